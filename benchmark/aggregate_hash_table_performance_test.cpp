@@ -67,6 +67,117 @@ BENCHMARK_DEFINE_F(DISABLED_StandardAggregateHashTableBenchmark, Aggregate)(benc
 
 BENCHMARK_REGISTER_F(DISABLED_StandardAggregateHashTableBenchmark, Aggregate)->Arg(16)->Arg(1024)->Arg(8192);
 
+class VectorizedAggregateHashTableBenchmark : public AggregateHashTableBenchmark
+{
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    AggregateHashTableBenchmark::SetUp(state);
+    vectorized_hash_table_ = make_unique<VectorizedAggregateHashTable>(vector<Expression *>{&sum_expr_});
+  }
+
+protected:
+  FieldMeta                      field_meta_{"v", AttrType::INTS, 0, 4, true, 0};
+  AggregateExpr                  sum_expr_{AggregateExpr::Type::SUM, new FieldExpr(nullptr, &field_meta_)};
+  unique_ptr<AggregateHashTable> vectorized_hash_table_;
+};
+
+BENCHMARK_DEFINE_F(VectorizedAggregateHashTableBenchmark, Aggregate)(benchmark::State &state)
+{
+  for (auto _ : state) {
+    vectorized_hash_table_->add_chunk(group_chunk_, aggr_chunk_);
+  }
+}
+
+BENCHMARK_REGISTER_F(VectorizedAggregateHashTableBenchmark, Aggregate)->Arg(16)->Arg(1024)->Arg(8192);
+
+/**
+ * @brief 多个分组列(INTS, CHARS, BIGINTS)、多个聚合函数，分组数量由第二个参数指定
+ */
+class VectorizedMultiKeyAggregateHashTableBenchmark : public benchmark::Fixture
+{
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    const int rows   = state.range(0);
+    const int groups = state.range(1);
+    auto      key1   = make_unique<Column>(AttrType::INTS, 4, rows);
+    auto      key2   = make_unique<Column>(AttrType::CHARS, 8, rows);
+    auto      key3   = make_unique<Column>(AttrType::BIGINTS, 8, rows);
+    auto      value1 = make_unique<Column>(AttrType::INTS, 4, rows);
+    auto      value2 = make_unique<Column>(AttrType::FLOATS, 4, rows);
+    for (int i = 0; i < rows; i++) {
+      int     k1 = i % groups;
+      int64_t k3 = k1 * 31;
+      float   f  = i * 0.5f;
+      key1->append_one((char *)&k1);
+      key2->append_value(Value(to_string(k1 % 97).c_str()));
+      key3->append_one((char *)&k3);
+      value1->append_one((char *)&i);
+      value2->append_one((char *)&f);
+    }
+    group_chunk_.add_column(std::move(key1), 0);
+    group_chunk_.add_column(std::move(key2), 1);
+    group_chunk_.add_column(std::move(key3), 2);
+    aggr_chunk_.add_column(std::move(value1), 0);
+    aggr_chunk_.add_column(std::move(value2), 1);
+    aggr_chunk_.add_column(make_unique<Column>(*aggr_chunk_.column_ptr(0)), 2);
+    aggr_chunk_.add_column(make_unique<Column>(*aggr_chunk_.column_ptr(1)), 3);
+
+    aggregate_exprs_.emplace_back(make_unique<AggregateExpr>(AggregateExpr::Type::SUM, new FieldExpr(nullptr, &int_meta_)));
+    aggregate_exprs_.emplace_back(make_unique<AggregateExpr>(AggregateExpr::Type::AVG, new FieldExpr(nullptr, &float_meta_)));
+    aggregate_exprs_.emplace_back(make_unique<AggregateExpr>(AggregateExpr::Type::COUNT, new FieldExpr(nullptr, &int_meta_)));
+    aggregate_exprs_.emplace_back(make_unique<AggregateExpr>(AggregateExpr::Type::SUM, new FieldExpr(nullptr, &float_meta_)));
+    for (auto &expr : aggregate_exprs_) {
+      aggregate_expr_ptrs_.push_back(expr.get());
+    }
+  }
+
+  void TearDown(const ::benchmark::State &state) override
+  {
+    group_chunk_.reset();
+    aggr_chunk_.reset();
+    aggregate_expr_ptrs_.clear();
+    aggregate_exprs_.clear();
+  }
+
+protected:
+  FieldMeta                         int_meta_{"i", AttrType::INTS, 0, 4, true, 0};
+  FieldMeta                         float_meta_{"f", AttrType::FLOATS, 4, 4, true, 1};
+  vector<unique_ptr<AggregateExpr>> aggregate_exprs_;
+  vector<Expression *>              aggregate_expr_ptrs_;
+  Chunk                             group_chunk_;
+  Chunk                             aggr_chunk_;
+};
+
+BENCHMARK_DEFINE_F(VectorizedMultiKeyAggregateHashTableBenchmark, Aggregate)(benchmark::State &state)
+{
+  for (auto _ : state) {
+    VectorizedAggregateHashTable hash_table(aggregate_expr_ptrs_);
+    hash_table.add_chunk(group_chunk_, aggr_chunk_);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(VectorizedMultiKeyAggregateHashTableBenchmark, Aggregate)
+    ->Args({8192, 16})
+    ->Args({8192, 1024})
+    ->Args({8192, 8192});
+
+BENCHMARK_DEFINE_F(VectorizedMultiKeyAggregateHashTableBenchmark, StandardAggregate)(benchmark::State &state)
+{
+  for (auto _ : state) {
+    StandardAggregateHashTable hash_table(aggregate_expr_ptrs_);
+    hash_table.add_chunk(group_chunk_, aggr_chunk_);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_REGISTER_F(VectorizedMultiKeyAggregateHashTableBenchmark, StandardAggregate)
+    ->Args({8192, 16})
+    ->Args({8192, 1024})
+    ->Args({8192, 8192});
+
 #ifdef USE_SIMD
 class DISABLED_LinearProbingAggregateHashTableBenchmark : public AggregateHashTableBenchmark
 {
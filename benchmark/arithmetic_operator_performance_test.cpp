@@ -11,6 +11,7 @@ See the Mulan PSL v2 for more details. */
 #include <benchmark/benchmark.h>
 
 #include "sql/expr/arithmetic_operator.hpp"
+#include "sql/expr/predicate_operator.hpp"
 
 class DISABLED_ArithmeticBenchmark : public benchmark::Fixture
 {
@@ -97,4 +98,104 @@ static void DISABLED_benchmark_sum_scalar(benchmark::State &state)
 
 BENCHMARK(DISABLED_benchmark_sum_scalar)->RangeMultiplier(2)->Range(1 << 10, 1 << 12);
 
+class PredicateBenchmark : public benchmark::Fixture
+{
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    int size = state.range(0);
+    values_.resize(size);
+    strings_.resize(size);
+    select_.assign(size, 1);
+    other_.resize(size);
+    for (int i = 0; i < size; ++i) {
+      values_[i]  = (i * 7919) % 10000;
+      strings_[i] = "some_prefix_" + std::to_string(values_[i]) + "_some_suffix";
+      other_[i]   = i % 3 == 0;
+    }
+  }
+
+protected:
+  std::vector<int>         values_;
+  std::vector<std::string> strings_;
+  std::vector<uint8_t>     select_;
+  std::vector<uint8_t>     other_;
+};
+
+BENCHMARK_DEFINE_F(PredicateBenchmark, Between)(benchmark::State &state)
+{
+  for (auto _ : state) {
+    between_filter(values_.data(), state.range(0), 1000, 5000, select_.data());
+    benchmark::DoNotOptimize(select_.data());
+  }
+}
+
+BENCHMARK_REGISTER_F(PredicateBenchmark, Between)->Arg(1000)->Arg(8192);
+
+BENCHMARK_DEFINE_F(PredicateBenchmark, InSmallList)(benchmark::State &state)
+{
+  InListFilter<int> filter({1, 10, 100, 1000, 2000, 3000, 4000, 5000});
+  for (auto _ : state) {
+    filter.filter(values_.data(), state.range(0), select_.data());
+    benchmark::DoNotOptimize(select_.data());
+  }
+}
+
+BENCHMARK_REGISTER_F(PredicateBenchmark, InSmallList)->Arg(1000)->Arg(8192);
+
+BENCHMARK_DEFINE_F(PredicateBenchmark, InLargeList)(benchmark::State &state)
+{
+  std::vector<int> list;
+  for (int i = 0; i < 1000; i++) {
+    list.push_back(i * 3);
+  }
+  InListFilter<int> filter(list);
+  for (auto _ : state) {
+    select_.assign(state.range(0), 1);
+    filter.filter(values_.data(), state.range(0), select_.data());
+    benchmark::DoNotOptimize(select_.data());
+  }
+}
+
+BENCHMARK_REGISTER_F(PredicateBenchmark, InLargeList)->Arg(1000)->Arg(8192);
+
+BENCHMARK_DEFINE_F(PredicateBenchmark, LikeContains)(benchmark::State &state)
+{
+  LikePattern pattern("%99_some%");
+  for (auto _ : state) {
+    int matched = 0;
+    for (int i = 0; i < state.range(0); i++) {
+      matched += pattern.match(strings_[i]);
+    }
+    benchmark::DoNotOptimize(matched);
+  }
+}
+
+BENCHMARK_REGISTER_F(PredicateBenchmark, LikeContains)->Arg(1000)->Arg(8192);
+
+BENCHMARK_DEFINE_F(PredicateBenchmark, LikeGeneric)(benchmark::State &state)
+{
+  LikePattern pattern("%99_s%suffix");
+  for (auto _ : state) {
+    int matched = 0;
+    for (int i = 0; i < state.range(0); i++) {
+      matched += pattern.match(strings_[i]);
+    }
+    benchmark::DoNotOptimize(matched);
+  }
+}
+
+BENCHMARK_REGISTER_F(PredicateBenchmark, LikeGeneric)->Arg(1000)->Arg(8192);
+
+BENCHMARK_DEFINE_F(PredicateBenchmark, OrNotSelect)(benchmark::State &state)
+{
+  for (auto _ : state) {
+    or_select(select_.data(), other_.data(), state.range(0));
+    and_not_select(select_.data(), other_.data(), state.range(0));
+    benchmark::DoNotOptimize(select_none(select_.data(), state.range(0)));
+  }
+}
+
+BENCHMARK_REGISTER_F(PredicateBenchmark, OrNotSelect)->Arg(1000)->Arg(8192);
+
 BENCHMARK_MAIN();
\ No newline at end of file
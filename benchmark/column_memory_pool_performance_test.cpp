@@ -0,0 +1,140 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <new>
+
+#include "sql/expr/expression.h"
+#include "storage/common/chunk.h"
+#include "storage/common/column_memory_pool.h"
+
+// 与 memtracer 一样通过替换内存分配函数统计申请次数。memtracer 是单独的动态库，符号都是隐藏的，
+// 这里只替换 new/delete，统计列数据、列对象以及各种 vector 的申请次数
+static std::atomic<size_t> alloc_count{0};
+
+void *operator new(size_t size)
+{
+  alloc_count.fetch_add(1, std::memory_order_relaxed);
+  void *ptr = malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+void *operator new[](size_t size) { return operator new(size); }
+void  operator delete(void *ptr) noexcept { free(ptr); }
+void  operator delete[](void *ptr) noexcept { free(ptr); }
+void  operator delete(void *ptr, size_t) noexcept { free(ptr); }
+void  operator delete[](void *ptr, size_t) noexcept { free(ptr); }
+
+/**
+ * @brief 在 chunk 上计算 a * b + c > d 以及 a * b + c，统计每 1M 行申请内存的次数
+ * @details Heap 与原来的执行方式相同：临时列与结果列都从堆上申请，结果列每个 chunk 重新创建。
+ * Pool 中 chunk 带有内存池，结果列在 chunk 之间复用，预热之后每个 chunk 都不再申请内存。
+ */
+class ColumnMemoryPoolBenchmark : public benchmark::Fixture
+{
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    chunk_.reset();
+    auto a = std::make_unique<Column>(AttrType::INTS, sizeof(int), ROWS);
+    auto b = std::make_unique<Column>(AttrType::INTS, sizeof(int), ROWS);
+    auto c = std::make_unique<Column>(AttrType::INTS, sizeof(int), ROWS);
+    auto d = std::make_unique<Column>(AttrType::FLOATS, sizeof(float), ROWS);
+    for (int i = 0; i < ROWS; i++) {
+      int   a_value = i % 97;
+      int   b_value = i % 13;
+      int   c_value = i;
+      float d_value = i * 1.5f;
+      a->append_one((char *)&a_value);
+      b->append_one((char *)&b_value);
+      c->append_one((char *)&c_value);
+      d->append_one((char *)&d_value);
+    }
+    chunk_.add_column(std::move(a), 0);
+    chunk_.add_column(std::move(b), 1);
+    chunk_.add_column(std::move(c), 2);
+    chunk_.add_column(std::move(d), 3);
+
+    value_expr_     = make_value_expr();
+    predicate_expr_ = std::make_unique<ComparisonExpr>(
+        CompOp::GREAT_THAN, std::make_unique<CastExpr>(make_value_expr(), AttrType::FLOATS), make_field_expr(d_meta_));
+    select_.assign(ROWS, 1);
+  }
+
+  void TearDown(const ::benchmark::State &state) override
+  {
+    value_expr_.reset();
+    predicate_expr_.reset();
+    chunk_.reset();
+  }
+
+protected:
+  static constexpr int ROWS = Chunk::MAX_ROWS;
+
+  unique_ptr<Expression> make_field_expr(FieldMeta &meta) { return std::make_unique<FieldExpr>(Field(nullptr, &meta)); }
+
+  unique_ptr<Expression> make_value_expr()
+  {
+    auto mul = std::make_unique<ArithmeticExpr>(ArithmeticExpr::Type::MUL, make_field_expr(a_meta_), make_field_expr(b_meta_));
+    return std::make_unique<ArithmeticExpr>(ArithmeticExpr::Type::ADD, std::move(mul), make_field_expr(c_meta_));
+  }
+
+  void run(benchmark::State &state, bool use_pool)
+  {
+    ColumnMemoryPool pool;
+    Column           result(&pool);
+    chunk_.set_memory_pool(use_pool ? &pool : nullptr);
+
+    size_t allocs = 0;
+    size_t rows   = 0;
+    for (auto _ : state) {
+      const size_t start = alloc_count.load(std::memory_order_relaxed);
+      select_.assign(ROWS, 1);
+      predicate_expr_->eval(chunk_, select_);
+      if (use_pool) {
+        value_expr_->get_column(chunk_, result);
+        benchmark::DoNotOptimize(result.data());
+      } else {
+        auto column = std::make_unique<Column>();
+        value_expr_->get_column(chunk_, *column);
+        benchmark::DoNotOptimize(column->data());
+      }
+      allocs += alloc_count.load(std::memory_order_relaxed) - start;
+      rows += ROWS;
+    }
+    chunk_.set_memory_pool(nullptr);
+
+    state.counters["allocs_per_1M_rows"] = static_cast<double>(allocs) * 1000000 / std::max<size_t>(rows, 1);
+    state.counters["pool_bytes"]         = static_cast<double>(pool.memory_usage());
+    state.SetItemsProcessed(static_cast<int64_t>(rows));
+  }
+
+protected:
+  FieldMeta a_meta_{"a", AttrType::INTS, 0, sizeof(int), true, 0};
+  FieldMeta b_meta_{"b", AttrType::INTS, 0, sizeof(int), true, 1};
+  FieldMeta c_meta_{"c", AttrType::INTS, 0, sizeof(int), true, 2};
+  FieldMeta d_meta_{"d", AttrType::FLOATS, 0, sizeof(float), true, 3};
+
+  Chunk                  chunk_;
+  unique_ptr<Expression> value_expr_;
+  unique_ptr<Expression> predicate_expr_;
+  vector<uint8_t>        select_;
+};
+
+BENCHMARK_DEFINE_F(ColumnMemoryPoolBenchmark, Heap)(benchmark::State &state) { run(state, false); }
+BENCHMARK_REGISTER_F(ColumnMemoryPoolBenchmark, Heap);
+
+BENCHMARK_DEFINE_F(ColumnMemoryPoolBenchmark, Pool)(benchmark::State &state) { run(state, true); }
+BENCHMARK_REGISTER_F(ColumnMemoryPoolBenchmark, Pool);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,110 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/atomic.h"
+#include "common/lang/memory.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/parallel_group_by_vec_physical_operator.h"
+
+/**
+ * @brief 在内存中生成数据的流水线，多个流水线共享同一个行号计数器，模拟按 morsel 并行扫描
+ * @details 第 0 列是分组键，按乘法散列打乱顺序；第 1 列是聚合的值
+ */
+class GeneratorVecPhysicalOperator : public PhysicalOperator
+{
+public:
+  GeneratorVecPhysicalOperator(atomic<int64_t> &next_row, int64_t rows, int groups)
+      : next_row_(next_row), rows_(rows), groups_(groups)
+  {}
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::TABLE_SCAN_VEC; }
+
+  RC open(Trx *) override { return RC::SUCCESS; }
+  RC close() override { return RC::SUCCESS; }
+
+  RC next(Chunk &chunk) override
+  {
+    const int64_t begin = next_row_.fetch_add(Chunk::MAX_ROWS);
+    if (begin >= rows_) {
+      return RC::RECORD_EOF;
+    }
+    const int count = static_cast<int>(std::min<int64_t>(Chunk::MAX_ROWS, rows_ - begin));
+    chunk.reset();
+    auto keys   = make_unique<Column>(AttrType::INTS, sizeof(int));
+    auto values = make_unique<Column>(AttrType::INTS, sizeof(int));
+    for (int i = 0; i < count; i++) {
+      const int64_t row   = begin + i;
+      const int     key   = static_cast<int>(static_cast<uint64_t>(row) * 2654435761ULL % groups_);
+      const int     value = static_cast<int>(row & 0xFF);
+      keys->append_one((const char *)&key);
+      values->append_one((const char *)&value);
+    }
+    chunk.add_column(std::move(keys), 0);
+    chunk.add_column(std::move(values), 1);
+    return RC::SUCCESS;
+  }
+
+private:
+  atomic<int64_t> &next_row_;
+  int64_t          rows_;
+  int              groups_;
+};
+
+/**
+ * @brief select k, sum(v), count(*) from t group by k 的两阶段并行聚合
+ * @details 参数是线程数与分组数。为了能在一般的开发机上运行，总行数取 1000 万，
+ * 分组数 1K/1M/5M 分别对应每个分组 1 万行、10 行、2 行的情况
+ */
+static void BM_ParallelGroupBy(benchmark::State &state)
+{
+  static constexpr int64_t ROWS = 10 * 1000 * 1000;
+
+  const int threads = static_cast<int>(state.range(0));
+  const int groups  = static_cast<int>(state.range(1));
+
+  FieldMeta     key_meta("k", AttrType::INTS, 0, sizeof(int), true, 0);
+  FieldMeta     value_meta("v", AttrType::INTS, 0, sizeof(int), true, 1);
+  AggregateExpr sum_expr(AggregateExpr::Type::SUM, new FieldExpr(Field(nullptr, &value_meta)));
+  AggregateExpr count_expr(AggregateExpr::Type::COUNT, new ValueExpr(Value(1)));
+
+  int64_t output_groups = 0;
+  for (auto _ : state) {
+    atomic<int64_t>                next_row{0};
+    vector<unique_ptr<Expression>> group_by_exprs;
+    group_by_exprs.emplace_back(make_unique<FieldExpr>(Field(nullptr, &key_meta)));
+    ParallelGroupByVecPhysicalOperator oper(
+        std::move(group_by_exprs), vector<Expression *>{&sum_expr, &count_expr}, make_shared<MorselScheduler>());
+    for (int i = 0; i < threads; i++) {
+      oper.add_child(make_unique<GeneratorVecPhysicalOperator>(next_row, ROWS, groups));
+    }
+
+    if (oper.open(nullptr) != RC::SUCCESS) {
+      state.SkipWithError("failed to open parallel group by");
+      break;
+    }
+    output_groups = 0;
+    Chunk chunk;
+    while (oper.next(chunk) == RC::SUCCESS) {
+      output_groups += chunk.rows();
+    }
+    oper.close();
+  }
+  state.counters["groups"] = static_cast<double>(output_groups);
+  state.SetItemsProcessed(state.iterations() * ROWS);
+}
+
+BENCHMARK(BM_ParallelGroupBy)
+    ->ArgsProduct({{1, 2, 4, 8}, {1000, 1000 * 1000, 5 * 1000 * 1000}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,104 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <benchmark/benchmark.h>
+
+#include "common/lang/memory.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/order_by_key.hpp"
+#include "storage/common/external_sorter.h"
+
+/**
+ * @brief 排序 state.range(0) 个 chunk，每个 chunk 有 Column::DEFAULT_CAPACITY 行，
+ * 排序列为 (int, char(16))，payload 为 (int, char(16), float)
+ */
+class SortBenchmark : public benchmark::Fixture
+{
+public:
+  void SetUp(const ::benchmark::State &state) override
+  {
+    const int rows = Column::DEFAULT_CAPACITY;
+    int       seed = 1;
+    for (int c = 0; c < state.range(0); c++) {
+      auto payload = make_unique<Chunk>();
+      auto keys    = make_unique<Chunk>();
+      auto col1    = make_unique<Column>(AttrType::INTS, 4, rows);
+      auto col2    = make_unique<Column>(AttrType::CHARS, 16, rows);
+      auto col3    = make_unique<Column>(AttrType::FLOATS, 4, rows);
+      for (int i = 0; i < rows; i++) {
+        seed        = seed * 1103515245 + 12345;
+        int   key   = (seed >> 8) % 1000;
+        float value = i * 0.5f;
+        col1->append_one((char *)&key);
+        col2->append_value(Value(("name_" + to_string(seed & 0xffff)).c_str()));
+        col3->append_one((char *)&value);
+      }
+      keys->add_column(make_unique<Column>(*col1), 0);
+      keys->add_column(make_unique<Column>(*col2), 1);
+      payload->add_column(std::move(col1), 0);
+      payload->add_column(std::move(col2), 1);
+      payload->add_column(std::move(col3), 2);
+      payloads_.push_back(std::move(payload));
+      keys_.push_back(std::move(keys));
+    }
+  }
+
+  void TearDown(const ::benchmark::State &state) override
+  {
+    payloads_.clear();
+    keys_.clear();
+  }
+
+protected:
+  vector<unique_ptr<Chunk>> payloads_;
+  vector<unique_ptr<Chunk>> keys_;
+  vector<bool>              ascs_{true, false};
+};
+
+BENCHMARK_DEFINE_F(SortBenchmark, ValueRowSort)(benchmark::State &state)
+{
+  for (auto _ : state) {
+    __order_by::Rows rows;
+    for (size_t c = 0; c < payloads_.size(); c++) {
+      vector<unique_ptr<Column>> key_columns;
+      key_columns.push_back(make_unique<Column>(keys_[c]->column(0)));
+      key_columns.push_back(make_unique<Column>(keys_[c]->column(1)));
+      __order_by::append_rows(rows, *payloads_[c], key_columns);
+    }
+    __order_by::sort_rows(rows, __order_by::OrderKeyComp(ascs_));
+    benchmark::DoNotOptimize(rows.data());
+  }
+}
+
+BENCHMARK_DEFINE_F(SortBenchmark, NormalizedKeySort)(benchmark::State &state)
+{
+  for (auto _ : state) {
+    ExternalSorter sorter(ascs_, 0);
+    for (size_t c = 0; c < payloads_.size(); c++) {
+      sorter.add_chunk(*payloads_[c], *keys_[c]);
+    }
+    sorter.finish();
+
+    Chunk output;
+    output.add_column(make_unique<Column>(AttrType::INTS, 4), 0);
+    output.add_column(make_unique<Column>(AttrType::CHARS, 16), 1);
+    output.add_column(make_unique<Column>(AttrType::FLOATS, 4), 2);
+    while (sorter.next(output) == RC::SUCCESS) {
+      benchmark::DoNotOptimize(output.column(0).data());
+      output.reset_data();
+    }
+  }
+}
+
+BENCHMARK_REGISTER_F(SortBenchmark, ValueRowSort)->Arg(1)->Arg(16)->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(SortBenchmark, NormalizedKeySort)->Arg(1)->Arg(16)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
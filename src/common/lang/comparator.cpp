@@ -34,8 +34,8 @@ int compare_int(void *arg1, void *arg2)
 
 int compare_int64(void *arg1, void *arg2)
 {
-  int v1 = *(int64_t *)arg1;
-  int v2 = *(int64_t *)arg2;
+  int64_t v1 = *(int64_t *)arg1;
+  int64_t v2 = *(int64_t *)arg2;
   if (v1 > v2) {
     return 1;
   } else if (v1 < v2) {
@@ -106,6 +106,9 @@ public:
     return true;
   }
 
+  /// 只判断是否存在，不改变 LRU 顺序
+  bool contains(const Key &key) const { return searcher_.find((ListNode *)&key) != searcher_.end(); }
+
   void put(const Key &key, const Value &value)
   {
     auto iter = searcher_.find((ListNode *)&key);
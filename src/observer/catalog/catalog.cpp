@@ -9,6 +9,11 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "catalog/catalog.h"
+#include "common/lang/filesystem.h"
+#include "common/lang/fstream.h"
+#include "common/log/log.h"
+
+using namespace std;
 
 const TableStats &Catalog::get_table_stats(int table_id)
 {
@@ -19,5 +24,58 @@ const TableStats &Catalog::get_table_stats(int table_id)
 void Catalog::update_table_stats(int table_id, const TableStats &table_stats)
 {
   lock_guard<mutex> lock(mutex_);
-  table_stats_[table_id] = table_stats;
-}
\ No newline at end of file
+  table_stats_[table_id]          = table_stats;
+  table_stats_versions_[table_id] = ++last_stats_version_;
+}
+
+uint64_t Catalog::get_table_stats_version(int table_id)
+{
+  lock_guard<mutex> lock(mutex_);
+  auto              iter = table_stats_versions_.find(table_id);
+  return iter == table_stats_versions_.end() ? 0 : iter->second;
+}
+
+RC Catalog::save_table_stats(int table_id, const string &stats_file)
+{
+  TableStats stats = get_table_stats(table_id);
+
+  // 先写临时文件再改名，避免写到一半时留下损坏的文件
+  string  tmp_file = stats_file + ".tmp";
+  fstream fs;
+  fs.open(tmp_file, ios_base::out | ios_base::binary | ios_base::trunc);
+  if (!fs.is_open()) {
+    LOG_ERROR("Failed to open table stats file for write. file name=%s, errmsg=%s", tmp_file.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  if (stats.serialize(fs) < 0) {
+    LOG_ERROR("Failed to serialize table stats. file name=%s", tmp_file.c_str());
+    return RC::IOERR_WRITE;
+  }
+  fs.close();
+
+  error_code ec;
+  filesystem::rename(tmp_file, stats_file, ec);
+  if (ec) {
+    LOG_ERROR("Failed to rename table stats file. from=%s, to=%s, errmsg=%s",
+        tmp_file.c_str(), stats_file.c_str(), ec.message().c_str());
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+RC Catalog::load_table_stats(int table_id, const string &stats_file)
+{
+  fstream fs;
+  fs.open(stats_file, ios_base::in | ios_base::binary);
+  if (!fs.is_open()) {
+    return RC::SUCCESS;
+  }
+  TableStats stats;
+  if (stats.deserialize(fs) < 0) {
+    LOG_WARN("Failed to deserialize table stats, ignore it. file name=%s", stats_file.c_str());
+    return RC::SUCCESS;
+  }
+  update_table_stats(table_id, stats);
+  LOG_INFO("Load table stats. table id=%d, rows=%d, columns=%d", table_id, stats.row_nums, (int)stats.column_stats.size());
+  return RC::SUCCESS;
+}
@@ -11,6 +11,8 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 #include "common/lang/unordered_map.h"
 #include "common/lang/mutex.h"
+#include "common/lang/string.h"
+#include "common/sys/rc.h"
 #include "catalog/table_stats.h"
 
 /**
@@ -49,6 +51,29 @@ public:
    */
   void update_table_stats(int table_id, const TableStats &table_stats);
 
+  /**
+   * @brief Returns a number that changes every time the statistics of the table are updated.
+   *
+   * Cached plans record the versions of the statistics they were optimized with, and are
+   * dropped once the statistics change.
+   */
+  uint64_t get_table_stats_version(int table_id);
+
+  /**
+   * @brief Writes the statistics of a table to a file, so that they survive a restart.
+   *
+   * @param table_id The identifier of the table.
+   * @param stats_file The file to write, usually next to the table meta file.
+   */
+  RC save_table_stats(int table_id, const string &stats_file);
+
+  /**
+   * @brief Loads the statistics of a table written by save_table_stats.
+   *
+   * Does nothing if the file does not exist, i.e. the table has never been analyzed.
+   */
+  RC load_table_stats(int table_id, const string &stats_file);
+
   /**
    * @brief Gets the singleton instance of the Catalog.
    *
@@ -68,7 +93,11 @@ private:
   /**
    * @brief A map storing the table statistics indexed by table_id.
    *
-   * This map is currently not persisted and its persistence is planned via a system table.
+   * Each table's statistics are persisted in a separate file by save_table_stats and
+   * loaded when the table is opened.
    */
   unordered_map<int, TableStats> table_stats_;  ///< Table statistics storage.
+
+  unordered_map<int, uint64_t> table_stats_versions_;
+  uint64_t                     last_stats_version_ = 0;
 };
\ No newline at end of file
@@ -0,0 +1,579 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <json/json.h>
+
+#include "catalog/column_stats.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/cmath.h"
+#include "common/lang/iterator.h"
+#include "common/lang/sstream.h"
+#include "common/lang/string_view.h"
+#include "common/log/log.h"
+#include "storage/common/column.h"
+
+using namespace std;
+
+static const Json::StaticString FIELD_NAME("field_name");
+static const Json::StaticString FIELD_TYPE("type");
+static const Json::StaticString FIELD_NULL_FRAC("null_frac");
+static const Json::StaticString FIELD_NDV("ndv");
+static const Json::StaticString FIELD_MIN("min");
+static const Json::StaticString FIELD_MAX("max");
+static const Json::StaticString FIELD_MCV_VALUES("mcv_values");
+static const Json::StaticString FIELD_MCV_FREQS("mcv_freqs");
+static const Json::StaticString FIELD_HISTOGRAM("histogram");
+
+namespace {
+
+inline uint64_t mix_hash(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+bool is_numeric_stats_type(AttrType type)
+{
+  switch (type) {
+    case AttrType::INTS:
+    case AttrType::BIGINTS:
+    case AttrType::FLOATS:
+    case AttrType::DATES:
+    case AttrType::BOOLEANS: return true;
+    default: return false;
+  }
+}
+
+double to_number(const Value &value)
+{
+  switch (value.attr_type()) {
+    case AttrType::INTS:
+    case AttrType::DATES: return *reinterpret_cast<const int32_t *>(value.data());
+    case AttrType::BIGINTS: return static_cast<double>(*reinterpret_cast<const int64_t *>(value.data()));
+    case AttrType::FLOATS: return *reinterpret_cast<const float *>(value.data());
+    case AttrType::BOOLEANS: return *reinterpret_cast<const bool *>(value.data()) ? 1 : 0;
+    default: return 0;
+  }
+}
+
+/// 两个值都是数值或者都是字符串，由调用者保证
+int compare_stats_value(const Value &left, const Value &right)
+{
+  if (is_numeric_stats_type(left.attr_type())) {
+    const double l = to_number(left);
+    const double r = to_number(right);
+    return l < r ? -1 : (l > r ? 1 : 0);
+  }
+  return string_view(left.data(), left.length()).compare(string_view(right.data(), right.length()));
+}
+
+void value_to_json(const Value &value, Json::Value &json_value)
+{
+  if (is_numeric_stats_type(value.attr_type())) {
+    json_value = to_number(value);
+  } else {
+    json_value = string(value.data(), value.length());
+  }
+}
+
+bool value_from_json(const Json::Value &json_value, AttrType type, Value &value)
+{
+  if (!is_numeric_stats_type(type)) {
+    if (!json_value.isString()) {
+      return false;
+    }
+    value = Value(json_value.asCString());
+    return true;
+  }
+  if (!json_value.isNumeric()) {
+    return false;
+  }
+  const double number = json_value.asDouble();
+  switch (type) {
+    case AttrType::INTS:
+    case AttrType::DATES: {
+      int32_t v = static_cast<int32_t>(number);
+      value     = Value(type, (char *)&v, sizeof(v));
+    } break;
+    case AttrType::BIGINTS: {
+      int64_t v = static_cast<int64_t>(number);
+      value     = Value(type, (char *)&v, sizeof(v));
+    } break;
+    case AttrType::FLOATS: {
+      value = Value(static_cast<float>(number));
+    } break;
+    default: {
+      value = Value(number != 0);
+    } break;
+  }
+  return true;
+}
+
+}  // namespace
+
+uint64_t column_stats_hash(const Value &value)
+{
+  const char *data = value.data();
+  const int   len  = value.length();
+  uint64_t    h    = 0x9e3779b97f4a7c15ULL ^ static_cast<uint64_t>(len);
+  int         i    = 0;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    h = mix_hash(h ^ word);
+  }
+  if (i < len) {
+    uint64_t word = 0;
+    memcpy(&word, data + i, len - i);
+    h = mix_hash(h ^ word);
+  }
+  return mix_hash(h);
+}
+
+// ----------------------------------HyperLogLog------------------
+
+void HyperLogLog::add_hash(uint64_t hash)
+{
+  const int      index = static_cast<int>(hash >> (64 - PRECISION));
+  const uint64_t rest  = (hash << PRECISION) | (1ULL << (PRECISION - 1));  // 保证 rest 不为 0
+  const uint8_t  rank  = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+  if (rank > registers_[index]) {
+    registers_[index] = rank;
+  }
+}
+
+void HyperLogLog::merge(const HyperLogLog &other)
+{
+  for (int i = 0; i < REGISTER_NUM; i++) {
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+  }
+}
+
+double HyperLogLog::estimate() const
+{
+  const double m     = REGISTER_NUM;
+  const double alpha = 0.7213 / (1 + 1.079 / m);
+  double       sum   = 0;
+  int          zeros = 0;
+  for (uint8_t rank : registers_) {
+    sum += ldexp(1.0, -rank);
+    zeros += rank == 0 ? 1 : 0;
+  }
+  double estimate = alpha * m * m / sum;
+  if (estimate <= 2.5 * m && zeros > 0) {
+    // 基数比较小时用 linear counting 修正
+    estimate = m * log(m / zeros);
+  }
+  return estimate;
+}
+
+// ----------------------------------ColumnStats------------------
+
+bool ColumnStats::is_ordered_type(AttrType type) { return is_numeric_stats_type(type) || type == AttrType::CHARS; }
+
+bool ColumnStats::normalize(const Value &value, Value &result) const
+{
+  if (is_numeric_stats_type(attr_type) && is_numeric_stats_type(value.attr_type())) {
+    result = value;
+    return true;
+  }
+  if (attr_type == AttrType::CHARS && value.attr_type() == AttrType::CHARS) {
+    result = value;
+    return true;
+  }
+  return false;
+}
+
+double ColumnStats::mcv_total_freq() const
+{
+  double total = 0;
+  for (double freq : mcv_freqs) {
+    total += freq;
+  }
+  return total;
+}
+
+double ColumnStats::equal_selectivity(const Value &input) const
+{
+  Value value;
+  if (!normalize(input, value)) {
+    return DEFAULT_EQUAL_SEL;
+  }
+  if (has_min_max && (compare_stats_value(value, min_value) < 0 || compare_stats_value(value, max_value) > 0)) {
+    return 0;
+  }
+  for (size_t i = 0; i < mcv_values.size(); i++) {
+    if (compare_stats_value(value, mcv_values[i]) == 0) {
+      return mcv_freqs[i];
+    }
+  }
+  // 不在 MCV 中的值平分剩下的行
+  const double rest_frac = std::max(0.0, 1 - null_frac - mcv_total_freq());
+  const double rest_ndv  = std::max(1.0, ndv - mcv_values.size());
+  return rest_frac / rest_ndv;
+}
+
+double ColumnStats::histogram_fraction(const Value &value, bool inclusive) const
+{
+  const int buckets = static_cast<int>(histogram_bounds.size()) - 1;
+  if (compare_stats_value(value, histogram_bounds.front()) < 0) {
+    return 0;
+  }
+  const int cmp_last = compare_stats_value(value, histogram_bounds.back());
+  if (cmp_last > 0 || (cmp_last == 0 && inclusive)) {
+    return 1;
+  }
+
+  // 找到 value 所在的桶：bounds[bucket] <= value < bounds[bucket + 1]
+  auto iter   = upper_bound(histogram_bounds.begin(), histogram_bounds.end(), value,
+      [](const Value &v, const Value &bound) { return compare_stats_value(v, bound) < 0; });
+  int  bucket = static_cast<int>(iter - histogram_bounds.begin()) - 1;
+  bucket      = std::clamp(bucket, 0, buckets - 1);
+
+  const Value &low   = histogram_bounds[bucket];
+  const Value &high  = histogram_bounds[bucket + 1];
+  double       inner = 0.5;
+  if (is_numeric_stats_type(attr_type)) {
+    const double l = to_number(low);
+    const double h = to_number(high);
+    if (h > l) {
+      inner = std::clamp((to_number(value) - l) / (h - l), 0.0, 1.0);
+    }
+  }
+  return (bucket + inner) / buckets;
+}
+
+double ColumnStats::less_selectivity(const Value &input, bool inclusive) const
+{
+  Value value;
+  if (!normalize(input, value)) {
+    return DEFAULT_RANGE_SEL;
+  }
+  const double non_null = 1 - null_frac;
+  if (has_min_max) {
+    const int cmp_min = compare_stats_value(value, min_value);
+    if (cmp_min < 0 || (cmp_min == 0 && !inclusive)) {
+      return 0;
+    }
+    const int cmp_max = compare_stats_value(value, max_value);
+    if (cmp_max > 0 || (cmp_max == 0 && inclusive)) {
+      return non_null;
+    }
+  }
+
+  double selectivity = 0;
+  for (size_t i = 0; i < mcv_values.size(); i++) {
+    const int cmp = compare_stats_value(mcv_values[i], value);
+    if (cmp < 0 || (cmp == 0 && inclusive)) {
+      selectivity += mcv_freqs[i];
+    }
+  }
+
+  const double hist_frac = std::max(0.0, non_null - mcv_total_freq());
+  if (histogram_bounds.size() >= 2) {
+    selectivity += hist_frac * histogram_fraction(value, inclusive);
+  } else if (has_min_max && is_numeric_stats_type(attr_type) && to_number(max_value) > to_number(min_value)) {
+    const double low  = to_number(min_value);
+    const double high = to_number(max_value);
+    selectivity += hist_frac * std::clamp((to_number(value) - low) / (high - low), 0.0, 1.0);
+  } else if (mcv_values.empty()) {
+    selectivity += hist_frac * DEFAULT_RANGE_SEL;
+  }
+  return std::clamp(selectivity, 0.0, non_null);
+}
+
+double ColumnStats::greater_selectivity(const Value &value, bool inclusive) const
+{
+  Value normalized;
+  if (!normalize(value, normalized)) {
+    return DEFAULT_RANGE_SEL;
+  }
+  return std::max(0.0, 1 - null_frac - less_selectivity(value, !inclusive));
+}
+
+void ColumnStats::to_json(Json::Value &json_value) const
+{
+  json_value[FIELD_NAME]      = field_name;
+  json_value[FIELD_TYPE]      = attr_type_to_string(attr_type);
+  json_value[FIELD_NULL_FRAC] = null_frac;
+  json_value[FIELD_NDV]       = ndv;
+  if (has_min_max) {
+    value_to_json(min_value, json_value[FIELD_MIN]);
+    value_to_json(max_value, json_value[FIELD_MAX]);
+  }
+
+  Json::Value mcv_values_value(Json::arrayValue);
+  Json::Value mcv_freqs_value(Json::arrayValue);
+  for (size_t i = 0; i < mcv_values.size(); i++) {
+    Json::Value mcv_value;
+    value_to_json(mcv_values[i], mcv_value);
+    mcv_values_value.append(mcv_value);
+    mcv_freqs_value.append(mcv_freqs[i]);
+  }
+  json_value[FIELD_MCV_VALUES] = std::move(mcv_values_value);
+  json_value[FIELD_MCV_FREQS]  = std::move(mcv_freqs_value);
+
+  Json::Value histogram_value(Json::arrayValue);
+  for (const Value &bound : histogram_bounds) {
+    Json::Value bound_value;
+    value_to_json(bound, bound_value);
+    histogram_value.append(bound_value);
+  }
+  json_value[FIELD_HISTOGRAM] = std::move(histogram_value);
+}
+
+RC ColumnStats::from_json(const Json::Value &json_value, ColumnStats &stats)
+{
+  const Json::Value &name_value = json_value[FIELD_NAME];
+  const Json::Value &type_value = json_value[FIELD_TYPE];
+  if (!name_value.isString() || !type_value.isString()) {
+    LOG_ERROR("Invalid column stats. json value=%s", json_value.toStyledString().c_str());
+    return RC::INTERNAL;
+  }
+  stats.field_name = name_value.asString();
+  stats.attr_type  = attr_type_from_string(type_value.asCString());
+  stats.null_frac  = json_value[FIELD_NULL_FRAC].asDouble();
+  stats.ndv        = json_value[FIELD_NDV].asDouble();
+
+  stats.has_min_max = json_value.isMember(FIELD_MIN) && json_value.isMember(FIELD_MAX);
+  if (stats.has_min_max && (!value_from_json(json_value[FIELD_MIN], stats.attr_type, stats.min_value) ||
+                               !value_from_json(json_value[FIELD_MAX], stats.attr_type, stats.max_value))) {
+    LOG_ERROR("Invalid min/max in column stats. field=%s", stats.field_name.c_str());
+    return RC::INTERNAL;
+  }
+
+  const Json::Value &mcv_values_value = json_value[FIELD_MCV_VALUES];
+  const Json::Value &mcv_freqs_value  = json_value[FIELD_MCV_FREQS];
+  if (mcv_values_value.size() != mcv_freqs_value.size()) {
+    LOG_ERROR("Invalid mcv in column stats. field=%s", stats.field_name.c_str());
+    return RC::INTERNAL;
+  }
+  stats.mcv_values.resize(mcv_values_value.size());
+  stats.mcv_freqs.resize(mcv_freqs_value.size());
+  for (Json::ArrayIndex i = 0; i < mcv_values_value.size(); i++) {
+    if (!value_from_json(mcv_values_value[i], stats.attr_type, stats.mcv_values[i])) {
+      LOG_ERROR("Invalid mcv in column stats. field=%s", stats.field_name.c_str());
+      return RC::INTERNAL;
+    }
+    stats.mcv_freqs[i] = mcv_freqs_value[i].asDouble();
+  }
+
+  const Json::Value &histogram_value = json_value[FIELD_HISTOGRAM];
+  stats.histogram_bounds.resize(histogram_value.size());
+  for (Json::ArrayIndex i = 0; i < histogram_value.size(); i++) {
+    if (!value_from_json(histogram_value[i], stats.attr_type, stats.histogram_bounds[i])) {
+      LOG_ERROR("Invalid histogram in column stats. field=%s", stats.field_name.c_str());
+      return RC::INTERNAL;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+string ColumnStats::to_string() const
+{
+  stringstream ss;
+  ss << field_name << ": ndv=" << ndv << ", null_frac=" << null_frac;
+  if (has_min_max) {
+    ss << ", min=" << min_value.to_string() << ", max=" << max_value.to_string();
+  }
+  ss << ", mcv=" << mcv_values.size() << ", buckets=" << std::max<int>(0, histogram_bounds.size() - 1);
+  return ss.str();
+}
+
+// ----------------------------------ColumnStatsCollector------------------
+
+ColumnStatsCollector::ColumnStatsCollector(string field_name, AttrType attr_type, uint64_t seed)
+    : field_name_(std::move(field_name)), attr_type_(attr_type), random_(seed)
+{}
+
+void ColumnStatsCollector::add(const Column &column, int count)
+{
+  rows_ += count;
+  for (int i = 0; i < count; i++) {
+    if (column.is_null(i)) {
+      nulls_++;
+      continue;
+    }
+    add_value(column.get_value(i));
+  }
+}
+
+void ColumnStatsCollector::add_value(Value &&value)
+{
+  hll_.add_hash(column_stats_hash(value));
+  if (!ColumnStats::is_ordered_type(attr_type_)) {
+    return;
+  }
+
+  if (!has_min_max_) {
+    min_value_   = value;
+    max_value_   = value;
+    has_min_max_ = true;
+  } else if (compare_stats_value(value, min_value_) < 0) {
+    min_value_ = value;
+  } else if (compare_stats_value(value, max_value_) > 0) {
+    max_value_ = value;
+  }
+
+  // reservoir sampling，每个值被留下的概率相同
+  seen_values_++;
+  if (samples_.size() < MAX_SAMPLE_VALUES) {
+    samples_.emplace_back(std::move(value));
+  } else {
+    const uint64_t index = random_() % seen_values_;
+    if (index < MAX_SAMPLE_VALUES) {
+      samples_[index] = std::move(value);
+    }
+  }
+}
+
+void ColumnStatsCollector::merge(ColumnStatsCollector &other)
+{
+  rows_ += other.rows_;
+  nulls_ += other.nulls_;
+  hll_.merge(other.hll_);
+
+  if (other.has_min_max_) {
+    if (!has_min_max_) {
+      min_value_   = other.min_value_;
+      max_value_   = other.max_value_;
+      has_min_max_ = true;
+    } else {
+      if (compare_stats_value(other.min_value_, min_value_) < 0) {
+        min_value_ = other.min_value_;
+      }
+      if (compare_stats_value(other.max_value_, max_value_) > 0) {
+        max_value_ = other.max_value_;
+      }
+    }
+  }
+
+  const int64_t total_seen = seen_values_ + other.seen_values_;
+  if (samples_.size() + other.samples_.size() <= MAX_SAMPLE_VALUES) {
+    // 两边都还没有开始替换，直接拼起来
+    samples_.insert(samples_.end(),
+        std::make_move_iterator(other.samples_.begin()),
+        std::make_move_iterator(other.samples_.end()));
+  } else {
+    // 两边各自是均匀的样本，按各自代表的值的个数分配名额，打乱后取前面的部分
+    shuffle(samples_.begin(), samples_.end(), random_);
+    shuffle(other.samples_.begin(), other.samples_.end(), random_);
+    const double self_share = static_cast<double>(seen_values_) / total_seen;
+    size_t       self_take  = std::min(static_cast<size_t>(llround(MAX_SAMPLE_VALUES * self_share)), samples_.size());
+    const size_t other_take = std::min(MAX_SAMPLE_VALUES - self_take, other.samples_.size());
+    self_take               = std::min(MAX_SAMPLE_VALUES - other_take, samples_.size());
+    samples_.resize(self_take);
+    samples_.insert(samples_.end(),
+        std::make_move_iterator(other.samples_.begin()),
+        std::make_move_iterator(other.samples_.begin() + other_take));
+  }
+  other.samples_.clear();
+  seen_values_ = total_seen;
+}
+
+void ColumnStatsCollector::finish(double table_rows, ColumnStats &stats)
+{
+  stats                  = ColumnStats();
+  stats.field_name       = field_name_;
+  stats.attr_type        = attr_type_;
+  stats.null_frac        = rows_ > 0 ? static_cast<double>(nulls_) / rows_ : 0;
+  const int64_t non_null = rows_ - nulls_;
+  if (non_null == 0) {
+    return;
+  }
+
+  stats.has_min_max = has_min_max_;
+  stats.min_value   = min_value_;
+  stats.max_value   = max_value_;
+
+  sort(samples_.begin(), samples_.end(), [](const Value &l, const Value &r) { return compare_stats_value(l, r) < 0; });
+  // 样本中每个不同的值：起始下标与出现次数
+  vector<pair<int, int>> runs;
+  int                    singletons = 0;
+  for (int i = 0; i < static_cast<int>(samples_.size());) {
+    int j = i + 1;
+    while (j < static_cast<int>(samples_.size()) && compare_stats_value(samples_[i], samples_[j]) == 0) {
+      j++;
+    }
+    runs.emplace_back(i, j - i);
+    singletons += (j - i == 1) ? 1 : 0;
+    i = j;
+  }
+
+  double distinct = std::min(hll_.estimate(), static_cast<double>(non_null));
+  if (!runs.empty() && distinct < runs.size()) {
+    distinct = runs.size();
+  }
+  stats.ndv = distinct;
+  if (table_rows <= rows_ && seen_values_ == static_cast<int64_t>(samples_.size()) && !runs.empty()) {
+    // 读取了所有的行并且样本中包含了所有的值，不同值的个数是准确的
+    stats.ndv = runs.size();
+  } else if (table_rows > rows_ && !runs.empty()) {
+    // Duj1: n * d / (n - f1 + f1 * n / N)，f1 是样本中只出现一次的值的个数
+    const double n  = static_cast<double>(non_null);
+    const double N  = table_rows * (1 - stats.null_frac);
+    const double f1 = distinct * singletons / runs.size();
+    stats.ndv       = std::clamp(n * distinct / (n - f1 + f1 * n / N), distinct, std::max(distinct, N));
+  }
+
+  if (samples_.empty()) {
+    return;
+  }
+
+  // 出现次数明显多于平均值的作为 MCV；样本包含了所有的值时全部作为 MCV
+  const double sample_num    = static_cast<double>(samples_.size());
+  const double non_null_frac = 1 - stats.null_frac;
+  vector<int>  mcv_runs;
+  if (singletons == 0 && runs.size() <= ColumnStats::MAX_MCV_NUM) {
+    for (int i = 0; i < static_cast<int>(runs.size()); i++) {
+      mcv_runs.push_back(i);
+    }
+  } else {
+    const double avg_count = sample_num / runs.size();
+    for (int i = 0; i < static_cast<int>(runs.size()); i++) {
+      if (runs[i].second >= 2 && runs[i].second > 1.25 * avg_count) {
+        mcv_runs.push_back(i);
+      }
+    }
+    sort(mcv_runs.begin(), mcv_runs.end(), [&runs](int l, int r) { return runs[l].second > runs[r].second; });
+    if (mcv_runs.size() > ColumnStats::MAX_MCV_NUM) {
+      mcv_runs.resize(ColumnStats::MAX_MCV_NUM);
+    }
+  }
+  vector<bool> is_mcv(runs.size(), false);
+  for (int run : mcv_runs) {
+    is_mcv[run] = true;
+    stats.mcv_values.push_back(samples_[runs[run].first]);
+    stats.mcv_freqs.push_back(runs[run].second / sample_num * non_null_frac);
+  }
+
+  // 剩下的值构建等深直方图
+  vector<const Value *> rest;
+  for (size_t i = 0; i < runs.size(); i++) {
+    if (is_mcv[i]) {
+      continue;
+    }
+    for (int k = 0; k < runs[i].second; k++) {
+      rest.push_back(&samples_[runs[i].first + k]);
+    }
+  }
+  if (rest.size() >= 2) {
+    const int m       = static_cast<int>(rest.size());
+    const int buckets = std::min(ColumnStats::HISTOGRAM_BUCKETS, m - 1);
+    for (int i = 0; i <= buckets; i++) {
+      stats.histogram_bounds.push_back(*rest[static_cast<int64_t>(i) * (m - 1) / buckets]);
+    }
+  }
+  samples_.clear();
+}
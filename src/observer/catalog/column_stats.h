@@ -0,0 +1,175 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/random.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/sys/rc.h"
+#include "common/value.h"
+
+class Column;
+
+namespace Json {
+class Value;
+}
+
+/**
+ * @class HyperLogLog
+ * @brief Estimates the number of distinct values with a fixed amount of memory.
+ *
+ * The sketch keeps 2^PRECISION one-byte registers (4KB), the standard error of the
+ * estimation is about 1.04 / sqrt(2^PRECISION), 1.6% here. Two sketches can be merged,
+ * which allows each scanning thread to keep its own sketch.
+ */
+class HyperLogLog
+{
+public:
+  static constexpr int PRECISION    = 12;
+  static constexpr int REGISTER_NUM = 1 << PRECISION;
+
+  HyperLogLog() : registers_(REGISTER_NUM, 0) {}
+
+  void add_hash(uint64_t hash);
+  void merge(const HyperLogLog &other);
+
+  double estimate() const;
+
+private:
+  vector<uint8_t> registers_;
+};
+
+/**
+ * @class ColumnStats
+ * @brief Statistics of one column, collected by ANALYZE TABLE.
+ *
+ * Frequencies and fractions are relative to all rows of the table. Values listed in the
+ * most-common-values (MCV) list are excluded from the histogram, the equi-depth histogram
+ * describes the remaining non-null rows: every bucket holds about the same number of rows.
+ * Histogram and MCV are only kept for types with a meaningful order (numbers, dates, chars).
+ */
+class ColumnStats
+{
+public:
+  static constexpr int    MAX_MCV_NUM       = 16;
+  static constexpr int    HISTOGRAM_BUCKETS = 64;
+  static constexpr double DEFAULT_EQUAL_SEL = 0.005;
+  static constexpr double DEFAULT_RANGE_SEL = 1.0 / 3;
+
+  /**
+   * @brief Fraction of rows whose value equals value.
+   */
+  double equal_selectivity(const Value &value) const;
+
+  /**
+   * @brief Fraction of rows whose value is less than value (or equal to, if inclusive).
+   */
+  double less_selectivity(const Value &value, bool inclusive) const;
+
+  /**
+   * @brief Fraction of rows whose value is greater than value (or equal to, if inclusive).
+   */
+  double greater_selectivity(const Value &value, bool inclusive) const;
+
+  double mcv_total_freq() const;
+
+  void      to_json(Json::Value &json_value) const;
+  static RC from_json(const Json::Value &json_value, ColumnStats &stats);
+
+  string to_string() const;
+
+  /**
+   * @brief Whether histograms and MCV lists are collected for this type.
+   */
+  static bool is_ordered_type(AttrType type);
+
+public:
+  string   field_name;
+  AttrType attr_type = AttrType::UNDEFINED;
+  double   null_frac = 0;
+  double   ndv       = 0;  ///< number of distinct non-null values in the whole table
+
+  bool  has_min_max = false;
+  Value min_value;
+  Value max_value;
+
+  vector<Value>  mcv_values;
+  vector<double> mcv_freqs;
+  vector<Value>  histogram_bounds;  ///< bucket boundaries in ascending order, buckets + 1 values
+
+private:
+  /// Fraction of histogram rows less than value, in [0, 1]
+  double histogram_fraction(const Value &value, bool inclusive) const;
+  /// Converts the value to the column type so that compare works as expected
+  bool normalize(const Value &value, Value &result) const;
+};
+
+/**
+ * @class ColumnStatsCollector
+ * @brief Builds ColumnStats from sampled column data.
+ *
+ * Every non-null value goes into a HyperLogLog sketch and updates min/max. A reservoir
+ * sample of at most MAX_SAMPLE_VALUES values is kept to build the MCV list and histogram.
+ */
+class ColumnStatsCollector
+{
+public:
+  static constexpr int MAX_SAMPLE_VALUES = 30000;
+
+  ColumnStatsCollector(string field_name, AttrType attr_type, uint64_t seed = 0);
+
+  /**
+   * @brief Adds the first count values of column.
+   */
+  void add(const Column &column, int count);
+
+  /**
+   * @brief Merges the values collected by other, which must collect the same column.
+   * @details Used by parallel ANALYZE: each thread collects its own pages and the collectors are
+   * merged at the end. The merged sample keeps values from both sides in proportion to the number
+   * of values each side has seen, so it is still a uniform sample of all values.
+   */
+  void merge(ColumnStatsCollector &other);
+
+  const string &field_name() const { return field_name_; }
+  AttrType      attr_type() const { return attr_type_; }
+  int64_t       rows() const { return rows_; }
+
+  /**
+   * @brief Produces the statistics.
+   * @param table_rows Estimated number of rows of the table. If it is larger than the number of
+   * sampled rows, the number of distinct values is scaled up with the Haas-Stokes Duj1 estimator.
+   */
+  void finish(double table_rows, ColumnStats &stats);
+
+private:
+  void add_value(Value &&value);
+
+private:
+  string      field_name_;
+  AttrType    attr_type_;
+  HyperLogLog hll_;
+  int64_t     rows_  = 0;
+  int64_t     nulls_ = 0;
+
+  bool  has_min_max_ = false;
+  Value min_value_;
+  Value max_value_;
+
+  vector<Value> samples_;
+  int64_t       seen_values_ = 0;  ///< non-null values seen by the reservoir sampling
+  mt19937_64    random_;
+};
+
+/**
+ * @brief Hash of a value used by the HyperLogLog sketch.
+ */
+uint64_t column_stats_hash(const Value &value);
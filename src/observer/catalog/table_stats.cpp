@@ -0,0 +1,86 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <json/json.h>
+
+#include "catalog/table_stats.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+static const Json::StaticString FIELD_ROW_NUMS("row_nums");
+static const Json::StaticString FIELD_COLUMNS("columns");
+
+const ColumnStats *TableStats::find_column_stats(const string &field_name) const
+{
+  for (const ColumnStats &stats : column_stats) {
+    if (stats.field_name == field_name) {
+      return &stats;
+    }
+  }
+  return nullptr;
+}
+
+int TableStats::serialize(ostream &os) const
+{
+  Json::Value stats_value;
+  stats_value[FIELD_ROW_NUMS] = row_nums;
+
+  Json::Value columns_value(Json::arrayValue);
+  for (const ColumnStats &stats : column_stats) {
+    Json::Value column_value;
+    stats.to_json(column_value);
+    columns_value.append(std::move(column_value));
+  }
+  stats_value[FIELD_COLUMNS] = std::move(columns_value);
+
+  Json::StreamWriterBuilder builder;
+  Json::StreamWriter       *writer = builder.newStreamWriter();
+
+  streampos old_pos = os.tellp();
+  writer->write(stats_value, &os);
+  int ret = (int)(os.tellp() - old_pos);
+
+  delete writer;
+  return ret;
+}
+
+int TableStats::deserialize(istream &is)
+{
+  Json::Value             stats_value;
+  Json::CharReaderBuilder builder;
+  string                  errors;
+
+  streampos old_pos = is.tellg();
+  if (!Json::parseFromStream(builder, is, &stats_value, &errors)) {
+    LOG_ERROR("Failed to deserialize table stats. error=%s", errors.c_str());
+    return -1;
+  }
+
+  const Json::Value &row_nums_value = stats_value[FIELD_ROW_NUMS];
+  if (!row_nums_value.isInt()) {
+    LOG_ERROR("Invalid row nums. json value=%s", row_nums_value.toStyledString().c_str());
+    return -1;
+  }
+
+  vector<ColumnStats> columns;
+  const Json::Value  &columns_value = stats_value[FIELD_COLUMNS];
+  for (Json::ArrayIndex i = 0; i < columns_value.size(); i++) {
+    ColumnStats stats;
+    if (OB_FAIL(ColumnStats::from_json(columns_value[i], stats))) {
+      return -1;
+    }
+    columns.emplace_back(std::move(stats));
+  }
+
+  row_nums     = row_nums_value.asInt();
+  column_stats = std::move(columns);
+  return (int)(is.tellg() - old_pos);
+}
@@ -10,13 +10,18 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/iostream.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "catalog/column_stats.h"
+
 /**
  * @class TableStats
  * @brief Represents statistics related to a table.
  *
  * The TableStats class holds statistical information about a table,
- * such as the number of rows it contains.
- * TODO: Add more statistics as needed.
+ * such as the number of rows it contains and the statistics of each column.
+ * Column statistics are only available after ANALYZE TABLE.
  */
 class TableStats
 {
@@ -25,15 +30,21 @@ public:
 
   TableStats() = default;
 
-  TableStats(const TableStats &other) { row_nums = other.row_nums; }
-
-  TableStats &operator=(const TableStats &other)
-  {
-    row_nums = other.row_nums;
-    return *this;
-  }
+  TableStats(const TableStats &other)            = default;
+  TableStats &operator=(const TableStats &other) = default;
 
   ~TableStats() = default;
 
-  int row_nums = 0;
-};
\ No newline at end of file
+  /**
+   * @brief Finds the statistics of a column.
+   *
+   * @return nullptr if the column has not been analyzed.
+   */
+  const ColumnStats *find_column_stats(const string &field_name) const;
+
+  int serialize(ostream &os) const;
+  int deserialize(istream &is);
+
+  int                 row_nums = 0;
+  vector<ColumnStats> column_stats;
+};
@@ -39,5 +39,5 @@ bool is_numerical_type(AttrType type)
 
 bool is_string_type(AttrType type)
 {
-  return (type == AttrType::CHARS);
+  return type == AttrType::CHARS || type == AttrType::TEXTS;
 }
\ No newline at end of file
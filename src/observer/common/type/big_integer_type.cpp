@@ -34,8 +34,8 @@ int BigIntegerType::compare(const Column &left, const Column &right, int left_id
 {
   ASSERT(left.attr_type() == AttrType::BIGINTS, "left type is not integer");
   ASSERT(right.attr_type() == AttrType::BIGINTS, "right type is not integer");
-  return common::compare_int64((void *)&((int*)left.data())[left_idx],
-      (void *)&((int*)right.data())[right_idx]);
+  return common::compare_int64((void *)&((int64_t*)left.data())[left_idx],
+      (void *)&((int64_t*)right.data())[right_idx]);
 }
 
 RC BigIntegerType::cast_to(const Value &val, AttrType type, Value &result) const
@@ -59,25 +59,49 @@ RC BigIntegerType::cast_to(const Value &val, AttrType type, Value &result) const
 
 RC BigIntegerType::add(const Value &left, const Value &right, Value &result) const
 {
-  result.set_bigint(left.get_bigint() + right.get_bigint());
+  int64_t    value    = 0;
+  const bool overflow = __builtin_add_overflow(left.get_bigint(), right.get_bigint(), &value);
+  result.set_bigint(value);
+  if (overflow) {
+    LOG_WARN("integer overflow in arithmetic expression");
+    return RC::RANGE_ERROR;
+  }
   return RC::SUCCESS;
 }
 
 RC BigIntegerType::subtract(const Value &left, const Value &right, Value &result) const
 {
-  result.set_bigint(left.get_bigint() - right.get_bigint());
+  int64_t    value    = 0;
+  const bool overflow = __builtin_sub_overflow(left.get_bigint(), right.get_bigint(), &value);
+  result.set_bigint(value);
+  if (overflow) {
+    LOG_WARN("integer overflow in arithmetic expression");
+    return RC::RANGE_ERROR;
+  }
   return RC::SUCCESS;
 }
 
 RC BigIntegerType::multiply(const Value &left, const Value &right, Value &result) const
 {
-  result.set_bigint(left.get_bigint() * right.get_bigint());
+  int64_t    value    = 0;
+  const bool overflow = __builtin_mul_overflow(left.get_bigint(), right.get_bigint(), &value);
+  result.set_bigint(value);
+  if (overflow) {
+    LOG_WARN("integer overflow in arithmetic expression");
+    return RC::RANGE_ERROR;
+  }
   return RC::SUCCESS;
 }
 
 RC BigIntegerType::negative(const Value &val, Value &result) const
 {
-  result.set_bigint(-val.get_bigint());
+  int64_t    value    = 0;
+  const bool overflow = __builtin_sub_overflow(int64_t(0), val.get_bigint(), &value);
+  result.set_bigint(value);
+  if (overflow) {
+    LOG_WARN("integer overflow in arithmetic expression");
+    return RC::RANGE_ERROR;
+  }
   return RC::SUCCESS;
 }
 
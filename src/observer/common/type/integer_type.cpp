@@ -59,25 +59,49 @@ RC IntegerType::cast_to(const Value &val, AttrType type, Value &result) const
 
 RC IntegerType::add(const Value &left, const Value &right, Value &result) const
 {
-  result.set_int(left.get_int() + right.get_int());
+  int        value    = 0;
+  const bool overflow = __builtin_add_overflow(left.get_int(), right.get_int(), &value);
+  result.set_int(value);
+  if (overflow) {
+    LOG_WARN("integer overflow in arithmetic expression");
+    return RC::RANGE_ERROR;
+  }
   return RC::SUCCESS;
 }
 
 RC IntegerType::subtract(const Value &left, const Value &right, Value &result) const
 {
-  result.set_int(left.get_int() - right.get_int());
+  int        value    = 0;
+  const bool overflow = __builtin_sub_overflow(left.get_int(), right.get_int(), &value);
+  result.set_int(value);
+  if (overflow) {
+    LOG_WARN("integer overflow in arithmetic expression");
+    return RC::RANGE_ERROR;
+  }
   return RC::SUCCESS;
 }
 
 RC IntegerType::multiply(const Value &left, const Value &right, Value &result) const
 {
-  result.set_int(left.get_int() * right.get_int());
+  int        value    = 0;
+  const bool overflow = __builtin_mul_overflow(left.get_int(), right.get_int(), &value);
+  result.set_int(value);
+  if (overflow) {
+    LOG_WARN("integer overflow in arithmetic expression");
+    return RC::RANGE_ERROR;
+  }
   return RC::SUCCESS;
 }
 
 RC IntegerType::negative(const Value &val, Value &result) const
 {
-  result.set_int(-val.get_int());
+  int        value    = 0;
+  const bool overflow = __builtin_sub_overflow(int(0), val.get_int(), &value);
+  result.set_int(value);
+  if (overflow) {
+    LOG_WARN("integer overflow in arithmetic expression");
+    return RC::RANGE_ERROR;
+  }
   return RC::SUCCESS;
 }
 
@@ -17,6 +17,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "common/lang/memory.h"
 #include "sql/operator/physical_operator.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/query_cache/query_cache.h"
 
 class SessionEvent;
 class Stmt;
@@ -38,11 +40,15 @@ public:
   Stmt                               *stmt() const { return stmt_; }
   unique_ptr<PhysicalOperator>       &physical_operator() { return operator_; }
   const unique_ptr<PhysicalOperator> &physical_operator() const { return operator_; }
+  unique_ptr<CachedPlan>             &cached_plan() { return cached_plan_; }
+  unique_ptr<CachedResult>           &cached_result() { return cached_result_; }
 
   void set_sql(const char *sql) { sql_ = sql; }
   void set_sql_node(unique_ptr<ParsedSqlNode> sql_node) { sql_node_ = std::move(sql_node); }
   void set_stmt(Stmt *stmt) { stmt_ = stmt; }
   void set_operator(unique_ptr<PhysicalOperator> oper) { operator_ = std::move(oper); }
+  void set_cached_plan(unique_ptr<CachedPlan> plan) { cached_plan_ = std::move(plan); }
+  void set_cached_result(unique_ptr<CachedResult> result) { cached_result_ = std::move(result); }
 
 private:
   SessionEvent                *session_event_ = nullptr;
@@ -50,4 +56,6 @@ private:
   unique_ptr<ParsedSqlNode>    sql_node_;        ///< 语法解析后的SQL命令
   Stmt                        *stmt_ = nullptr;  ///< Resolver之后生成的数据结构
   unique_ptr<PhysicalOperator> operator_;        ///< 生成的执行计划，也可能没有
+  unique_ptr<CachedPlan>       cached_plan_;     ///< 执行计划缓存中的记录，执行结束后把执行计划放回缓存
+  unique_ptr<CachedResult>     cached_result_;   ///< 执行时收集的查询结果，执行结束后放入查询缓存
 };
@@ -21,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 #include "net/buffered_writer.h"
 #include "net/mysql_communicator.h"
 #include "sql/operator/string_list_physical_operator.h"
+#include "sql/plan_cache/prepared_statement.h"
 
 /**
  * @brief MySQL协议相关实现
@@ -39,6 +40,13 @@ const uint32_t CLIENT_OPTIONAL_RESULTSET_METADATA =
 // Support optional extension for query parameters into the COM_QUERY and COM_STMT_EXECUTE packets.
 // const uint32_t CLIENT_QUERY_ATTRIBUTES = (1UL << 27);
 
+// https://dev.mysql.com/doc/dev/mysql-server/latest/my__command_8h.html
+// commands of prepared statements, sent by client in binary protocol
+const int8_t COM_STMT_PREPARE = 0x16;
+const int8_t COM_STMT_EXECUTE = 0x17;
+const int8_t COM_STMT_CLOSE   = 0x19;
+const int8_t COM_STMT_RESET   = 0x1A;
+
 // https://dev.mysql.com/doc/dev/mysql-server/latest/group__group__cs__column__definition__flags.html
 // Column Definition Flags
 // const uint32_t NOT_NULL_FLAG  = 1;
@@ -278,6 +286,59 @@ int store_lenenc_string(char *buf, const char *s)
   return pos + len;
 }
 
+/**
+ * @brief 按照二进制协议把值写入到缓存中
+ * @details [Binary Protocol Value](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_binary_resultset.html)
+ * 数值直接写入，不需要转换成字符串，其它类型按照带长度标识的字符串写入
+ * @param buf  数据缓存
+ * @param value 要写入的值
+ * @param type 列描述中给出的类型，值的类型不同时先做转换
+ * @param[out] len 写入的字节数
+ * @ingroup MySQLProtocolStore
+ */
+RC store_binary_value(char *buf, const Value &value, AttrType type, int &len)
+{
+  Value        casted;
+  const Value *v = &value;
+  if (value.attr_type() != type && type != AttrType::CHARS) {
+    RC rc = Value::cast_to(value, type, casted);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to cast value to column type. value=%s, type=%s", value.to_string().c_str(), attr_type_to_string(type));
+      return rc;
+    }
+    v = &casted;
+  }
+
+  switch (type) {
+    case AttrType::INTS: len = store_int4(buf, v->get_int()); break;
+    case AttrType::BIGINTS: len = store_int8(buf, v->get_bigint()); break;
+    case AttrType::BOOLEANS: len = store_int1(buf, v->get_boolean() ? 1 : 0); break;
+    case AttrType::FLOATS: {
+      const float f = v->get_float();
+      memcpy(buf, &f, sizeof(f));
+      len = sizeof(f);
+    } break;
+    default: len = store_lenenc_string(buf, v->to_string().c_str()); break;
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * @brief 二进制协议中数据的类型
+ * @details 数值类型原样返回，其它类型都按照字符串返回
+ * @ingroup MySQLProtocol
+ */
+AttrType binary_column_type(AttrType type)
+{
+  switch (type) {
+    case AttrType::INTS:
+    case AttrType::BIGINTS:
+    case AttrType::FLOATS:
+    case AttrType::BOOLEANS: return type;
+    default: return AttrType::CHARS;
+  }
+}
+
 /**
  * @brief 每个包都有一个包头
  * @details [MySQL Basic Packet](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_basic_packets.html)
@@ -535,6 +596,217 @@ RC decode_query_packet(vector<char> &net_packet, QueryPacket &query_packet)
   return RC::SUCCESS;
 }
 
+/**
+ * @brief 读取变长编码的整数
+ * @details 与 store_lenenc_int 对应
+ * @return 数据不完整时返回 false
+ */
+bool read_lenenc_int(const vector<char> &packet, size_t &pos, uint64_t &value)
+{
+  if (pos >= packet.size()) {
+    return false;
+  }
+  const uint8_t first = static_cast<uint8_t>(packet[pos++]);
+  int           len   = 0;
+  if (first < 0xFB) {
+    value = first;
+    return true;
+  } else if (first == 0xFC) {
+    len = 2;
+  } else if (first == 0xFD) {
+    len = 3;
+  } else if (first == 0xFE) {
+    len = 8;
+  } else {
+    return false;
+  }
+  if (pos + len > packet.size()) {
+    return false;
+  }
+  value = 0;
+  memcpy(&value, packet.data() + pos, len);
+  pos += len;
+  return true;
+}
+
+/**
+ * @brief 按照二进制协议读取一个参数
+ * @details [Binary Protocol Value](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_binary_resultset.html)
+ * 整数都转换成 BIGINTS，浮点数转换成 FLOATS，与SQL中的常量一致；日期与时间转换成字符串
+ * @param type 参数的类型，高位字节是无符号标识
+ */
+RC decode_binary_value(const vector<char> &packet, size_t &pos, int type, Value &value)
+{
+  const bool  is_unsigned = (type & 0x8000) != 0;
+  const char *data        = packet.data();
+  auto        read_fixed  = [&](void *dest, size_t len) {
+    if (pos + len > packet.size()) {
+      return false;
+    }
+    memcpy(dest, data + pos, len);
+    pos += len;
+    return true;
+  };
+
+  switch (type & 0xFF) {
+    case MYSQL_TYPE_TINY: {
+      int8_t v = 0;
+      if (!read_fixed(&v, sizeof(v))) {
+        return RC::INVALID_ARGUMENT;
+      }
+      value = Value(static_cast<long long>(is_unsigned ? static_cast<uint8_t>(v) : v));
+    } break;
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_YEAR: {
+      int16_t v = 0;
+      if (!read_fixed(&v, sizeof(v))) {
+        return RC::INVALID_ARGUMENT;
+      }
+      value = Value(static_cast<long long>(is_unsigned ? static_cast<uint16_t>(v) : v));
+    } break;
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_INT24: {
+      int32_t v = 0;
+      if (!read_fixed(&v, sizeof(v))) {
+        return RC::INVALID_ARGUMENT;
+      }
+      value = Value(static_cast<long long>(is_unsigned ? static_cast<uint32_t>(v) : v));
+    } break;
+    case MYSQL_TYPE_LONGLONG: {
+      int64_t v = 0;
+      if (!read_fixed(&v, sizeof(v)) || (is_unsigned && v < 0)) {
+        return RC::INVALID_ARGUMENT;
+      }
+      value = Value(static_cast<long long>(v));
+    } break;
+    case MYSQL_TYPE_FLOAT: {
+      float v = 0;
+      if (!read_fixed(&v, sizeof(v))) {
+        return RC::INVALID_ARGUMENT;
+      }
+      value = Value(v);
+    } break;
+    case MYSQL_TYPE_DOUBLE: {
+      double v = 0;
+      if (!read_fixed(&v, sizeof(v))) {
+        return RC::INVALID_ARGUMENT;
+      }
+      value = Value(static_cast<float>(v));
+    } break;
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_TIMESTAMP: {
+      // 长度之后依次是年(2)、月、日、时、分、秒，以及可选的微秒，值为0的部分可以省略
+      uint8_t len      = 0;
+      uint8_t parts[5] = {0, 0, 0, 0, 0};
+      int16_t year     = 0;
+      if (!read_fixed(&len, 1) || (len != 0 && len != 4 && len != 7 && len != 11) || pos + len > packet.size()) {
+        return RC::INVALID_ARGUMENT;
+      }
+      if (len >= 4) {
+        read_fixed(&year, sizeof(year));
+        read_fixed(parts, len >= 7 ? 5 : 2);
+      }
+      if (len == 11) {
+        pos += 4;  // 微秒
+      }
+      char buf[32];
+      if ((type & 0xFF) == MYSQL_TYPE_DATE) {
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d", year, parts[0], parts[1]);
+      } else {
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d", year, parts[0], parts[1], parts[2], parts[3], parts[4]);
+      }
+      value = Value(buf);
+    } break;
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_NEWDECIMAL:
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_ENUM:
+    case MYSQL_TYPE_SET:
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_JSON: {
+      uint64_t len = 0;
+      if (!read_lenenc_int(packet, pos, len) || pos + len > packet.size()) {
+        return RC::INVALID_ARGUMENT;
+      }
+      string s(data + pos, len);
+      pos += len;
+      if ((type & 0xFF) == MYSQL_TYPE_DECIMAL || (type & 0xFF) == MYSQL_TYPE_NEWDECIMAL) {
+        // 定点数以字符串形式发送，按照常量的规则转换成整数或浮点数
+        if (s.find('.') == string::npos) {
+          value = Value(static_cast<long long>(strtoll(s.c_str(), nullptr, 10)));
+        } else {
+          value = Value(static_cast<float>(atof(s.c_str())));
+        }
+      } else {
+        value = Value(s.c_str(), static_cast<int>(s.size()));
+      }
+    } break;
+    default: {
+      LOG_WARN("unsupported parameter type. type=%d", type);
+      return RC::UNSUPPORTED;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+/**
+ * @brief 解析 COM_STMT_EXECUTE 请求中的参数
+ * @details [MySQL Protocol COM_STMT_EXECUTE](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_stmt_execute.html)
+ * 客户端只在重新绑定参数时发送参数的类型，其它时候使用上次执行时的类型
+ */
+RC decode_execute_params(const vector<char> &packet, PreparedStatement &stmt, vector<Value> &params)
+{
+  params.clear();
+  const int param_num = stmt.param_num();
+  if (param_num == 0) {
+    return RC::SUCCESS;
+  }
+
+  size_t       pos        = 10;  // command(1), statement id(4), flags(1), iteration count(4)
+  const size_t bitmap_len = (param_num + 7) / 8;
+  if (pos + bitmap_len + 1 > packet.size()) {
+    return RC::INVALID_ARGUMENT;
+  }
+  const char *null_bitmap = packet.data() + pos;
+  pos += bitmap_len;
+
+  vector<int> &types = stmt.param_types();
+  if (packet[pos++] == 1) {
+    if (pos + 2 * param_num > packet.size()) {
+      return RC::INVALID_ARGUMENT;
+    }
+    types.resize(param_num);
+    for (int i = 0; i < param_num; i++) {
+      types[i] = static_cast<uint8_t>(packet[pos]) | (static_cast<uint8_t>(packet[pos + 1]) << 8);
+      pos += 2;
+    }
+  }
+  if (static_cast<int>(types.size()) != param_num) {
+    LOG_WARN("parameter types are not bound");
+    return RC::INVALID_ARGUMENT;
+  }
+
+  params.resize(param_num);
+  for (int i = 0; i < param_num; i++) {
+    if (null_bitmap[i / 8] & (1 << (i % 8))) {
+      LOG_WARN("null parameter is not supported");
+      return RC::UNSUPPORTED;
+    }
+    RC rc = decode_binary_value(packet, pos, types[i], params[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to decode parameter. index=%d, type=%d, rc=%s", i, types[i], strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 /**
  * @brief MySQL客户端连接时会发起一个"select @@version_comment"的查询，这里对这个查询进行特殊处理
  * @param[out] sql_result 生成的结果
@@ -662,6 +934,7 @@ RC MysqlCommunicator::read_event(SessionEvent *&event)
   LOG_TRACE("recv command from client =%d", command_type);
 
   /// 已经做过握手，接收普通的消息包
+  binary_protocol_ = false;
   if (command_type == 0x03) {  // COM_QUERY，这是一个普通的文本请求
     QueryPacket query_packet;
     rc = decode_query_packet(buf, query_packet);
@@ -678,6 +951,20 @@ RC MysqlCommunicator::read_event(SessionEvent *&event)
 
     event = new SessionEvent(this);
     event->set_query(query_packet.query);
+  } else if (command_type == COM_STMT_PREPARE) {
+    rc = handle_stmt_prepare(buf);
+  } else if (command_type == COM_STMT_EXECUTE) {
+    rc = handle_stmt_execute(buf, event);
+  } else if (command_type == COM_STMT_CLOSE) {
+    // 按照协议，关闭预处理语句时不需要回复
+    if (buf.size() >= 5) {
+      session_->remove_prepared_statement(*(uint32_t *)(buf.data() + 1));
+    }
+  } else if (command_type == COM_STMT_RESET) {
+    // 没有 COM_STMT_SEND_LONG_DATA 发来的数据需要清理
+    OkPacket ok_packet(sequence_id_++);
+    rc = send_packet(ok_packet);
+    writer_->flush();
   } else {
     /// 其它的非文本请求，暂时不支持
     OkPacket ok_packet(sequence_id_);
@@ -691,6 +978,99 @@ RC MysqlCommunicator::read_event(SessionEvent *&event)
   return rc;
 }
 
+/**
+ * @brief 创建预处理语句
+ * @details [MySQL Protocol COM_STMT_PREPARE](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_stmt_prepare.html)
+ * 执行之前无法知道结果的列，这里总是返回0列，执行时的结果中会带有列描述信息
+ */
+RC MysqlCommunicator::handle_stmt_prepare(vector<char> &buf)
+{
+  const string sql(buf.data() + 1, buf.size() - 1);
+
+  PreparedStatement *stmt = nullptr;
+  RC                 rc   = session_->add_prepared_statement(sql, stmt);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to prepare statement. sql=%s, rc=%s", sql.c_str(), strrc(rc));
+    ErrPacket err_packet(sequence_id_++);
+    err_packet.error_code    = static_cast<int>(rc);
+    err_packet.error_message = strrc(rc);
+    rc                       = send_packet(err_packet);
+    writer_->flush();
+    return rc;
+  }
+
+  vector<char> net_packet(16);
+  char        *data = net_packet.data();
+  int          pos  = 3;
+  pos += store_int1(data + pos, sequence_id_++);
+  pos += store_int1(data + pos, 0);  // status: OK
+  pos += store_int4(data + pos, stmt->id());
+  pos += store_int2(data + pos, 0);  // num_columns
+  pos += store_int2(data + pos, stmt->param_num());
+  pos += store_int1(data + pos, 0);  // filler
+  pos += store_int2(data + pos, 0);  // warning_count
+  store_int3(data, pos - 4);
+
+  rc = writer_->writen(data, pos);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to send prepare ok packet. addr=%s, rc=%s", addr(), strrc(rc));
+    return rc;
+  }
+
+  if (stmt->param_num() > 0) {
+    for (int i = 0; i < stmt->param_num() && OB_SUCC(rc); i++) {
+      rc = send_column("", "?", AttrType::CHARS);
+    }
+    if (OB_SUCC(rc)) {
+      rc = send_metadata_eof();
+    }
+  }
+
+  writer_->flush();
+  LOG_TRACE("statement prepared. id=%u, param num=%d, sql=%s", stmt->id(), stmt->param_num(), sql.c_str());
+  return rc;
+}
+
+/**
+ * @brief 执行预处理语句
+ * @details [MySQL Protocol COM_STMT_EXECUTE](https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_stmt_execute.html)
+ */
+RC MysqlCommunicator::handle_stmt_execute(vector<char> &buf, SessionEvent *&event)
+{
+  RC                 rc   = RC::SUCCESS;
+  PreparedStatement *stmt = nullptr;
+  if (buf.size() >= 5) {
+    stmt = session_->find_prepared_statement(*(uint32_t *)(buf.data() + 1));
+  }
+
+  string        sql;
+  vector<Value> params;
+  if (nullptr == stmt) {
+    LOG_WARN("no such prepared statement");
+    rc = RC::NOTFOUND;
+  } else if (OB_FAIL(rc = decode_execute_params(buf, *stmt, params))) {
+    LOG_WARN("failed to decode execute params. statement id=%u, rc=%s", stmt->id(), strrc(rc));
+  } else if (OB_FAIL(rc = stmt->render(params, sql))) {
+    LOG_WARN("failed to render prepared statement. statement id=%u, rc=%s", stmt->id(), strrc(rc));
+  }
+
+  if (OB_FAIL(rc)) {
+    ErrPacket err_packet(sequence_id_++);
+    err_packet.error_code    = static_cast<int>(rc);
+    err_packet.error_message = strrc(rc);
+    rc                       = send_packet(err_packet);
+    writer_->flush();
+    return rc;
+  }
+
+  LOG_TRACE("execute prepared statement. id=%u, sql=%s", stmt->id(), sql.c_str());
+  sql.append(1, ';');
+  event = new SessionEvent(this);
+  event->set_query(sql);
+  binary_protocol_ = true;
+  return rc;
+}
+
 RC MysqlCommunicator::write_state(SessionEvent *event, bool &need_disconnect)
 {
   SqlResult *sql_result = event->sql_result();
@@ -751,7 +1131,7 @@ RC MysqlCommunicator::write_result(SessionEvent *event, bool &need_disconnect)
 
     need_disconnect = false;
   } else {
-    if (RC::SUCCESS != sql_result->return_code() || !sql_result->has_operator()) {
+    if (RC::SUCCESS != sql_result->return_code() || (!sql_result->has_operator() && !sql_result->has_cached_result())) {
       return write_state(event, need_disconnect);
     }
 
@@ -770,7 +1150,10 @@ RC MysqlCommunicator::write_result(SessionEvent *event, bool &need_disconnect)
     } else {
 
       // send metadata : Column Definition
-      rc = send_column_definition(sql_result, need_disconnect);
+      // 二进制协议需要知道每一列的类型，在发送第一行数据时再发送列描述信息
+      if (!binary_protocol_) {
+        rc = send_column_definition(sql_result, need_disconnect);
+      }
       if (rc != RC::SUCCESS) {
         sql_result->close();
         return rc;
@@ -816,7 +1199,7 @@ RC MysqlCommunicator::send_packet(const BasePacket &packet)
  * 先发送当前有多少个列
  * 然后发送N个包，告诉客户端每个列的信息
  */
-RC MysqlCommunicator::send_column_definition(SqlResult *sql_result, bool &need_disconnect)
+RC MysqlCommunicator::send_column_definition(SqlResult *sql_result, bool &need_disconnect, const vector<AttrType> *types)
 {
   RC rc = RC::SUCCESS;
 
@@ -858,72 +1241,18 @@ RC MysqlCommunicator::send_column_definition(SqlResult *sql_result, bool &need_d
   }
 
   for (int i = 0; i < cell_num; i++) {
-    net_packet.resize(1024);
-    buf = net_packet.data();
-    pos = 0;
-
-    pos += 3;
-    store_int1(buf + pos, sequence_id_++);
-    pos += 1;
-
-    const TupleCellSpec &spec      = tuple_schema.cell_at(i);
-    const char          *catalog   = "def";  // The catalog used. Currently always "def"
-    const char          *schema    = "sys";  // schema name
-    const char          *table     = spec.table_name();
-    const char          *org_table = spec.table_name();
-    const char          *name      = spec.alias();
-    // const char *org_name = spec.field_name();
-    const char *org_name         = spec.alias();
-    int         fixed_len_fields = 0x0c;
-    int         character_set    = 33;
-    int         column_length    = 16384;
-    int         type             = MYSQL_TYPE_VAR_STRING;
-    int16_t     flags            = 0;
-    int8_t      decimals         = 0x1f;
-
-    pos += store_lenenc_string(buf + pos, catalog);
-    pos += store_lenenc_string(buf + pos, schema);
-    pos += store_lenenc_string(buf + pos, table);
-    pos += store_lenenc_string(buf + pos, org_table);
-    pos += store_lenenc_string(buf + pos, name);
-    pos += store_lenenc_string(buf + pos, org_name);
-    pos += store_lenenc_int(buf + pos, fixed_len_fields);
-    store_int2(buf + pos, character_set);
-    pos += 2;
-    store_int4(buf + pos, column_length);
-    pos += 4;
-    store_int1(buf + pos, type);
-    pos += 1;
-    store_int2(buf + pos, flags);
-    pos += 2;
-    store_int1(buf + pos, decimals);
-    pos += 1;
-    store_int2(buf + pos, 0);  // 按照mariadb的文档描述，最后还有一个unused字段int<2>，不过mysql的文档没有给出这样的描述
-    pos += 2;
-
-    payload_length = pos - 4;
-    store_int3(buf, payload_length);
-    net_packet.resize(pos);
-
-    rc = writer_->writen(net_packet.data(), net_packet.size());
+    const TupleCellSpec &spec = tuple_schema.cell_at(i);
+    const AttrType       type = types != nullptr ? (*types)[i] : AttrType::CHARS;
+    rc                        = send_column(spec.table_name(), spec.alias(), type);
     if (OB_FAIL(rc)) {
-      LOG_WARN("failed to write column definition to client. addr=%s, error=%s", addr(), strerror(errno));
       need_disconnect = true;
       return rc;
     }
   }
-
-  if (!(client_capabilities_flag_ & CLIENT_DEPRECATE_EOF)) {
-    EofPacket eof_packet;
-    eof_packet.packet_header.sequence_id = sequence_id_++;
-    eof_packet.status_flags              = 0x02;
-    rc                                   = send_packet(eof_packet);
-    if (rc != RC::SUCCESS) {
-      need_disconnect = true;
-      LOG_WARN("failed to send eof packet to client. addr=%s, error=%s", addr(), strerror(errno));
-    }
-  } else {
-    LOG_TRACE("client use CLIENT_DEPRECATE_EOF");
+  rc = send_metadata_eof();
+  if (rc != RC::SUCCESS) {
+    need_disconnect = true;
+    LOG_WARN("failed to send eof packet to client. addr=%s, error=%s", addr(), strerror(errno));
   }
 
   LOG_TRACE("send column definition to client done");
@@ -931,6 +1260,105 @@ RC MysqlCommunicator::send_column_definition(SqlResult *sql_result, bool &need_d
   return RC::SUCCESS;
 }
 
+/**
+ * 发送一个列定义包
+ * 文本协议中所有的列都按照字符串描述，二进制协议中数值类型的列按照实际的类型描述
+ */
+RC MysqlCommunicator::send_column(const char *table_name, const char *column_name, AttrType attr_type)
+{
+  vector<char> net_packet;
+  net_packet.resize(1024);
+  char *buf = net_packet.data();
+  int   pos = 0;
+
+  pos += 3;
+  store_int1(buf + pos, sequence_id_++);
+  pos += 1;
+
+  const char *catalog   = "def";  // The catalog used. Currently always "def"
+  const char *schema    = "sys";  // schema name
+  const char *table     = table_name;
+  const char *org_table = table_name;
+  const char *name      = column_name;
+  // const char *org_name = spec.field_name();
+  const char *org_name         = column_name;
+  int         fixed_len_fields = 0x0c;
+  int         character_set    = 33;
+  int         column_length    = 16384;
+  int         type             = MYSQL_TYPE_VAR_STRING;
+  int16_t     flags            = 0;
+  int8_t      decimals         = 0x1f;
+
+  switch (attr_type) {
+    case AttrType::INTS: {
+      character_set = 63;  // binary
+      column_length = 11;
+      type          = MYSQL_TYPE_LONG;
+      decimals      = 0;
+    } break;
+    case AttrType::BIGINTS: {
+      character_set = 63;
+      column_length = 20;
+      type          = MYSQL_TYPE_LONGLONG;
+      decimals      = 0;
+    } break;
+    case AttrType::FLOATS: {
+      character_set = 63;
+      column_length = 12;
+      type          = MYSQL_TYPE_FLOAT;
+    } break;
+    case AttrType::BOOLEANS: {
+      character_set = 63;
+      column_length = 1;
+      type          = MYSQL_TYPE_TINY;
+      decimals      = 0;
+    } break;
+    default: break;
+  }
+
+  pos += store_lenenc_string(buf + pos, catalog);
+  pos += store_lenenc_string(buf + pos, schema);
+  pos += store_lenenc_string(buf + pos, table);
+  pos += store_lenenc_string(buf + pos, org_table);
+  pos += store_lenenc_string(buf + pos, name);
+  pos += store_lenenc_string(buf + pos, org_name);
+  pos += store_lenenc_int(buf + pos, fixed_len_fields);
+  store_int2(buf + pos, character_set);
+  pos += 2;
+  store_int4(buf + pos, column_length);
+  pos += 4;
+  store_int1(buf + pos, type);
+  pos += 1;
+  store_int2(buf + pos, flags);
+  pos += 2;
+  store_int1(buf + pos, decimals);
+  pos += 1;
+  store_int2(buf + pos, 0);  // 按照mariadb的文档描述，最后还有一个unused字段int<2>，不过mysql的文档没有给出这样的描述
+  pos += 2;
+
+  int payload_length = pos - 4;
+  store_int3(buf, payload_length);
+  net_packet.resize(pos);
+
+  RC rc = writer_->writen(net_packet.data(), net_packet.size());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to write column definition to client. addr=%s, error=%s", addr(), strerror(errno));
+  }
+  return rc;
+}
+
+RC MysqlCommunicator::send_metadata_eof()
+{
+  if (client_capabilities_flag_ & CLIENT_DEPRECATE_EOF) {
+    LOG_TRACE("client use CLIENT_DEPRECATE_EOF");
+    return RC::SUCCESS;
+  }
+  EofPacket eof_packet;
+  eof_packet.packet_header.sequence_id = sequence_id_++;
+  eof_packet.status_flags              = 0x02;
+  return send_packet(eof_packet);
+}
+
 /**
  * 发送每行数据
  * 一行一个包
@@ -945,7 +1373,11 @@ RC MysqlCommunicator::send_result_rows(SessionEvent *event, SqlResult *sql_resul
   packet.resize(4 * 1024 * 1024);  // TODO warning: length cannot be fix
 
   int    affected_rows = 0;
-  if (event->session()->get_execution_mode() == ExecutionMode::CHUNK_ITERATOR
+  if (binary_protocol_ && !no_column_def) {
+    rc = write_binary_result(event, sql_result, packet, affected_rows, need_disconnect);
+  } else if (sql_result->has_cached_result()) {
+    rc = write_cached_result(sql_result, packet, affected_rows, need_disconnect);
+  } else if (event->session()->get_execution_mode() == ExecutionMode::CHUNK_ITERATOR
       && event->session()->used_chunk_mode()) {
     rc = write_chunk_result(sql_result, packet, affected_rows, need_disconnect);
   } else {
@@ -1025,7 +1457,8 @@ RC MysqlCommunicator::write_chunk_result(SqlResult *sql_result, vector<char> &pa
     if (column_num == 0) {
       continue;
     }
-    for (int i = 0; i < chunk.rows(); i++) {
+    for (int i = 0; i < chunk.selected_rows(); i++) {
+      const int row_idx = chunk.selected_row(i);
       affected_rows++;
       // https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_query_response_text_resultset.html
       // https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_query_response_text_resultset_row.html
@@ -1037,7 +1470,7 @@ RC MysqlCommunicator::write_chunk_result(SqlResult *sql_result, vector<char> &pa
       pos += store_int1(buf + pos, sequence_id_++);
 
       for (int col_idx = 0; col_idx < column_num; col_idx++) {
-        Value value = chunk.get_value(col_idx, i);
+        Value value = chunk.get_value(col_idx, row_idx);
         pos += store_lenenc_string(buf + pos, value.to_string().c_str());
       }
 
@@ -1053,3 +1486,130 @@ RC MysqlCommunicator::write_chunk_result(SqlResult *sql_result, vector<char> &pa
   }
   return rc;
 }
+
+RC MysqlCommunicator::write_cached_result(SqlResult *sql_result, vector<char> &packet, int &affected_rows, bool &need_disconnect)
+{
+  RC                  rc     = RC::SUCCESS;
+  const CachedResult *result = sql_result->cached_result();
+  for (int row = 0; row < result->row_num(); row++) {
+    affected_rows++;
+    char *buf = packet.data();
+    int   pos = 0;
+
+    pos += 3;
+    pos += store_int1(buf + pos, sequence_id_++);
+
+    for (int col = 0; col < result->column_num(); col++) {
+      pos += store_lenenc_string(buf + pos, result->cell(row, col).c_str());
+    }
+
+    int payload_length = pos - 4;
+    store_int3(buf, payload_length);
+    rc = writer_->writen(buf, pos);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to send row packet to client. addr=%s, error=%s", addr(), strerror(errno));
+      need_disconnect = true;
+      return rc;
+    }
+  }
+  return rc;
+}
+
+/**
+ * 二进制协议的行数据
+ * https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_binary_resultset.html
+ * 每行以0x00开头，然后是NULL位图(前两位保留)，最后是按照列类型编码的数据
+ */
+RC MysqlCommunicator::write_binary_result(
+    SessionEvent *event, SqlResult *sql_result, vector<char> &packet, int &affected_rows, bool &need_disconnect)
+{
+  const int        cell_num = sql_result->tuple_schema().cell_num();
+  vector<AttrType> types;
+  vector<Value>    values(cell_num);
+
+  auto write_row = [&]() -> RC {
+    RC rc = RC::SUCCESS;
+    if (types.empty()) {
+      for (const Value &value : values) {
+        types.push_back(binary_column_type(value.attr_type()));
+      }
+      rc = send_column_definition(sql_result, need_disconnect, &types);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+
+    affected_rows++;
+    char *buf = packet.data();
+    int   pos = 0;
+
+    pos += 3;
+    pos += store_int1(buf + pos, sequence_id_++);
+    pos += store_int1(buf + pos, 0);
+    const int bitmap_len = (cell_num + 7 + 2) / 8;
+    memset(buf + pos, 0, bitmap_len);
+    pos += bitmap_len;
+
+    for (int i = 0; i < cell_num; i++) {
+      int len = 0;
+      rc      = store_binary_value(buf + pos, values[i], types[i], len);
+      if (OB_FAIL(rc)) {
+        sql_result->set_return_code(rc);
+        return rc;
+      }
+      pos += len;
+    }
+
+    store_int3(buf, pos - 4);
+    rc = writer_->writen(buf, pos);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to send row packet to client. addr=%s, error=%s", addr(), strerror(errno));
+      need_disconnect = true;
+    }
+    return rc;
+  };
+
+  RC rc = RC::SUCCESS;
+  if (sql_result->has_cached_result()) {
+    // 缓存的结果中只有字符串，所有列都按照字符串返回
+    const CachedResult *result = sql_result->cached_result();
+    for (int row = 0; row < result->row_num() && OB_SUCC(rc); row++) {
+      for (int col = 0; col < cell_num; col++) {
+        values[col].set_string(result->cell(row, col).c_str());
+      }
+      rc = write_row();
+    }
+  } else if (event->session()->get_execution_mode() == ExecutionMode::CHUNK_ITERATOR
+             && event->session()->used_chunk_mode()) {
+    Chunk chunk;
+    while (OB_SUCC(rc) && RC::SUCCESS == (rc = sql_result->next_chunk(chunk))) {
+      for (int i = 0; i < chunk.selected_rows() && OB_SUCC(rc); i++) {
+        const int row_idx = chunk.selected_row(i);
+        for (int col = 0; col < cell_num; col++) {
+          values[col] = chunk.get_value(col, row_idx);
+        }
+        rc = write_row();
+      }
+    }
+  } else {
+    Tuple *tuple = nullptr;
+    while (OB_SUCC(rc) && RC::SUCCESS == (rc = sql_result->next_tuple(tuple))) {
+      for (int col = 0; col < cell_num && OB_SUCC(rc); col++) {
+        rc = tuple->cell_at(col, values[col]);
+      }
+      if (OB_SUCC(rc)) {
+        rc = write_row();
+      }
+    }
+  }
+
+  if (types.empty() && !need_disconnect) {
+    // 没有数据时无法知道列的类型，都按照字符串描述
+    types.assign(cell_num, AttrType::CHARS);
+    RC def_rc = send_column_definition(sql_result, need_disconnect, &types);
+    if (OB_FAIL(def_rc)) {
+      return def_rc;
+    }
+  }
+  return rc;
+}
@@ -16,6 +16,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "net/communicator.h"
 #include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/type/attr_type.h"
 
 class SqlResult;
 class BasePacket;
@@ -71,8 +73,19 @@ private:
    * @brief 返回客户端列描述信息
    * @details 根据MySQL text protocol 描述，普通的结果分为列信息描述和行数据。
    * 这里就分为两个函数
+   * @param types 二进制协议中每一列的类型，为空时所有列都按照字符串描述
    */
-  RC send_column_definition(SqlResult *sql_result, bool &need_disconnect);
+  RC send_column_definition(SqlResult *sql_result, bool &need_disconnect, const vector<AttrType> *types = nullptr);
+
+  /**
+   * @brief 发送一个列定义包，预处理语句的参数描述也使用这个包
+   */
+  RC send_column(const char *table_name, const char *column_name, AttrType attr_type);
+
+  /**
+   * @brief 列定义结束后的EOF包，客户端设置了 CLIENT_DEPRECATE_EOF 时不发送
+   */
+  RC send_metadata_eof();
 
   /**
    * @brief 返回客户端行数据
@@ -93,6 +106,26 @@ private:
 
   RC write_tuple_result(SqlResult *sql_result, vector<char> &packet, int &affected_rows, bool &need_disconnect);
   RC write_chunk_result(SqlResult *sql_result, vector<char> &packet, int &affected_rows, bool &need_disconnect);
+  RC write_cached_result(SqlResult *sql_result, vector<char> &packet, int &affected_rows, bool &need_disconnect);
+
+  /**
+   * @brief 处理 COM_STMT_PREPARE，创建预处理语句并返回参数个数
+   */
+  RC handle_stmt_prepare(vector<char> &buf);
+
+  /**
+   * @brief 处理 COM_STMT_EXECUTE，把参数写回SQL，生成普通的SQL请求
+   * @param[out] event 参数正确时生成的请求，否则为空并且已经给客户端返回错误
+   */
+  RC handle_stmt_execute(vector<char> &buf, SessionEvent *&event);
+
+  /**
+   * @brief 按照二进制协议返回查询结果
+   * @details 数值类型的列按照二进制格式发送，不需要再转换成字符串。
+   * 列的类型在拿到第一行数据后才能确定，所以列描述信息也在这里发送
+   */
+  RC write_binary_result(
+      SessionEvent *event, SqlResult *sql_result, vector<char> &packet, int &affected_rows, bool &need_disconnect);
 
 private:
   //! 握手阶段(鉴权)，需要做一些特殊处理，所以加个字段单独标记
@@ -104,4 +137,7 @@ private:
   //! 在一次通讯过程中(一个任务的请求与处理)，每个包(packet)都有一个sequence id
   //! 这个sequence id是递增的
   int8_t sequence_id_ = 0;
+
+  //! 当前请求是否来自 COM_STMT_EXECUTE，结果需要按照二进制协议返回
+  bool binary_protocol_ = false;
 };
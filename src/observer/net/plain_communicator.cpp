@@ -200,7 +200,7 @@ RC PlainCommunicator::write_result_internal(SessionEvent *event, bool &need_disc
 
   SqlResult *sql_result = event->sql_result();
 
-  if (RC::SUCCESS != sql_result->return_code() || !sql_result->has_operator()) {
+  if (RC::SUCCESS != sql_result->return_code() || (!sql_result->has_operator() && !sql_result->has_cached_result())) {
     return write_state(event, need_disconnect);
   }
 
@@ -255,7 +255,9 @@ RC PlainCommunicator::write_result_internal(SessionEvent *event, bool &need_disc
   }
 
   rc = RC::SUCCESS;
-  if (event->session()->get_execution_mode() == ExecutionMode::CHUNK_ITERATOR && event->session()->used_chunk_mode()) {
+  if (sql_result->has_cached_result()) {
+    rc = write_cached_result(sql_result);
+  } else if (event->session()->get_execution_mode() == ExecutionMode::CHUNK_ITERATOR && event->session()->used_chunk_mode()) {
     rc = write_chunk_result(sql_result);
   } else {
     rc = write_tuple_result(sql_result);
@@ -341,6 +343,45 @@ RC PlainCommunicator::write_tuple_result(SqlResult *sql_result)
   return rc;
 }
 
+RC PlainCommunicator::write_cached_result(SqlResult *sql_result)
+{
+  RC                  rc     = RC::SUCCESS;
+  const CachedResult *result = sql_result->cached_result();
+  for (int row = 0; row < result->row_num(); row++) {
+    for (int col = 0; col < result->column_num(); col++) {
+      if (col != 0) {
+        const char *delim = " | ";
+
+        rc = writer_->writen(delim, strlen(delim));
+        if (OB_FAIL(rc)) {
+          LOG_WARN("failed to send data to client. err=%s", strerror(errno));
+          sql_result->close();
+          return rc;
+        }
+      }
+
+      const string &cell_str = result->cell(row, col);
+
+      rc = writer_->writen(cell_str.data(), cell_str.size());
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to send data to client. err=%s", strerror(errno));
+        sql_result->close();
+        return rc;
+      }
+    }
+
+    char newline = '\n';
+
+    rc = writer_->writen(&newline, 1);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to send data to client. err=%s", strerror(errno));
+      sql_result->close();
+      return rc;
+    }
+  }
+  return rc;
+}
+
 RC PlainCommunicator::write_chunk_result(SqlResult *sql_result)
 {
   RC    rc = RC::SUCCESS;
@@ -368,12 +409,18 @@ RC PlainCommunicator::write_chunk_result(SqlResult *sql_result)
         sql_result->close();
         return rc;
       }
+      if (OB_FAIL(rc = chunk.compact())) {
+        LOG_WARN("failed to compact chunk. rc=%s", strrc(rc));
+        sql_result->close();
+        return rc;
+      }
       view_table->insert_chunk(chunk);
 
       chunk.reset();
       continue;
     }
-    for (int row_idx = 0; row_idx < chunk.rows(); row_idx++) {
+    for (int i = 0; i < chunk.selected_rows(); i++) {
+      const int row_idx = chunk.selected_row(i);
       for (int col_idx = 0; col_idx < col_num; col_idx++) {
         if (col_idx != 0) {
           const char *delim = " | ";
@@ -411,6 +458,9 @@ RC PlainCommunicator::write_chunk_result(SqlResult *sql_result)
 
   if (rc == RC::RECORD_EOF) {
     rc = RC::SUCCESS;
+  } else if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get next chunk. rc=%s", strrc(rc));
+    sql_result->close();
   }
   return rc;
 }
\ No newline at end of file
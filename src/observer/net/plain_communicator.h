@@ -39,6 +39,7 @@ private:
   RC write_result_internal(SessionEvent *event, bool &need_disconnect);
   RC write_tuple_result(SqlResult *sql_result);
   RC write_chunk_result(SqlResult *sql_result);
+  RC write_cached_result(SqlResult *sql_result);
 
 protected:
   vector<char> send_message_delimiter_;  ///< 发送消息分隔符
@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "session/session.h"
+#include "sql/plan_cache/prepared_statement.h"
 #include "common/global_context.h"
 #include "storage/db/db.h"
 #include "storage/default/default_handler.h"
@@ -24,6 +25,8 @@ Session &Session::default_session()
   return session;
 }
 
+Session::Session() = default;
+
 Session::Session(const Session &other) : db_(other.db_) {}
 
 Session::~Session()
@@ -57,6 +60,31 @@ void Session::set_current_db(const string &dbname)
   db_ = db;
 }
 
+RC Session::add_prepared_statement(const string &sql, PreparedStatement *&stmt)
+{
+  if (prepared_statements_.size() >= MAX_PREPARED_STATEMENTS) {
+    LOG_WARN("too many prepared statements. count=%ld", prepared_statements_.size());
+    return RC::NOMEM;
+  }
+
+  auto prepared = make_unique<PreparedStatement>(++last_statement_id_, sql);
+  RC   rc       = prepared->init();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  stmt = prepared.get();
+  prepared_statements_[stmt->id()] = std::move(prepared);
+  return rc;
+}
+
+PreparedStatement *Session::find_prepared_statement(uint32_t id) const
+{
+  auto iter = prepared_statements_.find(id);
+  return iter == prepared_statements_.end() ? nullptr : iter->second.get();
+}
+
+void Session::remove_prepared_statement(uint32_t id) { prepared_statements_.erase(id); }
+
 void Session::set_trx_multi_operation_mode(bool multi_operation_mode)
 {
   trx_multi_operation_mode_ = multi_operation_mode;
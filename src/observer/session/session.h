@@ -15,8 +15,12 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/types.h"
+#include "common/lang/memory.h"
 #include "common/lang/string.h"
+#include "common/lang/unordered_map.h"
+#include "common/sys/rc.h"
 
+class PreparedStatement;
 class Trx;
 class Db;
 class SessionEvent;
@@ -35,7 +39,11 @@ public:
   static Session &default_session();
 
 public:
-  Session() = default;
+  /// 一个会话最多同时保留的预处理语句个数
+  static constexpr size_t MAX_PREPARED_STATEMENTS = 1024;
+
+public:
+  Session();
   ~Session();
 
   Session(const Session &other);
@@ -88,6 +96,28 @@ public:
   void set_use_cascade(bool use_cascade) { use_cascade_ = use_cascade; }
   bool use_cascade() const { return use_cascade_; }
 
+  void    set_operator_memory_limit(int64_t limit) { operator_memory_limit_ = limit; }
+  int64_t operator_memory_limit() const { return operator_memory_limit_; }
+
+  void set_parallel_degree(int parallel_degree) { parallel_degree_ = parallel_degree; }
+  int  parallel_degree() const { return parallel_degree_; }
+
+  void set_pipeline_execution(bool pipeline_execution) { pipeline_execution_ = pipeline_execution; }
+  bool pipeline_execution() const { return pipeline_execution_; }
+
+  void set_plan_cache(bool plan_cache) { plan_cache_ = plan_cache; }
+  bool plan_cache_on() const { return plan_cache_; }
+
+  void set_query_cache(bool query_cache) { query_cache_ = query_cache; }
+  bool query_cache_on() const { return query_cache_; }
+
+  /**
+   * @brief 创建服务端的预处理语句，会话关闭时一起释放
+   */
+  RC                 add_prepared_statement(const string &sql, PreparedStatement *&stmt);
+  PreparedStatement *find_prepared_statement(uint32_t id) const;
+  void               remove_prepared_statement(uint32_t id);
+
   void          set_execution_mode(const ExecutionMode mode) { execution_mode_ = mode; }
   ExecutionMode get_execution_mode() const { return execution_mode_; }
 
@@ -118,6 +148,15 @@ private:
   bool hash_join_   = false;  ///< 是否使用hash join
   bool use_cascade_ = false;  ///< 是否使用 cascade 优化器
 
+  int64_t operator_memory_limit_ = 0;  ///< 单个算子可以使用的内存（字节），超过后溢出到磁盘。0 表示不限制
+  int     parallel_degree_       = 1;  ///< chunk_iterator 模式下并行执行的线程数，1 表示不并行
+  bool    pipeline_execution_    = false;  ///< chunk_iterator 模式下是否按推模式的流水线执行
+  bool    plan_cache_            = true;   ///< 是否使用执行计划缓存
+  bool    query_cache_           = true;   ///< 是否使用查询结果缓存
+
+  unordered_map<uint32_t, unique_ptr<PreparedStatement>> prepared_statements_;
+  uint32_t                                               last_statement_id_ = 0;
+
   // 是否使用了 `chunk_iterator` 模式。 只有在设置了 `chunk_iterator`
   // 并且可以生成相关物理执行计划时才会使用 `chunk_iterator` 模式。
   bool used_chunk_mode_ = false;
@@ -10,12 +10,17 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/executor/analyze_table_executor.h"
 
+#include "common/lang/cmath.h"
+#include "common/lang/thread.h"
 #include "common/log/log.h"
 #include "event/session_event.h"
 #include "event/sql_event.h"
 #include "session/session.h"
 #include "sql/stmt/analyze_table_stmt.h"
+#include "storage/common/meta_util.h"
 #include "storage/db/db.h"
+#include "storage/record/morsel_scheduler.h"
+#include "storage/record/record_manager.h"
 #include "storage/table/table.h"
 #include "catalog/catalog.h"
 #include "storage/record/record_scanner.h"
@@ -39,23 +44,8 @@ RC AnalyzeTableExecutor::execute(SQLStageEvent *sql_event)
   Db    *db    = session->get_current_db();
   Table *table = db->find_table(table_name);
   if (table != nullptr) {
-    // TODO: optimize the analyze table compute. we can only get table statistics from metadata
-    // Don't really scan the whole table!!
-    int table_id = table->table_id();
-    table->get_record_scanner(scanner_, session->current_trx(), ReadWriteMode::READ_ONLY);
-    Record dummy;
-    int row_nums = 0;
-    while (OB_SUCC(rc = scanner_->next(dummy))) {
-      row_nums++;
-    }
-    if (rc == RC::RECORD_EOF) {
-      rc = RC::SUCCESS;
-    } else {
-      return rc;
-    }
-  
-    TableStats stats(row_nums);
-    Catalog::get_instance().update_table_stats(table_id, stats);
+    rc = analyze_table(
+        table, session->current_trx(), analyze_table_stmt->sample_percent(), session->parallel_degree());
   } else {
     sql_result->set_return_code(RC::SCHEMA_TABLE_NOT_EXIST);
     sql_result->set_state_string("Table not exists");
@@ -63,6 +53,205 @@ RC AnalyzeTableExecutor::execute(SQLStageEvent *sql_event)
   return rc;
 }
 
+RC AnalyzeTableExecutor::analyze_table(Table *table, Trx *trx, double sample_percent, int parallel_degree)
+{
+  // 收集期间的修改留到下一次
+  const int64_t modified_rows = table->modified_rows();
+
+  TableStats stats;
+  RC         rc = collect_table_stats(table, trx, stats, sample_percent, parallel_degree);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to collect table stats. table=%s, rc=%s", table->name(), strrc(rc));
+    return rc;
+  }
+
+  const int table_id = table->table_id();
+  Catalog::get_instance().update_table_stats(table_id, stats);
+  rc = Catalog::get_instance().save_table_stats(table_id, table_stats_file(table->db()->path().c_str(), table->name()));
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to save table stats. table=%s, rc=%s", table->name(), strrc(rc));
+    return rc;
+  }
+  table->reset_modified_rows(modified_rows);
+  return rc;
+}
+
+bool AnalyzeTableExecutor::need_auto_analyze(const Table *table)
+{
+  const int64_t row_nums  = Catalog::get_instance().get_table_stats(table->table_id()).row_nums;
+  const double  threshold = std::max(static_cast<double>(AUTO_ANALYZE_MIN_ROWS), row_nums * AUTO_ANALYZE_RATIO);
+  return table->modified_rows() >= threshold;
+}
+
+RC AnalyzeTableExecutor::auto_analyze(Table *table, Trx *trx, int parallel_degree)
+{
+  if (!need_auto_analyze(table)) {
+    return RC::SUCCESS;
+  }
+  LOG_INFO("table stats are stale, analyze again. table=%s, modified rows=%ld", table->name(), table->modified_rows());
+  AnalyzeTableExecutor executor;
+  return executor.analyze_table(table, trx, 0, parallel_degree);
+}
+
+RC AnalyzeTableExecutor::collect_table_stats(
+    Table *table, Trx *trx, TableStats &stats, double sample_percent, int parallel_degree)
+{
+  const TableMeta             &table_meta = table->table_meta();
+  vector<ColumnStatsCollector> collectors;
+  for (int i = table_meta.sys_field_num(); i < table_meta.field_num(); i++) {
+    const FieldMeta *field_meta = table_meta.field(i);
+    collectors.emplace_back(field_meta->name(), field_meta->type(), static_cast<uint64_t>(table->table_id()));
+  }
+
+  RC     rc         = RC::SUCCESS;
+  double table_rows = 0;
+  if (table_meta.storage_engine() == StorageEngine::HEAP) {
+    rc = collect_by_chunk(table, trx, sample_percent, parallel_degree, collectors, table_rows);
+  } else {
+    rc = collect_by_record(table, trx, collectors, table_rows);
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  stats.row_nums = static_cast<int>(llround(table_rows));
+  stats.column_stats.resize(collectors.size());
+  for (size_t i = 0; i < collectors.size(); i++) {
+    collectors[i].finish(table_rows, stats.column_stats[i]);
+    LOG_TRACE("column stats of %s: %s", table_meta.name(), stats.column_stats[i].to_string().c_str());
+  }
+  LOG_INFO("analyze table %s. rows=%d", table_meta.name(), stats.row_nums);
+  return rc;
+}
+
+RC AnalyzeTableExecutor::collect_by_chunk(Table *table, Trx *trx, double sample_percent, int parallel_degree,
+    vector<ColumnStatsCollector> &collectors, double &table_rows)
+{
+  // 随机选出一部分页面，种子固定，多次分析同一张表的结果是稳定的
+  MorselScheduler scheduler;
+  const uint64_t  seed = static_cast<uint64_t>(table->table_id());
+  if (sample_percent > 0) {
+    scheduler.set_sample(sample_percent, 0, seed);
+  } else {
+    scheduler.set_sample(100, MAX_SAMPLE_PAGES, seed);
+  }
+
+  // 每个线程一个扫描器与一组 collector，扫描器在启动线程前打开
+  const TableMeta                     &table_meta = table->table_meta();
+  const int                            workers    = std::max(parallel_degree, 1);
+  vector<unique_ptr<ChunkFileScanner>> scanners;
+  vector<vector<ColumnStatsCollector>> worker_collectors(workers);
+  RC                                   rc = RC::SUCCESS;
+  for (int w = 0; w < workers && OB_SUCC(rc); w++) {
+    for (const ColumnStatsCollector &collector : collectors) {
+      worker_collectors[w].emplace_back(collector.field_name(), collector.attr_type(), seed + w);
+    }
+    auto scanner = make_unique<ChunkFileScanner>();
+    if (OB_FAIL(rc = table->get_chunk_scanner(*scanner, trx, ReadWriteMode::READ_ONLY))) {
+      LOG_WARN("failed to get chunk scanner. rc=%s", strrc(rc));
+    } else if (OB_FAIL(rc = scanner->set_morsel_scheduler(&scheduler))) {
+      LOG_WARN("failed to set morsel scheduler. rc=%s", strrc(rc));
+    }
+    scanner->set_bypass_cache(true);
+    scanners.emplace_back(std::move(scanner));
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  vector<RC>      results(workers, RC::SUCCESS);
+  vector<int64_t> sampled_rows(workers, 0);
+  auto            collect = [&](int w) {
+    // chunk 中列的 id 与 field_id 相同，只读取用户字段
+    Chunk chunk;
+    for (int i = table_meta.sys_field_num(); i < table_meta.field_num(); i++) {
+      chunk.add_column(make_unique<Column>(*table_meta.field(i)), table_meta.field(i)->field_id());
+    }
+    RC rc = RC::SUCCESS;
+    while (OB_SUCC(rc = scanners[w]->next_chunk(chunk))) {
+      for (size_t i = 0; i < worker_collectors[w].size(); i++) {
+        worker_collectors[w][i].add(chunk.column(i), chunk.rows());
+      }
+      sampled_rows[w] += chunk.rows();
+    }
+    scanners[w]->close_scan();
+    results[w] = rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+  };
+  if (workers == 1) {
+    collect(0);
+  } else {
+    vector<thread> threads;
+    for (int w = 0; w < workers; w++) {
+      threads.emplace_back(collect, w);
+    }
+    for (thread &t : threads) {
+      t.join();
+    }
+  }
+
+  int64_t total_sampled_rows = 0;
+  for (int w = 0; w < workers; w++) {
+    if (OB_FAIL(results[w])) {
+      LOG_WARN("failed to scan chunk. rc=%s", strrc(results[w]));
+      return results[w];
+    }
+    for (size_t i = 0; i < collectors.size(); i++) {
+      collectors[i].merge(worker_collectors[w][i]);
+    }
+    total_sampled_rows += sampled_rows[w];
+  }
+
+  table_rows = scheduler.page_num() == 0
+                   ? 0
+                   : static_cast<double>(total_sampled_rows) * scheduler.total_page_num() / scheduler.page_num();
+  LOG_TRACE("sampled %d of %d pages by %d threads, %ld rows",
+      scheduler.page_num(), scheduler.total_page_num(), workers, total_sampled_rows);
+  return RC::SUCCESS;
+}
+
+RC AnalyzeTableExecutor::collect_by_record(
+    Table *table, Trx *trx, vector<ColumnStatsCollector> &collectors, double &table_rows)
+{
+  RC rc = table->get_record_scanner(scanner_, trx, ReadWriteMode::READ_ONLY);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get record scanner. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // 记录攒成 chunk 再交给 collector
+  const TableMeta &table_meta = table->table_meta();
+  Chunk            chunk;
+  for (int i = table_meta.sys_field_num(); i < table_meta.field_num(); i++) {
+    chunk.add_column(make_unique<Column>(*table_meta.field(i)), i);
+  }
+  auto flush = [&chunk, &collectors]() {
+    for (size_t i = 0; i < collectors.size(); i++) {
+      collectors[i].add(chunk.column(i), chunk.rows());
+    }
+    chunk.reset_data();
+  };
+
+  Record  record;
+  int64_t rows = 0;
+  while (OB_SUCC(rc = scanner_->next(record))) {
+    for (int i = 0; i < chunk.column_num(); i++) {
+      const FieldMeta *field_meta = table_meta.field(table_meta.sys_field_num() + i);
+      chunk.column(i).append_one(record.data() + field_meta->offset());
+    }
+    rows++;
+    if (chunk.rows() == chunk.capacity()) {
+      flush();
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to scan record. rc=%s", strrc(rc));
+    return rc;
+  }
+  flush();
+  table_rows = static_cast<double>(rows);
+  return RC::SUCCESS;
+}
+
 AnalyzeTableExecutor::~AnalyzeTableExecutor() 
 {
   if (scanner_ != nullptr) {
@@ -10,23 +10,74 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/vector.h"
+#include "common/types.h"
 #include "common/sys/rc.h"
 
 class SQLStageEvent;
 class RecordScanner;
+class ColumnStatsCollector;
+class Table;
+class TableStats;
+class Trx;
 
 /**
  * @brief 分析表的执行器(analyze table)
  * @ingroup Executor
+ * @details 收集表的行数与每一列的统计信息（NDV、空值比例、最小最大值、MCV、等深直方图），
+ * 保存到 Catalog 中并写入表的统计信息文件。
+ *
+ * HEAP 引擎的表按页面采样（block sampling）：随机选出一部分页面，由 parallel_degree 个线程通过
+ * ChunkFileScanner 共享一个 MorselScheduler 并行读取，每个线程有自己的 ColumnStatsCollector，最后合并。
+ * 采样读取绕过缓冲区，不会把其它查询的热点页面挤出去。默认最多读取 MAX_SAMPLE_PAGES 个页面，
+ * `ANALYZE TABLE t SAMPLE n PERCENT` 指定读取的页面比例。行数与 NDV 按采样的比例推算。
+ * 其它引擎的表逐行扫描全表。
+ *
+ * 表上修改的行数超过阈值（AUTO_ANALYZE_RATIO 倍的行数，至少 AUTO_ANALYZE_MIN_ROWS 行）之后，
+ * 优化器在使用统计信息之前会通过 auto_analyze 重新采样收集。
  */
 class AnalyzeTableExecutor
 {
 public:
+  static constexpr int     MAX_SAMPLE_PAGES      = 1024;
+  static constexpr int64_t AUTO_ANALYZE_MIN_ROWS = 1000;
+  static constexpr double  AUTO_ANALYZE_RATIO    = 0.1;
+
   AnalyzeTableExecutor() = default;
   virtual ~AnalyzeTableExecutor();
 
   RC execute(SQLStageEvent *sql_event);
 
+  /**
+   * @brief 收集表的统计信息，更新 Catalog 并写入统计信息文件
+   * @param sample_percent  采样的页面百分比，0 表示默认的采样方式
+   * @param parallel_degree 并行收集的线程数
+   */
+  RC analyze_table(Table *table, Trx *trx, double sample_percent, int parallel_degree);
+
+  /**
+   * @brief 收集表的统计信息
+   */
+  RC collect_table_stats(
+      Table *table, Trx *trx, TableStats &stats, double sample_percent = 0, int parallel_degree = 1);
+
+  /**
+   * @brief 上次收集之后修改的行数是否超过了阈值
+   */
+  static bool need_auto_analyze(const Table *table);
+
+  /**
+   * @brief 统计信息过期时重新收集，没有过期时什么也不做
+   */
+  static RC auto_analyze(Table *table, Trx *trx, int parallel_degree);
+
+private:
+  /// 通过 ChunkFileScanner 采样页面并行收集，table_rows 返回推算的行数
+  RC collect_by_chunk(Table *table, Trx *trx, double sample_percent, int parallel_degree,
+      vector<ColumnStatsCollector> &collectors, double &table_rows);
+  /// 逐行扫描全表收集
+  RC collect_by_record(Table *table, Trx *trx, vector<ColumnStatsCollector> &collectors, double &table_rows);
+
 private:
   RecordScanner *scanner_ = nullptr;
 };
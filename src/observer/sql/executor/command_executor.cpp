@@ -23,8 +23,11 @@ See the Mulan PSL v2 for more details. */
 #include "sql/executor/load_data_executor.h"
 #include "sql/executor/set_variable_executor.h"
 #include "sql/executor/show_tables_executor.h"
+#include "sql/executor/show_variables_executor.h"
 #include "sql/executor/trx_begin_executor.h"
 #include "sql/executor/trx_end_executor.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/query_cache/query_cache.h"
 #include "sql/stmt/stmt.h"
 
 RC CommandExecutor::execute(SQLStageEvent *sql_event)
@@ -63,6 +66,11 @@ RC CommandExecutor::execute(SQLStageEvent *sql_event)
       rc = executor.execute(sql_event);
     } break;
 
+    case StmtType::SHOW_VARIABLES: {
+      ShowVariablesExecutor executor;
+      rc = executor.execute(sql_event);
+    } break;
+
     case StmtType::BEGIN: {
       TrxBeginExecutor executor;
       rc = executor.execute(sql_event);
@@ -100,6 +108,10 @@ RC CommandExecutor::execute(SQLStageEvent *sql_event)
   }
 
   if (OB_SUCC(rc) && stmt_type_ddl(stmt->type())) {
+    // 表结构变化之后，缓存的执行计划与查询结果都不能再使用
+    PlanCache::instance().invalidate_all();
+    QueryCache::instance().invalidate_all();
+
     // 每次做完DDL之后，做一次sync，保证元数据与日志保持一致
     rc = sql_event->session_event()->session()->get_current_db()->sync();
     LOG_INFO("sync db after ddl. rc=%d", rc);
@@ -56,5 +56,7 @@ RC ExecuteStage::handle_request_with_physical_operator(SQLStageEvent *sql_event)
 
   SqlResult *sql_result = sql_event->session_event()->sql_result();
   sql_result->set_operator(std::move(physical_operator));
+  sql_result->set_cached_plan(std::move(sql_event->cached_plan()));
+  sql_result->set_result_collector(std::move(sql_event->cached_result()));
   return rc;
 }
@@ -9,6 +9,8 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "sql/executor/set_variable_executor.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/query_cache/query_cache.h"
 
 RC SetVariableExecutor::execute(SQLStageEvent *sql_event)
 {
@@ -50,6 +52,84 @@ RC SetVariableExecutor::execute(SQLStageEvent *sql_event)
           session->set_use_cascade(bool_value);
           LOG_TRACE("set use_cascade to %d", bool_value);
         }
+      } else if (strcasecmp(var_name, "operator_memory_limit") == 0) {
+        int64_t limit = 0;
+        if (var_value.attr_type() == AttrType::INTS) {
+          limit = var_value.get_int();
+        } else if (var_value.attr_type() == AttrType::BIGINTS) {
+          limit = var_value.get_bigint();
+        } else {
+          rc = RC::VARIABLE_NOT_VALID;
+        }
+        if (rc == RC::SUCCESS && limit < 0) {
+          rc = RC::VARIABLE_NOT_VALID;
+        }
+        if (rc == RC::SUCCESS) {
+          session->set_operator_memory_limit(limit);
+          LOG_TRACE("set operator_memory_limit to %ld", limit);
+        }
+      } else if (strcasecmp(var_name, "parallel_degree") == 0) {
+        int64_t degree = 0;
+        if (var_value.attr_type() == AttrType::INTS) {
+          degree = var_value.get_int();
+        } else if (var_value.attr_type() == AttrType::BIGINTS) {
+          degree = var_value.get_bigint();
+        }
+        if (degree < 1 || degree > MAX_PARALLEL_DEGREE) {
+          rc = RC::VARIABLE_NOT_VALID;
+        } else {
+          session->set_parallel_degree(static_cast<int>(degree));
+          LOG_TRACE("set parallel_degree to %ld", degree);
+        }
+      } else if (strcasecmp(var_name, "pipeline_execution") == 0) {
+        bool bool_value = false;
+        rc              = var_value_to_boolean(var_value, bool_value);
+        if (rc == RC::SUCCESS) {
+          session->set_pipeline_execution(bool_value);
+          LOG_TRACE("set pipeline_execution to %d", bool_value);
+        }
+      } else if (strcasecmp(var_name, "plan_cache") == 0) {
+        bool bool_value = false;
+        rc              = var_value_to_boolean(var_value, bool_value);
+        if (rc == RC::SUCCESS) {
+          session->set_plan_cache(bool_value);
+          LOG_TRACE("set plan_cache to %d", bool_value);
+        }
+      } else if (strcasecmp(var_name, "plan_cache_capacity") == 0) {
+        // 所有会话共用同一个执行计划缓存
+        int64_t capacity = -1;
+        if (var_value.attr_type() == AttrType::INTS) {
+          capacity = var_value.get_int();
+        } else if (var_value.attr_type() == AttrType::BIGINTS) {
+          capacity = var_value.get_bigint();
+        }
+        if (capacity < 0) {
+          rc = RC::VARIABLE_NOT_VALID;
+        } else {
+          PlanCache::instance().set_capacity(capacity);
+          LOG_INFO("set plan_cache_capacity to %ld", capacity);
+        }
+      } else if (strcasecmp(var_name, "query_cache") == 0) {
+        bool bool_value = false;
+        rc              = var_value_to_boolean(var_value, bool_value);
+        if (rc == RC::SUCCESS) {
+          session->set_query_cache(bool_value);
+          LOG_TRACE("set query_cache to %d", bool_value);
+        }
+      } else if (strcasecmp(var_name, "query_cache_capacity") == 0) {
+        // 所有会话共用同一个查询缓存
+        int64_t capacity = -1;
+        if (var_value.attr_type() == AttrType::INTS) {
+          capacity = var_value.get_int();
+        } else if (var_value.attr_type() == AttrType::BIGINTS) {
+          capacity = var_value.get_bigint();
+        }
+        if (capacity < 0) {
+          rc = RC::VARIABLE_NOT_VALID;
+        } else {
+          QueryCache::instance().set_capacity(capacity);
+          LOG_INFO("set query_cache_capacity to %ld", capacity);
+        }
       } else {
       rc = RC::VARIABLE_NOT_EXISTS;
     }
@@ -65,6 +145,8 @@ RC SetVariableExecutor::var_value_to_boolean(const Value &var_value, bool &bool_
       bool_value = var_value.get_boolean();
     } else if (var_value.attr_type() == AttrType::INTS) {
       bool_value = var_value.get_int() != 0;
+    } else if (var_value.attr_type() == AttrType::BIGINTS) {
+      bool_value = var_value.get_bigint() != 0;
     } else if (var_value.attr_type() == AttrType::FLOATS) {
       bool_value = var_value.get_float() != 0.0;
     } else if (var_value.attr_type() == AttrType::CHARS) {
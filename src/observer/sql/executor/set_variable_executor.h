@@ -33,6 +33,9 @@ public:
   RC execute(SQLStageEvent *sql_event);
 
 private:
+  /// parallel_degree 的上限
+  static constexpr int MAX_PARALLEL_DEGREE = 64;
+
   RC var_value_to_boolean(const Value &var_value, bool &bool_value) const;
 
   RC get_execution_mode(const Value &var_value, ExecutionMode &execution_mode) const;
@@ -0,0 +1,78 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/sys/rc.h"
+#include "event/session_event.h"
+#include "event/sql_event.h"
+#include "session/session.h"
+#include "sql/executor/sql_result.h"
+#include "sql/operator/string_list_physical_operator.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/query_cache/query_cache.h"
+
+/**
+ * @brief 显示变量的执行器
+ * @ingroup Executor
+ * @details 输出当前会话可以通过 set 修改的变量，以及执行计划缓存与查询缓存的命中情况
+ */
+class ShowVariablesExecutor
+{
+public:
+  ShowVariablesExecutor()          = default;
+  virtual ~ShowVariablesExecutor() = default;
+
+  RC execute(SQLStageEvent *sql_event)
+  {
+    SqlResult *sql_result = sql_event->session_event()->sql_result();
+    Session   *session    = sql_event->session_event()->session();
+
+    TupleSchema tuple_schema;
+    tuple_schema.append_cell(TupleCellSpec("", "Variable_name", "Variable_name"));
+    tuple_schema.append_cell(TupleCellSpec("", "Value", "Value"));
+    sql_result->set_tuple_schema(tuple_schema);
+
+    const PlanCache::Stats  stats       = PlanCache::instance().stats();
+    const QueryCache::Stats query_stats = QueryCache::instance().stats();
+
+    auto oper = new StringListPhysicalOperator;
+    oper->append({"sql_debug", bool_string(session->sql_debug_on())});
+    oper->append({"execution_mode",
+        session->get_execution_mode() == ExecutionMode::CHUNK_ITERATOR ? "CHUNK_ITERATOR" : "TUPLE_ITERATOR"});
+    oper->append({"hash_join", bool_string(session->hash_join_on())});
+    oper->append({"use_cascade", bool_string(session->use_cascade())});
+    oper->append({"operator_memory_limit", to_string(session->operator_memory_limit())});
+    oper->append({"parallel_degree", to_string(session->parallel_degree())});
+    oper->append({"pipeline_execution", bool_string(session->pipeline_execution())});
+    oper->append({"plan_cache", bool_string(session->plan_cache_on())});
+    oper->append({"plan_cache_capacity", to_string(PlanCache::instance().capacity())});
+    oper->append({"plan_cache_hits", to_string(stats.hits)});
+    oper->append({"plan_cache_misses", to_string(stats.misses)});
+    oper->append({"plan_cache_evictions", to_string(stats.evictions)});
+    oper->append({"plan_cache_invalidations", to_string(stats.invalidations)});
+    oper->append({"plan_cache_entries", to_string(stats.entries)});
+    oper->append({"plan_cache_memory", to_string(stats.memory)});
+    oper->append({"query_cache", bool_string(session->query_cache_on())});
+    oper->append({"query_cache_capacity", to_string(QueryCache::instance().capacity())});
+    oper->append({"query_cache_hits", to_string(query_stats.hits)});
+    oper->append({"query_cache_misses", to_string(query_stats.misses)});
+    oper->append({"query_cache_evictions", to_string(query_stats.evictions)});
+    oper->append({"query_cache_invalidations", to_string(query_stats.invalidations)});
+    oper->append({"query_cache_entries", to_string(query_stats.entries)});
+    oper->append({"query_cache_memory", to_string(query_stats.memory)});
+
+    sql_result->set_operator(unique_ptr<PhysicalOperator>(oper));
+    return RC::SUCCESS;
+  }
+
+private:
+  static const char *bool_string(bool value) { return value ? "1" : "0"; }
+};
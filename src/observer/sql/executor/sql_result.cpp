@@ -24,17 +24,26 @@ void SqlResult::set_tuple_schema(const TupleSchema &schema) { tuple_schema_ = sc
 
 RC SqlResult::open()
 {
+  if (cached_result_ != nullptr) {
+    return RC::SUCCESS;
+  }
   if (nullptr == operator_) {
     return RC::INVALID_ARGUMENT;
   }
 
   Trx *trx = session_->current_trx();
   trx->start_if_need();
-  return operator_->open(trx);
+  RC rc = operator_->open(trx);
+  failed_ = OB_FAIL(rc);
+  return rc;
 }
 
 RC SqlResult::close()
 {
+  if (cached_result_ != nullptr) {
+    cached_result_.reset();
+    return RC::SUCCESS;
+  }
   if (nullptr == operator_) {
     return RC::INVALID_ARGUMENT;
   }
@@ -43,6 +52,16 @@ RC SqlResult::close()
     LOG_WARN("failed to close operator. rc=%s", strrc(rc));
   }
 
+  if (result_collector_ != nullptr && rc == RC::SUCCESS && !failed_ && eof_) {
+    QueryCache::instance().add(std::move(result_collector_));
+  }
+  result_collector_.reset();
+
+  if (cached_plan_ != nullptr && rc == RC::SUCCESS && !failed_) {
+    cached_plan_->set_operator(std::move(operator_));
+    PlanCache::instance().release(std::move(cached_plan_));
+  }
+  cached_plan_.reset();
   operator_.reset();
 
   if (session_ && !session_->is_trx_multi_operation_mode()) {
@@ -63,16 +82,28 @@ RC SqlResult::next_tuple(Tuple *&tuple)
 {
   RC rc = operator_->next();
   if (rc != RC::SUCCESS) {
+    failed_ = failed_ || rc != RC::RECORD_EOF;
+    eof_    = rc == RC::RECORD_EOF;
     return rc;
   }
 
   tuple = operator_->current_tuple();
+  if (result_collector_ != nullptr && !result_collector_->add_tuple(*tuple)) {
+    result_collector_.reset();
+  }
   return rc;
 }
 
 RC SqlResult::next_chunk(Chunk &chunk)
 {
   RC rc = operator_->next(chunk);
+  failed_ = failed_ || (rc != RC::SUCCESS && rc != RC::RECORD_EOF);
+  eof_    = rc == RC::RECORD_EOF;
+  // 写入视图的 chunk 不是返回给客户端的结果
+  if (result_collector_ != nullptr && rc == RC::SUCCESS &&
+      (!chunk.table_name.empty() || !result_collector_->add_chunk(chunk))) {
+    result_collector_.reset();
+  }
   return rc;
 }
 
@@ -80,5 +111,21 @@ void SqlResult::set_operator(unique_ptr<PhysicalOperator> oper)
 {
   ASSERT(operator_ == nullptr, "current operator is not null. Result is not closed?");
   operator_ = std::move(oper);
+  failed_   = false;
+  eof_      = false;
   operator_->tuple_schema(tuple_schema_);
 }
+
+void SqlResult::set_cached_result(shared_ptr<const CachedResult> result)
+{
+  cached_result_ = std::move(result);
+  tuple_schema_  = cached_result_->schema();
+}
+
+void SqlResult::set_result_collector(unique_ptr<CachedResult> collector)
+{
+  result_collector_ = std::move(collector);
+  if (result_collector_ != nullptr) {
+    result_collector_->set_schema(tuple_schema_);
+  }
+}
@@ -18,6 +18,8 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/memory.h"
 #include "sql/expr/tuple.h"
 #include "sql/operator/physical_operator.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/query_cache/query_cache.h"
 
 class Session;
 
@@ -40,10 +42,27 @@ public:
 
   void set_operator(unique_ptr<PhysicalOperator> oper);
 
-  bool               has_operator() const { return operator_ != nullptr; }
-  const TupleSchema &tuple_schema() const { return tuple_schema_; }
-  RC                 return_code() const { return return_code_; }
-  const string      &state_string() const { return state_string_; }
+  /**
+   * @brief 执行成功时，关闭之后把执行计划放回执行计划缓存
+   */
+  void set_cached_plan(unique_ptr<CachedPlan> plan) { cached_plan_ = std::move(plan); }
+
+  /**
+   * @brief 查询缓存命中，直接把缓存的结果返回给客户端
+   */
+  void set_cached_result(shared_ptr<const CachedResult> result);
+
+  /**
+   * @brief 执行时收集返回的结果，完整返回之后放入查询缓存
+   */
+  void set_result_collector(unique_ptr<CachedResult> collector);
+
+  bool                has_operator() const { return operator_ != nullptr; }
+  bool                has_cached_result() const { return cached_result_ != nullptr; }
+  const CachedResult *cached_result() const { return cached_result_.get(); }
+  const TupleSchema  &tuple_schema() const { return tuple_schema_; }
+  RC                  return_code() const { return return_code_; }
+  const string       &state_string() const { return state_string_; }
 
   RC open();
   RC close();
@@ -51,9 +70,14 @@ public:
   RC next_chunk(Chunk &chunk);
 
 private:
-  Session                     *session_ = nullptr;  ///< 当前所属会话
-  unique_ptr<PhysicalOperator> operator_;           ///< 执行计划
-  TupleSchema                  tuple_schema_;       ///< 返回的表头信息。可能有也可能没有
-  RC                           return_code_ = RC::SUCCESS;
-  string                       state_string_;
+  Session                       *session_ = nullptr;  ///< 当前所属会话
+  unique_ptr<PhysicalOperator>   operator_;           ///< 执行计划
+  unique_ptr<CachedPlan>         cached_plan_;        ///< 执行计划缓存中的记录
+  bool                           failed_ = false;     ///< 执行过程中是否出错，出错的执行计划不放回缓存
+  bool                           eof_    = false;     ///< 是否已经返回了所有的结果
+  shared_ptr<const CachedResult> cached_result_;      ///< 命中的查询缓存中的结果
+  unique_ptr<CachedResult>       result_collector_;   ///< 正在收集的查询结果
+  TupleSchema                    tuple_schema_;       ///< 返回的表头信息。可能有也可能没有
+  RC                             return_code_ = RC::SUCCESS;
+  string                         state_string_;
 };
@@ -11,6 +11,8 @@ See the Mulan PSL v2 for more details. */
 #include "sql/expr/aggregate_hash_table.h"
 #include "common/math/simd_util.h"
 #include "sql/expr/aggregate_state.h"
+#include "storage/common/chunk_spill_file.h"
+#include "storage/common/column_util.h"
 #include <immintrin.h>
 
 // ----------------------------------StandardAggregateHashTable------------------
@@ -119,6 +121,610 @@ bool StandardAggregateHashTable::VectorEqual::operator()(const vector<Value> &lh
   return true;
 }
 
+// ----------------------------------VectorizedAggregateHashTable------------------
+
+namespace {
+inline uint64_t mix_hash(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/// 以 8 字节为单位计算键的哈希值，定长键的循环可以被编译器展开
+inline uint64_t hash_key(const char *key, int len)
+{
+  uint64_t h = 0x9e3779b97f4a7c15ULL ^ static_cast<uint64_t>(len);
+  int      i = 0;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t word;
+    memcpy(&word, key + i, sizeof(word));
+    h = mix_hash(h ^ word);
+  }
+  if (i < len) {
+    uint64_t word = 0;
+    memcpy(&word, key + i, len - i);
+    h = mix_hash(h ^ word);
+  }
+  return h;
+}
+
+inline bool is_supported_key_type(AttrType type)
+{
+  switch (type) {
+    case AttrType::INTS:
+    case AttrType::DATES:
+    case AttrType::FLOATS:
+    case AttrType::BIGINTS:
+    case AttrType::BOOLEANS:
+    case AttrType::CHARS:
+    case AttrType::TEXTS: return true;
+    default: return false;
+  }
+}
+}  // namespace
+
+VectorizedAggregateHashTable::VectorizedAggregateHashTable(const vector<Expression *> &aggregations)
+{
+  for (auto &expr : aggregations) {
+    ASSERT(expr->type() == ExprType::AGGREGATION, "expect aggregate expression");
+    auto *aggregation_expr = static_cast<AggregateExpr *>(expr);
+    aggr_types_.push_back(aggregation_expr->aggregate_type());
+    aggr_child_types_.push_back(aggregation_expr->child()->value_type());
+    states_.emplace_back(create_grouped_aggregate_state(aggregation_expr->aggregate_type(),
+        aggregation_expr->child()->value_type(),
+        aggregation_expr->child()->value_length()));
+    ASSERT(states_.back() != nullptr, "unsupported aggregation");
+  }
+}
+
+VectorizedAggregateHashTable::~VectorizedAggregateHashTable() = default;
+
+bool VectorizedAggregateHashTable::support(
+    const vector<unique_ptr<Expression>> &group_by_exprs, const vector<Expression *> &aggregations)
+{
+  for (const auto &expr : group_by_exprs) {
+    if (!is_supported_key_type(expr->value_type())) {
+      return false;
+    }
+  }
+  for (Expression *expr : aggregations) {
+    if (expr->type() != ExprType::AGGREGATION) {
+      return false;
+    }
+    auto *aggregation_expr = static_cast<AggregateExpr *>(expr);
+    if (create_grouped_aggregate_state(aggregation_expr->aggregate_type(),
+            aggregation_expr->child()->value_type(),
+            aggregation_expr->child()->value_length()) == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC VectorizedAggregateHashTable::init_key_layout(const Chunk &groups_chunk)
+{
+  for (int i = 0; i < groups_chunk.column_num(); i++) {
+    const Column &column = groups_chunk.column(i);
+    if (!is_supported_key_type(column.attr_type())) {
+      LOG_WARN("unsupported group by column type: %s", attr_type_to_string(column.attr_type()));
+      return RC::UNSUPPORTED;
+    }
+    key_types_.push_back(column.attr_type());
+    key_offsets_.push_back(fixed_key_len_);
+    if (column.attr_type() == AttrType::TEXTS) {
+      // 定长部分只记录字符串长度，字符串内容追加在变长部分
+      key_lens_.push_back(sizeof(uint32_t));
+      var_len_key_ = true;
+    } else {
+      key_lens_.push_back(column.attr_len());
+    }
+    fixed_key_len_ += key_lens_.back();
+  }
+  slots_.assign(INITIAL_CAPACITY, Slot{0, -1});
+  slot_mask_     = INITIAL_CAPACITY - 1;
+  layout_inited_ = true;
+  return RC::SUCCESS;
+}
+
+void VectorizedAggregateHashTable::serialize_keys(const Chunk &groups_chunk, int rows)
+{
+  // 计算每一行键的起始位置。定长键的位置可以直接算出来，变长键需要先累加 TEXTS 的长度
+  row_key_offsets_.resize(rows + 1);
+  if (!var_len_key_) {
+    for (int i = 0; i <= rows; i++) {
+      row_key_offsets_[i] = i * fixed_key_len_;
+    }
+  } else {
+    row_key_offsets_[0] = 0;
+    for (int i = 0; i < rows; i++) {
+      row_key_offsets_[i + 1] = fixed_key_len_;
+    }
+    for (size_t c = 0; c < key_types_.size(); c++) {
+      if (key_types_[c] != AttrType::TEXTS) {
+        continue;
+      }
+      const Column   &column  = groups_chunk.column(c);
+      const string_t *strings = reinterpret_cast<const string_t *>(column.data());
+      const int       stride  = column.column_type() == Column::Type::CONSTANT_COLUMN ? 0 : 1;
+      for (int i = 0; i < rows; i++) {
+        row_key_offsets_[i + 1] += strings[i * stride].size();
+      }
+    }
+    for (int i = 0; i < rows; i++) {
+      row_key_offsets_[i + 1] += row_key_offsets_[i];
+    }
+  }
+  row_keys_.resize(row_key_offsets_[rows]);
+
+  // 按列将值写入每一行的键中
+  char *keys = row_keys_.data();
+  row_var_cursors_.assign(rows, fixed_key_len_);
+  for (size_t c = 0; c < key_types_.size(); c++) {
+    const Column &column   = groups_chunk.column(c);
+    const int     offset   = key_offsets_[c];
+    const int     key_len  = key_lens_[c];
+    const int     attr_len = column.attr_len();
+    const int     stride   = column.column_type() == Column::Type::CONSTANT_COLUMN ? 0 : 1;
+    const char   *data     = column.data();
+    switch (key_types_[c]) {
+      case AttrType::CHARS: {
+        // CHARS 列在 '\0' 之后的内容是无效的，统一补零
+        for (int i = 0; i < rows; i++) {
+          char       *dst = keys + row_key_offsets_[i] + offset;
+          const char *src = data + static_cast<size_t>(i) * stride * attr_len;
+          const int   len = strnlen(src, attr_len);
+          memcpy(dst, src, len);
+          memset(dst + len, 0, key_len - len);
+        }
+      } break;
+      case AttrType::FLOATS: {
+        // 0.0 与 -0.0 相等，但是字节不同
+        const float *values = reinterpret_cast<const float *>(data);
+        for (int i = 0; i < rows; i++) {
+          float value = values[i * stride];
+          value       = value == 0.0f ? 0.0f : value;
+          memcpy(keys + row_key_offsets_[i] + offset, &value, sizeof(value));
+        }
+      } break;
+      case AttrType::TEXTS: {
+        const string_t *strings = reinterpret_cast<const string_t *>(data);
+        for (int i = 0; i < rows; i++) {
+          const string_t &str = strings[i * stride];
+          const uint32_t  len = str.size();
+          memcpy(keys + row_key_offsets_[i] + offset, &len, sizeof(len));
+          memcpy(keys + row_key_offsets_[i] + row_var_cursors_[i], str.data(), len);
+          row_var_cursors_[i] += len;
+        }
+      } break;
+      default: {
+        for (int i = 0; i < rows; i++) {
+          memcpy(keys + row_key_offsets_[i] + offset, data + static_cast<size_t>(i) * stride * attr_len, key_len);
+        }
+      } break;
+    }
+  }
+
+  row_hashes_.resize(rows);
+  for (int i = 0; i < rows; i++) {
+    row_hashes_[i] = hash_key(keys + row_key_offsets_[i], row_key_offsets_[i + 1] - row_key_offsets_[i]);
+  }
+}
+
+const char *VectorizedAggregateHashTable::group_key(int group, int &key_len) const
+{
+  if (var_len_key_) {
+    key_len = var_key_lens_[group];
+    return var_keys_[group];
+  }
+  key_len = fixed_key_len_;
+  return fixed_keys_.data() + static_cast<size_t>(group) * fixed_key_len_;
+}
+
+void VectorizedAggregateHashTable::copy_key_layout(const VectorizedAggregateHashTable &other)
+{
+  key_types_     = other.key_types_;
+  key_lens_      = other.key_lens_;
+  key_offsets_   = other.key_offsets_;
+  fixed_key_len_ = other.fixed_key_len_;
+  var_len_key_   = other.var_len_key_;
+  slots_.assign(INITIAL_CAPACITY, Slot{0, -1});
+  slot_mask_     = INITIAL_CAPACITY - 1;
+  layout_inited_ = true;
+}
+
+int VectorizedAggregateHashTable::add_group(uint64_t hash, const char *key, int key_len)
+{
+  group_hashes_.push_back(hash);
+  if (var_len_key_) {
+    char *buf = arena_.Allocate(std::max(key_len, 1));
+    memcpy(buf, key, key_len);
+    var_keys_.push_back(buf);
+    var_key_lens_.push_back(key_len);
+  } else {
+    fixed_keys_.insert(fixed_keys_.end(), key, key + key_len);
+  }
+  return group_count_++;
+}
+
+void VectorizedAggregateHashTable::grow()
+{
+  vector<Slot> old_slots = std::move(slots_);
+  slots_.assign(old_slots.size() * 2, Slot{0, -1});
+  slot_mask_ = slots_.size() - 1;
+  for (const Slot &slot : old_slots) {
+    if (slot.group < 0) {
+      continue;
+    }
+    uint64_t pos = slot.hash & slot_mask_;
+    while (slots_[pos].group >= 0) {
+      pos = (pos + 1) & slot_mask_;
+    }
+    slots_[pos] = slot;
+  }
+}
+
+void VectorizedAggregateHashTable::probe(int rows)
+{
+  // 保证负载因子不超过 0.5，探测过程中不需要扩容
+  while (!frozen_ && static_cast<size_t>(group_count_ + rows) * 2 > slots_.size()) {
+    grow();
+  }
+
+  row_groups_.resize(rows);
+  missed_rows_.clear();
+  const char *keys = row_keys_.data();
+  for (int i = 0; i < rows; i++) {
+    const int group = find_or_add_group(
+        row_hashes_[i], keys + row_key_offsets_[i], row_key_offsets_[i + 1] - row_key_offsets_[i]);
+    if (group < 0) {
+      row_groups_[i] = group_count_;
+      missed_rows_.push_back(i);
+    } else {
+      row_groups_[i] = group;
+    }
+  }
+}
+
+int VectorizedAggregateHashTable::find_or_add_group(uint64_t hash, const char *key, int key_len)
+{
+  for (uint64_t pos = hash & slot_mask_;; pos = (pos + 1) & slot_mask_) {
+    Slot &slot = slots_[pos];
+    if (slot.group < 0) {
+      if (frozen_) {
+        return -1;
+      }
+      slot.hash  = hash;
+      slot.group = add_group(hash, key, key_len);
+      return slot.group;
+    }
+    if (slot.hash == hash) {
+      int         group_key_len = 0;
+      const char *stored_key    = group_key(slot.group, group_key_len);
+      if (group_key_len == key_len && memcmp(stored_key, key, key_len) == 0) {
+        return slot.group;
+      }
+    }
+  }
+}
+
+RC VectorizedAggregateHashTable::merge(const VectorizedAggregateHashTable &other, const vector<int> &groups)
+{
+  if (other.states_.size() != states_.size()) {
+    LOG_WARN("cannot merge hash tables with different aggregations. %d != %d", other.states_.size(), states_.size());
+    return RC::INVALID_ARGUMENT;
+  }
+  if (frozen_) {
+    LOG_WARN("cannot merge into a frozen hash table");
+    return RC::INTERNAL;
+  }
+  if (groups.empty()) {
+    return RC::SUCCESS;
+  }
+  if (!layout_inited_) {
+    copy_key_layout(other);
+  }
+
+  const int count = static_cast<int>(groups.size());
+  while (static_cast<size_t>(group_count_ + count) * 2 > slots_.size()) {
+    grow();
+  }
+  row_groups_.resize(count);
+  for (int i = 0; i < count; i++) {
+    int         key_len = 0;
+    const char *key     = other.group_key(groups[i], key_len);
+    row_groups_[i]      = find_or_add_group(other.group_hashes_[groups[i]], key, key_len);
+  }
+  for (size_t i = 0; i < states_.size(); i++) {
+    states_[i]->resize(group_count_);
+    states_[i]->merge(*other.states_[i], groups.data(), row_groups_.data(), count);
+  }
+  return RC::SUCCESS;
+}
+
+RC VectorizedAggregateHashTable::add_chunk(Chunk &groups_chunk, Chunk &aggrs_chunk)
+{
+  if (groups_chunk.rows() != aggrs_chunk.rows()) {
+    LOG_WARN("groups_chunk and aggrs_chunk have different rows: %d, %d", groups_chunk.rows(), aggrs_chunk.rows());
+    return RC::INVALID_ARGUMENT;
+  }
+  if (aggrs_chunk.column_num() != static_cast<int>(states_.size())) {
+    LOG_WARN("aggrs_chunk has %d columns, but there are %d aggregations", aggrs_chunk.column_num(), states_.size());
+    return RC::INVALID_ARGUMENT;
+  }
+  RC rc = RC::SUCCESS;
+  if (!layout_inited_ && OB_FAIL(rc = init_key_layout(groups_chunk))) {
+    return rc;
+  }
+
+  const int rows = groups_chunk.rows();
+  serialize_keys(groups_chunk, rows);
+  probe(rows);
+
+  for (size_t i = 0; i < states_.size(); i++) {
+    states_[i]->resize(frozen_ ? group_count_ + 1 : group_count_);
+    states_[i]->update(aggrs_chunk.column(i), row_groups_.data(), rows);
+  }
+  return rc;
+}
+
+size_t VectorizedAggregateHashTable::memory_usage() const
+{
+  size_t usage = slots_.capacity() * sizeof(Slot) + fixed_keys_.capacity() + arena_.MemoryUsage() +
+                 var_keys_.capacity() * sizeof(const char *) + var_key_lens_.capacity() * sizeof(int) +
+                 group_hashes_.capacity() * sizeof(uint64_t);
+  for (const auto &state : states_) {
+    usage += state->memory_usage();
+  }
+  return usage;
+}
+
+RC VectorizedAggregateHashTable::decode_key(int group, int key_col_idx, Column &column) const
+{
+  int         key_len = 0;
+  const char *key     = group_key(group, key_len);
+  const char *value   = key + key_offsets_[key_col_idx];
+  AttrType    type    = key_types_[key_col_idx];
+  if (type == AttrType::TEXTS) {
+    int var_offset = fixed_key_len_;
+    for (int c = 0; c < key_col_idx; c++) {
+      if (key_types_[c] == AttrType::TEXTS) {
+        uint32_t len;
+        memcpy(&len, key + key_offsets_[c], sizeof(len));
+        var_offset += len;
+      }
+    }
+    uint32_t len;
+    memcpy(&len, value, sizeof(len));
+    Value text;
+    text.set_text(len == 0 ? "" : key + var_offset, len);
+    return column.append_value(text);
+  }
+  if (column.attr_len() == key_lens_[key_col_idx]) {
+    return column.append_one(value);
+  }
+  return column.append_value(Value(type, const_cast<char *>(value), key_lens_[key_col_idx]));
+}
+
+void VectorizedAggregateHashTable::Scanner::open_scan() { scan_pos_ = 0; }
+
+RC VectorizedAggregateHashTable::Scanner::next(Chunk &output_chunk)
+{
+  auto *table = static_cast<VectorizedAggregateHashTable *>(hash_table_);
+  if (scan_pos_ >= table->group_count()) {
+    return RC::RECORD_EOF;
+  }
+  const int count     = std::min(table->group_count() - scan_pos_, output_chunk.capacity() - output_chunk.rows());
+  const int key_count = static_cast<int>(table->key_types_.size());
+  RC        rc        = RC::SUCCESS;
+  for (int i = 0; i < output_chunk.column_num(); i++) {
+    const int col_idx = output_chunk.column_ids(i);
+    if (col_idx >= key_count) {
+      rc = table->states_[col_idx - key_count]->finalize(scan_pos_, count, output_chunk.column(i));
+      if (OB_FAIL(rc)) {
+        LOG_WARN("finialize aggregate state failed. rc=%s", strrc(rc));
+        return rc;
+      }
+    } else {
+      for (int group = scan_pos_; group < scan_pos_ + count; group++) {
+        if (OB_FAIL(rc = table->decode_key(group, col_idx, output_chunk.column(i)))) {
+          LOG_WARN("append group by value failed. rc=%s", strrc(rc));
+          return rc;
+        }
+      }
+    }
+  }
+  scan_pos_ += count;
+  return rc;
+}
+
+// ----------------------------------SpillableAggregateHashTable------------------
+
+SpillableAggregateHashTable::SpillableAggregateHashTable(
+    const vector<Expression *> &aggregations, size_t memory_limit, int level)
+    : aggregations_(aggregations), memory_limit_(memory_limit), level_(level), table_(aggregations)
+{
+  aggr_types_       = table_.aggr_types_;
+  aggr_child_types_ = table_.aggr_child_types_;
+  partition_buffers_.resize(PARTITION_NUM);
+  partition_files_.resize(PARTITION_NUM);
+}
+
+SpillableAggregateHashTable::~SpillableAggregateHashTable() = default;
+
+RC SpillableAggregateHashTable::add_chunk(Chunk &groups_chunk, Chunk &aggrs_chunk)
+{
+  RC rc = table_.add_chunk(groups_chunk, aggrs_chunk);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  group_column_num_ = groups_chunk.column_num();
+
+  if (table_.frozen()) {
+    if (!table_.missed_rows().empty()) {
+      rc = spill(groups_chunk, aggrs_chunk);
+    }
+  } else if (memory_limit_ > 0 && level_ < MAX_LEVEL && table_.memory_usage() > memory_limit_) {
+    LOG_INFO("aggregate hash table exceeds memory limit, start to spill. level=%d, groups=%d, memory usage=%zu, limit=%zu",
+        level_, table_.group_count(), table_.memory_usage(), memory_limit_);
+    table_.freeze();
+  }
+  return rc;
+}
+
+RC SpillableAggregateHashTable::spill(const Chunk &groups_chunk, const Chunk &aggrs_chunk)
+{
+  RC rc = RC::SUCCESS;
+  for (int row : table_.missed_rows()) {
+    const int partition = partition_of(table_.row_hash(row));
+    auto     &buffer    = partition_buffers_[partition];
+    if (buffer == nullptr) {
+      buffer = make_unique<Chunk>();
+      for (int i = 0; i < groups_chunk.column_num(); i++) {
+        const Column &column = groups_chunk.column(i);
+        buffer->add_column(make_unique<Column>(column.attr_type(), column.attr_len(), SPILL_BATCH_SIZE), i);
+      }
+      for (int i = 0; i < aggrs_chunk.column_num(); i++) {
+        const Column &column = aggrs_chunk.column(i);
+        buffer->add_column(
+            make_unique<Column>(column.attr_type(), column.attr_len(), SPILL_BATCH_SIZE), group_column_num_ + i);
+      }
+    } else if (buffer->rows() >= SPILL_BATCH_SIZE && OB_FAIL(rc = flush_partition(partition))) {
+      return rc;
+    }
+
+    for (int i = 0; i < groups_chunk.column_num() && OB_SUCC(rc); i++) {
+      rc = copy_column_row(groups_chunk.column(i), row, buffer->column(i));
+    }
+    for (int i = 0; i < aggrs_chunk.column_num() && OB_SUCC(rc); i++) {
+      rc = copy_column_row(aggrs_chunk.column(i), row, buffer->column(group_column_num_ + i));
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to append row to spill buffer. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  spilled_rows_ += table_.missed_rows().size();
+  return rc;
+}
+
+RC SpillableAggregateHashTable::flush_partition(int partition)
+{
+  auto &buffer = partition_buffers_[partition];
+  if (buffer == nullptr || buffer->rows() == 0) {
+    return RC::SUCCESS;
+  }
+
+  RC    rc   = RC::SUCCESS;
+  auto &file = partition_files_[partition];
+  if (file == nullptr) {
+    file = make_unique<ChunkSpillFile>();
+    if (OB_FAIL(rc = file->open())) {
+      LOG_WARN("failed to open spill file. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  if (OB_FAIL(rc = file->write_chunk(*buffer))) {
+    LOG_WARN("failed to write spill file. rc=%s", strrc(rc));
+    return rc;
+  }
+  buffer->reset_data();
+  return rc;
+}
+
+RC SpillableAggregateHashTable::build_partition_table(int partition, unique_ptr<SpillableAggregateHashTable> &table)
+{
+  RC rc = flush_partition(partition);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  partition_buffers_[partition].reset();
+  unique_ptr<ChunkSpillFile> file = std::move(partition_files_[partition]);
+  if (file == nullptr) {
+    return RC::SUCCESS;
+  }
+  if (OB_FAIL(rc = file->finish_write())) {
+    return rc;
+  }
+
+  table = make_unique<SpillableAggregateHashTable>(aggregations_, memory_limit_, level_ + 1);
+  Chunk chunk;
+  while (OB_SUCC(rc = file->read_chunk(chunk))) {
+    Chunk groups_chunk;
+    Chunk aggrs_chunk;
+    for (int i = 0; i < chunk.column_num(); i++) {
+      auto column = make_unique<Column>();
+      column->reference(chunk.column(i));
+      if (i < group_column_num_) {
+        groups_chunk.add_column(std::move(column), i);
+      } else {
+        aggrs_chunk.add_column(std::move(column), i - group_column_num_);
+      }
+    }
+    if (OB_FAIL(rc = table->add_chunk(groups_chunk, aggrs_chunk))) {
+      LOG_WARN("failed to aggregate spilled chunk. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
+SpillableAggregateHashTable::Scanner::Scanner(AggregateHashTable *hash_table)
+    : AggregateHashTable::Scanner(hash_table)
+{}
+
+SpillableAggregateHashTable::Scanner::~Scanner() = default;
+
+void SpillableAggregateHashTable::Scanner::open_scan()
+{
+  auto *table     = static_cast<SpillableAggregateHashTable *>(hash_table_);
+  memory_scanner_ = make_unique<VectorizedAggregateHashTable::Scanner>(&table->table_);
+  memory_scanner_->open_scan();
+  memory_done_   = false;
+  partition_idx_ = -1;
+  partition_scanner_.reset();
+  partition_table_.reset();
+}
+
+RC SpillableAggregateHashTable::Scanner::next(Chunk &chunk)
+{
+  auto *table = static_cast<SpillableAggregateHashTable *>(hash_table_);
+  RC    rc    = RC::SUCCESS;
+  if (!memory_done_) {
+    rc = memory_scanner_->next(chunk);
+    if (rc != RC::RECORD_EOF) {
+      return rc;
+    }
+    memory_done_ = true;
+  }
+
+  while (true) {
+    if (partition_scanner_ != nullptr) {
+      rc = partition_scanner_->next(chunk);
+      if (rc != RC::RECORD_EOF) {
+        return rc;
+      }
+      partition_scanner_.reset();
+      partition_table_.reset();
+    }
+
+    if (++partition_idx_ >= PARTITION_NUM) {
+      return RC::RECORD_EOF;
+    }
+    if (OB_FAIL(rc = table->build_partition_table(partition_idx_, partition_table_))) {
+      LOG_WARN("failed to build partition table. partition=%d, rc=%s", partition_idx_, strrc(rc));
+      return rc;
+    }
+    if (partition_table_ != nullptr) {
+      partition_scanner_ = make_unique<Scanner>(partition_table_.get());
+      partition_scanner_->open_scan();
+    }
+  }
+}
+
 // ----------------------------------LinearProbingAggregateHashTable------------------
 #ifdef USE_SIMD
 template <typename V>
@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/math/simd_util.h"
 #include "common/sys/rc.h"
 #include "sql/expr/expression.h"
+#include "storage/common/arena_allocator.h"
 
 /**
  * @brief 用于hash group by 的哈希表实现，不支持并发访问。
@@ -107,6 +108,223 @@ public:
   StandardHashTable aggr_values_;
 };
 
+class GroupedAggregateState;
+
+/**
+ * @brief 向量化的哈希聚合表，支持任意个数、任意类型的分组列与多个聚合函数。
+ * @details 每一行的分组列被序列化成一个规范化的键(normalized key)：定长类型直接拷贝字节，
+ * CHARS 去掉尾部无效字节后补零，TEXTS 在定长部分记录长度、在变长部分追加内容。
+ * 当所有分组列都是定长时，键的长度固定，直接存放在连续的数组中；否则存放在 Arena 中。
+ * 哈希表使用开放寻址（线性探测），槽位中保存完整的哈希值，只有哈希值相等时才比较键。
+ * 聚合状态按列存放（参考 GroupedAggregateState），一个 chunk 先整体探测得到每行的分组编号，
+ * 再逐个聚合函数整列更新。
+ */
+class VectorizedAggregateHashTable : public AggregateHashTable
+{
+public:
+  class Scanner : public AggregateHashTable::Scanner
+  {
+  public:
+    explicit Scanner(AggregateHashTable *hash_table) : AggregateHashTable::Scanner(hash_table) {}
+    ~Scanner() = default;
+
+    void open_scan() override;
+
+    RC next(Chunk &chunk) override;
+
+  private:
+    int scan_pos_ = 0;
+  };
+
+  explicit VectorizedAggregateHashTable(const vector<Expression *> &aggregations);
+  virtual ~VectorizedAggregateHashTable();
+
+  /**
+   * @brief 判断给定的分组列与聚合函数是否可以使用当前哈希表
+   */
+  static bool support(const vector<unique_ptr<Expression>> &group_by_exprs, const vector<Expression *> &aggregations);
+
+  RC add_chunk(Chunk &groups_chunk, Chunk &aggrs_chunk) override;
+
+  int group_count() const { return group_count_; }
+
+  /**
+   * @brief 哈希表（包括分组键与聚合状态）占用的内存大小（字节）
+   */
+  size_t memory_usage() const;
+
+  /**
+   * @brief 冻结哈希表，之后不再创建新的分组
+   * @details 冻结后，add_chunk 中不属于已有分组的行不会被聚合，这些行的下标记录在 missed_rows 中，
+   * 由调用者另行处理（比如溢出到磁盘）。
+   */
+  void freeze() { frozen_ = true; }
+  bool frozen() const { return frozen_; }
+
+  /// 最近一次 add_chunk 中没有被聚合的行
+  const vector<int> &missed_rows() const { return missed_rows_; }
+
+  /// 最近一次 add_chunk 中第 row 行的分组键的哈希值
+  uint64_t row_hash(int row) const { return row_hashes_[row]; }
+
+  /// 第 group 个分组的键的哈希值
+  uint64_t group_hash(int group) const { return group_hashes_[group]; }
+
+  /**
+   * @brief 把 other 中的分组 groups 合并到当前哈希表中，已有的分组合并聚合状态，其它分组新建
+   * @details 用于并行聚合的合并阶段。other 的分组列与聚合函数必须与当前哈希表相同，other 只会被读取，
+   * 因此多个线程可以同时从同一个 other 中合并不同的分组。
+   */
+  RC merge(const VectorizedAggregateHashTable &other, const vector<int> &groups);
+
+private:
+  struct Slot
+  {
+    uint64_t hash;
+    int      group;  ///< -1 表示空槽位
+  };
+
+  RC init_key_layout(const Chunk &groups_chunk);
+  /// 使用与 other 相同的键格式
+  void copy_key_layout(const VectorizedAggregateHashTable &other);
+
+  /**
+   * @brief 将 chunk 中每一行的分组列按列序列化成规范化的键，结果写入 row_keys_ 中
+   */
+  void serialize_keys(const Chunk &groups_chunk, int rows);
+
+  /**
+   * @brief 探测哈希表，得到每一行对应的分组编号，不存在的分组会被创建
+   * @details 哈希表冻结后不存在的分组不再创建，这些行被映射到编号为 group_count_ 的一个额外分组上，
+   * 这个分组不会被输出。
+   */
+  void probe(int rows);
+
+  /**
+   * @brief 查找键对应的分组，不存在时创建。哈希表冻结后不存在的分组返回 -1
+   * @note 调用者需要保证哈希表中有足够的空槽位
+   */
+  int find_or_add_group(uint64_t hash, const char *key, int key_len);
+
+  int add_group(uint64_t hash, const char *key, int key_len);
+
+  const char *group_key(int group, int &key_len) const;
+
+  /// 将分组键反序列化后追加到 column 中
+  RC decode_key(int group, int key_col_idx, Column &column) const;
+
+  void grow();
+
+private:
+  static constexpr int INITIAL_CAPACITY = 1024;
+
+  bool             layout_inited_ = false;
+  vector<AttrType> key_types_;
+  vector<int>      key_lens_;
+  vector<int>      key_offsets_;      ///< 每个分组列在定长部分中的偏移
+  int              fixed_key_len_ = 0;  ///< 键的定长部分的长度
+  bool             var_len_key_   = false;
+
+  vector<Slot> slots_;
+  uint64_t     slot_mask_   = 0;
+  int          group_count_ = 0;
+  bool         frozen_      = false;
+
+  vector<char>        fixed_keys_;  ///< 定长键，第 i 个分组的键位于 i * fixed_key_len_
+  vector<const char *> var_keys_;    ///< 变长键在 arena_ 中的地址
+  vector<int>         var_key_lens_;
+  vector<uint64_t>    group_hashes_;
+  Arena               arena_;
+
+  vector<unique_ptr<GroupedAggregateState>> states_;
+
+  // 处理单个 chunk 时的临时数据，避免每次重新分配内存
+  vector<char>     row_keys_;
+  vector<int>      row_key_offsets_;
+  vector<int>      row_var_cursors_;
+  vector<uint64_t> row_hashes_;
+  vector<int>      row_groups_;
+  vector<int>      missed_rows_;
+};
+
+class ChunkSpillFile;
+
+/**
+ * @brief 可以溢出到磁盘的哈希聚合表(external hash aggregation)
+ * @details 数据先聚合到内存中的 VectorizedAggregateHashTable 中，当哈希表占用的内存超过 memory_limit 时，
+ * 哈希表被冻结：属于已有分组的行继续在内存中聚合，其它行（分组列与聚合函数的输入列）按照分组键哈希值的高位
+ * 划分到 PARTITION_NUM 个分区中，写入对应分区的临时文件。
+ * 输出时先输出内存中的分组，再逐个分区读取临时文件，使用下一层的哈希表重新聚合后输出。
+ * 每一层使用哈希值中不同的位划分分区，同一个分组的数据总是落在同一个分区中。
+ * 递归超过 MAX_LEVEL 层后不再限制内存。
+ * @note 内存使用量在每个 chunk 处理完之后检查，所以实际使用的内存可能会超过 memory_limit。
+ * memory_limit 只限制哈希表本身，分区写缓冲与扫描时下层哈希表的内存不计算在内。
+ */
+class SpillableAggregateHashTable : public AggregateHashTable
+{
+public:
+  class Scanner : public AggregateHashTable::Scanner
+  {
+  public:
+    explicit Scanner(AggregateHashTable *hash_table);
+    ~Scanner();
+
+    void open_scan() override;
+
+    RC next(Chunk &chunk) override;
+
+  private:
+    unique_ptr<VectorizedAggregateHashTable::Scanner> memory_scanner_;
+    bool                                              memory_done_   = false;
+    int                                               partition_idx_ = -1;
+    unique_ptr<SpillableAggregateHashTable>           partition_table_;
+    unique_ptr<Scanner>                               partition_scanner_;
+  };
+
+  /**
+   * @param memory_limit 哈希表可以使用的内存（字节），0 表示不限制
+   * @param level 递归的层数，用于选择划分分区的哈希值的位
+   */
+  SpillableAggregateHashTable(const vector<Expression *> &aggregations, size_t memory_limit, int level = 0);
+  virtual ~SpillableAggregateHashTable();
+
+  RC add_chunk(Chunk &groups_chunk, Chunk &aggrs_chunk) override;
+
+  /// 本层溢出到磁盘的行数
+  int64_t spilled_rows() const { return spilled_rows_; }
+
+  static constexpr int PARTITION_BITS = 4;
+  static constexpr int PARTITION_NUM  = 1 << PARTITION_BITS;
+  static constexpr int MAX_LEVEL      = 4;
+
+private:
+  int partition_of(uint64_t hash) const
+  {
+    return static_cast<int>((hash >> (64 - PARTITION_BITS * (level_ + 1))) & (PARTITION_NUM - 1));
+  }
+
+  /// 将 table_ 没有聚合的行写入分区
+  RC spill(const Chunk &groups_chunk, const Chunk &aggrs_chunk);
+
+  RC flush_partition(int partition);
+
+  /// 读取分区的临时文件，构建下一层的哈希表。分区没有数据时 table 为空
+  RC build_partition_table(int partition, unique_ptr<SpillableAggregateHashTable> &table);
+
+private:
+  static constexpr int SPILL_BATCH_SIZE = 1024;
+
+  vector<Expression *>         aggregations_;
+  size_t                       memory_limit_;
+  int                          level_;
+  VectorizedAggregateHashTable table_;
+
+  int                                group_column_num_ = 0;
+  vector<unique_ptr<Chunk>>          partition_buffers_;  ///< 分区的写缓冲
+  vector<unique_ptr<ChunkSpillFile>> partition_files_;
+  int64_t                            spilled_rows_ = 0;
+};
+
 /**
  * @brief 线性探测哈希表实现
  * @note 当前只支持group by 列为 char/char(4) 类型，且聚合列为单列。
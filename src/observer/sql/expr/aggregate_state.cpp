@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/expr/aggregate_state.h"
 #include "common/value.h"
+#include "common/lang/limits.h"
 #include <cstdint>
 #include <stdint.h>
 
@@ -32,6 +33,14 @@ void SumState<T>::update(const T *values, int size)
 #endif
 }
 
+template <typename T>
+void SumState<T>::update(const T *values, const int *selection, int size)
+{
+  for (int i = 0; i < size; ++i) {
+    value += values[selection[i]];
+  }
+}
+
 template <typename T>
 void AvgState<T>::update(const T *values, int size)
 {
@@ -41,6 +50,15 @@ void AvgState<T>::update(const T *values, int size)
   count += size;
 }
 
+template <typename T>
+void AvgState<T>::update(const T *values, const int *selection, int size)
+{
+  for (int i = 0; i < size; ++i) {
+    value += values[selection[i]];
+  }
+  count += size;
+}
+
 template <typename T>
 void CountState<T>::update(const T *values, int size)
 {
@@ -161,6 +179,51 @@ RC finialize_aggregate_state(void *state, AggregateExpr::Type aggr_type, AttrTyp
   return rc;
 }
 
+namespace {
+template <typename T>
+void merge_avg_state(void *state, const void *other)
+{
+  auto       *state_ptr = static_cast<AvgState<T> *>(state);
+  const auto *other_ptr = static_cast<const AvgState<T> *>(other);
+  state_ptr->value += other_ptr->value;
+  state_ptr->count += other_ptr->count;
+}
+}  // namespace
+
+RC aggregate_state_merge(void *state, const void *other, AggregateExpr::Type aggr_type, AttrType attr_type)
+{
+  RC rc = RC::SUCCESS;
+  if (aggr_type == AggregateExpr::Type::SUM) {
+    if (attr_type == AttrType::INTS) {
+      static_cast<SumState<int> *>(state)->update(static_cast<const SumState<int> *>(other)->value);
+    } else if (attr_type == AttrType::FLOATS) {
+      static_cast<SumState<float> *>(state)->update(static_cast<const SumState<float> *>(other)->value);
+    } else if (attr_type == AttrType::BIGINTS) {
+      static_cast<SumState<int64_t> *>(state)->update(static_cast<const SumState<int64_t> *>(other)->value);
+    } else {
+      rc = RC::UNIMPLEMENTED;
+      LOG_WARN("unsupported aggregate value type");
+    }
+  } else if (aggr_type == AggregateExpr::Type::COUNT) {
+    static_cast<CountState<int> *>(state)->value += static_cast<const CountState<int> *>(other)->value;
+  } else if (aggr_type == AggregateExpr::Type::AVG) {
+    if (attr_type == AttrType::INTS) {
+      merge_avg_state<int>(state, other);
+    } else if (attr_type == AttrType::FLOATS) {
+      merge_avg_state<float>(state, other);
+    } else if (attr_type == AttrType::BIGINTS) {
+      merge_avg_state<int64_t>(state, other);
+    } else {
+      rc = RC::UNIMPLEMENTED;
+      LOG_WARN("unsupported aggregate value type");
+    }
+  } else {
+    rc = RC::UNIMPLEMENTED;
+    LOG_WARN("unsupported aggregator type");
+  }
+  return rc;
+}
+
 template <class STATE, typename T>
 void update_aggregate_state(void *state, const Column &column)
 {
@@ -169,8 +232,32 @@ void update_aggregate_state(void *state, const Column &column)
   state_ptr->update(data, column.count());
 }
 
+namespace {
+/**
+ * @brief 收集 selection 中不为 NULL 的行号。selection 为空时表示前 size 行
+ */
+void collect_valid_rows(const Column &col, const int *selection, int size, vector<int> &rows)
+{
+  rows.clear();
+  rows.reserve(size);
+  for (int i = 0; i < size; i++) {
+    const int row = selection == nullptr ? i : selection[i];
+    if (!col.is_null(row)) {
+      rows.push_back(row);
+    }
+  }
+}
+}  // namespace
+
 RC aggregate_state_update_by_column(void *state, AggregateExpr::Type aggr_type, AttrType attr_type, Column &col)
 {
+  if (col.has_nulls()) {
+    // NULL 不参与聚合，只把有效的行交给按行号更新的版本
+    vector<int> rows;
+    collect_valid_rows(col, nullptr, col.count(), rows);
+    return aggregate_state_update_by_column(state, aggr_type, attr_type, col, rows.data(), static_cast<int>(rows.size()));
+  }
+
   RC rc = RC::SUCCESS;
   if (aggr_type == AggregateExpr::Type::SUM) {
     if (attr_type == AttrType::INTS) {
@@ -203,6 +290,56 @@ RC aggregate_state_update_by_column(void *state, AggregateExpr::Type aggr_type,
   return rc;
 }
 
+template <class STATE, typename T>
+void update_aggregate_state(void *state, const Column &column, const int *selection, int size)
+{
+  STATE *state_ptr = reinterpret_cast<STATE *>(state);
+  T     *data      = (T *)column.data();
+  state_ptr->update(data, selection, size);
+}
+
+RC aggregate_state_update_by_column(void *state, AggregateExpr::Type aggr_type, AttrType attr_type, const Column &col,
+    const int *selection, int size)
+{
+  vector<int> valid_rows;
+  if (col.has_nulls()) {
+    collect_valid_rows(col, selection, size, valid_rows);
+    selection = valid_rows.data();
+    size      = static_cast<int>(valid_rows.size());
+  }
+
+  RC rc = RC::SUCCESS;
+  if (aggr_type == AggregateExpr::Type::SUM) {
+    if (attr_type == AttrType::INTS) {
+      update_aggregate_state<SumState<int>, int>(state, col, selection, size);
+    } else if (attr_type == AttrType::FLOATS) {
+      update_aggregate_state<SumState<float>, float>(state, col, selection, size);
+    } else if (attr_type == AttrType::BIGINTS) {
+      update_aggregate_state<SumState<int64_t>, int64_t>(state, col, selection, size);
+    } else {
+      LOG_WARN("unsupported aggregate value type");
+      rc = RC::UNIMPLEMENTED;
+    }
+  } else if (aggr_type == AggregateExpr::Type::COUNT) {
+    update_aggregate_state<CountState<int>, int>(state, col, selection, size);
+  } else if (aggr_type == AggregateExpr::Type::AVG) {
+    if (attr_type == AttrType::INTS) {
+      update_aggregate_state<AvgState<int>, int>(state, col, selection, size);
+    } else if (attr_type == AttrType::FLOATS) {
+      update_aggregate_state<AvgState<float>, float>(state, col, selection, size);
+    } else if (attr_type == AttrType::BIGINTS) {
+      update_aggregate_state<AvgState<int64_t>, int64_t>(state, col, selection, size);
+    } else {
+      LOG_WARN("unsupported aggregate value type");
+      rc = RC::UNIMPLEMENTED;
+    }
+  } else {
+    LOG_WARN("unsupported aggregator type");
+    rc = RC::UNIMPLEMENTED;
+  }
+  return rc;
+}
+
 template class SumState<int>;
 template class SumState<float>;
 
@@ -210,3 +347,359 @@ template class CountState<int>;
 
 template class AvgState<int>;
 template class AvgState<float>;
+
+// ----------------------------------GroupedAggregateState------------------
+
+namespace {
+
+/// 常量列中只有一个有效值，逐行访问时步长为 0
+inline int column_stride(const Column &column)
+{
+  return column.column_type() == Column::Type::CONSTANT_COLUMN ? 0 : 1;
+}
+
+/**
+ * @brief 对前 rows 行中不为 NULL 的行调用 func(i)
+ * @details 列中没有 NULL 时不检查掩码，与逐行直接更新的循环相同
+ */
+template <typename FUNC>
+inline void for_each_valid_row(const Column &column, int rows, FUNC &&func)
+{
+  if (!column.has_nulls()) {
+    for (int i = 0; i < rows; i++) {
+      func(i);
+    }
+    return;
+  }
+  for (int i = 0; i < rows; i++) {
+    if (!column.is_null(i)) {
+      func(i);
+    }
+  }
+}
+
+/// 没有任何有效值的分组（只聚合过 NULL）结果为 NULL
+inline void set_empty_groups_null(const uint8_t *has_value, int count, int base, Column &column)
+{
+  for (int i = 0; i < count; i++) {
+    if (!has_value[i]) {
+      column.set_null(base + i);
+    }
+  }
+}
+
+template <typename T>
+class GroupedSumState : public GroupedAggregateState
+{
+public:
+  void resize(int group_count) override
+  {
+    sums_.resize(group_count, 0);
+    has_value_.resize(group_count, 0);
+  }
+
+  void update(const Column &column, const int *group_ids, int rows) override
+  {
+    const T  *values    = reinterpret_cast<const T *>(column.data());
+    const int stride    = column_stride(column);
+    T        *sums      = sums_.data();
+    uint8_t  *has_value = has_value_.data();
+    for_each_valid_row(column, rows, [&](int i) {
+      sums[group_ids[i]] += values[i * stride];
+      has_value[group_ids[i]] = 1;
+    });
+  }
+
+  RC finalize(int start, int count, Column &column) const override
+  {
+    const int base = column.count();
+    RC        rc   = column.append(reinterpret_cast<const char *>(sums_.data() + start), count);
+    if (OB_SUCC(rc)) {
+      set_empty_groups_null(has_value_.data() + start, count, base, column);
+    }
+    return rc;
+  }
+
+  void merge(const GroupedAggregateState &other, const int *src_groups, const int *dest_groups, int count) override
+  {
+    const auto &src = static_cast<const GroupedSumState &>(other);
+    for (int i = 0; i < count; i++) {
+      sums_[dest_groups[i]] += src.sums_[src_groups[i]];
+      has_value_[dest_groups[i]] |= src.has_value_[src_groups[i]];
+    }
+  }
+
+  size_t memory_usage() const override { return sums_.capacity() * sizeof(T) + has_value_.capacity(); }
+
+private:
+  vector<T>       sums_;
+  vector<uint8_t> has_value_;
+};
+
+class GroupedCountState : public GroupedAggregateState
+{
+public:
+  void resize(int group_count) override { counts_.resize(group_count, 0); }
+
+  void update(const Column &column, const int *group_ids, int rows) override
+  {
+    int *counts = counts_.data();
+    for_each_valid_row(column, rows, [&](int i) { counts[group_ids[i]]++; });
+  }
+
+  RC finalize(int start, int count, Column &column) const override
+  {
+    return column.append(reinterpret_cast<const char *>(counts_.data() + start), count);
+  }
+
+  void merge(const GroupedAggregateState &other, const int *src_groups, const int *dest_groups, int count) override
+  {
+    const auto &src = static_cast<const GroupedCountState &>(other);
+    for (int i = 0; i < count; i++) {
+      counts_[dest_groups[i]] += src.counts_[src_groups[i]];
+    }
+  }
+
+  size_t memory_usage() const override { return counts_.capacity() * sizeof(int); }
+
+private:
+  vector<int> counts_;
+};
+
+template <typename T>
+class GroupedAvgState : public GroupedAggregateState
+{
+public:
+  void resize(int group_count) override
+  {
+    sums_.resize(group_count, 0);
+    counts_.resize(group_count, 0);
+  }
+
+  void update(const Column &column, const int *group_ids, int rows) override
+  {
+    const T  *values = reinterpret_cast<const T *>(column.data());
+    const int stride = column_stride(column);
+    T        *sums   = sums_.data();
+    int      *counts = counts_.data();
+    for_each_valid_row(column, rows, [&](int i) {
+      sums[group_ids[i]] += values[i * stride];
+      counts[group_ids[i]]++;
+    });
+  }
+
+  RC finalize(int start, int count, Column &column) const override
+  {
+    RC rc = RC::SUCCESS;
+    for (int i = start; i < start + count && OB_SUCC(rc); i++) {
+      if (counts_[i] == 0) {
+        rc = column.append_null();
+        continue;
+      }
+      float avg = (float)sums_[i] / (float)counts_[i];
+      rc        = column.append_one(reinterpret_cast<const char *>(&avg));
+    }
+    return rc;
+  }
+
+  void merge(const GroupedAggregateState &other, const int *src_groups, const int *dest_groups, int count) override
+  {
+    const auto &src = static_cast<const GroupedAvgState &>(other);
+    for (int i = 0; i < count; i++) {
+      sums_[dest_groups[i]] += src.sums_[src_groups[i]];
+      counts_[dest_groups[i]] += src.counts_[src_groups[i]];
+    }
+  }
+
+  size_t memory_usage() const override { return sums_.capacity() * sizeof(T) + counts_.capacity() * sizeof(int); }
+
+private:
+  vector<T>   sums_;
+  vector<int> counts_;
+};
+
+template <typename T, bool IS_MIN>
+class GroupedMinMaxState : public GroupedAggregateState
+{
+public:
+  void resize(int group_count) override
+  {
+    values_.resize(group_count, IS_MIN ? numeric_limits<T>::max() : numeric_limits<T>::lowest());
+    has_value_.resize(group_count, 0);
+  }
+
+  void update(const Column &column, const int *group_ids, int rows) override
+  {
+    const T  *values    = reinterpret_cast<const T *>(column.data());
+    const int stride    = column_stride(column);
+    T        *states    = values_.data();
+    uint8_t  *has_value = has_value_.data();
+    for_each_valid_row(column, rows, [&](int i) {
+      const T value = values[i * stride];
+      T      &state = states[group_ids[i]];
+      if constexpr (IS_MIN) {
+        state = value < state ? value : state;
+      } else {
+        state = value > state ? value : state;
+      }
+      has_value[group_ids[i]] = 1;
+    });
+  }
+
+  RC finalize(int start, int count, Column &column) const override
+  {
+    const int base = column.count();
+    RC        rc   = column.append(reinterpret_cast<const char *>(values_.data() + start), count);
+    if (OB_SUCC(rc)) {
+      set_empty_groups_null(has_value_.data() + start, count, base, column);
+    }
+    return rc;
+  }
+
+  void merge(const GroupedAggregateState &other, const int *src_groups, const int *dest_groups, int count) override
+  {
+    const auto &src = static_cast<const GroupedMinMaxState &>(other);
+    for (int i = 0; i < count; i++) {
+      if (!src.has_value_[src_groups[i]]) {
+        continue;
+      }
+      const T value = src.values_[src_groups[i]];
+      T      &state = values_[dest_groups[i]];
+      if constexpr (IS_MIN) {
+        state = value < state ? value : state;
+      } else {
+        state = value > state ? value : state;
+      }
+      has_value_[dest_groups[i]] = 1;
+    }
+  }
+
+  size_t memory_usage() const override { return values_.capacity() * sizeof(T) + has_value_.capacity(); }
+
+private:
+  vector<T>       values_;
+  vector<uint8_t> has_value_;
+};
+
+/**
+ * @brief 定长字符串的 MIN/MAX。字符串在 Column 中以 '\0' 结尾或占满整个 attr_len。
+ */
+template <bool IS_MIN>
+class GroupedCharsMinMaxState : public GroupedAggregateState
+{
+public:
+  explicit GroupedCharsMinMaxState(int attr_len) : attr_len_(attr_len) {}
+
+  void resize(int group_count) override
+  {
+    values_.resize(static_cast<size_t>(group_count) * attr_len_, 0);
+    has_value_.resize(group_count, 0);
+  }
+
+  void update(const Column &column, const int *group_ids, int rows) override
+  {
+    const int stride = column_stride(column);
+    const int len    = std::min(attr_len_, column.attr_len());
+    for_each_valid_row(column, rows, [&](int i) {
+      const char *value = column.data() + static_cast<size_t>(i) * stride * column.attr_len();
+      const int   group = group_ids[i];
+      char       *state = values_.data() + static_cast<size_t>(group) * attr_len_;
+      const int   cmp   = compare(value, strnlen(value, len), state, strnlen(state, attr_len_));
+      if (!has_value_[group] || (IS_MIN ? cmp < 0 : cmp > 0)) {
+        memset(state, 0, attr_len_);
+        memcpy(state, value, strnlen(value, len));
+        has_value_[group] = 1;
+      }
+    });
+  }
+
+  RC finalize(int start, int count, Column &column) const override
+  {
+    const int base = column.count();
+    RC        rc   = column.append(values_.data() + static_cast<size_t>(start) * attr_len_, count);
+    if (OB_SUCC(rc)) {
+      set_empty_groups_null(has_value_.data() + start, count, base, column);
+    }
+    return rc;
+  }
+
+  void merge(const GroupedAggregateState &other, const int *src_groups, const int *dest_groups, int count) override
+  {
+    const auto &src = static_cast<const GroupedCharsMinMaxState &>(other);
+    for (int i = 0; i < count; i++) {
+      const int src_group  = src_groups[i];
+      const int dest_group = dest_groups[i];
+      if (!src.has_value_[src_group]) {
+        continue;
+      }
+      const char *value = src.values_.data() + static_cast<size_t>(src_group) * attr_len_;
+      char       *state = values_.data() + static_cast<size_t>(dest_group) * attr_len_;
+      const int   cmp   = compare(value, strnlen(value, attr_len_), state, strnlen(state, attr_len_));
+      if (!has_value_[dest_group] || (IS_MIN ? cmp < 0 : cmp > 0)) {
+        memcpy(state, value, attr_len_);
+        has_value_[dest_group] = 1;
+      }
+    }
+  }
+
+  size_t memory_usage() const override { return values_.capacity() + has_value_.capacity(); }
+
+private:
+  static int compare(const char *left, size_t left_len, const char *right, size_t right_len)
+  {
+    int cmp = memcmp(left, right, std::min(left_len, right_len));
+    if (cmp != 0) {
+      return cmp;
+    }
+    return static_cast<int>(left_len) - static_cast<int>(right_len);
+  }
+
+private:
+  int             attr_len_;
+  vector<char>    values_;
+  vector<uint8_t> has_value_;
+};
+
+template <template <typename> class STATE>
+unique_ptr<GroupedAggregateState> create_arithmetic_state(AttrType attr_type)
+{
+  switch (attr_type) {
+    case AttrType::INTS: return make_unique<STATE<int>>();
+    case AttrType::FLOATS: return make_unique<STATE<float>>();
+    case AttrType::BIGINTS: return make_unique<STATE<int64_t>>();
+    default: return nullptr;
+  }
+}
+
+template <bool IS_MIN>
+unique_ptr<GroupedAggregateState> create_min_max_state(AttrType attr_type, int attr_len)
+{
+  switch (attr_type) {
+    case AttrType::INTS:
+    case AttrType::DATES: return make_unique<GroupedMinMaxState<int, IS_MIN>>();
+    case AttrType::FLOATS: return make_unique<GroupedMinMaxState<float, IS_MIN>>();
+    case AttrType::BIGINTS: return make_unique<GroupedMinMaxState<int64_t, IS_MIN>>();
+    case AttrType::CHARS: return make_unique<GroupedCharsMinMaxState<IS_MIN>>(attr_len);
+    default: return nullptr;
+  }
+}
+
+}  // namespace
+
+unique_ptr<GroupedAggregateState> create_grouped_aggregate_state(
+    AggregateExpr::Type aggr_type, AttrType attr_type, int attr_len)
+{
+  unique_ptr<GroupedAggregateState> state;
+  switch (aggr_type) {
+    case AggregateExpr::Type::SUM: state = create_arithmetic_state<GroupedSumState>(attr_type); break;
+    case AggregateExpr::Type::AVG: state = create_arithmetic_state<GroupedAvgState>(attr_type); break;
+    case AggregateExpr::Type::COUNT: state = make_unique<GroupedCountState>(); break;
+    case AggregateExpr::Type::MIN: state = create_min_max_state<true>(attr_type, attr_len); break;
+    case AggregateExpr::Type::MAX: state = create_min_max_state<false>(attr_type, attr_len); break;
+  }
+  if (state == nullptr) {
+    LOG_TRACE("unsupported grouped aggregate state. aggr type=%d, attr type=%s",
+              static_cast<int>(aggr_type), attr_type_to_string(attr_type));
+  }
+  return state;
+}
@@ -17,6 +17,8 @@ public:
   SumState() : value(0) {}
   T    value;
   void update(const T *values, int size);
+  /// 只累加 selection 中的 size 行
+  void update(const T *values, const int *selection, int size);
   void update(const T &value) { this->value += value; }
   template <class U>
   U finalize()
@@ -32,6 +34,7 @@ public:
   CountState() : value(0) {}
   int  value;
   void update(const T *values, int size);
+  void update(const T *values, const int *selection, int size) { value += size; }
   void update(const T &value) { this->value++; }
   template <class U>
   U finalize()
@@ -48,6 +51,7 @@ public:
   T    value;
   int  count = 0;
   void update(const T *values, int size);
+  void update(const T *values, const int *selection, int size);
   void update(const T &value)
   {
     this->value += value;
@@ -64,5 +68,59 @@ void *create_aggregate_state(AggregateExpr::Type aggr_type, AttrType attr_type);
 
 RC aggregate_state_update_by_value(void *state, AggregateExpr::Type aggr_type, AttrType attr_type, const Value &val);
 RC aggregate_state_update_by_column(void *state, AggregateExpr::Type aggr_type, AttrType attr_type, Column &col);
+/**
+ * @brief 只使用 col 中 selection 指定的 size 行更新聚合状态
+ */
+RC aggregate_state_update_by_column(void *state, AggregateExpr::Type aggr_type, AttrType attr_type, const Column &col,
+    const int *selection, int size);
 
-RC finialize_aggregate_state(void *state, AggregateExpr::Type aggr_type, AttrType attr_type, Column &col);
\ No newline at end of file
+RC finialize_aggregate_state(void *state, AggregateExpr::Type aggr_type, AttrType attr_type, Column &col);
+
+/**
+ * @brief 把 other 合并到 state 中，两者必须是 create_aggregate_state 以同样的参数创建的
+ */
+RC aggregate_state_merge(void *state, const void *other, AggregateExpr::Type aggr_type, AttrType attr_type);
+
+/**
+ * @brief 按分组列式存放的聚合状态
+ * @details 所有分组的同一个聚合函数的状态连续存放在一起，下标就是分组编号(group id)。
+ * 更新时一次处理一整列数据，避免逐行的虚函数调用与 Value 构造。
+ */
+class GroupedAggregateState
+{
+public:
+  virtual ~GroupedAggregateState() = default;
+
+  /**
+   * @brief 扩展状态数组，使其能够容纳 group_count 个分组，新分组的状态被初始化
+   */
+  virtual void resize(int group_count) = 0;
+
+  /**
+   * @brief 使用 column 中的前 rows 行更新聚合状态，第 i 行属于分组 group_ids[i]
+   */
+  virtual void update(const Column &column, const int *group_ids, int rows) = 0;
+
+  /**
+   * @brief 将分组 [start, start + count) 的聚合结果追加到 column 中
+   */
+  virtual RC finalize(int start, int count, Column &column) const = 0;
+
+  /**
+   * @brief 把 other 中分组 src_groups[i] 的状态合并到本状态的分组 dest_groups[i] 中
+   * @details 用于并行聚合合并各个线程的部分结果，other 必须是同样的聚合函数、同样的数据类型
+   */
+  virtual void merge(const GroupedAggregateState &other, const int *src_groups, const int *dest_groups, int count) = 0;
+
+  /**
+   * @brief 聚合状态占用的内存大小（字节）
+   */
+  virtual size_t memory_usage() const = 0;
+};
+
+/**
+ * @brief 创建分组聚合状态，不支持的聚合类型或数据类型返回 nullptr
+ * @param attr_len 聚合列的长度，仅对 CHARS 类型的 MIN/MAX 有意义
+ */
+unique_ptr<GroupedAggregateState> create_grouped_aggregate_state(
+    AggregateExpr::Type aggr_type, AttrType attr_type, int attr_len);
\ No newline at end of file
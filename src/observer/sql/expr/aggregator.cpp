@@ -34,3 +34,62 @@ RC SumAggregator::evaluate(Value& result)
   result = value_;
   return RC::SUCCESS;
 }
+
+RC CountAggregator::accumulate(const Value &value)
+{
+  count_++;
+  return RC::SUCCESS;
+}
+
+RC CountAggregator::evaluate(Value &result)
+{
+  result = Value(count_);
+  return RC::SUCCESS;
+}
+
+RC MaxMinAggregator::accumulate(const Value &value)
+{
+  if (value_.attr_type() == AttrType::UNDEFINED) {
+    value_ = value;
+    return RC::SUCCESS;
+  }
+
+  const int cmp = value.compare(value_);
+  if ((is_max_ && cmp > 0) || (!is_max_ && cmp < 0)) {
+    value_ = value;
+  }
+  return RC::SUCCESS;
+}
+
+RC MaxMinAggregator::evaluate(Value &result)
+{
+  result = value_;
+  return RC::SUCCESS;
+}
+
+RC AvgAggregator::accumulate(const Value &value)
+{
+  switch (value.attr_type()) {
+    case AttrType::INTS:
+    case AttrType::BIGINTS:
+    case AttrType::FLOATS: {
+      sum_ += value.attr_type() == AttrType::BIGINTS ? static_cast<double>(value.get_bigint()) : value.get_float();
+      count_++;
+    } break;
+    default: {
+      LOG_WARN("unsupported value type for avg. type=%s", attr_type_to_string(value.attr_type()));
+      return RC::UNSUPPORTED;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC AvgAggregator::evaluate(Value &result)
+{
+  if (count_ == 0) {
+    result = Value();
+    return RC::SUCCESS;
+  }
+  result = Value(static_cast<float>(sum_ / count_));
+  return RC::SUCCESS;
+}
@@ -35,3 +35,42 @@ public:
   RC accumulate(const Value &value) override;
   RC evaluate(Value &result) override;
 };
+
+class CountAggregator : public Aggregator
+{
+public:
+  RC accumulate(const Value &value) override;
+  RC evaluate(Value &result) override;
+
+private:
+  int count_ = 0;
+};
+
+/**
+ * @brief MAX/MIN 聚合，is_max 为 false 时取最小值
+ */
+class MaxMinAggregator : public Aggregator
+{
+public:
+  explicit MaxMinAggregator(bool is_max) : is_max_(is_max) {}
+
+  RC accumulate(const Value &value) override;
+  RC evaluate(Value &result) override;
+
+private:
+  bool is_max_;
+};
+
+/**
+ * @brief AVG 聚合，与向量化的 AvgState 一样输出 FLOATS
+ */
+class AvgAggregator : public Aggregator
+{
+public:
+  RC accumulate(const Value &value) override;
+  RC evaluate(Value &result) override;
+
+private:
+  double sum_   = 0;
+  int    count_ = 0;
+};
@@ -0,0 +1,244 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/expr/arithmetic_kernel.h"
+#include "common/lang/type_traits.h"
+#include "common/log/log.h"
+#include "sql/expr/arithmetic_operator.hpp"
+
+namespace {
+
+/// 参与计算的物理类型在函数表中的下标
+enum PhysicalType
+{
+  INT_TYPE,
+  BIGINT_TYPE,
+  FLOAT_TYPE,
+  PHYSICAL_TYPE_NUM
+};
+
+int physical_type(AttrType attr_type)
+{
+  switch (attr_type) {
+    case AttrType::INTS:
+    case AttrType::DATES: return INT_TYPE;
+    case AttrType::BIGINTS: return BIGINT_TYPE;
+    case AttrType::FLOATS: return FLOAT_TYPE;
+    default: return -1;
+  }
+}
+
+/// 与 arithmetic_result_type 的规则一致
+template <typename L, typename R, bool IS_DIV>
+using result_t = conditional_t<IS_DIV || is_same_v<L, float> || is_same_v<R, float>,
+    float,
+    conditional_t<is_same_v<L, int64_t> || is_same_v<R, int64_t>, int64_t, int>>;
+
+template <ArithmeticExpr::Type TYPE>
+struct OperatorOf;
+template <>
+struct OperatorOf<ArithmeticExpr::Type::ADD>
+{
+  using type = AddOperator;
+};
+template <>
+struct OperatorOf<ArithmeticExpr::Type::SUB>
+{
+  using type = SubtractOperator;
+};
+template <>
+struct OperatorOf<ArithmeticExpr::Type::MUL>
+{
+  using type = MultiplyOperator;
+};
+template <>
+struct OperatorOf<ArithmeticExpr::Type::DIV>
+{
+  using type = DivideOperator;
+};
+
+/**
+ * @brief 溢出时再检查一遍有效的行
+ * @details selection 为 nullptr 时前 size 行都有效。被过滤掉的行以及 NULL 行的数据没有意义，不能因为它们报错
+ */
+template <typename L, typename R, typename OUT, class OP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+bool overflow_on_valid_rows(const Column &left, const Column &right, const int *selection, int size)
+{
+  const L *left_data  = reinterpret_cast<const L *>(left.data());
+  const R *right_data = reinterpret_cast<const R *>(right.data());
+  OUT      result;
+  for (int k = 0; k < size; k++) {
+    const int i = selection == nullptr ? k : selection[k];
+    if (left.is_null(i) || right.is_null(i)) {
+      continue;
+    }
+    if (OP::checked_operation(static_cast<OUT>(left_data[LEFT_CONSTANT ? 0 : i]),
+            static_cast<OUT>(right_data[RIGHT_CONSTANT ? 0 : i]),
+            result)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename L, typename R, typename OUT, class OP, bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
+RC binary_kernel(
+    const Column &left, const Column &right, Column &result, int rows, const int *selection, int selected)
+{
+  const L *left_data   = reinterpret_cast<const L *>(left.data());
+  const R *right_data  = reinterpret_cast<const R *>(right.data());
+  OUT     *result_data = reinterpret_cast<OUT *>(result.data());
+
+  if constexpr (is_same_v<OUT, float>) {
+    if constexpr (is_same_v<L, float> && is_same_v<R, float>) {
+      binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, float, OP>(
+          const_cast<float *>(left_data), const_cast<float *>(right_data), result_data, rows);
+    } else {
+      for (int i = 0; i < rows; i++) {
+        result_data[i] = OP::template operation<float>(static_cast<float>(left_data[LEFT_CONSTANT ? 0 : i]),
+            static_cast<float>(right_data[RIGHT_CONSTANT ? 0 : i]));
+      }
+    }
+    return RC::SUCCESS;
+  } else {
+    bool overflow = false;
+    if constexpr (is_same_v<L, OUT> && is_same_v<R, OUT>) {
+      overflow =
+          checked_binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, OUT, OP>(left_data, right_data, result_data, rows);
+    } else {
+      for (int i = 0; i < rows; i++) {
+        overflow |= OP::checked_operation(static_cast<OUT>(left_data[LEFT_CONSTANT ? 0 : i]),
+            static_cast<OUT>(right_data[RIGHT_CONSTANT ? 0 : i]),
+            result_data[i]);
+      }
+    }
+    if (overflow && (selection != nullptr || left.has_nulls() || right.has_nulls())) {
+      overflow = overflow_on_valid_rows<L, R, OUT, OP, LEFT_CONSTANT, RIGHT_CONSTANT>(
+          left, right, selection, selection == nullptr ? rows : selected);
+    }
+    if (overflow) {
+      LOG_WARN("integer overflow in arithmetic expression");
+      return RC::RANGE_ERROR;
+    }
+    return RC::SUCCESS;
+  }
+}
+
+template <typename T, bool CONSTANT>
+RC negate_kernel(
+    const Column &input, const Column & /*unused*/, Column &result, int rows, const int *selection, int selected)
+{
+  T *input_data  = reinterpret_cast<T *>(input.data());
+  T *result_data = reinterpret_cast<T *>(result.data());
+  if constexpr (is_same_v<T, float>) {
+    unary_operator<CONSTANT, T, NegateOperator>(input_data, result_data, rows);
+    return RC::SUCCESS;
+  } else {
+    bool overflow = false;
+    for (int i = 0; i < rows; i++) {
+      overflow |= NegateOperator::checked_operation(input_data[CONSTANT ? 0 : i], result_data[i]);
+    }
+    if (overflow && (selection != nullptr || input.has_nulls())) {
+      overflow = false;
+      T value;
+      const int size = selection == nullptr ? rows : selected;
+      for (int k = 0; k < size && !overflow; k++) {
+        const int i = selection == nullptr ? k : selection[k];
+        overflow    = !input.is_null(i) && NegateOperator::checked_operation(input_data[CONSTANT ? 0 : i], value);
+      }
+    }
+    if (overflow) {
+      LOG_WARN("integer overflow in arithmetic expression");
+      return RC::RANGE_ERROR;
+    }
+    return RC::SUCCESS;
+  }
+}
+
+template <ArithmeticExpr::Type TYPE, typename L, typename R>
+constexpr ArithmeticKernels binary_kernels()
+{
+  using OP  = typename OperatorOf<TYPE>::type;
+  using OUT = result_t<L, R, TYPE == ArithmeticExpr::Type::DIV>;
+  return {binary_kernel<L, R, OUT, OP, false, false>,
+      binary_kernel<L, R, OUT, OP, false, true>,
+      binary_kernel<L, R, OUT, OP, true, false>,
+      binary_kernel<L, R, OUT, OP, true, true>};
+}
+
+template <ArithmeticExpr::Type TYPE>
+constexpr array<array<ArithmeticKernels, PHYSICAL_TYPE_NUM>, PHYSICAL_TYPE_NUM> binary_kernel_matrix()
+{
+  return {{
+      {binary_kernels<TYPE, int, int>(), binary_kernels<TYPE, int, int64_t>(), binary_kernels<TYPE, int, float>()},
+      {binary_kernels<TYPE, int64_t, int>(),
+          binary_kernels<TYPE, int64_t, int64_t>(),
+          binary_kernels<TYPE, int64_t, float>()},
+      {binary_kernels<TYPE, float, int>(), binary_kernels<TYPE, float, int64_t>(), binary_kernels<TYPE, float, float>()},
+  }};
+}
+
+/// 取负时左右参数是同一列，只按左参数是否为常量选择
+template <typename T>
+constexpr ArithmeticKernels negate_kernels()
+{
+  return {negate_kernel<T, false>, negate_kernel<T, false>, negate_kernel<T, true>, negate_kernel<T, true>};
+}
+
+/// 下标依次为运算类型、左参数的物理类型、右参数的物理类型
+constexpr array<array<array<ArithmeticKernels, PHYSICAL_TYPE_NUM>, PHYSICAL_TYPE_NUM>, 4> BINARY_KERNELS = {
+    binary_kernel_matrix<ArithmeticExpr::Type::ADD>(),
+    binary_kernel_matrix<ArithmeticExpr::Type::SUB>(),
+    binary_kernel_matrix<ArithmeticExpr::Type::MUL>(),
+    binary_kernel_matrix<ArithmeticExpr::Type::DIV>(),
+};
+
+constexpr array<ArithmeticKernels, PHYSICAL_TYPE_NUM> NEGATE_KERNELS = {
+    negate_kernels<int>(), negate_kernels<int64_t>(), negate_kernels<float>()};
+
+}  // namespace
+
+AttrType arithmetic_result_type(ArithmeticExpr::Type type, AttrType left_type, AttrType right_type)
+{
+  const int left = physical_type(left_type);
+  if (type == ArithmeticExpr::Type::NEGATIVE) {
+    return left < 0 ? AttrType::UNDEFINED : left_type;
+  }
+  const int right = physical_type(right_type);
+  if (left < 0 || right < 0) {
+    return AttrType::UNDEFINED;
+  }
+  if (type == ArithmeticExpr::Type::DIV || left == FLOAT_TYPE || right == FLOAT_TYPE) {
+    return AttrType::FLOATS;
+  }
+  if (left == BIGINT_TYPE || right == BIGINT_TYPE) {
+    return AttrType::BIGINTS;
+  }
+  return AttrType::INTS;
+}
+
+RC get_arithmetic_kernels(
+    ArithmeticExpr::Type type, AttrType left_type, AttrType right_type, ArithmeticKernels &kernels)
+{
+  const int left = physical_type(left_type);
+  if (left < 0) {
+    return RC::UNIMPLEMENTED;
+  }
+  if (type == ArithmeticExpr::Type::NEGATIVE) {
+    kernels = NEGATE_KERNELS[left];
+    return RC::SUCCESS;
+  }
+  const int right = physical_type(right_type);
+  if (right < 0) {
+    return RC::UNIMPLEMENTED;
+  }
+  kernels = BINARY_KERNELS[static_cast<int>(type)][left][right];
+  return RC::SUCCESS;
+}
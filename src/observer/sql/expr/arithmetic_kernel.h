@@ -0,0 +1,38 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/array.h"
+#include "sql/expr/expression.h"
+
+/**
+ * @file arithmetic_kernel.h
+ * @brief 向量化算术运算函数表
+ * @details 每种运算、左右参数的类型以及左右参数是否为常量都对应一个模板实例化出来的函数，
+ * 表达式在绑定时查表选定函数，执行时不再按类型分派。INTS 与 DATES 都按 int 计算。
+ */
+
+/// 按左右参数是否为常量排列的一组计算函数，下标为 left_const * 2 + right_const
+using ArithmeticKernels = array<ArithmeticExpr::Kernel, 4>;
+
+/**
+ * @brief 算术运算结果的类型
+ * @details 整数之间的加减乘结果为整数，有 BIGINT 参与时为 BIGINT。除法以及有浮点数参与的运算结果为 FLOAT。
+ * 取负与参数类型相同。有非数值类型参与时返回 UNDEFINED
+ */
+AttrType arithmetic_result_type(ArithmeticExpr::Type type, AttrType left_type, AttrType right_type);
+
+/**
+ * @brief 查找计算函数。取负时忽略 right_type，调用时左右参数传同一列
+ * @return 不支持的类型组合返回 RC::UNIMPLEMENTED
+ */
+RC get_arithmetic_kernels(
+    ArithmeticExpr::Type type, AttrType left_type, AttrType right_type, ArithmeticKernels &kernels);
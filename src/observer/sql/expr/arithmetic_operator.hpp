@@ -135,10 +135,36 @@ struct AddOperator
     return left + right;
   }
 
+  /// 带溢出检查的整数运算，溢出时返回 true
+  template <class T>
+  static inline bool checked_operation(T left, T right, T &result)
+  {
+    return __builtin_add_overflow(left, right, &result);
+  }
+
 #if defined(USE_SIMD)
   static inline __m256 operation(__m256 left, __m256 right) { return _mm256_add_ps(left, right); }
 
   static inline __m256i operation(__m256i left, __m256i right) { return _mm256_add_epi32(left, right); }
+
+  /// 溢出的通道在 overflow 中置为非 0。两个加数同号而结果异号时溢出
+  static inline __m256i checked_operation_int32(__m256i left, __m256i right, __m256i &overflow)
+  {
+    const __m256i result = _mm256_add_epi32(left, right);
+    const __m256i sign   = _mm256_and_si256(_mm256_xor_si256(left, result), _mm256_xor_si256(right, result));
+    overflow             = _mm256_or_si256(overflow, _mm256_srai_epi32(sign, 31));
+    return result;
+  }
+
+  static constexpr bool SIMD_INT64 = true;
+
+  static inline __m256i checked_operation_int64(__m256i left, __m256i right, __m256i &overflow)
+  {
+    const __m256i result = _mm256_add_epi64(left, right);
+    const __m256i sign   = _mm256_and_si256(_mm256_xor_si256(left, result), _mm256_xor_si256(right, result));
+    overflow             = _mm256_or_si256(overflow, _mm256_and_si256(sign, _mm256_set1_epi64x(INT64_MIN)));
+    return result;
+  }
 #endif
 };
 
@@ -149,11 +175,36 @@ struct SubtractOperator
   {
     return left - right;
   }
-  // your code here
+
+  template <class T>
+  static inline bool checked_operation(T left, T right, T &result)
+  {
+    return __builtin_sub_overflow(left, right, &result);
+  }
+
 #if defined(USE_SIMD)
-  static inline __m256 operation(__m256 left, __m256 right) { exit(-1); }
+  static inline __m256 operation(__m256 left, __m256 right) { return _mm256_sub_ps(left, right); }
+
+  static inline __m256i operation(__m256i left, __m256i right) { return _mm256_sub_epi32(left, right); }
+
+  /// 被减数与减数异号且结果与被减数异号时溢出
+  static inline __m256i checked_operation_int32(__m256i left, __m256i right, __m256i &overflow)
+  {
+    const __m256i result = _mm256_sub_epi32(left, right);
+    const __m256i sign   = _mm256_and_si256(_mm256_xor_si256(left, right), _mm256_xor_si256(left, result));
+    overflow             = _mm256_or_si256(overflow, _mm256_srai_epi32(sign, 31));
+    return result;
+  }
+
+  static constexpr bool SIMD_INT64 = true;
 
-  static inline __m256i operation(__m256i left, __m256i right) { exit(-1); }
+  static inline __m256i checked_operation_int64(__m256i left, __m256i right, __m256i &overflow)
+  {
+    const __m256i result = _mm256_sub_epi64(left, right);
+    const __m256i sign   = _mm256_and_si256(_mm256_xor_si256(left, right), _mm256_xor_si256(left, result));
+    overflow             = _mm256_or_si256(overflow, _mm256_and_si256(sign, _mm256_set1_epi64x(INT64_MIN)));
+    return result;
+  }
 #endif
 };
 
@@ -164,11 +215,34 @@ struct MultiplyOperator
   {
     return left * right;
   }
-// your code here
+
+  template <class T>
+  static inline bool checked_operation(T left, T right, T &result)
+  {
+    return __builtin_mul_overflow(left, right, &result);
+  }
+
 #if defined(USE_SIMD)
-  static inline __m256 operation(__m256 left, __m256 right) { exit(-1); }
+  static inline __m256 operation(__m256 left, __m256 right) { return _mm256_mul_ps(left, right); }
+
+  static inline __m256i operation(__m256i left, __m256i right) { return _mm256_mullo_epi32(left, right); }
+
+  /// 分别计算偶数与奇数通道的 64 位乘积，高 32 位不等于低 32 位的符号扩展时溢出
+  static inline __m256i checked_operation_int32(__m256i left, __m256i right, __m256i &overflow)
+  {
+    const __m256i result = _mm256_mullo_epi32(left, right);
+    const __m256i even   = _mm256_mul_epi32(left, right);
+    const __m256i odd    = _mm256_mul_epi32(_mm256_srli_epi64(left, 32), _mm256_srli_epi64(right, 32));
+    const __m256i high   = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0b10101010);
+    const __m256i equal  = _mm256_cmpeq_epi32(high, _mm256_srai_epi32(result, 31));
+    overflow             = _mm256_or_si256(overflow, _mm256_andnot_si256(equal, _mm256_set1_epi32(-1)));
+    return result;
+  }
+
+  /// AVX2 没有 64 位乘法，BIGINT 乘法逐个计算
+  static constexpr bool SIMD_INT64 = false;
 
-  static inline __m256i operation(__m256i left, __m256i right) { exit(-1); }
+  static inline __m256i checked_operation_int64(__m256i left, __m256i right, __m256i &overflow) { return left; }
 #endif
 };
 
@@ -202,6 +276,13 @@ struct NegateOperator
   {
     return -input;
   }
+
+  /// 最小的负数取负会溢出
+  template <class T>
+  static inline bool checked_operation(T input, T &result)
+  {
+    return __builtin_sub_overflow(T(0), input, &result);
+  }
 };
 
 template <typename T, bool LEFT_CONSTANT, bool RIGHT_CONSTANT, class OP>
@@ -331,6 +412,46 @@ void binary_operator(T *left_data, T *right_data, T *result_data, int size)
 #endif
 }
 
+/**
+ * @brief 带溢出检查的整数运算
+ * @return 有任意一行溢出时返回 true
+ */
+template <bool LEFT_CONSTANT, bool RIGHT_CONSTANT, typename T, class OP>
+bool checked_binary_operator(const T *left_data, const T *right_data, T *result_data, int size)
+{
+  int  i        = 0;
+  bool overflow = false;
+#if defined(USE_SIMD)
+  __m256i overflow_lanes = _mm256_setzero_si256();
+  if constexpr (is_same<T, int>::value) {
+    for (; i <= size - SIMD_WIDTH; i += SIMD_WIDTH) {
+      const __m256i left_value  = LEFT_CONSTANT ? _mm256_set1_epi32(left_data[0])
+                                                : _mm256_loadu_si256((const __m256i *)&left_data[i]);
+      const __m256i right_value = RIGHT_CONSTANT ? _mm256_set1_epi32(right_data[0])
+                                                 : _mm256_loadu_si256((const __m256i *)&right_data[i]);
+      _mm256_storeu_si256(
+          (__m256i *)&result_data[i], OP::checked_operation_int32(left_value, right_value, overflow_lanes));
+    }
+  } else if constexpr (is_same<T, int64_t>::value && OP::SIMD_INT64) {
+    constexpr int INT64_LANES = SIMD_WIDTH / 2;
+    for (; i <= size - INT64_LANES; i += INT64_LANES) {
+      const __m256i left_value  = LEFT_CONSTANT ? _mm256_set1_epi64x(left_data[0])
+                                                : _mm256_loadu_si256((const __m256i *)&left_data[i]);
+      const __m256i right_value = RIGHT_CONSTANT ? _mm256_set1_epi64x(right_data[0])
+                                                 : _mm256_loadu_si256((const __m256i *)&right_data[i]);
+      _mm256_storeu_si256(
+          (__m256i *)&result_data[i], OP::checked_operation_int64(left_value, right_value, overflow_lanes));
+    }
+  }
+  overflow = !_mm256_testz_si256(overflow_lanes, overflow_lanes);
+#endif
+  for (; i < size; i++) {
+    overflow |= OP::checked_operation(
+        left_data[LEFT_CONSTANT ? 0 : i], right_data[RIGHT_CONSTANT ? 0 : i], result_data[i]);
+  }
+  return overflow;
+}
+
 template <bool CONSTANT, typename T, class OP>
 void unary_operator(T *input, T *result_data, int size)
 {
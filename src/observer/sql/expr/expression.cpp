@@ -13,6 +13,8 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/expr/expression.h"
+#include "sql/expr/arithmetic_kernel.h"
+#include "common/lang/comparator.h"
 #include "common/type/attr_type.h"
 #include "common/type/data_type.h"
 #include "sql/expr/tuple.h"
@@ -106,7 +108,7 @@ RC CastExpr::get_value(const Tuple &tuple, Value &result) const
 
 RC CastExpr::get_column(Chunk &chunk, Column &column)
 {
-  Column child_column;
+  Column child_column(chunk.memory_pool());
   RC     rc = child_->get_column(chunk, child_column);
   if (rc != RC::SUCCESS) {
     return rc;
@@ -176,6 +178,19 @@ RC ComparisonExpr::compare_value(const Value &left, const Value &right, bool &re
   return rc;
 }
 
+bool ComparisonExpr::match_compare_result(int cmp_result) const
+{
+  switch (comp_) {
+    case EQUAL_TO: return cmp_result == 0;
+    case LESS_EQUAL: return cmp_result <= 0;
+    case NOT_EQUAL: return cmp_result != 0;
+    case LESS_THAN: return cmp_result < 0;
+    case GREAT_EQUAL: return cmp_result >= 0;
+    case GREAT_THAN: return cmp_result > 0;
+    default: return false;
+  }
+}
+
 RC ComparisonExpr::try_get_value(Value &cell) const
 {
   if (left_->type() == ExprType::VALUE && right_->type() == ExprType::VALUE) {
@@ -225,8 +240,8 @@ RC ComparisonExpr::get_value(const Tuple &tuple, Value &value) const
 RC ComparisonExpr::eval(Chunk &chunk, vector<uint8_t> &select)
 {
   RC     rc = RC::SUCCESS;
-  Column left_column;
-  Column right_column;
+  Column left_column(chunk.memory_pool());
+  Column right_column(chunk.memory_pool());
 
   rc = left_->get_column(chunk, left_column);
   if (rc != RC::SUCCESS) {
@@ -253,17 +268,19 @@ RC ComparisonExpr::eval(Chunk &chunk, vector<uint8_t> &select)
     } else {
       rows = left_column.count();
     }
+    // 直接比较列中的字符串，不再为每一行构造 Value
     for (int i = 0; i < rows; ++i) {
-      Value left_val  = left_column.get_value(i);
-      Value right_val = right_column.get_value(i);
-      bool  result    = false;
-      rc              = compare_value(left_val, right_val, result);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("failed to compare tuple cells. rc=%s", strrc(rc));
-        return rc;
+      if (select[i] == 0) {
+        continue;
       }
-      select[i] &= result ? 1 : 0;
+      string_view left_str  = column_string(left_column, i);
+      string_view right_str = column_string(right_column, i);
+      const int   cmp       = common::compare_string(
+          (void *)left_str.data(), left_str.size(), (void *)right_str.data(), right_str.size());
+      select[i] = match_compare_result(cmp) ? 1 : 0;
     }
+    filter_nulls(left_column, select.data(), rows);
+    filter_nulls(right_column, select.data(), rows);
   } else if (left_column.attr_type() == AttrType::BIGINTS) {
     rc = compare_column<int64_t>(left_column, right_column, select);
   } else {
@@ -289,6 +306,9 @@ RC ComparisonExpr::compare_column(const Column &left, const Column &right, vecto
   } else {
     compare_result<T, false, false>((T *)left.data(), (T *)right.data(), left.count(), result, comp_);
   }
+  const int rows = right_const ? left.count() : right.count();
+  filter_nulls(left, result.data(), rows);
+  filter_nulls(right, result.data(), rows);
   return rc;
 }
 
@@ -324,14 +344,361 @@ RC ConjunctionExpr::get_value(const Tuple &tuple, Value &value) const
   return rc;
 }
 
+RC ConjunctionExpr::eval(Chunk &chunk, vector<uint8_t> &select)
+{
+  RC        rc   = RC::SUCCESS;
+  const int rows = static_cast<int>(select.size());
+  if (conjunction_type_ == Type::AND) {
+    for (unique_ptr<Expression> &child : children_) {
+      if (select_none(select.data(), rows)) {
+        break;
+      }
+      rc = child->eval(chunk, select);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to eval child expression. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+    return rc;
+  }
+
+  if (children_.empty()) {
+    return rc;
+  }
+  vector<uint8_t> matched(rows, 0);
+  vector<uint8_t> pending(rows);
+  for (unique_ptr<Expression> &child : children_) {
+    // 只计算被选中、且还没有满足任何一个子表达式的行
+    pending.assign(select.begin(), select.end());
+    and_not_select(pending.data(), matched.data(), rows);
+    if (select_none(pending.data(), rows)) {
+      break;
+    }
+    rc = child->eval(chunk, pending);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to eval child expression. rc=%s", strrc(rc));
+      return rc;
+    }
+    or_select(matched.data(), pending.data(), rows);
+  }
+  and_select(select.data(), matched.data(), rows);
+  return rc;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SubQueryExpr::SubQueryExpr(
+    SubQueryType sub_query_type, CompOp comp, unique_ptr<Expression> left, SelectStmt *select_stmt)
+    : sub_query_type_(sub_query_type), comp_(comp), left_(std::move(left)), select_stmt_(select_stmt)
+{}
+
+RC SubQueryExpr::get_value(const Tuple &tuple, Value &value) const
+{
+  LOG_WARN("sub query should be unnested before execution");
+  return RC::UNIMPLEMENTED;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+NotExpr::NotExpr(unique_ptr<Expression> child) : child_(std::move(child)) {}
+
+RC NotExpr::get_value(const Tuple &tuple, Value &value) const
+{
+  Value child_value;
+  RC    rc = child_->get_value(tuple, child_value);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get value of child expression. rc=%s", strrc(rc));
+    return rc;
+  }
+  value.set_boolean(!child_value.get_boolean());
+  return rc;
+}
+
+RC NotExpr::eval(Chunk &chunk, vector<uint8_t> &select)
+{
+  vector<uint8_t> child_select(select);
+  RC              rc = child_->eval(chunk, child_select);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to eval child expression. rc=%s", strrc(rc));
+    return rc;
+  }
+  and_not_select(select.data(), child_select.data(), static_cast<int>(select.size()));
+  return rc;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+InExpr::InExpr(unique_ptr<Expression> child, vector<Value> values) : child_(std::move(child)), values_(std::move(values))
+{
+  if (values_.empty()) {
+    return;
+  }
+  const AttrType attr_type = values_.front().attr_type();
+  if (!same_type(attr_type)) {
+    return;
+  }
+  switch (attr_type) {
+    case AttrType::INTS:
+    case AttrType::DATES: {
+      vector<int> list;
+      for (const Value &value : values_) {
+        list.push_back(*reinterpret_cast<const int *>(value.data()));
+      }
+      int_filter_.init(std::move(list));
+    } break;
+    case AttrType::BIGINTS: {
+      vector<int64_t> list;
+      for (const Value &value : values_) {
+        list.push_back(value.get_bigint());
+      }
+      bigint_filter_.init(std::move(list));
+    } break;
+    case AttrType::FLOATS: {
+      vector<float> list;
+      for (const Value &value : values_) {
+        list.push_back(value.get_float());
+      }
+      float_filter_.init(std::move(list));
+    } break;
+    case AttrType::CHARS:
+    case AttrType::TEXTS: {
+      strings_.reserve(values_.size());
+      vector<string_view> list;
+      for (const Value &value : values_) {
+        strings_.emplace_back(value.data(), value.length());
+      }
+      for (const string &str : strings_) {
+        list.emplace_back(str);
+      }
+      string_filter_.init(std::move(list));
+    } break;
+    default: break;
+  }
+}
+
+bool InExpr::same_type(AttrType attr_type) const
+{
+  for (const Value &value : values_) {
+    if (value.attr_type() != attr_type && !(is_string_type(value.attr_type()) && is_string_type(attr_type))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool InExpr::contains(const Value &value) const
+{
+  for (const Value &item : values_) {
+    if (value.compare(item) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RC InExpr::get_value(const Tuple &tuple, Value &value) const
+{
+  Value child_value;
+  RC    rc = child_->get_value(tuple, child_value);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get value of child expression. rc=%s", strrc(rc));
+    return rc;
+  }
+  value.set_boolean(contains(child_value));
+  return rc;
+}
+
+RC InExpr::eval(Chunk &chunk, vector<uint8_t> &select)
+{
+  Column column(chunk.memory_pool());
+  RC     rc = child_->get_column(chunk, column);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get column of child expression. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  const int rows = static_cast<int>(select.size());
+  filter_nulls(column, select.data(), rows);
+  if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+    const uint8_t hit = contains(column.get_value(0)) ? 1 : 0;
+    for (int i = 0; i < rows; i++) {
+      select[i] &= hit;
+    }
+    return rc;
+  }
+
+  switch (same_type(column.attr_type()) ? column.attr_type() : AttrType::UNDEFINED) {
+    case AttrType::INTS:
+    case AttrType::DATES: {
+      int_filter_.filter(reinterpret_cast<const int *>(column.data()), rows, select.data());
+    } break;
+    case AttrType::BIGINTS: {
+      bigint_filter_.filter(reinterpret_cast<const int64_t *>(column.data()), rows, select.data());
+    } break;
+    case AttrType::FLOATS: {
+      float_filter_.filter(reinterpret_cast<const float *>(column.data()), rows, select.data());
+    } break;
+    case AttrType::CHARS:
+    case AttrType::TEXTS: {
+      for (int i = 0; i < rows; i++) {
+        if (select[i] != 0) {
+          select[i] = string_filter_.contains(column_string(column, i)) ? 1 : 0;
+        }
+      }
+    } break;
+    default: {
+      for (int i = 0; i < rows; i++) {
+        if (select[i] != 0) {
+          select[i] = contains(column.get_value(i)) ? 1 : 0;
+        }
+      }
+    } break;
+  }
+  return rc;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LikeExpr::LikeExpr(unique_ptr<Expression> child, const string &pattern)
+    : child_(std::move(child)), pattern_string_(pattern), pattern_(pattern)
+{}
+
+RC LikeExpr::get_value(const Tuple &tuple, Value &value) const
+{
+  Value child_value;
+  RC    rc = child_->get_value(tuple, child_value);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get value of child expression. rc=%s", strrc(rc));
+    return rc;
+  }
+  if (!is_string_type(child_value.attr_type())) {
+    LOG_WARN("like only supports string values. type=%s", attr_type_to_string(child_value.attr_type()));
+    return RC::INVALID_ARGUMENT;
+  }
+  value.set_boolean(pattern_.match(string_view(child_value.data(), child_value.length())));
+  return rc;
+}
+
+RC LikeExpr::eval(Chunk &chunk, vector<uint8_t> &select)
+{
+  Column column(chunk.memory_pool());
+  RC     rc = child_->get_column(chunk, column);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get column of child expression. rc=%s", strrc(rc));
+    return rc;
+  }
+  if (!is_string_type(column.attr_type())) {
+    LOG_WARN("like only supports string columns. type=%s", attr_type_to_string(column.attr_type()));
+    return RC::INVALID_ARGUMENT;
+  }
+  filter_nulls(column, select.data(), static_cast<int>(select.size()));
+  pattern_.filter(column, static_cast<int>(select.size()), select.data());
+  return rc;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BetweenExpr::BetweenExpr(unique_ptr<Expression> child, const Value &low, const Value &high)
+    : child_(std::move(child)), low_(low), high_(high)
+{}
+
+RC BetweenExpr::get_value(const Tuple &tuple, Value &value) const
+{
+  Value child_value;
+  RC    rc = child_->get_value(tuple, child_value);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get value of child expression. rc=%s", strrc(rc));
+    return rc;
+  }
+  value.set_boolean(child_value.compare(low_) >= 0 && child_value.compare(high_) <= 0);
+  return rc;
+}
+
+RC BetweenExpr::eval(Chunk &chunk, vector<uint8_t> &select)
+{
+  Column column(chunk.memory_pool());
+  RC     rc = child_->get_column(chunk, column);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get column of child expression. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  const int  rows      = static_cast<int>(select.size());
+  const bool same_type = low_.attr_type() == column.attr_type() && high_.attr_type() == column.attr_type();
+  filter_nulls(column, select.data(), rows);
+  if (column.column_type() == Column::Type::CONSTANT_COLUMN || !same_type) {
+    for (int i = 0; i < rows; i++) {
+      if (select[i] != 0) {
+        Value value = column.get_value(i);
+        select[i]   = value.compare(low_) >= 0 && value.compare(high_) <= 0 ? 1 : 0;
+      }
+    }
+    return rc;
+  }
+
+  switch (column.attr_type()) {
+    case AttrType::INTS:
+    case AttrType::DATES: {
+      between_filter(reinterpret_cast<const int *>(column.data()),
+          rows,
+          *reinterpret_cast<const int *>(low_.data()),
+          *reinterpret_cast<const int *>(high_.data()),
+          select.data());
+    } break;
+    case AttrType::BIGINTS: {
+      between_filter(
+          reinterpret_cast<const int64_t *>(column.data()), rows, low_.get_bigint(), high_.get_bigint(), select.data());
+    } break;
+    case AttrType::FLOATS: {
+      between_filter(
+          reinterpret_cast<const float *>(column.data()), rows, low_.get_float(), high_.get_float(), select.data());
+    } break;
+    case AttrType::CHARS:
+    case AttrType::TEXTS: {
+      for (int i = 0; i < rows; i++) {
+        if (select[i] == 0) {
+          continue;
+        }
+        string_view str = column_string(column, i);
+        select[i] = common::compare_string((void *)str.data(), str.size(), low_.data(), low_.length()) >= 0 &&
+                    common::compare_string((void *)str.data(), str.size(), high_.data(), high_.length()) <= 0;
+      }
+    } break;
+    default: {
+      for (int i = 0; i < rows; i++) {
+        if (select[i] != 0) {
+          Value value = column.get_value(i);
+          select[i]   = value.compare(low_) >= 0 && value.compare(high_) <= 0 ? 1 : 0;
+        }
+      }
+    } break;
+  }
+  return rc;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 ArithmeticExpr::ArithmeticExpr(ArithmeticExpr::Type type, Expression *left, Expression *right)
     : arithmetic_type_(type), left_(left), right_(right)
-{}
+{
+  bind_kernels();
+}
 ArithmeticExpr::ArithmeticExpr(ArithmeticExpr::Type type, unique_ptr<Expression> left, unique_ptr<Expression> right)
     : arithmetic_type_(type), left_(std::move(left)), right_(std::move(right))
-{}
+{
+  bind_kernels();
+}
+
+RC ArithmeticExpr::bind_kernels()
+{
+  kernels_.fill(nullptr);
+  // 解析阶段子表达式还没有绑定，类型未知，等绑定之后再选
+  const AttrType right_type = right_ ? right_->value_type() : AttrType::UNDEFINED;
+  ArithmeticKernels kernels;
+  RC                rc = get_arithmetic_kernels(arithmetic_type_, left_->value_type(), right_type, kernels);
+  if (OB_SUCC(rc)) {
+    kernels_           = kernels;
+    kernel_left_type_  = left_->value_type();
+    kernel_right_type_ = right_type;
+  }
+  return rc;
+}
 
 bool ArithmeticExpr::equal(const Expression &other) const
 {
@@ -351,17 +718,9 @@ AttrType ArithmeticExpr::value_type() const
     return left_->value_type();
   }
 
-  if ((left_->value_type() == AttrType::INTS) && (right_->value_type() == AttrType::INTS) &&
-      arithmetic_type_ != Type::DIV) {
-    return AttrType::INTS;
-  }
-
-  if ((left_->value_type() == AttrType::BIGINTS) && (right_->value_type() == AttrType::BIGINTS) &&
-      arithmetic_type_ != Type::DIV) {
-    return AttrType::BIGINTS;
-  }
-
-  return AttrType::FLOATS;
+  // 非数值类型参与运算时按浮点数计算
+  const AttrType attr_type = arithmetic_result_type(arithmetic_type_, left_->value_type(), right_->value_type());
+  return attr_type == AttrType::UNDEFINED ? AttrType::FLOATS : attr_type;
 }
 
 RC ArithmeticExpr::calc_value(const Value &left_value, const Value &right_value, Value &value) const
@@ -373,15 +732,15 @@ RC ArithmeticExpr::calc_value(const Value &left_value, const Value &right_value,
 
   switch (arithmetic_type_) {
     case Type::ADD: {
-      Value::add(left_value, right_value, value);
+      rc = Value::add(left_value, right_value, value);
     } break;
 
     case Type::SUB: {
-      Value::subtract(left_value, right_value, value);
+      rc = Value::subtract(left_value, right_value, value);
     } break;
 
     case Type::MUL: {
-      Value::multiply(left_value, right_value, value);
+      rc = Value::multiply(left_value, right_value, value);
     } break;
 
     case Type::DIV: {
@@ -389,7 +748,7 @@ RC ArithmeticExpr::calc_value(const Value &left_value, const Value &right_value,
     } break;
 
     case Type::NEGATIVE: {
-      Value::negative(left_value, value);
+      rc = Value::negative(left_value, value);
     } break;
 
     default: {
@@ -400,89 +759,6 @@ RC ArithmeticExpr::calc_value(const Value &left_value, const Value &right_value,
   return rc;
 }
 
-template <bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
-RC ArithmeticExpr::execute_calc(
-    const Column &left, const Column &right, Column &result, Type type, AttrType attr_type) const
-{
-  RC rc = RC::SUCCESS;
-  switch (type) {
-    case Type::ADD: {
-      if (attr_type == AttrType::INTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int, AddOperator>(
-            (int *)left.data(), (int *)right.data(), (int *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::FLOATS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, float, AddOperator>(
-            (float *)left.data(), (float *)right.data(), (float *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::BIGINTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int64_t, AddOperator>(
-            (int64_t *)left.data(), (int64_t *)right.data(), (int64_t *)result.data(), result.capacity());
-      } else {
-        rc = RC::UNIMPLEMENTED;
-      }
-    } break;
-    case Type::SUB:
-      if (attr_type == AttrType::INTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int, SubtractOperator>(
-            (int *)left.data(), (int *)right.data(), (int *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::FLOATS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, float, SubtractOperator>(
-            (float *)left.data(), (float *)right.data(), (float *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::BIGINTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int64_t, SubtractOperator>(
-            (int64_t *)left.data(), (int64_t *)right.data(), (int64_t *)result.data(), result.capacity());
-      } else {
-        rc = RC::UNIMPLEMENTED;
-      }
-      break;
-    case Type::MUL:
-      if (attr_type == AttrType::INTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int, MultiplyOperator>(
-            (int *)left.data(), (int *)right.data(), (int *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::FLOATS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, float, MultiplyOperator>(
-            (float *)left.data(), (float *)right.data(), (float *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::BIGINTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int64_t, MultiplyOperator>(
-            (int64_t *)left.data(), (int64_t *)right.data(), (int64_t *)result.data(), result.capacity());
-      } else {
-        rc = RC::UNIMPLEMENTED;
-      }
-      break;
-    case Type::DIV:
-      if (attr_type == AttrType::INTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int, DivideOperator>(
-            (int *)left.data(), (int *)right.data(), (int *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::FLOATS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, float, DivideOperator>(
-            (float *)left.data(), (float *)right.data(), (float *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::BIGINTS) {
-        binary_operator<LEFT_CONSTANT, RIGHT_CONSTANT, int64_t, DivideOperator>(
-            (int64_t *)left.data(), (int64_t *)right.data(), (int64_t *)result.data(), result.capacity());
-      } else {
-        rc = RC::UNIMPLEMENTED;
-      }
-      break;
-    case Type::NEGATIVE:
-      if (attr_type == AttrType::INTS) {
-        unary_operator<LEFT_CONSTANT, int, NegateOperator>((int *)left.data(), (int *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::FLOATS) {
-        unary_operator<LEFT_CONSTANT, float, NegateOperator>(
-            (float *)left.data(), (float *)result.data(), result.capacity());
-      } else if (attr_type == AttrType::BIGINTS) {
-        unary_operator<LEFT_CONSTANT, int64_t, NegateOperator>(
-            (int64_t *)left.data(), (int64_t *)result.data(), result.capacity());
-      } else {
-        rc = RC::UNIMPLEMENTED;
-      }
-      break;
-    default: rc = RC::UNIMPLEMENTED; break;
-  }
-  if (rc == RC::SUCCESS) {
-    result.set_count(result.capacity());
-  }
-  return rc;
-}
-
 RC ArithmeticExpr::get_value(const Tuple &tuple, Value &value) const
 {
   RC rc = RC::SUCCESS;
@@ -510,42 +786,61 @@ RC ArithmeticExpr::get_column(Chunk &chunk, Column &column)
     column.reference(chunk.column(pos_));
     return rc;
   }
-  Column left_column;
-  Column right_column;
+  Column left_column(chunk.memory_pool());
+  Column right_column(chunk.memory_pool());
 
   rc = left_->get_column(chunk, left_column);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to get column of left expression. rc=%s", strrc(rc));
     return rc;
   }
+  if (!right_) {
+    return calc_column(chunk, left_column, left_column, column);
+  }
   rc = right_->get_column(chunk, right_column);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to get column of right expression. rc=%s", strrc(rc));
     return rc;
   }
-  return calc_column(left_column, right_column, column);
+  return calc_column(chunk, left_column, right_column, column);
 }
 
-RC ArithmeticExpr::calc_column(const Column &left_column, const Column &right_column, Column &column) const
+RC ArithmeticExpr::calc_column(
+    const Chunk &chunk, const Column &left_column, const Column &right_column, Column &column) const
 {
-  RC rc = RC::SUCCESS;
-
-  const AttrType target_type = value_type();
-  column.init(target_type, left_column.attr_len(), max(left_column.count(), right_column.count()));
-  bool left_const  = left_column.column_type() == Column::Type::CONSTANT_COLUMN;
-  bool right_const = right_column.column_type() == Column::Type::CONSTANT_COLUMN;
-  if (left_const && right_const) {
-    column.set_column_type(Column::Type::CONSTANT_COLUMN);
-    rc = execute_calc<true, true>(left_column, right_column, column, arithmetic_type_, target_type);
-  } else if (left_const && !right_const) {
-    column.set_column_type(Column::Type::NORMAL_COLUMN);
-    rc = execute_calc<true, false>(left_column, right_column, column, arithmetic_type_, target_type);
-  } else if (!left_const && right_const) {
-    column.set_column_type(Column::Type::NORMAL_COLUMN);
-    rc = execute_calc<false, true>(left_column, right_column, column, arithmetic_type_, target_type);
-  } else {
-    column.set_column_type(Column::Type::NORMAL_COLUMN);
-    rc = execute_calc<false, false>(left_column, right_column, column, arithmetic_type_, target_type);
+  const ArithmeticKernels *kernels     = &kernels_;
+  AttrType                 target_type = value_type();
+  ArithmeticKernels        column_kernels;
+  if (left_column.attr_type() != kernel_left_type_ || (right_ && right_column.attr_type() != kernel_right_type_)) {
+    // 列的类型与绑定时子表达式的类型不一致，只能按列的类型重新查找
+    RC rc = get_arithmetic_kernels(arithmetic_type_, left_column.attr_type(), right_column.attr_type(), column_kernels);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("unsupported arithmetic. type=%d, left=%s, right=%s",
+          static_cast<int>(arithmetic_type_), attr_type_to_string(left_column.attr_type()),
+          attr_type_to_string(right_column.attr_type()));
+      return rc;
+    }
+    kernels     = &column_kernels;
+    target_type = arithmetic_result_type(arithmetic_type_, left_column.attr_type(), right_column.attr_type());
+  }
+
+  const bool   left_const  = left_column.column_type() == Column::Type::CONSTANT_COLUMN;
+  const bool   right_const = right_column.column_type() == Column::Type::CONSTANT_COLUMN;
+  const Kernel kernel      = (*kernels)[left_const * 2 + right_const];
+  const int    rows        = max(left_column.count(), right_column.count());
+  // 两侧都是常量时只需要计算一行
+  const int calc_rows = left_const && right_const ? 1 : rows;
+  column.init(target_type, get_default_length(target_type), calc_rows);
+  const int *selection = chunk.has_selection() && calc_rows == chunk.rows() ? chunk.selection().data() : nullptr;
+  RC         rc        = kernel(left_column, right_column, column, calc_rows, selection, chunk.selected_rows());
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  column.set_count(rows);
+  column.set_column_type(left_const && right_const ? Column::Type::CONSTANT_COLUMN : Column::Type::NORMAL_COLUMN);
+  if (left_column.has_nulls() || right_column.has_nulls()) {
+    // 任意一侧为 NULL 时结果为 NULL，数据部分的计算结果不再有意义
+    column.merge_nulls(left_column, right_column);
   }
   return rc;
 }
@@ -621,6 +916,22 @@ unique_ptr<Aggregator> AggregateExpr::create_aggregator() const
       aggregator = make_unique<SumAggregator>();
       break;
     }
+    case Type::COUNT: {
+      aggregator = make_unique<CountAggregator>();
+      break;
+    }
+    case Type::MAX: {
+      aggregator = make_unique<MaxMinAggregator>(true);
+      break;
+    }
+    case Type::MIN: {
+      aggregator = make_unique<MaxMinAggregator>(false);
+      break;
+    }
+    case Type::AVG: {
+      aggregator = make_unique<AvgAggregator>();
+      break;
+    }
     default: {
       ASSERT(false, "unsupported aggregate type");
       break;
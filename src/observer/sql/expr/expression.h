@@ -14,15 +14,19 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/array.h"
 #include "common/lang/string.h"
 #include "common/lang/memory.h"
 #include "common/lang/unordered_set.h"
 #include "common/value.h"
 #include "storage/field/field.h"
 #include "sql/expr/aggregator.h"
+#include "sql/expr/predicate_operator.hpp"
+#include "sql/parser/parse_defs.h"
 #include "storage/common/chunk.h"
 
 class Tuple;
+class SelectStmt;
 
 /**
  * @defgroup Expression
@@ -47,6 +51,11 @@ enum class ExprType
   CONJUNCTION,  ///< 多个表达式使用同一种关系(AND或OR)来联结
   ARITHMETIC,   ///< 算术运算
   AGGREGATION,  ///< 聚合运算
+  NOT,          ///< 逻辑非
+  IN,           ///< IN 列表
+  LIKE,         ///< 字符串模式匹配
+  BETWEEN,      ///< 区间比较
+  SUB_QUERY,    ///< 子查询
 };
 
 /**
@@ -251,6 +260,7 @@ public:
 
   void         get_value(Value &value) const { value = value_; }
   const Value &get_value() const { return value_; }
+  Value       &get_value() { return value_; }
 
 private:
   Value value_;
@@ -331,6 +341,10 @@ public:
   template <typename T>
   RC compare_column(const Column &left, const Column &right, vector<uint8_t> &result) const;
 
+private:
+  /// 根据比较运算符判断 compare 的结果是否满足条件
+  bool match_compare_result(int cmp_result) const;
+
 private:
   CompOp                 comp_;
   unique_ptr<Expression> left_;
@@ -373,11 +387,165 @@ public:
 
   vector<unique_ptr<Expression>> &children() { return children_; }
 
+  /**
+   * @brief 向量化计算 AND/OR
+   * @details AND 依次作用在 select 上，所有行都被过滤掉之后不再计算后面的子表达式。
+   * OR 只对还没有确定为真的行计算后面的子表达式，所有行都确定之后提前结束。
+   */
+  RC eval(Chunk &chunk, vector<uint8_t> &select) override;
+
 private:
   Type                           conjunction_type_;
   vector<unique_ptr<Expression>> children_;
 };
 
+/**
+ * @brief 逻辑非表达式
+ * @ingroup Expression
+ */
+class NotExpr : public Expression
+{
+public:
+  NotExpr(unique_ptr<Expression> child);
+  virtual ~NotExpr() = default;
+
+  unique_ptr<Expression> copy() const override { return make_unique<NotExpr>(child_->copy()); }
+
+  ExprType type() const override { return ExprType::NOT; }
+  AttrType value_type() const override { return AttrType::BOOLEANS; }
+  RC       get_value(const Tuple &tuple, Value &value) const override;
+  RC       eval(Chunk &chunk, vector<uint8_t> &select) override;
+
+  unique_ptr<Expression> &child() { return child_; }
+
+private:
+  unique_ptr<Expression> child_;
+};
+
+/**
+ * @brief IN 列表表达式，比如 a IN (1, 2, 3)
+ * @ingroup Expression
+ * @details 列表中的值需要与子表达式的类型相同，否则退化为逐行使用 Value 比较
+ */
+class InExpr : public Expression
+{
+public:
+  InExpr(unique_ptr<Expression> child, vector<Value> values);
+  virtual ~InExpr() = default;
+
+  unique_ptr<Expression> copy() const override { return make_unique<InExpr>(child_->copy(), values_); }
+
+  ExprType type() const override { return ExprType::IN; }
+  AttrType value_type() const override { return AttrType::BOOLEANS; }
+  RC       get_value(const Tuple &tuple, Value &value) const override;
+  RC       eval(Chunk &chunk, vector<uint8_t> &select) override;
+
+  unique_ptr<Expression> &child() { return child_; }
+  const vector<Value>    &values() const { return values_; }
+
+private:
+  bool contains(const Value &value) const;
+  bool same_type(AttrType attr_type) const;
+
+private:
+  unique_ptr<Expression> child_;
+  vector<Value>          values_;
+
+  InListFilter<int>         int_filter_;
+  InListFilter<int64_t>     bigint_filter_;
+  InListFilter<float>       float_filter_;
+  vector<string>            strings_;
+  InListFilter<string_view> string_filter_;  ///< 引用 strings_ 中的字符串
+};
+
+/**
+ * @brief LIKE 表达式，比如 a LIKE 'abc%'
+ * @ingroup Expression
+ */
+class LikeExpr : public Expression
+{
+public:
+  LikeExpr(unique_ptr<Expression> child, const string &pattern);
+  virtual ~LikeExpr() = default;
+
+  unique_ptr<Expression> copy() const override { return make_unique<LikeExpr>(child_->copy(), pattern_string_); }
+
+  ExprType type() const override { return ExprType::LIKE; }
+  AttrType value_type() const override { return AttrType::BOOLEANS; }
+  RC       get_value(const Tuple &tuple, Value &value) const override;
+  RC       eval(Chunk &chunk, vector<uint8_t> &select) override;
+
+  unique_ptr<Expression> &child() { return child_; }
+  const string           &pattern() const { return pattern_string_; }
+
+private:
+  unique_ptr<Expression> child_;
+  string                 pattern_string_;
+  LikePattern            pattern_;
+};
+
+/**
+ * @brief BETWEEN 表达式，比如 a BETWEEN 1 AND 10，包含两端
+ * @ingroup Expression
+ */
+class BetweenExpr : public Expression
+{
+public:
+  BetweenExpr(unique_ptr<Expression> child, const Value &low, const Value &high);
+  virtual ~BetweenExpr() = default;
+
+  unique_ptr<Expression> copy() const override { return make_unique<BetweenExpr>(child_->copy(), low_, high_); }
+
+  ExprType type() const override { return ExprType::BETWEEN; }
+  AttrType value_type() const override { return AttrType::BOOLEANS; }
+  RC       get_value(const Tuple &tuple, Value &value) const override;
+  RC       eval(Chunk &chunk, vector<uint8_t> &select) override;
+
+  unique_ptr<Expression> &child() { return child_; }
+
+private:
+  unique_ptr<Expression> child_;
+  Value                  low_;
+  Value                  high_;
+};
+
+/**
+ * @brief where 条件中的子查询，比如 a IN (select ...)、EXISTS (select ...)
+ * @ingroup Expression
+ * @details 子查询不会逐行执行，SubqueryUnnestRewriter 会把它展开成半连接或反连接，
+ * 所以这个表达式不能直接求值
+ */
+class SubQueryExpr : public Expression
+{
+public:
+  /**
+   * @param left 与子查询结果比较的表达式，EXISTS 子查询没有这个表达式
+   * @param select_stmt 子查询语句，由 FilterStmt 释放
+   */
+  SubQueryExpr(SubQueryType sub_query_type, CompOp comp, unique_ptr<Expression> left, SelectStmt *select_stmt);
+  virtual ~SubQueryExpr() = default;
+
+  unique_ptr<Expression> copy() const override
+  {
+    return make_unique<SubQueryExpr>(sub_query_type_, comp_, left_ ? left_->copy() : nullptr, select_stmt_);
+  }
+
+  ExprType type() const override { return ExprType::SUB_QUERY; }
+  AttrType value_type() const override { return AttrType::BOOLEANS; }
+  RC       get_value(const Tuple &tuple, Value &value) const override;
+
+  SubQueryType            sub_query_type() const { return sub_query_type_; }
+  CompOp                  comp() const { return comp_; }
+  unique_ptr<Expression> &left() { return left_; }
+  SelectStmt             *select_stmt() const { return select_stmt_; }
+
+private:
+  SubQueryType           sub_query_type_;
+  CompOp                 comp_;
+  unique_ptr<Expression> left_;
+  SelectStmt            *select_stmt_ = nullptr;
+};
+
 /**
  * @brief 算术表达式
  * @ingroup Expression
@@ -394,6 +562,14 @@ public:
     NEGATIVE,
   };
 
+  /**
+   * @brief 向量化计算函数，计算 rows 行写入 result。常量列只读取第 0 个值
+   * @details 整数运算溢出时返回 RC::RANGE_ERROR，与逐行计算时 Value 的运算一致。只有 selection 中的 selected 行
+   * 溢出才算，selection 为 nullptr 时前 rows 行都要检查。见 arithmetic_kernel.h
+   */
+  using Kernel = RC (*)(
+      const Column &left, const Column &right, Column &result, int rows, const int *selection, int selected);
+
 public:
   ArithmeticExpr(Type type, Expression *left, Expression *right);
   ArithmeticExpr(Type type, unique_ptr<Expression> left, unique_ptr<Expression> right);
@@ -425,18 +601,27 @@ public:
   unique_ptr<Expression> &left() { return left_; }
   unique_ptr<Expression> &right() { return right_; }
 
+  /**
+   * @brief 按子表达式的类型选定向量化计算函数，之后每个 chunk 不再按类型分派
+   * @details 构造时会调用一次。子表达式在绑定时被替换后需要重新调用。不支持的类型组合返回 RC::UNIMPLEMENTED
+   */
+  RC bind_kernels();
+
 private:
   RC calc_value(const Value &left_value, const Value &right_value, Value &value) const;
 
-  RC calc_column(const Column &left_column, const Column &right_column, Column &column) const;
-
-  template <bool LEFT_CONSTANT, bool RIGHT_CONSTANT>
-  RC execute_calc(const Column &left, const Column &right, Column &result, Type type, AttrType attr_type) const;
+  /// chunk 只用来提供选择向量，被过滤掉的行不检查溢出
+  RC calc_column(const Chunk &chunk, const Column &left_column, const Column &right_column, Column &column) const;
 
 private:
   Type                   arithmetic_type_;
   unique_ptr<Expression> left_;
   unique_ptr<Expression> right_;
+  /// 下标为 left_const * 2 + right_const
+  array<Kernel, 4> kernels_{};
+  /// 选定 kernels_ 时左右子表达式的类型
+  AttrType kernel_left_type_  = AttrType::UNDEFINED;
+  AttrType kernel_right_type_ = AttrType::UNDEFINED;
 };
 
 class UnboundAggregateExpr : public Expression
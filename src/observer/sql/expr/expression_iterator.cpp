@@ -63,6 +63,29 @@ RC ExpressionIterator::iterate_child_expr(Expression &expr, function<RC(unique_p
       rc = callback(aggregate_expr.child());
     } break;
 
+    case ExprType::NOT: {
+      rc = callback(static_cast<NotExpr &>(expr).child());
+    } break;
+
+    case ExprType::IN: {
+      rc = callback(static_cast<InExpr &>(expr).child());
+    } break;
+
+    case ExprType::LIKE: {
+      rc = callback(static_cast<LikeExpr &>(expr).child());
+    } break;
+
+    case ExprType::BETWEEN: {
+      rc = callback(static_cast<BetweenExpr &>(expr).child());
+    } break;
+
+    case ExprType::SUB_QUERY: {
+      auto &sub_query_expr = static_cast<SubQueryExpr &>(expr);
+      if (sub_query_expr.left()) {
+        rc = callback(sub_query_expr.left());
+      }
+    } break;
+
     case ExprType::NONE:
     case ExprType::STAR:
     case ExprType::UNBOUND_FIELD:
@@ -0,0 +1,591 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/expr/expression_program.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/sstream.h"
+#include "common/lang/type_traits.h"
+#include "common/log/log.h"
+#include "sql/expr/arithmetic_kernel.h"
+#include "sql/expr/arithmetic_operator.hpp"
+
+namespace {
+
+/// 寄存器中使用的类型，DATES 按 INTS 计算
+AttrType register_type(AttrType attr_type)
+{
+  switch (attr_type) {
+    case AttrType::INTS:
+    case AttrType::DATES: return AttrType::INTS;
+    case AttrType::BIGINTS:
+    case AttrType::FLOATS: return attr_type;
+    default: return AttrType::UNDEFINED;
+  }
+}
+
+template <typename FROM, typename TO>
+void cast_tile(const char *input, char *output, int rows)
+{
+  const FROM *from = reinterpret_cast<const FROM *>(input);
+  TO         *to   = reinterpret_cast<TO *>(output);
+  for (int i = 0; i < rows; i++) {
+    to[i] = static_cast<TO>(from[i]);
+  }
+}
+
+template <typename FROM>
+void cast_tile(AttrType to_type, const char *input, char *output, int rows)
+{
+  switch (to_type) {
+    case AttrType::INTS: cast_tile<FROM, int>(input, output, rows); break;
+    case AttrType::BIGINTS: cast_tile<FROM, int64_t>(input, output, rows); break;
+    default: cast_tile<FROM, float>(input, output, rows); break;
+  }
+}
+
+template <typename T, class OP>
+bool binary_tile(const char *left, const char *right, char *result, int rows)
+{
+  T *left_data   = reinterpret_cast<T *>(const_cast<char *>(left));
+  T *right_data  = reinterpret_cast<T *>(const_cast<char *>(right));
+  T *result_data = reinterpret_cast<T *>(result);
+  if constexpr (is_same_v<T, float>) {
+    binary_operator<false, false, float, OP>(left_data, right_data, result_data, rows);
+    return false;
+  } else {
+    return checked_binary_operator<false, false, T, OP>(left_data, right_data, result_data, rows);
+  }
+}
+
+template <typename T>
+bool negate_tile(const char *input, char *result, int rows)
+{
+  T *input_data  = reinterpret_cast<T *>(const_cast<char *>(input));
+  T *result_data = reinterpret_cast<T *>(result);
+  if constexpr (is_same_v<T, float>) {
+    unary_operator<false, float, NegateOperator>(input_data, result_data, rows);
+    return false;
+  } else {
+    bool overflow = false;
+    for (int i = 0; i < rows; i++) {
+      overflow |= NegateOperator::checked_operation(input_data[i], result_data[i]);
+    }
+    return overflow;
+  }
+}
+
+/// 返回是否溢出
+template <typename T>
+bool arithmetic_tile(ArithmeticExpr::Type type, const char *left, const char *right, char *result, int rows)
+{
+  switch (type) {
+    case ArithmeticExpr::Type::ADD: return binary_tile<T, AddOperator>(left, right, result, rows);
+    case ArithmeticExpr::Type::SUB: return binary_tile<T, SubtractOperator>(left, right, result, rows);
+    case ArithmeticExpr::Type::MUL: return binary_tile<T, MultiplyOperator>(left, right, result, rows);
+    case ArithmeticExpr::Type::DIV: {
+      // 除法的参数在编译时都转换成了 FLOATS
+      if constexpr (is_same_v<T, float>) {
+        return binary_tile<T, DivideOperator>(left, right, result, rows);
+      }
+      return false;
+    }
+    case ArithmeticExpr::Type::NEGATIVE: return negate_tile<T>(left, result, rows);
+  }
+  return false;
+}
+
+/**
+ * @brief 溢出时只检查仍然有效的行
+ * @details live[i] 为 0 的行已经被选择向量或者前面的谓词过滤掉了，它们的数据不能让查询失败
+ */
+template <typename T>
+bool overflow_on_live_rows(
+    ArithmeticExpr::Type type, const char *left, const char *right, const uint8_t *live, int rows)
+{
+  const T *left_data  = reinterpret_cast<const T *>(left);
+  const T *right_data = reinterpret_cast<const T *>(right);
+  T        result;
+  for (int i = 0; i < rows; i++) {
+    if (live[i] == 0) {
+      continue;
+    }
+    bool overflow = false;
+    switch (type) {
+      case ArithmeticExpr::Type::ADD:
+        overflow = AddOperator::checked_operation(left_data[i], right_data[i], result);
+        break;
+      case ArithmeticExpr::Type::SUB:
+        overflow = SubtractOperator::checked_operation(left_data[i], right_data[i], result);
+        break;
+      case ArithmeticExpr::Type::MUL:
+        overflow = MultiplyOperator::checked_operation(left_data[i], right_data[i], result);
+        break;
+      case ArithmeticExpr::Type::NEGATIVE: overflow = NegateOperator::checked_operation(left_data[i], result); break;
+      default: break;
+    }
+    if (overflow) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const char *arithmetic_name(ArithmeticExpr::Type type)
+{
+  switch (type) {
+    case ArithmeticExpr::Type::ADD: return "add";
+    case ArithmeticExpr::Type::SUB: return "sub";
+    case ArithmeticExpr::Type::MUL: return "mul";
+    case ArithmeticExpr::Type::DIV: return "div";
+    case ArithmeticExpr::Type::NEGATIVE: return "neg";
+  }
+  return "unknown";
+}
+}  // namespace
+
+void ExpressionProgram::reset()
+{
+  compiled_ = false;
+  sources_.clear();
+  instructions_.clear();
+  registers_.clear();
+  result_ = -1;
+}
+
+RC ExpressionProgram::compile_filter(const vector<unique_ptr<Expression>> &predicates)
+{
+  reset();
+  for (const unique_ptr<Expression> &predicate : predicates) {
+    sources_.push_back(predicate.get());
+  }
+
+  RC rc = RC::SUCCESS;
+  for (const unique_ptr<Expression> &predicate : predicates) {
+    if (OB_FAIL(rc = compile_predicate(*predicate))) {
+      LOG_TRACE("failed to compile predicate, fallback to expression evaluation. rc=%s", strrc(rc));
+      instructions_.clear();
+      registers_.clear();
+      return rc;
+    }
+  }
+  compiled_ = !instructions_.empty();
+  tile_select_.resize(TILE_ROWS);
+  return rc;
+}
+
+RC ExpressionProgram::compile_value(Expression *expr)
+{
+  reset();
+  sources_.push_back(expr);
+
+  int reg = -1;
+  RC  rc  = compile_node(*expr, reg);
+  // 结果直接是 chunk 中的一列或者常量时，逐个节点计算也不会生成临时列，没有必要编译
+  if (OB_SUCC(rc) &&
+      (instructions_.empty() || instructions_.back().code == OpCode::LOAD_COLUMN || instructions_.back().dest != reg)) {
+    rc = RC::UNSUPPORTED;
+  }
+  if (OB_FAIL(rc)) {
+    LOG_TRACE("failed to compile expression, fallback to expression evaluation. rc=%s", strrc(rc));
+    instructions_.clear();
+    registers_.clear();
+    return rc;
+  }
+  result_   = reg;
+  compiled_ = true;
+  return rc;
+}
+
+RC ExpressionProgram::compile_predicate(Expression &expr)
+{
+  switch (expr.type()) {
+    case ExprType::CONJUNCTION: {
+      auto &conjunction = static_cast<ConjunctionExpr &>(expr);
+      if (conjunction.conjunction_type() != ConjunctionExpr::Type::AND) {
+        return RC::UNSUPPORTED;
+      }
+      for (unique_ptr<Expression> &child : conjunction.children()) {
+        RC rc = compile_predicate(*child);
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+      }
+      return RC::SUCCESS;
+    }
+    case ExprType::COMPARISON: {
+      auto &comparison = static_cast<ComparisonExpr &>(expr);
+      if (comparison.comp() == CompOp::NO_OP) {
+        return RC::UNSUPPORTED;
+      }
+      int left  = -1;
+      int right = -1;
+      RC  rc    = compile_node(*comparison.left(), left);
+      if (OB_SUCC(rc)) {
+        rc = compile_node(*comparison.right(), right);
+      }
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+
+      // 比较前把两边转换成同一种类型
+      const AttrType left_type  = registers_[left].type;
+      const AttrType right_type = registers_[right].type;
+      AttrType       type       = AttrType::INTS;
+      if (left_type == AttrType::FLOATS || right_type == AttrType::FLOATS) {
+        type = AttrType::FLOATS;
+      } else if (left_type == AttrType::BIGINTS || right_type == AttrType::BIGINTS) {
+        type = AttrType::BIGINTS;
+      }
+
+      Instruction instruction{OpCode::COMPARE};
+      instruction.type  = type;
+      instruction.left  = cast(left, type);
+      instruction.right = cast(right, type);
+      instruction.comp  = comparison.comp();
+      instructions_.push_back(instruction);
+      return RC::SUCCESS;
+    }
+    default: return RC::UNSUPPORTED;
+  }
+}
+
+RC ExpressionProgram::compile_node(Expression &expr, int &reg)
+{
+  // 下层算子已经算好的表达式直接读取对应的列
+  if (expr.pos() != -1) {
+    return load_column(expr.pos(), expr.value_type(), reg);
+  }
+
+  switch (expr.type()) {
+    case ExprType::FIELD: {
+      auto &field_expr = static_cast<FieldExpr &>(expr);
+      return load_column(field_expr.field().meta()->field_id(), field_expr.value_type(), reg);
+    }
+    case ExprType::VALUE: {
+      return load_constant(static_cast<ValueExpr &>(expr).get_value(), reg);
+    }
+    case ExprType::CAST: {
+      auto          &cast_expr = static_cast<CastExpr &>(expr);
+      const AttrType type      = register_type(cast_expr.value_type());
+      if (type == AttrType::UNDEFINED) {
+        return RC::UNSUPPORTED;
+      }
+      RC rc = compile_node(*cast_expr.child(), reg);
+      if (OB_SUCC(rc)) {
+        reg = cast(reg, type);
+      }
+      return rc;
+    }
+    case ExprType::ARITHMETIC: {
+      auto              &arithmetic = static_cast<ArithmeticExpr &>(expr);
+      const bool         negative   = arithmetic.arithmetic_type() == ArithmeticExpr::Type::NEGATIVE;
+      int                left       = -1;
+      int                right      = -1;
+      RC                 rc         = compile_node(*arithmetic.left(), left);
+      if (OB_SUCC(rc) && !negative) {
+        if (!arithmetic.right()) {
+          return RC::UNSUPPORTED;
+        }
+        rc = compile_node(*arithmetic.right(), right);
+      }
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+
+      const AttrType result_type = arithmetic_result_type(arithmetic.arithmetic_type(),
+          registers_[left].type,
+          negative ? AttrType::UNDEFINED : registers_[right].type);
+      if (result_type == AttrType::UNDEFINED) {
+        return RC::UNSUPPORTED;
+      }
+
+      Instruction instruction{OpCode::ARITHMETIC};
+      instruction.type            = result_type;
+      instruction.arithmetic_type = arithmetic.arithmetic_type();
+      instruction.left            = cast(left, result_type);
+      instruction.right           = negative ? instruction.left : cast(right, result_type);
+      instruction.dest            = new_register(result_type);
+      instructions_.push_back(instruction);
+      reg = instruction.dest;
+      return RC::SUCCESS;
+    }
+    default: return RC::UNSUPPORTED;
+  }
+}
+
+RC ExpressionProgram::load_column(int column, AttrType attr_type, int &reg)
+{
+  const AttrType type = register_type(attr_type);
+  if (type == AttrType::UNDEFINED || column < 0) {
+    return RC::UNSUPPORTED;
+  }
+  // 同一列只读取一次
+  for (const Instruction &instruction : instructions_) {
+    if (instruction.code == OpCode::LOAD_COLUMN && instruction.column == column) {
+      reg = instruction.dest;
+      return RC::SUCCESS;
+    }
+  }
+
+  registers_.emplace_back();
+  registers_.back().type = type;
+  reg                    = static_cast<int>(registers_.size()) - 1;
+
+  Instruction instruction{OpCode::LOAD_COLUMN};
+  instruction.type   = type;
+  instruction.column = column;
+  instruction.dest   = reg;
+  instructions_.push_back(instruction);
+  return RC::SUCCESS;
+}
+
+RC ExpressionProgram::load_constant(const Value &value, int &reg)
+{
+  const AttrType type = register_type(value.attr_type());
+  if (type == AttrType::UNDEFINED) {
+    return RC::UNSUPPORTED;
+  }
+  // 常量在编译时展开成整块，执行时与普通寄存器一样按行读取
+  reg = new_register(type);
+  switch (type) {
+    case AttrType::INTS: {
+      int *data = reinterpret_cast<int *>(registers_[reg].data);
+      std::fill(data, data + TILE_ROWS, value.get_int());
+    } break;
+    case AttrType::BIGINTS: {
+      int64_t *data = reinterpret_cast<int64_t *>(registers_[reg].data);
+      std::fill(data, data + TILE_ROWS, value.get_bigint());
+    } break;
+    default: {
+      float *data = reinterpret_cast<float *>(registers_[reg].data);
+      std::fill(data, data + TILE_ROWS, value.get_float());
+    } break;
+  }
+  return RC::SUCCESS;
+}
+
+int ExpressionProgram::cast(int reg, AttrType type)
+{
+  if (registers_[reg].type == type) {
+    return reg;
+  }
+  Instruction instruction{OpCode::CAST};
+  instruction.type = type;
+  instruction.left = reg;
+  instruction.dest = new_register(type);
+  instructions_.push_back(instruction);
+  return instruction.dest;
+}
+
+int ExpressionProgram::new_register(AttrType type)
+{
+  registers_.emplace_back();
+  Register &reg = registers_.back();
+  reg.type      = type;
+  reg.buffer.resize(static_cast<size_t>(TILE_ROWS) * get_default_length(type));
+  reg.data = reg.buffer.data();
+  return static_cast<int>(registers_.size()) - 1;
+}
+
+bool ExpressionProgram::runnable(const Chunk &chunk) const
+{
+  if (!compiled_) {
+    return false;
+  }
+  for (const Instruction &instruction : instructions_) {
+    if (instruction.code != OpCode::LOAD_COLUMN) {
+      continue;
+    }
+    if (instruction.column >= chunk.column_num()) {
+      return false;
+    }
+    const Column &column = chunk.column(instruction.column);
+    if (column.column_type() != Column::Type::NORMAL_COLUMN || column.has_nulls() ||
+        register_type(column.attr_type()) != instruction.type) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC ExpressionProgram::filter(Chunk &chunk, vector<uint8_t> &select)
+{
+  if (!runnable(chunk)) {
+    for (Expression *expr : sources_) {
+      RC rc = expr->eval(chunk, select);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    return RC::SUCCESS;
+  }
+
+  const int rows = chunk.rows();
+  for (int start = 0; start < rows; start += TILE_ROWS) {
+    RC rc = run_tile(chunk, start, min(TILE_ROWS, rows - start), select.data() + start);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC ExpressionProgram::get_column(Chunk &chunk, Column &column)
+{
+  if (!runnable(chunk)) {
+    return sources_.front()->get_column(chunk, column);
+  }
+
+  const AttrType type = registers_[result_].type;
+  const int      rows = chunk.rows();
+  column.init(type, get_default_length(type), max(rows, 1));
+  char *const buffer = registers_[result_].data;
+  for (int start = 0; start < rows; start += TILE_ROWS) {
+    // 最后一条指令直接把结果写到输出列中
+    registers_[result_].data = column.data() + static_cast<size_t>(start) * column.attr_len();
+    RC rc                    = run_tile(chunk, start, min(TILE_ROWS, rows - start), nullptr);
+    if (OB_FAIL(rc)) {
+      registers_[result_].data = buffer;
+      return rc;
+    }
+  }
+  registers_[result_].data = buffer;
+  column.set_count(rows);
+  return RC::SUCCESS;
+}
+
+RC ExpressionProgram::run_tile(Chunk &chunk, int start, int rows, uint8_t *select)
+{
+  if (select != nullptr) {
+    if (select_none(select, rows)) {
+      return RC::SUCCESS;
+    }
+    tile_select_.assign(select, select + rows);
+  }
+
+  for (size_t i = 0; i < instructions_.size(); i++) {
+    const Instruction &instruction = instructions_[i];
+    switch (instruction.code) {
+      case OpCode::LOAD_COLUMN: {
+        Column &column                 = chunk.column(instruction.column);
+        registers_[instruction.dest].data = column.data() + static_cast<size_t>(start) * column.attr_len();
+      } break;
+
+      case OpCode::CAST: {
+        const Register &input  = registers_[instruction.left];
+        char           *output = registers_[instruction.dest].data;
+        switch (input.type) {
+          case AttrType::INTS: cast_tile<int>(instruction.type, input.data, output, rows); break;
+          case AttrType::BIGINTS: cast_tile<int64_t>(instruction.type, input.data, output, rows); break;
+          default: cast_tile<float>(instruction.type, input.data, output, rows); break;
+        }
+      } break;
+
+      case OpCode::ARITHMETIC: {
+        const char *left     = registers_[instruction.left].data;
+        const char *right    = registers_[instruction.right].data;
+        char       *result   = registers_[instruction.dest].data;
+        bool        overflow = false;
+        switch (instruction.type) {
+          case AttrType::INTS:
+            overflow = arithmetic_tile<int>(instruction.arithmetic_type, left, right, result, rows);
+            break;
+          case AttrType::BIGINTS:
+            overflow = arithmetic_tile<int64_t>(instruction.arithmetic_type, left, right, result, rows);
+            break;
+          default: overflow = arithmetic_tile<float>(instruction.arithmetic_type, left, right, result, rows); break;
+        }
+        const uint8_t *live = overflow ? live_rows(chunk, start, rows, select) : nullptr;
+        if (live != nullptr) {
+          // 浮点数运算不会报告溢出，这里只有整数
+          overflow = instruction.type == AttrType::INTS
+                         ? overflow_on_live_rows<int>(instruction.arithmetic_type, left, right, live, rows)
+                         : overflow_on_live_rows<int64_t>(instruction.arithmetic_type, left, right, live, rows);
+        }
+        if (overflow) {
+          LOG_WARN("integer overflow in arithmetic expression");
+          return RC::RANGE_ERROR;
+        }
+      } break;
+
+      case OpCode::COMPARE: {
+        char *left  = registers_[instruction.left].data;
+        char *right = registers_[instruction.right].data;
+        switch (instruction.type) {
+          case AttrType::INTS:
+            compare_result<int, false, false>((int *)left, (int *)right, rows, tile_select_, instruction.comp);
+            break;
+          case AttrType::BIGINTS:
+            compare_result<int64_t, false, false>(
+                (int64_t *)left, (int64_t *)right, rows, tile_select_, instruction.comp);
+            break;
+          default:
+            compare_result<float, false, false>((float *)left, (float *)right, rows, tile_select_, instruction.comp);
+            break;
+        }
+        // 这一块的行都被过滤掉了，后面的指令不用再算
+        if (i + 1 < instructions_.size() && select_none(tile_select_.data(), rows)) {
+          memset(select, 0, rows);
+          return RC::SUCCESS;
+        }
+      } break;
+    }
+  }
+
+  if (select != nullptr) {
+    memcpy(select, tile_select_.data(), rows);
+  }
+  return RC::SUCCESS;
+}
+
+const uint8_t *ExpressionProgram::live_rows(const Chunk &chunk, int start, int rows, const uint8_t *select)
+{
+  if (select != nullptr) {
+    // 计算谓词时 tile_select_ 同时包含了传入的 select 与前面的比较结果
+    return tile_select_.data();
+  }
+  if (!chunk.has_selection()) {
+    return nullptr;
+  }
+  live_.assign(rows, 0);
+  const vector<int> &selection = chunk.selection();
+  for (auto iter = lower_bound(selection.begin(), selection.end(), start);
+       iter != selection.end() && *iter < start + rows;
+       ++iter) {
+    live_[*iter - start] = 1;
+  }
+  return live_.data();
+}
+
+string ExpressionProgram::to_string() const
+{
+  stringstream ss;
+  for (const Instruction &instruction : instructions_) {
+    switch (instruction.code) {
+      case OpCode::LOAD_COLUMN: {
+        ss << "r" << instruction.dest << " = column " << instruction.column;
+      } break;
+      case OpCode::CAST: {
+        ss << "r" << instruction.dest << " = cast r" << instruction.left << " as "
+           << attr_type_to_string(instruction.type);
+      } break;
+      case OpCode::ARITHMETIC: {
+        ss << "r" << instruction.dest << " = " << arithmetic_name(instruction.arithmetic_type) << " r"
+           << instruction.left << ", r" << instruction.right;
+      } break;
+      case OpCode::COMPARE: {
+        ss << "select &= r" << instruction.left << " " << static_cast<int>(instruction.comp) << " r"
+           << instruction.right;
+      } break;
+    }
+    ss << "\n";
+  }
+  return ss.str();
+}
@@ -0,0 +1,115 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "sql/expr/expression.h"
+
+/**
+ * @brief 把表达式树编译成按块执行的寄存器指令
+ * @ingroup Expression
+ * @details 逐个节点计算表达式时，每个节点都会生成一个完整的临时列并遍历一遍内存，比如 a*b+c>d
+ * 要遍历 4 遍、生成 3 个临时列。编译之后整个指令序列每次只处理 TILE_ROWS 行，中间结果放在块大小的
+ * 寄存器中，一直留在 L1 缓存里；读取的列直接指向 chunk 中的数据，不做拷贝。
+ *
+ * 目前支持数值类型（INTS/DATES/BIGINTS/FLOATS）的字段、常量、算术运算、比较以及 AND。
+ * 编译失败，或者执行时列中有 NULL、列类型与编译时不一致，都会退回到逐个节点计算，结果与原来相同。
+ */
+class ExpressionProgram
+{
+public:
+  /// 每块的行数。INT 寄存器 4KB，几个寄存器加起来能放进 L1
+  static constexpr int TILE_ROWS = 1024;
+
+  ExpressionProgram() = default;
+
+  /**
+   * @brief 编译一组谓词，谓词之间是 AND 的关系
+   * @return 不能编译时返回 RC::UNSUPPORTED，之后的 filter 按原表达式计算
+   */
+  RC compile_filter(const vector<unique_ptr<Expression>> &predicates);
+
+  /**
+   * @brief 编译一个数值表达式
+   * @return 不能编译时返回 RC::UNSUPPORTED，之后的 get_column 按原表达式计算
+   */
+  RC compile_value(Expression *expr);
+
+  /**
+   * @brief 计算谓词，与 Expression::eval 一样把结果与 select 做“与”运算
+   */
+  RC filter(Chunk &chunk, vector<uint8_t> &select);
+
+  /**
+   * @brief 计算表达式的值，与 Expression::get_column 相同
+   */
+  RC get_column(Chunk &chunk, Column &column);
+
+  bool compiled() const { return compiled_; }
+  int  instruction_num() const { return static_cast<int>(instructions_.size()); }
+
+  string to_string() const;
+
+private:
+  enum class OpCode
+  {
+    LOAD_COLUMN,  /// 寄存器指向 chunk 中的列
+    CAST,         /// 数值类型转换
+    ARITHMETIC,   /// 算术运算，结果写入 dest
+    COMPARE,      /// 比较，结果与当前块的 select 做“与”运算
+  };
+
+  struct Instruction
+  {
+    OpCode               code;
+    AttrType             type   = AttrType::UNDEFINED;  /// 结果的类型；比较时为参数的类型
+    int                  dest   = -1;
+    int                  left   = -1;
+    int                  right  = -1;
+    int                  column = -1;  /// LOAD_COLUMN 读取的列在 chunk 中的下标
+    ArithmeticExpr::Type arithmetic_type = ArithmeticExpr::Type::ADD;
+    CompOp               comp            = CompOp::NO_OP;
+  };
+
+  struct Register
+  {
+    AttrType     type = AttrType::UNDEFINED;  /// INTS/BIGINTS/FLOATS
+    vector<char> buffer;                      /// 中间结果或常量，TILE_ROWS 个值
+    char        *data = nullptr;              /// 当前块的数据
+  };
+
+private:
+  void reset();
+
+  RC compile_predicate(Expression &expr);
+  RC compile_node(Expression &expr, int &reg);
+  RC load_column(int column, AttrType attr_type, int &reg);
+  RC load_constant(const Value &value, int &reg);
+  /// 把寄存器转换成 type 类型，类型相同时直接返回原寄存器
+  int cast(int reg, AttrType type);
+  int new_register(AttrType type);
+
+  /// 执行时能否使用编译结果，否则退回逐个节点计算
+  bool runnable(const Chunk &chunk) const;
+  RC   run_tile(Chunk &chunk, int start, int rows, uint8_t *select);
+  /// 当前块中有效的行，所有行都有效时返回 nullptr
+  const uint8_t *live_rows(const Chunk &chunk, int start, int rows, const uint8_t *select);
+
+private:
+  bool                 compiled_ = false;
+  vector<Expression *> sources_;  /// 编译前的表达式，退回逐个节点计算时使用
+  vector<Instruction>  instructions_;
+  vector<Register>     registers_;
+  int                  result_ = -1;  /// 数值表达式结果所在的寄存器
+  vector<uint8_t>      tile_select_;
+  vector<uint8_t>      live_;  /// 按 chunk 的选择向量标记当前块中有效的行，只在溢出时使用
+};
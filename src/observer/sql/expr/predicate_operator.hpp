@@ -0,0 +1,376 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#if defined(USE_SIMD)
+#include "common/math/simd_util.h"
+#endif
+
+#include "common/lang/algorithm.h"
+#include "common/lang/array.h"
+#include "common/lang/string.h"
+#include "common/lang/string_view.h"
+#include "common/lang/unordered_set.h"
+#include "common/lang/vector.h"
+#include "common/type/string_t.h"
+#include "storage/common/column.h"
+
+/**
+ * @file predicate_operator.hpp
+ * @brief 谓词的向量化计算
+ * @details 与 compare_result 一样，所有的函数都把结果与 result 做“与”运算：result 中为 0 的行保持为 0，
+ * 为 1 的行只有满足条件时才保留。所以多个谓词可以依次作用在同一个 select 上。
+ */
+
+/// result[i] &= other[i]
+inline void and_select(uint8_t *result, const uint8_t *other, int n)
+{
+  for (int i = 0; i < n; i++) {
+    result[i] &= other[i];
+  }
+}
+
+/// result[i] |= other[i]
+inline void or_select(uint8_t *result, const uint8_t *other, int n)
+{
+  for (int i = 0; i < n; i++) {
+    result[i] |= other[i];
+  }
+}
+
+/// result[i] &= !other[i]
+inline void and_not_select(uint8_t *result, const uint8_t *other, int n)
+{
+  for (int i = 0; i < n; i++) {
+    result[i] &= other[i] ^ 1;
+  }
+}
+
+/// 没有任何一行被选中
+inline bool select_none(const uint8_t *select, int n)
+{
+  uint8_t any = 0;
+  for (int i = 0; i < n; i++) {
+    any |= select[i];
+  }
+  return any == 0;
+}
+
+/**
+ * @brief 去掉 column 中为 NULL 的行
+ * @details NULL 参与比较的结果是 UNKNOWN，作为过滤条件时与 false 相同。列中没有 NULL 时直接返回
+ */
+inline void filter_nulls(const Column &column, uint8_t *result, int n)
+{
+  if (!column.has_nulls()) {
+    return;
+  }
+  if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+    if (column.is_null(0)) {
+      memset(result, 0, n);
+    }
+    return;
+  }
+  const uint64_t *mask = column.null_mask();
+  for (int i = 0; i < n; i++) {
+    result[i] &= static_cast<uint8_t>(((mask[i >> 6] >> (i & 63)) & 1) ^ 1);
+  }
+}
+
+#if defined(USE_SIMD)
+/**
+ * @brief 把 8 位的掩码展开成 8 个 0/1 字节（小端序，第 k 位对应第 k 个字节）
+ */
+inline uint64_t expand_mask_bits(unsigned mask)
+{
+  static constexpr array<uint64_t, 256> table = [] {
+    array<uint64_t, 256> t{};
+    for (unsigned m = 0; m < 256; m++) {
+      for (unsigned k = 0; k < 8; k++) {
+        t[m] |= static_cast<uint64_t>((m >> k) & 1) << (8 * k);
+      }
+    }
+    return t;
+  }();
+  return table[mask & 0xff];
+}
+
+/// result[i..i+8) &= mask 对应的 8 个字节
+inline void and_select_mask(uint8_t *result, __m256i mask)
+{
+  uint64_t bytes = 0;
+  memcpy(&bytes, result, sizeof(bytes));
+  bytes &= expand_mask_bits(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))));
+  memcpy(result, &bytes, sizeof(bytes));
+}
+#endif
+
+/**
+ * @brief BETWEEN low AND high
+ */
+template <typename T>
+void between_filter(const T *values, int n, T low, T high, uint8_t *result)
+{
+  int i = 0;
+#if defined(USE_SIMD)
+  if constexpr (is_same<T, int>::value) {
+    const __m256i low_value  = _mm256_set1_epi32(low);
+    const __m256i high_value = _mm256_set1_epi32(high);
+    for (; i + SIMD_WIDTH <= n; i += SIMD_WIDTH) {
+      __m256i value   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+      __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(low_value, value), _mm256_cmpgt_epi32(value, high_value));
+      and_select_mask(result + i, _mm256_xor_si256(outside, _mm256_set1_epi32(-1)));
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    result[i] &= static_cast<uint8_t>((values[i] >= low) & (values[i] <= high));
+  }
+}
+
+/**
+ * @brief IN 列表
+ * @details 列表中的元素不超过 SMALL_LIST_SIZE 个时，每一行与所有元素逐个比较，比较之间没有分支，
+ * 可以使用 SIMD 一次比较多行；列表更长时使用哈希表查找。
+ */
+template <typename T>
+class InListFilter
+{
+public:
+  static constexpr int SMALL_LIST_SIZE = 8;
+
+  InListFilter() = default;
+  explicit InListFilter(vector<T> values) { init(std::move(values)); }
+
+  void init(vector<T> values)
+  {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    values_ = std::move(values);
+    set_.clear();
+    if (values_.size() > SMALL_LIST_SIZE) {
+      set_.insert(values_.begin(), values_.end());
+    }
+  }
+
+  bool contains(const T &value) const
+  {
+    if (values_.size() > SMALL_LIST_SIZE) {
+      return set_.count(value) > 0;
+    }
+    bool hit = false;
+    for (const T &item : values_) {
+      hit |= item == value;
+    }
+    return hit;
+  }
+
+  void filter(const T *values, int n, uint8_t *result) const
+  {
+    if (values_.size() > SMALL_LIST_SIZE) {
+      for (int i = 0; i < n; i++) {
+        if (result[i] != 0) {
+          result[i] = set_.count(values[i]) > 0 ? 1 : 0;
+        }
+      }
+      return;
+    }
+
+    int i = 0;
+#if defined(USE_SIMD)
+    if constexpr (is_same<T, int>::value) {
+      for (; i + SIMD_WIDTH <= n; i += SIMD_WIDTH) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+        __m256i hit   = _mm256_setzero_si256();
+        for (const int item : values_) {
+          hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(value, _mm256_set1_epi32(item)));
+        }
+        and_select_mask(result + i, hit);
+      }
+    }
+#endif
+    for (; i < n; i++) {
+      uint8_t hit = 0;
+      for (const T &item : values_) {
+        hit |= static_cast<uint8_t>(item == values[i]);
+      }
+      result[i] &= hit;
+    }
+  }
+
+  size_t size() const { return values_.size(); }
+
+private:
+  vector<T>        values_;  ///< 排序去重后的列表
+  unordered_set<T> set_;     ///< 列表较长时使用
+};
+
+/**
+ * @brief 获取字符串列中第 row 行的值
+ * @details CHARS 列是定长的，实际长度是第一个 '\0' 之前的部分，与 Value::set_string 一致
+ */
+inline string_view column_string(const Column &column, int row)
+{
+  if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+    row = 0;
+  }
+  const char *data = column.data() + static_cast<size_t>(row) * column.attr_len();
+  if (column.attr_type() == AttrType::TEXTS) {
+    const string_t *str = reinterpret_cast<const string_t *>(data);
+    return string_view(str->data(), str->size());
+  }
+  return string_view(data, strnlen(data, column.attr_len()));
+}
+
+/**
+ * @brief LIKE 模式匹配，支持 '%' 与 '_'，区分大小写
+ * @details 常见的 'abc%'、'%abc'、'%abc%' 与不含通配符的模式分别退化为前缀、后缀、子串与相等比较，
+ * 其余的模式使用通用的回溯匹配。
+ */
+class LikePattern
+{
+public:
+  enum class Kind
+  {
+    EXACT,
+    PREFIX,
+    SUFFIX,
+    CONTAINS,
+    GENERIC,
+  };
+
+  explicit LikePattern(const string &pattern) : pattern_(pattern)
+  {
+    const size_t percents = std::count(pattern.begin(), pattern.end(), '%');
+    const bool   has_any  = pattern.find('_') != string::npos;
+    const size_t len      = pattern.size();
+    if (has_any) {
+      kind_ = Kind::GENERIC;
+    } else if (percents == 0) {
+      kind_   = Kind::EXACT;
+      needle_ = pattern;
+    } else if (percents == 1 && pattern.back() == '%') {
+      kind_   = Kind::PREFIX;
+      needle_ = pattern.substr(0, len - 1);
+    } else if (percents == 1 && pattern.front() == '%') {
+      kind_   = Kind::SUFFIX;
+      needle_ = pattern.substr(1);
+    } else if (percents == 2 && len >= 2 && pattern.front() == '%' && pattern.back() == '%') {
+      kind_   = Kind::CONTAINS;
+      needle_ = pattern.substr(1, len - 2);
+    } else {
+      kind_ = Kind::GENERIC;
+    }
+  }
+
+  Kind kind() const { return kind_; }
+
+  bool match(string_view str) const
+  {
+    switch (kind_) {
+      case Kind::EXACT: return str == needle_;
+      case Kind::PREFIX: return str.size() >= needle_.size() && memcmp(str.data(), needle_.data(), needle_.size()) == 0;
+      case Kind::SUFFIX:
+        return str.size() >= needle_.size() &&
+               memcmp(str.data() + str.size() - needle_.size(), needle_.data(), needle_.size()) == 0;
+      case Kind::CONTAINS: return contains(str.data(), str.size(), needle_);
+      default: return generic_match(str, pattern_);
+    }
+  }
+
+  /**
+   * @brief 对字符串列计算 LIKE
+   */
+  void filter(const Column &column, int n, uint8_t *result) const
+  {
+    if (column.column_type() == Column::Type::CONSTANT_COLUMN) {
+      const uint8_t hit = match(column_string(column, 0)) ? 1 : 0;
+      for (int i = 0; i < n; i++) {
+        result[i] &= hit;
+      }
+      return;
+    }
+    for (int i = 0; i < n; i++) {
+      if (result[i] != 0) {
+        result[i] = match(column_string(column, i)) ? 1 : 0;
+      }
+    }
+  }
+
+  /**
+   * @brief 子串查找
+   * @details 使用 SIMD 时，每次比较 32 个位置上的首字符与尾字符，两者都相同的位置再比较中间的部分
+   */
+  static bool contains(const char *str, size_t len, const string &needle)
+  {
+    const size_t k = needle.size();
+    if (k == 0) {
+      return true;
+    }
+    if (k > len) {
+      return false;
+    }
+    size_t i = 0;
+#if defined(USE_SIMD)
+    if (k >= 2) {
+      const __m256i first = _mm256_set1_epi8(needle[0]);
+      const __m256i last  = _mm256_set1_epi8(needle[k - 1]);
+      for (; i + k - 1 + 32 <= len; i += 32) {
+        __m256i  block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i));
+        __m256i  block_last  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str + i + k - 1));
+        __m256i  eq_first    = _mm256_cmpeq_epi8(first, block_first);
+        __m256i  eq_last     = _mm256_cmpeq_epi8(last, block_last);
+        unsigned mask        = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(eq_first, eq_last)));
+        while (mask != 0) {
+          const int pos = __builtin_ctz(mask);
+          if (memcmp(str + i + pos + 1, needle.data() + 1, k - 2) == 0) {
+            return true;
+          }
+          mask &= mask - 1;
+        }
+      }
+    }
+#endif
+    return memmem(str + i, len - i, needle.data(), k) != nullptr;
+  }
+
+  /**
+   * @brief 通用的 LIKE 匹配，遇到不匹配时回溯到上一个 '%'
+   */
+  static bool generic_match(string_view str, string_view pattern)
+  {
+    size_t s = 0, p = 0;
+    size_t star = string_view::npos, star_s = 0;
+    while (s < str.size()) {
+      if (p < pattern.size() && (pattern[p] == '_' || pattern[p] == str[s])) {
+        s++;
+        p++;
+      } else if (p < pattern.size() && pattern[p] == '%') {
+        star   = p++;
+        star_s = s;
+      } else if (star != string_view::npos) {
+        p = star + 1;
+        s = ++star_s;
+      } else {
+        return false;
+      }
+    }
+    while (p < pattern.size() && pattern[p] == '%') {
+      p++;
+    }
+    return p == pattern.size();
+  }
+
+private:
+  Kind   kind_ = Kind::GENERIC;
+  string pattern_;
+  string needle_;  ///< 去掉首尾 '%' 之后的部分，GENERIC 时不使用
+};
@@ -44,6 +44,12 @@ AggregateVecPhysicalOperator::AggregateVecPhysicalOperator(vector<Expression *>
 
 RC AggregateVecPhysicalOperator::open(Trx *trx)
 {
+  count_open();
+  if (children_.empty()) {
+    // 数据已经由流水线推送过来了
+    return RC::SUCCESS;
+  }
+
   ASSERT(children_.size() == 1, "group by operator only support one child, but got %d", children_.size());
 
   PhysicalOperator &child = *children_[0];
@@ -54,22 +60,8 @@ RC AggregateVecPhysicalOperator::open(Trx *trx)
   }
 
   while (OB_SUCC(rc = child.next(chunk_))) {
-    for (size_t aggr_idx = 0; aggr_idx < aggregate_expressions_.size(); aggr_idx++) {
-      Column column;
-      value_expressions_[aggr_idx]->get_column(chunk_, column);
-      ASSERT(aggregate_expressions_[aggr_idx]->type() == ExprType::AGGREGATION, "expect aggregate expression");
-      auto *aggregate_expr = static_cast<AggregateExpr *>(aggregate_expressions_[aggr_idx]);
-      if (aggregate_expr->aggregate_type() == AggregateExpr::Type::COUNT) {
-        CountState<int> *state_ptr = reinterpret_cast<CountState<int> *>(aggr_values_.at(aggr_idx));
-        state_ptr->update(nullptr, chunk_.rows());
-      } else {
-        rc = aggregate_state_update_by_column(
-            aggr_values_.at(aggr_idx), aggregate_expr->aggregate_type(), aggregate_expr->child()->value_type(), column);
-        if (OB_FAIL(rc)) {
-          LOG_INFO("failed to update aggregate state. rc=%s", strrc(rc));
-          return rc;
-        }
-      }
+    if (OB_FAIL(rc = sink(chunk_))) {
+      return rc;
     }
   }
 
@@ -80,6 +72,66 @@ RC AggregateVecPhysicalOperator::open(Trx *trx)
   return rc;
 }
 
+RC AggregateVecPhysicalOperator::sink(Chunk &chunk)
+{
+  RC rc = RC::SUCCESS;
+  for (size_t aggr_idx = 0; aggr_idx < aggregate_expressions_.size(); aggr_idx++) {
+    Column column(chunk.memory_pool());
+    value_expressions_[aggr_idx]->get_column(chunk, column);
+    ASSERT(aggregate_expressions_[aggr_idx]->type() == ExprType::AGGREGATION, "expect aggregate expression");
+    auto *aggregate_expr = static_cast<AggregateExpr *>(aggregate_expressions_[aggr_idx]);
+    if (aggregate_expr->aggregate_type() == AggregateExpr::Type::COUNT &&
+        column.column_type() == Column::Type::CONSTANT_COLUMN) {
+      // COUNT(*) 的参数是常量列，只有一个值，有效的行数就是 chunk 中选中的行数
+      if (!column.is_null(0)) {
+        CountState<int> *state_ptr = reinterpret_cast<CountState<int> *>(aggr_values_.at(aggr_idx));
+        state_ptr->update(nullptr, chunk.selected_rows());
+      }
+    } else if (chunk.has_selection() && column.column_type() == Column::Type::NORMAL_COLUMN) {
+      rc = aggregate_state_update_by_column(aggr_values_.at(aggr_idx),
+          aggregate_expr->aggregate_type(),
+          aggregate_expr->child()->value_type(),
+          column,
+          chunk.selection().data(),
+          chunk.selected_rows());
+      if (OB_FAIL(rc)) {
+        LOG_INFO("failed to update aggregate state. rc=%s", strrc(rc));
+        return rc;
+      }
+    } else {
+      rc = aggregate_state_update_by_column(
+          aggr_values_.at(aggr_idx), aggregate_expr->aggregate_type(), aggregate_expr->child()->value_type(), column);
+      if (OB_FAIL(rc)) {
+        LOG_INFO("failed to update aggregate state. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+  }
+  return rc;
+}
+
+unique_ptr<PipelineSink> AggregateVecPhysicalOperator::create_local_sink()
+{
+  return make_unique<AggregateVecPhysicalOperator>(vector<Expression *>(aggregate_expressions_));
+}
+
+RC AggregateVecPhysicalOperator::merge(PipelineSink &local)
+{
+  auto &other = static_cast<AggregateVecPhysicalOperator &>(local);
+  for (size_t i = 0; i < aggregate_expressions_.size(); i++) {
+    auto *aggregate_expr = static_cast<AggregateExpr *>(aggregate_expressions_[i]);
+    RC    rc             = aggregate_state_merge(aggr_values_.at(i),
+        other.aggr_values_.at(i),
+        aggregate_expr->aggregate_type(),
+        aggregate_expr->child()->value_type());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to merge aggregate state. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 template <class STATE, typename T>
 void AggregateVecPhysicalOperator::update_aggregate_state(void *state, const Column &column)
 {
@@ -110,12 +162,14 @@ RC AggregateVecPhysicalOperator::next(Chunk &chunk)
   chunk.reference(output_chunk_);
   outputed_ = true;
 
-  return RC::SUCCESS;
+  return count_rows(RC::SUCCESS, chunk);
 }
 
 RC AggregateVecPhysicalOperator::close()
 {
-  children_[0]->close();
+  if (!children_.empty()) {
+    children_[0]->close();
+  }
   LOG_INFO("close group by operator");
   return RC::SUCCESS;
 }
@@ -11,12 +11,15 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "sql/operator/physical_operator.h"
+#include "sql/operator/pipeline.h"
 
 /**
  * @brief 聚合物理算子 (Vectorized)
  * @ingroup PhysicalOperator
+ * @details 流水线执行时作为中断点，数据由流水线通过 sink 推送，此时算子没有子算子。
+ * 并行推送时每个流水线实例聚合到自己的局部状态中，最后合并。
  */
-class AggregateVecPhysicalOperator : public PhysicalOperator
+class AggregateVecPhysicalOperator : public PhysicalOperator, public PipelineSink
 {
 public:
   AggregateVecPhysicalOperator(vector<Expression *> &&expressions);
@@ -29,6 +32,12 @@ public:
   RC next(Chunk &chunk) override;
   RC close() override;
 
+  RC sink(Chunk &chunk) override;
+
+  /// 局部 sink 是使用同样的聚合表达式、只有聚合状态的聚合算子
+  unique_ptr<PipelineSink> create_local_sink() override;
+  RC                       merge(PipelineSink &local) override;
+
 private:
   template <class STATE, typename T>
   void update_aggregate_state(void *state, const Column &column);
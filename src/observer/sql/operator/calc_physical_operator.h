@@ -32,7 +32,11 @@ public:
   string name() const override { return "CALC"; }
   string param() const override { return ""; }
 
-  RC open(Trx *trx) override { return RC::SUCCESS; }
+  RC open(Trx *trx) override
+  {
+    count_open();
+    return RC::SUCCESS;
+  }
   RC next() override
   {
     RC rc = RC::SUCCESS;
@@ -50,7 +54,7 @@ public:
         return rc;
       }
     }
-    return RC::SUCCESS;
+    return count_rows(RC::SUCCESS);
   }
   RC close() override { return RC::SUCCESS; }
 
@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 
 RC DeletePhysicalOperator::open(Trx *trx)
 {
+  count_open();
   if (children_.empty()) {
     return RC::SUCCESS;
   }
@@ -32,6 +33,7 @@ RC DeletePhysicalOperator::open(Trx *trx)
   }
 
   trx_ = trx;
+  records_.clear();
 
   while (OB_SUCC(rc = child->next())) {
     Tuple *tuple = child->current_tuple();
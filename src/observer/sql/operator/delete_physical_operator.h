@@ -40,6 +40,8 @@ public:
 
   Tuple *current_tuple() override { return nullptr; }
 
+  bool collect_constants(vector<Value *> &constants, vector<Value *> &copies) override { return true; }
+
 private:
   Table         *table_ = nullptr;
   Trx           *trx_   = nullptr;
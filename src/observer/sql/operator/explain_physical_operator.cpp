@@ -18,12 +18,53 @@ See the Mulan PSL v2 for more details. */
 
 using namespace std;
 
-RC ExplainPhysicalOperator::open(Trx *)
+RC ExplainPhysicalOperator::open(Trx *trx)
 {
   ASSERT(children_.size() == 1, "explain must has 1 child");
+  trx_ = trx;
+  if (analyze_) {
+    children_.front()->enable_actual();
+  }
   return RC::SUCCESS;
 }
 
+RC ExplainPhysicalOperator::run_child()
+{
+  PhysicalOperator &child = *children_.front();
+  RC                rc    = child.open(trx_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open child operator. rc=%s", strrc(rc));
+    return rc;
+  }
+  while (OB_SUCC(rc = child.next())) {
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to get next tuple from child operator. rc=%s", strrc(rc));
+    child.close();
+    return rc;
+  }
+  return child.close();
+}
+
+RC ExplainPhysicalOperator::run_child(Chunk &chunk)
+{
+  PhysicalOperator &child = *children_.front();
+  RC                rc    = child.open(trx_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open child operator. rc=%s", strrc(rc));
+    return rc;
+  }
+  while (OB_SUCC(rc = child.next(chunk))) {
+    chunk.reset();
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to get next chunk from child operator. rc=%s", strrc(rc));
+    child.close();
+    return rc;
+  }
+  return child.close();
+}
+
 RC ExplainPhysicalOperator::close() { return RC::SUCCESS; }
 
 void ExplainPhysicalOperator::generate_physical_plan()
@@ -37,6 +78,12 @@ RC ExplainPhysicalOperator::next()
   if (!physical_plan_.empty()) {
     return RC::RECORD_EOF;
   }
+  if (analyze_) {
+    RC rc = run_child();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
   generate_physical_plan();
 
   vector<Value> cells;
@@ -51,11 +98,18 @@ RC ExplainPhysicalOperator::next(Chunk &chunk)
   if (!physical_plan_.empty()) {
     return RC::RECORD_EOF;
   }
+  if (analyze_) {
+    Chunk child_chunk;
+    RC    rc = run_child(child_chunk);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
   generate_physical_plan();
 
   Value         cell(physical_plan_.c_str());
   auto column = make_unique<Column>();
-  column->init(cell, chunk.rows());
+  column->init(cell, 1);
   chunk.add_column(std::move(column), 0);
   return RC::SUCCESS;
 }
@@ -19,11 +19,12 @@ See the Mulan PSL v2 for more details. */
 /**
  * @brief Explain物理算子
  * @ingroup PhysicalOperator
+ * @details explain analyze 先执行子算子并丢弃结果，再输出执行计划，每个算子后面附带实际的输出行数
  */
 class ExplainPhysicalOperator : public PhysicalOperator
 {
 public:
-  ExplainPhysicalOperator()          = default;
+  explicit ExplainPhysicalOperator(bool analyze = false) : analyze_(analyze) {}
   virtual ~ExplainPhysicalOperator() = default;
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::EXPLAIN; }
@@ -50,7 +51,13 @@ public:
 private:
   void generate_physical_plan();
 
+  /// 执行子算子直到结束
+  RC run_child();
+  RC run_child(Chunk &chunk);
+
 private:
+  bool           analyze_ = false;
+  Trx           *trx_     = nullptr;
   string         physical_plan_;
   ValueListTuple tuple_;
 };
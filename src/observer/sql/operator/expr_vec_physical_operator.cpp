@@ -17,12 +17,12 @@ using namespace std;
 using namespace common;
 
 ExprVecPhysicalOperator::ExprVecPhysicalOperator(vector<Expression *> &&expressions)
-{
-  expressions_ = std::move(expressions);
-}
+    : expressions_(std::move(expressions)), stage_(expressions_)
+{}
 
 RC ExprVecPhysicalOperator::open(Trx *trx)
 {
+  count_open();
   ASSERT(children_.size() == 1, "group by operator only support one child, but got %d", children_.size());
 
   PhysicalOperator &child = *children_[0];
@@ -31,7 +31,7 @@ RC ExprVecPhysicalOperator::open(Trx *trx)
     LOG_INFO("failed to open child operator. rc=%s", strrc(rc));
     return rc;
   }
-  return rc;
+  return stage_.open();
 }
 
 RC ExprVecPhysicalOperator::next(Chunk &chunk)
@@ -41,17 +41,10 @@ RC ExprVecPhysicalOperator::next(Chunk &chunk)
 
   PhysicalOperator &child = *children_[0];
   chunk.reset();
-  evaled_chunk_.reset();
-  chunk_.reset();
-  if (OB_SUCC(rc = child.next(chunk_))) {
-    for (size_t i = 0; i < expressions_.size(); i++) {
-      auto column = make_unique<Column>();
-      expressions_[i]->get_column(chunk_, *column);
-      evaled_chunk_.add_column(std::move(column), i);
-    }
-    chunk.reference(evaled_chunk_);
+  if (OB_SUCC(rc = child.next(chunk_)) && OB_SUCC(rc = stage_.execute(chunk_))) {
+    chunk.reference(chunk_);
   }
-  return rc;
+  return count_rows(rc, chunk);
 }
 
 RC ExprVecPhysicalOperator::close()
@@ -11,10 +11,12 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "sql/operator/physical_operator.h"
+#include "sql/operator/pipeline.h"
 
 /**
  * @brief 表达式物理算子(Vectorized)
  * @ingroup PhysicalOperator
+ * @details 计算过程由 ExprPipelineStage 完成，流水线执行时同样的计算作为流水线的一个阶段
  */
 class ExprVecPhysicalOperator : public PhysicalOperator
 {
@@ -29,8 +31,10 @@ public:
   RC next(Chunk &chunk) override;
   RC close() override;
 
+  const vector<Expression *> &expressions() const { return expressions_; }
+
 private:
   vector<Expression *> expressions_;  /// 表达式
+  ExprPipelineStage    stage_;
   Chunk                chunk_;
-  Chunk                evaled_chunk_;
 };
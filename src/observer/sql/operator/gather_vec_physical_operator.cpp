@@ -0,0 +1,189 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/gather_vec_physical_operator.h"
+#include "common/log/log.h"
+#include "common/type/string_t.h"
+
+using namespace std;
+
+GatherVecPhysicalOperator::~GatherVecPhysicalOperator() { stop_workers(); }
+
+string GatherVecPhysicalOperator::param() const { return "degree=" + to_string(children_.size()); }
+
+void GatherVecPhysicalOperator::wrap_pipelines(
+    const function<unique_ptr<PhysicalOperator>(unique_ptr<PhysicalOperator>)> &creator)
+{
+  for (unique_ptr<PhysicalOperator> &pipeline : children_) {
+    pipeline = creator(std::move(pipeline));
+  }
+}
+
+RC GatherVecPhysicalOperator::open(Trx *trx)
+{
+  count_open();
+  stop_workers();
+
+  trx_ = trx;
+  scheduler_->reset();
+  queue_.clear();
+  current_.reset();
+  cancelled_       = false;
+  error_           = RC::SUCCESS;
+  running_workers_ = static_cast<int>(children_.size());
+  for (size_t i = 0; i < children_.size(); i++) {
+    workers_.emplace_back(&GatherVecPhysicalOperator::run_pipeline, this, static_cast<int>(i));
+  }
+  LOG_TRACE("gather operator opened. workers=%d", running_workers_);
+  return RC::SUCCESS;
+}
+
+void GatherVecPhysicalOperator::run_pipeline(int index)
+{
+  PhysicalOperator &pipeline = *children_[index];
+
+  RC rc = pipeline.open(trx_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open pipeline. index=%d, rc=%s", index, strrc(rc));
+  }
+
+  Chunk chunk;
+  while (OB_SUCC(rc)) {
+    rc = pipeline.next(chunk);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+    if (chunk.selected_rows() == 0) {
+      continue;
+    }
+
+    unique_ptr<Chunk> output;
+    {
+      unique_lock<mutex> guard(lock_);
+      if (!free_chunks_.empty()) {
+        output = std::move(free_chunks_.back());
+        free_chunks_.pop_back();
+      }
+    }
+    if (output == nullptr) {
+      output = make_unique<Chunk>();
+    }
+    // 拷贝时不持有锁，多个工作线程可以同时拷贝
+    rc = copy_chunk(chunk, *output);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to copy chunk. rc=%s", strrc(rc));
+      break;
+    }
+
+    unique_lock<mutex> guard(lock_);
+    not_full_.wait(guard, [this] {
+      return cancelled_ || static_cast<int>(queue_.size()) < QUEUE_CHUNKS_PER_WORKER * static_cast<int>(children_.size());
+    });
+    if (cancelled_) {
+      break;
+    }
+    queue_.push_back(std::move(output));
+    not_empty_.notify_one();
+  }
+
+  pipeline.close();
+
+  unique_lock<mutex> guard(lock_);
+  if (rc != RC::RECORD_EOF && rc != RC::SUCCESS && error_ == RC::SUCCESS) {
+    error_     = rc;
+    cancelled_ = true;
+    not_full_.notify_all();
+  }
+  running_workers_--;
+  not_empty_.notify_all();
+}
+
+RC GatherVecPhysicalOperator::next(Chunk &chunk)
+{
+  unique_lock<mutex> guard(lock_);
+  if (current_ != nullptr) {
+    free_chunks_.push_back(std::move(current_));
+  }
+  not_empty_.wait(guard, [this] { return !queue_.empty() || running_workers_ == 0 || error_ != RC::SUCCESS; });
+  if (error_ != RC::SUCCESS) {
+    return error_;
+  }
+  if (queue_.empty()) {
+    return RC::RECORD_EOF;
+  }
+  current_ = std::move(queue_.front());
+  queue_.pop_front();
+  not_full_.notify_one();
+  guard.unlock();
+
+  current_->set_memory_pool(&memory_pool_);
+  return count_rows(chunk.reference(*current_), chunk);
+}
+
+RC GatherVecPhysicalOperator::close()
+{
+  stop_workers();
+  return RC::SUCCESS;
+}
+
+void GatherVecPhysicalOperator::stop_workers()
+{
+  {
+    lock_guard<mutex> guard(lock_);
+    cancelled_ = true;
+    not_full_.notify_all();
+  }
+  for (thread &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  queue_.clear();
+  current_.reset();
+}
+
+RC GatherVecPhysicalOperator::copy_chunk(const Chunk &src, Chunk &dest)
+{
+  if (dest.column_num() != src.column_num()) {
+    dest.reset();
+    for (int i = 0; i < src.column_num(); i++) {
+      dest.add_column(make_unique<Column>(), src.column_ids(i));
+    }
+  }
+  dest.clear_selection();
+
+  const int rows = src.selected_rows();
+  for (int i = 0; i < src.column_num(); i++) {
+    const Column &src_column  = src.column(i);
+    Column       &dest_column = dest.column(i);
+    const int     attr_len    = src_column.attr_len();
+    const bool    constant    = src_column.column_type() == Column::Type::CONSTANT_COLUMN;
+    dest_column.init(src_column.attr_type(), attr_len, max(rows, 1));
+
+    RC rc = RC::SUCCESS;
+    for (int r = 0; r < rows && OB_SUCC(rc); r++) {
+      const int row = constant ? 0 : src.selected_row(r);
+      if (src_column.is_null(row)) {
+        rc = dest_column.append_null();
+      } else if (src_column.attr_type() == AttrType::TEXTS) {
+        // 长字符串保存在源列的 VectorBuffer 中，需要拷贝一份
+        const string_t &str  = *reinterpret_cast<const string_t *>(src_column.data() + row * attr_len);
+        string_t        copy = dest_column.add_text(str.data(), str.size());
+        rc                   = dest_column.append_one(reinterpret_cast<const char *>(&copy));
+      } else {
+        rc = dest_column.append_one(src_column.data() + static_cast<size_t>(row) * attr_len);
+      }
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to copy column. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
@@ -0,0 +1,87 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/condition_variable.h"
+#include "common/lang/deque.h"
+#include "common/lang/functional.h"
+#include "common/lang/mutex.h"
+#include "common/lang/thread.h"
+#include "sql/operator/physical_operator.h"
+#include "storage/common/column_memory_pool.h"
+#include "storage/record/morsel_scheduler.h"
+
+/**
+ * @brief 并行执行的汇合算子(Vectorized)
+ * @ingroup PhysicalOperator
+ * @details 每个子算子是一条流水线（比如扫描、过滤、计算表达式），由一个工作线程执行。流水线中的扫描算子
+ * 共享同一个 MorselScheduler，按 morsel 领取页面。工作线程把输出的 chunk 拷贝出来放到一个有界队列中，
+ * 本算子在调用 next 的线程中按到达的顺序返回，因此输出的顺序是不确定的。
+ *
+ * 流水线中的算子只在各自的工作线程中执行，算子内部的状态（内存池、编译的表达式等）都是线程私有的，
+ * 共享的只有只读的表达式和表的元数据。
+ */
+class GatherVecPhysicalOperator : public PhysicalOperator
+{
+public:
+  explicit GatherVecPhysicalOperator(shared_ptr<MorselScheduler> scheduler) : scheduler_(std::move(scheduler)) {}
+
+  virtual ~GatherVecPhysicalOperator();
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::GATHER_VEC; }
+
+  string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next(Chunk &chunk) override;
+  RC close() override;
+
+  /**
+   * @brief 在每条流水线的最上面再加一个算子
+   * @param creator 参数是原来的流水线，返回新的流水线
+   */
+  void wrap_pipelines(const function<unique_ptr<PhysicalOperator>(unique_ptr<PhysicalOperator>)> &creator);
+
+  /// 流水线共享的调度器。上层的并行算子直接接管流水线时使用
+  const shared_ptr<MorselScheduler> &scheduler() const { return scheduler_; }
+
+  /**
+   * @brief 把 src 中有效的行拷贝到 dest 中，dest 中的列都持有自己的数据
+   * @details dest 中已有的列会被复用
+   */
+  static RC copy_chunk(const Chunk &src, Chunk &dest);
+
+private:
+  void run_pipeline(int index);
+  /// 等待所有工作线程退出
+  void stop_workers();
+
+private:
+  /// 每个工作线程最多积压的 chunk 数
+  static constexpr int QUEUE_CHUNKS_PER_WORKER = 2;
+
+  shared_ptr<MorselScheduler> scheduler_;
+  Trx                        *trx_ = nullptr;
+
+  vector<thread> workers_;
+
+  mutex                     lock_;
+  condition_variable        not_empty_;
+  condition_variable        not_full_;
+  deque<unique_ptr<Chunk>>  queue_;
+  vector<unique_ptr<Chunk>> free_chunks_;  ///< 已经被消费的 chunk，工作线程拿来复用
+  int                       running_workers_ = 0;
+  bool                      cancelled_       = false;
+  RC                        error_           = RC::SUCCESS;
+
+  ColumnMemoryPool  memory_pool_;  ///< 下游算子在输出的 chunk 上计算表达式时使用
+  unique_ptr<Chunk> current_;      ///< 正在被下游算子使用的 chunk
+};
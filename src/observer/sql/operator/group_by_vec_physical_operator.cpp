@@ -16,8 +16,10 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/column.h"
 #include <memory>
 GroupByVecPhysicalOperator::GroupByVecPhysicalOperator(
-    vector<unique_ptr<Expression>> &&group_by_exprs, vector<Expression *> &&expressions)
-    : group_by_exprs_(std::move(group_by_exprs)), aggregate_expressions_(std::move(expressions))
+    vector<unique_ptr<Expression>> &&group_by_exprs, vector<Expression *> &&expressions, size_t memory_limit)
+    : group_by_exprs_(std::move(group_by_exprs)),
+      aggregate_expressions_(std::move(expressions)),
+      memory_limit_(memory_limit)
 {
 #ifdef USE_SIMD
   if (aggregate_expressions_.size() == 1 &&
@@ -37,8 +39,8 @@ GroupByVecPhysicalOperator::GroupByVecPhysicalOperator(
         hash_table_scanner_ = std::make_unique<LinearProbingAggregateHashTable<float>::Scanner>(hash_table_.get());
       } break;
       default: {
-        hash_table_         = std::make_unique<StandardAggregateHashTable>(aggregate_expressions_);
-        hash_table_scanner_ = std::make_unique<StandardAggregateHashTable::Scanner>(hash_table_.get());
+        need_encode_ = false;
+        create_general_hash_table();
       }
     }
     output_chunk_.add_column(
@@ -47,8 +49,7 @@ GroupByVecPhysicalOperator::GroupByVecPhysicalOperator(
                                  aggregate_expressions_.front()->value_length()),
         1);
   } else {
-    hash_table_         = std::make_unique<StandardAggregateHashTable>(aggregate_expressions_);
-    hash_table_scanner_ = std::make_unique<StandardAggregateHashTable::Scanner>(hash_table_.get());
+    create_general_hash_table();
     for (int i = 0; i < group_by_exprs_.size(); ++i) {
       output_chunk_.add_column(
           std::make_unique<Column>(group_by_exprs_[i]->value_type(), group_by_exprs_[i]->value_length()), i);
@@ -60,8 +61,7 @@ GroupByVecPhysicalOperator::GroupByVecPhysicalOperator(
     }
   }
 #else
-  hash_table_         = std::make_unique<StandardAggregateHashTable>(aggregate_expressions_);
-  hash_table_scanner_ = std::make_unique<StandardAggregateHashTable::Scanner>(hash_table_.get());
+  create_general_hash_table();
   for (int i = 0; i < group_by_exprs_.size(); ++i) {
     output_chunk_.add_column(
         std::make_unique<Column>(group_by_exprs_[i]->value_type(), group_by_exprs_[i]->value_length()), i);
@@ -74,6 +74,22 @@ GroupByVecPhysicalOperator::GroupByVecPhysicalOperator(
 #endif
 }
 
+void GroupByVecPhysicalOperator::create_general_hash_table()
+{
+  if (memory_limit_ > 0 && VectorizedAggregateHashTable::support(group_by_exprs_, aggregate_expressions_)) {
+    hash_table_         = std::make_unique<SpillableAggregateHashTable>(aggregate_expressions_, memory_limit_);
+    hash_table_scanner_ = std::make_unique<SpillableAggregateHashTable::Scanner>(hash_table_.get());
+  } else if (VectorizedAggregateHashTable::support(group_by_exprs_, aggregate_expressions_)) {
+    auto table          = std::make_unique<VectorizedAggregateHashTable>(aggregate_expressions_);
+    vectorized_table_   = table.get();
+    hash_table_         = std::move(table);
+    hash_table_scanner_ = std::make_unique<VectorizedAggregateHashTable::Scanner>(hash_table_.get());
+  } else {
+    hash_table_         = std::make_unique<StandardAggregateHashTable>(aggregate_expressions_);
+    hash_table_scanner_ = std::make_unique<StandardAggregateHashTable::Scanner>(hash_table_.get());
+  }
+}
+
 [[maybe_unused]] static std::unique_ptr<Column> encode(const Column &column)
 {
   std::unique_ptr<Column> res      = std::make_unique<Column>(AttrType::INTS, sizeof(int));
@@ -100,6 +116,13 @@ GroupByVecPhysicalOperator::GroupByVecPhysicalOperator(
 
 RC GroupByVecPhysicalOperator::open(Trx *trx)
 {
+  count_open();
+  if (children_.empty()) {
+    // 数据已经由流水线推送过来了
+    hash_table_scanner_->open_scan();
+    return RC::SUCCESS;
+  }
+
   ASSERT(children_.size() == 1, "group by operator only support one child, but got %d", children_.size());
   PhysicalOperator &child = *children_[0];
   RC                rc    = child.open(trx);
@@ -109,34 +132,8 @@ RC GroupByVecPhysicalOperator::open(Trx *trx)
   }
   Chunk chunk;
   while (OB_SUCC(rc = child.next(chunk))) {
-    if (chunk.rows() == 0) {
-      continue;
-    }
-    Chunk groups_chunk, aggrs_chunk;
-    for (int i = 0; i < group_by_exprs_.size(); ++i) {
-      std::unique_ptr<Column> column = std::make_unique<Column>();
-      group_by_exprs_[i]->get_column(chunk, *column);
-// output_column(*column);
-#ifdef USE_SIMD
-      if (need_encode_) {
-        column = encode(*column);
-        // output_column(*column);
-      }
-#endif
-      groups_chunk.add_column(std::move(column), i);
-    }
-    for (int i = 0; i < aggregate_expressions_.size(); ++i) {
-      std::unique_ptr<Column> column = std::make_unique<Column>();
-      static_cast<AggregateExpr *>(aggregate_expressions_[i])->child()->get_column(chunk, *column);
-      // output_column(*column);
-      aggrs_chunk.add_column(std::move(column), i);
-    }
-    if (groups_chunk.rows() > 0) {
-      rc = hash_table_->add_chunk(groups_chunk, aggrs_chunk);
-      if (OB_FAIL(rc)) {
-        LOG_INFO("failed to update aggregate state. rc=%s", strrc(rc));
-        return rc;
-      }
+    if (OB_FAIL(rc = sink(chunk))) {
+      return rc;
     }
     chunk.reset();
   }
@@ -148,6 +145,78 @@ RC GroupByVecPhysicalOperator::open(Trx *trx)
   return RC::SUCCESS;
 }
 
+RC GroupByVecPhysicalOperator::sink(Chunk &chunk)
+{
+  if (chunk.rows() == 0) {
+    return RC::SUCCESS;
+  }
+  RC    rc = RC::SUCCESS;
+  Chunk groups_chunk, aggrs_chunk;
+  for (int i = 0; i < group_by_exprs_.size(); ++i) {
+    std::unique_ptr<Column> column = std::make_unique<Column>(chunk.memory_pool());
+    group_by_exprs_[i]->get_column(chunk, *column);
+// output_column(*column);
+#ifdef USE_SIMD
+    if (need_encode_) {
+      column = encode(*column);
+      // output_column(*column);
+    }
+#endif
+    groups_chunk.add_column(std::move(column), i);
+  }
+  for (int i = 0; i < aggregate_expressions_.size(); ++i) {
+    std::unique_ptr<Column> column = std::make_unique<Column>(chunk.memory_pool());
+    static_cast<AggregateExpr *>(aggregate_expressions_[i])->child()->get_column(chunk, *column);
+    // output_column(*column);
+    aggrs_chunk.add_column(std::move(column), i);
+  }
+  if (chunk.has_selection()) {
+    // 哈希表需要紧凑的输入，这里只拷贝分组列与聚合列中的有效行
+    groups_chunk.set_selection(chunk.selection());
+    aggrs_chunk.set_selection(chunk.selection());
+    if (OB_FAIL(rc = groups_chunk.compact()) || OB_FAIL(rc = aggrs_chunk.compact())) {
+      LOG_WARN("failed to compact chunk. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  if (groups_chunk.rows() > 0) {
+    rc = hash_table_->add_chunk(groups_chunk, aggrs_chunk);
+    if (OB_FAIL(rc)) {
+      LOG_INFO("failed to update aggregate state. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  return rc;
+}
+
+unique_ptr<PipelineSink> GroupByVecPhysicalOperator::create_local_sink()
+{
+  if (vectorized_table_ == nullptr) {
+    return nullptr;
+  }
+  vector<unique_ptr<Expression>> group_by_exprs;
+  for (const unique_ptr<Expression> &expr : group_by_exprs_) {
+    group_by_exprs.emplace_back(expr->copy());
+  }
+  return std::make_unique<GroupByVecPhysicalOperator>(
+      std::move(group_by_exprs), vector<Expression *>(aggregate_expressions_));
+}
+
+RC GroupByVecPhysicalOperator::merge(PipelineSink &local)
+{
+  auto &other = static_cast<GroupByVecPhysicalOperator &>(local);
+  ASSERT(vectorized_table_ != nullptr && other.vectorized_table_ != nullptr, "only vectorized hash table can merge");
+  vector<int> groups(other.vectorized_table_->group_count());
+  for (int i = 0; i < static_cast<int>(groups.size()); i++) {
+    groups[i] = i;
+  }
+  RC rc = vectorized_table_->merge(*other.vectorized_table_, groups);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to merge local hash table. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
 RC GroupByVecPhysicalOperator::next(Chunk &chunk)
 {
 #ifdef USE_SIMD
@@ -165,12 +234,14 @@ RC GroupByVecPhysicalOperator::next(Chunk &chunk)
   if (OB_FAIL(rc)) {
     return rc;
   }
-  return chunk.reference(output_chunk_);
+  return count_rows(chunk.reference(output_chunk_), chunk);
 }
 
 RC GroupByVecPhysicalOperator::close()
 {
-  children_.at(0)->close();
+  if (!children_.empty()) {
+    children_[0]->close();
+  }
   hash_table_scanner_->close_scan();
   return RC::SUCCESS;
 }
\ No newline at end of file
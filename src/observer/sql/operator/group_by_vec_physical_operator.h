@@ -12,16 +12,24 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/expr/aggregate_hash_table.h"
 #include "sql/operator/physical_operator.h"
+#include "sql/operator/pipeline.h"
 #include "storage/common/chunk.h"
 
 /**
  * @brief Group By 物理算子(vectorized)
  * @ingroup PhysicalOperator
+ * @details 流水线执行时作为中断点，构建阶段由流水线通过 sink 推送数据，此时算子没有子算子。
+ * 使用 VectorizedAggregateHashTable 时，并行推送的每个流水线实例聚合到自己的局部哈希表中，最后合并；
+ * 其它哈希表不支持合并，由流水线加锁推送。
  */
-class GroupByVecPhysicalOperator : public PhysicalOperator
+class GroupByVecPhysicalOperator : public PhysicalOperator, public PipelineSink
 {
 public:
-  GroupByVecPhysicalOperator(vector<unique_ptr<Expression>> &&group_by_exprs, vector<Expression *> &&expressions);
+  /**
+   * @param memory_limit 哈希表可以使用的内存（字节），超过后溢出到磁盘。0 表示不限制
+   */
+  GroupByVecPhysicalOperator(vector<unique_ptr<Expression>> &&group_by_exprs, vector<Expression *> &&expressions,
+      size_t memory_limit = 0);
 
   virtual ~GroupByVecPhysicalOperator() = default;
 
@@ -31,12 +39,26 @@ public:
   RC next(Chunk &chunk) override;
   RC close() override;
 
+  RC sink(Chunk &chunk) override;
+
+  unique_ptr<PipelineSink> create_local_sink() override;
+  RC                       merge(PipelineSink &local) override;
+
+private:
+  /**
+   * @brief 创建通用的哈希表。优先使用 VectorizedAggregateHashTable，不支持时退化为 StandardAggregateHashTable
+   * @details 设置了内存限制时使用 SpillableAggregateHashTable
+   */
+  void create_general_hash_table();
+
 private:
   vector<unique_ptr<Expression>>          group_by_exprs_;
   vector<Expression *>                    aggregate_expressions_;
   unique_ptr<AggregateHashTable>          hash_table_;
   unique_ptr<AggregateHashTable::Scanner> hash_table_scanner_;
+  VectorizedAggregateHashTable           *vectorized_table_ = nullptr;  ///< hash_table_ 可以合并时指向它
   Chunk                                   output_chunk_;
+  size_t                                  memory_limit_ = 0;
 #ifdef USE_SIMD
   bool need_encode_{false};
 #endif
@@ -28,6 +28,14 @@ HashGroupByPhysicalOperator::HashGroupByPhysicalOperator(
 
 RC HashGroupByPhysicalOperator::open(Trx *trx)
 {
+  count_open();
+  if (children_.empty()) {
+    // 输入被恒假的过滤条件裁剪掉了，没有任何分组
+    current_group_ = groups_.begin();
+    first_emited_  = false;
+    return RC::SUCCESS;
+  }
+
   ASSERT(children_.size() == 1, "group by operator only support one child, but got %d", children_.size());
 
   PhysicalOperator &child = *children_[0];
@@ -107,12 +115,14 @@ RC HashGroupByPhysicalOperator::next()
     return RC::RECORD_EOF;
   }
 
-  return RC::SUCCESS;
+  return count_rows(RC::SUCCESS);
 }
 
 RC HashGroupByPhysicalOperator::close()
 {
-  children_[0]->close();
+  if (!children_.empty()) {
+    children_[0]->close();
+  }
   LOG_INFO("close group by operator");
   return RC::SUCCESS;
 }
@@ -9,3 +9,456 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "sql/operator/hash_join_physical_operator.h"
+#include "common/lang/unordered_set.h"
+#include "common/log/log.h"
+#include "sql/expr/expression_iterator.h"
+#include "sql/operator/table_scan_physical_operator.h"
+
+using namespace std;
+
+namespace {
+const char *join_type_name(JoinType join_type)
+{
+  switch (join_type) {
+    case JoinType::INNER: return "INNER";
+    case JoinType::SEMI: return "SEMI";
+    case JoinType::ANTI: return "ANTI";
+  }
+  return "UNKNOWN";
+}
+
+bool is_integer(AttrType type) { return type == AttrType::INTS || type == AttrType::BIGINTS; }
+
+bool is_numeric(AttrType type) { return is_integer(type) || type == AttrType::FLOATS; }
+
+RC collect_key_tables(unique_ptr<Expression> &expr, unordered_set<const Table *> &tables)
+{
+  if (expr->type() == ExprType::FIELD) {
+    tables.insert(static_cast<FieldExpr &>(*expr).field().table());
+  }
+  return ExpressionIterator::iterate_child_expr(
+      *expr, [&tables](unique_ptr<Expression> &child) { return collect_key_tables(child, tables); });
+}
+
+/**
+ * @brief 在 oper 的子树中查找扫描 table 的算子
+ * @details 只穿过不改变行的算子和内连接。过滤掉的行一定连接不上，所以从内连接的任意一侧删除都不改变结果；
+ * 半连接与反连接只能从左侧删除，右侧的行决定了左侧的行是否输出
+ */
+TableScanPhysicalOperator *find_scan(PhysicalOperator &oper, const Table *table)
+{
+  vector<unique_ptr<PhysicalOperator>> &children = oper.children();
+  switch (oper.type()) {
+    case PhysicalOperatorType::TABLE_SCAN: {
+      auto &scan_oper = static_cast<TableScanPhysicalOperator &>(oper);
+      return scan_oper.table() == table ? &scan_oper : nullptr;
+    }
+    case PhysicalOperatorType::PREDICATE: {
+      return children.empty() ? nullptr : find_scan(*children[0], table);
+    }
+    case PhysicalOperatorType::NESTED_LOOP_JOIN:
+    case PhysicalOperatorType::HASH_JOIN: {
+      const bool inner = oper.type() == PhysicalOperatorType::NESTED_LOOP_JOIN ||
+                         static_cast<HashJoinPhysicalOperator &>(oper).join_type() == JoinType::INNER;
+      for (size_t i = 0; i < children.size() && (i == 0 || inner); i++) {
+        TableScanPhysicalOperator *scan_oper = find_scan(*children[i], table);
+        if (scan_oper != nullptr) {
+          return scan_oper;
+        }
+      }
+      return nullptr;
+    }
+    default: return nullptr;
+  }
+}
+}  // namespace
+
+HashJoinPhysicalOperator::HashJoinPhysicalOperator(
+    JoinType join_type, vector<unique_ptr<Expression>> &&left_keys, vector<unique_ptr<Expression>> &&right_keys)
+    : join_type_(join_type), left_keys_(std::move(left_keys)), right_keys_(std::move(right_keys))
+{
+  ASSERT(left_keys_.size() == right_keys_.size(), "join keys should be paired");
+  for (size_t i = 0; i < left_keys_.size(); i++) {
+    key_types_.push_back(key_type(left_keys_[i]->value_type(), right_keys_[i]->value_type()));
+  }
+}
+
+AttrType HashJoinPhysicalOperator::key_type(AttrType left, AttrType right)
+{
+  if (left == right) {
+    return left;
+  }
+  if (is_integer(left) && is_integer(right)) {
+    return AttrType::BIGINTS;
+  }
+  if (is_numeric(left) && is_numeric(right)) {
+    return AttrType::FLOATS;
+  }
+  return AttrType::CHARS;
+}
+
+string HashJoinPhysicalOperator::param() const
+{
+  string result = string(join_type_name(join_type_)) + ", keys=" + to_string(left_keys_.size());
+  if (!predicates_.empty()) {
+    result += ", predicates=" + to_string(predicates_.size());
+  }
+  if (reversed_) {
+    result += ", build=left";
+  }
+  return result;
+}
+
+RC HashJoinPhysicalOperator::open(Trx *trx)
+{
+  count_open();
+  if (children_.size() != 2) {
+    LOG_WARN("hash join operator should have 2 children");
+    return RC::INTERNAL;
+  }
+
+  if (!runtime_filter_published_) {
+    runtime_filter_published_ = true;
+    publish_runtime_filter();
+  }
+
+  left_        = children_[0].get();
+  probe_       = left_;
+  probe_tuple_ = nullptr;
+  bucket_      = nullptr;
+  bucket_pos_  = 0;
+  reversed_    = false;
+  probe_buffer_.clear();
+  probe_pos_   = 0;
+  left_opened_ = false;
+
+  RC rc = build(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to build hash table. rc=%s", strrc(rc));
+    return rc;
+  }
+  return left_opened_ ? RC::SUCCESS : left_->open(trx);
+}
+
+size_t HashJoinPhysicalOperator::reverse_threshold() const
+{
+  if (join_type_ != JoinType::INNER || !children_[0]->has_estimate()) {
+    return 0;
+  }
+  const double threshold = std::max(MIN_REVERSE_ROWS, REVERSE_RATIO * children_[0]->estimated_rows());
+  return static_cast<size_t>(threshold);
+}
+
+void HashJoinPhysicalOperator::publish_runtime_filter()
+{
+  // 反连接要输出连接不上的行，不能提前过滤
+  if (join_type_ == JoinType::ANTI || left_keys_.empty()) {
+    return;
+  }
+
+  unordered_set<const Table *> tables;
+  for (unique_ptr<Expression> &key : left_keys_) {
+    if (OB_FAIL(collect_key_tables(key, tables))) {
+      return;
+    }
+  }
+  if (tables.size() != 1) {
+    return;
+  }
+
+  runtime_filter_target_ = find_scan(*children_[0], *tables.begin());
+  if (runtime_filter_target_ == nullptr) {
+    return;
+  }
+
+  vector<unique_ptr<Expression>> probe_keys;
+  for (unique_ptr<Expression> &key : left_keys_) {
+    probe_keys.emplace_back(key->copy());
+  }
+  runtime_filter_ = make_shared<RuntimeFilter>(std::move(probe_keys), key_types_);
+  runtime_filter_target_->add_runtime_filter(runtime_filter_);
+  LOG_TRACE("publish runtime filter to table scan. table=%s", runtime_filter_target_->param().c_str());
+}
+
+RC HashJoinPhysicalOperator::build(Trx *trx)
+{
+  hash_table_.clear();
+  keep_rows_ = join_type_ == JoinType::INNER || !predicates_.empty();
+  if (runtime_filter_ != nullptr) {
+    runtime_filter_->reset();
+  }
+
+  PhysicalOperator &right = *children_[1];
+  RC                rc    = right.open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open right child. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  string        key;
+  vector<Value> values;
+  const size_t  threshold  = reverse_threshold();
+  size_t        right_rows = 0;
+  while (OB_SUCC(rc = right.next())) {
+    Tuple *tuple = right.current_tuple();
+    if (nullptr == tuple) {
+      LOG_WARN("failed to get tuple from right child");
+      rc = RC::INTERNAL;
+      break;
+    }
+
+    if (OB_FAIL(rc = make_key(*tuple, right_keys_, values, key))) {
+      LOG_WARN("failed to make join key of right tuple. rc=%s", strrc(rc));
+      break;
+    }
+
+    auto [iter, inserted] = hash_table_.try_emplace(key);
+    if (inserted && runtime_filter_ != nullptr) {
+      runtime_filter_->add(values, key);
+    }
+    Bucket &bucket = iter->second;
+    if (keep_rows_) {
+      bucket.emplace_back();
+      if (OB_FAIL(rc = ValueListTuple::make(*tuple, bucket.back()))) {
+        LOG_WARN("failed to copy right tuple. rc=%s", strrc(rc));
+        break;
+      }
+    }
+
+    if (++right_rows == threshold) {
+      // 右表已经比估算的左表大很多，看一下左表实际的大小
+      if (OB_FAIL(rc = try_reverse(trx, right_rows))) {
+        break;
+      }
+      if (reversed_) {
+        // 右表剩下的行在 next 中直接探测，不再读到哈希表中
+        return RC::SUCCESS;
+      }
+    }
+  }
+
+  if (RC::RECORD_EOF == rc) {
+    rc = RC::SUCCESS;
+  }
+  if (runtime_filter_ != nullptr) {
+    runtime_filter_->finish();
+  }
+
+  RC close_rc = right.close();
+  if (OB_FAIL(close_rc)) {
+    LOG_WARN("failed to close right child. rc=%s", strrc(close_rc));
+  }
+  LOG_TRACE("hash join built %d buckets", static_cast<int>(hash_table_.size()));
+  return OB_SUCC(rc) ? close_rc : rc;
+}
+
+RC HashJoinPhysicalOperator::try_reverse(Trx *trx, size_t limit)
+{
+  RC rc = left_->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open left child. rc=%s", strrc(rc));
+    return rc;
+  }
+  left_opened_ = true;
+
+  // 最多读取 limit 行，左表更大时这些行留给探测阶段使用
+  while (probe_buffer_.size() < limit && OB_SUCC(rc = left_->next())) {
+    probe_buffer_.emplace_back();
+    if (OB_FAIL(rc = ValueListTuple::make(*left_->current_tuple(), probe_buffer_.back()))) {
+      LOG_WARN("failed to copy left tuple. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  if (OB_SUCC(rc)) {
+    LOG_TRACE("left child is not smaller than right child. keep building right. left rows>=%d",
+        static_cast<int>(probe_buffer_.size()));
+    return rc;
+  }
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to get next tuple from left child. rc=%s", strrc(rc));
+    return rc;
+  }
+  if (OB_FAIL(rc = left_->close())) {
+    LOG_WARN("failed to close left child. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // 左表读完了，用左表建哈希表，已经读到的右表行与右表剩下的行一起探测
+  vector<ValueListTuple> left_rows = std::move(probe_buffer_);
+  probe_buffer_.clear();
+  for (auto &[key, bucket] : hash_table_) {
+    for (ValueListTuple &right_tuple : bucket) {
+      probe_buffer_.emplace_back(std::move(right_tuple));
+    }
+  }
+  hash_table_.clear();
+
+  string        key;
+  vector<Value> values;
+  for (ValueListTuple &left_tuple : left_rows) {
+    if (OB_FAIL(rc = make_key(left_tuple, left_keys_, values, key))) {
+      LOG_WARN("failed to make join key of left tuple. rc=%s", strrc(rc));
+      return rc;
+    }
+    hash_table_[key].emplace_back(std::move(left_tuple));
+  }
+
+  LOG_INFO("reverse hash join build side. estimated left rows=%d, actual left rows=%d, right rows>=%d",
+      static_cast<int>(children_[0]->estimated_rows()), static_cast<int>(left_rows.size()), static_cast<int>(limit));
+  reversed_ = true;
+  probe_    = children_[1].get();
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::next_probe_tuple()
+{
+  if (probe_pos_ < probe_buffer_.size()) {
+    probe_tuple_ = &probe_buffer_[probe_pos_++];
+    return RC::SUCCESS;
+  }
+
+  RC rc = probe_->next();
+  if (OB_SUCC(rc)) {
+    probe_tuple_ = probe_->current_tuple();
+  }
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::make_key(
+    const Tuple &tuple, vector<unique_ptr<Expression>> &keys, vector<Value> &values, string &key) const
+{
+  values.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    RC rc = keys[i]->get_value(tuple, values[i]);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to evaluate join key. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  // 按照比较类型编码，与运行时过滤器使用相同的编码
+  RuntimeFilter::encode_key(values, key_types_, key);
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::next()
+{
+  RC rc = RC::SUCCESS;
+  while (true) {
+    if (join_type_ == JoinType::INNER && bucket_ != nullptr) {
+      while (bucket_pos_ < bucket_->size()) {
+        Tuple *build_tuple = &(*bucket_)[bucket_pos_++];
+        if (reversed_) {
+          joined_tuple_.set_left(build_tuple);
+        } else {
+          joined_tuple_.set_right(build_tuple);
+        }
+        bool matched = false;
+        if (OB_FAIL(rc = filter(matched))) {
+          return rc;
+        }
+        if (matched) {
+          return count_rows(RC::SUCCESS);
+        }
+      }
+    }
+
+    if (OB_FAIL(rc = next_probe_tuple())) {
+      return rc;
+    }
+    if (reversed_) {
+      joined_tuple_.set_right(probe_tuple_);
+    } else {
+      joined_tuple_.set_left(probe_tuple_);
+    }
+
+    if (OB_FAIL(rc = make_key(*probe_tuple_, reversed_ ? right_keys_ : left_keys_, key_values_, key_))) {
+      LOG_WARN("failed to make join key of probe tuple. rc=%s", strrc(rc));
+      return rc;
+    }
+    auto iter   = hash_table_.find(key_);
+    bucket_     = iter == hash_table_.end() ? nullptr : &iter->second;
+    bucket_pos_ = 0;
+
+    if (join_type_ != JoinType::INNER) {
+      bool matched = false;
+      if (bucket_ != nullptr && OB_FAIL(rc = match_any(*bucket_, matched))) {
+        return rc;
+      }
+      if (matched == (join_type_ == JoinType::SEMI)) {
+        return count_rows(RC::SUCCESS);
+      }
+    }
+  }
+  return rc;
+}
+
+RC HashJoinPhysicalOperator::match_any(Bucket &bucket, bool &matched)
+{
+  if (predicates_.empty()) {
+    matched = true;
+    return RC::SUCCESS;
+  }
+
+  matched = false;
+  for (ValueListTuple &right_tuple : bucket) {
+    joined_tuple_.set_right(&right_tuple);
+    RC rc = filter(matched);
+    if (OB_FAIL(rc) || matched) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::filter(bool &result)
+{
+  Value value;
+  for (unique_ptr<Expression> &expr : predicates_) {
+    RC rc = expr->get_value(joined_tuple_, value);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (!value.get_boolean()) {
+      result = false;
+      return rc;
+    }
+  }
+  result = true;
+  return RC::SUCCESS;
+}
+
+RC HashJoinPhysicalOperator::close()
+{
+  hash_table_.clear();
+  probe_buffer_.clear();
+  bucket_ = nullptr;
+
+  RC rc = probe_ == nullptr ? RC::SUCCESS : probe_->close();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to close probe oper. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+Tuple *HashJoinPhysicalOperator::current_tuple()
+{
+  if (join_type_ == JoinType::INNER) {
+    return &joined_tuple_;
+  }
+  return probe_tuple_;
+}
+
+bool HashJoinPhysicalOperator::collect_constants(vector<Value *> &constants, vector<Value *> &copies)
+{
+  for (unique_ptr<Expression> &expr : left_keys_) {
+    collect_expression_constants(*expr, constants);
+  }
+  for (unique_ptr<Expression> &expr : right_keys_) {
+    collect_expression_constants(*expr, constants);
+  }
+  for (unique_ptr<Expression> &expr : predicates_) {
+    collect_expression_constants(*expr, constants);
+  }
+  return true;
+}
@@ -10,12 +10,134 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/unordered_map.h"
+#include "sql/operator/join_logical_operator.h"
 #include "sql/operator/physical_operator.h"
+#include "sql/operator/runtime_filter.h"
 #include "sql/parser/parse.h"
 
+class TableScanPhysicalOperator;
+
 /**
  * @brief Hash Join 算子
  * @ingroup PhysicalOperator
+ * @details 打开算子时读取右表的所有数据，按照连接键放到哈希表中，然后逐行读取左表并在哈希表中查找。
+ * 支持内连接、半连接与反连接。半连接与反连接只输出左表的行，每行最多输出一次。
+ * 连接键以外的连接条件在找到相同键的行之后计算。
+ * 内连接和半连接建完哈希表后，如果连接键只用到左侧某张表的字段，会生成 RuntimeFilter 交给这张表的扫描算子，
+ * 一定连接不上的行在扫描时就被丢弃。
+ *
+ * 优化器按照估算的行数选择右表作为建表的一侧，估算错误时建表的代价可能大很多。内连接有估算值时，
+ * 右表读到的行数超过左表估算行数的 REVERSE_RATIO 倍后，会先读取同样多的左表行：左表在此之前读完，
+ * 说明左表更小，改用左表建哈希表，右表已经读到的行和剩下的行作为探测的一侧；否则继续用右表建表。
  */
-class HashJoinPhysicalOperator
-{};
\ No newline at end of file
+class HashJoinPhysicalOperator : public PhysicalOperator
+{
+public:
+  /**
+   * @param left_keys 在左表的行上计算的连接键
+   * @param right_keys 在右表的行上计算的连接键，与 left_keys 一一对应，可以都为空
+   */
+  HashJoinPhysicalOperator(
+      JoinType join_type, vector<unique_ptr<Expression>> &&left_keys, vector<unique_ptr<Expression>> &&right_keys);
+  virtual ~HashJoinPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::HASH_JOIN; }
+
+  OpType get_op_type() const override
+  {
+    return join_type_ == JoinType::INNER ? OpType::INNERHASHJOIN : OpType::HASHSEMIJOIN;
+  }
+
+  virtual double calculate_cost(
+      LogicalProperty *prop, const vector<LogicalProperty *> &child_log_props, CostModel *cm) override
+  {
+    return cm->hash_join(child_log_props[0]->get_card(), child_log_props[1]->get_card(), prop->get_card());
+  }
+
+  string param() const override;
+
+  /**
+   * @brief 设置连接键以外的连接条件，在左右两行组成的 JoinedTuple 上计算
+   */
+  void set_predicates(vector<unique_ptr<Expression>> &&exprs) { predicates_ = std::move(exprs); }
+
+  RC     open(Trx *trx) override;
+  RC     next() override;
+  RC     close() override;
+  Tuple *current_tuple() override;
+
+  bool collect_constants(vector<Value *> &constants, vector<Value *> &copies) override;
+
+  /**
+   * @brief 两边的连接键比较时使用的类型
+   * @details 类型相同时不需要转换；都是整数时按 BIGINTS 比较，都是数值时按 FLOATS 比较，否则按字符串比较
+   */
+  static AttrType key_type(AttrType left, AttrType right);
+
+  JoinType join_type() const { return join_type_; }
+
+  /// 接收运行时过滤器的表扫描算子，没有时返回空
+  TableScanPhysicalOperator *runtime_filter_target() const { return runtime_filter_target_; }
+
+private:
+  using Bucket = vector<ValueListTuple>;
+
+  /// 右表读到的行数是左表估算行数的多少倍时尝试交换建表的一侧
+  static constexpr double REVERSE_RATIO    = 4;
+  static constexpr double MIN_REVERSE_ROWS = 1024;
+
+  /// 右表读到多少行时尝试交换，返回 0 表示不尝试
+  size_t reverse_threshold() const;
+
+  /**
+   * @brief 读取左表，左表不超过 limit 行时改用左表建哈希表
+   * @details 左表更大时，读到的行保存在 probe_buffer_ 中，左表保持打开，探测时先使用这些行
+   */
+  RC try_reverse(Trx *trx, size_t limit);
+
+  /// 取下一个探测的行，先取缓存的行，再从探测一侧的子算子读取
+  RC next_probe_tuple();
+
+  /// 右表的所有行放到哈希表中
+  RC build(Trx *trx);
+
+  /// 计算连接键，把它们转换成比较类型之后拼接成哈希表的键
+  RC make_key(const Tuple &tuple, vector<unique_ptr<Expression>> &keys, vector<Value> &values, string &key) const;
+
+  /// 在左子树中找到连接键所在的表扫描算子，把运行时过滤器交给它
+  void publish_runtime_filter();
+
+  /// 左表当前行是否在 bucket 中有满足所有连接条件的行
+  RC match_any(Bucket &bucket, bool &matched);
+
+  RC filter(bool &result);
+
+private:
+  JoinType                       join_type_;
+  vector<unique_ptr<Expression>> left_keys_;
+  vector<unique_ptr<Expression>> right_keys_;
+  vector<AttrType>               key_types_;
+  vector<unique_ptr<Expression>> predicates_;  //! 连接键以外的条件，它们之间是 AND 的关系
+
+  /// 只有内连接，或者有其它连接条件时才需要保存右表的行，否则桶只用来表示这个键存在
+  unordered_map<string, Bucket> hash_table_;
+  bool                          keep_rows_ = false;
+
+  shared_ptr<RuntimeFilter>  runtime_filter_;
+  TableScanPhysicalOperator *runtime_filter_target_    = nullptr;
+  bool                       runtime_filter_published_ = false;  //! 只在第一次打开时查找目标算子
+
+  PhysicalOperator      *left_         = nullptr;
+  PhysicalOperator      *probe_        = nullptr;  //! 探测一侧的子算子，交换之后是右表
+  Tuple                 *probe_tuple_  = nullptr;
+  bool                   reversed_     = false;    //! 是否改用左表建哈希表
+  bool                   left_opened_  = false;    //! 左表是否已经在建表时打开
+  vector<ValueListTuple> probe_buffer_;            //! 建表时已经读出来的探测一侧的行
+  size_t                 probe_pos_    = 0;
+  Bucket                *bucket_       = nullptr;  //! 内连接时探测行对应的桶
+  size_t                 bucket_pos_   = 0;        //! 下一个要关联的建表行在桶中的位置
+  JoinedTuple            joined_tuple_;
+  vector<Value>          key_values_;  //! 探测行的连接键
+  string                 key_;
+};
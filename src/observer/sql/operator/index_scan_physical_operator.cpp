@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/index_scan_physical_operator.h"
+#include "catalog/catalog.h"
 #include "storage/index/index.h"
 #include "storage/trx/trx.h"
 
@@ -34,14 +35,30 @@ IndexScanPhysicalOperator::IndexScanPhysicalOperator(Table *table, Index *index,
 
 RC IndexScanPhysicalOperator::open(Trx *trx)
 {
+  count_open();
   if (nullptr == table_ || nullptr == index_) {
     return RC::INTERNAL;
   }
 
-  IndexScanner *index_scanner = index_->create_scanner(left_value_.data(),
+  tuple_.set_schema(table_, table_->table_meta().field_metas());
+  trx_ = trx;
+
+  // 没有设置的一端不限制范围
+  const bool has_left  = left_value_.attr_type() != AttrType::UNDEFINED;
+  const bool has_right = right_value_.attr_type() != AttrType::UNDEFINED;
+  if (has_left && has_right) {
+    // 缓存的执行计划换了常量之后，范围可能是空的
+    const int result = left_value_.compare(right_value_);
+    if (result > 0 || (result == 0 && !(left_inclusive_ && right_inclusive_))) {
+      index_scanner_ = nullptr;
+      return RC::SUCCESS;
+    }
+  }
+
+  IndexScanner *index_scanner = index_->create_scanner(has_left ? left_value_.data() : nullptr,
       left_value_.length(),
       left_inclusive_,
-      right_value_.data(),
+      has_right ? right_value_.data() : nullptr,
       right_value_.length(),
       right_inclusive_);
   if (nullptr == index_scanner) {
@@ -49,16 +66,16 @@ RC IndexScanPhysicalOperator::open(Trx *trx)
     return RC::INTERNAL;
   }
   index_scanner_ = index_scanner;
-
-  tuple_.set_schema(table_, table_->table_meta().field_metas());
-
-  trx_ = trx;
   return RC::SUCCESS;
 }
 
 RC IndexScanPhysicalOperator::next()
 {
   // TODO: 需要适配 lsm-tree 引擎
+  if (nullptr == index_scanner_) {
+    return RC::RECORD_EOF;
+  }
+
   RID rid;
   RC  rc = RC::SUCCESS;
 
@@ -89,7 +106,7 @@ RC IndexScanPhysicalOperator::next()
       LOG_TRACE("record invisible");
       continue;
     } else {
-      return rc;
+      return count_rows(rc);
     }
   }
 
@@ -98,8 +115,10 @@ RC IndexScanPhysicalOperator::next()
 
 RC IndexScanPhysicalOperator::close()
 {
-  index_scanner_->destroy();
-  index_scanner_ = nullptr;
+  if (index_scanner_ != nullptr) {
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
   return RC::SUCCESS;
 }
 
@@ -109,6 +128,20 @@ Tuple *IndexScanPhysicalOperator::current_tuple()
   return &tuple_;
 }
 
+bool IndexScanPhysicalOperator::collect_constants(vector<Value *> &constants, vector<Value *> &copies)
+{
+  // 扫描范围来自过滤条件，过滤条件仍然保留在 predicates_ 中
+  for (unique_ptr<Expression> &expr : predicates_) {
+    collect_expression_constants(*expr, constants);
+  }
+  for (Value *bound : {&left_value_, &right_value_}) {
+    if (bound->attr_type() != AttrType::UNDEFINED) {
+      copies.push_back(bound);
+    }
+  }
+  return true;
+}
+
 void IndexScanPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&exprs)
 {
   predicates_ = std::move(exprs);
@@ -137,5 +170,39 @@ RC IndexScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 
 string IndexScanPhysicalOperator::param() const
 {
-  return string(index_->index_meta().name()) + " ON " + table_->name();
+  string result = string(index_->index_meta().name()) + " ON " + table_->name();
+  if (left_value_.attr_type() == AttrType::UNDEFINED && right_value_.attr_type() == AttrType::UNDEFINED) {
+    return result;
+  }
+  result += ", " + string(index_->index_meta().field()) + " IN ";
+  result += left_value_.attr_type() == AttrType::UNDEFINED ? "(-inf"
+                                                           : (left_inclusive_ ? "[" : "(") + left_value_.to_string();
+  result += ", ";
+  result += right_value_.attr_type() == AttrType::UNDEFINED ? "+inf)"
+                                                            : right_value_.to_string() + (right_inclusive_ ? "]" : ")");
+  return result;
+}
+
+uint64_t IndexScanPhysicalOperator::hash() const
+{
+  uint64_t hash = std::hash<int>()(static_cast<int>(get_op_type()));
+  hash ^= std::hash<int>()(table_->table_id());
+  hash ^= std::hash<string>()(index_->index_meta().name());
+  return hash;
+}
+
+bool IndexScanPhysicalOperator::operator==(const OperatorNode &other) const
+{
+  if (get_op_type() != other.get_op_type()) {
+    return false;
+  }
+  const auto &other_scan = static_cast<const IndexScanPhysicalOperator &>(other);
+  return table_ == other_scan.table_ && index_ == other_scan.index_;
+}
+
+double IndexScanPhysicalOperator::calculate_cost(
+    LogicalProperty *prop, const vector<LogicalProperty *> &child_log_props, CostModel *cm)
+{
+  const double rows = Catalog::get_instance().get_table_stats(table_->table_id()).row_nums;
+  return cm->index_scan(rows, CostModel::pages(rows, table_->table_meta().record_size()), rows * range_selectivity_);
 }
@@ -31,6 +31,12 @@ public:
   virtual ~IndexScanPhysicalOperator() = default;
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::INDEX_SCAN; }
+  OpType               get_op_type() const override { return OpType::INDEXSCAN; }
+
+  uint64_t hash() const override;
+  bool     operator==(const OperatorNode &other) const override;
+
+  double calculate_cost(LogicalProperty *prop, const vector<LogicalProperty *> &child_log_props, CostModel *cm) override;
 
   string param() const override;
 
@@ -40,8 +46,15 @@ public:
 
   Tuple *current_tuple() override;
 
+  bool collect_constants(vector<Value *> &constants, vector<Value *> &copies) override;
+
   void set_predicates(vector<unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 设置扫描区间内的行占全表的比例，用于估算代价
+   */
+  void set_range_selectivity(double selectivity) { range_selectivity_ = selectivity; }
+
 private:
   // 与TableScanPhysicalOperator代码相同，可以优化
   RC filter(RowTuple &tuple, bool &result);
@@ -61,5 +74,7 @@ private:
   bool  left_inclusive_  = false;
   bool  right_inclusive_ = false;
 
+  double range_selectivity_ = 1;
+
   vector<unique_ptr<Expression>> predicates_;
 };
@@ -40,6 +40,14 @@ public:
 
   Tuple *current_tuple() override { return nullptr; }
 
+  bool collect_constants(vector<Value *> &constants, vector<Value *> &copies) override
+  {
+    for (Value &value : values_) {
+      constants.push_back(&value);
+    }
+    return true;
+  }
+
 private:
   Table        *table_ = nullptr;
   vector<Value> values_;
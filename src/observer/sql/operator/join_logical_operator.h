@@ -14,7 +14,21 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/cmath.h"
 #include "sql/operator/logical_operator.h"
+#include "sql/optimizer/cascade/selectivity.h"
+
+/**
+ * @brief 连接的类型
+ * @details 半连接与反连接由子查询展开得到，只输出左边的行：半连接输出在右边能找到匹配的行，
+ * 反连接输出在右边找不到匹配的行
+ */
+enum class JoinType
+{
+  INNER,
+  SEMI,
+  ANTI,
+};
 
 /**
  * @brief 连接算子
@@ -24,7 +38,8 @@ See the Mulan PSL v2 for more details. */
 class JoinLogicalOperator : public LogicalOperator
 {
 public:
-  JoinLogicalOperator()          = default;
+  JoinLogicalOperator() = default;
+  explicit JoinLogicalOperator(JoinType join_type) : join_type_(join_type) {}
   virtual ~JoinLogicalOperator() = default;
 
   LogicalOperatorType type() const override { return LogicalOperatorType::JOIN; }
@@ -37,12 +52,39 @@ public:
     return nullptr;
   }
 
-  OpType get_op_type() const override { return OpType::LOGICALINNERJOIN; }
+  OpType get_op_type() const override
+  {
+    return join_type_ == JoinType::INNER ? OpType::LOGICALINNERJOIN : OpType::LOGICALSEMIJOIN;
+  }
+
+  JoinType join_type() const { return join_type_; }
+
+  /**
+   * @brief 等值连接的键，left_keys 在左边的输入上计算，right_keys 在右边的输入上计算
+   * @details 子查询展开时左右两边可能是同一张表，不能再根据字段所属的表区分两边，所以单独记录
+   */
+  void add_join_key(unique_ptr<Expression> left_key, unique_ptr<Expression> right_key)
+  {
+    left_keys_.emplace_back(std::move(left_key));
+    right_keys_.emplace_back(std::move(right_key));
+  }
+  vector<unique_ptr<Expression>> &left_keys() { return left_keys_; }
+  vector<unique_ptr<Expression>> &right_keys() { return right_keys_; }
 
   vector<unique_ptr<Expression>> &get_join_predicates() { return join_predicates_; }
 
   void clear_join_predicates() { join_predicates_.clear(); }
 
+  /// cascade 的规则生成新的连接算子时使用，同一个连接条件可能出现在多个等价的连接中
+  vector<unique_ptr<Expression>> copy_join_predicates() const
+  {
+    vector<unique_ptr<Expression>> predicates;
+    for (const unique_ptr<Expression> &predicate : join_predicates_) {
+      predicates.emplace_back(predicate->copy());
+    }
+    return predicates;
+  }
+
   auto add_join_predicate(unique_ptr<Expression> &&predicate) { join_predicates_.push_back(std::move(predicate)); }
 
   unique_ptr<LogicalProperty> find_log_prop(const vector<LogicalProperty *> &log_props) override
@@ -51,25 +93,30 @@ public:
       return nullptr;
     }
 
-    LogicalProperty *left_log_prop  = log_props[0];
-    LogicalProperty *right_log_prop = log_props[1];
-    int              card           = left_log_prop->get_card() * right_log_prop->get_card();
+    const double left_card   = log_props[0]->get_card();
+    const double right_card  = log_props[1]->get_card();
+    double       selectivity = 1;
     for (auto &predicate : join_predicates_) {
-      if (predicate->type() != ExprType::COMPARISON) {
-        continue;
-      }
-      auto  pred_expr = dynamic_cast<ComparisonExpr *>(predicate.get());
-      auto &left      = pred_expr->left();
-      auto &right     = pred_expr->right();
-      if (pred_expr->comp() == CompOp::EQUAL_TO && left->type() == ExprType::FIELD &&
-          right->type() == ExprType::FIELD) {
-        card /= std::max(std::max(left_log_prop->get_card(), right_log_prop->get_card()), 1);
-      }
+      selectivity *= SelectivityEstimator::join_selectivity(*predicate, left_card, right_card);
+    }
+    for (size_t i = 0; i < left_keys_.size(); i++) {
+      ComparisonExpr key_predicate(EQUAL_TO, left_keys_[i]->copy(), right_keys_[i]->copy());
+      selectivity *= SelectivityEstimator::join_selectivity(key_predicate, left_card, right_card);
+    }
+
+    double card = left_card * right_card * selectivity;
+    if (join_type_ != JoinType::INNER) {
+      // 左边的每一行最多输出一次
+      const double semi_card = left_card * std::min(1.0, right_card * selectivity);
+      card                   = join_type_ == JoinType::SEMI ? semi_card : left_card - semi_card;
     }
-    return make_unique<LogicalProperty>(card);
+    return make_unique<LogicalProperty>(static_cast<int>(std::min(std::round(card), double(INT32_MAX))));
   }
 
 private:
+  JoinType                            join_type_    = JoinType::INNER;
   LogicalOperator                    *predicate_op_ = nullptr;
   std::vector<unique_ptr<Expression>> join_predicates_;
+  vector<unique_ptr<Expression>>      left_keys_;
+  vector<unique_ptr<Expression>>      right_keys_;
 };
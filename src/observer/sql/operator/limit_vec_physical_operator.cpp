@@ -5,6 +5,7 @@ using namespace common;
 
 RC LimitVecPhysicalOperator::open(Trx *trx)
 {
+  count_open();
   ASSERT(children_.size() == 1, "limit operator only support one child, but got %d", children_.size());
 
   child = children_[0].get();
@@ -26,15 +27,12 @@ RC LimitVecPhysicalOperator::next(Chunk &chunk)
   if (OB_FAIL(rc)) {
     return rc;
   }
-  if (n_ >= chunk.rows()) {
-    n_ -= chunk.rows();
-    return RC::SUCCESS;
-  }
-  for (int i = 0; i < chunk.column_num(); ++i) {
-    Column &column = chunk.column(i);
-    column.limit(n_);
+  if (n_ >= chunk.selected_rows()) {
+    n_ -= chunk.selected_rows();
+    return count_rows(RC::SUCCESS, chunk);
   }
+  chunk.limit(n_);
   n_ = 0;
-  return RC::SUCCESS;
+  return count_rows(RC::SUCCESS, chunk);
 }
 RC LimitVecPhysicalOperator::close() { return child->close(); }
\ No newline at end of file
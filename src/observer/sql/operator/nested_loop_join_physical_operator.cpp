@@ -18,6 +18,7 @@ NestedLoopJoinPhysicalOperator::NestedLoopJoinPhysicalOperator() {}
 
 RC NestedLoopJoinPhysicalOperator::open(Trx *trx)
 {
+  count_open();
   if (children_.size() != 2) {
     LOG_WARN("nlj operator should have 2 children");
     return RC::INTERNAL;
@@ -60,10 +61,37 @@ RC NestedLoopJoinPhysicalOperator::next()
         return rc;
       }
     }
+
+    bool matched = false;
+    rc           = filter(matched);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to evaluate join predicates. rc=%s", strrc(rc));
+      return rc;
+    }
+    if (matched) {
+      return count_rows(rc);
+    }
   }
   return rc;
 }
 
+RC NestedLoopJoinPhysicalOperator::filter(bool &result)
+{
+  Value value;
+  for (unique_ptr<Expression> &expr : predicates_) {
+    RC rc = expr->get_value(joined_tuple_, value);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (!value.get_boolean()) {
+      result = false;
+      return rc;
+    }
+  }
+  result = true;
+  return RC::SUCCESS;
+}
+
 RC NestedLoopJoinPhysicalOperator::close()
 {
   RC rc = left_->close();
@@ -82,6 +110,14 @@ RC NestedLoopJoinPhysicalOperator::close()
   return rc;
 }
 
+bool NestedLoopJoinPhysicalOperator::collect_constants(vector<Value *> &constants, vector<Value *> &copies)
+{
+  for (unique_ptr<Expression> &expr : predicates_) {
+    collect_expression_constants(*expr, constants);
+  }
+  return true;
+}
+
 Tuple *NestedLoopJoinPhysicalOperator::current_tuple() { return &joined_tuple_; }
 
 RC NestedLoopJoinPhysicalOperator::left_next()
@@ -35,17 +35,25 @@ public:
   virtual double calculate_cost(
       LogicalProperty *prop, const vector<LogicalProperty *> &child_log_props, CostModel *cm) override
   {
-    return 0.0;
+    return cm->nested_loop_join(child_log_props[0]->get_card(), child_log_props[1]->get_card(), prop->get_card());
   }
 
+  /**
+   * @brief 设置连接条件，只输出满足所有条件的组合
+   */
+  void set_predicates(vector<unique_ptr<Expression>> &&exprs) { predicates_ = std::move(exprs); }
+
   RC     open(Trx *trx) override;
   RC     next() override;
   RC     close() override;
   Tuple *current_tuple() override;
 
+  bool collect_constants(vector<Value *> &constants, vector<Value *> &copies) override;
+
 private:
   RC left_next();   //! 左表遍历下一条数据
   RC right_next();  //! 右表遍历下一条数据，如果上一轮结束了就重新开始新的一轮
+  RC filter(bool &result);
 
   // TODO: remove this func
   // Expression *predicate() { return predicate_; }
@@ -61,4 +69,6 @@ private:
   JoinedTuple       joined_tuple_;         //! 当前关联的左右两个tuple
   bool              round_done_   = true;  //! 右表遍历的一轮是否结束
   bool              right_closed_ = true;  //! 右表算子是否已经关闭
+
+  vector<unique_ptr<Expression>> predicates_;  //! 连接条件，它们之间是 AND 的关系
 };
@@ -32,6 +32,7 @@ enum class OpType
   LOGICALPROJECTION,
   LOGICALFILTER,
   LOGICALINNERJOIN,
+  LOGICALSEMIJOIN,  ///< 半连接与反连接
   LOGICALINSERT,
   LOGICALDELETE,
   LOGICALUPDATE,
@@ -52,6 +53,7 @@ enum class OpType
   INNERINDEXJOIN,
   INNERNLJOIN,
   INNERHASHJOIN,
+  HASHSEMIJOIN,
   PROJECTION,
   INSERT,
   DELETE,
@@ -1,9 +1,13 @@
 #pragma once
 
-#include "common/order_by_key.hpp"
 #include "sql/operator/physical_operator.h"
 #include "storage/common/chunk.h"
+#include "storage/common/top_n_sorter.h"
 
+/**
+ * @brief ORDER BY ... LIMIT n 的向量化实现，使用 TopNSorter 只保留前 n 行
+ * @ingroup PhysicalOperator
+ */
 class OrderByLimitVecPhysicalOperator : public PhysicalOperator
 {
 public:
@@ -22,6 +26,9 @@ private:
   vector<unique_ptr<Expression>> order_by_exprs_;
   vector<bool>                   asc_;
   int                            n_;
-  __order_by::RowHeap            rows_;
+  unique_ptr<TopNSorter>         sorter_;
+  ColumnMemoryPool               memory_pool_;  /// 排序键列的内存，先于 keys_chunk_ 声明，在它之后析构
   Chunk                          chunk_;
-};
\ No newline at end of file
+  Chunk                          keys_chunk_;  /// 排序键列在各个 chunk 之间复用
+  Chunk                          output_chunk_;
+};
@@ -1,13 +1,22 @@
 #pragma once
 
-#include "common/order_by_key.hpp"
 #include "sql/operator/physical_operator.h"
 #include "storage/common/chunk.h"
+#include "storage/common/external_sorter.h"
 
+/**
+ * @brief Order By 物理算子(vectorized)
+ * @details 使用 ExternalSorter 排序，内存不足时溢出到磁盘。结果按 chunk 分批输出
+ * @ingroup PhysicalOperator
+ */
 class OrderByVecPhysicalOperator : public PhysicalOperator
 {
 public:
-  OrderByVecPhysicalOperator(vector<unique_ptr<Expression>> &&order_by_exprs, vector<bool> &&asc);
+  /**
+   * @param memory_limit 排序可以使用的内存（字节），超过后溢出到磁盘。0 表示不限制
+   */
+  OrderByVecPhysicalOperator(
+      vector<unique_ptr<Expression>> &&order_by_exprs, vector<bool> &&asc, size_t memory_limit = 0);
   virtual ~OrderByVecPhysicalOperator() = default;
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::ORDER_BY_VEC; }
@@ -21,6 +30,10 @@ public:
 private:
   vector<unique_ptr<Expression>> order_by_exprs_;
   vector<bool>                   asc_;
-  __order_by::Rows               rows_;
-  Chunk chunk_;
+  size_t                         memory_limit_ = 0;
+  unique_ptr<ExternalSorter>     sorter_;
+  ColumnMemoryPool               memory_pool_;  /// 排序键列的内存，先于 keys_chunk_ 声明，在它之后析构
+  Chunk                          chunk_;
+  Chunk                          keys_chunk_;  /// 排序键列在各个 chunk 之间复用
+  Chunk                          output_chunk_;
 };
\ No newline at end of file
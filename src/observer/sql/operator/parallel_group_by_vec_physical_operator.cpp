@@ -0,0 +1,225 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <unistd.h>
+
+#include "sql/operator/parallel_group_by_vec_physical_operator.h"
+#include "common/lang/thread.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+ParallelGroupByVecPhysicalOperator::ParallelGroupByVecPhysicalOperator(vector<unique_ptr<Expression>> &&group_by_exprs,
+    vector<Expression *> &&expressions, shared_ptr<MorselScheduler> scheduler)
+    : group_by_exprs_(std::move(group_by_exprs)),
+      aggregate_expressions_(std::move(expressions)),
+      scheduler_(std::move(scheduler))
+{
+  for (size_t i = 0; i < group_by_exprs_.size(); ++i) {
+    output_chunk_.add_column(
+        make_unique<Column>(group_by_exprs_[i]->value_type(), group_by_exprs_[i]->value_length()), i);
+  }
+  for (size_t i = 0; i < aggregate_expressions_.size(); ++i) {
+    output_chunk_.add_column(
+        make_unique<Column>(aggregate_expressions_[i]->value_type(), aggregate_expressions_[i]->value_length()),
+        group_by_exprs_.size() + i);
+  }
+}
+
+string ParallelGroupByVecPhysicalOperator::param() const { return "degree=" + to_string(children_.size()); }
+
+size_t ParallelGroupByVecPhysicalOperator::local_table_limit()
+{
+  // 取不到 L2 的大小时按 1MB 计算
+  static const size_t l2_size = [] {
+    long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return size > 0 ? static_cast<size_t>(size) : size_t(1024 * 1024);
+  }();
+  return l2_size;
+}
+
+RC ParallelGroupByVecPhysicalOperator::open(Trx *trx)
+{
+  count_open();
+  const int workers = static_cast<int>(children_.size());
+  trx_              = trx;
+  scheduler_->reset();
+  partials_.clear();
+  partials_.resize(workers);
+  partition_tables_.clear();
+  partition_tables_.resize(PARTITION_NUM);
+  next_partition_.store(0);
+  scan_partition_ = 0;
+  scanner_.reset();
+
+  // 第一阶段：每个线程执行一条流水线并预聚合
+  vector<RC>     results(workers, RC::SUCCESS);
+  vector<thread> threads;
+  for (int i = 0; i < workers; i++) {
+    threads.emplace_back([this, i, &results]() { results[i] = pre_aggregate(i); });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  threads.clear();
+  for (RC rc : results) {
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  // 第二阶段：并行合并各个分区
+  for (int i = 0; i < workers; i++) {
+    threads.emplace_back([this, i, &results]() { results[i] = merge_partitions(); });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  partials_.clear();
+  for (RC rc : results) {
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  LOG_TRACE("parallel group by finished. workers=%d", workers);
+  return RC::SUCCESS;
+}
+
+RC ParallelGroupByVecPhysicalOperator::pre_aggregate(int index)
+{
+  PhysicalOperator &pipeline = *children_[index];
+  RC                rc       = pipeline.open(trx_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open pipeline. index=%d, rc=%s", index, strrc(rc));
+    return rc;
+  }
+
+  const size_t limit = local_table_limit();
+  auto         table = make_unique<VectorizedAggregateHashTable>(aggregate_expressions_);
+  Chunk        chunk;
+  while (OB_SUCC(rc = pipeline.next(chunk))) {
+    if (chunk.selected_rows() == 0) {
+      continue;
+    }
+    Chunk groups_chunk, aggrs_chunk;
+    for (size_t i = 0; i < group_by_exprs_.size(); ++i) {
+      auto column = make_unique<Column>(chunk.memory_pool());
+      group_by_exprs_[i]->get_column(chunk, *column);
+      groups_chunk.add_column(std::move(column), i);
+    }
+    for (size_t i = 0; i < aggregate_expressions_.size(); ++i) {
+      auto column = make_unique<Column>(chunk.memory_pool());
+      static_cast<AggregateExpr *>(aggregate_expressions_[i])->child()->get_column(chunk, *column);
+      aggrs_chunk.add_column(std::move(column), i);
+    }
+    if (chunk.has_selection()) {
+      groups_chunk.set_selection(chunk.selection());
+      aggrs_chunk.set_selection(chunk.selection());
+      if (OB_FAIL(rc = groups_chunk.compact()) || OB_FAIL(rc = aggrs_chunk.compact())) {
+        LOG_WARN("failed to compact chunk. rc=%s", strrc(rc));
+        break;
+      }
+    }
+    if (OB_FAIL(rc = table->add_chunk(groups_chunk, aggrs_chunk))) {
+      LOG_WARN("failed to update aggregate state. rc=%s", strrc(rc));
+      break;
+    }
+    if (table->memory_usage() > limit) {
+      flush(std::move(table), partials_[index]);
+      table = make_unique<VectorizedAggregateHashTable>(aggregate_expressions_);
+    }
+  }
+  pipeline.close();
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to pre-aggregate. index=%d, rc=%s", index, strrc(rc));
+    return rc;
+  }
+
+  if (table->group_count() > 0) {
+    flush(std::move(table), partials_[index]);
+  }
+  LOG_TRACE("pre-aggregation finished. index=%d, partial tables=%d", index, partials_[index].size());
+  return RC::SUCCESS;
+}
+
+void ParallelGroupByVecPhysicalOperator::flush(
+    unique_ptr<VectorizedAggregateHashTable> table, vector<PartialTable> &partials)
+{
+  PartialTable partial;
+  partial.partitions.resize(PARTITION_NUM);
+  for (int group = 0; group < table->group_count(); group++) {
+    partial.partitions[partition_of(table->group_hash(group))].push_back(group);
+  }
+  partial.table = std::move(table);
+  partials.push_back(std::move(partial));
+}
+
+RC ParallelGroupByVecPhysicalOperator::merge_partitions()
+{
+  RC rc = RC::SUCCESS;
+  for (int partition = next_partition_.fetch_add(1); partition < PARTITION_NUM;
+       partition     = next_partition_.fetch_add(1)) {
+    unique_ptr<VectorizedAggregateHashTable> table;
+    for (const vector<PartialTable> &partials : partials_) {
+      for (const PartialTable &partial : partials) {
+        const vector<int> &groups = partial.partitions[partition];
+        if (groups.empty()) {
+          continue;
+        }
+        if (table == nullptr) {
+          table = make_unique<VectorizedAggregateHashTable>(aggregate_expressions_);
+        }
+        if (OB_FAIL(rc = table->merge(*partial.table, groups))) {
+          LOG_WARN("failed to merge partial aggregation. partition=%d, rc=%s", partition, strrc(rc));
+          return rc;
+        }
+      }
+    }
+    partition_tables_[partition] = std::move(table);
+  }
+  return rc;
+}
+
+RC ParallelGroupByVecPhysicalOperator::next(Chunk &chunk)
+{
+  while (scan_partition_ < PARTITION_NUM) {
+    if (scanner_ == nullptr) {
+      VectorizedAggregateHashTable *table = partition_tables_[scan_partition_].get();
+      if (table == nullptr) {
+        scan_partition_++;
+        continue;
+      }
+      scanner_ = make_unique<VectorizedAggregateHashTable::Scanner>(table);
+      scanner_->open_scan();
+    }
+
+    output_chunk_.reset_data();
+    RC rc = scanner_->next(output_chunk_);
+    if (rc == RC::RECORD_EOF) {
+      scanner_.reset();
+      partition_tables_[scan_partition_].reset();
+      scan_partition_++;
+      continue;
+    }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    return count_rows(chunk.reference(output_chunk_), chunk);
+  }
+  return RC::RECORD_EOF;
+}
+
+RC ParallelGroupByVecPhysicalOperator::close()
+{
+  scanner_.reset();
+  partials_.clear();
+  partition_tables_.clear();
+  return RC::SUCCESS;
+}
@@ -0,0 +1,84 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/atomic.h"
+#include "sql/expr/aggregate_hash_table.h"
+#include "sql/operator/physical_operator.h"
+#include "storage/common/chunk.h"
+#include "storage/record/morsel_scheduler.h"
+
+/**
+ * @brief 并行的两阶段 Group By 物理算子(Vectorized)
+ * @ingroup PhysicalOperator
+ * @details 每个子算子是一条流水线，由一个工作线程执行。
+ * 第一阶段（预聚合）：每个线程把流水线的输出聚合到线程私有的 VectorizedAggregateHashTable 中，
+ * 哈希表的大小限制在 L2 缓存以内。哈希表满了之后，按分组键哈希值的高 PARTITION_BITS 位把其中的分组
+ * 划分到各个分区，交给第二阶段，线程换一个新的哈希表继续聚合。分组数少时，每个线程只有一个哈希表，
+ * 绝大部分行在第一阶段就聚合完了；分组数多时预聚合的效果有限，主要依靠第二阶段并行合并。
+ * 第二阶段（合并）：各个线程按分区领取任务，把所有部分结果中属于这个分区的分组合并到分区的哈希表中。
+ * 同一个分组总是落在同一个分区，分区之间没有重复的分组，合并时不需要加锁。
+ *
+ * 两个阶段都在 open 中完成，next 依次输出各个分区的结果。
+ */
+class ParallelGroupByVecPhysicalOperator : public PhysicalOperator
+{
+public:
+  ParallelGroupByVecPhysicalOperator(vector<unique_ptr<Expression>> &&group_by_exprs,
+      vector<Expression *> &&expressions, shared_ptr<MorselScheduler> scheduler);
+
+  virtual ~ParallelGroupByVecPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::PARALLEL_GROUP_BY_VEC; }
+
+  string param() const override;
+
+  RC open(Trx *trx) override;
+  RC next(Chunk &chunk) override;
+  RC close() override;
+
+  /// 线程私有的哈希表可以使用的内存（字节），取 L2 缓存的大小
+  static size_t local_table_limit();
+
+  static constexpr int PARTITION_BITS = 6;
+  static constexpr int PARTITION_NUM  = 1 << PARTITION_BITS;
+
+private:
+  /// 第一阶段一个线程交出来的部分结果
+  struct PartialTable
+  {
+    unique_ptr<VectorizedAggregateHashTable> table;
+    vector<vector<int>>                      partitions;  ///< 每个分区中的分组编号
+  };
+
+  /// 第一阶段，第 index 个线程执行流水线并预聚合
+  RC pre_aggregate(int index);
+  /// 把哈希表中的分组划分到各个分区，加入 partials
+  void flush(unique_ptr<VectorizedAggregateHashTable> table, vector<PartialTable> &partials);
+  /// 第二阶段，领取分区并合并
+  RC merge_partitions();
+
+  static int partition_of(uint64_t hash) { return static_cast<int>(hash >> (64 - PARTITION_BITS)); }
+
+private:
+  vector<unique_ptr<Expression>> group_by_exprs_;
+  vector<Expression *>           aggregate_expressions_;
+  shared_ptr<MorselScheduler>    scheduler_;
+  Trx                           *trx_ = nullptr;
+
+  vector<vector<PartialTable>>                     partials_;  ///< 每个线程的部分结果
+  vector<unique_ptr<VectorizedAggregateHashTable>> partition_tables_;
+  atomic<int>                                      next_partition_{0};
+
+  int                                               scan_partition_ = 0;
+  unique_ptr<VectorizedAggregateHashTable::Scanner> scanner_;
+  Chunk                                             output_chunk_;
+};
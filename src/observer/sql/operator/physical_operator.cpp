@@ -13,6 +13,8 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/physical_operator.h"
+#include "sql/expr/expression.h"
+#include "sql/expr/expression_iterator.h"
 
 string physical_operator_type_name(PhysicalOperatorType type)
 {
@@ -40,6 +42,9 @@ string physical_operator_type_name(PhysicalOperatorType type)
     case PhysicalOperatorType::LIMIT_VEC: return "LIMIT_VEC";
     case PhysicalOperatorType::ORDER_BY_LIMIT_VEC: return "ORDER_BY_LIMIT_VEC";
     case PhysicalOperatorType::CREATE_MATERIALIZED_VIEW: return "CREATE_MATERIALIZED_VIEW";
+    case PhysicalOperatorType::GATHER_VEC: return "GATHER_VEC";
+    case PhysicalOperatorType::PARALLEL_GROUP_BY_VEC: return "PARALLEL_GROUP_BY_VEC";
+    case PhysicalOperatorType::PIPELINE_VEC: return "PIPELINE_VEC";
     default: return "UNKNOWN";    
   }
 }
@@ -47,3 +52,15 @@ string physical_operator_type_name(PhysicalOperatorType type)
 string PhysicalOperator::name() const { return physical_operator_type_name(type()); }
 
 string PhysicalOperator::param() const { return ""; }
+
+void PhysicalOperator::collect_expression_constants(Expression &expr, vector<Value *> &constants)
+{
+  if (expr.type() == ExprType::VALUE) {
+    constants.push_back(&static_cast<ValueExpr &>(expr).get_value());
+    return;
+  }
+  ExpressionIterator::iterate_child_expr(expr, [&constants](unique_ptr<Expression> &child) {
+    collect_expression_constants(*child, constants);
+    return RC::SUCCESS;
+  });
+}
@@ -56,7 +56,10 @@ enum class PhysicalOperatorType
   ORDER_BY_VEC,
   LIMIT_VEC,
   CREATE_MATERIALIZED_VIEW,
-  ORDER_BY_LIMIT_VEC
+  ORDER_BY_LIMIT_VEC,
+  GATHER_VEC,
+  PARALLEL_GROUP_BY_VEC,
+  PIPELINE_VEC
 };
 
 /**
@@ -94,6 +97,82 @@ public:
 
   vector<unique_ptr<PhysicalOperator>> &children() { return children_; }
 
+  /**
+   * @brief 收集当前算子（不包含子算子）中的常量，执行计划缓存修改这些常量后重新执行计划
+   * @details 返回 false 表示算子不能在修改常量后重新打开执行，包含这种算子的计划不会被缓存
+   * @param constants 来自SQL中常量的值
+   * @param copies 从其它常量复制出来的值，比如索引扫描的范围复制自过滤条件中的常量
+   */
+  virtual bool collect_constants(vector<Value *> &constants, vector<Value *> &copies) { return false; }
+
+  /**
+   * @brief 记录优化器估算的输出行数与代价（包含子算子的代价），在 explain 中输出
+   */
+  void set_estimate(double rows, double cost)
+  {
+    estimated_rows_ = rows;
+    estimated_cost_ = cost;
+  }
+  bool   has_estimate() const { return estimated_rows_ >= 0; }
+  double estimated_rows() const { return estimated_rows_; }
+  double estimated_cost() const { return estimated_cost_; }
+
+  /**
+   * @brief 实际执行时的统计，在 explain analyze 中与估算的行数一起输出
+   * @details loops 是算子被打开的次数，比如嵌套循环连接的右子算子对左表的每一行都会重新打开一次；
+   * rows 是所有次数输出的行数之和。只有调用过 enable_actual 的算子才会统计
+   */
+  bool    has_actual() const { return actual_loops_ > 0; }
+  int64_t actual_loops() const { return actual_loops_; }
+  int64_t actual_rows() const { return actual_rows_; }
+
+  /**
+   * @brief 开启当前算子及所有子算子的实际执行统计，explain analyze 在执行前调用
+   * @details 普通查询不开启，count_open/count_rows 只检查一个标记
+   */
+  virtual void enable_actual()
+  {
+    collect_actual_ = true;
+    for (unique_ptr<PhysicalOperator> &child : children_) {
+      child->enable_actual();
+    }
+  }
+
+protected:
+  /// 收集表达式树中所有 ValueExpr 的值
+  static void collect_expression_constants(Expression &expr, vector<Value *> &constants);
+
+  /// 在 open 中调用
+  void count_open()
+  {
+    if (collect_actual_) {
+      actual_loops_++;
+    }
+  }
+  /// 在 next 返回前调用，成功时计入输出的行数
+  RC count_rows(RC rc)
+  {
+    if (collect_actual_ && rc == RC::SUCCESS) {
+      actual_rows_++;
+    }
+    return rc;
+  }
+  RC count_rows(RC rc, const Chunk &chunk)
+  {
+    if (collect_actual_ && rc == RC::SUCCESS) {
+      actual_rows_ += chunk.selected_rows();
+    }
+    return rc;
+  }
+
 protected:
   vector<unique_ptr<PhysicalOperator>> children_;
+
+  double estimated_rows_ = -1;  ///< 没有经过基于代价的优化时为负数
+  double estimated_cost_ = 0;
+
+  /// 并行执行时每个线程驱动自己的算子实例，同一个算子不会被并发地 open/next，计数不需要原子操作
+  bool    collect_actual_ = false;
+  int64_t actual_loops_   = 0;
+  int64_t actual_rows_    = 0;
 };
@@ -0,0 +1,370 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/pipeline.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/functional.h"
+#include "common/lang/thread.h"
+#include "common/log/log.h"
+#include "sql/operator/aggregate_vec_physical_operator.h"
+#include "sql/operator/expr_vec_physical_operator.h"
+#include "sql/operator/gather_vec_physical_operator.h"
+#include "sql/operator/group_by_vec_physical_operator.h"
+#include "sql/operator/pipeline_vec_physical_operator.h"
+#include "storage/record/morsel_scheduler.h"
+
+using namespace std;
+
+// ----------------------------------ExprPipelineStage------------------
+
+RC ExprPipelineStage::open()
+{
+  programs_.clear();
+  programs_.resize(expressions_.size());
+  for (size_t i = 0; i < expressions_.size(); i++) {
+    programs_[i].compile_value(expressions_[i]);
+  }
+  return RC::SUCCESS;
+}
+
+RC ExprPipelineStage::execute(Chunk &chunk)
+{
+  if (evaled_chunk_.column_num() != static_cast<int>(expressions_.size())) {
+    evaled_chunk_.reset();
+    evaled_chunk_.set_memory_pool(&memory_pool_);
+    for (size_t i = 0; i < expressions_.size(); i++) {
+      evaled_chunk_.add_column(make_unique<Column>(&memory_pool_), i);
+    }
+  }
+  for (size_t i = 0; i < expressions_.size(); i++) {
+    RC rc = programs_[i].get_column(chunk, evaled_chunk_.column(i));
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to calculate expression. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  // 计算结果与输入按行对齐，沿用输入的选择向量
+  if (chunk.has_selection()) {
+    evaled_chunk_.set_selection(chunk.selection());
+  } else {
+    evaled_chunk_.clear_selection();
+  }
+  return chunk.reference(evaled_chunk_);
+}
+
+// ----------------------------------Pipeline------------------
+
+Pipeline::Pipeline(PipelineSink *sink, string sink_name) : sink_(sink), sink_name_(std::move(sink_name)) {}
+
+Pipeline::~Pipeline() = default;
+
+void Pipeline::add_driver(unique_ptr<PhysicalOperator> source, vector<unique_ptr<PipelineStage>> stages)
+{
+  auto driver    = make_unique<Driver>();
+  driver->source = std::move(source);
+  driver->stages = std::move(stages);
+  driver->stage_rows.resize(driver->stages.size(), 0);
+  drivers_.emplace_back(std::move(driver));
+}
+
+RC Pipeline::open_driver(Driver &driver, Trx *trx)
+{
+  RC rc = driver.source->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open pipeline source. rc=%s", strrc(rc));
+    return rc;
+  }
+  for (unique_ptr<PipelineStage> &stage : driver.stages) {
+    if (OB_FAIL(rc = stage->open())) {
+      LOG_WARN("failed to open pipeline stage %s. rc=%s", stage->name().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+  return rc;
+}
+
+RC Pipeline::execute_stages(Driver &driver, Chunk &chunk)
+{
+  RC rc = RC::SUCCESS;
+  for (size_t i = 0; i < driver.stages.size(); i++) {
+    if (OB_FAIL(rc = driver.stages[i]->execute(chunk))) {
+      return rc;
+    }
+    if (collect_actual_) {
+      driver.stage_rows[i] += chunk.selected_rows();
+    }
+  }
+  return rc;
+}
+
+RC Pipeline::run_driver(Driver &driver, Trx *trx)
+{
+  RC rc = open_driver(driver, trx);
+  while (OB_SUCC(rc)) {
+    Chunk &chunk = driver.chunk;
+    if (OB_FAIL(rc = driver.source->next(chunk))) {
+      break;
+    }
+    if (chunk.selected_rows() == 0) {
+      continue;
+    }
+    if (OB_FAIL(rc = execute_stages(driver, chunk))) {
+      break;
+    }
+    if (collect_actual_) {
+      driver.sink_rows += chunk.selected_rows();
+    }
+    if (driver.local_sink != nullptr) {
+      rc = driver.local_sink->sink(chunk);
+    } else if (driver_num() > 1) {
+      lock_guard<mutex> guard(sink_lock_);
+      rc = sink_->sink(chunk);
+    } else {
+      rc = sink_->sink(chunk);
+    }
+  }
+  driver.source->close();
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
+RC Pipeline::run(Trx *trx)
+{
+  ASSERT(sink_ != nullptr, "pipeline without a sink cannot run");
+  if (scheduler_ != nullptr) {
+    scheduler_->reset();
+  }
+
+  RC rc = RC::SUCCESS;
+  if (driver_num() == 1) {
+    rc = run_driver(*drivers_.front(), trx);
+  } else {
+    for (unique_ptr<Driver> &driver : drivers_) {
+      driver->local_sink = sink_->create_local_sink();
+    }
+    vector<RC>     results(drivers_.size(), RC::SUCCESS);
+    vector<thread> threads;
+    for (size_t i = 0; i < drivers_.size(); i++) {
+      threads.emplace_back([this, i, trx, &results]() { results[i] = run_driver(*drivers_[i], trx); });
+    }
+    for (thread &t : threads) {
+      t.join();
+    }
+    for (RC result : results) {
+      if (OB_FAIL(result)) {
+        rc = result;
+        break;
+      }
+    }
+    if (OB_SUCC(rc)) {
+      rc = merge_local_sinks();
+    }
+    for (unique_ptr<Driver> &driver : drivers_) {
+      driver->local_sink.reset();
+    }
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to run pipeline %s. rc=%s", to_string().c_str(), strrc(rc));
+    return rc;
+  }
+  return sink_->finalize();
+}
+
+RC Pipeline::merge_local_sinks()
+{
+  RC rc = RC::SUCCESS;
+  for (unique_ptr<Driver> &driver : drivers_) {
+    if (driver->local_sink == nullptr) {
+      continue;
+    }
+    if (OB_FAIL(rc = sink_->merge(*driver->local_sink))) {
+      LOG_WARN("failed to merge local sink of pipeline %s. rc=%s", to_string().c_str(), strrc(rc));
+      return rc;
+    }
+  }
+  return rc;
+}
+
+RC Pipeline::open(Trx *trx)
+{
+  ASSERT(sink_ == nullptr && driver_num() == 1, "only the output pipeline can be pulled");
+  return open_driver(*drivers_.front(), trx);
+}
+
+RC Pipeline::next(Chunk &chunk)
+{
+  Driver &driver = *drivers_.front();
+  RC      rc     = RC::SUCCESS;
+  do {
+    if (OB_FAIL(rc = driver.source->next(driver.chunk))) {
+      return rc;
+    }
+  } while (driver.chunk.selected_rows() == 0);
+
+  if (OB_FAIL(rc = execute_stages(driver, driver.chunk))) {
+    return rc;
+  }
+  return chunk.reference(driver.chunk);
+}
+
+RC Pipeline::close()
+{
+  if (drivers_.empty()) {
+    return RC::SUCCESS;
+  }
+  return drivers_.front()->source->close();
+}
+
+void Pipeline::enable_actual()
+{
+  collect_actual_ = true;
+  for (unique_ptr<Driver> &driver : drivers_) {
+    driver->source->enable_actual();
+  }
+}
+
+string Pipeline::to_string() const
+{
+  // 所有实例的行数之和
+  auto actual = [this](const function<int64_t(const Driver &)> &rows) -> string {
+    if (!collect_actual_) {
+      return "";
+    }
+    int64_t total = 0;
+    for (const unique_ptr<Driver> &driver : drivers_) {
+      total += rows(*driver);
+    }
+    return "(actual_rows=" + std::to_string(total) + ")";
+  };
+
+  string result;
+  if (!drivers_.empty()) {
+    const Driver &driver = *drivers_.front();
+    result += driver.source->name() + actual([](const Driver &d) { return d.source->actual_rows(); });
+    for (size_t i = 0; i < driver.stages.size(); i++) {
+      result += " -> " + driver.stages[i]->name() + actual([i](const Driver &d) { return d.stage_rows[i]; });
+    }
+  }
+  if (sink_ != nullptr) {
+    result += " -> " + sink_name_ + actual([](const Driver &d) { return d.sink_rows; });
+  }
+  if (driver_num() > 1) {
+    result += " x" + std::to_string(driver_num());
+  }
+  return result;
+}
+
+// ----------------------------------PipelineBuilder------------------
+
+bool PipelineBuilder::is_stage(const PhysicalOperator &oper) { return oper.type() == PhysicalOperatorType::EXPR_VEC; }
+
+PipelineSink *PipelineBuilder::as_sink(PhysicalOperator &oper)
+{
+  switch (oper.type()) {
+    case PhysicalOperatorType::GROUP_BY_VEC: return static_cast<GroupByVecPhysicalOperator *>(&oper);
+    case PhysicalOperatorType::AGGREGATE_VEC: return static_cast<AggregateVecPhysicalOperator *>(&oper);
+    default: return nullptr;
+  }
+}
+
+RC PipelineBuilder::build(unique_ptr<PhysicalOperator> &oper)
+{
+  RC rc = convert(oper);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to build pipelines. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+RC PipelineBuilder::convert(unique_ptr<PhysicalOperator> &oper)
+{
+  RC rc = RC::SUCCESS;
+  if (!is_stage(*oper) && (as_sink(*oper) == nullptr || oper->children().empty())) {
+    // 拉取方式的算子保持不变，继续转换子树
+    for (unique_ptr<PhysicalOperator> &child : oper->children()) {
+      if (OB_FAIL(rc = convert(child))) {
+        return rc;
+      }
+    }
+    return rc;
+  }
+
+  vector<unique_ptr<Pipeline>>      pipelines;
+  unique_ptr<PhysicalOperator>      source;
+  vector<unique_ptr<PipelineStage>> stages;
+  if (OB_FAIL(rc = build_driver(std::move(oper), source, stages, pipelines))) {
+    return rc;
+  }
+  auto output = make_unique<Pipeline>();
+  output->add_driver(std::move(source), std::move(stages));
+  oper = make_unique<PipelineVecPhysicalOperator>(std::move(pipelines), std::move(output));
+  return rc;
+}
+
+RC PipelineBuilder::build_driver(unique_ptr<PhysicalOperator> oper, unique_ptr<PhysicalOperator> &source,
+    vector<unique_ptr<PipelineStage>> &stages, vector<unique_ptr<Pipeline>> &pipelines)
+{
+  // 算子链从上往下遍历，处理阶段的执行顺序是从下往上
+  while (is_stage(*oper)) {
+    auto *expr_oper = static_cast<ExprVecPhysicalOperator *>(oper.get());
+    stages.emplace_back(make_unique<ExprPipelineStage>(expr_oper->expressions()));
+    ASSERT(oper->children().size() == 1, "expression operator should have 1 child");
+    unique_ptr<PhysicalOperator> child = std::move(oper->children().front());
+    oper                               = std::move(child);
+  }
+  std::reverse(stages.begin(), stages.end());
+
+  RC            rc   = RC::SUCCESS;
+  PipelineSink *sink = as_sink(*oper);
+  if (sink != nullptr && !oper->children().empty()) {
+    rc = build_sink_pipeline(*oper, *sink, pipelines);
+  } else {
+    for (unique_ptr<PhysicalOperator> &child : oper->children()) {
+      if (OB_FAIL(rc = convert(child))) {
+        break;
+      }
+    }
+  }
+  source = std::move(oper);
+  return rc;
+}
+
+RC PipelineBuilder::build_sink_pipeline(
+    PhysicalOperator &breaker, PipelineSink &sink, vector<unique_ptr<Pipeline>> &pipelines)
+{
+  ASSERT(breaker.children().size() == 1, "pipeline breaker should have 1 child");
+  unique_ptr<PhysicalOperator> child = std::move(breaker.children().front());
+  breaker.children().clear();
+
+  vector<unique_ptr<PhysicalOperator>> driver_roots;
+  auto                                 pipeline = make_unique<Pipeline>(&sink, breaker.name());
+  if (child->type() == PhysicalOperatorType::GATHER_VEC) {
+    // 并行扫描的每条子流水线直接推给中断点
+    auto *gather = static_cast<GatherVecPhysicalOperator *>(child.get());
+    pipeline->set_scheduler(gather->scheduler());
+    for (unique_ptr<PhysicalOperator> &root : gather->children()) {
+      driver_roots.emplace_back(std::move(root));
+    }
+  } else {
+    driver_roots.emplace_back(std::move(child));
+  }
+
+  // 推给这个中断点的数据依赖更下层的流水线，下层的流水线先加入，先执行
+  RC rc = RC::SUCCESS;
+  for (unique_ptr<PhysicalOperator> &root : driver_roots) {
+    unique_ptr<PhysicalOperator>      source;
+    vector<unique_ptr<PipelineStage>> stages;
+    if (OB_FAIL(rc = build_driver(std::move(root), source, stages, pipelines))) {
+      return rc;
+    }
+    pipeline->add_driver(std::move(source), std::move(stages));
+  }
+  pipelines.emplace_back(std::move(pipeline));
+  return rc;
+}
@@ -0,0 +1,210 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/sys/rc.h"
+#include "sql/expr/expression_program.h"
+#include "storage/common/chunk.h"
+#include "storage/common/column_memory_pool.h"
+
+class PhysicalOperator;
+class MorselScheduler;
+class Trx;
+
+/**
+ * @defgroup Pipeline
+ * @brief 推模式(push-based)的流水线执行
+ * @details 火山模型中每个算子每处理一个 chunk 都要经过一次虚函数 next 调用，数据由上层算子逐层拉取。
+ * 流水线执行把执行计划在流水线中断点(pipeline breaker，比如聚合的构建阶段)处切开，每一段是一条流水线：
+ * 源头(source)产生 chunk，依次经过若干个融合在一起的处理阶段(stage)，最后推给中断点(sink)。
+ * 一条流水线在一个紧凑的循环中执行到底，中间不再经过算子树。
+ * 流水线也是并行调度的单位：源头是按 morsel 并行扫描时，同一条流水线的多个实例在多个线程中同时执行。
+ */
+
+/**
+ * @brief 流水线的中断点，接收流水线推送的数据
+ * @ingroup Pipeline
+ * @details 需要读完全部输入才能输出的算子（比如聚合）实现这个接口。构建阶段由流水线推送数据，
+ * 之后算子作为下一条流水线的源头，按原来的方式输出结果。
+ */
+class PipelineSink
+{
+public:
+  virtual ~PipelineSink() = default;
+
+  /**
+   * @brief 接收一个 chunk
+   * @details 同一条流水线的多个实例并行执行时，由流水线保证同一个 sink 对象上的 sink 不会被并发调用
+   */
+  virtual RC sink(Chunk &chunk) = 0;
+
+  /**
+   * @brief 为流水线的一个实例创建线程私有的 sink
+   * @details 多个实例并行执行时，每个实例推给自己的局部 sink，不需要加锁，全部执行完之后再通过 merge
+   * 合并到当前 sink 中。返回空表示不支持，所有实例加锁推给当前 sink。
+   */
+  virtual unique_ptr<PipelineSink> create_local_sink() { return nullptr; }
+
+  /**
+   * @brief 把 create_local_sink 创建的局部 sink 合并进来
+   * @details 在所有实例执行完之后、finalize 之前串行调用
+   */
+  virtual RC merge(PipelineSink &local) { return RC::UNIMPLEMENTED; }
+
+  /// 所有数据都推送完之后调用一次
+  virtual RC finalize() { return RC::SUCCESS; }
+};
+
+/**
+ * @brief 流水线中的一个处理阶段
+ * @ingroup Pipeline
+ * @details 处理阶段在原地转换 chunk：执行之后 chunk 引用阶段自己的输出。阶段的状态是线程私有的，
+ * 并行执行时每个流水线实例都有自己的阶段对象。
+ */
+class PipelineStage
+{
+public:
+  virtual ~PipelineStage() = default;
+
+  virtual string name() const = 0;
+
+  virtual RC open() { return RC::SUCCESS; }
+  virtual RC execute(Chunk &chunk) = 0;
+};
+
+/**
+ * @brief 计算表达式的阶段，输出的每一列是一个表达式的结果
+ * @ingroup Pipeline
+ * @details 与 ExprVecPhysicalOperator 相同，表达式编译成 ExpressionProgram 执行，结果列在 chunk 之间复用
+ */
+class ExprPipelineStage : public PipelineStage
+{
+public:
+  explicit ExprPipelineStage(vector<Expression *> expressions) : expressions_(std::move(expressions)) {}
+
+  string name() const override { return "EXPR"; }
+
+  RC open() override;
+  RC execute(Chunk &chunk) override;
+
+private:
+  vector<Expression *>      expressions_;
+  vector<ExpressionProgram> programs_;
+  ColumnMemoryPool          memory_pool_;  ///< 结果列的内存，先于 evaled_chunk_ 声明，在它之后析构
+  Chunk                     evaled_chunk_;
+};
+
+/**
+ * @brief 一条流水线
+ * @ingroup Pipeline
+ * @details 流水线有一个或多个实例(driver)，每个实例是一个源头算子加上一组处理阶段。源头算子可以是任意的
+ * 向量化物理算子，通过 open/next/close 读取，这样原有的算子不需要修改就可以作为流水线的源头。
+ *
+ * 有 sink 的流水线通过 run 执行到底；多个实例时每个实例一个线程，共享 MorselScheduler 领取页面，
+ * 每个实例推给自己的局部 sink，执行完之后依次合并到 sink 中。sink 不支持局部状态时，
+ * 所有实例直接推给 sink，需要加锁。
+ *
+ * 没有 sink 的流水线是整个查询的输出，只能有一个实例，由上层按拉取的方式通过 next 读取，
+ * 每次 next 从源头读取一个 chunk 并执行所有阶段。
+ */
+class Pipeline
+{
+public:
+  /**
+   * @param sink 为空表示这条流水线是查询的输出
+   * @param sink_name 中断点的名字，用于 EXPLAIN
+   */
+  explicit Pipeline(PipelineSink *sink = nullptr, string sink_name = "");
+  ~Pipeline();
+
+  void add_driver(unique_ptr<PhysicalOperator> source, vector<unique_ptr<PipelineStage>> stages);
+  void set_scheduler(shared_ptr<MorselScheduler> scheduler) { scheduler_ = std::move(scheduler); }
+
+  int driver_num() const { return static_cast<int>(drivers_.size()); }
+
+  /**
+   * @brief 执行流水线直到源头没有数据，所有数据推给 sink，最后调用 sink 的 finalize
+   */
+  RC run(Trx *trx);
+
+  /// 按拉取的方式读取没有 sink 的流水线
+  RC open(Trx *trx);
+  RC next(Chunk &chunk);
+  RC close();
+
+  /// 比如 TABLE_SCAN_VEC -> EXPR -> GROUP_BY_VEC，并行时在最后标注实例数。开启统计后每一段附带实际的行数
+  string to_string() const;
+
+  /// 开启实际执行统计：源头算子的统计，以及每个阶段输出、推给 sink 的行数
+  void enable_actual();
+
+private:
+  struct Driver
+  {
+    unique_ptr<PhysicalOperator>      source;
+    vector<unique_ptr<PipelineStage>> stages;
+    Chunk                             chunk;
+    unique_ptr<PipelineSink>          local_sink;  ///< 线程私有的 sink，为空时加锁推给 sink_
+    vector<int64_t>                   stage_rows;  ///< 每个阶段输出的行数，只在开启统计时更新
+    int64_t                           sink_rows = 0;
+  };
+
+  RC open_driver(Driver &driver, Trx *trx);
+  /// 一个实例的紧凑循环：读取、执行各个阶段、推给 sink
+  RC run_driver(Driver &driver, Trx *trx);
+  /// 把各个实例的局部 sink 合并到 sink_ 中
+  RC merge_local_sinks();
+  RC execute_stages(Driver &driver, Chunk &chunk);
+
+private:
+  PipelineSink               *sink_ = nullptr;
+  string                      sink_name_;
+  vector<unique_ptr<Driver>>  drivers_;
+  shared_ptr<MorselScheduler> scheduler_;
+  mutex                       sink_lock_;
+  bool                        collect_actual_ = false;
+};
+
+/**
+ * @brief 把向量化的物理执行计划切分成流水线
+ * @ingroup Pipeline
+ * @details 从上往下查找由 EXPR_VEC 与中断点（GROUP_BY_VEC、AGGREGATE_VEC）构成的算子链：
+ * EXPR_VEC 变成处理阶段，中断点的子树变成推数据给它的流水线，链条最下面的算子作为源头。
+ * 中断点下面是 GATHER_VEC 时，GATHER_VEC 的每条子流水线都变成同一条流水线的一个实例，直接推给中断点，
+ * 不再经过汇合算子的队列与拷贝。其它算子（排序、LIMIT、投影等）保持拉取的方式，子树继续被转换。
+ * 每个算子链被替换成一个 PipelineVecPhysicalOperator，对上层来说仍然是一个普通的算子。
+ */
+class PipelineBuilder
+{
+public:
+  static RC build(unique_ptr<PhysicalOperator> &oper);
+
+private:
+  static bool is_stage(const PhysicalOperator &oper);
+  static PipelineSink *as_sink(PhysicalOperator &oper);
+
+  static RC convert(unique_ptr<PhysicalOperator> &oper);
+
+  /**
+   * @brief 从 oper 开始拆出处理阶段与源头
+   * @param pipelines 源头是中断点时，推给它的流水线按执行的先后顺序加入其中
+   */
+  static RC build_driver(unique_ptr<PhysicalOperator> oper, unique_ptr<PhysicalOperator> &source,
+      vector<unique_ptr<PipelineStage>> &stages, vector<unique_ptr<Pipeline>> &pipelines);
+
+  /// 把中断点的子树变成推数据给它的流水线
+  static RC build_sink_pipeline(
+      PhysicalOperator &breaker, PipelineSink &sink, vector<unique_ptr<Pipeline>> &pipelines);
+};
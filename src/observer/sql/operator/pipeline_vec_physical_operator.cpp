@@ -0,0 +1,50 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/pipeline_vec_physical_operator.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+string PipelineVecPhysicalOperator::param() const
+{
+  string result;
+  for (size_t i = 0; i < pipelines_.size(); i++) {
+    result += "P" + to_string(i) + ": " + pipelines_[i]->to_string() + "; ";
+  }
+  result += "P" + to_string(pipelines_.size()) + ": " + output_->to_string();
+  return result;
+}
+
+void PipelineVecPhysicalOperator::enable_actual()
+{
+  PhysicalOperator::enable_actual();
+  for (unique_ptr<Pipeline> &pipeline : pipelines_) {
+    pipeline->enable_actual();
+  }
+  output_->enable_actual();
+}
+
+RC PipelineVecPhysicalOperator::open(Trx *trx)
+{
+  count_open();
+  RC rc = RC::SUCCESS;
+  for (unique_ptr<Pipeline> &pipeline : pipelines_) {
+    LOG_TRACE("run pipeline: %s", pipeline->to_string().c_str());
+    if (OB_FAIL(rc = pipeline->run(trx))) {
+      return rc;
+    }
+  }
+  return output_->open(trx);
+}
+
+RC PipelineVecPhysicalOperator::next(Chunk &chunk) { return count_rows(output_->next(chunk), chunk); }
+
+RC PipelineVecPhysicalOperator::close() { return output_->close(); }
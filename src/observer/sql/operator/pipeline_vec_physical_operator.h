@@ -0,0 +1,45 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/operator/physical_operator.h"
+#include "sql/operator/pipeline.h"
+
+/**
+ * @brief 把一组流水线包装成一个物理算子(Vectorized)
+ * @ingroup PhysicalOperator
+ * @details 上层的算子仍然按拉取的方式读取。open 时按顺序把依赖的流水线执行到底（数据推给各自的中断点），
+ * 之后每次 next 从输出流水线中读取一个 chunk。
+ */
+class PipelineVecPhysicalOperator : public PhysicalOperator
+{
+public:
+  PipelineVecPhysicalOperator(vector<unique_ptr<Pipeline>> &&pipelines, unique_ptr<Pipeline> output)
+      : pipelines_(std::move(pipelines)), output_(std::move(output))
+  {}
+
+  virtual ~PipelineVecPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::PIPELINE_VEC; }
+
+  string param() const override;
+
+  /// 流水线中的算子不在算子树中，需要单独开启统计
+  void enable_actual() override;
+
+  RC open(Trx *trx) override;
+  RC next(Chunk &chunk) override;
+  RC close() override;
+
+private:
+  vector<unique_ptr<Pipeline>> pipelines_;  ///< 按执行的先后顺序排列
+  unique_ptr<Pipeline>         output_;
+};
@@ -13,8 +13,20 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/predicate_logical_operator.h"
+#include "common/lang/cmath.h"
+#include "sql/optimizer/cascade/property.h"
+#include "sql/optimizer/cascade/selectivity.h"
 
 PredicateLogicalOperator::PredicateLogicalOperator(unique_ptr<Expression> expression)
 {
   expressions_.emplace_back(std::move(expression));
 }
+
+unique_ptr<LogicalProperty> PredicateLogicalOperator::find_log_prop(const vector<LogicalProperty *> &log_props)
+{
+  if (log_props.size() != 1 || log_props[0] == nullptr) {
+    return nullptr;
+  }
+  const double selectivity = SelectivityEstimator::estimate(expressions_);
+  return make_unique<LogicalProperty>(static_cast<int>(std::round(log_props[0]->get_card() * selectivity)));
+}
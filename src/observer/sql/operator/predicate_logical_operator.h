@@ -30,4 +30,6 @@ public:
   LogicalOperatorType type() const override { return LogicalOperatorType::PREDICATE; }
 
   OpType get_op_type() const override { return OpType::LOGICALFILTER; }
+
+  unique_ptr<LogicalProperty> find_log_prop(const vector<LogicalProperty *> &log_props) override;
 };
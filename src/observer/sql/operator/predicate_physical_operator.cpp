@@ -25,6 +25,7 @@ PredicatePhysicalOperator::PredicatePhysicalOperator(std::unique_ptr<Expression>
 
 RC PredicatePhysicalOperator::open(Trx *trx)
 {
+  count_open();
   if (children_.size() != 1) {
     LOG_WARN("predicate operator must has one child");
     return RC::INTERNAL;
@@ -53,7 +54,7 @@ RC PredicatePhysicalOperator::next()
     }
 
     if (value.get_boolean()) {
-      return rc;
+      return count_rows(rc);
     }
   }
   return rc;
@@ -65,6 +66,12 @@ RC PredicatePhysicalOperator::close()
   return RC::SUCCESS;
 }
 
+bool PredicatePhysicalOperator::collect_constants(vector<Value *> &constants, vector<Value *> &copies)
+{
+  collect_expression_constants(*expression_, constants);
+  return true;
+}
+
 Tuple *PredicatePhysicalOperator::current_tuple() { return children_[0]->current_tuple(); }
 
 RC PredicatePhysicalOperator::tuple_schema(TupleSchema &schema) const
@@ -39,6 +39,8 @@ public:
 
   Tuple *current_tuple() override;
 
+  bool collect_constants(vector<Value *> &constants, vector<Value *> &copies) override;
+
   RC tuple_schema(TupleSchema &schema) const override;
 
 private:
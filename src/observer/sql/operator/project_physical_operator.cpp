@@ -26,6 +26,7 @@ ProjectPhysicalOperator::ProjectPhysicalOperator(vector<unique_ptr<Expression>>
 
 RC ProjectPhysicalOperator::open(Trx *trx)
 {
+  count_open();
   if (children_.empty()) {
     return RC::SUCCESS;
   }
@@ -45,7 +46,7 @@ RC ProjectPhysicalOperator::next()
   if (children_.empty()) {
     return RC::RECORD_EOF;
   }
-  return children_[0]->next();
+  return count_rows(children_[0]->next());
 }
 
 RC ProjectPhysicalOperator::close()
@@ -61,6 +62,16 @@ Tuple *ProjectPhysicalOperator::current_tuple()
   return &tuple_;
 }
 
+bool ProjectPhysicalOperator::collect_constants(vector<Value *> &constants, vector<Value *> &copies)
+{
+  // 输出的列名是表达式的原始文本，包含常量时换了常量列名就不对了
+  vector<Value *> expression_constants;
+  for (unique_ptr<Expression> &expression : expressions_) {
+    collect_expression_constants(*expression, expression_constants);
+  }
+  return expression_constants.empty();
+}
+
 RC ProjectPhysicalOperator::tuple_schema(TupleSchema &schema) const
 {
   for (const unique_ptr<Expression> &expression : expressions_) {
@@ -26,6 +26,7 @@ ProjectVecPhysicalOperator::ProjectVecPhysicalOperator(vector<unique_ptr<Express
 }
 RC ProjectVecPhysicalOperator::open(Trx *trx)
 {
+  count_open();
   if (children_.empty()) {
     return RC::SUCCESS;
   }
@@ -53,7 +54,7 @@ RC ProjectVecPhysicalOperator::next(Chunk &chunk)
     LOG_WARN("failed to get next tuple: %s", strrc(rc));
     return rc;
   }
-  return rc;
+  return count_rows(rc, chunk);
 }
 
 RC ProjectVecPhysicalOperator::close()
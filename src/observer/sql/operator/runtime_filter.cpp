@@ -0,0 +1,207 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/runtime_filter.h"
+#include "common/lang/functional.h"
+#include "common/lang/string_view.h"
+#include "common/log/log.h"
+#include "sql/expr/tuple.h"
+
+using namespace std;
+
+namespace {
+bool is_integer(AttrType type) { return type == AttrType::INTS || type == AttrType::BIGINTS; }
+
+/// std::hash 对整数可能是恒等映射，再打散一次，高位用来选择块，低位用来选择块内的位
+uint64_t hash_key(const string &key)
+{
+  uint64_t result = std::hash<string_view>()(key);
+  result ^= result >> 33;
+  result *= 0xff51afd7ed558ccdULL;
+  result ^= result >> 33;
+  result *= 0xc4ceb9fe1a85ec53ULL;
+  result ^= result >> 33;
+  return result;
+}
+}  // namespace
+
+void BlockedBloomFilter::init(size_t expected_keys)
+{
+  // 每个块 512 位，每个键 16 位时误判率在 0.1% 左右
+  size_t block_num = 1;
+  while (block_num * 32 < expected_keys) {
+    block_num <<= 1;
+  }
+  blocks_.assign(block_num, Block{});
+}
+
+uint64_t BlockedBloomFilter::mask(uint64_t hash, int i)
+{
+  static constexpr uint32_t SALTS[WORDS_PER_BLOCK] = {
+      0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+  return 1ULL << ((static_cast<uint32_t>(hash) * SALTS[i]) >> 26);
+}
+
+void BlockedBloomFilter::insert(uint64_t hash)
+{
+  Block &target = blocks_[block_index(hash)];
+  for (int i = 0; i < WORDS_PER_BLOCK; i++) {
+    target.words[i] |= mask(hash, i);
+  }
+}
+
+bool BlockedBloomFilter::may_contain(uint64_t hash) const
+{
+  const Block &target = blocks_[block_index(hash)];
+  for (int i = 0; i < WORDS_PER_BLOCK; i++) {
+    if ((target.words[i] & mask(hash, i)) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RuntimeFilter::RuntimeFilter(vector<unique_ptr<Expression>> &&probe_keys, const vector<AttrType> &key_types)
+    : probe_keys_(std::move(probe_keys)), key_types_(key_types)
+{
+  ASSERT(probe_keys_.size() == key_types_.size(), "every key should have a type");
+  values_.resize(probe_keys_.size());
+}
+
+void RuntimeFilter::encode_key(const vector<Value> &values, const vector<AttrType> &key_types, string &key)
+{
+  key.clear();
+  for (size_t i = 0; i < values.size(); i++) {
+    const Value   &value = values[i];
+    const AttrType type  = key_types[i];
+    if (is_integer(type)) {
+      const int64_t int_value = value.get_bigint();
+      key.append(reinterpret_cast<const char *>(&int_value), sizeof(int_value));
+    } else if (type == AttrType::FLOATS) {
+      float float_value = value.get_float();
+      if (float_value == 0) {
+        float_value = 0;  // -0.0 与 0.0 相等
+      }
+      key.append(reinterpret_cast<const char *>(&float_value), sizeof(float_value));
+    } else {
+      const string   str_value = value.to_string();
+      const uint32_t length    = static_cast<uint32_t>(str_value.size());
+      key.append(reinterpret_cast<const char *>(&length), sizeof(length));
+      key.append(str_value);
+    }
+  }
+}
+
+void RuntimeFilter::reset()
+{
+  bloom_filter_.clear();
+  key_hashes_.clear();
+  key_count_ = 0;
+  ready_     = false;
+  has_range_.assign(key_types_.size(), false);
+  min_values_.assign(key_types_.size(), 0);
+  max_values_.assign(key_types_.size(), 0);
+
+  // 数据变化之后重新评估
+  enabled_       = true;
+  checked_rows_  = 0;
+  rejected_rows_ = 0;
+}
+
+void RuntimeFilter::add(const vector<Value> &values, const string &key)
+{
+  key_hashes_.push_back(hash_key(key));
+  key_count_++;
+
+  for (size_t i = 0; i < values.size(); i++) {
+    const AttrType type = key_types_[i];
+    if (!is_integer(type) && type != AttrType::FLOATS) {
+      continue;
+    }
+    // 整数转换成 double 可能有精度损失，但是转换是单调的，范围判断不会误删
+    const double value = is_integer(type) ? static_cast<double>(values[i].get_bigint()) : values[i].get_float();
+    if (!has_range_[i]) {
+      has_range_[i]  = true;
+      min_values_[i] = max_values_[i] = value;
+    } else {
+      min_values_[i] = std::min(min_values_[i], value);
+      max_values_[i] = std::max(max_values_[i], value);
+    }
+  }
+}
+
+void RuntimeFilter::finish()
+{
+  bloom_filter_.init(key_hashes_.size());
+  for (uint64_t hash : key_hashes_) {
+    bloom_filter_.insert(hash);
+  }
+  key_hashes_.clear();
+  key_hashes_.shrink_to_fit();
+  ready_ = true;
+}
+
+RC RuntimeFilter::filter(const Tuple &tuple, bool &result)
+{
+  result = true;
+  if (!ready_ || !enabled_) {
+    return RC::SUCCESS;
+  }
+
+  if (key_count_ == 0) {
+    // 右表为空，没有行能连接上
+    result = false;
+  } else {
+    for (size_t i = 0; i < probe_keys_.size(); i++) {
+      RC rc = probe_keys_[i]->get_value(tuple, values_[i]);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to evaluate runtime filter key. rc=%s", strrc(rc));
+        return rc;
+      }
+
+      // 先用代价更低的范围判断
+      if (has_range_[i]) {
+        const AttrType type = key_types_[i];
+        const double   value =
+            is_integer(type) ? static_cast<double>(values_[i].get_bigint()) : values_[i].get_float();
+        if (value < min_values_[i] || value > max_values_[i]) {
+          result = false;
+          break;
+        }
+      }
+    }
+
+    if (result) {
+      encode_key(values_, key_types_, key_);
+      result = bloom_filter_.may_contain(hash_key(key_));
+    }
+  }
+
+  checked_rows_++;
+  rejected_rows_ += result ? 0 : 1;
+  if (checked_rows_ == SAMPLE_ROWS && rejected_rows_ < SAMPLE_ROWS * MIN_REJECT_RATIO) {
+    LOG_TRACE("disable runtime filter. %s", to_string().c_str());
+    enabled_ = false;
+  }
+  return RC::SUCCESS;
+}
+
+string RuntimeFilter::to_string() const
+{
+  string result = "keys=" + std::to_string(key_count_) + ", bloom=" + std::to_string(bloom_filter_.memory_size()) +
+                  "B, checked=" + std::to_string(checked_rows_) + ", rejected=" + std::to_string(rejected_rows_);
+  for (size_t i = 0; i < has_range_.size(); i++) {
+    if (has_range_[i]) {
+      result += ", range" + std::to_string(i) + "=[" + std::to_string(min_values_[i]) + ", " +
+                std::to_string(max_values_[i]) + "]";
+    }
+  }
+  return result;
+}
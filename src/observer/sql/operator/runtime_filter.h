@@ -0,0 +1,113 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/sys/rc.h"
+#include "sql/expr/expression.h"
+
+class Tuple;
+
+/**
+ * @brief 分块的布隆过滤器
+ * @details 每个键只访问一个 64 字节的块，在块内的 8 个字中各设置一位，查询时只有一次缓存未命中。
+ */
+class BlockedBloomFilter
+{
+public:
+  /// 按照 expected_keys 个键分配空间，每个键大约 16 位
+  void init(size_t expected_keys);
+  void clear() { blocks_.clear(); }
+
+  void insert(uint64_t hash);
+  bool may_contain(uint64_t hash) const;
+
+  size_t memory_size() const { return blocks_.size() * sizeof(Block); }
+
+private:
+  static constexpr int WORDS_PER_BLOCK = 8;
+  struct alignas(64) Block
+  {
+    uint64_t words[WORDS_PER_BLOCK];
+  };
+
+  size_t block_index(uint64_t hash) const { return (hash >> 32) & (blocks_.size() - 1); }
+  /// 块内第 i 个字中要设置的位
+  static uint64_t mask(uint64_t hash, int i);
+
+private:
+  vector<Block> blocks_;  //! 块的数量是 2 的幂
+};
+
+/**
+ * @brief 连接运行时生成的过滤器
+ * @ingroup PhysicalOperator
+ * @details Hash Join 建完哈希表后，用右表所有连接键的布隆过滤器和数值键的最小、最大值生成过滤器，
+ * 交给左表的表扫描算子。扫描时在左表的行上计算连接键，哈希表中一定不存在的行直接丢弃，不再传给上层算子。
+ * 过滤器只会误留不会误删，所以只能用于内连接和半连接。
+ * 过滤掉的行太少时，计算连接键的代价比节省的代价大，检查一定行数之后会停用过滤器。
+ */
+class RuntimeFilter
+{
+public:
+  /**
+   * @param probe_keys 在左表的行上计算的连接键
+   * @param key_types 连接键比较时使用的类型，与哈希表中的编码方式一致
+   */
+  RuntimeFilter(vector<unique_ptr<Expression>> &&probe_keys, const vector<AttrType> &key_types);
+
+  /**
+   * @brief 把连接键的值转换成比较类型后拼接起来，相等的键得到相同的字节序列
+   */
+  static void encode_key(const vector<Value> &values, const vector<AttrType> &key_types, string &key);
+
+  /// 开始接收新的右表数据，调用 finish 之前所有的行都能通过
+  void reset();
+  /// 加入右表的一个键，key 是 values 编码之后的结果，相同的键只需要加入一次
+  void add(const vector<Value> &values, const string &key);
+  /// 右表的键都加入之后，按照键的数量生成布隆过滤器
+  void finish();
+
+  /**
+   * @brief 左表的行是否可能在哈希表中存在
+   */
+  RC filter(const Tuple &tuple, bool &result);
+
+  bool   enabled() const { return enabled_; }
+  size_t checked_rows() const { return checked_rows_; }
+  size_t rejected_rows() const { return rejected_rows_; }
+
+  string to_string() const;
+
+private:
+  /// 检查这么多行之后评估过滤效果
+  static constexpr size_t SAMPLE_ROWS = 4096;
+  /// 过滤掉的行少于这个比例时停用
+  static constexpr double MIN_REJECT_RATIO = 0.05;
+
+  vector<unique_ptr<Expression>> probe_keys_;
+  vector<AttrType>               key_types_;
+
+  BlockedBloomFilter bloom_filter_;
+  vector<uint64_t>   key_hashes_;  //! 生成布隆过滤器之前暂存键的哈希值
+  size_t             key_count_ = 0;
+  vector<bool>       has_range_;  //! 数值类型的键记录最小、最大值
+  vector<double>     min_values_;
+  vector<double>     max_values_;
+
+  bool          ready_         = false;  //! 右表的数据是否已经完整
+  bool          enabled_       = true;
+  size_t        checked_rows_  = 0;
+  size_t        rejected_rows_ = 0;
+  vector<Value> values_;
+  string        key_;
+};
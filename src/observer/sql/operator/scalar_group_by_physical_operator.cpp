@@ -26,6 +26,12 @@ ScalarGroupByPhysicalOperator::ScalarGroupByPhysicalOperator(vector<Expression *
 
 RC ScalarGroupByPhysicalOperator::open(Trx *trx)
 {
+  count_open();
+  if (children_.empty()) {
+    // 输入被恒假的过滤条件裁剪掉了，与空表一样不输出结果
+    return RC::SUCCESS;
+  }
+
   ASSERT(children_.size() == 1, "group by operator only support one child, but got %d", children_.size());
 
   PhysicalOperator &child = *children_[0];
@@ -99,14 +105,16 @@ RC ScalarGroupByPhysicalOperator::next()
 
   emitted_ = true;
 
-  return RC::SUCCESS;
+  return count_rows(RC::SUCCESS);
 }
 
 RC ScalarGroupByPhysicalOperator::close()
 {
   group_value_.reset();
   emitted_ = false;
-  children_[0]->close();
+  if (!children_.empty()) {
+    children_[0]->close();
+  }
   return RC::SUCCESS;
 }
 
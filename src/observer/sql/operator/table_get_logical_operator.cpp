@@ -13,7 +13,9 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/table_get_logical_operator.h"
+#include "common/lang/cmath.h"
 #include "sql/optimizer/cascade/property.h"
+#include "sql/optimizer/cascade/selectivity.h"
 #include "catalog/catalog.h"
 
 TableGetLogicalOperator::TableGetLogicalOperator(Table *table, ReadWriteMode mode)
@@ -25,9 +27,15 @@ void TableGetLogicalOperator::set_predicates(vector<unique_ptr<Expression>> &&ex
   predicates_ = std::move(exprs);
 }
 
+void TableGetLogicalOperator::set_referenced_fields(vector<int> &&field_ids)
+{
+  referenced_fields_     = std::move(field_ids);
+  has_referenced_fields_ = true;
+}
+
 unique_ptr<LogicalProperty> TableGetLogicalOperator::find_log_prop(const vector<LogicalProperty*> &log_props)
 {
-  int card = Catalog::get_instance().get_table_stats(table_->table_id()).row_nums;
-  // TODO: think about predicates.
-  return make_unique<LogicalProperty>(card);
+  const int    row_nums    = Catalog::get_instance().get_table_stats(table_->table_id()).row_nums;
+  const double selectivity = SelectivityEstimator::estimate(predicates_);
+  return make_unique<LogicalProperty>(static_cast<int>(std::round(row_nums * selectivity)));
 }
\ No newline at end of file
@@ -57,6 +57,14 @@ public:
   void set_predicates(vector<unique_ptr<Expression>> &&exprs);
   auto predicates() -> vector<unique_ptr<Expression>> & { return predicates_; }
 
+  /**
+   * @brief 设置上层算子（包括过滤条件）用到的字段，向量化扫描时只读取这些字段
+   * @param field_ids 字段的 field_id
+   */
+  void               set_referenced_fields(vector<int> &&field_ids);
+  bool               has_referenced_fields() const { return has_referenced_fields_; }
+  const vector<int> &referenced_fields() const { return referenced_fields_; }
+
 private:
   Table        *table_ = nullptr;
   ReadWriteMode mode_  = ReadWriteMode::READ_WRITE;
@@ -66,4 +74,7 @@ private:
   // 不包含复杂的表达式运算，比如加减乘除、或者conjunction expression
   // 如果有多个表达式，他们的关系都是 AND
   vector<unique_ptr<Expression>> predicates_;
+
+  bool        has_referenced_fields_ = false;  ///< 没有设置时读取所有字段
+  vector<int> referenced_fields_;
 };
@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include "sql/operator/table_scan_physical_operator.h"
+#include "catalog/catalog.h"
 #include "event/sql_debug.h"
 #include "storage/table/table.h"
 
@@ -20,6 +21,7 @@ using namespace std;
 
 RC TableScanPhysicalOperator::open(Trx *trx)
 {
+  count_open();
   RC rc = table_->get_record_scanner(record_scanner_, trx, mode_);
   if (rc == RC::SUCCESS) {
     tuple_.set_schema(table_, table_->table_meta().field_metas());
@@ -50,10 +52,14 @@ RC TableScanPhysicalOperator::next()
       sql_debug("a tuple is filtered: %s", tuple_.to_string().c_str());
     }
   }
-  return rc;
+  return count_rows(rc);
 }
 
 RC TableScanPhysicalOperator::close() {
+  for (const shared_ptr<RuntimeFilter> &runtime_filter : runtime_filters_) {
+    LOG_TRACE("runtime filter of table %s: %s", table_->name(), runtime_filter->to_string().c_str());
+  }
+
   RC rc = RC::SUCCESS;
   if (record_scanner_ != nullptr) {
     rc = record_scanner_->close_scan();
@@ -67,6 +73,14 @@ RC TableScanPhysicalOperator::close() {
 
 }
 
+bool TableScanPhysicalOperator::collect_constants(vector<Value *> &constants, vector<Value *> &copies)
+{
+  for (unique_ptr<Expression> &expr : predicates_) {
+    collect_expression_constants(*expr, constants);
+  }
+  return true;
+}
+
 Tuple *TableScanPhysicalOperator::current_tuple()
 {
   tuple_.set_record(&current_record_);
@@ -97,6 +111,21 @@ RC TableScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
     }
   }
 
+  for (const shared_ptr<RuntimeFilter> &runtime_filter : runtime_filters_) {
+    rc = runtime_filter->filter(tuple, result);
+    if (rc != RC::SUCCESS || !result) {
+      return rc;
+    }
+  }
+
   result = true;
   return rc;
 }
+
+double TableScanPhysicalOperator::calculate_cost(
+    LogicalProperty *prop, const vector<LogicalProperty *> &child_log_props, CostModel *cm)
+{
+  // 全表扫描的代价与过滤后的行数无关，每一页、每一行都要读取
+  const double rows = Catalog::get_instance().get_table_stats(table_->table_id()).row_nums;
+  return cm->seq_scan(rows, CostModel::pages(rows, table_->table_meta().record_size()));
+}
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/sys/rc.h"
 #include "sql/operator/physical_operator.h"
+#include "sql/operator/runtime_filter.h"
 #include "storage/record/record_manager.h"
 #include "storage/record/record_scanner.h"
 #include "common/types.h"
@@ -54,10 +55,7 @@ public:
     return true;
   }
 
-  double calculate_cost(LogicalProperty *prop, const vector<LogicalProperty *> &child_log_props, CostModel *cm) override
-  {
-    return (cm->io() + cm->cpu_op()) * prop->get_card();
-  }
+  double calculate_cost(LogicalProperty *prop, const vector<LogicalProperty *> &child_log_props, CostModel *cm) override;
 
   RC open(Trx *trx) override;
   RC next() override;
@@ -65,19 +63,29 @@ public:
 
   Tuple *current_tuple() override;
 
-  int table_id() const { return table_->table_id(); }
+  bool collect_constants(vector<Value *> &constants, vector<Value *> &copies) override;
+
+  int    table_id() const { return table_->table_id(); }
+  Table *table() const { return table_; }
 
   void set_predicates(vector<unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 增加上层 Hash Join 生成的过滤器，在谓词之后计算
+   * @details 过滤器的内容在 Hash Join 每次建完哈希表后更新，本算子只负责使用
+   */
+  void add_runtime_filter(shared_ptr<RuntimeFilter> filter) { runtime_filters_.emplace_back(std::move(filter)); }
+
 private:
   RC filter(RowTuple &tuple, bool &result);
 
 private:
-  Table                         *table_ = nullptr;
-  Trx                           *trx_   = nullptr;
-  ReadWriteMode                  mode_  = ReadWriteMode::READ_WRITE;
-  RecordScanner                 *record_scanner_;
-  Record                         current_record_;
-  RowTuple                       tuple_;
-  vector<unique_ptr<Expression>> predicates_;  // TODO chang predicate to table tuple filter
+  Table                            *table_ = nullptr;
+  Trx                              *trx_   = nullptr;
+  ReadWriteMode                     mode_  = ReadWriteMode::READ_WRITE;
+  RecordScanner                    *record_scanner_;
+  Record                            current_record_;
+  RowTuple                          tuple_;
+  vector<unique_ptr<Expression>>    predicates_;  // TODO chang predicate to table tuple filter
+  vector<shared_ptr<RuntimeFilter>> runtime_filters_;
 };
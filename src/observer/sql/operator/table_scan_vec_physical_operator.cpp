@@ -10,76 +10,147 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/operator/table_scan_vec_physical_operator.h"
 #include "event/sql_debug.h"
+#include "sql/expr/expression_iterator.h"
 #include "storage/table/table.h"
 
 using namespace std;
 
 RC TableScanVecPhysicalOperator::open(Trx *trx)
 {
+  count_open();
   RC rc = table_->get_chunk_scanner(chunk_scanner_, trx, mode_);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to get chunk scanner", strrc(rc));
     return rc;
   }
-  // TODO: don't need to fetch all columns from record manager
+  if (morsel_scheduler_ != nullptr) {
+    rc = chunk_scanner_.set_morsel_scheduler(morsel_scheduler_.get());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to open morsel scheduler. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  // chunk 中列的下标与 field_id 相同，没有用到的列也保留着，只是不读取数据
+  all_columns_.reset();
+  all_columns_.set_memory_pool(&memory_pool_);
   for (int i = 0; i < table_->table_meta().field_num(); ++i) {
     all_columns_.add_column(
         make_unique<Column>(*table_->table_meta().field(i)), table_->table_meta().field(i)->field_id());
-    filterd_columns_.add_column(
-        make_unique<Column>(*table_->table_meta().field(i)), table_->table_meta().field(i)->field_id());
   }
+  init_scan_columns();
+  chunk_scanner_.set_eager_columns(predicates_.empty() ? late_columns_ : predicate_columns_);
   return rc;
 }
 
+void TableScanVecPhysicalOperator::init_scan_columns()
+{
+  vector<bool> predicate_fields(all_columns_.column_num(), false);
+  function<RC(unique_ptr<Expression> &)> collector = [&](unique_ptr<Expression> &expr) -> RC {
+    if (expr->type() == ExprType::FIELD) {
+      const int field_id = static_cast<FieldExpr &>(*expr).field().meta()->field_id();
+      if (field_id >= 0 && field_id < static_cast<int>(predicate_fields.size())) {
+        predicate_fields[field_id] = true;
+      }
+    }
+    return ExpressionIterator::iterate_child_expr(*expr, collector);
+  };
+  for (unique_ptr<Expression> &predicate : predicates_) {
+    collector(predicate);
+  }
+
+  vector<bool> referenced(all_columns_.column_num(), !has_referenced_fields_);
+  for (int field_id : referenced_fields_) {
+    if (field_id >= 0 && field_id < static_cast<int>(referenced.size())) {
+      referenced[field_id] = true;
+    }
+  }
+
+  predicate_columns_.clear();
+  late_columns_.clear();
+  for (int i = 0; i < all_columns_.column_num(); i++) {
+    const int field_id = all_columns_.column_ids(i);
+    if (predicate_fields[field_id]) {
+      predicate_columns_.push_back(i);
+    } else if (referenced[field_id]) {
+      late_columns_.push_back(i);
+    }
+  }
+}
+
 RC TableScanVecPhysicalOperator::next(Chunk &chunk)
 {
   RC rc = RC::SUCCESS;
 
-  all_columns_.reset_data();
-  filterd_columns_.reset_data();
-  if (OB_SUCC(rc = chunk_scanner_.next_chunk(all_columns_))) {
-    select_.assign(all_columns_.rows(), 1);
+  // 过滤之后的行不做拷贝，通过选择向量传给下游算子；所有行都被过滤掉的 chunk 直接跳过。
+  // 只在输出时用到的列在过滤之后才读取，跳过的 chunk 不会读取这些列
+  while (OB_SUCC(rc = chunk_scanner_.next_chunk(all_columns_))) {
     if (predicates_.empty()) {
-      chunk.reference(all_columns_);
-    } else {
-      rc = filter(all_columns_);
-      if (rc != RC::SUCCESS) {
-        LOG_TRACE("filtered failed=%s", strrc(rc));
-        return rc;
-      }
-      // TODO: if all setted, it doesn't need to set one by one
-      for (int i = 0; i < all_columns_.rows(); i++) {
-        if (select_[i] == 0) {
-          continue;
-        }
-        for (int j = 0; j < all_columns_.column_num(); j++) {
-          filterd_columns_.column(j).append_value(
-              all_columns_.column(filterd_columns_.column_ids(j)).get_value(i));
+      break;
+    }
+    const int rows = all_columns_.rows();
+    select_.assign(rows, 1);
+    rc = filter(all_columns_);
+    if (rc != RC::SUCCESS) {
+      LOG_TRACE("filtered failed=%s", strrc(rc));
+      return rc;
+    }
+
+    selection_.resize(rows);
+    int selected_rows = 0;
+    for (int i = 0; i < rows; i++) {
+      selection_[selected_rows] = i;
+      selected_rows += select_[i] != 0;
+    }
+    if (selected_rows == 0) {
+      continue;
+    }
+    if (selected_rows == rows) {
+      rc = chunk_scanner_.fetch_columns(all_columns_, late_columns_, nullptr, 0);
+      break;
+    }
+    // 拷贝到 chunk 已有的空间中，两边的 vector 都可以复用
+    selection_.resize(selected_rows);
+    if (selected_rows * COMPACT_RATIO < rows) {
+      // 压缩已经读取的谓词列，其它列直接从页面中读取选中的行
+      for (int i : predicate_columns_) {
+        rc = all_columns_.column(i).compact(selection_.data(), selected_rows);
+        if (OB_FAIL(rc)) {
+          LOG_WARN("failed to compact column. rc=%s", strrc(rc));
+          return rc;
         }
       }
-      chunk.reference(filterd_columns_);
+      // 没有读取的列只需要保持行数一致
+      for (int i = 0; i < all_columns_.column_num(); i++) {
+        all_columns_.column(i).set_count(selected_rows);
+      }
+      rc = chunk_scanner_.fetch_columns(all_columns_, late_columns_, selection_.data(), selected_rows);
+    } else {
+      all_columns_.set_selection(selection_);
+      rc = chunk_scanner_.fetch_columns(all_columns_, late_columns_, nullptr, 0);
     }
+    break;
   }
-  return rc;
+  if (OB_SUCC(rc)) {
+    chunk.reference(all_columns_);
+  }
+  return count_rows(rc, chunk);
 }
 
 RC TableScanVecPhysicalOperator::close() { return chunk_scanner_.close_scan(); }
 
 string TableScanVecPhysicalOperator::param() const { return table_->name(); }
 
-void TableScanVecPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&exprs)
+void TableScanVecPhysicalOperator::set_referenced_fields(const vector<int> &field_ids)
 {
-  predicates_ = std::move(exprs);
+  referenced_fields_     = field_ids;
+  has_referenced_fields_ = true;
 }
 
-RC TableScanVecPhysicalOperator::filter(Chunk &chunk)
+void TableScanVecPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&exprs)
 {
-  RC rc = RC::SUCCESS;
-  for (unique_ptr<Expression> &expr : predicates_) {
-    rc = expr->eval(chunk, select_);
-    if (rc != RC::SUCCESS) {
-      return rc;
-    }
-  }
-  return rc;
+  predicates_ = std::move(exprs);
+  // 不能编译的谓词在 filter 时逐个计算
+  predicate_program_.compile_filter(predicates_);
 }
+
+RC TableScanVecPhysicalOperator::filter(Chunk &chunk) { return predicate_program_.filter(chunk, select_); }
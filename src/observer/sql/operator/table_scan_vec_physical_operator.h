@@ -11,7 +11,9 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/sys/rc.h"
+#include "sql/expr/expression_program.h"
 #include "sql/operator/physical_operator.h"
+#include "storage/record/morsel_scheduler.h"
 #include "storage/record/record_manager.h"
 #include "common/types.h"
 
@@ -38,15 +40,40 @@ public:
 
   void set_predicates(vector<unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 设置上层算子用到的字段，其它字段不从页面中读取
+   * @param field_ids 字段的 field_id，包括谓词用到的字段
+   */
+  void set_referenced_fields(const vector<int> &field_ids);
+
+  /**
+   * @brief 并行扫描，只扫描 scheduler 分配的页面
+   */
+  void set_morsel_scheduler(shared_ptr<MorselScheduler> scheduler) { morsel_scheduler_ = std::move(scheduler); }
+
 private:
   RC filter(Chunk &chunk);
 
+  /// 划分谓词用到的列和只在输出时用到的列
+  void init_scan_columns();
+
 private:
+  /// 有效行不到 1/COMPACT_RATIO 时直接压缩成紧凑的 Chunk，否则使用选择向量输出
+  static constexpr int COMPACT_RATIO = 4;
+
   Table                         *table_ = nullptr;
   ReadWriteMode                  mode_  = ReadWriteMode::READ_WRITE;
+  shared_ptr<MorselScheduler>    morsel_scheduler_;  /// 要在 chunk_scanner_ 之后析构
   ChunkFileScanner               chunk_scanner_;
+  ColumnMemoryPool               memory_pool_;  /// 在扫描结果上计算表达式时使用的内存
   Chunk                          all_columns_;
-  Chunk                          filterd_columns_;
   vector<uint8_t>                select_;
+  vector<int>                    selection_;
   vector<unique_ptr<Expression>> predicates_;
+  ExpressionProgram              predicate_program_;  /// 谓词编译后的指令，按块融合计算
+
+  bool        has_referenced_fields_ = false;  /// 没有设置时读取所有的列
+  vector<int> referenced_fields_;
+  vector<int> predicate_columns_;  /// 先读取的列，用于计算谓词
+  vector<int> late_columns_;       /// 只在输出时用到的列，过滤之后只读取选中的行
 };
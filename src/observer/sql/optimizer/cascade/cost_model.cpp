@@ -12,6 +12,23 @@ See the Mulan PSL v2 for more details. */
 #include "sql/optimizer/cascade/memo.h"
 #include "catalog/catalog.h"
 #include "sql/optimizer/cascade/group_expr.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/cmath.h"
+#include "storage/buffer/page.h"
+
+double CostModel::pages(double rows, int record_size)
+{
+  const double rows_per_page = std::max(1, BP_PAGE_DATA_SIZE / std::max(record_size, 1));
+  return std::max(1.0, std::ceil(rows / rows_per_page));
+}
+
+double CostModel::index_scan(double table_rows, double table_pages, double matched_rows)
+{
+  const double probe_cost = INDEX_PROBE * (std::log2(std::max(table_rows, 1.0)) + matched_rows);
+  // Yao: expected number of distinct pages touched by matched_rows random rows
+  const double fetched_pages = table_pages * (1 - std::pow(1 - 1 / table_pages, matched_rows));
+  return probe_cost + RANDOM_IO * fetched_pages + CPU_OP * matched_rows;
+}
 
 double CostModel::calculate_cost(Memo *memo,
                                GroupExpr *gexpr)
@@ -24,6 +24,7 @@ private:
   double HASH_PROBE  = 0.00001;
   double INDEX_PROBE = 0.00001;
   double IO          = 0.03;
+  double RANDOM_IO   = 0.12;  ///< reading a page out of order, 4 times a sequential read
 
 public:
   // TODO: support user-defined
@@ -43,5 +44,46 @@ public:
   ///< i/o cost
   inline double io() { return IO; }
 
+  ///< i/o cost of a random page access
+  inline double random_io() { return RANDOM_IO; }
+
+  /**
+   * @brief estimated number of data pages of a table
+   */
+  static double pages(double rows, int record_size);
+
+  /**
+   * @brief cost of scanning all pages of a table in order and evaluating every row
+   */
+  double seq_scan(double table_rows, double table_pages) { return IO * table_pages + CPU_OP * table_rows; }
+
+  /**
+   * @brief cost of an index range scan that matches matched_rows rows
+   * @details The scan descends the tree once and walks the matched entries, then fetches every
+   * matched row from the table. Rows are not stored in index order, so each fetch is a random
+   * page access; rows on the same page are only read once, which is estimated with Yao's formula.
+   */
+  double index_scan(double table_rows, double table_pages, double matched_rows);
+
+  /**
+   * @brief cost of a nested loop join, not including the cost of its inputs
+   * @details every outer row reopens the inner input and compares with all inner rows.
+   * The cost is asymmetric, so the smaller input is preferred as the outer one.
+   */
+  double nested_loop_join(double outer_card, double inner_card, double output_card)
+  {
+    return CPU_OP * (outer_card * inner_card + output_card) + IO * outer_card;
+  }
+
+  /**
+   * @brief cost of a hash join, not including the cost of its inputs
+   * @details the build (right) input is read once into a hash table, then every probe (left) row
+   * looks up its bucket.
+   */
+  double hash_join(double probe_card, double build_card, double output_card)
+  {
+    return HASH_COST * build_card + HASH_PROBE * probe_card + CPU_OP * output_card;
+  }
+
   double calculate_cost(Memo *memo, GroupExpr *gexpr);
 };
\ No newline at end of file
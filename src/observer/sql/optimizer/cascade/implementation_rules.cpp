@@ -12,6 +12,9 @@ See the Mulan PSL v2 for more details. */
 #include "sql/optimizer/cascade/implementation_rules.h"
 #include "sql/operator/table_get_logical_operator.h"
 #include "sql/operator/table_scan_physical_operator.h"
+#include "sql/operator/index_scan_physical_operator.h"
+#include "sql/optimizer/cascade/selectivity.h"
+#include "storage/index/index.h"
 #include "sql/operator/project_logical_operator.h"
 #include "sql/operator/project_physical_operator.h"
 #include "sql/operator/insert_logical_operator.h"
@@ -27,6 +30,9 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/group_by_logical_operator.h"
 #include "sql/operator/scalar_group_by_physical_operator.h"
 #include "sql/operator/hash_group_by_physical_operator.h"
+#include "sql/operator/join_logical_operator.h"
+#include "sql/operator/nested_loop_join_physical_operator.h"
+#include "sql/operator/hash_join_physical_operator.h"
 
 // -------------------------------------------------------------------------------------------------
 // PhysicalSeqScan
@@ -55,6 +61,162 @@ void LogicalGetToPhysicalSeqScan::transform(OperatorNode* input,
   transformed->emplace_back(std::move(oper));
 }
 
+// -------------------------------------------------------------------------------------------------
+// PhysicalIndexScan
+// -------------------------------------------------------------------------------------------------
+namespace {
+/// a op b is the same as b reverse(op) a
+CompOp reverse_comp(CompOp comp)
+{
+  switch (comp) {
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case LESS_THAN: return GREAT_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    default: return comp;
+  }
+}
+
+/// Range of an index column bounded by comparisons with constants, a side without value is open
+struct IndexRange
+{
+  const FieldExpr *field = nullptr;
+
+  Value left;
+  bool  left_inclusive = true;
+  Value right;
+  bool  right_inclusive = true;
+
+  bool has_left() const { return left.attr_type() != AttrType::UNDEFINED; }
+  bool has_right() const { return right.attr_type() != AttrType::UNDEFINED; }
+
+  void add(CompOp comp, const Value &value)
+  {
+    switch (comp) {
+      case EQUAL_TO: {
+        narrow_left(value, true);
+        narrow_right(value, true);
+      } break;
+      case GREAT_THAN: narrow_left(value, false); break;
+      case GREAT_EQUAL: narrow_left(value, true); break;
+      case LESS_THAN: narrow_right(value, false); break;
+      case LESS_EQUAL: narrow_right(value, true); break;
+      default: break;
+    }
+  }
+
+  bool bounded() const { return has_left() || has_right(); }
+
+  bool empty() const
+  {
+    if (!has_left() || !has_right()) {
+      return false;
+    }
+    const int cmp = left.compare(right);
+    return cmp > 0 || (cmp == 0 && !(left_inclusive && right_inclusive));
+  }
+
+private:
+  void narrow_left(const Value &value, bool inclusive)
+  {
+    const int cmp = has_left() ? value.compare(left) : 1;
+    if (cmp > 0 || (cmp == 0 && !inclusive)) {
+      left           = value;
+      left_inclusive = inclusive;
+    }
+  }
+
+  void narrow_right(const Value &value, bool inclusive)
+  {
+    const int cmp = has_right() ? value.compare(right) : -1;
+    if (cmp < 0 || (cmp == 0 && !inclusive)) {
+      right           = value;
+      right_inclusive = inclusive;
+    }
+  }
+};
+
+/// Narrows the range with a predicate like `field op value`, other predicates are ignored
+void add_to_range(Expression &predicate, const Table *table, const char *field_name, IndexRange &range)
+{
+  if (predicate.type() != ExprType::COMPARISON) {
+    return;
+  }
+  auto       &comparison = static_cast<ComparisonExpr &>(predicate);
+  Expression *left       = comparison.left().get();
+  Expression *right      = comparison.right().get();
+  CompOp      comp       = comparison.comp();
+  if (left->type() == ExprType::VALUE && right->type() == ExprType::FIELD) {
+    std::swap(left, right);
+    comp = reverse_comp(comp);
+  }
+  if (left->type() != ExprType::FIELD || right->type() != ExprType::VALUE) {
+    return;
+  }
+
+  auto        *field = static_cast<FieldExpr *>(left);
+  const Value &value = static_cast<ValueExpr *>(right)->get_value();
+  // index keys are compared as raw bytes of the column type
+  if (field->field().table() != table || strcmp(field->field_name(), field_name) != 0 ||
+      value.attr_type() != field->value_type()) {
+    return;
+  }
+  range.field = field;
+  range.add(comp, value);
+}
+}  // namespace
+
+LogicalGetToPhysicalIndexScan::LogicalGetToPhysicalIndexScan()
+{
+  type_          = RuleType::GET_TO_INDEX_SCAN;
+  match_pattern_ = unique_ptr<Pattern>(new Pattern(OpType::LOGICALGET));
+}
+
+void LogicalGetToPhysicalIndexScan::transform(
+    OperatorNode *input, std::vector<std::unique_ptr<OperatorNode>> *transformed, OptimizerContext *context) const
+{
+  auto                           *table_get_oper = dynamic_cast<TableGetLogicalOperator *>(input);
+  Table                          *table          = table_get_oper->table();
+  vector<unique_ptr<Expression>> &log_preds      = table_get_oper->predicates();
+
+  const TableMeta &table_meta = table->table_meta();
+  for (int i = 0; i < table_meta.index_num(); i++) {
+    const IndexMeta *index_meta = table_meta.index(i);
+    Index           *index      = table->find_index(index_meta->name());
+    if (index == nullptr) {
+      continue;
+    }
+
+    IndexRange range;
+    for (auto &pred : log_preds) {
+      add_to_range(*pred, table, index_meta->field(), range);
+    }
+    // an unbounded index scan is never cheaper than seq scan, an empty range is left to seq scan
+    if (!range.bounded() || range.empty()) {
+      continue;
+    }
+
+    vector<unique_ptr<Expression>> phys_preds;
+    for (auto &pred : log_preds) {
+      phys_preds.push_back(pred->copy());
+    }
+    auto index_scan_oper = make_unique<IndexScanPhysicalOperator>(table,
+        index,
+        table_get_oper->read_write_mode(),
+        range.has_left() ? &range.left : nullptr,
+        range.left_inclusive,
+        range.has_right() ? &range.right : nullptr,
+        range.right_inclusive);
+    index_scan_oper->set_predicates(std::move(phys_preds));
+    index_scan_oper->set_range_selectivity(SelectivityEstimator::range_selectivity(*range.field,
+        range.has_left() ? &range.left : nullptr,
+        range.left_inclusive,
+        range.has_right() ? &range.right : nullptr,
+        range.right_inclusive));
+    transformed->emplace_back(std::move(index_scan_oper));
+  }
+}
+
 // -------------------------------------------------------------------------------------------------
 //  LogicalProjectionToProjection
 // -------------------------------------------------------------------------------------------------
@@ -119,7 +281,7 @@ void LogicalExplainToExplain::transform(OperatorNode* input,
                          OptimizerContext *context) const
 {
   auto explain_oper = dynamic_cast<ExplainLogicalOperator*>(input);
-  unique_ptr<PhysicalOperator> explain_physical_oper(new ExplainPhysicalOperator());
+  unique_ptr<PhysicalOperator> explain_physical_oper(new ExplainPhysicalOperator(explain_oper->analyze()));
   for (auto &child : explain_oper->children()) {
     explain_physical_oper->add_general_child(child.get());
   }
@@ -199,6 +361,64 @@ void LogicalPredicateToPredicate::transform(OperatorNode* input,
   transformed->emplace_back(std::move(oper));
 }
 
+// -------------------------------------------------------------------------------------------------
+// Physical Nested Loop Join
+// -------------------------------------------------------------------------------------------------
+LogicalInnerJoinToNestedLoopJoin::LogicalInnerJoinToNestedLoopJoin()
+{
+  type_ = RuleType::INNER_JOIN_TO_NL_JOIN;
+  match_pattern_ = unique_ptr<Pattern>(new Pattern(OpType::LOGICALINNERJOIN));
+  match_pattern_->add_child(new Pattern(OpType::LEAF));
+  match_pattern_->add_child(new Pattern(OpType::LEAF));
+}
+
+void LogicalInnerJoinToNestedLoopJoin::transform(OperatorNode* input,
+                         std::vector<std::unique_ptr<OperatorNode>> *transformed,
+                         OptimizerContext *context) const
+{
+  auto join_oper = dynamic_cast<JoinLogicalOperator*>(input);
+
+  auto nlj_oper = make_unique<NestedLoopJoinPhysicalOperator>();
+  nlj_oper->set_predicates(join_oper->copy_join_predicates());
+  for (auto &child : join_oper->get_general_children()) {
+    nlj_oper->add_general_child(child);
+  }
+  transformed->emplace_back(std::move(nlj_oper));
+}
+
+// -------------------------------------------------------------------------------------------------
+// Physical Hash Semi Join
+// -------------------------------------------------------------------------------------------------
+LogicalSemiJoinToHashJoin::LogicalSemiJoinToHashJoin()
+{
+  type_ = RuleType::SEMI_JOIN_TO_HASH_JOIN;
+  match_pattern_ = unique_ptr<Pattern>(new Pattern(OpType::LOGICALSEMIJOIN));
+  match_pattern_->add_child(new Pattern(OpType::LEAF));
+  match_pattern_->add_child(new Pattern(OpType::LEAF));
+}
+
+void LogicalSemiJoinToHashJoin::transform(OperatorNode* input,
+                         std::vector<std::unique_ptr<OperatorNode>> *transformed,
+                         OptimizerContext *context) const
+{
+  auto join_oper = dynamic_cast<JoinLogicalOperator*>(input);
+
+  vector<unique_ptr<Expression>> left_keys;
+  vector<unique_ptr<Expression>> right_keys;
+  for (size_t i = 0; i < join_oper->left_keys().size(); i++) {
+    left_keys.push_back(join_oper->left_keys()[i]->copy());
+    right_keys.push_back(join_oper->right_keys()[i]->copy());
+  }
+
+  auto hash_join_oper =
+      make_unique<HashJoinPhysicalOperator>(join_oper->join_type(), std::move(left_keys), std::move(right_keys));
+  hash_join_oper->set_predicates(join_oper->copy_join_predicates());
+  for (auto &child : join_oper->get_general_children()) {
+    hash_join_oper->add_general_child(child);
+  }
+  transformed->emplace_back(std::move(hash_join_oper));
+}
+
 // -------------------------------------------------------------------------------------------------
 // Physical Aggregation
 // -------------------------------------------------------------------------------------------------
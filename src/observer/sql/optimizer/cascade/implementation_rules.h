@@ -24,9 +24,19 @@ public:
       OptimizerContext *context) const override;
 };
 
-// TODO: support index scan
-// class LogicalGetToPhysicalIndexScan : public Rule {
-// };
+/**
+ * Rule transforms Logical Scan -> Physical Index Scan
+ * One index scan is produced for every index whose column is compared with constants, the
+ * comparisons bound the scanned range. The cost model then chooses between them and seq scan.
+ */
+class LogicalGetToPhysicalIndexScan : public Rule
+{
+public:
+  LogicalGetToPhysicalIndexScan();
+
+  void transform(OperatorNode *input, std::vector<std::unique_ptr<OperatorNode>> *transformed,
+      OptimizerContext *context) const override;
+};
 
 /**
  * Rule transforms Logical Projection -> Physical Projection
@@ -101,6 +111,31 @@ public:
       OptimizerContext *context) const override;
 };
 
+/**
+ * Rule transforms Logical Inner Join -> Physical Nested Loop Join
+ */
+class LogicalInnerJoinToNestedLoopJoin : public Rule
+{
+public:
+  LogicalInnerJoinToNestedLoopJoin();
+
+  void transform(OperatorNode *input, std::vector<std::unique_ptr<OperatorNode>> *transformed,
+      OptimizerContext *context) const override;
+};
+
+/**
+ * Rule transforms Logical Semi/Anti Join -> Physical Hash Join
+ * @details semi and anti joins come from unnested subqueries and are only implemented by hash join
+ */
+class LogicalSemiJoinToHashJoin : public Rule
+{
+public:
+  LogicalSemiJoinToHashJoin();
+
+  void transform(OperatorNode *input, std::vector<std::unique_ptr<OperatorNode>> *transformed,
+      OptimizerContext *context) const override;
+};
+
 /**
  * Rule transforms Logical Groupby -> Physical Aggregation(Scalar Groupby)
  * TODO: currently group by is competition problem, so we don't implement this rule
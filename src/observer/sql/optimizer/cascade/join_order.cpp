@@ -0,0 +1,387 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+
+#include "sql/optimizer/cascade/join_order.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/bitset.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/join_logical_operator.h"
+#include "sql/optimizer/cascade/selectivity.h"
+#include "sql/optimizer/optimizer_utils.h"
+
+namespace {
+inline uint64_t bit(int i) { return uint64_t(1) << i; }
+
+inline int popcount(uint64_t relations) { return static_cast<int>(std::bitset<64>(relations).count()); }
+
+inline int lowest(uint64_t relations) { return __builtin_ctzll(relations); }
+
+/// relations with index <= i
+inline uint64_t prefix(int i) { return i >= 63 ? ~uint64_t(0) : bit(i + 1) - 1; }
+
+inline bool is_subset(uint64_t sub, uint64_t relations) { return (sub & ~relations) == 0; }
+
+/// semi and anti joins are not reordered, they are inputs of the region above them
+inline bool is_inner_join(LogicalOperator &oper)
+{
+  return oper.type() == LogicalOperatorType::JOIN &&
+         static_cast<JoinLogicalOperator &>(oper).join_type() == JoinType::INNER;
+}
+}  // namespace
+
+// -------------------------------------------------------------------------------------------------
+// JoinOrderEnumerator
+// -------------------------------------------------------------------------------------------------
+int JoinOrderEnumerator::add_relation(double card)
+{
+  relation_cards_.push_back(std::max(card, 1.0));
+  adjacency_.push_back(0);
+  return static_cast<int>(relation_cards_.size()) - 1;
+}
+
+void JoinOrderEnumerator::add_predicate(uint64_t relations, double selectivity)
+{
+  edges_.push_back(Edge{relations, selectivity});
+  if (popcount(relations) == 2) {
+    const int first  = lowest(relations);
+    const int second = lowest(relations & ~bit(first));
+    adjacency_[first] |= bit(second);
+    adjacency_[second] |= bit(first);
+  }
+}
+
+const JoinPlanNode *JoinOrderEnumerator::solve()
+{
+  nodes_.clear();
+  best_plans_.clear();
+  pairs_.clear();
+  const int relation_num = static_cast<int>(relation_cards_.size());
+  if (relation_num == 0 || relation_num > MAX_RELATIONS) {
+    return nullptr;
+  }
+
+  for (int i = 0; i < relation_num; i++) {
+    JoinPlanNode &leaf = nodes_.emplace_back();
+    leaf.relations     = bit(i);
+    leaf.card          = relation_cards_[i];
+    leaf.relation      = i;
+    best_plans_[bit(i)] = &leaf;
+  }
+
+  used_dp_ = relation_num <= DP_THRESHOLD && connected();
+  return used_dp_ ? solve_dp() : solve_greedy();
+}
+
+bool JoinOrderEnumerator::connected() const
+{
+  const uint64_t all     = prefix(static_cast<int>(relation_cards_.size()) - 1);
+  uint64_t       visited = bit(0);
+  uint64_t       border  = bit(0);
+  while (border != 0) {
+    border = neighbors(visited) & ~visited;
+    visited |= border;
+  }
+  return visited == all;
+}
+
+uint64_t JoinOrderEnumerator::neighbors(uint64_t relations) const
+{
+  uint64_t result = 0;
+  for (uint64_t rest = relations; rest != 0; rest &= rest - 1) {
+    result |= adjacency_[lowest(rest)];
+  }
+  return result & ~relations;
+}
+
+double JoinOrderEnumerator::cardinality(uint64_t relations)
+{
+  auto iter = cards_.find(relations);
+  if (iter != cards_.end()) {
+    return iter->second;
+  }
+  double card = 1;
+  for (uint64_t rest = relations; rest != 0; rest &= rest - 1) {
+    card *= relation_cards_[lowest(rest)];
+  }
+  for (const Edge &edge : edges_) {
+    if (is_subset(edge.relations, relations)) {
+      card *= edge.selectivity;
+    }
+  }
+  card = std::max(card, 1.0);
+  cards_.emplace(relations, card);
+  return card;
+}
+
+JoinPlanNode JoinOrderEnumerator::make_join(const JoinPlanNode *left, const JoinPlanNode *right)
+{
+  JoinPlanNode join;
+  join.relations = left->relations | right->relations;
+  join.card      = cardinality(join.relations);
+
+  const double inputs_cost = left->cost + right->cost;
+  const double left_outer  = cost_model_.nested_loop_join(left->card, right->card, join.card);
+  const double right_outer = cost_model_.nested_loop_join(right->card, left->card, join.card);
+  if (left_outer <= right_outer) {
+    join.outer = left;
+    join.inner = right;
+    join.cost  = inputs_cost + left_outer;
+  } else {
+    join.outer = right;
+    join.inner = left;
+    join.cost  = inputs_cost + right_outer;
+  }
+  return join;
+}
+
+void JoinOrderEnumerator::emit_pair(uint64_t left, uint64_t right)
+{
+  JoinPlanNode join = make_join(best_plans_[left], best_plans_[right]);
+
+  auto iter = best_plans_.find(join.relations);
+  if (iter == best_plans_.end() || join.cost < iter->second->cost) {
+    best_plans_[join.relations] = &nodes_.emplace_back(join);
+  }
+}
+
+const JoinPlanNode *JoinOrderEnumerator::solve_dp()
+{
+  const int relation_num = static_cast<int>(relation_cards_.size());
+  for (int i = relation_num - 1; i >= 0; i--) {
+    emit_csg(bit(i));
+    enumerate_csg_rec(bit(i), prefix(i));
+  }
+
+  // a plan can only be built after the plans of both inputs are final, i.e. after all the pairs
+  // producing smaller sets of relations
+  std::stable_sort(pairs_.begin(), pairs_.end(), [](const auto &a, const auto &b) {
+    return popcount(a.first | a.second) < popcount(b.first | b.second);
+  });
+  for (const auto &[left, right] : pairs_) {
+    emit_pair(left, right);
+  }
+
+  LOG_TRACE("DPccp enumerated %d connected subgraph pairs of %d relations", enumerated_pairs(), relation_num);
+  auto iter = best_plans_.find(prefix(relation_num - 1));
+  return iter == best_plans_.end() ? nullptr : iter->second;
+}
+
+void JoinOrderEnumerator::emit_csg(uint64_t s1)
+{
+  const uint64_t excluded = s1 | prefix(lowest(s1));
+  const uint64_t neighbor = neighbors(s1) & ~excluded;
+  // every single neighbor starts a complement, larger neighbors first
+  for (int i = MAX_RELATIONS - 1; i >= 0; i--) {
+    if ((neighbor & bit(i)) == 0) {
+      continue;
+    }
+    pairs_.emplace_back(s1, bit(i));
+    enumerate_cmp_rec(s1, bit(i), excluded | (prefix(i) & neighbor));
+  }
+}
+
+void JoinOrderEnumerator::enumerate_csg_rec(uint64_t s1, uint64_t excluded)
+{
+  const uint64_t neighbor = neighbors(s1) & ~excluded;
+  for (uint64_t sub = neighbor; sub != 0; sub = (sub - 1) & neighbor) {
+    emit_csg(s1 | sub);
+  }
+  for (uint64_t sub = neighbor; sub != 0; sub = (sub - 1) & neighbor) {
+    enumerate_csg_rec(s1 | sub, excluded | neighbor);
+  }
+}
+
+void JoinOrderEnumerator::enumerate_cmp_rec(uint64_t s1, uint64_t s2, uint64_t excluded)
+{
+  const uint64_t neighbor = neighbors(s2) & ~excluded;
+  for (uint64_t sub = neighbor; sub != 0; sub = (sub - 1) & neighbor) {
+    pairs_.emplace_back(s1, s2 | sub);
+  }
+  for (uint64_t sub = neighbor; sub != 0; sub = (sub - 1) & neighbor) {
+    enumerate_cmp_rec(s1, s2 | sub, excluded | neighbor);
+  }
+}
+
+const JoinPlanNode *JoinOrderEnumerator::solve_greedy()
+{
+  vector<const JoinPlanNode *> plans;
+  for (const JoinPlanNode &leaf : nodes_) {
+    plans.push_back(&leaf);
+  }
+
+  auto is_connected = [this](uint64_t left, uint64_t right) {
+    for (const Edge &edge : edges_) {
+      if ((edge.relations & left) != 0 && (edge.relations & right) != 0 && is_subset(edge.relations, left | right)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  while (plans.size() > 1) {
+    bool         best_connected = false;
+    size_t       best_left = 0, best_right = 0;
+    JoinPlanNode best_join;
+    best_join.cost = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < plans.size(); i++) {
+      for (size_t j = i + 1; j < plans.size(); j++) {
+        const bool pair_connected = is_connected(plans[i]->relations, plans[j]->relations);
+        if (best_connected && !pair_connected) {
+          continue;
+        }
+        JoinPlanNode join = make_join(plans[i], plans[j]);
+        if ((pair_connected && !best_connected) || join.cost < best_join.cost) {
+          best_connected = pair_connected;
+          best_left      = i;
+          best_right     = j;
+          best_join      = join;
+        }
+      }
+    }
+
+    plans[best_left] = &nodes_.emplace_back(best_join);
+    plans.erase(plans.begin() + best_right);
+  }
+  return plans.front();
+}
+
+// -------------------------------------------------------------------------------------------------
+// JoinOrderOptimizer
+// -------------------------------------------------------------------------------------------------
+RC JoinOrderOptimizer::reorder(unique_ptr<LogicalOperator> &oper)
+{
+  RC rc = RC::SUCCESS;
+  if (!is_inner_join(*oper) || count_region_inputs(*oper) > JoinOrderEnumerator::MAX_RELATIONS) {
+    for (unique_ptr<LogicalOperator> &child : oper->children()) {
+      if (OB_FAIL(rc = reorder(child))) {
+        return rc;
+      }
+    }
+    return rc;
+  }
+
+  vector<unique_ptr<LogicalOperator>> inputs;
+  vector<unique_ptr<Expression>>      predicates;
+  collect_region(oper, inputs, predicates);
+
+  JoinOrderEnumerator               enumerator(cost_model_);
+  unordered_map<const Table *, int> table_relations;
+  vector<double>                    cards;
+  for (unique_ptr<LogicalOperator> &input : inputs) {
+    // 输入内部可能还有其它的连接区域
+    if (OB_FAIL(rc = reorder(input))) {
+      return rc;
+    }
+    const double card     = estimate_card(*input);
+    const int    relation = enumerator.add_relation(card);
+    cards.push_back(card);
+
+    unordered_set<const Table *> tables;
+    OptimizerUtils::collect_tables(*input, tables);
+    for (const Table *table : tables) {
+      table_relations[table] = relation;
+    }
+  }
+
+  vector<PlacedPredicate> placed_predicates;
+  for (unique_ptr<Expression> &predicate : predicates) {
+    unordered_set<const Table *> tables;
+    OptimizerUtils::collect_tables(*predicate, tables);
+    uint64_t relations = 0;
+    double   max_card  = 1;
+    for (const Table *table : tables) {
+      auto iter = table_relations.find(table);
+      if (iter != table_relations.end()) {
+        relations |= bit(iter->second);
+        max_card = std::max(max_card, cards[iter->second]);
+      }
+    }
+    if (popcount(relations) >= 2) {
+      enumerator.add_predicate(relations, SelectivityEstimator::join_selectivity(*predicate, max_card, max_card));
+    }
+    placed_predicates.push_back(PlacedPredicate{relations, std::move(predicate)});
+  }
+
+  const JoinPlanNode *plan = enumerator.solve();
+  ASSERT(plan != nullptr, "join region should have a plan");
+  LOG_TRACE("reorder %d join inputs with %s, estimated cost %f rows %f",
+      static_cast<int>(inputs.size()), enumerator.used_dp() ? "DPccp" : "greedy", plan->cost, plan->card);
+  oper = build(*plan, inputs, placed_predicates);
+  return rc;
+}
+
+int JoinOrderOptimizer::count_region_inputs(LogicalOperator &oper)
+{
+  if (!is_inner_join(oper)) {
+    return 1;
+  }
+  int count = 0;
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    count += count_region_inputs(*child);
+  }
+  return count;
+}
+
+void JoinOrderOptimizer::collect_region(unique_ptr<LogicalOperator> &oper, vector<unique_ptr<LogicalOperator>> &inputs,
+    vector<unique_ptr<Expression>> &predicates)
+{
+  if (!is_inner_join(*oper)) {
+    inputs.emplace_back(std::move(oper));
+    return;
+  }
+  for (unique_ptr<Expression> &predicate : static_cast<JoinLogicalOperator &>(*oper).get_join_predicates()) {
+    predicates.emplace_back(std::move(predicate));
+  }
+  for (unique_ptr<LogicalOperator> &child : oper->children()) {
+    collect_region(child, inputs, predicates);
+  }
+}
+
+double JoinOrderOptimizer::estimate_card(LogicalOperator &oper)
+{
+  vector<unique_ptr<LogicalProperty>> child_props;
+  vector<LogicalProperty *>           child_prop_ptrs;
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    child_props.emplace_back(make_unique<LogicalProperty>(static_cast<int>(estimate_card(*child))));
+    child_prop_ptrs.push_back(child_props.back().get());
+  }
+  unique_ptr<LogicalProperty> prop = oper.find_log_prop(child_prop_ptrs);
+  if (prop != nullptr) {
+    return prop->get_card();
+  }
+  return child_prop_ptrs.empty() ? 1 : child_prop_ptrs.front()->get_card();
+}
+
+unique_ptr<LogicalOperator> JoinOrderOptimizer::build(
+    const JoinPlanNode &node, vector<unique_ptr<LogicalOperator>> &inputs, vector<PlacedPredicate> &predicates)
+{
+  if (node.is_leaf()) {
+    return std::move(inputs[node.relation]);
+  }
+
+  // 条件放在覆盖它引用的所有表的最低的连接上
+  vector<PlacedPredicate> outer_predicates;
+  vector<PlacedPredicate> inner_predicates;
+  auto                    join = make_unique<JoinLogicalOperator>();
+  for (PlacedPredicate &predicate : predicates) {
+    if (!node.outer->is_leaf() && is_subset(predicate.relations, node.outer->relations)) {
+      outer_predicates.emplace_back(std::move(predicate));
+    } else if (!node.inner->is_leaf() && is_subset(predicate.relations, node.inner->relations)) {
+      inner_predicates.emplace_back(std::move(predicate));
+    } else {
+      join->add_join_predicate(std::move(predicate.expression));
+    }
+  }
+  join->add_child(build(*node.outer, inputs, outer_predicates));
+  join->add_child(build(*node.inner, inputs, inner_predicates));
+  return join;
+}
@@ -0,0 +1,150 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+
+#pragma once
+
+#include "common/lang/deque.h"
+#include "common/lang/memory.h"
+#include "common/lang/unordered_map.h"
+#include "common/lang/utility.h"
+#include "common/lang/vector.h"
+#include "common/sys/rc.h"
+#include "common/types.h"
+#include "sql/optimizer/cascade/cost_model.h"
+
+class Expression;
+class LogicalOperator;
+
+/**
+ * @brief A join tree chosen by JoinOrderEnumerator
+ */
+struct JoinPlanNode
+{
+  uint64_t            relations = 0;        ///< bitmap of the relations joined by this node
+  double              card      = 0;        ///< estimated number of output rows
+  double              cost      = 0;        ///< cost of the joins in this subtree
+  int                 relation  = -1;       ///< relation index of a leaf, -1 for a join
+  const JoinPlanNode *outer     = nullptr;  ///< left input of a join
+  const JoinPlanNode *inner     = nullptr;  ///< right input of a join
+
+  bool is_leaf() const { return relation >= 0; }
+};
+
+/**
+ * @brief Chooses the order of a sequence of inner joins
+ * @details Relations are the vertices of the join graph and every join predicate is an edge
+ * between the relations it references. With at most DP_THRESHOLD relations, the cheapest bushy
+ * tree without cross products is found by dynamic programming over connected subgraphs (DPccp,
+ * Moerkotte and Neumann, VLDB 2006), which visits every connected subgraph / connected complement
+ * pair exactly once instead of all subset pairs. Larger graphs, and graphs that are not connected,
+ * use greedy operator ordering: repeatedly join the two plans whose join is the cheapest,
+ * preferring pairs connected by a predicate.
+ *
+ * The cardinality of a set of relations is the product of the cardinalities of the relations and
+ * the selectivities of the predicates among them, so it does not depend on the join order.
+ * The cost of each join comes from CostModel, the same formula the cascade optimizer uses.
+ */
+class JoinOrderEnumerator
+{
+public:
+  static constexpr int DP_THRESHOLD  = 12;
+  static constexpr int MAX_RELATIONS = 64;
+
+  explicit JoinOrderEnumerator(CostModel &cost_model) : cost_model_(cost_model) {}
+
+  /**
+   * @return index of the new relation
+   */
+  int add_relation(double card);
+
+  /**
+   * @param relations bitmap of the relations referenced by the predicate, at least two of them
+   */
+  void add_predicate(uint64_t relations, double selectivity);
+
+  /**
+   * @return the cheapest join tree of all relations, owned by the enumerator
+   */
+  const JoinPlanNode *solve();
+
+  /// whether the last solve used dynamic programming
+  bool used_dp() const { return used_dp_; }
+
+  /// number of connected subgraph / complement pairs enumerated by the last DPccp
+  int enumerated_pairs() const { return static_cast<int>(pairs_.size()); }
+
+private:
+  struct Edge
+  {
+    uint64_t relations;
+    double   selectivity;
+  };
+
+  const JoinPlanNode *solve_dp();
+  const JoinPlanNode *solve_greedy();
+
+  bool     connected() const;
+  uint64_t neighbors(uint64_t relations) const;
+  double   cardinality(uint64_t relations);
+
+  /// the cheaper one of (left join right) and (right join left)
+  JoinPlanNode make_join(const JoinPlanNode *left, const JoinPlanNode *right);
+  void         emit_pair(uint64_t left, uint64_t right);
+
+  void emit_csg(uint64_t s1);
+  void enumerate_csg_rec(uint64_t s1, uint64_t excluded);
+  void enumerate_cmp_rec(uint64_t s1, uint64_t s2, uint64_t excluded);
+
+private:
+  CostModel       &cost_model_;
+  vector<double>   relation_cards_;
+  vector<Edge>     edges_;
+  vector<uint64_t> adjacency_;  ///< neighbors of every relation through predicates on two relations
+  bool             used_dp_ = false;
+
+  deque<JoinPlanNode>                           nodes_;
+  unordered_map<uint64_t, const JoinPlanNode *> best_plans_;
+  unordered_map<uint64_t, double>               cards_;
+  vector<pair<uint64_t, uint64_t>>              pairs_;  ///< csg-cmp pairs found by DPccp
+};
+
+/**
+ * @brief Reorders the inner joins of a logical plan before it is optimized by the cascade optimizer
+ * @details Adjacent JOIN operators form a join region. The inputs of the region become relations,
+ * join predicates become edges, and the region is rebuilt from the tree chosen by JoinOrderEnumerator.
+ * Every predicate is placed on the lowest join that covers all the relations it references.
+ * The cardinality of an input comes from the logical properties, i.e. from the table statistics.
+ * The join commutativity and associativity rules of the cascade optimizer explore the neighborhood
+ * of this order afterwards.
+ */
+class JoinOrderOptimizer
+{
+public:
+  RC reorder(unique_ptr<LogicalOperator> &oper);
+
+private:
+  struct PlacedPredicate
+  {
+    uint64_t               relations;
+    unique_ptr<Expression> expression;
+  };
+
+  static int    count_region_inputs(LogicalOperator &oper);
+  static void   collect_region(unique_ptr<LogicalOperator> &oper, vector<unique_ptr<LogicalOperator>> &inputs,
+        vector<unique_ptr<Expression>> &predicates);
+  static double estimate_card(LogicalOperator &oper);
+
+  static unique_ptr<LogicalOperator> build(const JoinPlanNode &node, vector<unique_ptr<LogicalOperator>> &inputs,
+      vector<PlacedPredicate> &predicates);
+
+private:
+  CostModel cost_model_;
+};
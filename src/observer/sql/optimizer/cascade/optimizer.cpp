@@ -44,6 +44,10 @@ std::unique_ptr<PhysicalOperator> Optimizer::choose_best_plan(int root_group_id)
   context_->get_memo().release_operator(winner_contents);
   PhysicalOperator* winner_phys = dynamic_cast<PhysicalOperator*>(winner_contents);
   LOG_TRACE("winner: %d", winner_phys->type());
+  LogicalProperty *log_prop = root_group->get_logical_prop();
+  if (log_prop != nullptr) {
+    winner_phys->set_estimate(log_prop->get_card(), winner->get_cost());
+  }
   for (const auto& child : winner->get_child_group_ids()) {
     winner_phys->add_child(choose_best_plan(child));
   }
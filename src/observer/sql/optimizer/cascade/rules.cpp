@@ -10,15 +10,22 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/optimizer/cascade/rules.h"
 #include "sql/optimizer/cascade/implementation_rules.h"
+#include "sql/optimizer/cascade/transformation_rules.h"
 #include "sql/optimizer/cascade/group_expr.h"
 
 RuleSet::RuleSet()
 {
   add_rule(RuleSetName::PHYSICAL_IMPLEMENTATION, new LogicalProjectionToProjection());
   add_rule(RuleSetName::PHYSICAL_IMPLEMENTATION, new LogicalGetToPhysicalSeqScan());
+  add_rule(RuleSetName::PHYSICAL_IMPLEMENTATION, new LogicalGetToPhysicalIndexScan());
   add_rule(RuleSetName::PHYSICAL_IMPLEMENTATION, new LogicalInsertToInsert());
   add_rule(RuleSetName::PHYSICAL_IMPLEMENTATION, new LogicalExplainToExplain());
   add_rule(RuleSetName::PHYSICAL_IMPLEMENTATION, new LogicalCalcToCalc());
   add_rule(RuleSetName::PHYSICAL_IMPLEMENTATION, new LogicalDeleteToDelete());
   add_rule(RuleSetName::PHYSICAL_IMPLEMENTATION, new LogicalPredicateToPredicate());
+  add_rule(RuleSetName::PHYSICAL_IMPLEMENTATION, new LogicalInnerJoinToNestedLoopJoin());
+  add_rule(RuleSetName::PHYSICAL_IMPLEMENTATION, new LogicalSemiJoinToHashJoin());
+
+  add_rule(RuleSetName::LOGICAL_TRANSFORMATION, new JoinCommutativity());
+  add_rule(RuleSetName::LOGICAL_TRANSFORMATION, new JoinAssociativity());
 }
\ No newline at end of file
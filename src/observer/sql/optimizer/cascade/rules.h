@@ -20,7 +20,8 @@ See the Mulan PSL v2 for more details. */
 enum class RuleType : uint32_t
 {
   // Transformation rules (logical -> logical)
-  // TODO: currently, we don't have transformation rules
+  JOIN_COMMUTATIVITY,
+  JOIN_ASSOCIATIVITY,
 
   // Don't move this one
   LogicalPhysicalDelimiter,
@@ -34,6 +35,7 @@ enum class RuleType : uint32_t
   AGGREGATE_TO_PHYSICAL,
   INNER_JOIN_TO_NL_JOIN,
   INNER_JOIN_TO_HASH_JOIN,
+  SEMI_JOIN_TO_HASH_JOIN,
   IMPLEMENT_LIMIT,
   PROJECTION_TO_PHYSOCAL,
   ANALYZE_TO_PHYSICAL,
@@ -52,6 +54,7 @@ enum class RuleType : uint32_t
 enum class RuleSetName : uint32_t
 {
   // TODO: add more rule sets
+  LOGICAL_TRANSFORMATION,
   PHYSICAL_IMPLEMENTATION
 };
 
@@ -0,0 +1,173 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/optimizer/cascade/selectivity.h"
+#include "catalog/catalog.h"
+#include "common/lang/algorithm.h"
+#include "sql/expr/expression.h"
+#include "storage/table/table.h"
+
+namespace {
+/// a op b 等价于 b flip(op) a
+CompOp flip_comp(CompOp comp)
+{
+  switch (comp) {
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case LESS_THAN: return GREAT_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    default: return comp;
+  }
+}
+
+double default_selectivity(CompOp comp)
+{
+  switch (comp) {
+    case EQUAL_TO: return ColumnStats::DEFAULT_EQUAL_SEL;
+    case NOT_EQUAL: return 1 - ColumnStats::DEFAULT_EQUAL_SEL;
+    default: return ColumnStats::DEFAULT_RANGE_SEL;
+  }
+}
+}  // namespace
+
+const ColumnStats *SelectivityEstimator::find_column_stats(const FieldExpr &field)
+{
+  const Table *table = field.field().table();
+  if (table == nullptr) {
+    return nullptr;
+  }
+  const TableStats &table_stats = Catalog::get_instance().get_table_stats(table->table_id());
+  return table_stats.find_column_stats(field.field_name());
+}
+
+double SelectivityEstimator::ndv(const FieldExpr &field)
+{
+  const ColumnStats *stats = find_column_stats(field);
+  return stats == nullptr ? 0 : stats->ndv;
+}
+
+double SelectivityEstimator::estimate(vector<unique_ptr<Expression>> &predicates)
+{
+  double selectivity = 1;
+  for (unique_ptr<Expression> &predicate : predicates) {
+    selectivity *= estimate(*predicate);
+  }
+  return selectivity;
+}
+
+double SelectivityEstimator::estimate(Expression &predicate)
+{
+  switch (predicate.type()) {
+    case ExprType::COMPARISON: return estimate_comparison(static_cast<ComparisonExpr &>(predicate));
+    case ExprType::CONJUNCTION: {
+      auto  &conjunction = static_cast<ConjunctionExpr &>(predicate);
+      double selectivity = conjunction.conjunction_type() == ConjunctionExpr::Type::AND ? 1 : 0;
+      for (unique_ptr<Expression> &child : conjunction.children()) {
+        const double child_sel = estimate(*child);
+        if (conjunction.conjunction_type() == ConjunctionExpr::Type::AND) {
+          selectivity *= child_sel;
+        } else {
+          selectivity = selectivity + child_sel - selectivity * child_sel;
+        }
+      }
+      return selectivity;
+    }
+    case ExprType::VALUE: return static_cast<ValueExpr &>(predicate).get_value().get_boolean() ? 1 : 0;
+    default: return DEFAULT_SEL;
+  }
+}
+
+double SelectivityEstimator::join_selectivity(Expression &predicate, double left_card, double right_card)
+{
+  if (predicate.type() != ExprType::COMPARISON) {
+    return estimate(predicate);
+  }
+  auto &comparison = static_cast<ComparisonExpr &>(predicate);
+  auto &left       = comparison.left();
+  auto &right      = comparison.right();
+  if (comparison.comp() != EQUAL_TO || left->type() != ExprType::FIELD || right->type() != ExprType::FIELD) {
+    return estimate(predicate);
+  }
+  // 没有统计信息时，认为连接列在较大的一边是唯一的
+  double max_ndv =
+      std::max(ndv(static_cast<const FieldExpr &>(*left)), ndv(static_cast<const FieldExpr &>(*right)));
+  if (max_ndv < 1) {
+    max_ndv = std::max(left_card, right_card);
+  }
+  return 1 / std::max(max_ndv, 1.0);
+}
+
+double SelectivityEstimator::range_selectivity(
+    const FieldExpr &field, const Value *left, bool left_inclusive, const Value *right, bool right_inclusive)
+{
+  const ColumnStats *stats = find_column_stats(field);
+  if (left != nullptr && right != nullptr && left_inclusive && right_inclusive && left->compare(*right) == 0) {
+    return stats == nullptr ? ColumnStats::DEFAULT_EQUAL_SEL : stats->equal_selectivity(*left);
+  }
+  if (stats == nullptr) {
+    double selectivity = 1;
+    if (left != nullptr) {
+      selectivity *= ColumnStats::DEFAULT_RANGE_SEL;
+    }
+    if (right != nullptr) {
+      selectivity *= ColumnStats::DEFAULT_RANGE_SEL;
+    }
+    return selectivity;
+  }
+
+  // 区间之外的行：小于左边界的、大于右边界的以及空值
+  double selectivity = 1 - stats->null_frac;
+  if (left != nullptr) {
+    selectivity -= stats->less_selectivity(*left, !left_inclusive);
+  }
+  if (right != nullptr) {
+    selectivity -= stats->greater_selectivity(*right, !right_inclusive);
+  }
+  return std::clamp(selectivity, 0.0, 1.0);
+}
+
+double SelectivityEstimator::estimate_comparison(ComparisonExpr &expr)
+{
+  Expression *left  = expr.left().get();
+  Expression *right = expr.right().get();
+  CompOp      comp  = expr.comp();
+  if (left->type() == ExprType::VALUE && right->type() == ExprType::FIELD) {
+    std::swap(left, right);
+    comp = flip_comp(comp);
+  }
+
+  if (left->type() == ExprType::FIELD && right->type() == ExprType::FIELD) {
+    // 连接条件：a = b 时每个值匹配 1/max(ndv(a), ndv(b))
+    const double max_ndv =
+        std::max(ndv(static_cast<const FieldExpr &>(*left)), ndv(static_cast<const FieldExpr &>(*right)));
+    if (comp == EQUAL_TO && max_ndv >= 1) {
+      return 1 / max_ndv;
+    }
+    return default_selectivity(comp);
+  }
+
+  if (left->type() != ExprType::FIELD || right->type() != ExprType::VALUE) {
+    return default_selectivity(comp);
+  }
+  const ColumnStats *stats = find_column_stats(static_cast<const FieldExpr &>(*left));
+  if (stats == nullptr) {
+    return default_selectivity(comp);
+  }
+  const Value &value = static_cast<const ValueExpr &>(*right).get_value();
+  switch (comp) {
+    case EQUAL_TO: return stats->equal_selectivity(value);
+    case NOT_EQUAL: return std::max(0.0, 1 - stats->null_frac - stats->equal_selectivity(value));
+    case LESS_THAN: return stats->less_selectivity(value, false);
+    case LESS_EQUAL: return stats->less_selectivity(value, true);
+    case GREAT_THAN: return stats->greater_selectivity(value, false);
+    case GREAT_EQUAL: return stats->greater_selectivity(value, true);
+    default: return DEFAULT_SEL;
+  }
+}
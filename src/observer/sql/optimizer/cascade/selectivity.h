@@ -0,0 +1,70 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/memory.h"
+#include "common/lang/vector.h"
+
+class ColumnStats;
+class ComparisonExpr;
+class Expression;
+class FieldExpr;
+class Value;
+
+/**
+ * @brief Estimates the selectivity of predicates with the column statistics from ANALYZE TABLE
+ * @details Comparisons between a column and a constant use the MCV list and the equi-depth
+ * histogram of the column, equi-joins use the number of distinct values. AND multiplies the
+ * selectivities of its children (columns are assumed to be independent) and OR combines them
+ * as P(A) + P(B) - P(A)P(B). Without statistics the usual default selectivities are used.
+ */
+class SelectivityEstimator
+{
+public:
+  static constexpr double DEFAULT_SEL = 1.0 / 3;
+
+  /**
+   * @brief Fraction of rows that satisfy the predicate, in [0, 1]
+   */
+  static double estimate(Expression &predicate);
+
+  /**
+   * @brief Fraction of rows that satisfy all the predicates
+   */
+  static double estimate(vector<unique_ptr<Expression>> &predicates);
+
+  /**
+   * @brief Fraction of the cross product of two inputs that satisfies a join predicate
+   * @details Without statistics an equi-join is assumed to match a key of the larger input, so the
+   * selectivity is 1/max(left_card, right_card).
+   */
+  static double join_selectivity(Expression &predicate, double left_card, double right_card);
+
+  /**
+   * @brief Fraction of rows whose column value falls in a range
+   * @details Used to estimate the rows an index range scan visits. A null bound leaves that side
+   * of the range open. With statistics the histogram covers both bounds at once, so a range such
+   * as a > 1 AND a < 5 is not treated as two independent predicates.
+   */
+  static double range_selectivity(const FieldExpr &field, const Value *left, bool left_inclusive,
+      const Value *right, bool right_inclusive);
+
+  /**
+   * @brief Number of distinct values of a column
+   * @return 0 if the column has not been analyzed
+   */
+  static double ndv(const FieldExpr &field);
+
+  static const ColumnStats *find_column_stats(const FieldExpr &field);
+
+private:
+  static double estimate_comparison(ComparisonExpr &expr);
+};
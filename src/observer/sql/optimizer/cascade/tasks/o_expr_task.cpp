@@ -20,9 +20,10 @@ void OptimizeExpression::perform()
   std::vector<RuleWithPromise> valid_rules;
 
   // Construct valid transformation rules from rule set
-  // TODO: add transformation rules
-  auto phys_rules = get_rule_set().get_rules_by_name(RuleSetName::PHYSICAL_IMPLEMENTATION);
-  for (auto &rule : phys_rules) {
+  vector<Rule *> rules = get_rule_set().get_rules_by_name(RuleSetName::LOGICAL_TRANSFORMATION);
+  auto &phys_rules = get_rule_set().get_rules_by_name(RuleSetName::PHYSICAL_IMPLEMENTATION);
+  rules.insert(rules.end(), phys_rules.begin(), phys_rules.end());
+  for (auto &rule : rules) {
     // check if we can apply the rule
     bool already_explored = group_expr_->rule_explored(rule);
     if (already_explored) {
@@ -41,6 +41,11 @@ void OptimizeInputs::perform()
       push_task(new OptimizeInputs(this));
       push_task(new OptimizeGroup(child_group, context_));
       return;
+    } else {
+      // the child group has been optimized but no physical plan can be found for it,
+      // so this expression cannot be implemented either
+      LOG_TRACE("child group %d has no winner", child_group->get_id());
+      break;
     }
   }
 
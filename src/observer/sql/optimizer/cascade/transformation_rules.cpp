@@ -0,0 +1,119 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+
+#include "sql/optimizer/cascade/transformation_rules.h"
+#include "sql/operator/join_logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+#include "sql/optimizer/optimizer_utils.h"
+
+namespace {
+void collect_tables(OperatorNode *node, unordered_set<const Table *> &tables)
+{
+  if (node->get_op_type() == OpType::LOGICALGET) {
+    tables.insert(static_cast<TableGetLogicalOperator *>(node)->table());
+  }
+  for (OperatorNode *child : node->get_general_children()) {
+    collect_tables(child, tables);
+  }
+}
+}  // namespace
+
+// -------------------------------------------------------------------------------------------------
+// JoinCommutativity
+// -------------------------------------------------------------------------------------------------
+JoinCommutativity::JoinCommutativity()
+{
+  type_          = RuleType::JOIN_COMMUTATIVITY;
+  match_pattern_ = unique_ptr<Pattern>(new Pattern(OpType::LOGICALINNERJOIN));
+  match_pattern_->add_child(new Pattern(OpType::LEAF));
+  match_pattern_->add_child(new Pattern(OpType::LEAF));
+}
+
+void JoinCommutativity::transform(
+    OperatorNode *input, std::vector<std::unique_ptr<OperatorNode>> *transformed, OptimizerContext *context) const
+{
+  auto  join_oper = dynamic_cast<JoinLogicalOperator *>(input);
+  auto &children  = join_oper->get_general_children();
+
+  auto new_join = make_unique<JoinLogicalOperator>();
+  for (unique_ptr<Expression> &predicate : join_oper->copy_join_predicates()) {
+    new_join->add_join_predicate(std::move(predicate));
+  }
+  new_join->add_general_child(children[1]);
+  new_join->add_general_child(children[0]);
+  transformed->emplace_back(std::move(new_join));
+}
+
+// -------------------------------------------------------------------------------------------------
+// JoinAssociativity
+// -------------------------------------------------------------------------------------------------
+JoinAssociativity::JoinAssociativity()
+{
+  type_          = RuleType::JOIN_ASSOCIATIVITY;
+  match_pattern_ = unique_ptr<Pattern>(new Pattern(OpType::LOGICALINNERJOIN));
+  auto left      = new Pattern(OpType::LOGICALINNERJOIN);
+  left->add_child(new Pattern(OpType::LEAF));
+  left->add_child(new Pattern(OpType::LEAF));
+  match_pattern_->add_child(left);
+  match_pattern_->add_child(new Pattern(OpType::LEAF));
+}
+
+void JoinAssociativity::transform(
+    OperatorNode *input, std::vector<std::unique_ptr<OperatorNode>> *transformed, OptimizerContext *context) const
+{
+  auto top_join = dynamic_cast<JoinLogicalOperator *>(input);
+  if (top_join->get_general_children()[0]->get_op_type() != OpType::LOGICALINNERJOIN) {
+    return;
+  }
+  auto          left_join = static_cast<JoinLogicalOperator *>(top_join->get_general_children()[0]);
+  OperatorNode *a         = left_join->get_general_children()[0];
+  OperatorNode *b         = left_join->get_general_children()[1];
+  OperatorNode *c         = top_join->get_general_children()[1];
+
+  unordered_set<const Table *> bc_tables;
+  collect_tables(b, bc_tables);
+  collect_tables(c, bc_tables);
+
+  vector<unique_ptr<Expression>> predicates = top_join->copy_join_predicates();
+  for (unique_ptr<Expression> &predicate : left_join->copy_join_predicates()) {
+    predicates.emplace_back(std::move(predicate));
+  }
+
+  auto new_top   = make_unique<JoinLogicalOperator>();
+  auto new_right = make_unique<JoinLogicalOperator>();
+  for (unique_ptr<Expression> &predicate : predicates) {
+    unordered_set<const Table *> tables;
+    OptimizerUtils::collect_tables(*predicate, tables);
+    bool only_bc = true;
+    for (const Table *table : tables) {
+      if (bc_tables.count(table) == 0) {
+        only_bc = false;
+        break;
+      }
+    }
+    if (only_bc) {
+      new_right->add_join_predicate(std::move(predicate));
+    } else {
+      new_top->add_join_predicate(std::move(predicate));
+    }
+  }
+  if (new_right->get_join_predicates().empty()) {
+    return;
+  }
+
+  new_right->add_general_child(b);
+  new_right->add_general_child(c);
+  new_top->add_general_child(a);
+  new_top->add_general_child(new_right.get());
+  // the new right child becomes a new expression in the memo, so the memo owns it
+  context->record_operator_node_in_memo(std::move(new_right));
+  transformed->emplace_back(std::move(new_top));
+}
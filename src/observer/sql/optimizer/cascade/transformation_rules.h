@@ -0,0 +1,41 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+
+#pragma once
+
+#include "sql/optimizer/cascade/rules.h"
+
+/**
+ * Rule transforms (A join B) -> (B join A)
+ * The cost of a nested loop join depends on which input is the outer one.
+ */
+class JoinCommutativity : public Rule
+{
+public:
+  JoinCommutativity();
+
+  void transform(OperatorNode *input, std::vector<std::unique_ptr<OperatorNode>> *transformed,
+      OptimizerContext *context) const override;
+};
+
+/**
+ * Rule transforms ((A join B) join C) -> (A join (B join C))
+ * Join predicates are redistributed between the two new joins. The rule is not applied
+ * if (B join C) would be a cross product.
+ */
+class JoinAssociativity : public Rule
+{
+public:
+  JoinAssociativity();
+
+  void transform(OperatorNode *input, std::vector<std::unique_ptr<OperatorNode>> *transformed,
+      OptimizerContext *context) const override;
+};
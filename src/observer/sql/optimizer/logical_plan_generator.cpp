@@ -210,6 +210,18 @@ RC LogicalPlanGenerator::create_plan(FilterStmt *filter_stmt, unique_ptr<Logical
     const FilterObj &filter_obj_left  = filter_unit->left();
     const FilterObj &filter_obj_right = filter_unit->right();
 
+    if (filter_unit->sub_query() != nullptr) {
+      // 子查询在改写阶段展开成半连接或反连接
+      unique_ptr<Expression> left;
+      if (filter_unit->sub_query_type() != SubQueryType::EXISTS &&
+          filter_unit->sub_query_type() != SubQueryType::NOT_EXISTS) {
+        left = make_unique<FieldExpr>(filter_obj_left.field);
+      }
+      cmp_exprs.emplace_back(make_unique<SubQueryExpr>(
+          filter_unit->sub_query_type(), filter_unit->comp(), std::move(left), filter_unit->sub_query()));
+      continue;
+    }
+
     unique_ptr<Expression> left(filter_obj_left.is_attr
                                     ? static_cast<Expression *>(new FieldExpr(filter_obj_left.field))
                                     : static_cast<Expression *>(new ValueExpr(filter_obj_left.value)));
@@ -218,6 +230,11 @@ RC LogicalPlanGenerator::create_plan(FilterStmt *filter_stmt, unique_ptr<Logical
                                      ? static_cast<Expression *>(new FieldExpr(filter_obj_right.field))
                                      : static_cast<Expression *>(new ValueExpr(filter_obj_right.value)));
 
+    if (left->value_type() != right->value_type()) {
+      fold_value_to_field_type(left, right);
+      fold_value_to_field_type(right, left);
+    }
+
     if (left->value_type() != right->value_type()) {
       auto left_to_right_cost = implicit_cast_cost(left->value_type(), right->value_type());
       auto right_to_left_cost = implicit_cast_cost(right->value_type(), left->value_type());
@@ -277,6 +294,26 @@ int LogicalPlanGenerator::implicit_cast_cost(AttrType from, AttrType to)
   return DataType::type_instance(from)->cast_cost(to);
 }
 
+void LogicalPlanGenerator::fold_value_to_field_type(
+    const unique_ptr<Expression> &field_expr, unique_ptr<Expression> &value_expr)
+{
+  if (field_expr->type() != ExprType::FIELD || value_expr->type() != ExprType::VALUE ||
+      implicit_cast_cost(value_expr->value_type(), field_expr->value_type()) == INT32_MAX) {
+    return;
+  }
+
+  const Value &value = static_cast<ValueExpr *>(value_expr.get())->get_value();
+  Value        casted_value;
+  Value        restored_value;
+  // 转换回原来的类型后不变才是无损的，比如 bigint 超出 int 的范围、浮点数有小数部分时都不转换
+  if (OB_FAIL(Value::cast_to(value, field_expr->value_type(), casted_value)) ||
+      OB_FAIL(Value::cast_to(casted_value, value.attr_type(), restored_value)) ||
+      restored_value.compare(value) != 0) {
+    return;
+  }
+  value_expr = make_unique<ValueExpr>(casted_value);
+}
+
 RC LogicalPlanGenerator::create_plan(InsertStmt *insert_stmt, unique_ptr<LogicalOperator> &logical_operator)
 {
   Table        *table = insert_stmt->table();
@@ -325,7 +362,7 @@ RC LogicalPlanGenerator::create_plan(ExplainStmt *explain_stmt, unique_ptr<Logic
     return rc;
   }
 
-  logical_operator = unique_ptr<LogicalOperator>(new ExplainLogicalOperator);
+  logical_operator = unique_ptr<LogicalOperator>(new ExplainLogicalOperator(explain_stmt->analyze()));
   logical_operator->add_child(std::move(child_oper));
   return rc;
 }
@@ -49,4 +49,11 @@ private:
   RC bind_order_by_plan(SelectStmt *select_stmt);
 
   int implicit_cast_cost(AttrType from, AttrType to);
+
+  /**
+   * @brief 字段与常量比较时，如果常量可以无损地转换成字段的类型，就转换常量
+   * @details 这样比较的一边仍然是字段本身而不是类型转换表达式，可以使用索引与列的统计信息。
+   * 比如 int 字段与整数常量（解析成 bigint）比较。
+   */
+  void fold_value_to_field_type(const unique_ptr<Expression> &field_expr, unique_ptr<Expression> &value_expr);
 };
@@ -22,8 +22,12 @@ See the Mulan PSL v2 for more details. */
 #include "common/log/log.h"
 #include "event/session_event.h"
 #include "event/sql_event.h"
+#include "sql/executor/analyze_table_executor.h"
 #include "sql/operator/logical_operator.h"
+#include "sql/operator/pipeline.h"
+#include "sql/operator/table_get_logical_operator.h"
 #include "sql/stmt/stmt.h"
+#include "sql/optimizer/cascade/join_order.h"
 #include "sql/optimizer/cascade/optimizer.h"
 #include "sql/optimizer/optimizer_utils.h"
 
@@ -51,12 +55,26 @@ RC OptimizeStage::handle_request(SQLStageEvent *sql_event)
     return rc;
   }
 
+  Session *session = sql_event->session_event()->session();
+  if (session->use_cascade()) {
+    rc = refresh_table_stats(*logical_operator, session);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to refresh table stats. rc=%s", strrc(rc));
+      return rc;
+    }
+    rc = JoinOrderOptimizer().reorder(logical_operator);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to reorder joins. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
   // TODO: better way
   logical_operator->generate_general_child();
   Optimizer optimizer;
   // TODO: error handle
   unique_ptr<PhysicalOperator> physical_operator;
-  if (sql_event->session_event()->session()->use_cascade()) {
+  if (session->use_cascade()) {
     physical_operator = optimizer.optimize(logical_operator.get());
     if (!physical_operator) {
       rc = RC::INTERNAL;
@@ -67,7 +85,7 @@ RC OptimizeStage::handle_request(SQLStageEvent *sql_event)
 
     LOG_INFO("cascade physical plan:\n%s", phys_plan_str.c_str());
   } else {
-    rc = generate_physical_plan(logical_operator, physical_operator, sql_event->session_event()->session());
+    rc = generate_physical_plan(logical_operator, physical_operator, session);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to generate physical plan. rc=%s", strrc(rc));
       return rc;
@@ -85,6 +103,22 @@ RC OptimizeStage::optimize(unique_ptr<LogicalOperator> &oper)
   return RC::SUCCESS;
 }
 
+RC OptimizeStage::refresh_table_stats(LogicalOperator &logical_operator, Session *session)
+{
+  RC rc = RC::SUCCESS;
+  if (logical_operator.type() == LogicalOperatorType::TABLE_GET) {
+    Table *table = static_cast<TableGetLogicalOperator &>(logical_operator).table();
+    rc           = AnalyzeTableExecutor::auto_analyze(table, session->current_trx(), session->parallel_degree());
+  }
+  for (unique_ptr<LogicalOperator> &child : logical_operator.children()) {
+    if (OB_FAIL(rc)) {
+      break;
+    }
+    rc = refresh_table_stats(*child, session);
+  }
+  return rc;
+}
+
 RC OptimizeStage::generate_physical_plan(
     unique_ptr<LogicalOperator> &logical_operator, unique_ptr<PhysicalOperator> &physical_operator, Session *session)
 {
@@ -92,7 +126,11 @@ RC OptimizeStage::generate_physical_plan(
   if (session->get_execution_mode() == ExecutionMode::CHUNK_ITERATOR && LogicalOperator::can_generate_vectorized_operator(logical_operator->type())) {
     LOG_TRACE("use chunk iterator");
     session->set_used_chunk_mode(true);
+    PhysicalPlanGenerator::prune_columns(*logical_operator);
     rc    = physical_plan_generator_.create_vec(*logical_operator, physical_operator, session);
+    if (OB_SUCC(rc) && session->pipeline_execution()) {
+      rc = PipelineBuilder::build(physical_operator);
+    }
   } else {
     LOG_TRACE("use tuple iterator");
     session->set_used_chunk_mode(false);
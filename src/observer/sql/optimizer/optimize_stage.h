@@ -64,6 +64,12 @@ private:
    */
   RC optimize(unique_ptr<LogicalOperator> &logical_operator);
 
+  /**
+   * @brief 基于代价优化之前，重新收集计划中过期的表统计信息
+   * @details 表上修改的行数超过阈值时统计信息过期，参考 AnalyzeTableExecutor::auto_analyze
+   */
+  RC refresh_table_stats(LogicalOperator &logical_operator, Session *session);
+
   /**
    * @brief 根据逻辑计划生成物理计划
    * @details 生成的物理计划就可以直接让后面的执行器完全按照物理计划执行了。
@@ -9,6 +9,11 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "sql/optimizer/optimizer_utils.h"
+#include "common/lang/iomanip.h"
+#include "sql/expr/expression_iterator.h"
+#include "sql/operator/logical_operator.h"
+#include "sql/operator/join_logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
 
 string OptimizerUtils::dump_physical_plan(const unique_ptr<PhysicalOperator>& children)
 {
@@ -36,6 +41,13 @@ string OptimizerUtils::dump_physical_plan(const unique_ptr<PhysicalOperator>& ch
     if (!param.empty()) {
       os << "(" << param << ")";
     }
+    if (oper->has_estimate()) {
+      os << " rows=" << static_cast<int64_t>(oper->estimated_rows()) << " cost=" << std::fixed << std::setprecision(4)
+         << oper->estimated_cost() << std::defaultfloat;
+    }
+    if (oper->has_actual()) {
+      os << " actual_rows=" << oper->actual_rows() << " loops=" << oper->actual_loops();
+    }
     os << '\n';
 
     if (static_cast<int>(ends.size()) < level + 2) {
@@ -61,4 +73,31 @@ string OptimizerUtils::dump_physical_plan(const unique_ptr<PhysicalOperator>& ch
   to_string(ss, children.get(), level, true /*last_child*/, ends);
 
   return ss.str();
-}
\ No newline at end of file
+}
+
+void OptimizerUtils::collect_tables(Expression &expr, unordered_set<const Table *> &tables)
+{
+  if (expr.type() == ExprType::FIELD) {
+    tables.insert(static_cast<FieldExpr &>(expr).field().table());
+  }
+  ExpressionIterator::iterate_child_expr(expr, [&tables](unique_ptr<Expression> &child) {
+    collect_tables(*child, tables);
+    return RC::SUCCESS;
+  });
+}
+
+void OptimizerUtils::collect_tables(LogicalOperator &oper, unordered_set<const Table *> &tables)
+{
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    tables.insert(static_cast<TableGetLogicalOperator &>(oper).table());
+  }
+  if (oper.type() == LogicalOperatorType::JOIN &&
+      static_cast<JoinLogicalOperator &>(oper).join_type() != JoinType::INNER) {
+    // 半连接与反连接只输出左边的行
+    collect_tables(*oper.children().front(), tables);
+    return;
+  }
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    collect_tables(*child, tables);
+  }
+}
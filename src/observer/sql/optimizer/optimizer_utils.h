@@ -12,10 +12,19 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/lang/string.h"
 #include "common/lang/memory.h"
+#include "common/lang/unordered_set.h"
 #include "sql/operator/physical_operator.h"
 
+class LogicalOperator;
+
 class OptimizerUtils
 {
 public:
   static string dump_physical_plan(const unique_ptr<PhysicalOperator> &root);
+
+  /// 表达式引用的字段所属的表
+  static void collect_tables(Expression &expr, unordered_set<const Table *> &tables);
+
+  /// 逻辑算子树中 TABLE_GET 读取的表。半连接与反连接不输出右边的列，不包含右边的表
+  static void collect_tables(LogicalOperator &oper, unordered_set<const Table *> &tables);
 };
\ No newline at end of file
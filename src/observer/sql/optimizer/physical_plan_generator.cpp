@@ -24,6 +24,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/explain_logical_operator.h"
 #include "sql/operator/explain_physical_operator.h"
 #include "sql/operator/expr_vec_physical_operator.h"
+#include "sql/operator/gather_vec_physical_operator.h"
 #include "sql/operator/group_by_vec_physical_operator.h"
 #include "sql/operator/hash_join_physical_operator.h"
 #include "sql/operator/index_scan_physical_operator.h"
@@ -37,6 +38,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/order_by_limit_vec_physical_operator.h"
 #include "sql/operator/order_by_logical_operator.h"
 #include "sql/operator/order_by_vec_physical_operator.h"
+#include "sql/operator/parallel_group_by_vec_physical_operator.h"
 #include "sql/operator/predicate_logical_operator.h"
 #include "sql/operator/predicate_physical_operator.h"
 #include "sql/operator/project_logical_operator.h"
@@ -53,9 +55,139 @@ See the Mulan PSL v2 for more details. */
 #include "sql/optimizer/physical_plan_generator.h"
 #include "sql/operator/create_materialized_view_physical_operator.h"
 #include "sql/operator/create_materialized_view_logic_operator.h"
+#include "sql/expr/expression_iterator.h"
+#include "common/lang/set.h"
+#include "common/lang/unordered_map.h"
+#include "common/lang/unordered_set.h"
+#include "sql/optimizer/optimizer_utils.h"
 
 using namespace std;
 
+namespace {
+
+using TableFields = unordered_map<const Table *, set<int>>;
+
+void collect_fields(Expression &expr, TableFields &fields)
+{
+  if (expr.type() == ExprType::FIELD) {
+    const Field &field = static_cast<FieldExpr &>(expr).field();
+    fields[field.table()].insert(field.meta()->field_id());
+  }
+  ExpressionIterator::iterate_child_expr(expr, [&fields](unique_ptr<Expression> &child) {
+    collect_fields(*child, fields);
+    return RC::SUCCESS;
+  });
+}
+
+void collect_fields(LogicalOperator &oper, TableFields &fields)
+{
+  for (unique_ptr<Expression> &expr : oper.expressions()) {
+    collect_fields(*expr, fields);
+  }
+  switch (oper.type()) {
+    case LogicalOperatorType::TABLE_GET: {
+      for (unique_ptr<Expression> &expr : static_cast<TableGetLogicalOperator &>(oper).predicates()) {
+        collect_fields(*expr, fields);
+      }
+    } break;
+    case LogicalOperatorType::GROUP_BY: {
+      auto &group_by_oper = static_cast<GroupByLogicalOperator &>(oper);
+      for (unique_ptr<Expression> &expr : group_by_oper.group_by_expressions()) {
+        collect_fields(*expr, fields);
+      }
+      for (Expression *expr : group_by_oper.aggregate_expressions()) {
+        collect_fields(*expr, fields);
+      }
+    } break;
+    case LogicalOperatorType::ORDER_BY: {
+      for (unique_ptr<Expression> &expr : static_cast<OrderByLogicalOperator &>(oper).order_by_exprs()) {
+        collect_fields(*expr, fields);
+      }
+    } break;
+    case LogicalOperatorType::JOIN: {
+      auto &join_oper = static_cast<JoinLogicalOperator &>(oper);
+      for (unique_ptr<Expression> &expr : join_oper.get_join_predicates()) {
+        collect_fields(*expr, fields);
+      }
+      for (unique_ptr<Expression> &expr : join_oper.left_keys()) {
+        collect_fields(*expr, fields);
+      }
+      for (unique_ptr<Expression> &expr : join_oper.right_keys()) {
+        collect_fields(*expr, fields);
+      }
+    } break;
+    default: break;
+  }
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    collect_fields(*child, fields);
+  }
+}
+
+bool covered_by(const unordered_set<const Table *> &tables, const unordered_set<const Table *> &scope)
+{
+  if (tables.empty()) {
+    return false;
+  }
+  for (const Table *table : tables) {
+    if (scope.count(table) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief 连接条件是否可以作为哈希连接的键，即两边分别只引用连接左右两边的表的等值条件
+ * @param left_first 条件的左边在连接的左边计算时为 true
+ */
+bool is_hash_join_key(Expression &predicate, JoinLogicalOperator &join_oper, bool &left_first)
+{
+  if (predicate.type() != ExprType::COMPARISON || static_cast<ComparisonExpr &>(predicate).comp() != EQUAL_TO) {
+    return false;
+  }
+
+  auto                        &comparison = static_cast<ComparisonExpr &>(predicate);
+  unordered_set<const Table *> left_tables, right_tables, expr_left_tables, expr_right_tables;
+  OptimizerUtils::collect_tables(*join_oper.children()[0], left_tables);
+  OptimizerUtils::collect_tables(*join_oper.children()[1], right_tables);
+  OptimizerUtils::collect_tables(*comparison.left(), expr_left_tables);
+  OptimizerUtils::collect_tables(*comparison.right(), expr_right_tables);
+  if (covered_by(expr_left_tables, left_tables) && covered_by(expr_right_tables, right_tables)) {
+    left_first = true;
+    return true;
+  }
+  if (covered_by(expr_left_tables, right_tables) && covered_by(expr_right_tables, left_tables)) {
+    left_first = false;
+    return true;
+  }
+  return false;
+}
+
+void set_referenced_fields(LogicalOperator &oper, const TableFields &fields)
+{
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    auto &table_get_oper = static_cast<TableGetLogicalOperator &>(oper);
+    auto  iter           = fields.find(table_get_oper.table());
+    if (iter == fields.end()) {
+      table_get_oper.set_referenced_fields(vector<int>());
+    } else {
+      table_get_oper.set_referenced_fields(vector<int>(iter->second.begin(), iter->second.end()));
+    }
+  }
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    set_referenced_fields(*child, fields);
+  }
+}
+
+}  // namespace
+
+void PhysicalPlanGenerator::prune_columns(LogicalOperator &logical_operator)
+{
+  TableFields fields;
+  collect_fields(logical_operator, fields);
+  set_referenced_fields(logical_operator, fields);
+}
+
 RC PhysicalPlanGenerator::create(
     LogicalOperator &logical_operator, unique_ptr<PhysicalOperator> &oper, Session *session)
 {
@@ -338,7 +470,7 @@ RC PhysicalPlanGenerator::create_plan(
 
   RC rc = RC::SUCCESS;
 
-  unique_ptr<PhysicalOperator> explain_physical_oper(new ExplainPhysicalOperator);
+  unique_ptr<PhysicalOperator> explain_physical_oper(new ExplainPhysicalOperator(explain_oper.analyze()));
   for (unique_ptr<LogicalOperator> &child_oper : child_opers) {
     unique_ptr<PhysicalOperator> child_physical_oper;
     rc = create(*child_oper, child_physical_oper, session);
@@ -364,29 +496,59 @@ RC PhysicalPlanGenerator::create_plan(
     LOG_WARN("join operator should have 2 children, but have %d", child_opers.size());
     return RC::INTERNAL;
   }
-  if (session->hash_join_on() && can_use_hash_join(join_oper)) {
-    // your code here
-  } else {
-    unique_ptr<PhysicalOperator> join_physical_oper(new NestedLoopJoinPhysicalOperator());
-    for (auto &child_oper : child_opers) {
-      unique_ptr<PhysicalOperator> child_physical_oper;
-      rc = create(*child_oper, child_physical_oper, session);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("failed to create physical child oper. rc=%s", strrc(rc));
-        return rc;
+  unique_ptr<PhysicalOperator> join_physical_oper;
+  // 子查询展开得到的半连接与反连接只有哈希连接的实现
+  if (join_oper.join_type() != JoinType::INNER || !join_oper.left_keys().empty() ||
+      (session->hash_join_on() && can_use_hash_join(join_oper))) {
+    vector<unique_ptr<Expression>> predicates;
+    for (unique_ptr<Expression> &predicate : join_oper.get_join_predicates()) {
+      bool left_first = true;
+      if (!is_hash_join_key(*predicate, join_oper, left_first)) {
+        predicates.emplace_back(std::move(predicate));
+        continue;
       }
+      auto &comparison = static_cast<ComparisonExpr &>(*predicate);
+      if (left_first) {
+        join_oper.add_join_key(std::move(comparison.left()), std::move(comparison.right()));
+      } else {
+        join_oper.add_join_key(std::move(comparison.right()), std::move(comparison.left()));
+      }
+    }
+    join_oper.clear_join_predicates();
 
-      join_physical_oper->add_child(std::move(child_physical_oper));
+    auto hash_join_oper = new HashJoinPhysicalOperator(
+        join_oper.join_type(), std::move(join_oper.left_keys()), std::move(join_oper.right_keys()));
+    hash_join_oper->set_predicates(std::move(predicates));
+    join_physical_oper.reset(hash_join_oper);
+  } else {
+    auto nlj_oper = new NestedLoopJoinPhysicalOperator();
+    nlj_oper->set_predicates(std::move(join_oper.get_join_predicates()));
+    join_physical_oper.reset(nlj_oper);
+  }
+
+  for (auto &child_oper : child_opers) {
+    unique_ptr<PhysicalOperator> child_physical_oper;
+    rc = create(*child_oper, child_physical_oper, session);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to create physical child oper. rc=%s", strrc(rc));
+      return rc;
     }
 
-    oper = std::move(join_physical_oper);
+    join_physical_oper->add_child(std::move(child_physical_oper));
   }
+
+  oper = std::move(join_physical_oper);
   return rc;
 }
 
 bool PhysicalPlanGenerator::can_use_hash_join(JoinLogicalOperator &join_oper)
 {
-  // your code here
+  for (unique_ptr<Expression> &predicate : join_oper.get_join_predicates()) {
+    bool left_first = true;
+    if (is_hash_join_key(*predicate, join_oper, left_first)) {
+      return true;
+    }
+  }
   return false;
 }
 
@@ -414,6 +576,12 @@ RC PhysicalPlanGenerator::create_plan(
         std::move(logical_oper.group_by_expressions()), std::move(logical_oper.aggregate_expressions()));
   }
 
+  // 没有子算子说明输入被恒假的过滤条件裁剪掉了，聚合算子按空输入处理
+  if (logical_oper.children().empty()) {
+    oper = std::move(group_by_oper);
+    return rc;
+  }
+
   ASSERT(logical_oper.children().size() == 1, "group by operator should have 1 child");
 
   LogicalOperator             &child_oper = *logical_oper.children().front();
@@ -435,9 +603,36 @@ RC PhysicalPlanGenerator::create_vec_plan(
 {
   vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
   Table                          *table      = table_get_oper.table();
-  TableScanVecPhysicalOperator   *table_scan_oper =
+
+  // 并行扫描：每个工作线程一个扫描算子，共享同一个 MorselScheduler，谓词各自拷贝一份
+  const int parallel_degree = session != nullptr ? session->parallel_degree() : 1;
+  if (parallel_degree > 1 && table->table_meta().storage_format() == StorageFormat::PAX_FORMAT) {
+    auto scheduler = make_shared<MorselScheduler>();
+    auto gather    = make_unique<GatherVecPhysicalOperator>(scheduler);
+    for (int i = 0; i < parallel_degree; i++) {
+      vector<unique_ptr<Expression>> worker_predicates;
+      for (const unique_ptr<Expression> &predicate : predicates) {
+        worker_predicates.emplace_back(predicate->copy());
+      }
+      auto scan_oper = make_unique<TableScanVecPhysicalOperator>(table, table_get_oper.read_write_mode());
+      scan_oper->set_predicates(std::move(worker_predicates));
+      if (table_get_oper.has_referenced_fields()) {
+        scan_oper->set_referenced_fields(table_get_oper.referenced_fields());
+      }
+      scan_oper->set_morsel_scheduler(scheduler);
+      gather->add_child(std::move(scan_oper));
+    }
+    oper = std::move(gather);
+    LOG_TRACE("use parallel vectorized table scan. degree=%d", parallel_degree);
+    return RC::SUCCESS;
+  }
+
+  TableScanVecPhysicalOperator *table_scan_oper =
       new TableScanVecPhysicalOperator(table, table_get_oper.read_write_mode());
   table_scan_oper->set_predicates(std::move(predicates));
+  if (table_get_oper.has_referenced_fields()) {
+    table_scan_oper->set_referenced_fields(table_get_oper.referenced_fields());
+  }
   oper = unique_ptr<PhysicalOperator>(table_scan_oper);
   LOG_TRACE("use vectorized table scan");
 
@@ -447,27 +642,47 @@ RC PhysicalPlanGenerator::create_vec_plan(
 RC PhysicalPlanGenerator::create_vec_plan(
     GroupByLogicalOperator &logical_oper, unique_ptr<PhysicalOperator> &oper, Session *session)
 {
-  RC                           rc            = RC::SUCCESS;
+  RC rc = RC::SUCCESS;
+  ASSERT(logical_oper.children().size() <= 1, "group by operator should have at most 1 child");
+
+  // 没有子算子说明输入被恒假的过滤条件裁剪掉了，聚合算子按空输入处理
+  unique_ptr<PhysicalOperator> child_physical_oper;
+  if (!logical_oper.children().empty()) {
+    rc = create_vec(*logical_oper.children().front(), child_physical_oper, session);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to create child physical operator of group by(vec) operator. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  const size_t                 memory_limit  = session != nullptr ? session->operator_memory_limit() : 0;
   unique_ptr<PhysicalOperator> physical_oper = nullptr;
   if (logical_oper.group_by_expressions().empty()) {
     physical_oper = make_unique<AggregateVecPhysicalOperator>(std::move(logical_oper.aggregate_expressions()));
+  } else if (child_physical_oper != nullptr && child_physical_oper->type() == PhysicalOperatorType::GATHER_VEC &&
+             memory_limit == 0 &&
+             VectorizedAggregateHashTable::support(
+                 logical_oper.group_by_expressions(), logical_oper.aggregate_expressions())) {
+    // 两阶段并行聚合直接接管并行扫描的各条流水线，不再经过 gather 汇合
+    auto gather        = static_cast<GatherVecPhysicalOperator *>(child_physical_oper.get());
+    auto parallel_oper = make_unique<ParallelGroupByVecPhysicalOperator>(std::move(logical_oper.group_by_expressions()),
+        std::move(logical_oper.aggregate_expressions()),
+        gather->scheduler());
+    for (unique_ptr<PhysicalOperator> &pipeline : gather->children()) {
+      parallel_oper->add_child(std::move(pipeline));
+    }
+    oper = std::move(parallel_oper);
+    LOG_TRACE("use parallel two-phase hash aggregation");
+    return rc;
   } else {
     physical_oper = make_unique<GroupByVecPhysicalOperator>(
-        std::move(logical_oper.group_by_expressions()), std::move(logical_oper.aggregate_expressions()));
+        std::move(logical_oper.group_by_expressions()), std::move(logical_oper.aggregate_expressions()), memory_limit);
   }
 
-  ASSERT(logical_oper.children().size() == 1, "group by operator should have 1 child");
-
-  LogicalOperator             &child_oper = *logical_oper.children().front();
-  unique_ptr<PhysicalOperator> child_physical_oper;
-  rc = create_vec(child_oper, child_physical_oper, session);
-  if (OB_FAIL(rc)) {
-    LOG_WARN("failed to create child physical operator of group by(vec) operator. rc=%s", strrc(rc));
-    return rc;
+  if (child_physical_oper != nullptr) {
+    physical_oper->add_child(std::move(child_physical_oper));
   }
 
-  physical_oper->add_child(std::move(child_physical_oper));
-
   oper = std::move(physical_oper);
   return rc;
 
@@ -493,7 +708,20 @@ RC PhysicalPlanGenerator::create_vec_plan(
 
   auto project_operator = make_unique<ProjectVecPhysicalOperator>(std::move(project_oper.expressions()));
 
-  if (child_phy_oper != nullptr) {
+  if (child_phy_oper != nullptr && child_phy_oper->type() == PhysicalOperatorType::GATHER_VEC) {
+    // 表达式计算放到每条并行的流水线中，表达式本身是只读的，可以在多个线程中共享
+    auto gather = static_cast<GatherVecPhysicalOperator *>(child_phy_oper.get());
+    gather->wrap_pipelines([&project_operator](unique_ptr<PhysicalOperator> pipeline) {
+      vector<Expression *> expressions;
+      for (auto &expr : project_operator->expressions()) {
+        expressions.push_back(expr.get());
+      }
+      auto expr_operator = make_unique<ExprVecPhysicalOperator>(std::move(expressions));
+      expr_operator->add_child(std::move(pipeline));
+      return unique_ptr<PhysicalOperator>(std::move(expr_operator));
+    });
+    project_operator->add_child(std::move(child_phy_oper));
+  } else if (child_phy_oper != nullptr) {
     vector<Expression *> expressions;
     for (auto &expr : project_operator->expressions()) {
       expressions.push_back(expr.get());
@@ -516,7 +744,7 @@ RC PhysicalPlanGenerator::create_vec_plan(
 
   RC rc = RC::SUCCESS;
   // reuse `ExplainPhysicalOperator` in explain vectorized physical plan
-  unique_ptr<PhysicalOperator> explain_physical_oper(new ExplainPhysicalOperator);
+  unique_ptr<PhysicalOperator> explain_physical_oper(new ExplainPhysicalOperator(explain_oper.analyze()));
   for (unique_ptr<LogicalOperator> &child_oper : child_opers) {
     unique_ptr<PhysicalOperator> child_physical_oper;
     rc = create_vec(*child_oper, child_physical_oper, session);
@@ -536,7 +764,9 @@ RC PhysicalPlanGenerator::create_vec_plan(
     OrderByLogicalOperator &logical_oper, unique_ptr<PhysicalOperator> &oper, Session *session)
 {
   unique_ptr<PhysicalOperator> physical_oper =
-      make_unique<OrderByVecPhysicalOperator>(std::move(logical_oper.order_by_exprs()), std::move(logical_oper.asc()));
+      make_unique<OrderByVecPhysicalOperator>(std::move(logical_oper.order_by_exprs()),
+          std::move(logical_oper.asc()),
+          session != nullptr ? session->operator_memory_limit() : 0);
   ASSERT(logical_oper.children().size() == 1, "oredr by operator should have 1 child");
   LogicalOperator             &child_oper = *logical_oper.children().front();
   unique_ptr<PhysicalOperator> child_physical_oper;
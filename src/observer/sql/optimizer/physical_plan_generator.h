@@ -47,6 +47,12 @@ public:
   RC create(LogicalOperator &logical_operator, unique_ptr<PhysicalOperator> &oper, Session *session);
   RC create_vec(LogicalOperator &logical_operator, unique_ptr<PhysicalOperator> &oper, Session *session);
 
+  /**
+   * @brief 列裁剪。收集整个逻辑计划中用到的字段，记录到每个 TableGetLogicalOperator 中
+   * @details 需要在 create_vec 之前调用，create_vec 会把表达式移动到物理算子中
+   */
+  static void prune_columns(LogicalOperator &logical_operator);
+
 private:
   RC create_plan(TableGetLogicalOperator &logical_oper, unique_ptr<PhysicalOperator> &oper, Session *session);
   RC create_plan(PredicateLogicalOperator &logical_oper, unique_ptr<PhysicalOperator> &oper, Session *session);
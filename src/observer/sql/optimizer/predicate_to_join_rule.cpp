@@ -9,3 +9,105 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "sql/optimizer/predicate_to_join_rule.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/join_logical_operator.h"
+#include "sql/operator/logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+#include "sql/optimizer/optimizer_utils.h"
+
+RC PredicateToJoinRewriter::rewrite(unique_ptr<LogicalOperator> &oper, bool &change_made)
+{
+  if (oper->type() != LogicalOperatorType::PREDICATE || oper->children().size() != 1 ||
+      oper->children().front()->type() != LogicalOperatorType::JOIN) {
+    return RC::SUCCESS;
+  }
+
+  vector<unique_ptr<Expression>> &predicate_exprs = oper->expressions();
+  if (predicate_exprs.size() != 1) {
+    return RC::SUCCESS;
+  }
+
+  // 拆分 AND 连接的各个条件，OR 条件作为一个整体
+  unique_ptr<Expression>        &predicate_expr = predicate_exprs.front();
+  vector<unique_ptr<Expression>> conjuncts;
+  if (predicate_expr->type() == ExprType::CONJUNCTION &&
+      static_cast<ConjunctionExpr &>(*predicate_expr).conjunction_type() == ConjunctionExpr::Type::AND) {
+    conjuncts = std::move(static_cast<ConjunctionExpr &>(*predicate_expr).children());
+  } else {
+    conjuncts.emplace_back(std::move(predicate_expr));
+  }
+
+  LogicalOperator               &join_oper = *oper->children().front();
+  vector<unique_ptr<Expression>> remains;
+  for (unique_ptr<Expression> &conjunct : conjuncts) {
+    unordered_set<const Table *> tables;
+    OptimizerUtils::collect_tables(*conjunct, tables);
+    if (tables.empty() || !push_down(join_oper, conjunct, tables)) {
+      remains.emplace_back(std::move(conjunct));
+    }
+  }
+
+  if (remains.size() == conjuncts.size()) {
+    // 没有可以下推的条件，恢复原来的表达式
+    if (remains.size() == 1) {
+      predicate_expr = std::move(remains.front());
+    } else {
+      predicate_expr = make_unique<ConjunctionExpr>(ConjunctionExpr::Type::AND, remains);
+    }
+    return RC::SUCCESS;
+  }
+
+  change_made = true;
+  if (remains.empty()) {
+    // 所有的条件都下推了，不再需要这个算子
+    LOG_TRACE("all predicates were pushed into join, remove the predicate operator");
+    unique_ptr<LogicalOperator> child = std::move(oper->children().front());
+    oper                              = std::move(child);
+  } else if (remains.size() == 1) {
+    predicate_expr = std::move(remains.front());
+  } else {
+    predicate_expr = make_unique<ConjunctionExpr>(ConjunctionExpr::Type::AND, remains);
+  }
+  return RC::SUCCESS;
+}
+
+bool PredicateToJoinRewriter::push_down(
+    LogicalOperator &oper, unique_ptr<Expression> &expr, const unordered_set<const Table *> &tables)
+{
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    // 与 PredicatePushdownRewriter 一样，只有比较条件交给表扫描
+    if (expr->type() != ExprType::COMPARISON) {
+      return false;
+    }
+    static_cast<TableGetLogicalOperator &>(oper).predicates().emplace_back(std::move(expr));
+    return true;
+  }
+
+  if (oper.type() != LogicalOperatorType::JOIN) {
+    return false;
+  }
+
+  if (static_cast<JoinLogicalOperator &>(oper).join_type() != JoinType::INNER) {
+    // 半连接与反连接的输出只有左边的列，条件只能下推到左边。作为连接条件会改变连接的语义
+    return push_down(*oper.children().front(), expr, tables);
+  }
+
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    unordered_set<const Table *> child_tables;
+    OptimizerUtils::collect_tables(*child, child_tables);
+    bool covered = true;
+    for (const Table *table : tables) {
+      if (child_tables.count(table) == 0) {
+        covered = false;
+        break;
+      }
+    }
+    if (covered && push_down(*child, expr, tables)) {
+      return true;
+    }
+  }
+
+  static_cast<JoinLogicalOperator &>(oper).add_join_predicate(std::move(expr));
+  return true;
+}
@@ -10,12 +10,32 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/unordered_set.h"
 #include "common/lang/vector.h"
 #include "sql/optimizer/rewrite_rule.h"
 
+class Table;
+
 /**
  * @brief 将一些谓词表达式下推到join中
  * @ingroup Rewriter
+ * @details 逻辑计划生成的连接是没有条件的笛卡尔积，过滤条件都在连接上面的 PREDICATE 算子中。
+ * 这里把 AND 连接的每个条件下推到能够计算它的最低的算子：只涉及一张表的比较条件下推到 TABLE_GET，
+ * 涉及多张表的条件成为连接的条件。这样连接可以提前过滤，代价估算和连接顺序的选择也能知道哪些表之间有连接条件。
  */
-class PredicateToJoinRewriter
-{};
+class PredicateToJoinRewriter : public RewriteRule
+{
+public:
+  PredicateToJoinRewriter()          = default;
+  virtual ~PredicateToJoinRewriter() = default;
+
+  RC rewrite(unique_ptr<LogicalOperator> &oper, bool &change_made) override;
+
+private:
+  /**
+   * @brief 把条件下推到 oper 或者它的子树中
+   * @param tables 条件引用的表，它们都在 oper 的子树中
+   * @return 是否下推成功。失败时 expr 保持不变
+   */
+  bool push_down(LogicalOperator &oper, unique_ptr<Expression> &expr, const unordered_set<const Table *> &tables);
+};
@@ -18,11 +18,15 @@ See the Mulan PSL v2 for more details. */
 #include "sql/optimizer/expression_rewriter.h"
 #include "sql/optimizer/predicate_pushdown_rewriter.h"
 #include "sql/optimizer/predicate_rewrite.h"
+#include "sql/optimizer/predicate_to_join_rule.h"
+#include "sql/optimizer/subquery_unnest_rewriter.h"
 
 Rewriter::Rewriter()
 {
+  rewrite_rules_.emplace_back(new SubqueryUnnestRewriter);
   rewrite_rules_.emplace_back(new ExpressionRewriter);
   rewrite_rules_.emplace_back(new PredicateRewriteRule);
+  rewrite_rules_.emplace_back(new PredicateToJoinRewriter);
   rewrite_rules_.emplace_back(new PredicatePushdownRewriter);
 }
 
@@ -0,0 +1,308 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/optimizer/subquery_unnest_rewriter.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/expr/expression_iterator.h"
+#include "sql/operator/group_by_logical_operator.h"
+#include "sql/operator/join_logical_operator.h"
+#include "sql/operator/logical_operator.h"
+#include "sql/optimizer/logical_plan_generator.h"
+#include "sql/optimizer/optimizer_utils.h"
+#include "sql/stmt/select_stmt.h"
+
+namespace {
+
+/// 拆分 AND 连接的各个条件
+void split_conjuncts(unique_ptr<Expression> &expr, vector<unique_ptr<Expression>> &conjuncts)
+{
+  if (expr->type() == ExprType::CONJUNCTION &&
+      static_cast<ConjunctionExpr &>(*expr).conjunction_type() == ConjunctionExpr::Type::AND) {
+    for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr &>(*expr).children()) {
+      conjuncts.emplace_back(std::move(child));
+    }
+  } else {
+    conjuncts.emplace_back(std::move(expr));
+  }
+  expr.reset();
+}
+
+/// 把条件重新用 AND 连接起来，没有条件时返回空
+unique_ptr<Expression> merge_conjuncts(vector<unique_ptr<Expression>> &conjuncts)
+{
+  if (conjuncts.empty()) {
+    return nullptr;
+  }
+  if (conjuncts.size() == 1) {
+    return std::move(conjuncts.front());
+  }
+  return make_unique<ConjunctionExpr>(ConjunctionExpr::Type::AND, conjuncts);
+}
+
+/// 表达式引用的表都在 scope 中
+bool covered_by(Expression &expr, const unordered_set<const Table *> &scope)
+{
+  unordered_set<const Table *> tables;
+  OptimizerUtils::collect_tables(expr, tables);
+  if (tables.empty()) {
+    return false;
+  }
+  for (const Table *table : tables) {
+    if (scope.count(table) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// 表达式只引用 scope 以外的表
+bool outside(Expression &expr, const unordered_set<const Table *> &scope)
+{
+  unordered_set<const Table *> tables;
+  OptimizerUtils::collect_tables(expr, tables);
+  if (tables.empty()) {
+    return false;
+  }
+  for (const Table *table : tables) {
+    if (scope.count(table) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool has_count(Expression &expr)
+{
+  if (expr.type() == ExprType::AGGREGATION &&
+      static_cast<AggregateExpr &>(expr).aggregate_type() == AggregateExpr::Type::COUNT) {
+    return true;
+  }
+  bool found = false;
+  ExpressionIterator::iterate_child_expr(expr, [&found](unique_ptr<Expression> &child) {
+    found = found || has_count(*child);
+    return RC::SUCCESS;
+  });
+  return found;
+}
+
+}  // namespace
+
+RC SubqueryUnnestRewriter::rewrite(unique_ptr<LogicalOperator> &oper, bool &change_made)
+{
+  if (oper->type() != LogicalOperatorType::PREDICATE || oper->expressions().size() != 1) {
+    return RC::SUCCESS;
+  }
+
+  // 子查询只会出现在 AND 连接的条件中
+  unique_ptr<Expression> &predicate_expr = oper->expressions().front();
+  bool                    has_sub_query  = predicate_expr->type() == ExprType::SUB_QUERY;
+  if (predicate_expr->type() == ExprType::CONJUNCTION) {
+    for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr &>(*predicate_expr).children()) {
+      has_sub_query = has_sub_query || child->type() == ExprType::SUB_QUERY;
+    }
+  }
+  if (!has_sub_query) {
+    return RC::SUCCESS;
+  }
+
+  vector<unique_ptr<Expression>> conjuncts;
+  split_conjuncts(predicate_expr, conjuncts);
+
+  vector<unique_ptr<Expression>> remains;
+  vector<unique_ptr<Expression>> sub_queries;
+  for (unique_ptr<Expression> &conjunct : conjuncts) {
+    if (conjunct->type() == ExprType::SUB_QUERY) {
+      sub_queries.emplace_back(std::move(conjunct));
+    } else {
+      remains.emplace_back(std::move(conjunct));
+    }
+  }
+
+  if (oper->children().size() != 1) {
+    LOG_WARN("sub query in a query without tables is not supported");
+    return RC::UNSUPPORTED;
+  }
+
+  for (unique_ptr<Expression> &sub_query : sub_queries) {
+    RC rc = unnest(static_cast<SubQueryExpr &>(*sub_query), oper->children().front());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to unnest sub query. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  change_made = true;
+  if (remains.empty()) {
+    LOG_TRACE("all predicates are sub queries, remove the predicate operator");
+    unique_ptr<LogicalOperator> child = std::move(oper->children().front());
+    oper                              = std::move(child);
+  } else {
+    predicate_expr = merge_conjuncts(remains);
+  }
+  return RC::SUCCESS;
+}
+
+RC SubqueryUnnestRewriter::unnest(SubQueryExpr &sub_query_expr, unique_ptr<LogicalOperator> &outer)
+{
+  unique_ptr<LogicalOperator> sub_plan;
+  RC rc = LogicalPlanGenerator().create(sub_query_expr.select_stmt(), sub_plan);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create logical plan of sub query. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // 子查询的输出顺序没有意义
+  if (sub_plan->type() == LogicalOperatorType::LIMIT) {
+    LOG_WARN("limit in sub query is not supported");
+    return RC::UNSUPPORTED;
+  }
+  if (sub_plan->type() == LogicalOperatorType::ORDER_BY) {
+    unique_ptr<LogicalOperator> child = std::move(sub_plan->children().front());
+    sub_plan                          = std::move(child);
+  }
+  ASSERT(sub_plan->type() == LogicalOperatorType::PROJECTION, "sub query plan should end with a projection");
+
+  LogicalOperator &project_oper = *sub_plan;
+  if (project_oper.children().empty()) {
+    LOG_WARN("sub query without tables is not supported");
+    return RC::UNSUPPORTED;
+  }
+
+  unique_ptr<LogicalOperator> &project_child = project_oper.children().front();
+  unordered_set<const Table *> sub_tables;
+  OptimizerUtils::collect_tables(*project_child, sub_tables);
+  if (sub_tables.empty()) {
+    LOG_WARN("sub query without tables is not supported");
+    return RC::UNSUPPORTED;
+  }
+
+  // group by 在子查询的投影下面，过滤条件在 group by 下面
+  GroupByLogicalOperator      *group_by_oper  = nullptr;
+  unique_ptr<LogicalOperator> *predicate_oper = &project_child;
+  if (project_child->type() == LogicalOperatorType::GROUP_BY) {
+    group_by_oper  = static_cast<GroupByLogicalOperator *>(project_child.get());
+    predicate_oper = &project_child->children().front();
+  }
+
+  vector<unique_ptr<Expression>> correlated;
+  if ((*predicate_oper)->type() == LogicalOperatorType::PREDICATE) {
+    extract_correlated(*predicate_oper, sub_tables, correlated);
+  }
+
+  // 外层 = 内层 的条件成为连接键，其它相关条件在连接时计算
+  vector<unique_ptr<Expression>> outer_keys;
+  vector<unique_ptr<Expression>> inner_keys;
+  vector<unique_ptr<Expression>> residuals;
+  for (unique_ptr<Expression> &predicate : correlated) {
+    if (predicate->type() == ExprType::COMPARISON && static_cast<ComparisonExpr &>(*predicate).comp() == EQUAL_TO) {
+      auto &comparison = static_cast<ComparisonExpr &>(*predicate);
+      if (covered_by(*comparison.right(), sub_tables) && outside(*comparison.left(), sub_tables)) {
+        outer_keys.emplace_back(std::move(comparison.left()));
+        inner_keys.emplace_back(std::move(comparison.right()));
+        continue;
+      }
+      if (covered_by(*comparison.left(), sub_tables) && outside(*comparison.right(), sub_tables)) {
+        outer_keys.emplace_back(std::move(comparison.right()));
+        inner_keys.emplace_back(std::move(comparison.left()));
+        continue;
+      }
+    }
+    residuals.emplace_back(std::move(predicate));
+  }
+
+  const SubQueryType type      = sub_query_expr.sub_query_type();
+  const bool         is_exists = type == SubQueryType::EXISTS || type == SubQueryType::NOT_EXISTS;
+  if (group_by_oper != nullptr) {
+    // 聚合之后内层的行已经不存在了，只能按照连接键分组
+    if (!residuals.empty()) {
+      LOG_WARN("only equality correlation is supported in sub query with aggregation");
+      return RC::UNSUPPORTED;
+    }
+    if (!inner_keys.empty() && is_exists) {
+      LOG_WARN("correlated exists sub query with aggregation is not supported");
+      return RC::UNSUPPORTED;
+    }
+    if (!inner_keys.empty() && type == SubQueryType::SCALAR && has_count(*project_oper.expressions().front())) {
+      LOG_WARN("correlated scalar sub query with count is not supported");
+      return RC::UNSUPPORTED;
+    }
+    for (unique_ptr<Expression> &inner_key : inner_keys) {
+      group_by_oper->group_by_expressions().emplace_back(inner_key->copy());
+    }
+  }
+
+  unique_ptr<Expression> sub_query_value;
+  if (is_exists) {
+    // 聚合的表达式在投影中，group by 只引用它们，这时保留投影算子
+    if (group_by_oper == nullptr) {
+      unique_ptr<LogicalOperator> child = std::move(project_child);
+      sub_plan                          = std::move(child);
+    }
+  } else {
+    sub_query_value                   = std::move(project_oper.expressions().front());
+    unique_ptr<LogicalOperator> child = std::move(project_child);
+    sub_plan                          = std::move(child);
+  }
+
+  const JoinType join_type =
+      (type == SubQueryType::NOT_IN || type == SubQueryType::NOT_EXISTS) ? JoinType::ANTI : JoinType::SEMI;
+  auto join_oper = make_unique<JoinLogicalOperator>(join_type);
+  for (size_t i = 0; i < outer_keys.size(); i++) {
+    join_oper->add_join_key(std::move(outer_keys[i]), std::move(inner_keys[i]));
+  }
+  for (unique_ptr<Expression> &residual : residuals) {
+    join_oper->add_join_predicate(std::move(residual));
+  }
+  if (type == SubQueryType::IN || type == SubQueryType::NOT_IN) {
+    join_oper->add_join_key(std::move(sub_query_expr.left()), std::move(sub_query_value));
+  } else if (type == SubQueryType::SCALAR) {
+    join_oper->add_join_predicate(
+        make_unique<ComparisonExpr>(sub_query_expr.comp(), std::move(sub_query_expr.left()), std::move(sub_query_value)));
+  }
+
+  join_oper->add_child(std::move(outer));
+  join_oper->add_child(std::move(sub_plan));
+  outer = std::move(join_oper);
+  return RC::SUCCESS;
+}
+
+void SubqueryUnnestRewriter::extract_correlated(unique_ptr<LogicalOperator> &predicate_oper,
+    const unordered_set<const Table *> &tables, vector<unique_ptr<Expression>> &correlated)
+{
+  unique_ptr<Expression>        &predicate_expr = predicate_oper->expressions().front();
+  vector<unique_ptr<Expression>> conjuncts;
+  split_conjuncts(predicate_expr, conjuncts);
+
+  vector<unique_ptr<Expression>> remains;
+  for (unique_ptr<Expression> &conjunct : conjuncts) {
+    unordered_set<const Table *> conjunct_tables;
+    OptimizerUtils::collect_tables(*conjunct, conjunct_tables);
+    bool is_correlated = false;
+    for (const Table *table : conjunct_tables) {
+      if (tables.count(table) == 0) {
+        is_correlated = true;
+        break;
+      }
+    }
+    if (is_correlated) {
+      correlated.emplace_back(std::move(conjunct));
+    } else {
+      remains.emplace_back(std::move(conjunct));
+    }
+  }
+
+  if (remains.empty()) {
+    unique_ptr<LogicalOperator> child = std::move(predicate_oper->children().front());
+    predicate_oper                    = std::move(child);
+  } else {
+    predicate_expr = merge_conjuncts(remains);
+  }
+}
@@ -0,0 +1,51 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/unordered_set.h"
+#include "common/lang/vector.h"
+#include "sql/optimizer/rewrite_rule.h"
+
+class SubQueryExpr;
+class Table;
+
+/**
+ * @brief 把 where 条件中的子查询展开成连接
+ * @ingroup Rewriter
+ * @details 子查询不逐行执行，而是与外层查询做一次连接：
+ * IN、EXISTS 展开成半连接，NOT IN、NOT EXISTS 展开成反连接，标量子查询展开成与聚合结果的半连接。
+ * 相关子查询中引用外层表的等值条件成为连接键，其它条件在连接时计算。
+ * 标量子查询的相关条件只能是等值条件，展开时把内层的连接键加到 group by 中，每个外层的值对应一组聚合结果。
+ * 没有匹配的组时标量子查询的结果是 NULL，比较的结果也不成立，所以可以用半连接代替外连接。
+ * 但是 COUNT 在没有数据时的结果是 0，相关的 COUNT 子查询不能这样展开。
+ */
+class SubqueryUnnestRewriter : public RewriteRule
+{
+public:
+  SubqueryUnnestRewriter()          = default;
+  virtual ~SubqueryUnnestRewriter() = default;
+
+  RC rewrite(unique_ptr<LogicalOperator> &oper, bool &change_made) override;
+
+private:
+  /**
+   * @brief 把 outer 替换成 outer 与子查询的连接
+   */
+  RC unnest(SubQueryExpr &sub_query_expr, unique_ptr<LogicalOperator> &outer);
+
+  /**
+   * @brief 从子查询的过滤条件中取出引用外层表的条件
+   * @param predicate_oper 子查询中的过滤算子，所有条件都被取出时删除这个算子
+   * @param tables 子查询中的表
+   */
+  void extract_correlated(unique_ptr<LogicalOperator> &predicate_oper, const unordered_set<const Table *> &tables,
+      vector<unique_ptr<Expression>> &correlated);
+};
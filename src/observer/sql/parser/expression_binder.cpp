@@ -350,6 +350,12 @@ RC ExpressionBinder::bind_arithmetic_expression(
     right_expr.reset(right.release());
   }
 
+  // 子表达式的类型已经确定，选定向量化计算函数。不支持的类型只影响向量化执行，在那里报错
+  if (OB_FAIL(arithmetic_expr->bind_kernels())) {
+    LOG_TRACE("no arithmetic kernel for the expression. left=%s, right=%s",
+        attr_type_to_string(left_expr->value_type()), attr_type_to_string(right_expr->value_type()));
+  }
+
   bound_expressions.emplace_back(std::move(expr));
   return RC::SUCCESS;
 }
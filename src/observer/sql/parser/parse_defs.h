@@ -57,6 +57,22 @@ enum CompOp
   NO_OP
 };
 
+struct SelectSqlNode;
+
+/**
+ * @brief 条件中子查询的形式
+ * @ingroup SQLParser
+ */
+enum class SubQueryType
+{
+  NONE,        ///< 不是子查询
+  IN,          ///< a IN (select ...)
+  NOT_IN,      ///< a NOT IN (select ...)
+  EXISTS,      ///< EXISTS (select ...)
+  NOT_EXISTS,  ///< NOT EXISTS (select ...)
+  SCALAR,      ///< a > (select ...)，子查询只返回一个值
+};
+
 /**
  * @brief 表示一个条件比较
  * @ingroup SQLParser
@@ -76,6 +92,9 @@ struct ConditionSqlNode
                                  ///< 1时，操作符右边是属性名，0时，是属性值
   RelAttrSqlNode right_attr;     ///< right-hand side attribute if right_is_attr = TRUE 右边的属性
   Value          right_value;    ///< right-hand side value if right_is_attr = FALSE
+
+  SubQueryType              sub_query_type = SubQueryType::NONE;  ///< 右边是子查询时，条件的形式
+  shared_ptr<SelectSqlNode> sub_query;                            ///< 右边的子查询
 };
 
 /**
@@ -194,7 +213,8 @@ struct DropTableSqlNode
  */
 struct AnalyzeTableSqlNode
 {
-  string relation_name;  ///< 要分析的表名
+  string relation_name;       ///< 要分析的表名
+  float  sample_percent = 0;  ///< SAMPLE n PERCENT 指定的采样比例，0 表示使用默认的采样方式
 };
 
 /**
@@ -266,6 +286,7 @@ class ParsedSqlNode;
 struct ExplainSqlNode
 {
   unique_ptr<ParsedSqlNode> sql_node;
+  bool                      analyze = false;  ///< explain analyze 会执行语句，输出每个算子实际的行数
 };
 
 /**
@@ -300,6 +321,7 @@ enum SqlCommandFlag
   SCF_DROP_INDEX,
   SCF_SYNC,
   SCF_SHOW_TABLES,
+  SCF_SHOW_VARIABLES,
   SCF_DESC_TABLE,
   SCF_BEGIN,  ///< 事务开始语句，可以在这里扩展只读事务
   SCF_COMMIT,
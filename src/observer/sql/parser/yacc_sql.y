@@ -50,6 +50,37 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
   return expr;
 }
 
+ConditionSqlNode *create_sub_query_condition(SubQueryType type,
+                                             RelAttrSqlNode *left,
+                                             CompOp comp,
+                                             ParsedSqlNode *sub_query)
+{
+  ConditionSqlNode *condition = new ConditionSqlNode;
+  condition->left_is_attr = (left != nullptr) ? 1 : 0;
+  if (left != nullptr) {
+    condition->left_attr = *left;
+    delete left;
+  }
+  condition->right_is_attr = 0;
+  condition->comp = comp;
+  condition->sub_query_type = type;
+  condition->sub_query = make_shared<SelectSqlNode>(std::move(sub_query->selection));
+  delete sub_query;
+  return condition;
+}
+
+/// a op b 等价于 b flip(op) a，用于把子查询在左边的比较条件转换成子查询在右边
+CompOp flip_comp(CompOp comp)
+{
+  switch (comp) {
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case LESS_THAN: return GREAT_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    default: return comp;
+  }
+}
+
 %}
 
 %define api.pure full
@@ -73,6 +104,7 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
         LIMIT
         TABLE
         TABLES
+        VARIABLES
         INDEX
         CALC
         SELECT
@@ -106,6 +138,9 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
         FROM
         WHERE
         AND
+        NOT
+        IN
+        EXISTS
         SET
         ON
         LOAD
@@ -117,6 +152,8 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
         PRIMARY
         KEY
         ANALYZE
+        SAMPLE
+        PERCENT
         FIELDS
         TERMINATED
         ENCLOSED
@@ -160,6 +197,7 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
 %type <number>              type
 %type <condition>           condition
 %type <value>               value
+%type <value>               signed_value
 %type <number>              number
 %type <cstring>             relation
 %type <comp>                comp_op
@@ -170,6 +208,7 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
 %type <condition_list>      where
 %type <condition_list>      condition_list
 %type <cstring>             storage_format
+%type <floats>              sample_percent
 %type <key_list>            primary_key
 %type <key_list>            attr_list
 %type <relation_list>       rel_list
@@ -193,6 +232,7 @@ UnboundAggregateExpr *create_aggregate_expression(const char *aggregate_name,
 %type <sql_node>            drop_table_stmt
 %type <sql_node>            analyze_table_stmt
 %type <sql_node>            show_tables_stmt
+%type <sql_node>            show_variables_stmt
 %type <sql_node>            desc_table_stmt
 %type <sql_node>            create_index_stmt
 %type <sql_node>            drop_index_stmt
@@ -232,6 +272,7 @@ command_wrapper:
   | drop_table_stmt
   | analyze_table_stmt
   | show_tables_stmt
+  | show_variables_stmt
   | desc_table_stmt
   | create_index_stmt
   | drop_index_stmt
@@ -288,9 +329,25 @@ drop_table_stmt:    /*drop table 语句的语法解析树*/
     };
 
 analyze_table_stmt:  /* analyze table 语法的语法解析树*/
-    ANALYZE TABLE ID {
+    ANALYZE TABLE ID sample_percent {
       $$ = new ParsedSqlNode(SCF_ANALYZE_TABLE);
       $$->analyze_table.relation_name = $3;
+      $$->analyze_table.sample_percent = $4;
+    }
+    ;
+
+sample_percent:
+    /* empty */
+    {
+      $$ = 0;
+    }
+    | SAMPLE NUMBER PERCENT
+    {
+      $$ = $2;
+    }
+    | SAMPLE FLOAT PERCENT
+    {
+      $$ = $2;
     }
     ;
 
@@ -300,6 +357,12 @@ show_tables_stmt:
     }
     ;
 
+show_variables_stmt:
+    SHOW VARIABLES {
+      $$ = new ParsedSqlNode(SCF_SHOW_VARIABLES);
+    }
+    ;
+
 desc_table_stmt:
     DESC ID  {
       $$ = new ParsedSqlNode(SCF_DESC_TABLE);
@@ -442,7 +505,7 @@ attr_list:
     ;
 
 insert_stmt:        /*insert   语句的语法解析树*/
-    INSERT INTO ID VALUES LBRACE value value_list RBRACE 
+    INSERT INTO ID VALUES LBRACE signed_value value_list RBRACE 
     {
       $$ = new ParsedSqlNode(SCF_INSERT);
       $$->insertion.relation_name = $3;
@@ -461,7 +524,7 @@ value_list:
     {
       $$ = nullptr;
     }
-    | COMMA value value_list  { 
+    | COMMA signed_value value_list  { 
       if ($3 != nullptr) {
         $$ = $3;
       } else {
@@ -486,6 +549,20 @@ value:
       free(tmp);
     }
     ;
+// 可以带负号的常量，用于不接受表达式的位置（插入的值、条件、SET）。表达式中的负号由 UMINUS 处理
+signed_value:
+    value {
+      $$ = $1;
+    }
+    | '-' NUMBER {
+      $$ = new Value(-(long long)$2);
+      @$ = @1;
+    }
+    | '-' FLOAT {
+      $$ = new Value(-(float)$2);
+      @$ = @1;
+    }
+    ;
 storage_format:
     /* empty */
     {
@@ -509,7 +586,7 @@ delete_stmt:    /*  delete 语句的语法解析树*/
     }
     ;
 update_stmt:      /*  update 语句的语法解析树*/
-    UPDATE ID SET ID EQ value where 
+    UPDATE ID SET ID EQ signed_value where 
     {
       $$ = new ParsedSqlNode(SCF_UPDATE);
       $$->update.relation_name = $2;
@@ -682,7 +759,7 @@ condition_list:
     }
     ;
 condition:
-    rel_attr comp_op value
+    rel_attr comp_op signed_value
     {
       $$ = new ConditionSqlNode;
       $$->left_is_attr = 1;
@@ -694,7 +771,7 @@ condition:
       delete $1;
       delete $3;
     }
-    | value comp_op value 
+    | signed_value comp_op signed_value
     {
       $$ = new ConditionSqlNode;
       $$->left_is_attr = 0;
@@ -718,7 +795,7 @@ condition:
       delete $1;
       delete $3;
     }
-    | value comp_op rel_attr
+    | signed_value comp_op rel_attr
     {
       $$ = new ConditionSqlNode;
       $$->left_is_attr = 0;
@@ -730,6 +807,30 @@ condition:
       delete $1;
       delete $3;
     }
+    | rel_attr comp_op LBRACE select_stmt RBRACE
+    {
+      $$ = create_sub_query_condition(SubQueryType::SCALAR, $1, $2, $4);
+    }
+    | LBRACE select_stmt RBRACE comp_op rel_attr
+    {
+      $$ = create_sub_query_condition(SubQueryType::SCALAR, $5, flip_comp($4), $2);
+    }
+    | rel_attr IN LBRACE select_stmt RBRACE
+    {
+      $$ = create_sub_query_condition(SubQueryType::IN, $1, EQUAL_TO, $4);
+    }
+    | rel_attr NOT IN LBRACE select_stmt RBRACE
+    {
+      $$ = create_sub_query_condition(SubQueryType::NOT_IN, $1, EQUAL_TO, $5);
+    }
+    | EXISTS LBRACE select_stmt RBRACE
+    {
+      $$ = create_sub_query_condition(SubQueryType::EXISTS, nullptr, EQUAL_TO, $3);
+    }
+    | NOT EXISTS LBRACE select_stmt RBRACE
+    {
+      $$ = create_sub_query_condition(SubQueryType::NOT_EXISTS, nullptr, EQUAL_TO, $4);
+    }
     ;
 
 comp_op:
@@ -856,10 +957,16 @@ explain_stmt:
       $$ = new ParsedSqlNode(SCF_EXPLAIN);
       $$->explain.sql_node = unique_ptr<ParsedSqlNode>($2);
     }
+    | EXPLAIN ANALYZE command_wrapper
+    {
+      $$ = new ParsedSqlNode(SCF_EXPLAIN);
+      $$->explain.sql_node = unique_ptr<ParsedSqlNode>($3);
+      $$->explain.analyze  = true;
+    }
     ;
 
 set_variable_stmt:
-    SET ID EQ value
+    SET ID EQ signed_value
     {
       $$ = new ParsedSqlNode(SCF_SET_VARIABLE);
       $$->set_variable.name  = $2;
@@ -0,0 +1,361 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/plan_cache/plan_cache.h"
+#include "catalog/catalog.h"
+#include "common/log/log.h"
+#include "session/session.h"
+#include "sql/executor/analyze_table_executor.h"
+#include "sql/operator/physical_operator.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+namespace {
+
+bool same_param(const Value &left, const Value &right)
+{
+  return left.attr_type() == right.attr_type() && left.compare(right) == 0;
+}
+
+/// 每个参数所在的组，即与它相等的第一个参数的下标
+vector<int> param_groups(const vector<Value> &params)
+{
+  vector<int> groups(params.size());
+  for (size_t i = 0; i < params.size(); i++) {
+    groups[i] = static_cast<int>(i);
+    for (size_t j = 0; j < i; j++) {
+      if (same_param(params[j], params[i])) {
+        groups[i] = static_cast<int>(j);
+        break;
+      }
+    }
+  }
+  return groups;
+}
+
+bool collect_plan_constants(PhysicalOperator &oper, vector<Value *> &constants, vector<Value *> &copies, int &operator_num)
+{
+  if (!oper.collect_constants(constants, copies)) {
+    return false;
+  }
+  operator_num++;
+  for (unique_ptr<PhysicalOperator> &child : oper.children()) {
+    if (!collect_plan_constants(*child, constants, copies, operator_num)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+CachedPlan::CachedPlan(string key, vector<Value> params, uint64_t schema_version)
+    : key_(std::move(key)), params_(std::move(params)), schema_version_(schema_version)
+{}
+
+CachedPlan::~CachedPlan() = default;
+
+void CachedPlan::set_operator(unique_ptr<PhysicalOperator> oper) { operator_ = std::move(oper); }
+
+bool CachedPlan::cast_param(const Value &param, AttrType type, Value &result)
+{
+  if (param.attr_type() == type) {
+    result = param;
+    return true;
+  }
+  Value back;
+  if (OB_FAIL(Value::cast_to(param, type, result)) || OB_FAIL(Value::cast_to(result, param.attr_type(), back))) {
+    return false;
+  }
+  return back.compare(param) == 0;
+}
+
+bool CachedPlan::match_slot(Value &value)
+{
+  // 布尔值是常量计算的结果，不会来自参数
+  if (value.attr_type() == AttrType::BOOLEANS) {
+    return false;
+  }
+
+  const vector<int> groups = param_groups(params_);
+  int               param  = -1;
+  for (size_t i = 0; i < params_.size(); i++) {
+    Value casted;
+    if (groups[i] != static_cast<int>(i) || !cast_param(params_[i], value.attr_type(), casted) ||
+        casted.compare(value) != 0) {
+      continue;
+    }
+    if (param != -1) {
+      LOG_TRACE("constant matches more than one parameter. value=%s", value.to_string().c_str());
+      return false;
+    }
+    param = static_cast<int>(i);
+  }
+  if (param == -1) {
+    LOG_TRACE("constant does not match any parameter. value=%s", value.to_string().c_str());
+    return false;
+  }
+  slots_.push_back(Slot{&value, param});
+  return true;
+}
+
+bool CachedPlan::prepare(PhysicalOperator &oper, const vector<Table *> &tables)
+{
+  vector<Value *> constants;
+  vector<Value *> copies;
+  int             operator_num = 0;
+  if (!collect_plan_constants(oper, constants, copies, operator_num)) {
+    LOG_TRACE("plan contains operators that cannot be reopened");
+    return false;
+  }
+
+  for (Value *value : constants) {
+    if (!match_slot(*value)) {
+      return false;
+    }
+  }
+  // 每组相等的参数都要在执行计划中出现相同的次数，否则有参数以看不到的形式用在了执行计划中
+  const vector<int> groups = param_groups(params_);
+  vector<int>       expected(params_.size(), 0);
+  vector<int>       found(params_.size(), 0);
+  for (int group : groups) {
+    expected[group]++;
+  }
+  for (const Slot &slot : slots_) {
+    found[slot.param]++;
+  }
+  if (expected != found) {
+    LOG_TRACE("parameters do not match constants in the plan");
+    return false;
+  }
+  for (Value *value : copies) {
+    if (!match_slot(*value)) {
+      return false;
+    }
+  }
+
+  tables_ = tables;
+  for (Table *table : tables_) {
+    stats_versions_.push_back(Catalog::get_instance().get_table_stats_version(table->table_id()));
+  }
+
+  memory_size_ = sizeof(CachedPlan) + key_.capacity() + operator_num * OPERATOR_MEMORY +
+                 slots_.size() * (sizeof(Slot) + sizeof(Value));
+  for (const Slot &slot : slots_) {
+    if (slot.value->attr_type() == AttrType::CHARS) {
+      memory_size_ += slot.value->length();
+    }
+  }
+  params_.clear();
+  return true;
+}
+
+RC CachedPlan::bind(const vector<Value> &params)
+{
+  for (const Slot &slot : slots_) {
+    if (slot.param >= static_cast<int>(params.size())) {
+      return RC::INVALID_ARGUMENT;
+    }
+    Value value;
+    if (!cast_param(params[slot.param], slot.value->attr_type(), value)) {
+      LOG_TRACE("cannot cast parameter to the constant type. param=%s, type=%s",
+          params[slot.param].to_string().c_str(), attr_type_to_string(slot.value->attr_type()));
+      return RC::INVALID_ARGUMENT;
+    }
+    *slot.value = std::move(value);
+  }
+  return RC::SUCCESS;
+}
+
+bool CachedPlan::is_valid(uint64_t schema_version) const
+{
+  if (schema_version != schema_version_) {
+    return false;
+  }
+  for (size_t i = 0; i < tables_.size(); i++) {
+    if (Catalog::get_instance().get_table_stats_version(tables_[i]->table_id()) != stats_versions_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CachedPlan::need_analyze() const
+{
+  for (Table *table : tables_) {
+    if (AnalyzeTableExecutor::need_auto_analyze(table)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PlanCache::PlanCache() = default;
+
+PlanCache::~PlanCache() = default;
+
+PlanCache &PlanCache::instance()
+{
+  static PlanCache instance;
+  return instance;
+}
+
+string PlanCache::make_key(const string &normalized_sql, const vector<Value> &params, Session *session)
+{
+  string key;
+  key.append(session->get_current_db_name()).push_back('\n');
+
+  key.push_back(session->use_cascade() ? 'c' : '-');
+  key.push_back(session->hash_join_on() ? 'h' : '-');
+  key.push_back(session->pipeline_execution() ? 'p' : '-');
+  key.append(std::to_string(static_cast<int>(session->get_execution_mode()))).push_back(',');
+  key.append(std::to_string(session->parallel_degree())).push_back(',');
+  key.append(std::to_string(session->operator_memory_limit())).push_back('\n');
+
+  const vector<int> groups = param_groups(params);
+  for (size_t i = 0; i < params.size(); i++) {
+    key.append(attr_type_to_string(params[i].attr_type())).push_back(':');
+    key.append(std::to_string(groups[i])).push_back(',');
+  }
+  key.push_back('\n');
+  key.append(normalized_sql);
+  return key;
+}
+
+PlanCache::Shard &PlanCache::shard(const string &key) { return shards_[std::hash<string>()(key) % SHARD_NUM]; }
+
+unique_ptr<CachedPlan> PlanCache::acquire(const string &key, const vector<Value> &params, bool check_analyze)
+{
+  Shard                 &s = shard(key);
+  unique_ptr<CachedPlan> plan;
+  {
+    lock_guard<mutex> guard(s.lock);
+    shared_ptr<Entry> entry;
+    if (s.entries.get(key, entry) && !entry->plans.empty()) {
+      plan = std::move(entry->plans.back());
+      entry->plans.pop_back();
+      entry->memory -= plan->memory_size();
+      s.memory -= plan->memory_size();
+
+      if (!plan->is_valid(schema_version()) || (check_analyze && plan->need_analyze())) {
+        // 同一条SQL的其它执行计划也是之前生成的，一起丢弃
+        invalidations_ += 1 + entry->plans.size();
+        plan.reset();
+        remove_entry(s, key, entry);
+      } else if (entry->plans.empty()) {
+        // 所有的执行计划都在使用中，执行结束后再放回来
+        remove_entry(s, key, entry);
+      }
+    }
+  }
+
+  if (plan != nullptr && OB_FAIL(plan->bind(params))) {
+    plan.reset();
+  }
+  if (plan != nullptr) {
+    hits_++;
+  } else {
+    misses_++;
+  }
+  return plan;
+}
+
+void PlanCache::release(unique_ptr<CachedPlan> plan)
+{
+  const int64_t limit = capacity() / SHARD_NUM;
+  if (plan == nullptr || static_cast<int64_t>(plan->memory_size()) > limit) {
+    return;
+  }
+
+  Shard            &s = shard(plan->key());
+  lock_guard<mutex> guard(s.lock);
+  // 在锁内检查，invalidate_all 清空分片时不会漏掉刚放回来的执行计划
+  if (!plan->is_valid(schema_version())) {
+    return;
+  }
+
+  shared_ptr<Entry> entry;
+  if (!s.entries.get(plan->key(), entry)) {
+    entry = make_shared<Entry>();
+    s.entries.put(plan->key(), entry);
+  }
+  if (entry->plans.size() >= MAX_PLANS_PER_KEY) {
+    return;
+  }
+  entry->memory += plan->memory_size();
+  s.memory += plan->memory_size();
+  entry->plans.emplace_back(std::move(plan));
+  evict(s, limit);
+}
+
+void PlanCache::invalidate_all()
+{
+  schema_version_++;
+  for (Shard &s : shards_) {
+    lock_guard<mutex> guard(s.lock);
+    s.entries.foreach ([this](const string &, const shared_ptr<Entry> &entry) {
+      invalidations_ += entry->plans.size();
+      return true;
+    });
+    s.entries.destroy();
+    s.memory = 0;
+  }
+}
+
+void PlanCache::set_capacity(int64_t capacity)
+{
+  capacity_ = capacity;
+  for (Shard &s : shards_) {
+    lock_guard<mutex> guard(s.lock);
+    evict(s, capacity / SHARD_NUM);
+  }
+}
+
+void PlanCache::evict(Shard &s, int64_t limit)
+{
+  while (s.memory > limit && s.entries.count() > 0) {
+    string            key;
+    shared_ptr<Entry> entry;
+    s.entries.foreach_reverse([&key, &entry](const string &k, const shared_ptr<Entry> &e) {
+      key   = k;
+      entry = e;
+      return false;
+    });
+    evictions_ += entry->plans.size();
+    remove_entry(s, key, entry);
+  }
+}
+
+void PlanCache::remove_entry(Shard &s, const string &key, const shared_ptr<Entry> &entry)
+{
+  s.memory -= entry->memory;
+  s.entries.remove(key);
+}
+
+PlanCache::Stats PlanCache::stats()
+{
+  Stats result;
+  result.hits          = hits_.load();
+  result.misses        = misses_.load();
+  result.evictions     = evictions_.load();
+  result.invalidations = invalidations_.load();
+  for (Shard &s : shards_) {
+    lock_guard<mutex> guard(s.lock);
+    s.entries.foreach ([&result](const string &, const shared_ptr<Entry> &entry) {
+      result.entries += entry->plans.size();
+      return true;
+    });
+    result.memory += s.memory;
+  }
+  return result;
+}
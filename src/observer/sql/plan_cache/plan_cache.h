@@ -0,0 +1,192 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/atomic.h"
+#include "common/lang/lru_cache.h"
+#include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/sys/rc.h"
+#include "common/value.h"
+
+class PhysicalOperator;
+class Session;
+class Table;
+
+/**
+ * @brief 缓存的执行计划
+ * @ingroup SQLStage
+ * @details 记录执行计划中来自SQL常量的值（槽位）与参数的对应关系。再次执行只是常量不同的SQL时，
+ * 把新的参数写到槽位中，重新打开执行计划即可，不再需要语法分析、语义解析与优化。
+ * 槽位与参数按照值来对应：相等的参数在缓存的键中已经标记出来，每组相等的参数对应的槽位个数要与参数个数相同，
+ * 每个槽位只能对应一组参数，否则说明有参数变成了执行计划中看不到的形式（比如 LIMIT、IN 列表），执行计划不能缓存。
+ * 一个执行计划同时只能被一个请求使用。
+ */
+class CachedPlan
+{
+public:
+  /// 估算的每个算子占用的内存，包括算子中的记录、元组与表达式
+  static constexpr size_t OPERATOR_MEMORY = 1024;
+
+  /**
+   * @param schema_version 开始生成执行计划时的表结构版本
+   */
+  CachedPlan(string key, vector<Value> params, uint64_t schema_version);
+  ~CachedPlan();
+
+  const string          &key() const { return key_; }
+  const vector<Table *> &tables() const { return tables_; }
+
+  /**
+   * @brief 收集执行计划中的常量并与参数对应起来
+   * @param tables 执行计划访问的表，统计信息变化后执行计划失效
+   * @return false 表示执行计划不能缓存
+   */
+  bool prepare(PhysicalOperator &oper, const vector<Table *> &tables);
+
+  /**
+   * @brief 把参数写到执行计划的槽位中
+   * @details 参数需要能够无损地转换成槽位的类型，否则返回失败，需要重新生成执行计划
+   */
+  RC bind(const vector<Value> &params);
+
+  /**
+   * @brief 表结构与统计信息是否还与生成执行计划时相同
+   */
+  bool is_valid(uint64_t schema_version) const;
+
+  /**
+   * @brief 是否有表修改的数据已经多到需要重新收集统计信息
+   */
+  bool need_analyze() const;
+
+  void                         set_operator(unique_ptr<PhysicalOperator> oper);
+  unique_ptr<PhysicalOperator> take_operator() { return std::move(operator_); }
+  size_t                       memory_size() const { return memory_size_; }
+
+private:
+  /// 执行计划中的一个常量
+  struct Slot
+  {
+    Value *value = nullptr;
+    int    param = -1;  ///< 对应的参数下标，相等的参数中的第一个
+  };
+
+  /// 把参数转换成槽位的类型，转换有损失时返回 false
+  static bool cast_param(const Value &param, AttrType type, Value &result);
+  /// 找到与常量相等的参数，记录为槽位
+  bool        match_slot(Value &value);
+
+private:
+  string                       key_;
+  vector<Value>                params_;  ///< 生成执行计划时的参数
+  unique_ptr<PhysicalOperator> operator_;
+  vector<Slot>                 slots_;
+  vector<Table *>              tables_;
+  vector<uint64_t>             stats_versions_;
+  uint64_t                     schema_version_ = 0;
+  size_t                       memory_size_    = 0;
+};
+
+/**
+ * @brief 执行计划缓存
+ * @ingroup SQLStage
+ * @details 以替换了常量的SQL、当前数据库、影响执行计划的会话变量以及参数类型为键。
+ * 缓存分成多个分片，每个分片有自己的锁与 LRU 链表，总共占用的内存不超过容量。
+ * DDL 之后清空缓存，表的统计信息变化之后相关的执行计划在下次使用时丢弃。
+ */
+class PlanCache
+{
+public:
+  static constexpr int     SHARD_NUM         = 16;
+  static constexpr int     MAX_PLANS_PER_KEY = 4;  ///< 同一条SQL最多缓存几份执行计划，用于并发执行
+  static constexpr int64_t DEFAULT_CAPACITY  = 16 * 1024 * 1024;
+
+  struct Stats
+  {
+    int64_t hits          = 0;
+    int64_t misses        = 0;
+    int64_t evictions     = 0;
+    int64_t invalidations = 0;
+    int64_t entries       = 0;
+    int64_t memory        = 0;
+  };
+
+public:
+  PlanCache();
+  ~PlanCache();
+
+  static PlanCache &instance();
+
+  /**
+   * @brief 生成缓存的键
+   * @details 参数的类型以及哪些参数相等都是键的一部分，比如 `insert ... values(1, 1)` 与
+   * `insert ... values(1, 2)` 的执行计划不能共用
+   */
+  static string make_key(const string &normalized_sql, const vector<Value> &params, Session *session);
+
+  /**
+   * @brief 取出一个执行计划并绑定参数，没有可用的执行计划时返回空
+   * @param check_analyze 统计信息需要重新收集时不使用缓存，重新优化时会收集统计信息
+   */
+  unique_ptr<CachedPlan> acquire(const string &key, const vector<Value> &params, bool check_analyze);
+
+  /**
+   * @brief 执行结束后把执行计划放回缓存
+   */
+  void release(unique_ptr<CachedPlan> plan);
+
+  /**
+   * @brief 表结构变化后清空缓存
+   */
+  void invalidate_all();
+
+  uint64_t schema_version() const { return schema_version_.load(); }
+
+  void    set_capacity(int64_t capacity);
+  int64_t capacity() const { return capacity_.load(); }
+
+  Stats stats();
+
+private:
+  struct Entry
+  {
+    vector<unique_ptr<CachedPlan>> plans;
+    size_t                         memory = 0;
+  };
+
+  struct Shard
+  {
+    mutex                                       lock;
+    common::LruCache<string, shared_ptr<Entry>> entries;
+    int64_t                                     memory = 0;
+  };
+
+  Shard &shard(const string &key);
+
+  /// 淘汰最久没有使用的执行计划，直到分片的内存不超过限制
+  void evict(Shard &shard, int64_t limit);
+
+  void remove_entry(Shard &shard, const string &key, const shared_ptr<Entry> &entry);
+
+private:
+  Shard shards_[SHARD_NUM];
+
+  atomic<int64_t>  capacity_{DEFAULT_CAPACITY};
+  atomic<uint64_t> schema_version_{0};
+
+  atomic<int64_t> hits_{0};
+  atomic<int64_t> misses_{0};
+  atomic<int64_t> evictions_{0};
+  atomic<int64_t> invalidations_{0};
+};
@@ -12,13 +12,79 @@ See the Mulan PSL v2 for more details. */
 // Created by Longda on 2021/4/13.
 //
 
-#include <string.h>
+#include "sql/plan_cache/plan_cache_stage.h"
 
-#include "plan_cache_stage.h"
-
-#include "common/conf/ini.h"
-#include "common/io/io.h"
-#include "common/lang/string.h"
 #include "common/log/log.h"
+#include "event/session_event.h"
+#include "event/sql_event.h"
+#include "session/session.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/plan_cache/sql_normalizer.h"
+#include "sql/stmt/delete_stmt.h"
+#include "sql/stmt/filter_stmt.h"
+#include "sql/stmt/insert_stmt.h"
+#include "sql/stmt/select_stmt.h"
+
+using namespace std;
+
+RC PlanCacheStage::handle_request(SQLStageEvent *sql_event)
+{
+  Session *session = sql_event->session_event()->session();
+  if (!session->plan_cache_on() || session->get_current_db() == nullptr) {
+    return RC::SUCCESS;
+  }
+
+  const string word = SqlNormalizer::first_word(sql_event->sql());
+  if (word != "select" && word != "insert" && word != "delete") {
+    return RC::SUCCESS;
+  }
+
+  string        text;
+  vector<Value> params;
+  if (!SqlNormalizer::normalize(sql_event->sql(), text, params)) {
+    return RC::SUCCESS;
+  }
+
+  PlanCache             &plan_cache = PlanCache::instance();
+  const uint64_t         version    = plan_cache.schema_version();
+  string                 key        = PlanCache::make_key(text, params, session);
+  unique_ptr<CachedPlan> plan       = plan_cache.acquire(key, params, session->use_cascade());
+  if (plan != nullptr) {
+    LOG_TRACE("plan cache hit. sql=%s", sql_event->sql().c_str());
+    sql_event->set_operator(plan->take_operator());
+    // 缓存的执行计划都是按行执行的
+    session->set_used_chunk_mode(false);
+  } else {
+    plan = make_unique<CachedPlan>(std::move(key), std::move(params), version);
+  }
+  sql_event->set_cached_plan(std::move(plan));
+  return RC::SUCCESS;
+}
+
+void PlanCacheStage::add_plan(SQLStageEvent *sql_event)
+{
+  unique_ptr<CachedPlan> &plan = sql_event->cached_plan();
+  if (plan == nullptr) {
+    return;
+  }
+
+  vector<Table *> tables;
+  Stmt           *stmt = sql_event->stmt();
+  if (stmt != nullptr && stmt->type() == StmtType::SELECT) {
+    static_cast<SelectStmt *>(stmt)->collect_tables(tables);
+  } else if (stmt != nullptr && stmt->type() == StmtType::INSERT) {
+    tables.push_back(static_cast<InsertStmt *>(stmt)->table());
+  } else if (stmt != nullptr && stmt->type() == StmtType::DELETE) {
+    auto *delete_stmt = static_cast<DeleteStmt *>(stmt);
+    tables.push_back(delete_stmt->table());
+    if (delete_stmt->filter_stmt() != nullptr) {
+      delete_stmt->filter_stmt()->collect_sub_query_tables(tables);
+    }
+  }
 
-using namespace common;
+  unique_ptr<PhysicalOperator> &oper = sql_event->physical_operator();
+  if (tables.empty() || oper == nullptr || !plan->prepare(*oper, tables)) {
+    LOG_TRACE("plan is not cacheable. sql=%s", sql_event->sql().c_str());
+    plan.reset();
+  }
+}
@@ -16,11 +16,29 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/sys/rc.h"
 
+class SQLStageEvent;
+
 /**
  * @brief 尝试从Plan的缓存中获取Plan，如果没有命中，则执行Optimizer
  * @ingroup SQLStage
- * @details 实际上现在什么都没做。不过PlanCache对数据库的优化提升明显，是一个非常有趣的功能，
- * 感兴趣的同学可以参考OceanBase的实现
+ * @details 只对 select、insert、delete 语句生效。SQL中的常量替换成参数之后在 PlanCache 中查找，
+ * 命中时把参数绑定到缓存的执行计划上，跳过解析与优化直接执行。没有命中时正常生成执行计划，
+ * 执行结束后由 SqlResult 把执行计划放入缓存。可以通过 `set plan_cache = 0` 关闭。
  */
 class PlanCacheStage
-{};
+{
+public:
+  PlanCacheStage()          = default;
+  virtual ~PlanCacheStage() = default;
+
+public:
+  /**
+   * @brief 查找缓存的执行计划，命中时设置到 sql_event 中
+   */
+  RC handle_request(SQLStageEvent *sql_event);
+
+  /**
+   * @brief 优化之后收集执行计划中的参数，可以缓存时在执行结束后放入缓存
+   */
+  void add_plan(SQLStageEvent *sql_event);
+};
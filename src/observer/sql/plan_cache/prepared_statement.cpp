@@ -0,0 +1,97 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/plan_cache/prepared_statement.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+RC PreparedStatement::init()
+{
+  pieces_.clear();
+  string piece;
+  for (size_t pos = 0; pos < sql_.size(); pos++) {
+    const char c = sql_[pos];
+    if (c == '\'' || c == '"') {
+      // 与词法分析器一致，字符串中没有转义字符
+      const size_t end = sql_.find(c, pos + 1);
+      if (end == string::npos) {
+        LOG_WARN("string is not terminated. sql=%s", sql_.c_str());
+        return RC::SQL_SYNTAX;
+      }
+      piece.append(sql_, pos, end - pos + 1);
+      pos = end;
+    } else if (c == '?') {
+      pieces_.emplace_back(std::move(piece));
+      piece.clear();
+    } else {
+      piece.push_back(c);
+    }
+  }
+  pieces_.emplace_back(std::move(piece));
+  return RC::SUCCESS;
+}
+
+RC PreparedStatement::render(const vector<Value> &params, string &sql) const
+{
+  if (static_cast<int>(params.size()) != param_num()) {
+    LOG_WARN("parameter number mismatch. expect=%d, actual=%d", param_num(), static_cast<int>(params.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  sql = pieces_[0];
+  string literal;
+  for (size_t i = 0; i < params.size(); i++) {
+    RC rc = to_literal(params[i], literal);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    sql.append(literal);
+    sql.append(pieces_[i + 1]);
+  }
+  return RC::SUCCESS;
+}
+
+RC PreparedStatement::to_literal(const Value &value, string &literal)
+{
+  switch (value.attr_type()) {
+    case AttrType::INTS:
+    case AttrType::BIGINTS: {
+      literal = value.to_string();
+    } break;
+
+    case AttrType::FLOATS: {
+      // 词法分析器只识别 1.5 这样的浮点数，不能使用科学计数法。取能够还原出原值的最短精度
+      const float f = value.get_float();
+      char        buf[128];
+      for (int precision = 1; precision <= 60; precision++) {
+        snprintf(buf, sizeof(buf), "%.*f", precision, f);
+        if (strtof(buf, nullptr) == f) {
+          break;
+        }
+      }
+      literal = buf;
+    } break;
+
+    default: {
+      const string text  = value.to_string();
+      const char   quote = text.find('\'') == string::npos ? '\'' : '"';
+      if (text.find(quote) != string::npos) {
+        LOG_WARN("string parameter contains both single and double quotes");
+        return RC::INVALID_ARGUMENT;
+      }
+      literal.clear();
+      literal.push_back(quote);
+      literal.append(text);
+      literal.push_back(quote);
+    } break;
+  }
+  return RC::SUCCESS;
+}
@@ -0,0 +1,62 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/sys/rc.h"
+#include "common/value.h"
+
+/**
+ * @brief 服务端的预处理语句
+ * @ingroup SQLStage
+ * @details 客户端通过二进制协议准备的SQL，`?` 表示参数，引号中的 `?` 不是参数。
+ * 执行时把参数转换成常量写回SQL，再按普通的SQL执行。转换后的SQL只有常量不同，
+ * 经过 SqlNormalizer 之后得到相同的文本，从第二次执行开始命中执行计划缓存，不再需要语法分析与优化。
+ */
+class PreparedStatement
+{
+public:
+  PreparedStatement(uint32_t id, string sql) : id_(id), sql_(std::move(sql)) {}
+
+  /**
+   * @brief 按照参数拆分SQL
+   * @return 字符串没有结束时返回 SQL_SYNTAX
+   */
+  RC init();
+
+  uint32_t      id() const { return id_; }
+  const string &sql() const { return sql_; }
+  int           param_num() const { return static_cast<int>(pieces_.size()) - 1; }
+
+  /**
+   * @brief 客户端上次执行时给出的参数类型，再次执行时客户端可以不再发送
+   */
+  vector<int> &param_types() { return param_types_; }
+
+  /**
+   * @brief 把参数转换成常量，生成可以执行的SQL
+   */
+  RC render(const vector<Value> &params, string &sql) const;
+
+  /**
+   * @brief 把值转换成词法分析器可以识别的常量
+   * @details 负数带有负号，语法中可以出现参数的常量位置(signed_value)都接受带负号的数字；
+   * 浮点数总是带有小数点；字符串中同时有单引号与双引号时无法表示，返回失败
+   */
+  static RC to_literal(const Value &value, string &literal);
+
+private:
+  uint32_t       id_ = 0;
+  string         sql_;
+  vector<string> pieces_;  ///< 参数之间的SQL片段，比参数多一个
+  vector<int>    param_types_;
+};
@@ -0,0 +1,87 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/plan_cache/sql_normalizer.h"
+
+using namespace std;
+
+static bool is_identifier_char(char c) { return isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+
+bool SqlNormalizer::normalize(const string &sql, string &text, vector<Value> &params)
+{
+  text.clear();
+  params.clear();
+
+  const size_t size = sql.size();
+  size_t       pos  = 0;
+  while (pos < size) {
+    const char c = sql[pos];
+    if (isspace(static_cast<unsigned char>(c))) {
+      while (pos < size && isspace(static_cast<unsigned char>(sql[pos]))) {
+        pos++;
+      }
+      // 保留单词之间的分隔，去掉首尾的空白
+      if (!text.empty() && pos < size) {
+        text.push_back(' ');
+      }
+      continue;
+    }
+
+    if (c == '\'' || c == '"') {
+      const size_t end = sql.find(c, pos + 1);
+      if (end == string::npos) {
+        return false;
+      }
+      params.emplace_back(sql.substr(pos + 1, end - pos - 1).c_str());
+      text.push_back('?');
+      pos = end + 1;
+    } else if (isdigit(static_cast<unsigned char>(c))) {
+      const size_t begin = pos;
+      while (pos < size && isdigit(static_cast<unsigned char>(sql[pos]))) {
+        pos++;
+      }
+      if (pos + 1 < size && sql[pos] == '.' && isdigit(static_cast<unsigned char>(sql[pos + 1]))) {
+        pos++;
+        while (pos < size && isdigit(static_cast<unsigned char>(sql[pos]))) {
+          pos++;
+        }
+        params.emplace_back(static_cast<float>(atof(sql.substr(begin, pos - begin).c_str())));
+      } else {
+        params.emplace_back(static_cast<long long>(strtoll(sql.substr(begin, pos - begin).c_str(), nullptr, 10)));
+      }
+      text.push_back('?');
+    } else if (is_identifier_char(c)) {
+      // 标识符中的数字不是常量
+      const size_t begin = pos;
+      while (pos < size && is_identifier_char(sql[pos])) {
+        pos++;
+      }
+      text.append(sql, begin, pos - begin);
+    } else {
+      text.push_back(c);
+      pos++;
+    }
+  }
+  return true;
+}
+
+string SqlNormalizer::first_word(const string &sql)
+{
+  string word;
+  size_t pos = 0;
+  while (pos < sql.size() && isspace(static_cast<unsigned char>(sql[pos]))) {
+    pos++;
+  }
+  while (pos < sql.size() && is_identifier_char(sql[pos])) {
+    word.push_back(static_cast<char>(tolower(static_cast<unsigned char>(sql[pos]))));
+    pos++;
+  }
+  return word;
+}
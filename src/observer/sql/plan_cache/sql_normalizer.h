@@ -0,0 +1,39 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/value.h"
+
+/**
+ * @brief 把SQL中的常量替换成参数
+ * @ingroup SQLStage
+ * @details 整数、浮点数与字符串常量替换成 `?`，连续的空白字符合并成一个空格，其它内容保持不变。
+ * 只是常量不同的SQL得到相同的文本，可以作为执行计划缓存的键。
+ * 常量按照词法分析器相同的规则转换成 Value，顺序与在SQL中出现的顺序一致。
+ */
+class SqlNormalizer
+{
+public:
+  /**
+   * @param sql 原始的SQL
+   * @param text 替换常量之后的SQL
+   * @param params SQL中的常量
+   * @return false 表示SQL不完整，比如字符串没有结束，交给语法分析报告错误
+   */
+  static bool normalize(const string &sql, string &text, vector<Value> &params);
+
+  /**
+   * @brief SQL的第一个单词，小写
+   */
+  static string first_word(const string &sql);
+};
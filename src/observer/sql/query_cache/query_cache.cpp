@@ -0,0 +1,225 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/query_cache/query_cache.h"
+#include "common/log/log.h"
+#include "session/session.h"
+#include "storage/common/chunk.h"
+#include "storage/db/db.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+CachedResult::CachedResult(string key, Db *db, uint64_t data_version, uint64_t schema_version, size_t memory_limit)
+    : key_(std::move(key)),
+      db_(db),
+      data_version_(data_version),
+      schema_version_(schema_version),
+      memory_limit_(memory_limit)
+{
+  memory_size_ = sizeof(*this) + key_.capacity();
+}
+
+void CachedResult::set_tables(const vector<Table *> &tables)
+{
+  table_ids_.clear();
+  for (Table *table : tables) {
+    table_ids_.push_back(table->table_id());
+  }
+  memory_size_ += table_ids_.size() * sizeof(int32_t);
+}
+
+void CachedResult::set_schema(const TupleSchema &schema)
+{
+  schema_     = schema;
+  column_num_ = schema.cell_num();
+  memory_size_ += column_num_ * SPEC_MEMORY;
+}
+
+bool CachedResult::add_cell(string cell)
+{
+  memory_size_ += CELL_MEMORY + cell.size();
+  cells_.emplace_back(std::move(cell));
+  return memory_size_ <= memory_limit_;
+}
+
+bool CachedResult::add_tuple(const Tuple &tuple)
+{
+  if (tuple.cell_num() != column_num_) {
+    return false;
+  }
+  Value value;
+  for (int i = 0; i < column_num_; i++) {
+    if (OB_FAIL(tuple.cell_at(i, value)) || !add_cell(value.to_string())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CachedResult::add_chunk(const Chunk &chunk)
+{
+  if (chunk.column_num() != column_num_) {
+    return false;
+  }
+  for (int i = 0; i < chunk.selected_rows(); i++) {
+    const int row_idx = chunk.selected_row(i);
+    for (int col_idx = 0; col_idx < column_num_; col_idx++) {
+      if (!add_cell(chunk.get_value(col_idx, row_idx).to_string())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool CachedResult::is_valid(uint64_t schema_version) const
+{
+  if (schema_version != schema_version_) {
+    return false;
+  }
+  for (int32_t table_id : table_ids_) {
+    Table *table = db_->find_table(table_id);
+    if (table == nullptr || table->data_version() > data_version_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+QueryCache::QueryCache() = default;
+
+QueryCache::~QueryCache() = default;
+
+QueryCache &QueryCache::instance()
+{
+  static QueryCache instance;
+  return instance;
+}
+
+string QueryCache::make_key(const string &normalized_sql, const vector<Value> &params, Session *session)
+{
+  string key;
+  key.append(session->get_current_db_name()).push_back('\n');
+  // 参数的值带上长度，字符串参数中的任何字符都不会与后面的内容混淆
+  for (const Value &param : params) {
+    const string value = param.to_string();
+    key.append(attr_type_to_string(param.attr_type())).push_back(':');
+    key.append(std::to_string(value.size())).push_back(':');
+    key.append(value).push_back(',');
+  }
+  key.push_back('\n');
+  key.append(normalized_sql);
+  return key;
+}
+
+QueryCache::Shard &QueryCache::shard(const string &key) { return shards_[std::hash<string>()(key) % SHARD_NUM]; }
+
+shared_ptr<const CachedResult> QueryCache::lookup(const string &key)
+{
+  Shard                         &s = shard(key);
+  shared_ptr<const CachedResult> result;
+  {
+    lock_guard<mutex> guard(s.lock);
+    if (s.entries.get(key, result) && !result->is_valid(schema_version())) {
+      invalidations_++;
+      remove_entry(s, key, result);
+      result.reset();
+    }
+  }
+
+  if (result != nullptr) {
+    hits_++;
+  } else {
+    misses_++;
+  }
+  return result;
+}
+
+void QueryCache::add(unique_ptr<CachedResult> result)
+{
+  const int64_t limit = max_result_size();
+  if (result == nullptr || static_cast<int64_t>(result->memory_size()) > limit) {
+    return;
+  }
+
+  Shard            &s = shard(result->key());
+  lock_guard<mutex> guard(s.lock);
+  // 在锁内检查，invalidate_all 清空分片时不会漏掉刚放进来的结果。执行期间有修改提交的结果直接丢弃
+  if (!result->is_valid(schema_version())) {
+    return;
+  }
+
+  shared_ptr<const CachedResult> old_result;
+  if (s.entries.get(result->key(), old_result)) {
+    remove_entry(s, result->key(), old_result);
+  }
+  const string key = result->key();
+  s.memory += result->memory_size();
+  s.entries.put(key, shared_ptr<const CachedResult>(std::move(result)));
+  evict(s, limit);
+}
+
+void QueryCache::invalidate_all()
+{
+  schema_version_++;
+  for (Shard &s : shards_) {
+    lock_guard<mutex> guard(s.lock);
+    invalidations_ += s.entries.count();
+    s.entries.destroy();
+    s.memory = 0;
+  }
+}
+
+void QueryCache::set_capacity(int64_t capacity)
+{
+  capacity_ = capacity;
+  for (Shard &s : shards_) {
+    lock_guard<mutex> guard(s.lock);
+    evict(s, capacity / SHARD_NUM);
+  }
+}
+
+void QueryCache::evict(Shard &s, int64_t limit)
+{
+  while (s.memory > limit && s.entries.count() > 0) {
+    string                         key;
+    shared_ptr<const CachedResult> result;
+    s.entries.foreach_reverse([&key, &result](const string &k, const shared_ptr<const CachedResult> &r) {
+      key    = k;
+      result = r;
+      return false;
+    });
+    evictions_++;
+    remove_entry(s, key, result);
+  }
+}
+
+void QueryCache::remove_entry(Shard &s, const string &key, const shared_ptr<const CachedResult> &result)
+{
+  s.memory -= result->memory_size();
+  s.entries.remove(key);
+}
+
+QueryCache::Stats QueryCache::stats()
+{
+  Stats result;
+  result.hits          = hits_.load();
+  result.misses        = misses_.load();
+  result.evictions     = evictions_.load();
+  result.invalidations = invalidations_.load();
+  for (Shard &s : shards_) {
+    lock_guard<mutex> guard(s.lock);
+    result.entries += s.entries.count();
+    result.memory += s.memory;
+  }
+  return result;
+}
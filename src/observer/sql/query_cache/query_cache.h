@@ -0,0 +1,172 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/atomic.h"
+#include "common/lang/lru_cache.h"
+#include "common/lang/memory.h"
+#include "common/lang/mutex.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "common/sys/rc.h"
+#include "common/value.h"
+#include "sql/expr/tuple.h"
+
+class Chunk;
+class Db;
+class Session;
+class Table;
+
+/**
+ * @brief 缓存的查询结果
+ * @ingroup SQLStage
+ * @details 保存表头以及每一行转换成字符串之后的列值。命中缓存时，客户端通讯模块直接把它们写给客户端，不再执行。
+ * 执行查询时一边返回结果一边收集，完整返回之后才放入缓存。
+ * 记录开始执行时的全局数据版本，访问的任何一张表的数据版本比它新，说明有修改在这之后提交，结果就过期了。
+ */
+class CachedResult
+{
+public:
+  /// 估算的每一列、每一行额外占用的内存
+  static constexpr size_t CELL_MEMORY = sizeof(string);
+  static constexpr size_t SPEC_MEMORY = 64;
+
+  /**
+   * @param data_version 开始执行时的全局数据版本
+   * @param schema_version 开始执行时的表结构版本
+   * @param memory_limit 结果占用的内存超过它时不再收集
+   */
+  CachedResult(string key, Db *db, uint64_t data_version, uint64_t schema_version, size_t memory_limit);
+
+  const string &key() const { return key_; }
+
+  /**
+   * @brief 设置查询访问的表
+   */
+  void set_tables(const vector<Table *> &tables);
+  void set_schema(const TupleSchema &schema);
+
+  /**
+   * @brief 收集一行结果
+   * @return 收集失败，或者结果超过了单个结果的内存上限时返回 false，结果不再放入缓存
+   */
+  bool add_tuple(const Tuple &tuple);
+  bool add_chunk(const Chunk &chunk);
+
+  /**
+   * @brief 表结构没有变化，访问的表在开始执行之后也没有提交过修改
+   */
+  bool is_valid(uint64_t schema_version) const;
+
+  const TupleSchema &schema() const { return schema_; }
+  int                row_num() const { return column_num_ == 0 ? 0 : static_cast<int>(cells_.size()) / column_num_; }
+  int                column_num() const { return column_num_; }
+  const string      &cell(int row, int col) const { return cells_[static_cast<size_t>(row) * column_num_ + col]; }
+  size_t             memory_size() const { return memory_size_; }
+
+private:
+  bool add_cell(string cell);
+
+private:
+  string          key_;
+  Db             *db_ = nullptr;
+  vector<int32_t> table_ids_;
+  uint64_t        data_version_   = 0;
+  uint64_t        schema_version_ = 0;
+  size_t          memory_limit_   = 0;
+
+  TupleSchema    schema_;
+  int            column_num_ = 0;
+  vector<string> cells_;  ///< 按行依次存放的列值
+  size_t         memory_size_ = 0;
+};
+
+/**
+ * @brief 查询结果缓存
+ * @ingroup SQLStage
+ * @details 以替换了常量的SQL、当前数据库以及参数的值为键，只缓存单语句事务中的 SELECT。
+ * 缓存分成多个分片，每个分片有自己的锁与 LRU 链表，总共占用的内存不超过容量。
+ * 访问的表提交修改之后，缓存的结果在下次查找时丢弃；DDL 之后清空缓存。
+ */
+class QueryCache
+{
+public:
+  static constexpr int     SHARD_NUM        = 16;
+  static constexpr int64_t DEFAULT_CAPACITY = 64 * 1024 * 1024;
+
+  struct Stats
+  {
+    int64_t hits          = 0;
+    int64_t misses        = 0;
+    int64_t evictions     = 0;
+    int64_t invalidations = 0;
+    int64_t entries       = 0;
+    int64_t memory        = 0;
+  };
+
+public:
+  QueryCache();
+  ~QueryCache();
+
+  static QueryCache &instance();
+
+  static string make_key(const string &normalized_sql, const vector<Value> &params, Session *session);
+
+  /**
+   * @brief 查找有效的查询结果，过期的结果直接删除
+   */
+  shared_ptr<const CachedResult> lookup(const string &key);
+
+  /**
+   * @brief 把完整收集的查询结果放入缓存，已经过期或者太大的结果会被丢弃
+   */
+  void add(unique_ptr<CachedResult> result);
+
+  /**
+   * @brief 表结构变化后清空缓存
+   */
+  void invalidate_all();
+
+  uint64_t schema_version() const { return schema_version_.load(); }
+
+  void    set_capacity(int64_t capacity);
+  int64_t capacity() const { return capacity_.load(); }
+  /// 单个结果可以占用的内存上限，超过的结果在收集过程中就放弃
+  int64_t max_result_size() const { return capacity() / SHARD_NUM; }
+
+  Stats stats();
+
+private:
+  struct Shard
+  {
+    mutex                                                    lock;
+    common::LruCache<string, shared_ptr<const CachedResult>> entries;
+    int64_t                                                  memory = 0;
+  };
+
+  Shard &shard(const string &key);
+
+  /// 淘汰最久没有使用的结果，直到分片的内存不超过限制
+  void evict(Shard &shard, int64_t limit);
+
+  void remove_entry(Shard &shard, const string &key, const shared_ptr<const CachedResult> &result);
+
+private:
+  Shard shards_[SHARD_NUM];
+
+  atomic<int64_t>  capacity_{DEFAULT_CAPACITY};
+  atomic<uint64_t> schema_version_{0};
+
+  atomic<int64_t> hits_{0};
+  atomic<int64_t> misses_{0};
+  atomic<int64_t> evictions_{0};
+  atomic<int64_t> invalidations_{0};
+};
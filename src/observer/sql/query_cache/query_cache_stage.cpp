@@ -20,10 +20,72 @@ See the Mulan PSL v2 for more details. */
 #include "common/io/io.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
+#include "event/session_event.h"
+#include "event/sql_event.h"
+#include "session/session.h"
+#include "sql/plan_cache/sql_normalizer.h"
+#include "sql/query_cache/query_cache.h"
+#include "sql/stmt/select_stmt.h"
+#include "storage/table/table.h"
 
 using namespace common;
 
 RC QueryCacheStage::handle_request(SQLStageEvent *sql_event)
 {
+  Session *session = sql_event->session_event()->session();
+  // 多语句事务能看到自己没有提交的修改，也看不到事务开始之后其它事务提交的修改，不使用缓存
+  if (!session->query_cache_on() || session->get_current_db() == nullptr || session->is_trx_multi_operation_mode() ||
+      session->sql_debug_on()) {
+    return RC::SUCCESS;
+  }
+
+  if (SqlNormalizer::first_word(sql_event->sql()) != "select") {
+    return RC::SUCCESS;
+  }
+
+  string        text;
+  vector<Value> params;
+  if (!SqlNormalizer::normalize(sql_event->sql(), text, params)) {
+    return RC::SUCCESS;
+  }
+
+  // 在访问任何数据之前记录数据版本，之后提交的修改都会让收集到的结果失效
+  QueryCache    &query_cache    = QueryCache::instance();
+  const uint64_t schema_version = query_cache.schema_version();
+  const uint64_t data_version   = Table::current_data_version();
+
+  string                         key    = QueryCache::make_key(text, params, session);
+  shared_ptr<const CachedResult> result = query_cache.lookup(key);
+  if (result != nullptr) {
+    LOG_TRACE("query cache hit. sql=%s", sql_event->sql().c_str());
+    sql_event->session_event()->sql_result()->set_cached_result(std::move(result));
+  } else {
+    sql_event->set_cached_result(make_unique<CachedResult>(std::move(key),
+        session->get_current_db(),
+        data_version,
+        schema_version,
+        static_cast<size_t>(query_cache.max_result_size())));
+  }
   return RC::SUCCESS;
 }
+
+void QueryCacheStage::add_result(SQLStageEvent *sql_event)
+{
+  unique_ptr<CachedResult> &result = sql_event->cached_result();
+  if (result == nullptr) {
+    return;
+  }
+
+  Stmt *stmt = sql_event->stmt();
+  if (stmt != nullptr && stmt->type() == StmtType::SELECT) {
+    // 子查询访问的表变化后，结果也会变化
+    vector<Table *> tables;
+    static_cast<SelectStmt *>(stmt)->collect_tables(tables);
+    result->set_tables(tables);
+  } else if (stmt == nullptr && sql_event->cached_plan() != nullptr) {
+    // 执行计划缓存命中时没有解析，使用执行计划访问的表
+    result->set_tables(sql_event->cached_plan()->tables());
+  } else {
+    result.reset();
+  }
+}
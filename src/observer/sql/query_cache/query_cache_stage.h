@@ -21,7 +21,9 @@ class SQLStageEvent;
 /**
  * @brief 查询缓存处理
  * @ingroup SQLStage
- * @details 当前什么都没做
+ * @details 只对单语句事务中的 select 语句生效。SQL中的常量替换成参数之后，连同参数的值在 QueryCache 中查找，
+ * 命中时把缓存的结果交给 SqlResult，由客户端通讯模块直接返回，不再解析、优化与执行。
+ * 没有命中时在执行过程中收集结果，完整返回之后由 SqlResult 放入缓存。可以通过 `set query_cache = 0` 关闭。
  */
 class QueryCacheStage
 {
@@ -30,5 +32,13 @@ public:
   virtual ~QueryCacheStage() = default;
 
 public:
+  /**
+   * @brief 查找缓存的查询结果，命中时设置到 SqlResult 中
+   */
   RC handle_request(SQLStageEvent *sql_event);
+
+  /**
+   * @brief 执行之前记录查询访问的表，执行时收集查询结果
+   */
+  void add_result(SQLStageEvent *sql_event);
 };
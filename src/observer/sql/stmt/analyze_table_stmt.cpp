@@ -9,6 +9,7 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "sql/stmt/analyze_table_stmt.h"
+#include "common/log/log.h"
 #include "storage/db/db.h"
 
 RC AnalyzeTableStmt::create(Db *db, const AnalyzeTableSqlNode &analyze_table, Stmt *&stmt)
@@ -16,6 +17,10 @@ RC AnalyzeTableStmt::create(Db *db, const AnalyzeTableSqlNode &analyze_table, St
   if (db->find_table(analyze_table.relation_name.c_str()) == nullptr) {
     return RC::SCHEMA_TABLE_NOT_EXIST;
   }
-  stmt = new AnalyzeTableStmt(analyze_table.relation_name);
+  if (analyze_table.sample_percent < 0 || analyze_table.sample_percent > 100) {
+    LOG_WARN("invalid sample percent: %f", analyze_table.sample_percent);
+    return RC::INVALID_ARGUMENT;
+  }
+  stmt = new AnalyzeTableStmt(analyze_table.relation_name, analyze_table.sample_percent);
   return RC::SUCCESS;
 }
@@ -21,15 +21,20 @@ class Db;
 class AnalyzeTableStmt : public Stmt
 {
 public:
-  AnalyzeTableStmt(const string &table_name) : table_name_(table_name) {}
+  AnalyzeTableStmt(const string &table_name, float sample_percent)
+      : table_name_(table_name), sample_percent_(sample_percent)
+  {}
   virtual ~AnalyzeTableStmt() = default;
 
   StmtType type() const override { return StmtType::ANALYZE_TABLE; }
 
   const string &table_name() const { return table_name_; }
+  /// 采样的页面百分比，0 表示使用默认的采样方式
+  float sample_percent() const { return sample_percent_; }
 
   static RC create(Db *db, const AnalyzeTableSqlNode &analyze_table, Stmt *&stmt);
 
 private:
   string table_name_;
+  float  sample_percent_ = 0;
 };
@@ -16,9 +16,25 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/sys/rc.h"
+#include "sql/expr/expression_iterator.h"
+#include "sql/stmt/select_stmt.h"
 #include "storage/db/db.h"
 #include "storage/table/table.h"
 
+FilterUnit::~FilterUnit()
+{
+  if (nullptr != sub_query_) {
+    delete sub_query_;
+    sub_query_ = nullptr;
+  }
+}
+
+void FilterUnit::set_sub_query(SubQueryType type, SelectStmt *sub_query)
+{
+  sub_query_type_ = type;
+  sub_query_      = sub_query;
+}
+
 FilterStmt::~FilterStmt()
 {
   for (FilterUnit *unit : filter_units_) {
@@ -27,8 +43,18 @@ FilterStmt::~FilterStmt()
   filter_units_.clear();
 }
 
+void FilterStmt::collect_sub_query_tables(vector<Table *> &tables) const
+{
+  for (const FilterUnit *unit : filter_units_) {
+    if (unit->sub_query() != nullptr) {
+      unit->sub_query()->collect_tables(tables);
+    }
+  }
+}
+
 RC FilterStmt::create(Db *db, Table *default_table, unordered_map<string, Table *> *tables,
-    const ConditionSqlNode *conditions, int condition_num, FilterStmt *&stmt)
+    const ConditionSqlNode *conditions, int condition_num, FilterStmt *&stmt,
+    const unordered_map<string, Table *> *outer_tables)
 {
   RC rc = RC::SUCCESS;
   stmt  = nullptr;
@@ -37,7 +63,7 @@ RC FilterStmt::create(Db *db, Table *default_table, unordered_map<string, Table
   for (int i = 0; i < condition_num; i++) {
     FilterUnit *filter_unit = nullptr;
 
-    rc = create_filter_unit(db, default_table, tables, conditions[i], filter_unit);
+    rc = create_filter_unit(db, default_table, tables, conditions[i], filter_unit, outer_tables);
     if (rc != RC::SUCCESS) {
       delete tmp_stmt;
       LOG_WARN("failed to create filter unit. condition index=%d", i);
@@ -51,7 +77,8 @@ RC FilterStmt::create(Db *db, Table *default_table, unordered_map<string, Table
 }
 
 RC get_table_and_field(Db *db, Table *default_table, unordered_map<string, Table *> *tables,
-    const RelAttrSqlNode &attr, Table *&table, const FieldMeta *&field)
+    const unordered_map<string, Table *> *outer_tables, const RelAttrSqlNode &attr, Table *&table,
+    const FieldMeta *&field)
 {
   if (common::is_blank(attr.relation_name.c_str())) {
     table = default_table;
@@ -59,6 +86,12 @@ RC get_table_and_field(Db *db, Table *default_table, unordered_map<string, Table
     auto iter = tables->find(attr.relation_name);
     if (iter != tables->end()) {
       table = iter->second;
+    } else if (nullptr != outer_tables) {
+      // 当前查询中没有这个表，引用的是外层查询的表
+      auto outer_iter = outer_tables->find(attr.relation_name);
+      if (outer_iter != outer_tables->end()) {
+        table = outer_iter->second;
+      }
     }
   } else {
     table = db->find_table(attr.relation_name.c_str());
@@ -79,7 +112,7 @@ RC get_table_and_field(Db *db, Table *default_table, unordered_map<string, Table
 }
 
 RC FilterStmt::create_filter_unit(Db *db, Table *default_table, unordered_map<string, Table *> *tables,
-    const ConditionSqlNode &condition, FilterUnit *&filter_unit)
+    const ConditionSqlNode &condition, FilterUnit *&filter_unit, const unordered_map<string, Table *> *outer_tables)
 {
   RC rc = RC::SUCCESS;
 
@@ -94,7 +127,7 @@ RC FilterStmt::create_filter_unit(Db *db, Table *default_table, unordered_map<st
   if (condition.left_is_attr) {
     Table           *table = nullptr;
     const FieldMeta *field = nullptr;
-    rc                     = get_table_and_field(db, default_table, tables, condition.left_attr, table, field);
+    rc = get_table_and_field(db, default_table, tables, outer_tables, condition.left_attr, table, field);
     if (rc != RC::SUCCESS) {
       LOG_WARN("cannot find attr");
       return rc;
@@ -108,10 +141,17 @@ RC FilterStmt::create_filter_unit(Db *db, Table *default_table, unordered_map<st
     filter_unit->set_left(filter_obj);
   }
 
-  if (condition.right_is_attr) {
+  if (condition.sub_query_type != SubQueryType::NONE) {
+    rc = create_sub_query(db, tables, condition, *filter_unit);
+    if (OB_FAIL(rc)) {
+      delete filter_unit;
+      filter_unit = nullptr;
+      return rc;
+    }
+  } else if (condition.right_is_attr) {
     Table           *table = nullptr;
     const FieldMeta *field = nullptr;
-    rc                     = get_table_and_field(db, default_table, tables, condition.right_attr, table, field);
+    rc = get_table_and_field(db, default_table, tables, outer_tables, condition.right_attr, table, field);
     if (rc != RC::SUCCESS) {
       LOG_WARN("cannot find attr");
       return rc;
@@ -130,3 +170,46 @@ RC FilterStmt::create_filter_unit(Db *db, Table *default_table, unordered_map<st
   // 检查两个类型是否能够比较
   return rc;
 }
+
+RC FilterStmt::create_sub_query(
+    Db *db, unordered_map<string, Table *> *tables, const ConditionSqlNode &condition, FilterUnit &filter_unit)
+{
+  Stmt *stmt = nullptr;
+  RC    rc   = SelectStmt::create(db, *condition.sub_query, stmt, tables);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create sub query. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  SelectStmt *sub_query = static_cast<SelectStmt *>(stmt);
+  filter_unit.set_sub_query(condition.sub_query_type, sub_query);
+
+  const SubQueryType type = condition.sub_query_type;
+  if (type == SubQueryType::EXISTS || type == SubQueryType::NOT_EXISTS) {
+    return RC::SUCCESS;
+  }
+
+  if (sub_query->query_expressions().size() != 1) {
+    LOG_WARN("sub query should return exactly one column. column num=%d",
+        static_cast<int>(sub_query->query_expressions().size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  if (type == SubQueryType::SCALAR) {
+    // 只有不带 group by 的聚合能保证子查询最多返回一行
+    bool                                   has_aggregate = false;
+    function<RC(unique_ptr<Expression> &)> find_aggregate = [&](unique_ptr<Expression> &expr) -> RC {
+      if (expr->type() == ExprType::AGGREGATION) {
+        has_aggregate = true;
+        return RC::SUCCESS;
+      }
+      return ExpressionIterator::iterate_child_expr(*expr, find_aggregate);
+    };
+    find_aggregate(sub_query->query_expressions().front());
+    if (!has_aggregate || !sub_query->group_by().empty()) {
+      LOG_WARN("scalar sub query should be an aggregation without group by");
+      return RC::UNSUPPORTED;
+    }
+  }
+  return RC::SUCCESS;
+}
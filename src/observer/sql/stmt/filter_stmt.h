@@ -23,6 +23,7 @@ See the Mulan PSL v2 for more details. */
 class Db;
 class Table;
 class FieldMeta;
+class SelectStmt;
 
 struct FilterObj
 {
@@ -47,7 +48,7 @@ class FilterUnit
 {
 public:
   FilterUnit() = default;
-  ~FilterUnit() {}
+  ~FilterUnit();
 
   void set_comp(CompOp comp) { comp_ = comp; }
 
@@ -59,10 +60,20 @@ public:
   const FilterObj &left() const { return left_; }
   const FilterObj &right() const { return right_; }
 
+  /**
+   * @brief 条件的右边是子查询，子查询由当前对象释放
+   */
+  void         set_sub_query(SubQueryType type, SelectStmt *sub_query);
+  SubQueryType sub_query_type() const { return sub_query_type_; }
+  SelectStmt  *sub_query() const { return sub_query_; }
+
 private:
   CompOp    comp_ = NO_OP;
   FilterObj left_;
   FilterObj right_;
+
+  SubQueryType sub_query_type_ = SubQueryType::NONE;
+  SelectStmt  *sub_query_      = nullptr;
 };
 
 /**
@@ -78,12 +89,31 @@ public:
 public:
   const vector<FilterUnit *> &filter_units() const { return filter_units_; }
 
+  /**
+   * @brief 收集条件中的子查询访问的表
+   */
+  void collect_sub_query_tables(vector<Table *> &tables) const;
+
 public:
+  /**
+   * @param tables 条件中可以引用的表
+   * @param outer_tables 当前语句是子查询时，外层查询的表。条件中可以引用外层的表，即相关子查询
+   */
   static RC create(Db *db, Table *default_table, unordered_map<string, Table *> *tables,
-      const ConditionSqlNode *conditions, int condition_num, FilterStmt *&stmt);
+      const ConditionSqlNode *conditions, int condition_num, FilterStmt *&stmt,
+      const unordered_map<string, Table *> *outer_tables = nullptr);
 
   static RC create_filter_unit(Db *db, Table *default_table, unordered_map<string, Table *> *tables,
-      const ConditionSqlNode &condition, FilterUnit *&filter_unit);
+      const ConditionSqlNode &condition, FilterUnit *&filter_unit,
+      const unordered_map<string, Table *> *outer_tables = nullptr);
+
+private:
+  /**
+   * @brief 创建条件右边的子查询
+   * @details 子查询可以引用当前查询中的表，不能引用更外层查询中的表
+   */
+  static RC create_sub_query(Db *db, unordered_map<string, Table *> *tables, const ConditionSqlNode &condition,
+      FilterUnit &filter_unit);
 
 private:
   vector<FilterUnit *> filter_units_;  // 默认当前都是AND关系
@@ -32,7 +32,15 @@ SelectStmt::~SelectStmt()
   }
 }
 
-RC SelectStmt::create(Db *db, SelectSqlNode &select_sql, Stmt *&stmt)
+void SelectStmt::collect_tables(vector<Table *> &tables) const
+{
+  tables.insert(tables.end(), tables_.begin(), tables_.end());
+  if (nullptr != filter_stmt_) {
+    filter_stmt_->collect_sub_query_tables(tables);
+  }
+}
+
+RC SelectStmt::create(Db *db, SelectSqlNode &select_sql, Stmt *&stmt, const unordered_map<string, Table *> *outer_tables)
 {
   if (nullptr == db) {
     LOG_WARN("invalid argument. db is null");
@@ -104,7 +112,8 @@ RC SelectStmt::create(Db *db, SelectSqlNode &select_sql, Stmt *&stmt)
       &table_map,
       select_sql.conditions.data(),
       static_cast<int>(select_sql.conditions.size()),
-      filter_stmt);
+      filter_stmt,
+      outer_tables);
   if (rc != RC::SUCCESS) {
     LOG_WARN("cannot construct filter stmt");
     return rc;
@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/lang/unordered_map.h"
 #include "common/sys/rc.h"
 #include "sql/expr/expression.h"
 #include "sql/stmt/stmt.h"
@@ -38,10 +39,20 @@ public:
   StmtType type() const override { return StmtType::SELECT; }
 
 public:
-  static RC create(Db *db, SelectSqlNode &select_sql, Stmt *&stmt);
+  /**
+   * @param outer_tables 创建子查询时，外层查询的表，子查询的条件中可以引用这些表
+   */
+  static RC create(Db *db, SelectSqlNode &select_sql, Stmt *&stmt,
+      const unordered_map<string, Table *> *outer_tables = nullptr);
 
 public:
   const vector<Table *> &tables() const { return tables_; }
+
+  /**
+   * @brief 收集查询以及其中的子查询访问的所有表
+   */
+  void collect_tables(vector<Table *> &tables) const;
+
   FilterStmt            *filter_stmt() const { return filter_stmt_; }
 
   vector<unique_ptr<Expression>>                     &query_expressions() { return query_expressions_; }
@@ -0,0 +1,32 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/stmt/stmt.h"
+
+/**
+ * @brief 显示会话变量与执行计划缓存统计信息的语句
+ * @ingroup Statement
+ */
+class ShowVariablesStmt : public Stmt
+{
+public:
+  ShowVariablesStmt()          = default;
+  virtual ~ShowVariablesStmt() = default;
+
+  StmtType type() const override { return StmtType::SHOW_VARIABLES; }
+
+  static RC create(Stmt *&stmt)
+  {
+    stmt = new ShowVariablesStmt();
+    return RC::SUCCESS;
+  }
+};
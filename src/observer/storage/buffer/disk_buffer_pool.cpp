@@ -109,6 +109,14 @@ Frame *BPFrameManager::get(int buffer_pool_id, PageNum page_num)
   return get_internal(frame_id);
 }
 
+bool BPFrameManager::contains(int buffer_pool_id, PageNum page_num)
+{
+  FrameId frame_id(buffer_pool_id, page_num);
+
+  lock_guard<mutex> lock_guard(lock_);
+  return frames_.contains(frame_id);
+}
+
 Frame *BPFrameManager::get_internal(const FrameId &frame_id)
 {
   Frame *frame = nullptr;
@@ -504,6 +512,24 @@ RC DiskBufferPool::purge_page(PageNum page_num)
   return RC::SUCCESS;
 }
 
+bool DiskBufferPool::is_page_cached(PageNum page_num) { return frame_manager_.contains(id(), page_num); }
+
+RC DiskBufferPool::evict_page(PageNum page_num)
+{
+  scoped_lock lock_guard(lock_);
+
+  Frame *used_frame = frame_manager_.get(id(), page_num);
+  if (used_frame == nullptr) {
+    return RC::SUCCESS;
+  }
+  if (used_frame->pin_count() != 1 || used_frame->dirty()) {
+    // 其它地方还在使用，或者有没刷盘的修改，留在缓冲区中按正常的方式淘汰
+    used_frame->unpin();
+    return RC::SUCCESS;
+  }
+  return purge_frame(page_num, used_frame);
+}
+
 RC DiskBufferPool::purge_all_pages()
 {
   list<Frame *> used = frame_manager_.find_list(id());
@@ -102,6 +102,11 @@ public:
    */
   Frame *get(int buffer_pool_id, PageNum page_num);
 
+  /**
+   * @brief 页面是否在内存中。不会 pin 页面，也不改变淘汰顺序
+   */
+  bool contains(int buffer_pool_id, PageNum page_num);
+
   /**
    * @brief 列出所有指定文件的页面
    *
@@ -229,6 +234,19 @@ public:
   RC purge_page(PageNum page_num);
   RC purge_all_pages();
 
+  /**
+   * @brief 页面是否已经读取到缓冲区中
+   */
+  bool is_page_cached(PageNum page_num);
+
+  /**
+   * @brief 如果页面没有被其它地方使用，就把它淘汰出缓冲区
+   * @details 给只读一遍、不希望挤占缓冲区的扫描使用（比如 ANALYZE TABLE 的采样）：
+   * 扫描自己读进来的页面用完后马上释放 frame，不会把其它查询的热点页面淘汰出去。
+   * 页面还被其它地方 pin 住时什么也不做。
+   */
+  RC evict_page(PageNum page_num);
+
   /**
    * @brief 用于解除pageHandle对应页面的驻留缓冲区限制
    *
@@ -18,7 +18,10 @@ void Chunk::add_column(unique_ptr<Column> col, int col_id)
 
 RC Chunk::reference(Chunk &chunk)
 {
-  reset();
+  if (this == &chunk) {
+    return RC::SUCCESS;
+  }
+  column_ids_.clear();
   this->columns_.resize(chunk.column_num());
   for (size_t i = 0; i < columns_.size(); ++i) {
     if (nullptr == columns_[i]) {
@@ -27,9 +30,59 @@ RC Chunk::reference(Chunk &chunk)
     columns_[i]->reference(chunk.column(i));
     column_ids_.push_back(chunk.column_ids(i));
   }
+  selection_     = chunk.selection_;
+  has_selection_ = chunk.has_selection_;
+  memory_pool_   = chunk.memory_pool_;
+  return RC::SUCCESS;
+}
+
+void Chunk::set_selection(vector<int> &&selection)
+{
+  selection_     = std::move(selection);
+  has_selection_ = true;
+}
+
+void Chunk::set_selection(const vector<int> &selection)
+{
+  selection_     = selection;
+  has_selection_ = true;
+}
+
+void Chunk::clear_selection()
+{
+  selection_.clear();
+  has_selection_ = false;
+}
+
+RC Chunk::compact()
+{
+  if (!has_selection_) {
+    return RC::SUCCESS;
+  }
+  for (auto &col : columns_) {
+    RC rc = col->compact(selection_.data(), static_cast<int>(selection_.size()));
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to compact column. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+  clear_selection();
   return RC::SUCCESS;
 }
 
+void Chunk::limit(int n)
+{
+  if (has_selection_) {
+    if (static_cast<int>(selection_.size()) > n) {
+      selection_.resize(n);
+    }
+    return;
+  }
+  for (auto &col : columns_) {
+    col->limit(n);
+  }
+}
+
 int Chunk::rows() const
 {
   if (!columns_.empty()) {
@@ -51,10 +104,12 @@ void Chunk::reset_data()
   for (auto &col : columns_) {
     col->reset_data();
   }
+  clear_selection();
 }
 
 void Chunk::reset()
 {
   columns_.clear();
   column_ids_.clear();
+  clear_selection();
 }
\ No newline at end of file
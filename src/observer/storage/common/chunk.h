@@ -29,12 +29,18 @@ public:
     for (size_t i = 0; i < other.columns_.size(); ++i) {
       columns_.emplace_back(other.columns_[i]->clone());
     }
-    column_ids_ = other.column_ids_;
+    column_ids_    = other.column_ids_;
+    selection_     = other.selection_;
+    has_selection_ = other.has_selection_;
+    memory_pool_   = other.memory_pool_;
   }
   Chunk(Chunk &&chunk)
   {
-    columns_    = std::move(chunk.columns_);
-    column_ids_ = std::move(chunk.column_ids_);
+    columns_       = std::move(chunk.columns_);
+    column_ids_    = std::move(chunk.column_ids_);
+    selection_     = std::move(chunk.selection_);
+    has_selection_ = chunk.has_selection_;
+    memory_pool_   = chunk.memory_pool_;
   }
 
   int column_num() const { return columns_.size(); }
@@ -65,13 +71,59 @@ public:
 
   void add_column(unique_ptr<Column> col, int col_id);
 
+  /**
+   * @brief 引用另一个 Chunk 的数据
+   * @details 已有的 Column 对象会被复用，稳定运行时不需要申请内存
+   */
   RC reference(Chunk &chunk);
 
+  /**
+   * @brief 在这个 Chunk 上计算表达式时，临时列使用的内存池
+   * @details 由产生数据的算子设置，引用其它 Chunk 时一并引用它的内存池。为 nullptr 时直接从堆上申请
+   */
+  ColumnMemoryPool *memory_pool() const { return memory_pool_; }
+  void              set_memory_pool(ColumnMemoryPool *memory_pool) { memory_pool_ = memory_pool; }
+
   /**
    * @brief 获取 Chunk 中的行数
+   * @note 带选择向量时返回的是列中保存的行数，有效的行数需要使用 selected_rows
    */
   int rows() const;
 
+  /**
+   * @brief 设置选择向量
+   * @details selection 是升序的行号。带选择向量的 Chunk 中，列仍然保存所有的行，只有 selection 中的行是有效的。
+   * 表达式在这样的 Chunk 上计算得到的列与原来的列按行对齐，因此过滤之后的行不需要拷贝，
+   * 直到某个算子确实需要紧凑的数据时再调用 compact。
+   */
+  void set_selection(vector<int> &&selection);
+  void set_selection(const vector<int> &selection);
+  void clear_selection();
+
+  bool               has_selection() const { return has_selection_; }
+  const vector<int> &selection() const { return selection_; }
+
+  /**
+   * @brief 有效的行数。没有选择向量时等于 rows()
+   */
+  int selected_rows() const { return has_selection_ ? static_cast<int>(selection_.size()) : rows(); }
+
+  /**
+   * @brief 第 i 个有效行在列中的行号
+   */
+  int selected_row(int i) const { return has_selection_ ? selection_[i] : i; }
+
+  /**
+   * @brief 按选择向量把有效的行移动到列的前面，之后 Chunk 不再带有选择向量
+   * @details 自己持有内存的列原地移动；引用其它列的数据时会先拷贝一份，不会修改被引用的列
+   */
+  RC compact();
+
+  /**
+   * @brief 只保留前 n 个有效行
+   */
+  void limit(int n);
+
   /**
    * @brief 获取 Chunk 的容量
    */
@@ -102,4 +154,8 @@ private:
   // TODO: remove it and support multi-tables,
   // `columnd_ids` store the ids of child operator that need to be output
   vector<int> column_ids_;
+  /// 选择向量，只在 has_selection_ 为 true 时有效
+  vector<int>       selection_;
+  bool              has_selection_ = false;
+  ColumnMemoryPool *memory_pool_   = nullptr;
 };
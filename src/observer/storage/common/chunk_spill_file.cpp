@@ -0,0 +1,249 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "storage/common/chunk_spill_file.h"
+#include "common/io/io.h"
+#include "common/lang/filesystem.h"
+#include "common/lang/system_error.h"
+#include "common/log/log.h"
+#include "common/type/string_t.h"
+
+ChunkSpillFile::~ChunkSpillFile()
+{
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+RC ChunkSpillFile::open(const string &dir)
+{
+  error_code ec;
+  string     spill_dir = dir.empty() ? filesystem::temp_directory_path(ec).string() : dir;
+  if (ec) {
+    LOG_WARN("failed to get temp directory. error=%s", ec.message().c_str());
+    return RC::IOERR_OPEN;
+  }
+
+  string path = spill_dir + "/miniob_spill_XXXXXX";
+  fd_         = mkstemp(path.data());
+  if (fd_ < 0) {
+    LOG_WARN("failed to create spill file. path=%s, errno=%s", path.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  ::unlink(path.c_str());
+  buffer_.resize(BUFFER_SIZE);
+  LOG_DEBUG("create spill file %s", path.c_str());
+  return RC::SUCCESS;
+}
+
+RC ChunkSpillFile::write_chunk(const Chunk &chunk)
+{
+  RC rc = RC::SUCCESS;
+  if (fd_ < 0 || reading_) {
+    LOG_WARN("spill file is not writable");
+    return RC::INTERNAL;
+  }
+
+  const int32_t rows       = chunk.rows();
+  const int32_t column_num = chunk.column_num();
+  if (OB_FAIL(rc = write(&rows, sizeof(rows))) || OB_FAIL(rc = write(&column_num, sizeof(column_num)))) {
+    return rc;
+  }
+  for (int i = 0; i < column_num; i++) {
+    const Column &column    = chunk.column(i);
+    const int32_t attr_type = static_cast<int32_t>(column.attr_type());
+    const int32_t attr_len  = column.attr_len();
+    if (OB_FAIL(rc = write(&attr_type, sizeof(attr_type))) || OB_FAIL(rc = write(&attr_len, sizeof(attr_len)))) {
+      return rc;
+    }
+  }
+
+  for (int i = 0; i < column_num; i++) {
+    const Column &column = chunk.column(i);
+    const bool    constant = column.column_type() == Column::Type::CONSTANT_COLUMN;
+    if (column.attr_type() == AttrType::TEXTS) {
+      const string_t *strings = reinterpret_cast<const string_t *>(column.data());
+      for (int r = 0; r < rows && OB_SUCC(rc); r++) {
+        const string_t &str = strings[constant ? 0 : r];
+        const uint32_t  len = str.size();
+        if (OB_SUCC(rc = write(&len, sizeof(len)))) {
+          rc = write(str.data(), len);
+        }
+      }
+    } else if (constant) {
+      for (int r = 0; r < rows && OB_SUCC(rc); r++) {
+        rc = write(column.data(), column.attr_len());
+      }
+    } else {
+      rc = write(column.data(), static_cast<size_t>(rows) * column.attr_len());
+    }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  rows_ += rows;
+  return rc;
+}
+
+RC ChunkSpillFile::finish_write()
+{
+  RC rc = flush();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  if (::lseek(fd_, 0, SEEK_SET) < 0) {
+    LOG_WARN("failed to seek spill file. errno=%s", strerror(errno));
+    return RC::IOERR_SEEK;
+  }
+  reading_    = true;
+  buffer_pos_ = 0;
+  buffer_len_ = 0;
+  return rc;
+}
+
+RC ChunkSpillFile::read_chunk(Chunk &chunk)
+{
+  if (fd_ < 0 || !reading_) {
+    LOG_WARN("spill file is not readable");
+    return RC::INTERNAL;
+  }
+
+  int32_t rows       = 0;
+  int32_t column_num = 0;
+  RC      rc         = read(&rows, sizeof(rows));
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  if (OB_FAIL(rc = read(&column_num, sizeof(column_num)))) {
+    return rc == RC::RECORD_EOF ? RC::IOERR_READ : rc;
+  }
+
+  vector<AttrType> attr_types(column_num);
+  vector<int32_t>  attr_lens(column_num);
+  bool             reusable = chunk.column_num() == column_num;
+  for (int i = 0; i < column_num && OB_SUCC(rc); i++) {
+    int32_t attr_type = 0;
+    if (OB_SUCC(rc = read(&attr_type, sizeof(attr_type)))) {
+      rc = read(&attr_lens[i], sizeof(int32_t));
+    }
+    attr_types[i] = static_cast<AttrType>(attr_type);
+    reusable      = reusable && chunk.column(i).attr_type() == attr_types[i] &&
+               chunk.column(i).attr_len() == attr_lens[i] && chunk.column(i).capacity() >= rows &&
+               chunk.column(i).column_type() == Column::Type::NORMAL_COLUMN;
+  }
+  if (OB_FAIL(rc)) {
+    return rc == RC::RECORD_EOF ? RC::IOERR_READ : rc;
+  }
+
+  if (reusable) {
+    chunk.reset_data();
+  } else {
+    chunk.reset();
+    for (int i = 0; i < column_num; i++) {
+      chunk.add_column(make_unique<Column>(attr_types[i], attr_lens[i], std::max<size_t>(rows, 1)), i);
+    }
+  }
+
+  vector<char> data;
+  for (int i = 0; i < column_num && OB_SUCC(rc); i++) {
+    Column &column = chunk.column(i);
+    if (attr_types[i] == AttrType::TEXTS) {
+      for (int r = 0; r < rows && OB_SUCC(rc); r++) {
+        uint32_t len = 0;
+        if (OB_FAIL(rc = read(&len, sizeof(len)))) {
+          break;
+        }
+        data.resize(len);
+        if (OB_SUCC(rc = read(data.data(), len))) {
+          string_t str = column.add_text(data.data(), len);
+          rc           = column.append_one(reinterpret_cast<const char *>(&str));
+        }
+      }
+    } else {
+      data.resize(static_cast<size_t>(rows) * attr_lens[i]);
+      if (OB_SUCC(rc = read(data.data(), data.size()))) {
+        rc = column.append(data.data(), rows);
+      }
+    }
+  }
+  if (rc == RC::RECORD_EOF) {
+    LOG_WARN("spill file is truncated");
+    rc = RC::IOERR_READ;
+  }
+  return rc;
+}
+
+RC ChunkSpillFile::write(const void *data, size_t size)
+{
+  const char *ptr = static_cast<const char *>(data);
+  while (size > 0) {
+    if (buffer_pos_ == buffer_.size()) {
+      RC rc = flush();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    const size_t len = std::min(size, buffer_.size() - buffer_pos_);
+    memcpy(buffer_.data() + buffer_pos_, ptr, len);
+    buffer_pos_ += len;
+    bytes_ += len;
+    ptr += len;
+    size -= len;
+  }
+  return RC::SUCCESS;
+}
+
+RC ChunkSpillFile::flush()
+{
+  if (buffer_pos_ == 0) {
+    return RC::SUCCESS;
+  }
+  int ret = common::writen(fd_, buffer_.data(), buffer_pos_);
+  if (ret != 0) {
+    LOG_WARN("failed to write spill file. error=%s", strerror(ret));
+    return RC::IOERR_WRITE;
+  }
+  buffer_pos_ = 0;
+  return RC::SUCCESS;
+}
+
+RC ChunkSpillFile::read(void *data, size_t size)
+{
+  char *ptr = static_cast<char *>(data);
+  while (size > 0) {
+    if (buffer_pos_ == buffer_len_) {
+      ssize_t ret = ::read(fd_, buffer_.data(), buffer_.size());
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        LOG_WARN("failed to read spill file. errno=%s", strerror(errno));
+        return RC::IOERR_READ;
+      }
+      if (ret == 0) {
+        return RC::RECORD_EOF;
+      }
+      buffer_pos_ = 0;
+      buffer_len_ = ret;
+    }
+    const size_t len = std::min(size, buffer_len_ - buffer_pos_);
+    memcpy(ptr, buffer_.data() + buffer_pos_, len);
+    buffer_pos_ += len;
+    ptr += len;
+    size -= len;
+  }
+  return RC::SUCCESS;
+}
@@ -0,0 +1,74 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/sys/rc.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/common/chunk.h"
+
+/**
+ * @brief 算子溢出(spill)到磁盘时使用的临时文件
+ * @details 文件在创建后立即被删除(unlink)，关闭文件描述符后磁盘空间会被自动回收，
+ * 即使进程异常退出也不会遗留临时文件。
+ * 文件以 Chunk 为单位先顺序写入，调用 finish_write 之后再从头顺序读出。每个 Chunk 按列存放：
+ * 定长类型直接写入列的原始数据，TEXTS 类型写入每一行的长度与内容。
+ */
+class ChunkSpillFile
+{
+public:
+  ChunkSpillFile() = default;
+  ~ChunkSpillFile();
+
+  ChunkSpillFile(const ChunkSpillFile &)            = delete;
+  ChunkSpillFile &operator=(const ChunkSpillFile &) = delete;
+
+  /**
+   * @brief 在 dir 目录下创建临时文件，dir 为空时使用系统临时目录
+   */
+  RC open(const string &dir = "");
+
+  RC write_chunk(const Chunk &chunk);
+
+  /**
+   * @brief 结束写入并切换到读模式
+   */
+  RC finish_write();
+
+  /**
+   * @brief 读取下一个 Chunk
+   * @details 如果 chunk 的列与文件中的列类型一致，会复用 chunk 中的列，否则重新创建。
+   * @return 读取完毕时返回 RECORD_EOF
+   */
+  RC read_chunk(Chunk &chunk);
+
+  /// 已经写入的行数
+  int64_t rows() const { return rows_; }
+
+  /// 已经写入的字节数
+  int64_t bytes() const { return bytes_; }
+
+private:
+  RC write(const void *data, size_t size);
+  RC flush();
+  RC read(void *data, size_t size);
+
+private:
+  static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+  int          fd_ = -1;
+  vector<char> buffer_;
+  size_t       buffer_pos_ = 0;  ///< 写模式下是缓冲区中数据的长度，读模式下是下一个要读取的位置
+  size_t       buffer_len_ = 0;  ///< 读模式下缓冲区中有效数据的长度
+  bool         reading_    = false;
+  int64_t      rows_       = 0;
+  int64_t      bytes_      = 0;
+};
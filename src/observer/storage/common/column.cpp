@@ -24,7 +24,7 @@ Column::Column(const FieldMeta &meta, size_t size)
       column_type_(Type::NORMAL_COLUMN)
 {
   // TODO: optimized the memory usage if it doesn't need to allocate memory
-  data_ = new char[size * attr_len_];
+  reserve_data(size * attr_len_);
   memset(data_, 0, size * attr_len_);
   capacity_ = size;
 }
@@ -33,7 +33,7 @@ Column::Column(AttrType attr_type, int attr_len, size_t capacity)
 {
   attr_type_ = attr_type;
   attr_len_  = attr_len;
-  data_      = new char[capacity * attr_len_];
+  reserve_data(capacity * attr_len_);
   memset(data_, 0, capacity * attr_len_);
   count_       = 0;
   capacity_    = capacity;
@@ -43,8 +43,9 @@ Column::Column(AttrType attr_type, int attr_len, size_t capacity)
 
 void Column::init(const FieldMeta &meta, size_t size)
 {
-  reset();
-  data_ = new char[size * meta.len()];
+  vector_buffer_ = nullptr;
+  clear_nulls();
+  reserve_data(size * meta.len());
   memset(data_, 0, size * meta.len());
   count_       = 0;
   capacity_    = size;
@@ -56,8 +57,9 @@ void Column::init(const FieldMeta &meta, size_t size)
 
 void Column::init(AttrType attr_type, int attr_len, size_t capacity)
 {
-  reset();
-  data_ = new char[capacity * attr_len];
+  vector_buffer_ = nullptr;
+  clear_nulls();
+  reserve_data(capacity * attr_len);
   memset(data_, 0, capacity * attr_len);
   count_       = 0;
   capacity_    = capacity;
@@ -72,7 +74,7 @@ void Column::init(const Value &value, size_t size)
   int attr_len;
   switch (value.attr_type()) {
     case AttrType::CHARS: {
-      attr_len = size;
+      attr_len = std::max(value.length(), 1);
     } break;
     default: attr_len = get_default_length(value.attr_type());
   }
@@ -87,15 +89,56 @@ void Column::reset()
   if (vector_buffer_ != nullptr) {
     vector_buffer_ = nullptr;
   }
-  if (data_ != nullptr && own_) {
-    delete[] data_;
+  if (own_) {
+    free_data(data_, data_capacity_);
+  }
+  data_          = nullptr;
+  data_capacity_ = 0;
+  count_         = 0;
+  capacity_      = 0;
+  own_           = false;
+  attr_type_     = AttrType::UNDEFINED;
+  attr_len_      = -1;
+  clear_nulls();
+}
+
+void Column::set_memory_pool(ColumnMemoryPool *memory_pool)
+{
+  reset();
+  memory_pool_ = memory_pool;
+}
+
+void Column::reserve_data(size_t bytes)
+{
+  if (own_ && data_ != nullptr && data_capacity_ >= bytes) {
+    return;
+  }
+  if (own_) {
+    free_data(data_, data_capacity_);
+  }
+  data_ = allocate_data(bytes, data_capacity_);
+  own_  = true;
+}
+
+char *Column::allocate_data(size_t bytes, size_t &capacity)
+{
+  if (memory_pool_ != nullptr) {
+    return memory_pool_->allocate(bytes, capacity);
+  }
+  capacity = bytes;
+  return new char[bytes];
+}
+
+void Column::free_data(char *data, size_t capacity)
+{
+  if (data == nullptr) {
+    return;
+  }
+  if (memory_pool_ != nullptr) {
+    memory_pool_->deallocate(data, capacity);
+  } else {
+    delete[] data;
   }
-  data_      = nullptr;
-  count_     = 0;
-  capacity_  = 0;
-  own_       = false;
-  attr_type_ = AttrType::UNDEFINED;
-  attr_len_  = -1;
 }
 
 RC Column::append_one(const char *data) { return append(data, 1); }
@@ -143,6 +186,65 @@ RC Column::append_value(const Value &value)
   return RC::SUCCESS;
 }
 
+RC Column::append_null()
+{
+  if (!own_) {
+    LOG_WARN("append data to non-owned column");
+    return RC::INTERNAL;
+  }
+  if (count_ >= capacity_) {
+    LOG_WARN("append data to full column");
+    return RC::INTERNAL;
+  }
+  memset(data_ + static_cast<size_t>(count_) * attr_len_, 0, attr_len_);
+  set_null(count_);
+  count_ += 1;
+  return RC::SUCCESS;
+}
+
+void Column::set_null(int index)
+{
+  if (column_type_ == Type::CONSTANT_COLUMN) {
+    index = 0;
+  }
+  const size_t words = (static_cast<size_t>(std::max(capacity_, index + 1)) + 63) / 64;
+  if (nulls_.size() < words) {
+    nulls_.resize(words, 0);
+  }
+  nulls_[index >> 6] |= uint64_t(1) << (index & 63);
+  has_nulls_ = true;
+}
+
+void Column::merge_nulls(const Column &left, const Column &right)
+{
+  clear_nulls();
+  for (const Column *input : {&left, &right}) {
+    if (!input->has_nulls()) {
+      continue;
+    }
+    if (input->column_type() == Type::CONSTANT_COLUMN) {
+      if (input->is_null(0)) {
+        // 常量 NULL 参与运算，所有行都是 NULL
+        if (column_type_ == Type::CONSTANT_COLUMN) {
+          set_null(0);
+        } else {
+          nulls_.assign((static_cast<size_t>(std::max(capacity_, count_)) + 63) / 64, ~uint64_t(0));
+          has_nulls_ = true;
+        }
+      }
+      continue;
+    }
+    const size_t words = std::min((static_cast<size_t>(count_) + 63) / 64, input->nulls_.size());
+    if (nulls_.size() < words) {
+      nulls_.resize(words, 0);
+    }
+    for (size_t i = 0; i < words; i++) {
+      nulls_[i] |= input->nulls_[i];
+    }
+    has_nulls_ = true;
+  }
+}
+
 string_t Column::add_text(const char *data, int length)
 {
   if (vector_buffer_ == nullptr) {
@@ -164,7 +266,7 @@ Value Column::get_value(int index) const
   if (column_type_ == Type::CONSTANT_COLUMN) {
     index = 0;
   }
-  if (index >= count_ || index < 0) {
+  if (index >= count_ || index < 0 || is_null(index)) {
     return Value();
   }
   if (attr_type_ == AttrType::TEXTS) {
@@ -175,6 +277,78 @@ Value Column::get_value(int index) const
   return Value(attr_type_, &data_[index * attr_len_], attr_len_);
 }
 
+namespace {
+/// 16 字节的定长数据，例如 string_t
+struct Bytes16
+{
+  int64_t low;
+  int64_t high;
+};
+
+template <typename T>
+void gather_rows(const char *src, char *dest, const int *selection, int count)
+{
+  const T *src_values  = reinterpret_cast<const T *>(src);
+  T       *dest_values = reinterpret_cast<T *>(dest);
+  for (int i = 0; i < count; i++) {
+    dest_values[i] = src_values[selection[i]];
+  }
+}
+}  // namespace
+
+RC Column::compact(const int *selection, int count)
+{
+  if (count > count_) {
+    LOG_WARN("invalid selection. selected rows=%d, rows=%d", count, count_);
+    return RC::INVALID_ARGUMENT;
+  }
+  if (column_type_ == Type::CONSTANT_COLUMN) {
+    count_ = count;
+    return RC::SUCCESS;
+  }
+
+  // selection 是升序的，所以原地移动时第 i 行的来源不会早于第 i 行，不会被覆盖
+  size_t dest_capacity = data_capacity_;
+  char  *dest          = own_ ? data_ : allocate_data(static_cast<size_t>(capacity_) * attr_len_, dest_capacity);
+  switch (attr_len_) {
+    case 1: gather_rows<int8_t>(data_, dest, selection, count); break;
+    case 4: gather_rows<int32_t>(data_, dest, selection, count); break;
+    case 8: gather_rows<int64_t>(data_, dest, selection, count); break;
+    case 16: gather_rows<Bytes16>(data_, dest, selection, count); break;
+    default: {
+      for (int i = 0; i < count; i++) {
+        if (dest != data_ || selection[i] != i) {
+          memcpy(dest + static_cast<size_t>(i) * attr_len_,
+              data_ + static_cast<size_t>(selection[i]) * attr_len_,
+              attr_len_);
+        }
+      }
+    } break;
+  }
+  if (!own_) {
+    data_          = dest;
+    data_capacity_ = dest_capacity;
+    own_           = true;
+  }
+  if (has_nulls_) {
+    // 与数据一样原地收拢，第 i 位的来源不早于第 i 位
+    for (int i = 0; i < count; i++) {
+      const int      src  = selection[i];
+      const uint64_t bit  = (nulls_[src >> 6] >> (src & 63)) & 1;
+      const uint64_t mask = uint64_t(1) << (i & 63);
+      nulls_[i >> 6]      = (nulls_[i >> 6] & ~mask) | (bit << (i & 63));
+    }
+    // 清掉被丢弃的行，避免之后追加的数据继承旧的标记
+    const size_t tail_word = static_cast<size_t>(count) >> 6;
+    if (tail_word < nulls_.size()) {
+      nulls_[tail_word] &= (uint64_t(1) << (count & 63)) - 1;
+      std::fill(nulls_.begin() + tail_word + 1, nulls_.end(), 0);
+    }
+  }
+  count_ = count;
+  return RC::SUCCESS;
+}
+
 void Column::reference(const Column &column)
 {
   if (this == &column) {
@@ -190,4 +364,6 @@ void Column::reference(const Column &column)
   this->column_type_ = column.column_type();
   this->attr_type_   = column.attr_type();
   this->attr_len_    = column.attr_len();
+  this->nulls_       = column.nulls_;
+  this->has_nulls_   = column.has_nulls_;
 }
\ No newline at end of file
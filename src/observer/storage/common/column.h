@@ -13,7 +13,9 @@ See the Mulan PSL v2 for more details. */
 #include <memory>
 #include <string.h>
 
+#include "common/lang/vector.h"
 #include "storage/field/field_meta.h"
+#include "storage/common/column_memory_pool.h"
 #include "storage/common/vector_buffer.h"
 
 /**
@@ -31,41 +33,66 @@ public:
 
   Column() = default;
 
+  /**
+   * @brief 列数据从 memory_pool 中申请，为 nullptr 时直接从堆上申请
+   */
+  explicit Column(ColumnMemoryPool *memory_pool) : memory_pool_(memory_pool) {}
+
   Column(const Column &other)
   {
-    count_       = other.count_;
-    capacity_    = other.capacity_;
-    own_         = true;
-    attr_type_   = other.attr_type_;
-    attr_len_    = other.attr_len_;
-    column_type_ = other.column_type_;
-    data_        = new char[capacity_ * attr_len_];
-    memcpy(data_, other.data_, capacity_ * attr_len_);
+    count_         = other.count_;
+    capacity_      = other.capacity_;
+    own_           = true;
+    attr_type_     = other.attr_type_;
+    attr_len_      = other.attr_len_;
+    column_type_   = other.column_type_;
+    data_capacity_ = static_cast<size_t>(capacity_) * attr_len_;
+    data_          = new char[data_capacity_];
+    memcpy(data_, other.data_, data_capacity_);
     vector_buffer_ = make_unique<VectorBuffer>();
+    nulls_         = other.nulls_;
+    has_nulls_     = other.has_nulls_;
   }
   Column(Column &&other)
   {
-    data_           = other.data_;
-    count_          = other.count_;
-    capacity_       = other.capacity_;
-    own_            = other.own_;
-    attr_type_      = other.attr_type_;
-    attr_len_       = other.attr_len_;
-    column_type_    = other.column_type_;
-    vector_buffer_  = std::move(other.vector_buffer_);
-    other.data_     = nullptr;
-    other.count_    = 0;
-    other.capacity_ = 0;
-    other.own_      = false;
+    data_                = other.data_;
+    count_               = other.count_;
+    capacity_            = other.capacity_;
+    own_                 = other.own_;
+    attr_type_           = other.attr_type_;
+    attr_len_            = other.attr_len_;
+    column_type_         = other.column_type_;
+    vector_buffer_       = std::move(other.vector_buffer_);
+    nulls_               = std::move(other.nulls_);
+    has_nulls_           = other.has_nulls_;
+    memory_pool_         = other.memory_pool_;
+    data_capacity_       = other.data_capacity_;
+    other.data_          = nullptr;
+    other.count_         = 0;
+    other.capacity_      = 0;
+    other.own_           = false;
+    other.has_nulls_     = false;
+    other.data_capacity_ = 0;
   }
 
   Column(const FieldMeta &meta, size_t size = DEFAULT_CAPACITY);
   Column(AttrType attr_type, int attr_len, size_t size = DEFAULT_CAPACITY);
 
+  /**
+   * @brief 重新初始化列
+   * @details 列自己持有的内存足够大时直接复用，不会重新申请
+   */
   void init(const FieldMeta &meta, size_t size = DEFAULT_CAPACITY);
   void init(AttrType attr_type, int attr_len, size_t size = DEFAULT_CAPACITY);
   void init(const Value &value, size_t size);
 
+  /**
+   * @brief 设置申请列数据使用的内存池，会先释放列中的数据
+   */
+  void set_memory_pool(ColumnMemoryPool *memory_pool);
+
+  ColumnMemoryPool *memory_pool() const { return memory_pool_; }
+
   unique_ptr<Column> clone() const { return make_unique<Column>(*this); }
 
   virtual ~Column() { reset(); }
@@ -83,17 +110,72 @@ public:
    */
   RC append(const char *data, int count);
 
+  /**
+   * @brief 追加一个 NULL 值，数据部分填 0
+   */
+  RC append_null();
+
   /**
    * @brief 获取 index 位置的列值
+   * @details NULL 值返回 UNDEFINED 类型的 Value
    */
   Value get_value(int index) const;
 
+  /**
+   * @brief 列中是否可能包含 NULL 值
+   * @details 为 false 时没有 NULL 掩码，各种算子可以直接走不检查 NULL 的快速路径
+   */
+  bool has_nulls() const { return has_nulls_; }
+
+  /**
+   * @brief index 位置的列值是否为 NULL。常量列只看第 0 位
+   */
+  bool is_null(int index) const
+  {
+    if (!has_nulls_) {
+      return false;
+    }
+    if (column_type_ == Type::CONSTANT_COLUMN) {
+      index = 0;
+    }
+    return (nulls_[index >> 6] >> (index & 63)) & 1;
+  }
+
+  /**
+   * @brief 把 index 位置标记为 NULL，第一次调用时才会申请掩码内存
+   */
+  void set_null(int index);
+
+  /**
+   * @brief NULL 掩码，第 i 位为 1 表示第 i 行为 NULL。没有 NULL 时返回 nullptr
+   */
+  const uint64_t *null_mask() const { return has_nulls_ ? nulls_.data() : nullptr; }
+
+  void clear_nulls()
+  {
+    nulls_.clear();
+    has_nulls_ = false;
+  }
+
+  /**
+   * @brief 把两个输入列的 NULL 掩码合并到当前列，用于二元运算的结果列
+   * @details 任意一个输入为 NULL 时结果为 NULL。两个输入都没有 NULL 时只清空当前列的掩码
+   */
+  void merge_nulls(const Column &left, const Column &right);
+
   RC copy_to(void *dest, int start_rows, int insert_rows) const
   {
     memcpy(dest, data_ + start_rows * attr_len_, insert_rows * attr_len_);
     return RC::SUCCESS;
   }
 
+  /**
+   * @brief 按 selection 中的行号把对应的行移动到列的前面，列中只保留 count 行
+   * @param selection 升序的行号
+   * @details 不持有内存的列会先拷贝到新申请的内存中
+   */
+  RC compact(const int *selection, int count);
+
   void limit(int limitation)
   {
     if (count_ > limitation) {
@@ -117,6 +199,7 @@ public:
   {
     count_         = 0;
     vector_buffer_ = nullptr;
+    clear_nulls();
   }
 
   /**
@@ -139,6 +222,12 @@ public:
   Type                    column_type() const { return column_type_; }
   static constexpr size_t DEFAULT_CAPACITY = 8192;
 
+private:
+  /// 申请至少 bytes 字节的数据内存，自己持有的内存足够大时直接复用
+  void reserve_data(size_t bytes);
+  char *allocate_data(size_t bytes, size_t &capacity);
+  void  free_data(char *data, size_t capacity);
+
 private:
   char *data_ = nullptr;
   /// 当前列值数量
@@ -154,4 +243,12 @@ private:
   /// 列类型
   Type                     column_type_   = Type::NORMAL_COLUMN;
   unique_ptr<VectorBuffer> vector_buffer_ = nullptr;
+  /// NULL 掩码，每行一位，按需申请
+  vector<uint64_t> nulls_;
+  /// 是否存在 NULL 掩码，为 false 时 nulls_ 为空
+  bool has_nulls_ = false;
+  /// 数据内存的来源，为 nullptr 时使用 new/delete
+  ColumnMemoryPool *memory_pool_ = nullptr;
+  /// 自己持有的数据内存的实际大小（字节）
+  size_t data_capacity_ = 0;
 };
\ No newline at end of file
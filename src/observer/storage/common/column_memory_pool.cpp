@@ -0,0 +1,57 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/common/column_memory_pool.h"
+#include "common/log/log.h"
+
+int ColumnMemoryPool::size_class(size_t bytes)
+{
+  int index = 0;
+  while ((size_t(1) << (MIN_SIZE_CLASS + index)) < bytes) {
+    index++;
+  }
+  return index;
+}
+
+char *ColumnMemoryPool::allocate(size_t bytes, size_t &capacity)
+{
+  if (bytes == 0) {
+    bytes = 1;
+  }
+  ASSERT(bytes <= MAX_BLOCK_SIZE, "column memory block is too large. bytes=%lu", bytes);
+
+  const int index = size_class(bytes);
+  capacity        = size_t(1) << (MIN_SIZE_CLASS + index);
+
+  vector<char *> &free_list = free_lists_[index];
+  if (!free_list.empty()) {
+    char *data = free_list.back();
+    free_list.pop_back();
+    return data;
+  }
+  return arena_.AllocateAligned(capacity);
+}
+
+void ColumnMemoryPool::deallocate(char *data, size_t capacity)
+{
+  if (data == nullptr) {
+    return;
+  }
+  free_lists_[size_class(capacity)].push_back(data);
+}
+
+size_t ColumnMemoryPool::free_blocks() const
+{
+  size_t blocks = 0;
+  for (const vector<char *> &free_list : free_lists_) {
+    blocks += free_list.size();
+  }
+  return blocks;
+}
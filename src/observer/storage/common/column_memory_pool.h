@@ -0,0 +1,64 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/array.h"
+#include "common/lang/vector.h"
+#include "storage/common/arena_allocator.h"
+
+/**
+ * @brief 列数据的内存池
+ * @details 向量化执行时每个 chunk 都会为表达式的结果和中间结果申请列内存，算完之后马上释放，
+ * 下一个 chunk 又申请同样大小的内存。内存池从 Arena 中按 2 的幂次切出内存块，释放的内存块按大小
+ * 挂到空闲链表上，之后同样大小的申请直接复用，稳定运行时处理每个 chunk 都不再调用 malloc。
+ * 内存只在内存池析构时才归还给系统。
+ *
+ * 内存池不是线程安全的，由一个算子（或者一个执行线程）独占。从内存池申请内存的列必须在内存池
+ * 析构之前释放，因此算子中内存池成员要声明在使用它的 Chunk/Column 之前。
+ */
+class ColumnMemoryPool
+{
+public:
+  ColumnMemoryPool() = default;
+
+  ColumnMemoryPool(const ColumnMemoryPool &)            = delete;
+  ColumnMemoryPool &operator=(const ColumnMemoryPool &) = delete;
+
+  /**
+   * @brief 申请至少 bytes 字节的内存
+   * @param[out] capacity 实际可用的字节数，释放时需要传回来
+   */
+  char *allocate(size_t bytes, size_t &capacity);
+
+  /**
+   * @brief 释放 allocate 申请的内存
+   * @param capacity allocate 返回的实际字节数
+   */
+  void deallocate(char *data, size_t capacity);
+
+  /// 从 Arena 中申请的内存总量
+  size_t memory_usage() const { return arena_.MemoryUsage(); }
+
+  /// 空闲链表中可以复用的内存块数量
+  size_t free_blocks() const;
+
+private:
+  /// 最小的内存块 64 字节，即一个缓存行
+  static constexpr int    MIN_SIZE_CLASS = 6;
+  static constexpr int    SIZE_CLASS_NUM = 40;
+  static constexpr size_t MAX_BLOCK_SIZE = size_t(1) << (MIN_SIZE_CLASS + SIZE_CLASS_NUM - 1);
+
+  static int size_class(size_t bytes);
+
+private:
+  Arena                                  arena_;
+  array<vector<char *>, SIZE_CLASS_NUM> free_lists_;
+};
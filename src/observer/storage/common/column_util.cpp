@@ -0,0 +1,89 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/common/column_util.h"
+#include "common/lang/algorithm.h"
+#include "common/type/string_t.h"
+
+namespace {
+template <typename T>
+inline int compare_number(T left, T right)
+{
+  return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+inline const char *row_data(const Column &column, int row)
+{
+  const int stride = column.column_type() == Column::Type::CONSTANT_COLUMN ? 0 : 1;
+  return column.data() + static_cast<size_t>(row) * stride * column.attr_len();
+}
+}  // namespace
+
+int compare_column_value(const Column &left, int left_row, const Column &right, int right_row)
+{
+  const char *left_data  = row_data(left, left_row);
+  const char *right_data = row_data(right, right_row);
+  switch (left.attr_type()) {
+    case AttrType::INTS:
+    case AttrType::DATES: {
+      return compare_number(*reinterpret_cast<const int *>(left_data), *reinterpret_cast<const int *>(right_data));
+    }
+    case AttrType::BIGINTS: {
+      return compare_number(
+          *reinterpret_cast<const int64_t *>(left_data), *reinterpret_cast<const int64_t *>(right_data));
+    }
+    case AttrType::FLOATS: {
+      return compare_number(*reinterpret_cast<const float *>(left_data), *reinterpret_cast<const float *>(right_data));
+    }
+    case AttrType::BOOLEANS: {
+      return compare_number(*reinterpret_cast<const bool *>(left_data), *reinterpret_cast<const bool *>(right_data));
+    }
+    case AttrType::CHARS: {
+      const size_t left_len  = strnlen(left_data, left.attr_len());
+      const size_t right_len = strnlen(right_data, right.attr_len());
+      const int    cmp       = memcmp(left_data, right_data, std::min(left_len, right_len));
+      return cmp != 0 ? cmp : compare_number(left_len, right_len);
+    }
+    case AttrType::TEXTS: {
+      const string_t &left_str  = *reinterpret_cast<const string_t *>(left_data);
+      const string_t &right_str = *reinterpret_cast<const string_t *>(right_data);
+      return left_str < right_str ? -1 : (right_str < left_str ? 1 : 0);
+    }
+    default: {
+      return left.get_value(left_row).compare(right.get_value(right_row));
+    }
+  }
+}
+
+RC copy_column_row(const Column &src, int row, Column &dst)
+{
+  if (src.is_null(row)) {
+    return dst.append_null();
+  }
+  const char *value = row_data(src, row);
+  if (src.attr_type() == AttrType::TEXTS) {
+    const string_t *str  = reinterpret_cast<const string_t *>(value);
+    string_t        copy = dst.add_text(str->data(), str->size());
+    return dst.append_one(reinterpret_cast<const char *>(&copy));
+  }
+  return dst.append_one(value);
+}
+
+RC copy_column_rows(const Column &src, int rows, Column &dst)
+{
+  if (src.attr_type() != AttrType::TEXTS && src.column_type() == Column::Type::NORMAL_COLUMN && !src.has_nulls()) {
+    return dst.append(src.data(), rows);
+  }
+  RC rc = RC::SUCCESS;
+  for (int i = 0; i < rows && OB_SUCC(rc); i++) {
+    rc = copy_column_row(src, i, dst);
+  }
+  return rc;
+}
@@ -0,0 +1,31 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/sys/rc.h"
+#include "storage/common/column.h"
+
+/**
+ * @brief 比较两个列中的值，两个列的类型需要相同
+ * @details 常用类型直接比较列中的数据，其它类型退化为 Value::compare。支持常量列
+ */
+int compare_column_value(const Column &left, int left_row, const Column &right, int right_row);
+
+/**
+ * @brief 将 src 中的第 row 行追加到 dst 中
+ * @details TEXTS 类型的字符串内容会被拷贝到 dst 的 VectorBuffer 中，dst 不依赖 src 的生命周期。NULL 值追加为 NULL
+ */
+RC copy_column_row(const Column &src, int row, Column &dst);
+
+/**
+ * @brief 将 src 中的前 rows 行追加到 dst 中，常量列会被展开
+ */
+RC copy_column_rows(const Column &src, int rows, Column &dst);
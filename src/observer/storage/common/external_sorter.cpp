@@ -0,0 +1,582 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/common/external_sorter.h"
+#include "common/lang/algorithm.h"
+#include "common/log/log.h"
+#include "common/type/string_t.h"
+#include "storage/common/chunk_spill_file.h"
+#include "storage/common/column_util.h"
+
+namespace {
+
+/**
+ * @brief 将列中前 rows 行编码成规范化键，第 i 行写入 dst + i * stride 处，占用 width 个字节
+ * @details 整数转换成大端序并翻转符号位；浮点数为正时翻转符号位，为负时按位取反；
+ * 字符串不足 width 的部分补零。编码后的字节串按 memcmp 比较的结果与原值的升序一致。
+ * @return 列的类型不支持时返回 false
+ */
+bool encode_normalized_key(const Column &column, int rows, uint8_t *dst, int stride, int width)
+{
+  const char *data = column.data();
+  switch (column.attr_type()) {
+    case AttrType::INTS:
+    case AttrType::DATES: {
+      const int32_t *values = reinterpret_cast<const int32_t *>(data);
+      for (int i = 0; i < rows; i++) {
+        uint32_t key = __builtin_bswap32(static_cast<uint32_t>(values[i]) ^ 0x80000000U);
+        memcpy(dst + static_cast<size_t>(i) * stride, &key, sizeof(key));
+      }
+    } break;
+    case AttrType::BIGINTS: {
+      const int64_t *values = reinterpret_cast<const int64_t *>(data);
+      for (int i = 0; i < rows; i++) {
+        uint64_t key = __builtin_bswap64(static_cast<uint64_t>(values[i]) ^ 0x8000000000000000ULL);
+        memcpy(dst + static_cast<size_t>(i) * stride, &key, sizeof(key));
+      }
+    } break;
+    case AttrType::FLOATS: {
+      const float *values = reinterpret_cast<const float *>(data);
+      for (int i = 0; i < rows; i++) {
+        float    value = values[i] == 0.0f ? 0.0f : values[i];
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        bits         = (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+        uint32_t key = __builtin_bswap32(bits);
+        memcpy(dst + static_cast<size_t>(i) * stride, &key, sizeof(key));
+      }
+    } break;
+    case AttrType::BOOLEANS: {
+      for (int i = 0; i < rows; i++) {
+        dst[static_cast<size_t>(i) * stride] = data[i] ? 1 : 0;
+      }
+    } break;
+    case AttrType::CHARS: {
+      const int attr_len = column.attr_len();
+      for (int i = 0; i < rows; i++) {
+        const char *value = data + static_cast<size_t>(i) * attr_len;
+        uint8_t    *key   = dst + static_cast<size_t>(i) * stride;
+        const int   len   = strnlen(value, attr_len);
+        memcpy(key, value, len);
+        memset(key + len, 0, width - len);
+      }
+    } break;
+    case AttrType::TEXTS: {
+      const string_t *values = reinterpret_cast<const string_t *>(data);
+      for (int i = 0; i < rows; i++) {
+        uint8_t  *key = dst + static_cast<size_t>(i) * stride;
+        const int len = std::min<int>(values[i].size(), width);
+        memcpy(key, values[i].data(), len);
+        memset(key + len, 0, width - len);
+      }
+    } break;
+    default: {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t chunk_memory_usage(const Chunk &chunk)
+{
+  size_t usage = 0;
+  for (int i = 0; i < chunk.column_num(); i++) {
+    const Column &column = chunk.column(i);
+    usage += static_cast<size_t>(column.capacity()) * column.attr_len();
+    if (column.attr_type() == AttrType::TEXTS) {
+      const string_t *strings = reinterpret_cast<const string_t *>(column.data());
+      for (int r = 0; r < column.count(); r++) {
+        if (strings[r].size() > string_t::INLINE_LENGTH) {
+          usage += strings[r].size();
+        }
+      }
+    }
+  }
+  return usage;
+}
+
+}  // namespace
+
+/**
+ * @brief 使用败者树对多个顺串做多路归并
+ * @details 败者树的内部节点记录比较中失败的顺串，tree_[0] 记录最终的胜者，即当前最小的行。
+ * 每输出一行只需要沿着胜者所在的叶子到根的路径比较 log(k) 次。
+ */
+class ExternalSorter::Merger
+{
+public:
+  Merger(const ExternalSorter &sorter, vector<unique_ptr<ChunkSpillFile>> runs) : sorter_(sorter)
+  {
+    for (auto &run : runs) {
+      auto source  = make_unique<Source>();
+      source->file = std::move(run);
+      sources_.push_back(std::move(source));
+    }
+  }
+
+  RC init()
+  {
+    RC rc = RC::SUCCESS;
+    for (int i = 0; i < static_cast<int>(sources_.size()); i++) {
+      if (OB_FAIL(rc = sources_[i]->file->finish_write()) || OB_FAIL(rc = advance(i))) {
+        LOG_WARN("failed to open sorted run. rc=%s", strrc(rc));
+        return rc;
+      }
+    }
+
+    // -1 表示一个比任何行都小的虚拟顺串，在建树的过程中被逐渐替换掉
+    tree_.assign(sources_.size(), -1);
+    for (int i = static_cast<int>(sources_.size()) - 1; i >= 0; i--) {
+      adjust(i);
+    }
+    return rc;
+  }
+
+  /**
+   * @brief 按顺序输出数据，直到 chunk 写满。chunk 中的列是顺串中的列的前缀
+   */
+  RC next(Chunk &chunk)
+  {
+    RC rc = RC::SUCCESS;
+    while (chunk.rows() < chunk.capacity()) {
+      const int winner = tree_.empty() ? -1 : tree_[0];
+      if (winner < 0 || sources_[winner]->exhausted) {
+        break;
+      }
+      Source &source = *sources_[winner];
+      for (int i = 0; i < chunk.column_num() && OB_SUCC(rc); i++) {
+        rc = copy_column_row(source.chunk.column(i), source.pos, chunk.column(i));
+      }
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to copy row. rc=%s", strrc(rc));
+        return rc;
+      }
+      if (++source.pos >= source.chunk.rows() && OB_FAIL(rc = advance(winner))) {
+        return rc;
+      }
+      adjust(winner);
+    }
+    return chunk.rows() == 0 ? RC::RECORD_EOF : RC::SUCCESS;
+  }
+
+private:
+  struct Source
+  {
+    unique_ptr<ChunkSpillFile> file;
+    Chunk                      chunk;
+    int                        pos       = 0;
+    bool                       exhausted = false;
+  };
+
+  /// 读取顺串的下一个 chunk
+  RC advance(int index)
+  {
+    Source &source = *sources_[index];
+    source.pos     = 0;
+    RC rc          = RC::SUCCESS;
+    do {
+      rc = source.file->read_chunk(source.chunk);
+    } while (OB_SUCC(rc) && source.chunk.rows() == 0);
+
+    if (rc == RC::RECORD_EOF) {
+      source.exhausted = true;
+      source.file.reset();
+      return RC::SUCCESS;
+    }
+    return rc;
+  }
+
+  /// 顺串 left 的当前行是否应该排在顺串 right 的当前行之前，已经读完的顺串排在最后
+  bool less(int left, int right) const
+  {
+    const Source &left_source  = *sources_[left];
+    const Source &right_source = *sources_[right];
+    if (left_source.exhausted || right_source.exhausted) {
+      return !left_source.exhausted;
+    }
+    int cmp = sorter_.compare_rows(left_source.chunk, left_source.pos, right_source.chunk, right_source.pos);
+    return cmp < 0 || (cmp == 0 && left < right);
+  }
+
+  /// 从叶子 index 开始向上调整
+  void adjust(int index)
+  {
+    const int k      = static_cast<int>(sources_.size());
+    int       winner = index;
+    for (int node = (index + k) / 2; node > 0; node /= 2) {
+      if (winner != -1 && (tree_[node] == -1 || less(tree_[node], winner))) {
+        std::swap(winner, tree_[node]);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+private:
+  const ExternalSorter       &sorter_;
+  vector<unique_ptr<Source>> sources_;
+  vector<int>                tree_;
+};
+
+ExternalSorter::ExternalSorter(const vector<bool> &ascs, size_t memory_limit)
+    : ascs_(ascs), memory_limit_(memory_limit)
+{}
+
+ExternalSorter::~ExternalSorter() = default;
+
+void ExternalSorter::init_layout(const Chunk &payload, const Chunk &keys)
+{
+  payload_num_ = payload.column_num();
+  for (int i = 0; i < payload.column_num(); i++) {
+    attr_types_.push_back(payload.column(i).attr_type());
+    attr_lens_.push_back(payload.column(i).attr_len());
+  }
+  // 规范化键只包含排序列的一个前缀：遇到不能编码的列或者 TEXTS 列（只编码了前缀）之后，
+  // 后面的列无法再按字节比较，只能在规范化键相同时使用完整的比较函数
+  bool truncated = false;
+  for (int i = 0; i < keys.column_num(); i++) {
+    const Column &column = keys.column(i);
+    attr_types_.push_back(column.attr_type());
+    attr_lens_.push_back(column.attr_len());
+
+    int width = 0;
+    if (truncated) {
+      key_widths_.push_back(0);
+      continue;
+    }
+    switch (column.attr_type()) {
+      case AttrType::INTS:
+      case AttrType::DATES:
+      case AttrType::FLOATS: width = 4; break;
+      case AttrType::BIGINTS: width = 8; break;
+      case AttrType::BOOLEANS: width = 1; break;
+      case AttrType::CHARS: width = column.attr_len(); break;
+      case AttrType::TEXTS: {
+        width     = TEXT_PREFIX_LENGTH;
+        truncated = true;
+      } break;
+      default: {
+        truncated = true;
+      } break;
+    }
+    key_widths_.push_back(width);
+    key_width_ += width;
+  }
+  need_tie_break_ = truncated;
+  normalized_     = key_width_ > 0;
+  layout_inited_  = true;
+}
+
+void ExternalSorter::create_block(Chunk &chunk, int capacity) const
+{
+  for (size_t i = 0; i < attr_types_.size(); i++) {
+    chunk.add_column(make_unique<Column>(attr_types_[i], attr_lens_[i], capacity), i);
+  }
+}
+
+RC ExternalSorter::add_chunk(const Chunk &payload, const Chunk &keys)
+{
+  const int rows = payload.rows();
+  if (rows == 0) {
+    return RC::SUCCESS;
+  }
+  if (keys.column_num() != static_cast<int>(ascs_.size())) {
+    LOG_WARN("keys chunk has %d columns, but there are %d order by keys", keys.column_num(), ascs_.size());
+    return RC::INVALID_ARGUMENT;
+  }
+  if (!layout_inited_) {
+    init_layout(payload, keys);
+  }
+
+  RC   rc    = RC::SUCCESS;
+  auto block = make_unique<Chunk>();
+  create_block(*block, rows);
+  for (int i = 0; i < payload.column_num() && OB_SUCC(rc); i++) {
+    rc = copy_column_rows(payload.column(i), rows, block->column(i));
+  }
+  for (int i = 0; i < keys.column_num() && OB_SUCC(rc); i++) {
+    rc = copy_column_rows(keys.column(i), rows, block->column(payload_num_ + i));
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to copy chunk. rc=%s", strrc(rc));
+    return rc;
+  }
+  memory_usage_ += chunk_memory_usage(*block);
+  blocks_.push_back(std::move(block));
+
+  if (memory_limit_ > 0 && memory_usage_ > memory_limit_) {
+    rc = spill();
+  }
+  return rc;
+}
+
+int ExternalSorter::compare_rows(const Chunk &left, int left_row, const Chunk &right, int right_row) const
+{
+  for (size_t i = 0; i < ascs_.size(); i++) {
+    const int col = payload_num_ + i;
+    const int cmp = compare_column_value(left.column(col), left_row, right.column(col), right_row);
+    if (cmp != 0) {
+      return ascs_[i] ? cmp : -cmp;
+    }
+  }
+  return 0;
+}
+
+void ExternalSorter::sort_in_memory()
+{
+  vector<RowRef> rows;
+  for (int b = 0; b < static_cast<int>(blocks_.size()); b++) {
+    for (int r = 0; r < blocks_[b]->rows(); r++) {
+      rows.push_back(RowRef{b, r});
+    }
+  }
+  output_pos_ = 0;
+
+  if (!normalized_) {
+    std::sort(rows.begin(), rows.end(), [this](const RowRef &left, const RowRef &right) {
+      return compare_rows(*blocks_[left.block], left.row, *blocks_[right.block], right.row) < 0;
+    });
+    sorted_rows_ = std::move(rows);
+    return;
+  }
+
+  encode_keys(rows);
+  vector<uint32_t> perm(rows.size());
+  vector<uint32_t> tmp(rows.size());
+  for (size_t i = 0; i < perm.size(); i++) {
+    perm[i] = static_cast<uint32_t>(i);
+  }
+  radix_sort(perm.data(), tmp.data(), perm.size(), rows);
+
+  sorted_rows_.resize(rows.size());
+  for (size_t i = 0; i < perm.size(); i++) {
+    sorted_rows_[i] = rows[perm[i]];
+  }
+  normalized_keys_.clear();
+}
+
+void ExternalSorter::encode_keys(const vector<RowRef> &rows)
+{
+  normalized_keys_.resize(rows.size() * key_width_);
+  size_t row_base = 0;
+  for (const auto &block : blocks_) {
+    const int rows_in_block = block->rows();
+    int       offset        = 0;
+    for (size_t k = 0; k < key_widths_.size(); k++) {
+      uint8_t  *dst   = normalized_keys_.data() + row_base * key_width_ + offset;
+      const int width = key_widths_[k];
+      if (width == 0) {
+        continue;
+      }
+      encode_normalized_key(block->column(payload_num_ + k), rows_in_block, dst, key_width_, width);
+      if (!ascs_[k]) {
+        // 降序的列按位取反
+        for (int i = 0; i < rows_in_block; i++) {
+          uint8_t *key = dst + static_cast<size_t>(i) * key_width_;
+          for (int j = 0; j < width; j++) {
+            key[j] = ~key[j];
+          }
+        }
+      }
+      offset += width;
+    }
+    row_base += rows_in_block;
+  }
+}
+
+void ExternalSorter::radix_sort(uint32_t *perm, uint32_t *tmp, size_t count, const vector<RowRef> &rows)
+{
+  // 数据量小于这个值时使用比较排序
+  static constexpr size_t COMPARE_SORT_THRESHOLD = 64;
+
+  struct Range
+  {
+    size_t begin;
+    size_t end;
+    int    depth;
+  };
+
+  const uint8_t *keys = normalized_keys_.data();
+  vector<Range>  ranges{{0, count, 0}};
+  while (!ranges.empty()) {
+    Range range = ranges.back();
+    ranges.pop_back();
+
+    // 所有行的当前字节都相同时，直接比较下一个字节
+    size_t counts[256];
+    bool   split = false;
+    while (range.end - range.begin > COMPARE_SORT_THRESHOLD && range.depth < key_width_) {
+      memset(counts, 0, sizeof(counts));
+      for (size_t i = range.begin; i < range.end; i++) {
+        counts[keys[static_cast<size_t>(perm[i]) * key_width_ + range.depth]]++;
+      }
+      const uint8_t first = keys[static_cast<size_t>(perm[range.begin]) * key_width_ + range.depth];
+      if (counts[first] != range.end - range.begin) {
+        split = true;
+        break;
+      }
+      range.depth++;
+    }
+
+    if (!split) {
+      if (range.end - range.begin > 1 && (range.depth < key_width_ || need_tie_break_)) {
+        compare_sort(perm, range.begin, range.end, range.depth, rows);
+      }
+      continue;
+    }
+
+    size_t offsets[256];
+    size_t offset = range.begin;
+    for (int b = 0; b < 256; b++) {
+      offsets[b] = offset;
+      offset += counts[b];
+    }
+    for (size_t i = range.begin; i < range.end; i++) {
+      const uint8_t byte = keys[static_cast<size_t>(perm[i]) * key_width_ + range.depth];
+      tmp[offsets[byte]++] = perm[i];
+    }
+    memcpy(perm + range.begin, tmp + range.begin, (range.end - range.begin) * sizeof(uint32_t));
+
+    size_t bucket_begin = range.begin;
+    for (int b = 0; b < 256; b++) {
+      if (counts[b] > 1) {
+        ranges.push_back(Range{bucket_begin, bucket_begin + counts[b], range.depth + 1});
+      }
+      bucket_begin += counts[b];
+    }
+  }
+}
+
+void ExternalSorter::compare_sort(uint32_t *perm, size_t begin, size_t end, int depth, const vector<RowRef> &rows)
+{
+  const uint8_t *keys = normalized_keys_.data();
+  const int      len  = key_width_ - depth;
+  std::sort(perm + begin, perm + end, [&](uint32_t left, uint32_t right) {
+    int cmp = memcmp(keys + static_cast<size_t>(left) * key_width_ + depth,
+        keys + static_cast<size_t>(right) * key_width_ + depth, len);
+    if (cmp != 0 || !need_tie_break_) {
+      return cmp < 0;
+    }
+    const RowRef &left_row  = rows[left];
+    const RowRef &right_row = rows[right];
+    return compare_rows(*blocks_[left_row.block], left_row.row, *blocks_[right_row.block], right_row.row) < 0;
+  });
+}
+
+RC ExternalSorter::gather(size_t &pos, Chunk &chunk) const
+{
+  const int count = static_cast<int>(std::min<size_t>(chunk.capacity() - chunk.rows(), sorted_rows_.size() - pos));
+  RC        rc    = RC::SUCCESS;
+  for (int c = 0; c < chunk.column_num() && OB_SUCC(rc); c++) {
+    Column &column = chunk.column(c);
+    for (int i = 0; i < count && OB_SUCC(rc); i++) {
+      const RowRef &ref = sorted_rows_[pos + i];
+      rc                = copy_column_row(blocks_[ref.block]->column(c), ref.row, column);
+    }
+  }
+  pos += count;
+  return rc;
+}
+
+RC ExternalSorter::spill()
+{
+  sort_in_memory();
+
+  auto run = make_unique<ChunkSpillFile>();
+  RC   rc  = run->open();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open spill file. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  Chunk chunk;
+  create_block(chunk, Column::DEFAULT_CAPACITY);
+  size_t pos = 0;
+  while (pos < sorted_rows_.size()) {
+    if (OB_FAIL(rc = gather(pos, chunk)) || OB_FAIL(rc = run->write_chunk(chunk))) {
+      LOG_WARN("failed to write sorted run. rc=%s", strrc(rc));
+      return rc;
+    }
+    chunk.reset_data();
+  }
+  LOG_INFO("sort buffer exceeds memory limit, spill a sorted run. rows=%ld, bytes=%ld", run->rows(), run->bytes());
+
+  runs_.push_back(std::move(run));
+  spilled_runs_++;
+  blocks_.clear();
+  sorted_rows_.clear();
+  memory_usage_ = 0;
+  return rc;
+}
+
+RC ExternalSorter::merge_runs(size_t begin, size_t end, unique_ptr<ChunkSpillFile> &run)
+{
+  vector<unique_ptr<ChunkSpillFile>> inputs(
+      std::make_move_iterator(runs_.begin() + begin), std::make_move_iterator(runs_.begin() + end));
+  runs_.erase(runs_.begin() + begin, runs_.begin() + end);
+
+  Merger merger(*this, std::move(inputs));
+  RC     rc = merger.init();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  run = make_unique<ChunkSpillFile>();
+  if (OB_FAIL(rc = run->open())) {
+    LOG_WARN("failed to open spill file. rc=%s", strrc(rc));
+    return rc;
+  }
+  Chunk chunk;
+  create_block(chunk, Column::DEFAULT_CAPACITY);
+  while (OB_SUCC(rc = merger.next(chunk))) {
+    if (OB_FAIL(rc = run->write_chunk(chunk))) {
+      LOG_WARN("failed to write merged run. rc=%s", strrc(rc));
+      return rc;
+    }
+    chunk.reset_data();
+  }
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
+RC ExternalSorter::finish()
+{
+  if (runs_.empty()) {
+    sort_in_memory();
+    return RC::SUCCESS;
+  }
+
+  RC rc = RC::SUCCESS;
+  if (!blocks_.empty() && OB_FAIL(rc = spill())) {
+    return rc;
+  }
+
+  while (runs_.size() > MAX_MERGE_WAYS) {
+    unique_ptr<ChunkSpillFile> run;
+    if (OB_FAIL(rc = merge_runs(0, MAX_MERGE_WAYS, run))) {
+      LOG_WARN("failed to merge sorted runs. rc=%s", strrc(rc));
+      return rc;
+    }
+    runs_.push_back(std::move(run));
+  }
+
+  merger_ = make_unique<Merger>(*this, std::move(runs_));
+  runs_.clear();
+  return merger_->init();
+}
+
+RC ExternalSorter::next(Chunk &chunk)
+{
+  if (merger_ != nullptr) {
+    return merger_->next(chunk);
+  }
+  if (output_pos_ >= sorted_rows_.size()) {
+    return RC::RECORD_EOF;
+  }
+  return gather(output_pos_, chunk);
+}
@@ -0,0 +1,134 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/memory.h"
+#include "common/lang/vector.h"
+#include "common/sys/rc.h"
+#include "storage/common/chunk.h"
+
+class ChunkSpillFile;
+
+/**
+ * @brief 外部排序，用于向量化的 ORDER BY
+ * @details 输入的每个 chunk 由两部分组成：需要输出的列(payload)与排序列(keys)，两部分的行数相同。
+ * 数据先拷贝到内存中，当占用的内存超过 memory_limit 时，对内存中的数据排序，
+ * 形成一个有序的顺串(run)写入临时文件。所有数据输入之后，使用败者树(loser tree)对所有顺串做多路归并。
+ * 顺串数量超过 MAX_MERGE_WAYS 时，先把前面的顺串归并成更长的顺串，限制归并时同时打开的文件与读缓冲的数量。
+ * 如果没有发生溢出，直接在内存中排序后输出。
+ *
+ * 内存中的排序使用规范化键(normalized key)：每一行的排序列被编码成定长的字节串，
+ * 字节串按 memcmp 比较的结果与按排序列比较的结果一致（降序的列按位取反）。
+ * 对字节串做 MSD 基数排序，排序的对象是行号组成的置换向量，payload 最后按置换向量整列拷贝。
+ * TEXTS 只编码固定长度的前缀，它之后的排序列不再编码，规范化键相同的行再使用完整的比较函数排序。
+ * 输出时每次最多填满调用者提供的 chunk，不会一次性构造所有结果。
+ */
+class ExternalSorter
+{
+public:
+  /**
+   * @param ascs 每个排序列是否为升序
+   * @param memory_limit 内存中缓存的数据的大小上限（字节），0 表示不限制
+   */
+  ExternalSorter(const vector<bool> &ascs, size_t memory_limit);
+  ~ExternalSorter();
+
+  /**
+   * @brief 添加数据，数据会被拷贝
+   */
+  RC add_chunk(const Chunk &payload, const Chunk &keys);
+
+  /**
+   * @brief 输入结束，开始排序
+   */
+  RC finish();
+
+  /**
+   * @brief 按顺序输出 payload 列，追加到 chunk 中直到 chunk 写满
+   * @details chunk 的列需要与输入的 payload 一致
+   * @return 没有数据时返回 RECORD_EOF
+   */
+  RC next(Chunk &chunk);
+
+  /// 溢出到磁盘的顺串个数（不包括归并产生的中间顺串）
+  int spilled_runs() const { return spilled_runs_; }
+
+  static constexpr int MAX_MERGE_WAYS = 64;
+
+  /// TEXTS 类型的排序列在规范化键中的前缀长度
+  static constexpr int TEXT_PREFIX_LENGTH = 16;
+
+private:
+  class Merger;
+
+  /// 内存中的一行：所在的块与在块中的行号
+  struct RowRef
+  {
+    int block;
+    int row;
+  };
+
+  void init_layout(const Chunk &payload, const Chunk &keys);
+
+  /// 按照排序列比较两行，两个 chunk 的结构都与内存块相同
+  int compare_rows(const Chunk &left, int left_row, const Chunk &right, int right_row) const;
+
+  /// 对内存中的数据排序，结果保存在 sorted_rows_ 中
+  void sort_in_memory();
+
+  /// 将内存中所有行的排序列编码成规范化键，写入 normalized_keys_
+  void encode_keys(const vector<RowRef> &rows);
+
+  /**
+   * @brief 按规范化键对行号 perm 做 MSD 基数排序
+   * @param tmp 与 perm 一样大的临时空间
+   */
+  void radix_sort(uint32_t *perm, uint32_t *tmp, size_t count, const vector<RowRef> &rows);
+
+  /// 数量较少或者键已经比较完时，使用比较排序
+  void compare_sort(uint32_t *perm, size_t begin, size_t end, int depth, const vector<RowRef> &rows);
+
+  /// 从 sorted_rows_ 的 pos 位置开始按顺序拷贝数据到 chunk 中，直到 chunk 写满
+  RC gather(size_t &pos, Chunk &chunk) const;
+
+  /// 将内存中的数据排序后写入一个新的顺串
+  RC spill();
+
+  /// 将 runs_ 中 [begin, end) 的顺串归并成一个新的顺串
+  RC merge_runs(size_t begin, size_t end, unique_ptr<ChunkSpillFile> &run);
+
+  /// 创建一个与内存块结构相同的空 chunk
+  void create_block(Chunk &chunk, int capacity) const;
+
+private:
+  vector<bool> ascs_;
+  size_t       memory_limit_;
+
+  bool             layout_inited_ = false;
+  int              payload_num_   = 0;
+  vector<AttrType> attr_types_;  ///< 内存块中的列，前 payload_num_ 列是 payload，之后是排序列
+  vector<int>      attr_lens_;
+
+  bool            normalized_     = false;  ///< 是否使用规范化键排序
+  bool            need_tie_break_ = false;  ///< 规范化键相同时是否需要再比较完整的值
+  vector<int>     key_widths_;              ///< 每个排序列编码后的长度
+  int             key_width_ = 0;           ///< 规范化键的长度
+  vector<uint8_t> normalized_keys_;
+
+  vector<unique_ptr<Chunk>> blocks_;  ///< 内存中缓存的数据
+  size_t                    memory_usage_ = 0;
+  vector<RowRef>            sorted_rows_;
+  size_t                    output_pos_ = 0;
+
+  vector<unique_ptr<ChunkSpillFile>> runs_;
+  unique_ptr<Merger>                 merger_;
+  int                                spilled_runs_ = 0;
+};
@@ -0,0 +1,297 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/common/top_n_sorter.h"
+#include "common/lang/algorithm.h"
+#include "common/log/log.h"
+#include "common/math/simd_util.h"
+#include "storage/common/column_util.h"
+
+namespace {
+
+/**
+ * @brief 将 values 中不比 threshold 差的行号写入 selected，返回行数
+ * @details 升序时保留 value <= threshold 的行，降序时保留 value >= threshold 的行。
+ * 与阈值相等的行需要再比较后面的排序列。循环中没有分支，每一行都写入 selected，只是根据比较结果决定是否前进
+ */
+template <typename T>
+int select_candidates(const T *values, int rows, T threshold, bool asc, int *selected)
+{
+  int count = 0;
+  if (asc) {
+    for (int i = 0; i < rows; i++) {
+      selected[count] = i;
+      count += values[i] <= threshold;
+    }
+  } else {
+    for (int i = 0; i < rows; i++) {
+      selected[count] = i;
+      count += values[i] >= threshold;
+    }
+  }
+  return count;
+}
+
+#ifdef USE_SIMD
+template <>
+int select_candidates<int>(const int *values, int rows, int threshold, bool asc, int *selected)
+{
+  int           count = 0;
+  int           i     = 0;
+  const __m256i thr   = _mm256_set1_epi32(threshold);
+  for (; i + SIMD_WIDTH <= rows; i += SIMD_WIDTH) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+    // 升序时 value > threshold 的行被过滤掉，降序时 value < threshold 的行被过滤掉
+    __m256i  rejected = asc ? _mm256_cmpgt_epi32(v, thr) : _mm256_cmpgt_epi32(thr, v);
+    unsigned mask     = ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(rejected))) & 0xff;
+    while (mask != 0) {
+      selected[count++] = i + __builtin_ctz(mask);
+      mask &= mask - 1;
+    }
+  }
+  for (; i < rows; i++) {
+    selected[count] = i;
+    count += asc ? values[i] <= threshold : values[i] >= threshold;
+  }
+  return count;
+}
+#endif
+
+}  // namespace
+
+TopNSorter::TopNSorter(const vector<bool> &ascs, int limit) : ascs_(ascs), limit_(limit) {}
+
+TopNSorter::~TopNSorter() = default;
+
+void TopNSorter::init_layout(const Chunk &payload, const Chunk &keys)
+{
+  payload_num_ = payload.column_num();
+  for (int i = 0; i < payload.column_num(); i++) {
+    attr_types_.push_back(payload.column(i).attr_type());
+    attr_lens_.push_back(payload.column(i).attr_len());
+  }
+  for (int i = 0; i < keys.column_num(); i++) {
+    attr_types_.push_back(keys.column(i).attr_type());
+    attr_lens_.push_back(keys.column(i).attr_len());
+  }
+  layout_inited_ = true;
+}
+
+void TopNSorter::create_block()
+{
+  auto block = make_unique<Chunk>();
+  for (size_t i = 0; i < attr_types_.size(); i++) {
+    block->add_column(make_unique<Column>(attr_types_[i], attr_lens_[i], BLOCK_ROWS), i);
+  }
+  blocks_.push_back(std::move(block));
+}
+
+Column &TopNSorter::block_column(int id, int col, int &row) const
+{
+  row = id % BLOCK_ROWS;
+  return blocks_[id / BLOCK_ROWS]->column(col);
+}
+
+int TopNSorter::compare_input(const Chunk &keys, int row, int id) const
+{
+  for (size_t i = 0; i < ascs_.size(); i++) {
+    int           block_row = 0;
+    const Column &column    = block_column(id, payload_num_ + i, block_row);
+    const int     cmp       = compare_column_value(keys.column(i), row, column, block_row);
+    if (cmp != 0) {
+      return ascs_[i] ? cmp : -cmp;
+    }
+  }
+  return 0;
+}
+
+int TopNSorter::compare_rows(int left_id, int right_id) const
+{
+  for (size_t i = 0; i < ascs_.size(); i++) {
+    int           left_row = 0, right_row = 0;
+    const Column &left     = block_column(left_id, payload_num_ + i, left_row);
+    const Column &right    = block_column(right_id, payload_num_ + i, right_row);
+    const int     cmp      = compare_column_value(left, left_row, right, right_row);
+    if (cmp != 0) {
+      return ascs_[i] ? cmp : -cmp;
+    }
+  }
+  return 0;
+}
+
+RC TopNSorter::append_row(const Chunk &payload, const Chunk &keys, int row, int &id)
+{
+  if (row_count_ % BLOCK_ROWS == 0) {
+    create_block();
+  }
+  Chunk &block = *blocks_.back();
+  RC     rc    = RC::SUCCESS;
+  for (int i = 0; i < payload_num_ && OB_SUCC(rc); i++) {
+    rc = copy_column_row(payload.column(i), row, block.column(i));
+  }
+  for (int i = 0; i < keys.column_num() && OB_SUCC(rc); i++) {
+    rc = copy_column_row(keys.column(i), row, block.column(payload_num_ + i));
+  }
+  id = row_count_++;
+  return rc;
+}
+
+void TopNSorter::filter(const Column &first_key, int rows)
+{
+  selected_.resize(rows);
+  int           threshold_row = 0;
+  const Column &threshold     = block_column(heap_.front(), payload_num_, threshold_row);
+  const char   *threshold_ptr = threshold.data() + static_cast<size_t>(threshold_row) * threshold.attr_len();
+  const bool    asc           = ascs_[0];
+
+  int count = 0;
+  if (first_key.column_type() == Column::Type::CONSTANT_COLUMN) {
+    for (int i = 0; i < rows; i++) {
+      selected_[count++] = i;
+    }
+  } else {
+    switch (first_key.attr_type()) {
+      case AttrType::INTS:
+      case AttrType::DATES: {
+        count = select_candidates(reinterpret_cast<const int *>(first_key.data()),
+            rows,
+            *reinterpret_cast<const int *>(threshold_ptr),
+            asc,
+            selected_.data());
+      } break;
+      case AttrType::BIGINTS: {
+        count = select_candidates(reinterpret_cast<const int64_t *>(first_key.data()),
+            rows,
+            *reinterpret_cast<const int64_t *>(threshold_ptr),
+            asc,
+            selected_.data());
+      } break;
+      case AttrType::FLOATS: {
+        count = select_candidates(reinterpret_cast<const float *>(first_key.data()),
+            rows,
+            *reinterpret_cast<const float *>(threshold_ptr),
+            asc,
+            selected_.data());
+      } break;
+      default: {
+        for (int i = 0; i < rows; i++) {
+          const int cmp    = compare_column_value(first_key, i, threshold, threshold_row);
+          selected_[count] = i;
+          count += asc ? cmp <= 0 : cmp >= 0;
+        }
+      } break;
+    }
+  }
+  selected_.resize(count);
+  filtered_rows_ += rows - count;
+}
+
+RC TopNSorter::add_chunk(const Chunk &payload, const Chunk &keys)
+{
+  const int rows = payload.rows();
+  if (rows == 0 || limit_ <= 0) {
+    return RC::SUCCESS;
+  }
+  if (keys.column_num() != static_cast<int>(ascs_.size())) {
+    LOG_WARN("keys chunk has %d columns, but there are %d order by keys", keys.column_num(), ascs_.size());
+    return RC::INVALID_ARGUMENT;
+  }
+  if (!layout_inited_) {
+    init_layout(payload, keys);
+  }
+
+  if (static_cast<int>(heap_.size()) >= limit_) {
+    filter(keys.column(0), rows);
+  } else {
+    selected_.resize(rows);
+    for (int i = 0; i < rows; i++) {
+      selected_[i] = i;
+    }
+  }
+
+  auto cmp = [this](int left, int right) { return compare_rows(left, right) < 0; };
+  RC   rc  = RC::SUCCESS;
+  for (int row : selected_) {
+    int id = -1;
+    if (static_cast<int>(heap_.size()) < limit_) {
+      if (OB_FAIL(rc = append_row(payload, keys, row, id))) {
+        break;
+      }
+      heap_.push_back(id);
+      std::push_heap(heap_.begin(), heap_.end(), cmp);
+    } else if (compare_input(keys, row, heap_.front()) < 0) {
+      if (OB_FAIL(rc = append_row(payload, keys, row, id))) {
+        break;
+      }
+      std::pop_heap(heap_.begin(), heap_.end(), cmp);
+      heap_.back() = id;
+      std::push_heap(heap_.begin(), heap_.end(), cmp);
+    }
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to copy row. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (row_count_ > 2 * limit_ + BLOCK_ROWS) {
+    rc = compact();
+  }
+  return rc;
+}
+
+RC TopNSorter::compact()
+{
+  vector<unique_ptr<Chunk>> old_blocks = std::move(blocks_);
+  blocks_.clear();
+  row_count_ = 0;
+
+  RC rc = RC::SUCCESS;
+  for (int &id : heap_) {
+    if (row_count_ % BLOCK_ROWS == 0) {
+      create_block();
+    }
+    Chunk &old_block = *old_blocks[id / BLOCK_ROWS];
+    Chunk &block     = *blocks_.back();
+    for (int c = 0; c < block.column_num() && OB_SUCC(rc); c++) {
+      rc = copy_column_row(old_block.column(c), id % BLOCK_ROWS, block.column(c));
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to copy row. rc=%s", strrc(rc));
+      return rc;
+    }
+    id = row_count_++;
+  }
+  return rc;
+}
+
+RC TopNSorter::finish()
+{
+  std::sort_heap(heap_.begin(), heap_.end(), [this](int left, int right) { return compare_rows(left, right) < 0; });
+  output_pos_ = 0;
+  return RC::SUCCESS;
+}
+
+RC TopNSorter::next(Chunk &chunk)
+{
+  if (output_pos_ >= heap_.size()) {
+    return RC::RECORD_EOF;
+  }
+  const int count = static_cast<int>(std::min<size_t>(chunk.capacity() - chunk.rows(), heap_.size() - output_pos_));
+  RC        rc    = RC::SUCCESS;
+  for (int c = 0; c < chunk.column_num() && OB_SUCC(rc); c++) {
+    for (int i = 0; i < count && OB_SUCC(rc); i++) {
+      int           row    = 0;
+      const Column &column = block_column(heap_[output_pos_ + i], c, row);
+      rc                   = copy_column_row(column, row, chunk.column(c));
+    }
+  }
+  output_pos_ += count;
+  return rc;
+}
@@ -0,0 +1,90 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/memory.h"
+#include "common/lang/vector.h"
+#include "common/sys/rc.h"
+#include "storage/common/chunk.h"
+
+/**
+ * @brief 列式的 Top-N 排序，用于 ORDER BY ... LIMIT n
+ * @details 与 ExternalSorter 一样，输入由 payload 与排序列两部分组成。
+ * 候选行按列拷贝到若干个内存块中，使用一个大小为 n 的堆（堆顶是当前第 n 名）维护前 n 行。
+ * 堆满之后，堆顶的第一个排序列就是一个阈值：处理新的 chunk 时先对第一个排序列整列与阈值比较，
+ * 一次过滤掉所有不可能进入前 n 名的行，只有剩下的行才会与堆顶逐行比较并拷贝到内存块中。
+ * 被淘汰的行占用的空间在候选行数量超过 2n 时统一回收。
+ */
+class TopNSorter
+{
+public:
+  TopNSorter(const vector<bool> &ascs, int limit);
+  ~TopNSorter();
+
+  RC add_chunk(const Chunk &payload, const Chunk &keys);
+
+  /**
+   * @brief 输入结束，对前 n 行排序
+   */
+  RC finish();
+
+  /**
+   * @brief 按顺序输出 payload 列，追加到 chunk 中直到 chunk 写满
+   * @return 没有数据时返回 RECORD_EOF
+   */
+  RC next(Chunk &chunk);
+
+  /// 被阈值过滤掉、没有逐行比较的行数
+  int64_t filtered_rows() const { return filtered_rows_; }
+
+private:
+  void init_layout(const Chunk &payload, const Chunk &keys);
+
+  /**
+   * @brief 使用堆顶的第一个排序列过滤 keys 中的行，可能进入前 n 名的行号写入 selected_
+   */
+  void filter(const Column &first_key, int rows);
+
+  /// 比较输入的一行与内存块中的一行
+  int compare_input(const Chunk &keys, int row, int id) const;
+
+  /// 比较内存块中的两行
+  int compare_rows(int left_id, int right_id) const;
+
+  /// 将输入的一行拷贝到内存块中，返回它的编号
+  RC append_row(const Chunk &payload, const Chunk &keys, int row, int &id);
+
+  /// 只保留堆中的行，回收其它行占用的内存
+  RC compact();
+
+  Column &block_column(int id, int col, int &row) const;
+
+  void create_block();
+
+private:
+  static constexpr int BLOCK_ROWS = 1024;
+
+  vector<bool> ascs_;
+  int          limit_;
+
+  bool             layout_inited_ = false;
+  int              payload_num_   = 0;
+  vector<AttrType> attr_types_;
+  vector<int>      attr_lens_;
+
+  vector<unique_ptr<Chunk>> blocks_;             ///< 候选行，前 payload_num_ 列是 payload，之后是排序列
+  int                       row_count_ = 0;      ///< 内存块中的行数，第 i 行位于 blocks_[i / BLOCK_ROWS]
+  vector<int>               heap_;               ///< 前 n 行的编号，堆顶是排在最后的一行
+  vector<int>               selected_;           ///< filter 的结果
+  int64_t                   filtered_rows_ = 0;
+
+  size_t output_pos_ = 0;
+};
@@ -158,20 +158,15 @@ RC PersistHandler::write_at(uint64_t offset, int size, const char *data, int64_t
     LOG_ERROR("Failed to write, because file is not opened.");
     rc = RC::FILE_NOT_OPENED;
   } else {
-    if (lseek(file_desc_, offset, SEEK_SET) == off_t(-1)) {
-      LOG_ERROR("Failed to write %lld of %d:%s due to failed to seek %s.",
-          offset, file_desc_, file_name_.c_str(), strerror(errno));
-      rc = RC::IOERR_SEEK;
-    } else {
-      int64_t write_size = 0;
-      if ((write_size = write(file_desc_, data, size)) != size) {
-        LOG_ERROR("Failed to write %llu of %d:%s due to %s. Write size: %lld",
-            offset, file_desc_, file_name_.c_str(), strerror(errno), write_size);
-        rc = RC::IOERR_WRITE;
-      }
-      if (out_size != nullptr) {
-        *out_size = write_size;
-      }
+    // pwrite 不移动文件描述符的位置，多个线程同时读写不同位置时互不影响
+    int64_t write_size = 0;
+    if ((write_size = pwrite(file_desc_, data, size, offset)) != size) {
+      LOG_ERROR("Failed to write %llu of %d:%s due to %s. Write size: %lld",
+          offset, file_desc_, file_name_.c_str(), strerror(errno), write_size);
+      rc = RC::IOERR_WRITE;
+    }
+    if (out_size != nullptr) {
+      *out_size = write_size;
     }
   }
 
@@ -245,21 +240,16 @@ RC PersistHandler::read_at(uint64_t offset, int size, char *data, int64_t *out_s
     LOG_ERROR("Failed to read, because file is not opened.");
     rc = RC::FILE_NOT_OPENED;
   } else {
-    if (lseek(file_desc_, offset, SEEK_SET) == off_t(-1)) {
-      LOG_ERROR("Failed to read %llu of %d:%s due to failed to seek %s.",
-          offset, file_desc_, file_name_.c_str(), strerror(errno));
-      return RC::IOERR_SEEK;
-    } else {
-      ssize_t read_size = read(file_desc_, data, size);
-      if (read_size == 0) {
-        LOG_TRACE("read file touch the end. file name=%s", file_name_.c_str());
-      } else if (read_size < 0) {
-        LOG_WARN("failed to read file. file name=%s, offset=%lld, size=%d, error=%s",
-          file_name_.c_str(), offset, size, strerror(errno));
-        rc = RC::IOERR_READ;
-      } else if (out_size != nullptr) {
-        *out_size = read_size;
-      }
+    // 并行扫描时多个线程会同时读取 LOB 文件，使用 pread 避免共享文件描述符的位置
+    ssize_t read_size = pread(file_desc_, data, size, offset);
+    if (read_size == 0) {
+      LOG_TRACE("read file touch the end. file name=%s", file_name_.c_str());
+    } else if (read_size < 0) {
+      LOG_WARN("failed to read file. file name=%s, offset=%lld, size=%d, error=%s",
+        file_name_.c_str(), offset, size, strerror(errno));
+      rc = RC::IOERR_READ;
+    } else if (out_size != nullptr) {
+      *out_size = read_size;
     }
   }
 
@@ -45,7 +45,7 @@ public:
   /** 在当前文件描述符的位置写入一段数据，并返回实际写入的数据大小out_size */
   RC write_file(int size, const char *data, int64_t *out_size = nullptr);
 
-  /** 在指定位置写入一段数据，并返回实际写入的数据大小out_size */
+  /** 在指定位置写入一段数据，并返回实际写入的数据大小out_size。不改变文件描述符的位置 */
   RC write_at(uint64_t offset, int size, const char *data, int64_t *out_size = nullptr);
 
   /** 在文件末尾写入一段数据，并返回实际写入的数据大小out_size */
@@ -54,7 +54,7 @@ public:
   /** 在当前文件描述符的位置读取一段数据，并返回实际读取的数据大小out_size */
   RC read_file(int size, char *data, int64_t *out_size = nullptr);
 
-  /** 在指定位置读取一段数据，并返回实际读取的数据大小out_size */
+  /** 在指定位置读取一段数据，并返回实际读取的数据大小out_size。不改变文件描述符的位置，可以并发调用 */
   RC read_at(uint64_t offset, int size, char *data, int64_t *out_size = nullptr);
 
   /** 将文件描述符移动到指定位置 */
@@ -0,0 +1,92 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/record/morsel_scheduler.h"
+#include "common/lang/algorithm.h"
+#include "common/lang/cmath.h"
+#include "common/lang/random.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+RC MorselScheduler::open(DiskBufferPool &buffer_pool)
+{
+  lock_guard<mutex> guard(open_lock_);
+  if (opened_) {
+    return RC::SUCCESS;
+  }
+
+  // 页面的分配信息在文件头页面中，遍历时也要避免与其它线程读取页面冲突
+  lock_guard<mutex> bp_guard(buffer_pool_lock_);
+  BufferPoolIterator bp_iterator;
+  RC                 rc = bp_iterator.init(buffer_pool, 1);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init bp iterator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  pages_.clear();
+  while (bp_iterator.has_next()) {
+    pages_.push_back(bp_iterator.next());
+  }
+  total_pages_ = page_num();
+  sample_pages();
+  next_page_.store(0);
+  opened_ = true;
+  LOG_TRACE("morsel scheduler opened. pages=%d, total pages=%d", page_num(), total_pages_);
+  return RC::SUCCESS;
+}
+
+void MorselScheduler::set_sample(double percent, int max_pages, uint64_t seed)
+{
+  sample_percent_   = percent;
+  sample_max_pages_ = max_pages;
+  sample_seed_      = seed;
+}
+
+void MorselScheduler::sample_pages()
+{
+  const int total  = page_num();
+  int       target = static_cast<int>(ceil(total * sample_percent_ / 100));
+  if (sample_max_pages_ > 0) {
+    target = std::min(target, sample_max_pages_);
+  }
+  target = std::clamp(target, std::min(total, 1), total);
+  if (target == total) {
+    return;
+  }
+
+  // 部分 Fisher-Yates 洗牌，前 target 个页面就是均匀选出的样本
+  mt19937_64 random(sample_seed_);
+  for (int i = 0; i < target; i++) {
+    uniform_int_distribution<int> dist(i, total - 1);
+    std::swap(pages_[i], pages_[dist(random)]);
+  }
+  pages_.resize(target);
+  sort(pages_.begin(), pages_.end());
+}
+
+void MorselScheduler::reset()
+{
+  opened_ = false;
+  pages_.clear();
+  next_page_.store(0);
+}
+
+bool MorselScheduler::next_morsel(vector<PageNum> &pages)
+{
+  pages.clear();
+  const int begin = next_page_.fetch_add(MORSEL_PAGES);
+  if (begin >= page_num()) {
+    return false;
+  }
+  const int end = std::min(begin + MORSEL_PAGES, page_num());
+  pages.assign(pages_.begin() + begin, pages_.begin() + end);
+  return true;
+}
@@ -0,0 +1,89 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "common/lang/atomic.h"
+#include "common/lang/mutex.h"
+#include "common/lang/vector.h"
+#include "common/sys/rc.h"
+#include "storage/buffer/page.h"
+
+class DiskBufferPool;
+
+/**
+ * @brief 并行扫描时在多个线程之间分配页面
+ * @ingroup RecordManager
+ * @details 表中所有的数据页面按顺序切成若干个 morsel（连续的 MORSEL_PAGES 个页面），每个扫描线程处理完手上的
+ * morsel 之后再来取下一个，处理得快的线程自然会多处理一些，不需要事先按线程数平均划分。
+ *
+ * 不开启 CONCURRENCY 编译选项时 buffer pool 内部不加锁，因此多个线程读取、释放页面时都要持有 buffer_pool_lock，
+ * 只有解码、过滤、计算表达式这些不访问 buffer pool 的工作是并行的。
+ */
+class MorselScheduler
+{
+public:
+  static constexpr int MORSEL_PAGES = 16;
+
+  MorselScheduler() = default;
+
+  MorselScheduler(const MorselScheduler &)            = delete;
+  MorselScheduler &operator=(const MorselScheduler &) = delete;
+
+  /**
+   * @brief 收集需要扫描的页面。多个扫描线程都会调用，只有第一次调用会收集页面
+   */
+  RC open(DiskBufferPool &buffer_pool);
+
+  /**
+   * @brief 只扫描一部分页面（block sampling），用于 ANALYZE TABLE 收集统计信息
+   * @param percent   扫描页面的百分比，(0, 100]
+   * @param max_pages 最多扫描的页面数
+   * @param seed      随机数种子，相同的种子选中相同的页面
+   * @details 需要在 open 之前调用。选中的页面仍然按页号升序排列，保持顺序读取
+   */
+  void set_sample(double percent, int max_pages, uint64_t seed);
+
+  /**
+   * @brief 重新开始分配页面，下一次 open 时重新收集页面
+   * @note 不能与 open/next_morsel 并发调用
+   */
+  void reset();
+
+  /**
+   * @brief 获取下一个 morsel
+   * @param[out] pages morsel 中的页面
+   * @return 页面已经分配完时返回 false
+   */
+  bool next_morsel(vector<PageNum> &pages);
+
+  mutex &buffer_pool_lock() { return buffer_pool_lock_; }
+
+  int page_num() const { return static_cast<int>(pages_.size()); }
+
+  /// 表中所有的页面数，没有采样时与 page_num 相同
+  int total_page_num() const { return total_pages_; }
+
+private:
+  /// 按 set_sample 的设置从收集到的页面中选出样本
+  void sample_pages();
+
+private:
+  mutex           open_lock_;
+  bool            opened_ = false;
+  vector<PageNum> pages_;
+  int             total_pages_ = 0;
+
+  double   sample_percent_   = 100;
+  int      sample_max_pages_ = 0;  ///< 0 表示不限制
+  uint64_t sample_seed_      = 0;
+  atomic<int>     next_page_{0};
+  mutex           buffer_pool_lock_;
+};
@@ -20,13 +20,17 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/column.h"
 #include "storage/common/condition_filter.h"
 #include "storage/record/lob_handler.h"
+#include "storage/record/morsel_scheduler.h"
 #include "storage/trx/trx.h"
 #include "storage/clog/log_handler.h"
+#include <algorithm>
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
+#include <unistd.h>
 
 using namespace common;
 
@@ -422,6 +426,38 @@ RC RowRecordPageHandler::get_record(const RID &rid, Record &record)
   return RC::SUCCESS;
 }
 
+RC RowRecordPageHandler::get_columns(Chunk &chunk, const vector<int> &columns, const int *rows, int row_num)
+{
+  if (field_offsets_ == nullptr) {
+    LOG_WARN("field offsets are required to read columns from a row page");
+    return RC::UNIMPLEMENTED;
+  }
+
+  if (rows == nullptr) {
+    row_num = page_header_->record_num;
+  }
+  slots_.resize(row_num);
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  for (int i = 0, k = 0, index = 0; k < row_num; ++i, ++index) {
+    index = bitmap.next_setted_bit(index);
+    if (rows == nullptr || rows[k] == i) {
+      slots_[k++] = index;
+    }
+  }
+
+  for (int j : columns) {
+    const int offset = (*field_offsets_)[chunk.column_ids(j)];
+    Column   &column = chunk.column(j);
+    for (int i = 0; i < row_num; ++i) {
+      RC rc = column.append_one(get_record_data(slots_[i]) + offset);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
+
 PageNum RecordPageHandler::get_page_num() const
 {
   if (nullptr == page_header_) {
@@ -592,40 +628,64 @@ RC PaxRecordPageHandler::get_record(const RID &rid, Record &record)
   return RC::SUCCESS;
 }
 
-// TODO: specify the column_ids that chunk needed. currenly we get all columns
 RC PaxRecordPageHandler::get_chunk(Chunk &chunk)
 {
+  // reset_data 会同时清空各列的 NULL 掩码。字段目前都不可为 NULL，页中也没有 NULL 标记，
+  // 所以读出的列都没有掩码，上层算子直接走不检查 NULL 的路径
   chunk.reset_data();
-  RC     rc = RC::SUCCESS;
-  Bitmap bitmap(bitmap_, page_header_->record_capacity);
-  bool   fulfilled = page_header_->record_num == page_header_->record_capacity;
+  vector<int> columns(chunk.column_num());
   for (int j = 0; j < chunk.column_num(); ++j) {
+    columns[j] = j;
+  }
+  return get_columns(chunk, columns, nullptr, 0);
+}
+
+RC PaxRecordPageHandler::get_columns(Chunk &chunk, const vector<int> &columns, const int *rows, int row_num)
+{
+  const int record_num = page_header_->record_num;
+  const bool fulfilled = record_num == page_header_->record_capacity;
+  if (rows == nullptr) {
+    row_num = record_num;
+  }
+
+  // 页面写满并且读取所有行时可以整列拷贝，否则先把行的序号换算成槽位
+  const int *slots = rows;
+  if (!fulfilled) {
+    slots_.resize(row_num);
+    Bitmap bitmap(bitmap_, page_header_->record_capacity);
+    for (int i = 0, k = 0, index = 0; k < row_num; ++i, ++index) {
+      index = bitmap.next_setted_bit(index);
+      if (rows == nullptr || rows[k] == i) {
+        slots_[k++] = index;
+      }
+    }
+    slots = slots_.data();
+  }
+
+  for (int j : columns) {
     const int col_id = chunk.column_ids(j);
     Column   &column = chunk.column(j);
-    if (!fulfilled || chunk.column(j).attr_type() == AttrType::TEXTS) {
-      for (int i = 0, index = 0; i < page_header_->record_num; ++i, ++index) {
-        index = bitmap.next_setted_bit(index);
-        if (chunk.column(j).attr_type() == AttrType::TEXTS) {
-          string_t str = *(string_t *)get_field_data(index, j);
-          if (!str.is_inlined()) {
-            int64_t offset = str.get_offset();
-            str            = chunk.column(j).get_vector_buffer()->empty_string(str.size());
-            GlobalLobFileHandler::get().get_data(offset, str.size(), str.get_noinline_ptr());
-          }
-          rc = column.append_one((char *)&str);
-        } else {
-          rc = column.append_one(get_field_data(index, col_id));
-        }
-        if (OB_FAIL(rc)) {
-          return rc;
+    RC        rc     = RC::SUCCESS;
+    if (column.attr_type() == AttrType::TEXTS) {
+      for (int i = 0; i < row_num && OB_SUCC(rc); ++i) {
+        string_t str = *(string_t *)get_field_data(slots == nullptr ? i : slots[i], col_id);
+        if (!str.is_inlined()) {
+          int64_t offset = str.get_offset();
+          str            = column.get_vector_buffer()->empty_string(str.size());
+          GlobalLobFileHandler::get().get_data(offset, str.size(), str.get_noinline_ptr());
         }
+        rc = column.append_one((char *)&str);
       }
+    } else if (slots == nullptr) {
+      rc = column.append(get_field_data(0, col_id), row_num);
     } else {
-      RC rc = column.append(get_field_data(0, col_id), page_header_->record_num);
-      if (OB_FAIL(rc)) {
-        return rc;
+      for (int i = 0; i < row_num && OB_SUCC(rc); ++i) {
+        rc = column.append_one(get_field_data(slots[i], col_id));
       }
     }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
   }
   return RC::SUCCESS;
 }
@@ -922,15 +982,20 @@ ChunkFileScanner::~ChunkFileScanner() { close_scan(); }
 
 RC ChunkFileScanner::close_scan()
 {
-  if (disk_buffer_pool_ != nullptr) {
-    disk_buffer_pool_ = nullptr;
-  }
-
-  if (record_page_handler_ != nullptr) {
-    record_page_handler_->cleanup();
-    delete record_page_handler_;
-    record_page_handler_ = nullptr;
+  for (unique_ptr<RecordPageHandler> &page_handler : page_handlers_) {
+    cleanup_page(*page_handler);
   }
+  page_handlers_.clear();
+  bypass_pages_.clear();
+  bypass_cache_ = false;
+  disk_buffer_pool_ = nullptr;
+  page_num_     = 0;
+  pending_page_ = false;
+  eager_set_    = false;
+  eager_columns_.clear();
+  morsel_scheduler_ = nullptr;
+  morsel_pages_.clear();
+  morsel_pos_ = 0;
 
   return RC::SUCCESS;
 }
@@ -945,43 +1010,219 @@ RC ChunkFileScanner::open_scan_chunk(
   log_handler_      = &log_handler;
   rw_mode_          = mode;
 
+  field_offsets_.clear();
+  if (table != nullptr && table->table_meta().storage_format() == StorageFormat::ROW_FORMAT) {
+    const TableMeta &table_meta = table->table_meta();
+    field_offsets_.resize(table_meta.field_num());
+    for (int i = 0; i < table_meta.field_num(); i++) {
+      field_offsets_[table_meta.field(i)->field_id()] = table_meta.field(i)->offset();
+    }
+  }
+
   RC rc = bp_iterator_.init(buffer_pool, 1);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
-  if (table == nullptr || table->table_meta().storage_format() == StorageFormat::ROW_FORMAT) {
-    record_page_handler_ = new RowRecordPageHandler();
-  } else {
-    record_page_handler_ = new PaxRecordPageHandler();
+  return rc;
+}
+
+void ChunkFileScanner::set_eager_columns(vector<int> columns)
+{
+  eager_columns_ = std::move(columns);
+  eager_set_     = true;
+}
+
+RC ChunkFileScanner::set_morsel_scheduler(MorselScheduler *scheduler)
+{
+  morsel_scheduler_ = scheduler;
+  morsel_pages_.clear();
+  morsel_pos_ = 0;
+  if (scheduler == nullptr) {
+    return RC::SUCCESS;
   }
+  return scheduler->open(*disk_buffer_pool_);
+}
 
-  return rc;
+bool ChunkFileScanner::next_page(PageNum &page_num)
+{
+  if (morsel_scheduler_ == nullptr) {
+    if (!bp_iterator_.has_next()) {
+      return false;
+    }
+    page_num = bp_iterator_.next();
+    return true;
+  }
+
+  if (morsel_pos_ >= static_cast<int>(morsel_pages_.size())) {
+    morsel_pos_ = 0;
+    if (!morsel_scheduler_->next_morsel(morsel_pages_)) {
+      return false;
+    }
+  }
+  page_num = morsel_pages_[morsel_pos_++];
+  return true;
 }
 
-RC ChunkFileScanner::next_chunk(Chunk &chunk)
+RC ChunkFileScanner::init_page(RecordPageHandler &page_handler, PageNum page_num)
 {
-  RC rc = RC::SUCCESS;
+  unique_lock<mutex> guard;
+  if (morsel_scheduler_ != nullptr) {
+    guard = unique_lock<mutex>(morsel_scheduler_->buffer_pool_lock());
+  }
+  if (bypass_cache_ && !disk_buffer_pool_->is_page_cached(page_num)) {
+    bypass_pages_[&page_handler] = page_num;
+  }
+  return page_handler.init(*disk_buffer_pool_, *log_handler_, page_num, rw_mode_, table_->lob_handler());
+}
+
+void ChunkFileScanner::cleanup_page(RecordPageHandler &page_handler)
+{
+  unique_lock<mutex> guard;
+  if (morsel_scheduler_ != nullptr) {
+    guard = unique_lock<mutex>(morsel_scheduler_->buffer_pool_lock());
+  }
+  page_handler.cleanup();
 
-  while (bp_iterator_.has_next()) {
-    PageNum page_num = bp_iterator_.next();
-    record_page_handler_->cleanup();
-    rc = record_page_handler_->init(*disk_buffer_pool_, *log_handler_, page_num, rw_mode_, table_->lob_handler());
+  auto iter = bypass_pages_.find(&page_handler);
+  if (iter != bypass_pages_.end()) {
+    RC rc = disk_buffer_pool_->evict_page(iter->second);
     if (OB_FAIL(rc)) {
-      LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
-      return rc;
+      LOG_TRACE("failed to evict page %d. rc=%s", iter->second, strrc(rc));
     }
-    rc = record_page_handler_->get_chunk(chunk);
-    if (rc == RC::SUCCESS) {
-      return rc;
-    } else if (rc == RC::RECORD_EOF) {
-      break;
+    bypass_pages_.erase(iter);
+  }
+}
+
+void ChunkFileScanner::release_pages()
+{
+  for (int i = 0; i < page_num_; i++) {
+    cleanup_page(*page_handlers_[i]);
+  }
+  if (pending_page_) {
+    std::swap(page_handlers_[0], page_handlers_[page_num_]);
+  }
+  page_num_ = 0;
+}
+
+int ChunkFileScanner::target_rows(int row_width, int capacity)
+{
+  // 取不到 L2 的大小时按 1MB 计算。Chunk 只占 L2 的一半，给表达式的中间结果留一些空间
+  static const long l2_size = [] {
+    long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return size > 0 ? size : 1024L * 1024;
+  }();
+  if (row_width <= 0) {
+    return capacity;
+  }
+  return static_cast<int>(std::max(1L, std::min<long>(capacity, l2_size / 2 / row_width)));
+}
+
+RC ChunkFileScanner::next_chunk(Chunk &chunk)
+{
+  release_pages();
+  chunk.reset_data();
+
+  if (!eager_set_) {
+    eager_columns_.resize(chunk.column_num());
+    for (int j = 0; j < chunk.column_num(); j++) {
+      eager_columns_[j] = j;
+    }
+  }
+  lazy_columns_.clear();
+  int row_width = 0;
+  for (int j = 0; j < chunk.column_num(); j++) {
+    if (std::find(eager_columns_.begin(), eager_columns_.end(), j) == eager_columns_.end()) {
+      lazy_columns_.push_back(j);
     } else {
-      LOG_WARN("failed to get chunk from page. page_num=%d, rc=%s", page_num, strrc(rc));
+      row_width += chunk.column(j).attr_len();
+    }
+  }
+
+  const StorageFormat storage_format =
+      table_ == nullptr ? StorageFormat::ROW_FORMAT : table_->table_meta().storage_format();
+  const int max_rows = target_rows(row_width, chunk.capacity());
+  int       rows     = 0;
+  while (rows < max_rows) {
+    if (!pending_page_) {
+      PageNum page_num = BP_INVALID_PAGE_NUM;
+      if (!next_page(page_num)) {
+        break;
+      }
+      if (page_num_ == static_cast<int>(page_handlers_.size())) {
+        page_handlers_.emplace_back(RecordPageHandler::create(storage_format));
+        if (storage_format == StorageFormat::ROW_FORMAT) {
+          static_cast<RowRecordPageHandler *>(page_handlers_.back().get())->set_field_offsets(&field_offsets_);
+        }
+      }
+      RC rc = init_page(*page_handlers_[page_num_], page_num);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
+        return rc;
+      }
+    }
+    pending_page_ = false;
+
+    RecordPageHandler &page_handler = *page_handlers_[page_num_];
+    const int          page_rows    = page_handler.record_num();
+    if (page_rows == 0) {
+      cleanup_page(page_handler);
+      continue;
+    }
+    if (rows > 0 && rows + page_rows > chunk.capacity()) {
+      pending_page_ = true;
+      break;
+    }
+
+    if (static_cast<int>(page_rows_.size()) <= page_num_) {
+      page_rows_.resize(page_num_ + 1);
+    }
+    page_rows_[page_num_++] = rows;
+    RC rc = page_handler.get_columns(chunk, eager_columns_, nullptr, 0);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get chunk from page. page_num=%d, rc=%s", page_handler.get_page_num(), strrc(rc));
       return rc;
     }
+    rows += page_rows;
+  }
+
+  if (rows == 0) {
+    return RC::RECORD_EOF;
+  }
+  for (int j : lazy_columns_) {
+    chunk.column(j).set_count(rows);
+  }
+  return RC::SUCCESS;
+}
+
+RC ChunkFileScanner::fetch_columns(Chunk &chunk, const vector<int> &columns, const int *selection, int count)
+{
+  if (columns.empty()) {
+    return RC::SUCCESS;
+  }
+  for (int j : columns) {
+    chunk.column(j).reset_data();
   }
 
-  record_page_handler_->cleanup();
-  return RC::RECORD_EOF;
+  RC rc = RC::SUCCESS;
+  for (int i = 0, k = 0; i < page_num_ && OB_SUCC(rc); i++) {
+    if (selection == nullptr) {
+      rc = page_handlers_[i]->get_columns(chunk, columns, nullptr, 0);
+      continue;
+    }
+
+    const int page_end = i + 1 < page_num_ ? page_rows_[i + 1] : std::numeric_limits<int>::max();
+    page_selection_.clear();
+    for (; k < count && selection[k] < page_end; k++) {
+      page_selection_.push_back(selection[k] - page_rows_[i]);
+    }
+    if (!page_selection_.empty()) {
+      rc = page_handlers_[i]->get_columns(
+          chunk, columns, page_selection_.data(), static_cast<int>(page_selection_.size()));
+    }
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch columns. rc=%s", strrc(rc));
+  }
+  return rc;
 }
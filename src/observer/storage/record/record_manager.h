@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/lang/bitmap.h"
 #include "common/lang/sstream.h"
+#include "common/lang/unordered_map.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/common/chunk.h"
 #include "storage/record/record.h"
@@ -25,6 +26,7 @@ See the Mulan PSL v2 for more details. */
 
 class LogHandler;
 class ConditionFilter;
+class MorselScheduler;
 class RecordPageHandler;
 class LogHandler;
 class Trx;
@@ -222,6 +224,18 @@ public:
    */
   virtual RC get_chunk(Chunk &chunk) { return RC::UNIMPLEMENTED; }
 
+  /**
+   * @brief 把页面中指定列的记录追加到 chunk 中，不会清空 chunk 中原有的数据
+   *
+   * @param columns 需要读取的列在 chunk 中的下标
+   * @param rows    需要读取的行在页面有效记录中的序号，升序。为 nullptr 时读取所有记录
+   * @param row_num rows 中的行数
+   */
+  virtual RC get_columns(Chunk &chunk, const vector<int> &columns, const int *rows, int row_num)
+  {
+    return RC::UNIMPLEMENTED;
+  }
+
   /**
    * @brief 返回该记录页的页号
    */
@@ -237,6 +251,11 @@ public:
    */
   bool is_empty() const;
 
+  /**
+   * @brief 当前页面上的记录数
+   */
+  int record_num() const { return page_header_->record_num; }
+
 protected:
   /**
    * @details
@@ -307,6 +326,21 @@ public:
    * @param record 返回指定的数据。这里不会将数据复制出来，而是使用指针，所以调用者必须保证数据使用期间受到保护
    */
   virtual RC get_record(const RID &rid, Record &record) override;
+
+  /**
+   * @brief 按列读取页面中的记录，与 PaxRecordPageHandler 相同
+   * @details 行存页面中没有列的信息，需要先通过 set_field_offsets 设置每一列在记录中的偏移
+   */
+  virtual RC get_columns(Chunk &chunk, const vector<int> &columns, const int *rows, int row_num) override;
+
+  /**
+   * @brief 设置每一列在记录中的偏移，下标是列的 id（field_id）
+   */
+  void set_field_offsets(const vector<int> *field_offsets) { field_offsets_ = field_offsets; }
+
+private:
+  const vector<int> *field_offsets_ = nullptr;
+  vector<int>        slots_;  ///< get_columns 时要读取的行所在的槽位
 };
 
 /**
@@ -355,12 +389,17 @@ public:
    */
   virtual RC get_chunk(Chunk &chunk) override;
 
+  virtual RC get_columns(Chunk &chunk, const vector<int> &columns, const int *rows, int row_num) override;
+
 private:
   // get the field data by `slot_num` and `column id`
   char *get_field_data(SlotNum slot_num, int col_id);
 
   // get the field length by `column id`, all columns are fixed length.
   int get_field_len(int col_id);
+
+private:
+  vector<int> slots_;  ///< get_columns 时要读取的行所在的槽位
 };
 /**
  * @brief 管理整个文件中记录的增删改查
@@ -435,7 +474,11 @@ private:
 /**
  * @brief 遍历某个文件中所有记录，每次返回一个 Chunk
  * @ingroup RecordManager
- * @details 遍历所有的页面，每次以 Chunk 格式返回一个页面内的所有数据
+ * @details 每次从连续的若干个页面中读取数据，拼成一个 Chunk 返回。一个 Chunk 读取的行数根据读取的列宽调整，
+ * 让 Chunk 中的数据能放进 L2 缓存。
+ * 可以通过 set_eager_columns 只读取部分列，其它列推迟到 fetch_columns 时按需读取（延迟物化）。
+ * 当前 Chunk 涉及的页面会一直持有到下一次调用 next_chunk。
+ * 并行扫描时多个 ChunkFileScanner 共享一个 MorselScheduler，每个 ChunkFileScanner 只扫描分配给它的页面。
  */
 class ChunkFileScanner
 {
@@ -452,10 +495,54 @@ public:
   RC close_scan();
 
   /**
-   * @brief 每次调用获取一个页面中的所有记录。
+   * @brief 设置 next_chunk 时读取的列
+   * @param columns 列在 chunk 中的下标。没有设置时读取 chunk 中所有的列
+   * @details 其它列不会读取数据，只把行数设置成与读取的列相同，需要时再调用 fetch_columns
+   */
+  void set_eager_columns(vector<int> columns);
+
+  /**
+   * @brief 并行扫描，只扫描 scheduler 分配的页面
+   * @details 需要在 open_scan_chunk 之后调用
+   */
+  RC set_morsel_scheduler(MorselScheduler *scheduler);
+
+  /**
+   * @brief 扫描时绕过缓冲区
+   * @details 扫描过程中读进缓冲区的页面，用完之后马上淘汰出去，原本就在缓冲区中的页面不受影响。
+   * 给只读一遍的扫描（比如 ANALYZE TABLE 的采样）使用，避免把其它查询的热点页面挤出缓冲区。
+   * 需要在 open_scan_chunk 之后调用
+   */
+  void set_bypass_cache(bool bypass) { bypass_cache_ = bypass; }
+
+  /**
+   * @brief 每次调用获取若干个页面中的记录。
    */
   RC next_chunk(Chunk &chunk);
 
+  /**
+   * @brief 读取当前 Chunk 中推迟读取的列
+   * @param columns   列在 chunk 中的下标
+   * @param selection 需要读取的行，升序。为 nullptr 时读取所有行，否则只读取这些行并紧凑地放在列的前面
+   * @param count     selection 中的行数
+   */
+  RC fetch_columns(Chunk &chunk, const vector<int> &columns, const int *selection, int count);
+
+  /**
+   * @brief 一个 Chunk 最多读取多少行
+   * @param row_width 每行读取的字节数
+   * @param capacity  Chunk 的容量
+   */
+  static int target_rows(int row_width, int capacity);
+
+private:
+  /// 释放当前 Chunk 涉及的页面，没有读取过的页面留给下一个 Chunk
+  void release_pages();
+
+  bool next_page(PageNum &page_num);
+  RC   init_page(RecordPageHandler &page_handler, PageNum page_num);
+  void cleanup_page(RecordPageHandler &page_handler);
+
 private:
   Table *table_ = nullptr;  ///< 当前遍历的是哪张表。
 
@@ -463,6 +550,23 @@ private:
   LogHandler     *log_handler_      = nullptr;
   ReadWriteMode   rw_mode_          = ReadWriteMode::READ_WRITE;  ///< 遍历出来的数据，是否可能对它做修改
 
-  BufferPoolIterator bp_iterator_;                    ///< 遍历buffer pool的所有页面
-  RecordPageHandler *record_page_handler_ = nullptr;  ///< 处理文件某页面的记录
+  BufferPoolIterator bp_iterator_;  ///< 遍历buffer pool的所有页面
+
+  vector<unique_ptr<RecordPageHandler>> page_handlers_;  ///< 当前 Chunk 涉及的页面，还在持有中
+  vector<int>                           page_rows_;      ///< 每个页面中的数据在 Chunk 中的起始行
+  int                                   page_num_     = 0;      ///< page_handlers_ 中正在使用的个数
+  bool                                  pending_page_ = false;  ///< 最后一个页面放不下，留给下一个 Chunk
+  bool                                  eager_set_    = false;
+  vector<int>                           eager_columns_;
+  vector<int>                           lazy_columns_;  ///< next_chunk 时没有读取的列
+  vector<int>                           page_selection_;
+
+  vector<int> field_offsets_;  ///< 行存表每一列在记录中的偏移，按列读取行存页面时使用
+
+  MorselScheduler *morsel_scheduler_ = nullptr;  ///< 并行扫描时分配页面，为 nullptr 时扫描所有页面
+  vector<PageNum>  morsel_pages_;               ///< 当前 morsel 中的页面
+  int              morsel_pos_ = 0;
+
+  bool                                        bypass_cache_ = false;
+  unordered_map<RecordPageHandler *, PageNum> bypass_pages_;  ///< 绕过缓冲区时，由这次扫描读进缓冲区的页面
 };
@@ -21,6 +21,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/algorithm.h"
 #include "common/log/log.h"
 #include "common/global_context.h"
+#include "catalog/catalog.h"
 #include "storage/db/db.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/common/condition_filter.h"
@@ -169,17 +170,39 @@ RC Table::open(Db *db, const char *meta_file, const char *base_dir)
     return rc;
   }
 
+  // ANALYZE TABLE 收集的统计信息
+  rc = Catalog::get_instance().load_table_stats(table_id(), table_stats_file(base_dir, name()));
+
   return rc;
 }
 
+atomic<uint64_t> Table::global_data_version_{0};
+
+void Table::advance_data_version()
+{
+  // 并发推进时只保留最大的版本，不能让较小的版本覆盖较新的修改
+  const uint64_t version = ++global_data_version_;
+  uint64_t       current = data_version_.load();
+  while (current < version && !data_version_.compare_exchange_weak(current, version)) {
+  }
+}
+
 RC Table::insert_record(Record &record)
 {
-  return engine_->insert_record(record);
+  RC rc = engine_->insert_record(record);
+  if (OB_SUCC(rc)) {
+    add_modified_rows(1);
+  }
+  return rc;
 }
 
 RC Table::insert_chunk(const Chunk& chunk)
 {
-  return engine_->insert_chunk(chunk);
+  RC rc = engine_->insert_chunk(chunk);
+  if (OB_SUCC(rc)) {
+    add_modified_rows(chunk.rows());
+  }
+  return rc;
 }
 
 RC Table::visit_record(const RID &rid, function<bool(Record &)> visitor)
@@ -187,18 +210,43 @@ RC Table::visit_record(const RID &rid, function<bool(Record &)> visitor)
   return engine_->visit_record(rid, visitor);
 }
 
+RC Table::delete_record_in_place(const RID &rid, function<bool(Record &)> deleter)
+{
+  bool deleted = false;
+  RC   rc      = engine_->visit_record(rid, [&deleter, &deleted](Record &record) {
+    deleted = deleter(record);
+    return deleted;
+  });
+  if (OB_SUCC(rc) && deleted) {
+    add_modified_rows(1);
+  }
+  return rc;
+}
+
 RC Table::insert_record_with_trx(Record &record, Trx *trx)
 {
-  return engine_->insert_record_with_trx(record, trx);
+  RC rc = engine_->insert_record_with_trx(record, trx);
+  if (OB_SUCC(rc)) {
+    add_modified_rows(1);
+  }
+  return rc;
 }
 RC Table::delete_record_with_trx(const Record &record, Trx *trx)
 {
-  return engine_->delete_record_with_trx(record, trx);
+  RC rc = engine_->delete_record_with_trx(record, trx);
+  if (OB_SUCC(rc)) {
+    add_modified_rows(1);
+  }
+  return rc;
 }
 
 RC Table::update_record_with_trx(const Record &old_record, const Record &new_record, Trx* trx)
 {
-  return engine_->update_record_with_trx(old_record, new_record, trx);
+  RC rc = engine_->update_record_with_trx(old_record, new_record, trx);
+  if (OB_SUCC(rc)) {
+    add_modified_rows(1);
+  }
+  return rc;
 }
 
 RC Table::get_record(const RID &rid, Record &record)
@@ -281,7 +329,11 @@ RC Table::create_index(Trx *trx, const FieldMeta *field_meta, const char *index_
 
 RC Table::delete_record(const Record &record)
 {
-  return engine_->delete_record(record);
+  RC rc = engine_->delete_record(record);
+  if (OB_SUCC(rc)) {
+    add_modified_rows(1);
+  }
+  return rc;
 }
 
 Index *Table::find_index(const char *index_name) const
@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/chunk.h"
 #include "storage/record/lob_handler.h"
 #include "common/types.h"
+#include "common/lang/atomic.h"
 #include "common/lang/span.h"
 #include "common/lang/functional.h"
 
@@ -109,6 +110,12 @@ public:
    */
   RC visit_record(const RID &rid, function<bool(Record &)> visitor);
 
+  /**
+   * @brief 在页面锁保护下原地修改记录来删除它，比如 MVCC 删除时只标记版本号
+   * @details deleter 返回 true 表示记录被删除，此时与 delete_record 一样计入修改行数
+   */
+  RC delete_record_in_place(const RID &rid, function<bool(Record &)> deleter);
+
 public:
   int32_t     table_id() const { return table_meta_.table_id(); }
   const char *name() const;
@@ -121,6 +128,30 @@ public:
 
   RC sync();
 
+  /**
+   * @brief 上次收集统计信息之后修改过的行数
+   * @details 插入、删除、更新都会增加计数，只在 Table 这一层计数，事务层不再重复计数。
+   * 收集统计信息之后减去收集开始时的值，收集期间的修改不会丢失。
+   * 计数超过阈值时，统计信息会在下次被优化器使用前重新收集
+   */
+  int64_t modified_rows() const { return modified_rows_.load(); }
+  void    add_modified_rows(int64_t rows)
+  {
+    modified_rows_.fetch_add(rows);
+    advance_data_version();
+  }
+  void reset_modified_rows(int64_t analyzed_rows) { modified_rows_.fetch_sub(analyzed_rows); }
+
+  /**
+   * @brief 表中数据最后一次变化时的数据版本
+   * @details 数据版本是所有表共用的递增计数。修改数据之后，以及事务提交让修改对其它事务可见之后，
+   * 都要推进一次。查询缓存记录开始执行时的全局数据版本，访问的表的数据版本都不超过它时，缓存的结果仍然有效
+   */
+  uint64_t data_version() const { return data_version_.load(); }
+  void     advance_data_version();
+
+  static uint64_t current_data_version() { return global_data_version_.load(); }
+
 private:
   RC set_value_to_record(char *record_data, const Value &value, const FieldMeta *field);
 
@@ -139,4 +170,8 @@ private:
   // vector<Index *>    indexes_;
   unique_ptr<TableEngine> engine_      = nullptr;
   LobFileHandler         *lob_handler_ = nullptr;
+  atomic<int64_t>         modified_rows_{0};
+  atomic<uint64_t>        data_version_{0};
+
+  static atomic<uint64_t> global_data_version_;
 };
@@ -9,6 +9,7 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "storage/trx/lsm_mvcc_trx.h"
+#include "common/lang/algorithm.h"
 
 RC LsmMvccTrxKit::init() { return RC::SUCCESS; }
 
@@ -29,18 +30,28 @@ LogReplayer *LsmMvccTrxKit::create_log_replayer(Db &, LogHandler &) { return new
 
 RC LsmMvccTrx::insert_record(Table *table, Record &record)
 {
-   return table->insert_record_with_trx(record, this);
+  add_written_table(table);
+  return table->insert_record_with_trx(record, this);
 }
 
 RC LsmMvccTrx::delete_record(Table *table, Record &record)
 {
+  add_written_table(table);
   return table->delete_record_with_trx(record, this);
 }
 
 RC LsmMvccTrx::update_record(Table *table, Record &old_record, Record &new_record)
 {
+  add_written_table(table);
   return table->update_record_with_trx(old_record, new_record, this);
 }
+
+void LsmMvccTrx::add_written_table(Table *table)
+{
+  if (find(written_tables_.begin(), written_tables_.end(), table) == written_tables_.end()) {
+    written_tables_.push_back(table);
+  }
+}
 /**
  * 在 index scan 中使用的，需要适配 index scan
  */
@@ -60,11 +71,18 @@ RC LsmMvccTrx::commit()
   if (trx_ == nullptr) {
     return RC::SUCCESS;
   }
-  return trx_->commit();
+  RC rc = trx_->commit();
+  // 提交之后修改才可见，推进数据版本让查询缓存中的结果失效
+  for (Table *table : written_tables_) {
+    table->advance_data_version();
+  }
+  written_tables_.clear();
+  return rc;
 }
 
 RC LsmMvccTrx::rollback()
 {
+  written_tables_.clear();
   return trx_->rollback();
 }
 
@@ -65,9 +65,13 @@ public:
 
   int32_t id() const override { return 0; }
 
+private:
+  void add_written_table(Table *table);
+
 private:
   ObLsm            *lsm_;
   ObLsmTransaction *trx_ = nullptr;
+  vector<Table *>   written_tables_;  ///< 修改过的表，提交后推进它们的数据版本
 };
 
 class LsmMvccTrxLogReplayer : public LogReplayer
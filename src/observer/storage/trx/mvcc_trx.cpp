@@ -142,7 +142,8 @@ RC MvccTrx::delete_record(Table *table, Record &record)
 
   RC delete_result = RC::SUCCESS;
 
-  RC rc = table->visit_record(record.rid(), [this, table, &delete_result, &end_field](Record &inplace_record) -> bool {
+  RC rc = table->delete_record_in_place(
+      record.rid(), [this, table, &delete_result, &end_field](Record &inplace_record) -> bool {
     RC rc = this->visit_record(table, inplace_record, ReadWriteMode::READ_WRITE);
     if (OB_FAIL(rc)) {
       delete_result = rc;
@@ -325,6 +326,17 @@ RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
     rc = log_handler_.commit(trx_id_, commit_xid);
   }
 
+  // 修改已经对其它事务可见，推进数据版本让查询缓存中的结果失效
+  vector<Table *> tables;
+  for (const Operation &operation : operations_) {
+    if (find(tables.begin(), tables.end(), operation.table()) == tables.end()) {
+      tables.push_back(operation.table());
+    }
+  }
+  for (Table *table : tables) {
+    table->advance_data_version();
+  }
+
   operations_.clear();
 
   LOG_TRACE("append trx commit log. trx id=%d, commit_xid=%d, rc=%s", trx_id_, commit_xid, strrc(rc));
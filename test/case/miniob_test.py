@@ -483,12 +483,28 @@ class CommandRunner:
       result = self.run_sort(command_arg)
     elif command.startswith('ensure'):
       result = self.run_ensure(command, command_arg)
+    elif command.startswith('exclude:'):
+      result = self.run_exclude(command, command_arg)
     else:
       _logger.error("No such command %s", command)
       result = False
 
     return result
   
+  def run_exclude(self, command: str, sql: str):
+    '''
+    执行SQL，丢掉包含指定关键字的结果行，比如 exclude:CACHE_MEMORY 可以去掉与平台相关的内存统计
+    '''
+    self.__result_writer.write_line(sql)
+    keyword = command[len('exclude:') : ].upper()
+    result, data = self.__current_client.run_sql(sql)
+    if result is False:
+      return False
+    data_l = [line for line in data.strip().split('\n') if keyword not in line.upper()]
+    data = '\n'.join(data_l) + '\n'
+    self.__result_writer.write(data)
+    return True
+
   def run_ensure(self, command: str, sql: str):
     self.__result_writer.write_line(command + " " + sql)
     result, data = self.__current_client.run_sql("explain " + sql)
@@ -103,6 +103,289 @@ TEST(AggregateHashTableTest, DISABLED_standard_hash_table)
   }
 }
 
+TEST(AggregateHashTableTest, vectorized_hash_table)
+{
+  // mutiple group by columns, mutiple aggregate columns, added by several chunks
+  {
+    FieldMeta int_field("i", AttrType::INTS, 0, 4, true, 0);
+    FieldMeta float_field("f", AttrType::FLOATS, 0, 4, true, 1);
+
+    vector<unique_ptr<AggregateExpr>> aggregate_exprs;
+    aggregate_exprs.emplace_back(make_unique<AggregateExpr>(AggregateExpr::Type::SUM, new FieldExpr(nullptr, &int_field)));
+    aggregate_exprs.emplace_back(make_unique<AggregateExpr>(AggregateExpr::Type::COUNT, new ValueExpr(Value(1))));
+    aggregate_exprs.emplace_back(make_unique<AggregateExpr>(AggregateExpr::Type::MIN, new FieldExpr(nullptr, &int_field)));
+    aggregate_exprs.emplace_back(make_unique<AggregateExpr>(AggregateExpr::Type::MAX, new FieldExpr(nullptr, &float_field)));
+    aggregate_exprs.emplace_back(make_unique<AggregateExpr>(AggregateExpr::Type::AVG, new FieldExpr(nullptr, &int_field)));
+    vector<Expression *> aggregate_expr_ptrs;
+    for (auto &expr : aggregate_exprs) {
+      aggregate_expr_ptrs.push_back(expr.get());
+    }
+
+    VectorizedAggregateHashTable hash_table(aggregate_expr_ptrs);
+    for (int round = 0; round < 2; round++) {
+      Chunk group_chunk;
+      Chunk aggr_chunk;
+      auto  group1 = make_unique<Column>(AttrType::CHARS, 4);
+      auto  group2 = make_unique<Column>(AttrType::INTS, 4);
+      auto  aggr1  = make_unique<Column>(AttrType::INTS, 4);
+      auto  aggr2  = make_unique<Column>();
+      auto  aggr3  = make_unique<Column>(AttrType::INTS, 4);
+      auto  aggr4  = make_unique<Column>(AttrType::FLOATS, 4);
+      auto  aggr5  = make_unique<Column>(AttrType::INTS, 4);
+      for (int i = 0; i < 1000; i++) {
+        int   i_group2 = i % 4;
+        float i_float  = i + 0.5;
+        group1->append_value(Value(to_string(i % 2).c_str()));
+        group2->append_one((char *)&i_group2);
+        aggr1->append_one((char *)&i);
+        aggr3->append_one((char *)&i);
+        aggr4->append_one((char *)&i_float);
+        aggr5->append_one((char *)&i);
+      }
+      aggr2->init(Value(1), 1000);
+      group_chunk.add_column(std::move(group1), 0);
+      group_chunk.add_column(std::move(group2), 1);
+      aggr_chunk.add_column(std::move(aggr1), 0);
+      aggr_chunk.add_column(std::move(aggr2), 1);
+      aggr_chunk.add_column(std::move(aggr3), 2);
+      aggr_chunk.add_column(std::move(aggr4), 3);
+      aggr_chunk.add_column(std::move(aggr5), 4);
+      ASSERT_EQ(hash_table.add_chunk(group_chunk, aggr_chunk), RC::SUCCESS);
+    }
+    // (i % 2, i % 4) only has 4 different values
+    ASSERT_EQ(hash_table.group_count(), 4);
+
+    Chunk output_chunk;
+    output_chunk.add_column(make_unique<Column>(AttrType::CHARS, 4), 0);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 1);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 2);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 3);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 4);
+    output_chunk.add_column(make_unique<Column>(AttrType::FLOATS, 4), 5);
+    output_chunk.add_column(make_unique<Column>(AttrType::FLOATS, 4), 6);
+    VectorizedAggregateHashTable::Scanner scanner(&hash_table);
+    scanner.open_scan();
+    ASSERT_EQ(scanner.next(output_chunk), RC::SUCCESS);
+    ASSERT_EQ(output_chunk.rows(), 4);
+    for (int i = 0; i < 4; i++) {
+      int group2 = output_chunk.get_value(1, i).get_int();
+      ASSERT_EQ(output_chunk.get_value(0, i).get_string(), to_string(group2 % 2));
+      // 250 rows in each group of one round: group2, group2 + 4, ...
+      ASSERT_EQ(output_chunk.get_value(2, i).get_int(), 2 * (250 * group2 + 4 * 250 * 249 / 2));
+      ASSERT_EQ(output_chunk.get_value(3, i).get_int(), 500);
+      ASSERT_EQ(output_chunk.get_value(4, i).get_int(), group2);
+      ASSERT_FLOAT_EQ(output_chunk.get_value(5, i).get_float(), 996 + group2 + 0.5);
+      ASSERT_FLOAT_EQ(output_chunk.get_value(6, i).get_float(), group2 + 498);
+    }
+    output_chunk.reset_data();
+    ASSERT_EQ(scanner.next(output_chunk), RC::RECORD_EOF);
+  }
+
+  // text group by column
+  {
+    FieldMeta int_field("i", AttrType::INTS, 0, 4, true, 0);
+    AggregateExpr        aggregate_expr(AggregateExpr::Type::SUM, new FieldExpr(nullptr, &int_field));
+    vector<Expression *> aggregate_exprs{&aggregate_expr};
+
+    VectorizedAggregateHashTable hash_table(aggregate_exprs);
+    Chunk                        group_chunk;
+    Chunk                        aggr_chunk;
+    auto                         group = make_unique<Column>(AttrType::TEXTS, sizeof(string_t));
+    auto                         aggr  = make_unique<Column>(AttrType::INTS, 4);
+    for (int i = 0; i < 100; i++) {
+      Value text;
+      text.set_text(string(20 + i % 3, 'a' + i % 3).c_str());
+      group->append_value(text);
+      aggr->append_one((char *)&i);
+    }
+    group_chunk.add_column(std::move(group), 0);
+    aggr_chunk.add_column(std::move(aggr), 0);
+    ASSERT_EQ(hash_table.add_chunk(group_chunk, aggr_chunk), RC::SUCCESS);
+    ASSERT_EQ(hash_table.group_count(), 3);
+
+    Chunk output_chunk;
+    output_chunk.add_column(make_unique<Column>(AttrType::TEXTS, sizeof(string_t)), 0);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 1);
+    VectorizedAggregateHashTable::Scanner scanner(&hash_table);
+    scanner.open_scan();
+    ASSERT_EQ(scanner.next(output_chunk), RC::SUCCESS);
+    ASSERT_EQ(output_chunk.rows(), 3);
+    int total = 0;
+    for (int i = 0; i < 3; i++) {
+      string key = output_chunk.get_value(0, i).get_string();
+      ASSERT_EQ(key.size(), 20 + (key[0] - 'a'));
+      total += output_chunk.get_value(1, i).get_int();
+    }
+    ASSERT_EQ(total, 99 * 100 / 2);
+  }
+}
+
+TEST(AggregateHashTableTest, spillable_hash_table)
+{
+  FieldMeta     int_field("i", AttrType::INTS, 0, 4, true, 0);
+  AggregateExpr sum_expr(AggregateExpr::Type::SUM, new FieldExpr(nullptr, &int_field));
+  AggregateExpr count_expr(AggregateExpr::Type::COUNT, new ValueExpr(Value(1)));
+  vector<Expression *> aggregate_exprs{&sum_expr, &count_expr};
+
+  // 内存限制很小，第一个 chunk 之后哈希表就会被冻结，后面新出现的分组都会溢出到磁盘，并且会递归地划分分区
+  const int                   group_num  = 10000;
+  const int                   chunk_rows = 5000;
+  SpillableAggregateHashTable hash_table(aggregate_exprs, 16 * 1024);
+  for (int round = 0; round < 4; round++) {
+    Chunk group_chunk;
+    Chunk aggr_chunk;
+    auto  group1 = make_unique<Column>(AttrType::INTS, 4);
+    auto  group2 = make_unique<Column>(AttrType::TEXTS, sizeof(string_t));
+    auto  aggr1  = make_unique<Column>(AttrType::INTS, 4);
+    auto  aggr2  = make_unique<Column>();
+    for (int j = 0; j < chunk_rows; j++) {
+      int   i     = round * chunk_rows + j;
+      int   group = i % group_num;
+      Value text;
+      text.set_text(("group_" + to_string(group) + "_padding").c_str());
+      group1->append_one((char *)&group);
+      group2->append_value(text);
+      aggr1->append_one((char *)&i);
+    }
+    aggr2->init(Value(1), chunk_rows);
+    group_chunk.add_column(std::move(group1), 0);
+    group_chunk.add_column(std::move(group2), 1);
+    aggr_chunk.add_column(std::move(aggr1), 0);
+    aggr_chunk.add_column(std::move(aggr2), 1);
+    ASSERT_EQ(hash_table.add_chunk(group_chunk, aggr_chunk), RC::SUCCESS);
+  }
+  ASSERT_GT(hash_table.spilled_rows(), 0);
+
+  Chunk output_chunk;
+  output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 0);
+  output_chunk.add_column(make_unique<Column>(AttrType::TEXTS, sizeof(string_t)), 1);
+  output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 2);
+  output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 3);
+  SpillableAggregateHashTable::Scanner scanner(&hash_table);
+  scanner.open_scan();
+  vector<bool> seen(group_num, false);
+  int          total = 0;
+  RC           rc    = RC::SUCCESS;
+  while (true) {
+    output_chunk.reset_data();
+    if (OB_FAIL(rc = scanner.next(output_chunk))) {
+      break;
+    }
+    for (int r = 0; r < output_chunk.rows(); r++) {
+      int group = output_chunk.get_value(0, r).get_int();
+      ASSERT_FALSE(seen[group]);
+      seen[group] = true;
+      ASSERT_EQ(output_chunk.get_value(1, r).get_string(), "group_" + to_string(group) + "_padding");
+      ASSERT_EQ(output_chunk.get_value(2, r).get_int(), 2 * group + group_num);
+      ASSERT_EQ(output_chunk.get_value(3, r).get_int(), 2);
+      total++;
+    }
+  }
+  ASSERT_EQ(rc, RC::RECORD_EOF);
+  ASSERT_EQ(total, group_num);
+}
+
+TEST(AggregateHashTableTest, merge_hash_tables)
+{
+  FieldMeta     int_field("i", AttrType::INTS, 0, 4, true, 0);
+  FieldMeta     char_field("c", AttrType::CHARS, 0, 4, true, 1);
+  AggregateExpr sum_expr(AggregateExpr::Type::SUM, new FieldExpr(nullptr, &int_field));
+  AggregateExpr count_expr(AggregateExpr::Type::COUNT, new ValueExpr(Value(1)));
+  AggregateExpr min_expr(AggregateExpr::Type::MIN, new FieldExpr(nullptr, &int_field));
+  AggregateExpr max_expr(AggregateExpr::Type::MAX, new FieldExpr(nullptr, &char_field));
+  vector<Expression *> aggregate_exprs{&sum_expr, &count_expr, &min_expr, &max_expr};
+
+  // 模拟并行聚合：3 个线程各自预聚合一部分数据，分组互相重叠，再按哈希值的最高位分成两个分区合并
+  const int group_num  = 1000;
+  const int chunk_rows = 1500;
+  vector<unique_ptr<VectorizedAggregateHashTable>> partials;
+  for (int t = 0; t < 3; t++) {
+    partials.emplace_back(make_unique<VectorizedAggregateHashTable>(aggregate_exprs));
+    Chunk group_chunk;
+    Chunk aggr_chunk;
+    auto  group1 = make_unique<Column>(AttrType::INTS, 4);
+    auto  group2 = make_unique<Column>(AttrType::TEXTS, sizeof(string_t));
+    auto  aggr1  = make_unique<Column>(AttrType::INTS, 4);
+    auto  aggr2  = make_unique<Column>();
+    auto  aggr3  = make_unique<Column>(AttrType::INTS, 4);
+    auto  aggr4  = make_unique<Column>(AttrType::CHARS, 4);
+    for (int j = 0; j < chunk_rows; j++) {
+      int   i     = t * chunk_rows + j;
+      int   group = i % group_num;
+      Value text;
+      text.set_text(("group_" + to_string(group)).c_str());
+      group1->append_one((char *)&group);
+      group2->append_value(text);
+      aggr1->append_one((char *)&i);
+      aggr3->append_one((char *)&i);
+      aggr4->append_value(Value(to_string(t).c_str()));
+    }
+    aggr2->init(Value(1), chunk_rows);
+    group_chunk.add_column(std::move(group1), 0);
+    group_chunk.add_column(std::move(group2), 1);
+    aggr_chunk.add_column(std::move(aggr1), 0);
+    aggr_chunk.add_column(std::move(aggr2), 1);
+    aggr_chunk.add_column(std::move(aggr3), 2);
+    aggr_chunk.add_column(std::move(aggr4), 3);
+    ASSERT_EQ(partials.back()->add_chunk(group_chunk, aggr_chunk), RC::SUCCESS);
+  }
+
+  vector<int64_t> sums(group_num, 0);
+  vector<int>     counts(group_num, 0);
+  vector<int>     mins(group_num, INT32_MAX);
+  vector<string>  maxs(group_num);
+  for (int i = 0; i < 3 * chunk_rows; i++) {
+    const int group = i % group_num;
+    sums[group] += i;
+    counts[group]++;
+    mins[group] = min(mins[group], i);
+    maxs[group] = max(maxs[group], to_string(i / chunk_rows));
+  }
+
+  int total = 0;
+  for (int partition = 0; partition < 2; partition++) {
+    VectorizedAggregateHashTable merged(aggregate_exprs);
+    for (auto &partial : partials) {
+      vector<int> groups;
+      for (int group = 0; group < partial->group_count(); group++) {
+        if (static_cast<int>(partial->group_hash(group) >> 63) == partition) {
+          groups.push_back(group);
+        }
+      }
+      ASSERT_EQ(merged.merge(*partial, groups), RC::SUCCESS);
+    }
+
+    Chunk output_chunk;
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 0);
+    output_chunk.add_column(make_unique<Column>(AttrType::TEXTS, sizeof(string_t)), 1);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 2);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 3);
+    output_chunk.add_column(make_unique<Column>(AttrType::INTS, 4), 4);
+    output_chunk.add_column(make_unique<Column>(AttrType::CHARS, 4), 5);
+    VectorizedAggregateHashTable::Scanner scanner(&merged);
+    scanner.open_scan();
+    while (true) {
+      output_chunk.reset_data();
+      RC rc = scanner.next(output_chunk);
+      if (rc == RC::RECORD_EOF) {
+        break;
+      }
+      ASSERT_EQ(rc, RC::SUCCESS);
+      for (int r = 0; r < output_chunk.rows(); r++) {
+        const int group = output_chunk.get_value(0, r).get_int();
+        ASSERT_EQ(output_chunk.get_value(1, r).get_string(), "group_" + to_string(group));
+        ASSERT_EQ(output_chunk.get_value(2, r).get_int(), sums[group]);
+        ASSERT_EQ(output_chunk.get_value(3, r).get_int(), counts[group]);
+        ASSERT_EQ(output_chunk.get_value(4, r).get_int(), mins[group]);
+        ASSERT_EQ(output_chunk.get_value(5, r).get_string(), maxs[group]);
+        counts[group] = 0;  // 每个分组只能出现在一个分区中
+        total++;
+      }
+    }
+  }
+  ASSERT_EQ(total, group_num);
+}
+
 #ifdef USE_SIMD
 TEST(AggregateHashTableTest, linear_probing_hash_table)
 {
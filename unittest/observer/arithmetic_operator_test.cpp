@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <memory>
 
+#include "sql/expr/arithmetic_kernel.h"
 #include "sql/expr/arithmetic_operator.hpp"
 #include "gtest/gtest.h"
 
@@ -106,6 +107,170 @@ TEST(ArithmeticTest, arithmetic_test)
 #endif
 }
 
+namespace {
+/// 生成 rows 行的数值列，第 i 行为 i - rows / 2 的若干倍，常量列只有一个值 3
+unique_ptr<Column> make_number_column(AttrType attr_type, int rows, bool constant)
+{
+  auto column = make_unique<Column>();
+  if (constant) {
+    Value value(3);
+    if (attr_type == AttrType::BIGINTS) {
+      value = Value(int64_t(3));
+    } else if (attr_type == AttrType::FLOATS) {
+      value = Value(3.0f);
+    }
+    column->init(value, rows);
+    column->set_attr_type(attr_type);
+    return column;
+  }
+  column->init(attr_type, get_default_length(attr_type), rows);
+  for (int i = 0; i < rows; i++) {
+    const int base = i - rows / 2;
+    switch (attr_type) {
+      case AttrType::BIGINTS: {
+        int64_t value = base * 1000003LL;
+        column->append_one((char *)&value);
+      } break;
+      case AttrType::FLOATS: {
+        float value = base * 0.5f;
+        column->append_one((char *)&value);
+      } break;
+      default: {
+        int value = base * 7;
+        column->append_one((char *)&value);
+      } break;
+    }
+  }
+  return column;
+}
+
+double number_at(const Column &column, int row)
+{
+  const int index = column.column_type() == Column::Type::CONSTANT_COLUMN ? 0 : row;
+  switch (column.attr_type()) {
+    case AttrType::BIGINTS: return static_cast<double>(((int64_t *)column.data())[index]);
+    case AttrType::FLOATS: return ((float *)column.data())[index];
+    default: return ((int *)column.data())[index];
+  }
+}
+}  // namespace
+
+TEST(ArithmeticTest, kernel_table_test)
+{
+  const int                          rows  = 37;
+  const vector<AttrType>             types = {AttrType::INTS, AttrType::DATES, AttrType::BIGINTS, AttrType::FLOATS};
+  const vector<ArithmeticExpr::Type> ops   = {
+      ArithmeticExpr::Type::ADD, ArithmeticExpr::Type::SUB, ArithmeticExpr::Type::MUL, ArithmeticExpr::Type::DIV};
+  for (ArithmeticExpr::Type op : ops) {
+    for (AttrType left_type : types) {
+      for (AttrType right_type : types) {
+        ArithmeticKernels kernels;
+        ASSERT_EQ(get_arithmetic_kernels(op, left_type, right_type, kernels), RC::SUCCESS);
+        const AttrType result_type = arithmetic_result_type(op, left_type, right_type);
+        for (int constants = 0; constants < 3; constants++) {
+          const bool left_const  = constants == 1;
+          const bool right_const = constants == 2;
+          auto       left        = make_number_column(left_type, rows, left_const);
+          auto       right       = make_number_column(right_type, rows, right_const);
+          Column     result(result_type, get_default_length(result_type), rows);
+          ASSERT_EQ(kernels[left_const * 2 + right_const](*left, *right, result, rows, nullptr, 0), RC::SUCCESS);
+          result.set_count(rows);
+          for (int i = 0; i < rows; i++) {
+            const double l = number_at(*left, i);
+            const double r = number_at(*right, i);
+            if (op == ArithmeticExpr::Type::DIV && r == 0) {
+              continue;
+            }
+            double expected;
+            switch (op) {
+              case ArithmeticExpr::Type::ADD: expected = l + r; break;
+              case ArithmeticExpr::Type::SUB: expected = l - r; break;
+              case ArithmeticExpr::Type::MUL: expected = l * r; break;
+              default: expected = static_cast<float>(l) / static_cast<float>(r); break;
+            }
+            ASSERT_NEAR(number_at(result, i), expected, std::abs(expected) * 1e-5 + 1e-3)
+                << "op=" << static_cast<int>(op) << ", left=" << attr_type_to_string(left_type)
+                << ", right=" << attr_type_to_string(right_type) << ", row=" << i;
+          }
+        }
+      }
+    }
+  }
+  ASSERT_EQ(arithmetic_result_type(ArithmeticExpr::Type::ADD, AttrType::INTS, AttrType::DATES), AttrType::INTS);
+  ASSERT_EQ(arithmetic_result_type(ArithmeticExpr::Type::MUL, AttrType::INTS, AttrType::BIGINTS), AttrType::BIGINTS);
+  ASSERT_EQ(arithmetic_result_type(ArithmeticExpr::Type::DIV, AttrType::INTS, AttrType::INTS), AttrType::FLOATS);
+  ASSERT_EQ(arithmetic_result_type(ArithmeticExpr::Type::ADD, AttrType::CHARS, AttrType::INTS), AttrType::UNDEFINED);
+}
+
+TEST(ArithmeticTest, overflow_test)
+{
+  const int   size = 100;
+  vector<int> a(size, 1);
+  vector<int> b(size, 2);
+  vector<int> result(size, 0);
+  ASSERT_FALSE((checked_binary_operator<false, false, int, AddOperator>(a.data(), b.data(), result.data(), size)));
+  ASSERT_EQ(result[size - 1], 3);
+
+  // 溢出分别出现在向量化部分与剩余的部分
+  for (int row : {3, size - 1}) {
+    a[row] = numeric_limits<int>::max();
+    ASSERT_TRUE((checked_binary_operator<false, false, int, AddOperator>(a.data(), b.data(), result.data(), size)));
+    ASSERT_TRUE((checked_binary_operator<false, false, int, MultiplyOperator>(a.data(), b.data(), result.data(), size)));
+    a[row] = numeric_limits<int>::min();
+    ASSERT_TRUE((checked_binary_operator<false, false, int, SubtractOperator>(a.data(), b.data(), result.data(), size)));
+    a[row] = 1;
+  }
+  // -46341 * -46341 溢出，46340 * -46341 不溢出
+  a.assign(size, 46340);
+  b.assign(size, -46341);
+  ASSERT_FALSE((checked_binary_operator<false, false, int, MultiplyOperator>(a.data(), b.data(), result.data(), size)));
+  ASSERT_EQ(result[0], 46340 * -46341);
+  a[5] = -46341;
+  ASSERT_TRUE((checked_binary_operator<false, false, int, MultiplyOperator>(a.data(), b.data(), result.data(), size)));
+
+  vector<int64_t> c(size, numeric_limits<int64_t>::max() - 1);
+  vector<int64_t> d(size, 1);
+  vector<int64_t> result64(size, 0);
+  ASSERT_FALSE(
+      (checked_binary_operator<false, true, int64_t, AddOperator>(c.data(), d.data(), result64.data(), size)));
+  d[0] = 2;
+  ASSERT_TRUE((checked_binary_operator<false, true, int64_t, AddOperator>(c.data(), d.data(), result64.data(), size)));
+
+  // 通过函数表计算时溢出返回 RANGE_ERROR，但是 NULL 行以及被过滤掉的行的溢出不算
+  ArithmeticKernels kernels;
+  ASSERT_EQ(get_arithmetic_kernels(ArithmeticExpr::Type::ADD, AttrType::INTS, AttrType::INTS, kernels), RC::SUCCESS);
+  Column left(AttrType::INTS, sizeof(int), size);
+  Column right;
+  right.init(Value(1), size);
+  for (int i = 0; i < size; i++) {
+    int value = i == 10 ? numeric_limits<int>::max() : i;
+    left.append_one((char *)&value);
+  }
+  Column sum(AttrType::INTS, sizeof(int), size);
+  ASSERT_EQ(kernels[1](left, right, sum, size, nullptr, 0), RC::RANGE_ERROR);
+  vector<int> selection{0, 9, 11, size - 1};
+  ASSERT_EQ(kernels[1](left, right, sum, size, selection.data(), static_cast<int>(selection.size())), RC::SUCCESS);
+  ASSERT_EQ(((int *)sum.data())[11], 12);
+  selection.insert(selection.begin() + 2, 10);
+  ASSERT_EQ(
+      kernels[1](left, right, sum, size, selection.data(), static_cast<int>(selection.size())), RC::RANGE_ERROR);
+  left.set_null(10);
+  ASSERT_EQ(kernels[1](left, right, sum, size, nullptr, 0), RC::SUCCESS);
+
+  // 逐行计算时同样报错，结果与向量化计算一样按补码回绕
+  Value value;
+  value.set_type(AttrType::INTS);
+  ASSERT_EQ(Value::add(Value(numeric_limits<int>::max()), Value(1), value), RC::RANGE_ERROR);
+  ASSERT_EQ(value.get_int(), numeric_limits<int>::min());
+  ASSERT_EQ(Value::multiply(Value(46341), Value(46341), value), RC::RANGE_ERROR);
+  ASSERT_EQ(Value::negative(Value(numeric_limits<int>::min()), value), RC::RANGE_ERROR);
+  ASSERT_EQ(Value::add(Value(1), Value(2), value), RC::SUCCESS);
+  ASSERT_EQ(value.get_int(), 3);
+  Value big_value;
+  big_value.set_type(AttrType::BIGINTS);
+  ASSERT_EQ(Value::subtract(Value(numeric_limits<int64_t>::min()), Value(int64_t(1)), big_value), RC::RANGE_ERROR);
+}
+
 int main(int argc, char **argv)
 {
 
@@ -9,6 +9,8 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "catalog/catalog.h"
+#include "common/lang/sstream.h"
+#include "storage/common/column.h"
 
 #include "gtest/gtest.h"
 
@@ -29,6 +31,148 @@ TEST(CatalogTest, catalog_test)
   EXPECT_EQ(catalog.get_table_stats(-1).row_nums, 0);
 }
 
+TEST(CatalogTest, hyper_log_log)
+{
+  HyperLogLog hll;
+  HyperLogLog other;
+  for (int i = 0; i < 100000; i++) {
+    Value value(i);
+    (i % 2 == 0 ? hll : other).add_hash(column_stats_hash(value));
+    // 重复的值不影响结果
+    hll.add_hash(column_stats_hash(Value(i % 100)));
+  }
+  hll.merge(other);
+  EXPECT_NEAR(hll.estimate(), 100000, 100000 * 0.05);
+
+  HyperLogLog small;
+  for (int i = 0; i < 1000; i++) {
+    small.add_hash(column_stats_hash(Value(i % 10)));
+  }
+  EXPECT_NEAR(small.estimate(), 10, 1);
+}
+
+TEST(CatalogTest, column_stats)
+{
+  // 一半的行是 7，另一半在 [0, 1000) 上均匀分布
+  const int            rows = 100000;
+  ColumnStatsCollector collector("a", AttrType::INTS);
+  Column               column(AttrType::INTS, sizeof(int), rows);
+  for (int i = 0; i < rows; i++) {
+    int v = i % 2 == 0 ? 7 : (i / 2) % 1000;
+    column.append_one((const char *)&v);
+  }
+  collector.add(column, rows);
+
+  ColumnStats stats;
+  collector.finish(rows, stats);
+  EXPECT_EQ(stats.null_frac, 0);
+  EXPECT_NEAR(stats.ndv, 1000, 50);
+  EXPECT_EQ(stats.min_value.get_int(), 0);
+  EXPECT_EQ(stats.max_value.get_int(), 999);
+  ASSERT_FALSE(stats.mcv_values.empty());
+  EXPECT_EQ(stats.mcv_values[0].get_int(), 7);
+  EXPECT_EQ(stats.histogram_bounds.size(), ColumnStats::HISTOGRAM_BUCKETS + 1);
+
+  EXPECT_NEAR(stats.equal_selectivity(Value(7)), 0.5, 0.02);
+  EXPECT_NEAR(stats.equal_selectivity(Value(100)), 0.0005, 0.0005);
+  EXPECT_EQ(stats.equal_selectivity(Value(5000)), 0);
+  EXPECT_NEAR(stats.less_selectivity(Value(500), false), 0.75, 0.03);
+  EXPECT_NEAR(stats.greater_selectivity(Value(500), true), 0.25, 0.03);
+  EXPECT_NEAR(stats.greater_selectivity(Value(2.5f), false), 0.5 + 0.5 * 997 / 1000, 0.03);
+  EXPECT_EQ(stats.less_selectivity(Value(0), false), 0);
+  EXPECT_EQ(stats.less_selectivity(Value(999), true), 1);
+  EXPECT_EQ(stats.equal_selectivity(Value("abc")), ColumnStats::DEFAULT_EQUAL_SEL);
+
+  // 只采样了十分之一的行，按 Duj1 推算整张表的 NDV
+  ColumnStatsCollector sample_collector("b", AttrType::INTS);
+  Column               sample_column(AttrType::INTS, sizeof(int), rows / 10);
+  for (int i = 0; i < rows / 10; i++) {
+    int v = i;
+    sample_column.append_one((const char *)&v);
+  }
+  sample_collector.add(sample_column, rows / 10);
+  ColumnStats sample_stats;
+  sample_collector.finish(rows, sample_stats);
+  EXPECT_GT(sample_stats.ndv, rows / 2);
+  EXPECT_LE(sample_stats.ndv, rows);
+}
+
+TEST(CatalogTest, column_stats_merge)
+{
+  // 两个线程各自收集一半的行，合并之后与一个线程收集所有的行得到的结果接近
+  const int            rows = 80000;
+  ColumnStatsCollector single("a", AttrType::INTS);
+  ColumnStatsCollector left("a", AttrType::INTS, 1);
+  ColumnStatsCollector right("a", AttrType::INTS, 2);
+  Column               all_column(AttrType::INTS, sizeof(int), rows);
+  Column               left_column(AttrType::INTS, sizeof(int), rows / 4);
+  Column               right_column(AttrType::INTS, sizeof(int), rows * 3 / 4);
+  for (int i = 0; i < rows; i++) {
+    int v = i % 4 == 0 ? i % 2000 : 5000 + i % 20;
+    all_column.append_one((const char *)&v);
+    (i < rows / 4 ? left_column : right_column).append_one((const char *)&v);
+  }
+  single.add(all_column, rows);
+  left.add(left_column, rows / 4);
+  right.add(right_column, rows * 3 / 4);
+  left.merge(right);
+  EXPECT_EQ(left.rows(), rows);
+
+  ColumnStats expected;
+  ColumnStats merged;
+  single.finish(rows, expected);
+  left.finish(rows, merged);
+  EXPECT_NEAR(merged.ndv, expected.ndv, expected.ndv * 0.05);
+  EXPECT_EQ(merged.min_value.get_int(), 0);
+  EXPECT_EQ(merged.max_value.get_int(), 5019);
+  EXPECT_NEAR(merged.equal_selectivity(Value(5003)), expected.equal_selectivity(Value(5003)), 0.01);
+  EXPECT_NEAR(merged.less_selectivity(Value(1000), false), expected.less_selectivity(Value(1000), false), 0.02);
+  EXPECT_NEAR(merged.less_selectivity(Value(1000), false), 0.125, 0.02);
+}
+
+TEST(CatalogTest, table_stats_serialize)
+{
+  TableStats stats(4);
+  ColumnStatsCollector int_collector("x", AttrType::INTS);
+  ColumnStatsCollector char_collector("y", AttrType::CHARS);
+  Column               int_column(AttrType::INTS, sizeof(int), 4);
+  Column               char_column(AttrType::CHARS, 4, 4);
+  const int            ints[]  = {1, 2, 2, 3};
+  const char          *chars[] = {"aa", "bb", "bb", "cc"};
+  for (int i = 0; i < 4; i++) {
+    char buf[4] = {0};
+    strncpy(buf, chars[i], sizeof(buf));
+    int_column.append_one((const char *)&ints[i]);
+    char_column.append_one(buf);
+  }
+  int_collector.add(int_column, 4);
+  char_collector.add(char_column, 4);
+  stats.column_stats.resize(2);
+  int_collector.finish(4, stats.column_stats[0]);
+  char_collector.finish(4, stats.column_stats[1]);
+  EXPECT_EQ(stats.column_stats[0].ndv, 3);
+
+  stringstream ss;
+  ASSERT_GT(stats.serialize(ss), 0);
+  TableStats loaded;
+  ASSERT_GE(loaded.deserialize(ss), 0);
+  EXPECT_EQ(loaded.row_nums, 4);
+  ASSERT_EQ(loaded.column_stats.size(), 2);
+
+  const ColumnStats *x = loaded.find_column_stats("x");
+  const ColumnStats *y = loaded.find_column_stats("y");
+  ASSERT_NE(x, nullptr);
+  ASSERT_NE(y, nullptr);
+  EXPECT_EQ(loaded.find_column_stats("z"), nullptr);
+  EXPECT_EQ(x->attr_type, AttrType::INTS);
+  EXPECT_EQ(x->max_value.get_int(), 3);
+  EXPECT_EQ(x->ndv, 3);
+  EXPECT_EQ(x->histogram_bounds.size(), stats.column_stats[0].histogram_bounds.size());
+  EXPECT_EQ(y->min_value.get_string(), "aa");
+  EXPECT_DOUBLE_EQ(y->equal_selectivity(Value("bb")), stats.column_stats[1].equal_selectivity(Value("bb")));
+  EXPECT_EQ(y->equal_selectivity(Value("zz")), 0);
+}
+
 int main(int argc, char **argv)
 {
 
@@ -60,6 +60,192 @@ TEST(ChunkTest, chunk_test)
   }
 }
 
+TEST(ChunkTest, selection_test)
+{
+  int   row_num = 8;
+  Chunk chunk;
+  chunk.add_column(std::make_unique<Column>(AttrType::INTS, sizeof(int), row_num), 0);
+  chunk.add_column(std::make_unique<Column>(AttrType::CHARS, 6, row_num), 1);
+  for (int i = 0; i < row_num; i++) {
+    int value1 = i;
+    chunk.column(0).append_one((char *)&value1);
+    chunk.column(1).append_value(Value(("c" + to_string(i)).c_str()));
+  }
+
+  chunk.set_selection(vector<int>{1, 3, 4, 7});
+  ASSERT_TRUE(chunk.has_selection());
+  ASSERT_EQ(chunk.rows(), row_num);
+  ASSERT_EQ(chunk.selected_rows(), 4);
+  ASSERT_EQ(chunk.selected_row(1), 3);
+
+  // 引用时带上选择向量，压缩引用的 chunk 不会修改原来的列
+  Chunk chunk2;
+  chunk2.reference(chunk);
+  ASSERT_EQ(chunk2.selected_rows(), 4);
+  ASSERT_EQ(chunk2.compact(), RC::SUCCESS);
+  ASSERT_FALSE(chunk2.has_selection());
+  ASSERT_EQ(chunk2.rows(), 4);
+  vector<int> expected = {1, 3, 4, 7};
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(chunk2.get_value(0, i).get_int(), expected[i]);
+    ASSERT_EQ(chunk2.get_value(1, i).get_string(), "c" + to_string(expected[i]));
+  }
+  for (int i = 0; i < row_num; i++) {
+    ASSERT_EQ(chunk.get_value(0, i).get_int(), i);
+  }
+
+  // 在选择向量上做 limit
+  chunk.limit(2);
+  ASSERT_EQ(chunk.selected_rows(), 2);
+  ASSERT_EQ(chunk.rows(), row_num);
+
+  // 持有内存的 chunk 原地压缩
+  ASSERT_EQ(chunk.compact(), RC::SUCCESS);
+  ASSERT_EQ(chunk.rows(), 2);
+  ASSERT_EQ(chunk.get_value(0, 0).get_int(), 1);
+  ASSERT_EQ(chunk.get_value(0, 1).get_int(), 3);
+  ASSERT_EQ(chunk.get_value(1, 1).get_string(), "c3");
+
+  chunk.reset_data();
+  ASSERT_FALSE(chunk.has_selection());
+}
+
+TEST(ChunkTest, null_test)
+{
+  const int row_num = 100;
+  Column    column(AttrType::INTS, sizeof(int), row_num);
+  ASSERT_FALSE(column.has_nulls());
+  ASSERT_EQ(column.null_mask(), nullptr);
+  for (int i = 0; i < row_num; i++) {
+    if (i % 3 == 0) {
+      ASSERT_EQ(column.append_null(), RC::SUCCESS);
+    } else {
+      ASSERT_EQ(column.append_one((char *)&i), RC::SUCCESS);
+    }
+  }
+  ASSERT_TRUE(column.has_nulls());
+  ASSERT_EQ(column.count(), row_num);
+  for (int i = 0; i < row_num; i++) {
+    ASSERT_EQ(column.is_null(i), i % 3 == 0);
+    if (i % 3 == 0) {
+      ASSERT_EQ(column.get_value(i).attr_type(), AttrType::UNDEFINED);
+    } else {
+      ASSERT_EQ(column.get_value(i).get_int(), i);
+    }
+  }
+
+  // 拷贝与引用都带上掩码
+  Column copied(column);
+  Column referenced;
+  referenced.reference(column);
+  for (int i = 0; i < row_num; i++) {
+    ASSERT_EQ(copied.is_null(i), i % 3 == 0);
+    ASSERT_EQ(referenced.is_null(i), i % 3 == 0);
+  }
+
+  // 压缩时掩码跟着数据一起移动
+  vector<int> selection;
+  for (int i = 1; i < row_num; i += 2) {
+    selection.push_back(i);
+  }
+  ASSERT_EQ(column.compact(selection.data(), static_cast<int>(selection.size())), RC::SUCCESS);
+  for (size_t i = 0; i < selection.size(); i++) {
+    ASSERT_EQ(column.is_null(i), selection[i] % 3 == 0);
+    if (selection[i] % 3 != 0) {
+      ASSERT_EQ(column.get_value(i).get_int(), selection[i]);
+    }
+  }
+
+  // 合并两个输入的掩码
+  Column merged(AttrType::INTS, sizeof(int), row_num);
+  merged.set_count(row_num);
+  Column constant;
+  constant.init(Value(1), row_num);
+  merged.merge_nulls(copied, constant);
+  for (int i = 0; i < row_num; i++) {
+    ASSERT_EQ(merged.is_null(i), i % 3 == 0);
+  }
+  constant.set_null(0);
+  merged.merge_nulls(copied, constant);
+  for (int i = 0; i < row_num; i++) {
+    ASSERT_TRUE(merged.is_null(i));
+  }
+
+  column.reset_data();
+  ASSERT_FALSE(column.has_nulls());
+}
+
+TEST(ChunkTest, memory_pool_test)
+{
+  ColumnMemoryPool pool;
+
+  // 释放的内存块按大小复用
+  size_t capacity = 0;
+  char  *block    = pool.allocate(100, capacity);
+  ASSERT_EQ(capacity, 128);
+  pool.deallocate(block, capacity);
+  ASSERT_EQ(pool.free_blocks(), 1);
+  size_t reused_capacity = 0;
+  ASSERT_EQ(pool.allocate(120, reused_capacity), block);
+  ASSERT_EQ(reused_capacity, capacity);
+  ASSERT_EQ(pool.free_blocks(), 0);
+  pool.deallocate(block, reused_capacity);
+
+  // 列重新初始化时复用自己的内存，释放时归还给内存池
+  {
+    Column column(&pool);
+    column.init(AttrType::INTS, sizeof(int), 1024);
+    char *data = column.data();
+    for (int i = 0; i < 1024; i++) {
+      ASSERT_EQ(column.append_one((char *)&i), RC::SUCCESS);
+    }
+    column.init(AttrType::FLOATS, sizeof(float), 512);
+    ASSERT_EQ(column.data(), data);
+    ASSERT_EQ(column.count(), 0);
+    ASSERT_EQ(column.capacity(), 512);
+    ASSERT_EQ(column.attr_type(), AttrType::FLOATS);
+
+    // 压缩引用其它列的数据时，新的内存也从内存池中申请
+    Column source(AttrType::INTS, sizeof(int), 16);
+    for (int i = 0; i < 16; i++) {
+      source.append_one((char *)&i);
+    }
+    column.reference(source);
+    const size_t usage = pool.memory_usage();
+    vector<int>  selection{1, 3, 5};
+    ASSERT_EQ(column.compact(selection.data(), 3), RC::SUCCESS);
+    ASSERT_EQ(pool.memory_usage(), usage);
+    ASSERT_EQ(column.get_value(2).get_int(), 5);
+    ASSERT_EQ(source.get_value(2).get_int(), 2);
+  }
+  ASSERT_GT(pool.free_blocks(), 0);
+
+  // 稳定之后反复计算同样大小的列不会再申请内存
+  size_t usage = 0;
+  for (int round = 0; round < 10; round++) {
+    Column column(&pool);
+    column.init(AttrType::INTS, sizeof(int), 1024);
+    Column other(&pool);
+    other.init(AttrType::INTS, sizeof(int), 1000);
+    if (round == 0) {
+      usage = pool.memory_usage();
+    }
+  }
+  ASSERT_EQ(pool.memory_usage(), usage);
+
+  // 引用其它 chunk 时复用已有的列对象，内存池也一起引用
+  Chunk source;
+  source.set_memory_pool(&pool);
+  source.add_column(make_unique<Column>(AttrType::INTS, sizeof(int), 8), 3);
+  Chunk chunk;
+  chunk.reference(source);
+  Column *column = chunk.column_ptr(0);
+  chunk.reference(source);
+  ASSERT_EQ(chunk.column_ptr(0), column);
+  ASSERT_EQ(chunk.column_ids(0), 3);
+  ASSERT_EQ(chunk.memory_pool(), &pool);
+}
+
 int main(int argc, char **argv)
 {
 
@@ -0,0 +1,67 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "catalog/column_stats.h"
+#include "sql/expr/expression.h"
+#include "sql/optimizer/cascade/cost_model.h"
+#include "sql/optimizer/cascade/selectivity.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+TEST(CostModel, pages)
+{
+  ASSERT_EQ(CostModel::pages(0, 16), 1);
+  ASSERT_EQ(CostModel::pages(100, 16), 1);
+  ASSERT_GT(CostModel::pages(100000, 16), CostModel::pages(10000, 16));
+  ASSERT_GT(CostModel::pages(10000, 64), CostModel::pages(10000, 16));
+}
+
+TEST(CostModel, index_scan_versus_seq_scan)
+{
+  CostModel    cm;
+  const double rows     = 1000000;
+  const double pages    = CostModel::pages(rows, 16);
+  const double seq_cost = cm.seq_scan(rows, pages);
+
+  // 点查与很小的范围使用索引
+  ASSERT_LT(cm.index_scan(rows, pages, 1), seq_cost);
+  ASSERT_LT(cm.index_scan(rows, pages, 100), seq_cost);
+  // 匹配的行较多时，随机读取的页面比顺序扫描全表更慢
+  ASSERT_GT(cm.index_scan(rows, pages, rows * 0.1), seq_cost);
+  ASSERT_GT(cm.index_scan(rows, pages, rows), seq_cost);
+
+  // 匹配的行越多代价越高
+  double last_cost = 0;
+  for (double matched : {0.0, 1.0, 10.0, 1000.0, 100000.0, rows}) {
+    const double cost = cm.index_scan(rows, pages, matched);
+    ASSERT_GT(cost, last_cost);
+    last_cost = cost;
+  }
+}
+
+TEST(CostModel, range_selectivity_without_stats)
+{
+  FieldMeta field_meta("a", AttrType::INTS, 0, sizeof(int), true, 0);
+  FieldExpr field(Field(nullptr, &field_meta));
+  Value     one(1);
+  Value     five(5);
+
+  ASSERT_DOUBLE_EQ(SelectivityEstimator::range_selectivity(field, &one, true, &one, true), ColumnStats::DEFAULT_EQUAL_SEL);
+  ASSERT_DOUBLE_EQ(SelectivityEstimator::range_selectivity(field, &one, false, nullptr, true), ColumnStats::DEFAULT_RANGE_SEL);
+  ASSERT_DOUBLE_EQ(SelectivityEstimator::range_selectivity(field, &one, true, &five, false),
+      ColumnStats::DEFAULT_RANGE_SEL * ColumnStats::DEFAULT_RANGE_SEL);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,7 +14,9 @@ See the Mulan PSL v2 for more details. */
 
 #include <memory>
 
+#include "sql/expr/aggregate_state.h"
 #include "sql/expr/expression.h"
+#include "sql/expr/expression_program.h"
 #include "sql/expr/tuple.h"
 #include "gtest/gtest.h"
 
@@ -307,6 +309,183 @@ TEST(ComparisonExpr, comparison_expr_test)
   }
 }
 
+namespace {
+/// 构造一个 chunk：第 0 列是 0..count-1 的 int，第 1 列是 "name_<i % 10>" 的 chars
+void make_predicate_chunk(int count, Chunk &chunk)
+{
+  auto int_column  = std::make_unique<Column>(AttrType::INTS, sizeof(int), count);
+  auto char_column = std::make_unique<Column>(AttrType::CHARS, 8, count);
+  for (int i = 0; i < count; ++i) {
+    int_column->append_one((char *)&i);
+    char_column->append_value(Value(("name_" + to_string(i % 10)).c_str()));
+  }
+  chunk.add_column(std::move(int_column), 0);
+  chunk.add_column(std::move(char_column), 1);
+}
+
+unique_ptr<Expression> make_field_expr(FieldMeta &field_meta) { return std::make_unique<FieldExpr>(Field(nullptr, &field_meta)); }
+
+unique_ptr<Expression> make_comparison(CompOp op, FieldMeta &field_meta, int value)
+{
+  return std::make_unique<ComparisonExpr>(op, make_field_expr(field_meta), std::make_unique<ValueExpr>(Value(value)));
+}
+}  // namespace
+
+TEST(PredicateExpr, predicate_eval_test)
+{
+  const int count = 1000;
+  Chunk     chunk;
+  make_predicate_chunk(count, chunk);
+  FieldMeta int_meta("id", AttrType::INTS, 0, sizeof(int), true, 0);
+  FieldMeta char_meta("name", AttrType::CHARS, sizeof(int), 8, true, 1);
+
+  auto check = [&](Expression &expr, function<bool(int)> expected) {
+    vector<uint8_t> select(count, 1);
+    ASSERT_EQ(expr.eval(chunk, select), RC::SUCCESS);
+    for (int i = 0; i < count; ++i) {
+      ASSERT_EQ(select[i], expected(i) ? 1 : 0) << "row=" << i << ", expr type=" << static_cast<int>(expr.type());
+    }
+  };
+
+  // id < 100 or id > 900 or id = 500
+  {
+    vector<unique_ptr<Expression>> children;
+    children.push_back(make_comparison(CompOp::LESS_THAN, int_meta, 100));
+    children.push_back(make_comparison(CompOp::GREAT_THAN, int_meta, 900));
+    children.push_back(make_comparison(CompOp::EQUAL_TO, int_meta, 500));
+    ConjunctionExpr expr(ConjunctionExpr::Type::OR, children);
+    check(expr, [](int i) { return i < 100 || i > 900 || i == 500; });
+  }
+  // id > 100 and id < 200，以及被第一个条件全部过滤掉的情况
+  {
+    vector<unique_ptr<Expression>> children;
+    children.push_back(make_comparison(CompOp::GREAT_THAN, int_meta, 100));
+    children.push_back(make_comparison(CompOp::LESS_THAN, int_meta, 200));
+    ConjunctionExpr expr(ConjunctionExpr::Type::AND, children);
+    check(expr, [](int i) { return i > 100 && i < 200; });
+
+    children.push_back(make_comparison(CompOp::GREAT_THAN, int_meta, count));
+    children.push_back(make_comparison(CompOp::LESS_THAN, int_meta, 10));
+    ConjunctionExpr empty_expr(ConjunctionExpr::Type::AND, children);
+    check(empty_expr, [](int i) { return false; });
+  }
+  // not (id >= 10)
+  {
+    NotExpr expr(make_comparison(CompOp::GREAT_EQUAL, int_meta, 10));
+    check(expr, [](int i) { return i < 10; });
+  }
+  // id in (...)，分别使用逐个比较与哈希表
+  {
+    InExpr small_expr(make_field_expr(int_meta), {Value(3), Value(17), Value(999), Value(3), Value(-1)});
+    check(small_expr, [](int i) { return i == 3 || i == 17 || i == 999; });
+
+    vector<Value> values;
+    for (int i = 0; i < count * 2; i += 7) {
+      values.emplace_back(i);
+    }
+    InExpr large_expr(make_field_expr(int_meta), values);
+    check(large_expr, [](int i) { return i % 7 == 0; });
+
+    InExpr string_expr(make_field_expr(char_meta), {Value("name_1"), Value("name_7"), Value("name_")});
+    check(string_expr, [](int i) { return i % 10 == 1 || i % 10 == 7; });
+  }
+  // id between 123 and 456
+  {
+    BetweenExpr expr(make_field_expr(int_meta), Value(123), Value(456));
+    check(expr, [](int i) { return i >= 123 && i <= 456; });
+
+    BetweenExpr string_expr(make_field_expr(char_meta), Value("name_2"), Value("name_4"));
+    check(string_expr, [](int i) { return i % 10 >= 2 && i % 10 <= 4; });
+  }
+  // name like ...
+  {
+    LikeExpr prefix(make_field_expr(char_meta), "name%");
+    check(prefix, [](int i) { return true; });
+    LikeExpr suffix(make_field_expr(char_meta), "%_3");
+    check(suffix, [](int i) { return i % 10 == 3; });
+    LikeExpr contains(make_field_expr(char_meta), "%me_5%");
+    check(contains, [](int i) { return i % 10 == 5; });
+    LikeExpr exact(make_field_expr(char_meta), "name_6");
+    check(exact, [](int i) { return i % 10 == 6; });
+    LikeExpr generic(make_field_expr(char_meta), "n%e__");
+    check(generic, [](int i) { return true; });
+    LikeExpr none(make_field_expr(char_meta), "%x%");
+    check(none, [](int i) { return false; });
+  }
+  // name > 'name_5'
+  {
+    ComparisonExpr expr(CompOp::GREAT_THAN, make_field_expr(char_meta), std::make_unique<ValueExpr>(Value("name_5")));
+    check(expr, [](int i) { return i % 10 > 5; });
+  }
+}
+
+TEST(PredicateExpr, null_test)
+{
+  // 第 0 列为 id，id % 3 == 0 的行为 NULL
+  const int count  = 1000;
+  auto      column = std::make_unique<Column>(AttrType::INTS, sizeof(int), count);
+  for (int i = 0; i < count; ++i) {
+    if (i % 3 == 0) {
+      column->append_null();
+    } else {
+      column->append_one((char *)&i);
+    }
+  }
+  Chunk chunk;
+  chunk.add_column(std::move(column), 0);
+  FieldMeta int_meta("id", AttrType::INTS, 0, sizeof(int), true, 0);
+
+  // id + 1 的结果也是 NULL
+  ArithmeticExpr add(ArithmeticExpr::Type::ADD, make_field_expr(int_meta), std::make_unique<ValueExpr>(Value(1)));
+  Column         result;
+  ASSERT_EQ(add.get_column(chunk, result), RC::SUCCESS);
+  ASSERT_TRUE(result.has_nulls());
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(result.is_null(i), i % 3 == 0);
+    if (i % 3 != 0) {
+      ASSERT_EQ(result.get_value(i).get_int(), i + 1);
+    }
+  }
+
+  // NULL 参与比较时不满足条件
+  auto check = [&](Expression &expr, function<bool(int)> expected) {
+    vector<uint8_t> select(count, 1);
+    ASSERT_EQ(expr.eval(chunk, select), RC::SUCCESS);
+    for (int i = 0; i < count; ++i) {
+      ASSERT_EQ(select[i], i % 3 != 0 && expected(i) ? 1 : 0) << "row=" << i;
+    }
+  };
+  ComparisonExpr greater(CompOp::GREAT_EQUAL, make_field_expr(int_meta), std::make_unique<ValueExpr>(Value(0)));
+  check(greater, [](int i) { return true; });
+  BetweenExpr between(make_field_expr(int_meta), Value(100), Value(200));
+  check(between, [](int i) { return i >= 100 && i <= 200; });
+  InExpr in(make_field_expr(int_meta), {Value(0), Value(3), Value(4)});
+  check(in, [](int i) { return i == 4; });
+}
+
+TEST(PredicateExpr, like_pattern_test)
+{
+  ASSERT_EQ(LikePattern("abc%").kind(), LikePattern::Kind::PREFIX);
+  ASSERT_EQ(LikePattern("%abc").kind(), LikePattern::Kind::SUFFIX);
+  ASSERT_EQ(LikePattern("%abc%").kind(), LikePattern::Kind::CONTAINS);
+  ASSERT_EQ(LikePattern("abc").kind(), LikePattern::Kind::EXACT);
+  ASSERT_EQ(LikePattern("a%b%c").kind(), LikePattern::Kind::GENERIC);
+
+  ASSERT_TRUE(LikePattern("a%b%c").match("aXXbYYc"));
+  ASSERT_FALSE(LikePattern("a%b%c").match("aXXbYYcd"));
+  ASSERT_TRUE(LikePattern("%%").match(""));
+  ASSERT_TRUE(LikePattern("_b_").match("abc"));
+  ASSERT_FALSE(LikePattern("_b_").match("abcd"));
+
+  // 较长的字符串会走分块的子串查找
+  string text(200, 'a');
+  text.replace(150, 6, "needle");
+  ASSERT_TRUE(LikePattern("%needle%").match(text));
+  ASSERT_FALSE(LikePattern("%needles%").match(text));
+  ASSERT_TRUE(LikePattern("%a%").match(text));
+  ASSERT_TRUE(LikePattern::contains(text.data(), text.size(), "e"));
+}
+
 TEST(AggregateExpr, aggregate_expr_test)
 {
   Value                  int_value(1);
@@ -334,6 +513,239 @@ TEST(AggregateExpr, aggregate_expr_test)
   ASSERT_EQ(RC::INVALID_ARGUMENT, AggregateExpr::type_from_string("invalid type", aggr_type));
 }
 
+TEST(AggregateExpr, null_aggregate_test)
+{
+  // 值为 i，i % 4 == 0 的行为 NULL；分组为 i % 4，所以第 0 组只有 NULL
+  const int count = 100;
+  Column    column(AttrType::INTS, sizeof(int), count);
+  vector<int> group_ids;
+  for (int i = 0; i < count; ++i) {
+    if (i % 4 == 0) {
+      column.append_null();
+    } else {
+      column.append_one((char *)&i);
+    }
+    group_ids.push_back(i % 4);
+  }
+
+  SumState<int> sum_state;
+  ASSERT_EQ(aggregate_state_update_by_column(&sum_state, AggregateExpr::Type::SUM, AttrType::INTS, column), RC::SUCCESS);
+  CountState<int> count_state;
+  ASSERT_EQ(
+      aggregate_state_update_by_column(&count_state, AggregateExpr::Type::COUNT, AttrType::INTS, column), RC::SUCCESS);
+  int expected_sum = 0;
+  for (int i = 0; i < count; ++i) {
+    expected_sum += i % 4 == 0 ? 0 : i;
+  }
+  ASSERT_EQ(sum_state.value, expected_sum);
+  ASSERT_EQ(count_state.value, count * 3 / 4);
+
+  for (AggregateExpr::Type type :
+      {AggregateExpr::Type::SUM, AggregateExpr::Type::COUNT, AggregateExpr::Type::AVG, AggregateExpr::Type::MAX}) {
+    unique_ptr<GroupedAggregateState> state = create_grouped_aggregate_state(type, AttrType::INTS, sizeof(int));
+    ASSERT_NE(state, nullptr);
+    state->resize(4);
+    state->update(column, group_ids.data(), count);
+    Column output(type == AggregateExpr::Type::AVG ? AttrType::FLOATS : AttrType::INTS, 4, 4);
+    ASSERT_EQ(state->finalize(0, 4, output), RC::SUCCESS);
+    ASSERT_EQ(output.is_null(0), type != AggregateExpr::Type::COUNT);
+    for (int group = 1; group < 4; group++) {
+      ASSERT_FALSE(output.is_null(group));
+    }
+    if (type == AggregateExpr::Type::COUNT) {
+      ASSERT_EQ(output.get_value(0).get_int(), 0);
+      ASSERT_EQ(output.get_value(1).get_int(), count / 4);
+    } else if (type == AggregateExpr::Type::MAX) {
+      ASSERT_EQ(output.get_value(3).get_int(), count - 1);
+    }
+  }
+}
+
+TEST(ExpressionProgram, fused_filter_test)
+{
+  // 第 0、1、2 列为 int，第 3 列为 float，行数不是 TILE_ROWS 的整数倍
+  const int count = ExpressionProgram::TILE_ROWS * 2 + 100;
+  Chunk     chunk;
+  {
+    auto a = std::make_unique<Column>(AttrType::INTS, sizeof(int), count);
+    auto b = std::make_unique<Column>(AttrType::INTS, sizeof(int), count);
+    auto c = std::make_unique<Column>(AttrType::INTS, sizeof(int), count);
+    auto d = std::make_unique<Column>(AttrType::FLOATS, sizeof(float), count);
+    for (int i = 0; i < count; ++i) {
+      int   a_value = i % 97;
+      int   b_value = i % 13 - 6;
+      int   c_value = i;
+      float d_value = i * 0.5f;
+      a->append_one((char *)&a_value);
+      b->append_one((char *)&b_value);
+      c->append_one((char *)&c_value);
+      d->append_one((char *)&d_value);
+    }
+    chunk.add_column(std::move(a), 0);
+    chunk.add_column(std::move(b), 1);
+    chunk.add_column(std::move(c), 2);
+    chunk.add_column(std::move(d), 3);
+  }
+  FieldMeta a_meta("a", AttrType::INTS, 0, sizeof(int), true, 0);
+  FieldMeta b_meta("b", AttrType::INTS, 0, sizeof(int), true, 1);
+  FieldMeta c_meta("c", AttrType::INTS, 0, sizeof(int), true, 2);
+  FieldMeta d_meta("d", AttrType::FLOATS, 0, sizeof(float), true, 3);
+
+  // cast(a * b + c as float) > d and c < count - 50
+  vector<unique_ptr<Expression>> predicates;
+  auto mul = std::make_unique<ArithmeticExpr>(ArithmeticExpr::Type::MUL, make_field_expr(a_meta), make_field_expr(b_meta));
+  auto add = std::make_unique<ArithmeticExpr>(ArithmeticExpr::Type::ADD, std::move(mul), make_field_expr(c_meta));
+  auto cast = std::make_unique<CastExpr>(std::move(add), AttrType::FLOATS);
+  predicates.push_back(std::make_unique<ComparisonExpr>(CompOp::GREAT_THAN, std::move(cast), make_field_expr(d_meta)));
+  predicates.push_back(make_comparison(CompOp::LESS_THAN, c_meta, count - 50));
+
+  ExpressionProgram program;
+  ASSERT_EQ(program.compile_filter(predicates), RC::SUCCESS);
+  ASSERT_TRUE(program.compiled());
+
+  vector<uint8_t> fused(count, 1);
+  vector<uint8_t> expected(count, 1);
+  fused[7] = expected[7] = 0;
+  ASSERT_EQ(program.filter(chunk, fused), RC::SUCCESS);
+  for (unique_ptr<Expression> &predicate : predicates) {
+    ASSERT_EQ(predicate->eval(chunk, expected), RC::SUCCESS);
+  }
+  for (int i = 0; i < count; ++i) {
+    const bool match = i != 7 && (i % 97) * (i % 13 - 6) + i > i * 0.5f && i < count - 50;
+    ASSERT_EQ(expected[i], match ? 1 : 0) << "row=" << i;
+    ASSERT_EQ(fused[i], expected[i]) << "row=" << i;
+  }
+
+  // 数值表达式直接写到输出列
+  ExpressionProgram value_program;
+  ArithmeticExpr    sub(ArithmeticExpr::Type::SUB, make_field_expr(c_meta), make_field_expr(d_meta));
+  ASSERT_EQ(value_program.compile_value(&sub), RC::SUCCESS);
+  Column fused_column;
+  Column expected_column;
+  ASSERT_EQ(value_program.get_column(chunk, fused_column), RC::SUCCESS);
+  ASSERT_EQ(sub.get_column(chunk, expected_column), RC::SUCCESS);
+  ASSERT_EQ(fused_column.attr_type(), AttrType::FLOATS);
+  ASSERT_EQ(fused_column.count(), count);
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(fused_column.get_value(i).get_float(), expected_column.get_value(i).get_float()) << "row=" << i;
+  }
+
+  // 单独一个字段不需要编译
+  ExpressionProgram field_program;
+  auto              field = make_field_expr(a_meta);
+  ASSERT_EQ(field_program.compile_value(field.get()), RC::UNSUPPORTED);
+}
+
+TEST(ExpressionProgram, fallback_test)
+{
+  const int count = 1000;
+  Chunk     chunk;
+  make_predicate_chunk(count, chunk);
+  FieldMeta int_meta("id", AttrType::INTS, 0, sizeof(int), true, 0);
+  FieldMeta char_meta("name", AttrType::CHARS, sizeof(int), 8, true, 1);
+
+  // 字符串比较不能编译，按原表达式计算
+  vector<unique_ptr<Expression>> predicates;
+  predicates.push_back(make_comparison(CompOp::GREAT_EQUAL, int_meta, 500));
+  predicates.push_back(
+      std::make_unique<ComparisonExpr>(CompOp::GREAT_THAN, make_field_expr(char_meta), std::make_unique<ValueExpr>(Value("name_5"))));
+  ExpressionProgram program;
+  ASSERT_EQ(program.compile_filter(predicates), RC::UNSUPPORTED);
+  ASSERT_FALSE(program.compiled());
+  vector<uint8_t> select(count, 1);
+  ASSERT_EQ(program.filter(chunk, select), RC::SUCCESS);
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(select[i], i >= 500 && i % 10 > 5 ? 1 : 0) << "row=" << i;
+  }
+
+  // 执行时列中有 NULL 也按原表达式计算
+  Chunk null_chunk;
+  auto  column = std::make_unique<Column>(AttrType::INTS, sizeof(int), count);
+  for (int i = 0; i < count; ++i) {
+    if (i % 3 == 0) {
+      column->append_null();
+    } else {
+      column->append_one((char *)&i);
+    }
+  }
+  null_chunk.add_column(std::move(column), 0);
+  vector<unique_ptr<Expression>> int_predicates;
+  int_predicates.push_back(make_comparison(CompOp::GREAT_EQUAL, int_meta, 500));
+  ExpressionProgram int_program;
+  ASSERT_EQ(int_program.compile_filter(int_predicates), RC::SUCCESS);
+  select.assign(count, 1);
+  ASSERT_EQ(int_program.filter(null_chunk, select), RC::SUCCESS);
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(select[i], i >= 500 && i % 3 != 0 ? 1 : 0) << "row=" << i;
+  }
+
+  // 整数溢出
+  vector<unique_ptr<Expression>> overflow_predicates;
+  overflow_predicates.push_back(std::make_unique<ComparisonExpr>(CompOp::GREAT_THAN,
+      std::make_unique<ArithmeticExpr>(
+          ArithmeticExpr::Type::MUL, make_field_expr(int_meta), std::make_unique<ValueExpr>(Value(INT32_MAX))),
+      std::make_unique<ValueExpr>(Value(0))));
+  ExpressionProgram overflow_program;
+  ASSERT_EQ(overflow_program.compile_filter(overflow_predicates), RC::SUCCESS);
+  select.assign(count, 1);
+  ASSERT_EQ(overflow_program.filter(chunk, select), RC::RANGE_ERROR);
+}
+
+TEST(ExpressionProgram, overflow_on_filtered_rows)
+{
+  // 第 0 列为 id，第 1 列 a 与 id 相同，只有最后一行 a + a 会溢出
+  const int count = ExpressionProgram::TILE_ROWS + 10;
+  Chunk     chunk;
+  auto      id = std::make_unique<Column>(AttrType::INTS, sizeof(int), count);
+  auto      a  = std::make_unique<Column>(AttrType::INTS, sizeof(int), count);
+  for (int i = 0; i < count; ++i) {
+    int a_value = i == count - 1 ? 2000000000 : i;
+    id->append_one((char *)&i);
+    a->append_one((char *)&a_value);
+  }
+  chunk.add_column(std::move(id), 0);
+  chunk.add_column(std::move(a), 1);
+  FieldMeta id_meta("id", AttrType::INTS, 0, sizeof(int), true, 0);
+  FieldMeta a_meta("a", AttrType::INTS, 0, sizeof(int), true, 1);
+
+  // id < count - 1 and a + a > 0：溢出的行已经被第一个谓词过滤掉了
+  vector<unique_ptr<Expression>> predicates;
+  predicates.push_back(make_comparison(CompOp::LESS_THAN, id_meta, count - 1));
+  predicates.push_back(std::make_unique<ComparisonExpr>(CompOp::GREAT_THAN,
+      std::make_unique<ArithmeticExpr>(ArithmeticExpr::Type::ADD, make_field_expr(a_meta), make_field_expr(a_meta)),
+      std::make_unique<ValueExpr>(Value(0))));
+  ExpressionProgram filter_program;
+  ASSERT_EQ(filter_program.compile_filter(predicates), RC::SUCCESS);
+  vector<uint8_t> select(count, 1);
+  ASSERT_EQ(filter_program.filter(chunk, select), RC::SUCCESS);
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(select[i], i > 0 && i < count - 1 ? 1 : 0) << "row=" << i;
+  }
+
+  // 投影 a + a 时只检查选择向量中的行，编译与不编译的结果相同
+  ArithmeticExpr    add(ArithmeticExpr::Type::ADD, make_field_expr(a_meta), make_field_expr(a_meta));
+  ExpressionProgram value_program;
+  ASSERT_EQ(value_program.compile_value(&add), RC::SUCCESS);
+  Column column;
+  ASSERT_EQ(value_program.get_column(chunk, column), RC::RANGE_ERROR);
+  ASSERT_EQ(add.get_column(chunk, column), RC::RANGE_ERROR);
+
+  vector<int> selection;
+  for (int i = 0; i < count - 1; i += 2) {
+    selection.push_back(i);
+  }
+  chunk.set_selection(selection);
+  ASSERT_EQ(value_program.get_column(chunk, column), RC::SUCCESS);
+  ASSERT_EQ(column.get_value(count - 2).get_int(), (count - 2) * 2);
+  ASSERT_EQ(add.get_column(chunk, column), RC::SUCCESS);
+  ASSERT_EQ(column.get_value(count - 2).get_int(), (count - 2) * 2);
+
+  selection.push_back(count - 1);
+  chunk.set_selection(selection);
+  ASSERT_EQ(value_program.get_column(chunk, column), RC::RANGE_ERROR);
+  ASSERT_EQ(add.get_column(chunk, column), RC::RANGE_ERROR);
+}
+
 int main(int argc, char **argv)
 {
 
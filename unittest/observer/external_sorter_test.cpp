@@ -0,0 +1,153 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "common/lang/memory.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/common/external_sorter.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+namespace {
+/// 构造一个 chunk：payload 为 (id int, name text)，排序列为 (name % 7 的 chars, id)
+void make_chunk(int start, int rows, int modulo, Chunk &payload, Chunk &keys)
+{
+  auto id_col   = make_unique<Column>(AttrType::INTS, sizeof(int), rows);
+  auto name_col = make_unique<Column>(AttrType::TEXTS, sizeof(string_t), rows);
+  auto key1_col = make_unique<Column>(AttrType::CHARS, 4, rows);
+  auto key2_col = make_unique<Column>(AttrType::INTS, sizeof(int), rows);
+  for (int i = start; i < start + rows; i++) {
+    // 打乱输入的顺序
+    int   id = (i * 7919) % modulo;
+    Value name;
+    name.set_text(("name_with_long_text_" + to_string(id)).c_str());
+    id_col->append_one((char *)&id);
+    name_col->append_value(name);
+    key1_col->append_value(Value(to_string(id % 7).c_str()));
+    key2_col->append_one((char *)&id);
+  }
+  payload.add_column(std::move(id_col), 0);
+  payload.add_column(std::move(name_col), 1);
+  keys.add_column(std::move(key1_col), 0);
+  keys.add_column(std::move(key2_col), 1);
+}
+
+/// 按 (id % 7 升序, id 降序) 检查排序结果，返回输出的行数
+int check_sorted(ExternalSorter &sorter)
+{
+  Chunk output;
+  output.add_column(make_unique<Column>(AttrType::INTS, sizeof(int), 1000), 0);
+  output.add_column(make_unique<Column>(AttrType::TEXTS, sizeof(string_t), 1000), 1);
+
+  int total   = 0;
+  int last_id = -1;
+  RC  rc      = RC::SUCCESS;
+  while (OB_SUCC(rc = sorter.next(output))) {
+    EXPECT_GT(output.rows(), 0);
+    for (int r = 0; r < output.rows(); r++) {
+      int id = output.get_value(0, r).get_int();
+      EXPECT_EQ(output.get_value(1, r).get_string(), "name_with_long_text_" + to_string(id));
+      if (last_id >= 0) {
+        EXPECT_TRUE(last_id % 7 < id % 7 || (last_id % 7 == id % 7 && last_id > id));
+      }
+      last_id = id;
+      total++;
+    }
+    output.reset_data();
+  }
+  EXPECT_EQ(rc, RC::RECORD_EOF);
+  return total;
+}
+}  // namespace
+
+TEST(ExternalSorterTest, sort_in_memory)
+{
+  ExternalSorter sorter({true, false}, 0);
+  for (int i = 0; i < 10; i++) {
+    Chunk payload, keys;
+    make_chunk(i * 1000, 1000, 10000, payload, keys);
+    ASSERT_EQ(sorter.add_chunk(payload, keys), RC::SUCCESS);
+  }
+  ASSERT_EQ(sorter.finish(), RC::SUCCESS);
+  ASSERT_EQ(sorter.spilled_runs(), 0);
+  ASSERT_EQ(check_sorted(sorter), 10000);
+}
+
+TEST(ExternalSorterTest, sort_with_spill)
+{
+  // 每个 chunk 都会形成一个顺串，顺串的个数超过 MAX_MERGE_WAYS，需要多趟归并
+  const int      chunk_num = ExternalSorter::MAX_MERGE_WAYS * 2 + 3;
+  ExternalSorter sorter({true, false}, 1);
+  for (int i = 0; i < chunk_num; i++) {
+    Chunk payload, keys;
+    make_chunk(i * 100, 100, chunk_num * 100, payload, keys);
+    ASSERT_EQ(sorter.add_chunk(payload, keys), RC::SUCCESS);
+  }
+  ASSERT_EQ(sorter.finish(), RC::SUCCESS);
+  ASSERT_EQ(sorter.spilled_runs(), chunk_num);
+  ASSERT_EQ(check_sorted(sorter), chunk_num * 100);
+}
+
+TEST(ExternalSorterTest, normalized_keys)
+{
+  // 排序列覆盖各种类型，与逐行使用 Value::compare 排序的结果对比
+  const int        rows = 5000;
+  vector<AttrType> types{AttrType::INTS, AttrType::FLOATS, AttrType::BIGINTS, AttrType::CHARS, AttrType::TEXTS};
+  vector<int>      lens{4, 4, 8, 6, sizeof(string_t)};
+  for (size_t t = 0; t < types.size(); t++) {
+    for (bool asc : {true, false}) {
+      Chunk payload, keys;
+      auto  id_col  = make_unique<Column>(AttrType::INTS, sizeof(int), rows);
+      auto  key_col = make_unique<Column>(types[t], lens[t], rows);
+      auto  tie_col = make_unique<Column>(AttrType::INTS, sizeof(int), rows);
+      for (int i = 0; i < rows; i++) {
+        // 取值范围很小，会有大量相同的值，并且包含负数
+        int   v = (i * 7919) % 201 - 100;
+        Value value;
+        switch (types[t]) {
+          case AttrType::INTS: value = Value(v * 1000); break;
+          case AttrType::FLOATS: value = Value(v == 0 && i % 2 ? -0.0f : v / 3.0f); break;
+          case AttrType::BIGINTS: value.set_bigint(static_cast<int64_t>(v) << 40); break;
+          case AttrType::CHARS: value = Value(to_string(v + 100).c_str()); break;
+          default: value.set_text(("a_long_common_prefix_" + to_string(v + 100)).c_str()); break;
+        }
+        key_col->append_value(value);
+        id_col->append_one((char *)&i);
+        tie_col->append_one((char *)&i);
+      }
+      payload.add_column(std::move(id_col), 0);
+      payload.add_column(key_col->clone(), 1);
+      keys.add_column(std::move(key_col), 0);
+      keys.add_column(std::move(tie_col), 1);
+
+      ExternalSorter sorter({asc, true}, 0);
+      ASSERT_EQ(sorter.add_chunk(payload, keys), RC::SUCCESS);
+      ASSERT_EQ(sorter.finish(), RC::SUCCESS);
+
+      Chunk output;
+      output.add_column(make_unique<Column>(AttrType::INTS, sizeof(int), rows), 0);
+      output.add_column(make_unique<Column>(types[t], lens[t], rows), 1);
+      ASSERT_EQ(sorter.next(output), RC::SUCCESS);
+      ASSERT_EQ(output.rows(), rows);
+      for (int r = 1; r < rows; r++) {
+        int cmp = output.get_value(1, r - 1).compare(output.get_value(1, r));
+        ASSERT_TRUE(asc ? cmp <= 0 : cmp >= 0)
+            << "type=" << attr_type_to_string(types[t]) << ", row=" << r;
+        if (cmp == 0) {
+          ASSERT_LT(output.get_value(0, r - 1).get_int(), output.get_value(0, r).get_int())
+              << "type=" << attr_type_to_string(types[t]) << ", row=" << r;
+        }
+      }
+      output.reset_data();
+      ASSERT_EQ(sorter.next(output), RC::RECORD_EOF);
+    }
+  }
+}
@@ -0,0 +1,213 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "common/lang/algorithm.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/hash_join_physical_operator.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+namespace {
+/// 按照下标取元组中的值
+class CellExpr : public Expression
+{
+public:
+  CellExpr(int index, AttrType type) : index_(index), type_(type) {}
+
+  unique_ptr<Expression> copy() const override { return make_unique<CellExpr>(index_, type_); }
+  ExprType               type() const override { return ExprType::NONE; }
+  AttrType               value_type() const override { return type_; }
+  RC get_value(const Tuple &tuple, Value &value) const override { return tuple.cell_at(index_, value); }
+
+private:
+  int      index_;
+  AttrType type_;
+};
+
+/// 依次输出给定的行
+class RowsPhysicalOperator : public PhysicalOperator
+{
+public:
+  explicit RowsPhysicalOperator(vector<vector<Value>> rows) : rows_(std::move(rows)) {}
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::TABLE_SCAN; }
+
+  RC open(Trx *) override
+  {
+    pos_ = 0;
+    return RC::SUCCESS;
+  }
+  RC close() override { return RC::SUCCESS; }
+
+  RC next() override
+  {
+    if (pos_ >= rows_.size()) {
+      return RC::RECORD_EOF;
+    }
+    const vector<Value> &row = rows_[pos_++];
+    vector<TupleCellSpec> specs;
+    for (size_t i = 0; i < row.size(); i++) {
+      specs.emplace_back("c" + to_string(i));
+    }
+    tuple_.set_names(specs);
+    tuple_.set_cells(row);
+    return RC::SUCCESS;
+  }
+
+  Tuple *current_tuple() override { return &tuple_; }
+
+private:
+  vector<vector<Value>> rows_;
+  size_t                pos_ = 0;
+  ValueListTuple        tuple_;
+};
+
+/// 左表 (id, a)，右表 (c)，按照 a = c 连接
+unique_ptr<HashJoinPhysicalOperator> make_join(JoinType join_type, AttrType right_type = AttrType::INTS)
+{
+  vector<unique_ptr<Expression>> left_keys;
+  vector<unique_ptr<Expression>> right_keys;
+  left_keys.emplace_back(make_unique<CellExpr>(1, AttrType::INTS));
+  right_keys.emplace_back(make_unique<CellExpr>(0, right_type));
+  auto join = make_unique<HashJoinPhysicalOperator>(join_type, std::move(left_keys), std::move(right_keys));
+
+  vector<vector<Value>> left_rows{
+      {Value(1), Value(10)}, {Value(2), Value(20)}, {Value(3), Value(30)}, {Value(4), Value(10)}};
+  vector<vector<Value>> right_rows;
+  for (int c : {10, 10, 30, 50}) {
+    right_rows.push_back({right_type == AttrType::FLOATS ? Value(static_cast<float>(c)) : Value(c)});
+  }
+  join->add_child(make_unique<RowsPhysicalOperator>(left_rows));
+  join->add_child(make_unique<RowsPhysicalOperator>(right_rows));
+  return join;
+}
+
+/// 输出的每一行的第一列
+vector<int> first_column(PhysicalOperator &oper)
+{
+  vector<int> result;
+  EXPECT_EQ(oper.open(nullptr), RC::SUCCESS);
+  RC rc = RC::SUCCESS;
+  while (OB_SUCC(rc = oper.next())) {
+    Value value;
+    EXPECT_EQ(oper.current_tuple()->cell_at(0, value), RC::SUCCESS);
+    result.push_back(value.get_int());
+  }
+  EXPECT_EQ(rc, RC::RECORD_EOF);
+  EXPECT_EQ(oper.close(), RC::SUCCESS);
+  return result;
+}
+}  // namespace
+
+TEST(HashJoin, key_type)
+{
+  ASSERT_EQ(HashJoinPhysicalOperator::key_type(AttrType::INTS, AttrType::INTS), AttrType::INTS);
+  ASSERT_EQ(HashJoinPhysicalOperator::key_type(AttrType::INTS, AttrType::BIGINTS), AttrType::BIGINTS);
+  ASSERT_EQ(HashJoinPhysicalOperator::key_type(AttrType::FLOATS, AttrType::INTS), AttrType::FLOATS);
+  ASSERT_EQ(HashJoinPhysicalOperator::key_type(AttrType::CHARS, AttrType::INTS), AttrType::CHARS);
+}
+
+TEST(HashJoin, inner)
+{
+  auto join = make_join(JoinType::INNER);
+  // 右表有两行 10，左表的 1 和 4 各输出两次
+  ASSERT_EQ(first_column(*join), (vector<int>{1, 1, 3, 4, 4}));
+}
+
+TEST(HashJoin, semi_and_anti)
+{
+  // 每行最多输出一次，重复执行得到相同的结果
+  auto semi = make_join(JoinType::SEMI);
+  ASSERT_EQ(first_column(*semi), (vector<int>{1, 3, 4}));
+  ASSERT_EQ(first_column(*semi), (vector<int>{1, 3, 4}));
+
+  auto anti = make_join(JoinType::ANTI);
+  ASSERT_EQ(first_column(*anti), (vector<int>{2}));
+
+  // 整数与浮点数的键按照浮点数比较
+  auto mixed = make_join(JoinType::SEMI, AttrType::FLOATS);
+  ASSERT_EQ(first_column(*mixed), (vector<int>{1, 3, 4}));
+}
+
+TEST(HashJoin, residual_predicate)
+{
+  // a = c and id <= c / 10：右表的 10 只能匹配 id 为 1 的行
+  auto join = make_join(JoinType::SEMI);
+  vector<unique_ptr<Expression>> predicates;
+  predicates.emplace_back(make_unique<ComparisonExpr>(LESS_EQUAL,
+      make_unique<CellExpr>(0, AttrType::INTS),
+      make_unique<ArithmeticExpr>(ArithmeticExpr::Type::DIV,
+          make_unique<CellExpr>(2, AttrType::INTS),
+          make_unique<ValueExpr>(Value(10)))));
+  join->set_predicates(std::move(predicates));
+  ASSERT_EQ(first_column(*join), (vector<int>{1, 3}));
+
+  auto anti = make_join(JoinType::ANTI);
+  predicates.clear();
+  predicates.emplace_back(make_unique<ComparisonExpr>(
+      GREAT_THAN, make_unique<CellExpr>(0, AttrType::INTS), make_unique<ValueExpr>(Value(1))));
+  anti->set_predicates(std::move(predicates));
+  ASSERT_EQ(first_column(*anti), (vector<int>{1, 2}));
+}
+
+TEST(HashJoin, reverse_build_side)
+{
+  // 左表 (id, a)，a = id % 5；右表 (c)，每个 c 有两行。估算左表只有 1 行，右表读到 1024 行时尝试交换
+  auto run = [](int left_rows, bool estimated, bool expect_reversed) {
+    vector<unique_ptr<Expression>> left_keys;
+    vector<unique_ptr<Expression>> right_keys;
+    left_keys.emplace_back(make_unique<CellExpr>(1, AttrType::INTS));
+    right_keys.emplace_back(make_unique<CellExpr>(0, AttrType::INTS));
+    HashJoinPhysicalOperator join(JoinType::INNER, std::move(left_keys), std::move(right_keys));
+
+    vector<vector<Value>> left;
+    for (int i = 0; i < left_rows; i++) {
+      left.push_back({Value(i), Value(i % 5)});
+    }
+    vector<vector<Value>> right;
+    for (int i = 0; i < 2000; i++) {
+      right.push_back({Value(i % 1000)});
+    }
+    auto left_oper = make_unique<RowsPhysicalOperator>(left);
+    if (estimated) {
+      left_oper->set_estimate(1, 1);
+    }
+    join.add_child(std::move(left_oper));
+    join.add_child(make_unique<RowsPhysicalOperator>(right));
+    join.enable_actual();
+
+    vector<int> ids = first_column(join);
+    EXPECT_EQ(join.param().find("build=left") != string::npos, expect_reversed);
+    EXPECT_EQ(join.actual_rows(), static_cast<int64_t>(ids.size()));
+    sort(ids.begin(), ids.end());
+    return ids;
+  };
+
+  vector<int> expected;
+  for (int i = 0; i < 20; i++) {
+    expected.push_back(i);
+    expected.push_back(i);
+  }
+  ASSERT_EQ(run(20, false, false), expected);
+  ASSERT_EQ(run(20, true, true), expected);
+
+  // 左表比右表读到的行多，继续用右表建表，已经读出的左表行也要输出
+  vector<int> large = run(3000, true, false);
+  ASSERT_EQ(large.size(), 6000);
+  ASSERT_EQ(large.front(), 0);
+  ASSERT_EQ(large.back(), 2999);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
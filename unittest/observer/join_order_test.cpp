@@ -0,0 +1,196 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+
+#include "common/lang/algorithm.h"
+#include "common/lang/random.h"
+#include "sql/optimizer/cascade/join_order.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+namespace {
+/// 计划中的叶子，按从左到右的顺序
+void leaves(const JoinPlanNode *node, vector<int> &relations)
+{
+  if (node->is_leaf()) {
+    relations.push_back(node->relation);
+    return;
+  }
+  leaves(node->outer, relations);
+  leaves(node->inner, relations);
+}
+
+/// 检查计划的结构：每个连接的关系集合是两个输入的并集，且输入不相交
+void check_plan(const JoinPlanNode *node)
+{
+  if (node->is_leaf()) {
+    ASSERT_EQ(node->relations, uint64_t(1) << node->relation);
+    return;
+  }
+  ASSERT_EQ(node->outer->relations & node->inner->relations, 0UL);
+  ASSERT_EQ(node->relations, node->outer->relations | node->inner->relations);
+  check_plan(node->outer);
+  check_plan(node->inner);
+}
+
+uint64_t set_of(int a, int b) { return (uint64_t(1) << a) | (uint64_t(1) << b); }
+}  // namespace
+
+TEST(JoinOrder, small_filtered_dimension_first)
+{
+  // fact 与两张维表连接，维表 1 过滤之后只有 1 行
+  CostModel           cost_model;
+  JoinOrderEnumerator enumerator(cost_model);
+  const int           fact = enumerator.add_relation(100000);
+  const int           dim1 = enumerator.add_relation(1);
+  const int           dim2 = enumerator.add_relation(1000);
+  enumerator.add_predicate(set_of(fact, dim1), 1.0 / 100);
+  enumerator.add_predicate(set_of(fact, dim2), 1.0 / 1000);
+
+  const JoinPlanNode *plan = enumerator.solve();
+  ASSERT_NE(plan, nullptr);
+  ASSERT_TRUE(enumerator.used_dp());
+  check_plan(plan);
+  ASSERT_EQ(plan->relations, 0x7UL);
+  ASSERT_DOUBLE_EQ(plan->card, 1000);
+
+  // 先连接 fact 与过滤后的维表 1，中间结果最小
+  ASSERT_FALSE(plan->outer->is_leaf());
+  ASSERT_EQ(plan->outer->relations, set_of(fact, dim1));
+  ASSERT_EQ(plan->inner->relation, dim2);
+  ASSERT_EQ(plan->outer->outer->relation, dim1);
+}
+
+TEST(JoinOrder, dpccp_enumerates_each_pair_once)
+{
+  CostModel cost_model;
+  // 链 n 个关系：(n^3 - n) / 6 个连通子图与补集的组合
+  {
+    JoinOrderEnumerator enumerator(cost_model);
+    for (int i = 0; i < 5; i++) {
+      enumerator.add_relation(100 * (i + 1));
+    }
+    for (int i = 0; i + 1 < 5; i++) {
+      enumerator.add_predicate(set_of(i, i + 1), 0.01);
+    }
+    const JoinPlanNode *plan = enumerator.solve();
+    ASSERT_NE(plan, nullptr);
+    check_plan(plan);
+    ASSERT_EQ(enumerator.enumerated_pairs(), 20);
+  }
+  // 星形 n 个关系：(n - 1) * 2^(n - 2)
+  {
+    JoinOrderEnumerator enumerator(cost_model);
+    for (int i = 0; i < 5; i++) {
+      enumerator.add_relation(100 * (i + 1));
+    }
+    for (int i = 1; i < 5; i++) {
+      enumerator.add_predicate(set_of(0, i), 0.01);
+    }
+    ASSERT_NE(enumerator.solve(), nullptr);
+    ASSERT_EQ(enumerator.enumerated_pairs(), 32);
+  }
+  // 完全图 n 个关系：(3^n - 2^(n+1) + 1) / 2
+  {
+    JoinOrderEnumerator enumerator(cost_model);
+    for (int i = 0; i < 4; i++) {
+      enumerator.add_relation(100 * (i + 1));
+    }
+    for (int i = 0; i < 4; i++) {
+      for (int j = i + 1; j < 4; j++) {
+        enumerator.add_predicate(set_of(i, j), 0.1);
+      }
+    }
+    ASSERT_NE(enumerator.solve(), nullptr);
+    ASSERT_EQ(enumerator.enumerated_pairs(), 25);
+  }
+}
+
+TEST(JoinOrder, dp_is_not_worse_than_greedy)
+{
+  CostModel cost_model;
+  mt19937   rng(1);
+  for (int round = 0; round < 20; round++) {
+    const int relation_num = 3 + round % 8;
+    vector<double> cards;
+    vector<pair<uint64_t, double>> predicates;
+    for (int i = 0; i < relation_num; i++) {
+      cards.push_back(1 + rng() % 100000);
+      if (i > 0) {
+        // 随机生成的树保证连通，再加一些额外的边
+        predicates.emplace_back(set_of(rng() % i, i), 1.0 / (1 + rng() % 1000));
+      }
+    }
+    for (int i = 0; i < relation_num / 2; i++) {
+      const int a = rng() % relation_num, b = rng() % relation_num;
+      if (a != b) {
+        predicates.emplace_back(set_of(a, b), 1.0 / (1 + rng() % 100));
+      }
+    }
+
+    JoinOrderEnumerator dp(cost_model);
+    // 在 DP_THRESHOLD 以上的关系数只能使用贪心算法，加一个与其它关系不连通的关系强制使用贪心
+    JoinOrderEnumerator greedy(cost_model);
+    for (double card : cards) {
+      dp.add_relation(card);
+      greedy.add_relation(card);
+    }
+    for (auto &[relations, selectivity] : predicates) {
+      dp.add_predicate(relations, selectivity);
+      greedy.add_predicate(relations, selectivity);
+    }
+    greedy.add_relation(1);
+
+    const JoinPlanNode *dp_plan = dp.solve();
+    ASSERT_TRUE(dp.used_dp());
+    const JoinPlanNode *greedy_plan = greedy.solve();
+    ASSERT_FALSE(greedy.used_dp());
+    check_plan(dp_plan);
+    check_plan(greedy_plan);
+
+    vector<int> relations;
+    leaves(greedy_plan, relations);
+    ASSERT_EQ(static_cast<int>(relations.size()), relation_num + 1);
+    // 多出来的 1 行的关系做笛卡尔积，代价只会增加
+    ASSERT_LE(dp_plan->cost, greedy_plan->cost * (1 + 1e-9));
+  }
+}
+
+TEST(JoinOrder, greedy_for_many_relations)
+{
+  CostModel           cost_model;
+  JoinOrderEnumerator enumerator(cost_model);
+  const int           relation_num = 30;
+  for (int i = 0; i < relation_num; i++) {
+    enumerator.add_relation(10 + i);
+  }
+  for (int i = 0; i + 1 < relation_num; i++) {
+    enumerator.add_predicate(set_of(i, i + 1), 0.1);
+  }
+  const JoinPlanNode *plan = enumerator.solve();
+  ASSERT_NE(plan, nullptr);
+  ASSERT_FALSE(enumerator.used_dp());
+  check_plan(plan);
+  ASSERT_EQ(plan->relations, (uint64_t(1) << relation_num) - 1);
+
+  vector<int> relations;
+  leaves(plan, relations);
+  sort(relations.begin(), relations.end());
+  for (int i = 0; i < relation_num; i++) {
+    ASSERT_EQ(relations[i], i);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
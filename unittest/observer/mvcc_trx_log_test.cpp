@@ -729,6 +729,49 @@ TEST(MvccTrxLog, wal_rollback_abnormal)
   db.reset();
 }
 
+TEST(MvccTrx, modified_rows_counted_once)
+{
+  // 插入与删除只在 Table 这一层计入修改行数，每行只计一次
+  filesystem::path test_directory("mvcc_trx_modified_rows_test");
+  filesystem::remove_all(test_directory);
+  filesystem::create_directory(test_directory);
+
+  const char      *dbname  = "test_db";
+  filesystem::path db_path = test_directory / dbname;
+  filesystem::create_directories(db_path);
+
+  auto db = make_unique<Db>();
+  ASSERT_EQ(RC::SUCCESS, db->init(dbname, db_path.c_str(), "mvcc", "disk"));
+
+  vector<AttrInfoSqlNode> attr_infos(1);
+  attr_infos[0].name   = "id";
+  attr_infos[0].type   = AttrType::INTS;
+  attr_infos[0].length = 4;
+  ASSERT_EQ(RC::SUCCESS, db->create_table("t", attr_infos, {}));
+  Table *table = db->find_table("t");
+  ASSERT_NE(table, nullptr);
+
+  const int insert_num = 10;
+  Trx      *trx        = db->trx_kit().create_trx(db->log_handler());
+  trx->start_if_need();
+  vector<Record> records(insert_num);
+  for (int i = 0; i < insert_num; i++) {
+    Value value(i);
+    ASSERT_EQ(RC::SUCCESS, table->make_record(1, &value, records[i]));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table, records[i]));
+  }
+  ASSERT_EQ(table->modified_rows(), insert_num);
+
+  for (int i = 0; i < insert_num / 2; i++) {
+    ASSERT_EQ(RC::SUCCESS, trx->delete_record(table, records[i]));
+  }
+  ASSERT_EQ(table->modified_rows(), insert_num + insert_num / 2);
+
+  ASSERT_EQ(RC::SUCCESS, trx->commit());
+  db->trx_kit().destroy_trx(trx);
+  db.reset();
+}
+
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -29,6 +29,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/thread/thread_pool_executor.h"
 #include "storage/clog/integrated_log_replayer.h"
 #include "storage/record/heap_record_scanner.h"
+#include "storage/record/morsel_scheduler.h"
 #include "gtest/gtest.h"
 
 using namespace std;
@@ -347,6 +348,192 @@ TEST_P(PaxPageHandlerTestWithParam, PaxPageHandler)
   delete bpm;
 }
 
+TEST(PaxChunkScanner, late_materialization)
+{
+  const int         record_insert_num = 3000;
+  VacuousLogHandler log_handler;
+
+  const char *record_manager_file = "record_manager.bp";
+  filesystem::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(log_handler, record_manager_file, bp));
+
+  TableMeta table_meta;
+  table_meta.fields_.resize(2);
+  for (int i = 0; i < 2; i++) {
+    table_meta.fields_[i].attr_type_ = AttrType::INTS;
+    table_meta.fields_[i].attr_len_  = 4;
+    table_meta.fields_[i].field_id_  = i;
+  }
+
+  RecordFileHandler file_handler(StorageFormat::PAX_FORMAT);
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(*bp, log_handler, &table_meta, nullptr));
+
+  // 第二列是第一列的两倍，删掉一部分记录让页面不满
+  vector<RID> rids;
+  for (int i = 0; i < record_insert_num; i++) {
+    int record_data[2] = {i, i * 2};
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record((const char *)record_data, sizeof(record_data), &rid));
+    rids.push_back(rid);
+  }
+  for (int i = 0; i < record_insert_num; i += 3) {
+    ASSERT_EQ(RC::SUCCESS, file_handler.delete_record(&rids[i]));
+  }
+
+  Table table;
+  table.table_meta_.storage_format_ = StorageFormat::PAX_FORMAT;
+  ChunkFileScanner chunk_scanner;
+  ASSERT_EQ(RC::SUCCESS, chunk_scanner.open_scan_chunk(&table, *bp, log_handler, ReadWriteMode::READ_ONLY));
+  chunk_scanner.set_eager_columns({0});
+
+  Chunk chunk;
+  for (int i = 0; i < 2; i++) {
+    chunk.add_column(make_unique<Column>(table_meta.fields_[i]), i);
+  }
+
+  RC          rc         = RC::SUCCESS;
+  int         rows       = 0;
+  int         max_rows   = 0;
+  int         selected   = 0;
+  int64_t     col0_sum   = 0;
+  vector<int> selection;
+  vector<int> col0_values;
+  while (OB_SUCC(rc = chunk_scanner.next_chunk(chunk))) {
+    ASSERT_EQ(chunk.column(1).count(), chunk.rows());
+    rows += chunk.rows();
+    max_rows = max(max_rows, chunk.rows());
+
+    // 按第一列过滤，只读取选中行的第二列
+    selection.clear();
+    col0_values.clear();
+    for (int i = 0; i < chunk.rows(); i++) {
+      const int value = chunk.get_value(0, i).get_int();
+      col0_sum += value;
+      if (value % 5 == 0) {
+        selection.push_back(i);
+        col0_values.push_back(value);
+      }
+    }
+    ASSERT_EQ(RC::SUCCESS, chunk_scanner.fetch_columns(chunk, {1}, selection.data(), selection.size()));
+    ASSERT_EQ(chunk.column(1).count(), static_cast<int>(selection.size()));
+    for (size_t i = 0; i < selection.size(); i++) {
+      ASSERT_EQ(chunk.get_value(1, i).get_int(), col0_values[i] * 2);
+    }
+    selected += selection.size();
+  }
+  ASSERT_EQ(rc, RC::RECORD_EOF);
+
+  int     expected_rows     = 0;
+  int     expected_selected = 0;
+  int64_t expected_sum      = 0;
+  for (int i = 0; i < record_insert_num; i++) {
+    if (i % 3 != 0) {
+      expected_rows++;
+      expected_sum += i;
+      expected_selected += i % 5 == 0;
+    }
+  }
+  ASSERT_EQ(rows, expected_rows);
+  ASSERT_EQ(col0_sum, expected_sum);
+  ASSERT_EQ(selected, expected_selected);
+  // 只读取一个 INT 列时，一个 chunk 会拼接多个页面的数据
+  ASSERT_GT(max_rows, rows / 2);
+
+  chunk_scanner.close_scan();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(PaxChunkScanner, target_rows)
+{
+  ASSERT_EQ(ChunkFileScanner::target_rows(0, Column::DEFAULT_CAPACITY), static_cast<int>(Column::DEFAULT_CAPACITY));
+  ASSERT_EQ(ChunkFileScanner::target_rows(1 << 30, Column::DEFAULT_CAPACITY), 1);
+  const int narrow = ChunkFileScanner::target_rows(4, Column::DEFAULT_CAPACITY);
+  const int wide   = ChunkFileScanner::target_rows(4096, Column::DEFAULT_CAPACITY);
+  ASSERT_LE(narrow, static_cast<int>(Column::DEFAULT_CAPACITY));
+  ASSERT_LE(wide, narrow);
+}
+
+TEST(PaxChunkScanner, morsel_parallel_scan)
+{
+  const int         record_insert_num = 20000;
+  const int         worker_num        = 4;
+  VacuousLogHandler log_handler;
+
+  const char *record_manager_file = "record_manager.bp";
+  filesystem::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  ASSERT_EQ(RC::SUCCESS, bpm->init(make_unique<VacuousDoubleWriteBuffer>()));
+  DiskBufferPool *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(log_handler, record_manager_file, bp));
+
+  TableMeta table_meta;
+  table_meta.fields_.resize(1);
+  table_meta.fields_[0].attr_type_ = AttrType::INTS;
+  table_meta.fields_[0].attr_len_  = 4;
+  table_meta.fields_[0].field_id_  = 0;
+
+  RecordFileHandler file_handler(StorageFormat::PAX_FORMAT);
+  ASSERT_EQ(RC::SUCCESS, file_handler.init(*bp, log_handler, &table_meta, nullptr));
+  for (int i = 0; i < record_insert_num; i++) {
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, file_handler.insert_record((const char *)&i, sizeof(i), &rid));
+  }
+
+  Table table;
+  table.table_meta_.storage_format_ = StorageFormat::PAX_FORMAT;
+  MorselScheduler scheduler;
+
+  // 每个线程一个扫描器，共享同一个调度器，所有线程读到的记录合起来恰好是整张表
+  vector<int64_t> sums(worker_num, 0);
+  vector<int>     rows(worker_num, 0);
+  vector<RC>      results(worker_num, RC::SUCCESS);
+  vector<thread>  workers;
+  for (int w = 0; w < worker_num; w++) {
+    workers.emplace_back([&, w]() {
+      ChunkFileScanner chunk_scanner;
+      RC rc = chunk_scanner.open_scan_chunk(&table, *bp, log_handler, ReadWriteMode::READ_ONLY);
+      if (OB_SUCC(rc)) {
+        rc = chunk_scanner.set_morsel_scheduler(&scheduler);
+      }
+      Chunk chunk;
+      chunk.add_column(make_unique<Column>(table_meta.fields_[0]), 0);
+      while (OB_SUCC(rc) && OB_SUCC(rc = chunk_scanner.next_chunk(chunk))) {
+        for (int i = 0; i < chunk.rows(); i++) {
+          sums[w] += chunk.get_value(0, i).get_int();
+        }
+        rows[w] += chunk.rows();
+      }
+      results[w] = rc;
+      chunk_scanner.close_scan();
+    });
+  }
+  for (thread &worker : workers) {
+    worker.join();
+  }
+
+  int     total_rows = 0;
+  int64_t total_sum  = 0;
+  for (int w = 0; w < worker_num; w++) {
+    ASSERT_EQ(results[w], RC::RECORD_EOF);
+    total_rows += rows[w];
+    total_sum += sums[w];
+  }
+  ASSERT_EQ(total_rows, record_insert_num);
+  ASSERT_EQ(total_sum, int64_t(record_insert_num) * (record_insert_num - 1) / 2);
+  ASSERT_GT(scheduler.page_num(), MorselScheduler::MORSEL_PAGES);
+
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
 INSTANTIATE_TEST_SUITE_P(PaxFileScannerTests, PaxRecordFileScannerWithParam, testing::Values(1, 10, 100, 1000, 2000, 10000));
 
 INSTANTIATE_TEST_SUITE_P(PaxPageTests, PaxPageHandlerTestWithParam, testing::Values(1, 10, 100, 337));
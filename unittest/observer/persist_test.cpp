@@ -12,6 +12,9 @@ See the Mulan PSL v2 for more details. */
 // Created by qiling on 2022
 //
 
+#include "common/lang/atomic.h"
+#include "common/lang/thread.h"
+#include "common/lang/vector.h"
 #include "storage/persist/persist.h"
 #include "gtest/gtest.h"
 #include <string.h>
@@ -131,6 +134,48 @@ TEST(test_persist, test_persist_file_io)
   ASSERT_EQ(access(file_name_1.c_str(), F_OK), -1);
 }
 
+TEST(test_persist, test_concurrent_read_at)
+{
+  std::string file_name = "test_persist_concurrent_read_at";
+  remove(file_name.c_str());
+
+  // 每个块 64 字节，内容都是块号
+  const int      block_size = 64;
+  const int      block_num  = 256;
+  PersistHandler persist_handler;
+  ASSERT_EQ(persist_handler.create_file(file_name.c_str()), RC::SUCCESS);
+  ASSERT_EQ(persist_handler.open_file(), RC::SUCCESS);
+  for (int i = 0; i < block_num; i++) {
+    std::string block(block_size, static_cast<char>(i));
+    ASSERT_EQ(persist_handler.append(block_size, block.data()), RC::SUCCESS);
+  }
+
+  // 多个线程同时按不同的位置读取，每次都要读到对应的块
+  atomic<int>    errors{0};
+  vector<thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t]() {
+      char buf[block_size];
+      for (int round = 0; round < 200; round++) {
+        const int block     = (round * 7 + t * 31) % block_num;
+        int64_t   read_size = 0;
+        if (persist_handler.read_at(block * block_size, block_size, buf, &read_size) != RC::SUCCESS ||
+            read_size != block_size || buf[0] != static_cast<char>(block) ||
+            buf[block_size - 1] != static_cast<char>(block)) {
+          errors++;
+        }
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(errors.load(), 0);
+
+  ASSERT_EQ(persist_handler.close_file(), RC::SUCCESS);
+  ASSERT_EQ(persist_handler.remove_file(), RC::SUCCESS);
+}
+
 int main(int argc, char **argv)
 {
 
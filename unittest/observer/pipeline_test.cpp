@@ -0,0 +1,271 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "common/lang/atomic.h"
+#include "common/lang/memory.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/aggregate_vec_physical_operator.h"
+#include "sql/operator/expr_vec_physical_operator.h"
+#include "sql/operator/gather_vec_physical_operator.h"
+#include "sql/operator/group_by_vec_physical_operator.h"
+#include "sql/operator/pipeline.h"
+#include "storage/record/morsel_scheduler.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+namespace {
+/// 多个实例共享行号计数器的数据源，第一列为行号，key_mod 大于 0 时第二列为行号对 key_mod 取模
+class CounterVecPhysicalOperator : public PhysicalOperator
+{
+public:
+  CounterVecPhysicalOperator(atomic<int> &next_row, int rows, int key_mod = 0)
+      : next_row_(next_row), rows_(rows), key_mod_(key_mod)
+  {}
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::TABLE_SCAN_VEC; }
+
+  RC open(Trx *) override
+  {
+    count_open();
+    return RC::SUCCESS;
+  }
+  RC close() override { return RC::SUCCESS; }
+
+  RC next(Chunk &chunk) override
+  {
+    const int begin = next_row_.fetch_add(100);
+    if (begin >= rows_) {
+      return RC::RECORD_EOF;
+    }
+    chunk.reset();
+    auto column = make_unique<Column>(AttrType::INTS, sizeof(int));
+    for (int row = begin; row < std::min(begin + 100, rows_); row++) {
+      column->append_one((const char *)&row);
+    }
+    chunk.add_column(std::move(column), 0);
+    if (key_mod_ > 0) {
+      auto key_column = make_unique<Column>(AttrType::INTS, sizeof(int));
+      for (int row = begin; row < std::min(begin + 100, rows_); row++) {
+        const int key = row % key_mod_;
+        key_column->append_one((const char *)&key);
+      }
+      chunk.add_column(std::move(key_column), 1);
+    }
+    return count_rows(RC::SUCCESS, chunk);
+  }
+
+private:
+  atomic<int> &next_row_;
+  int          rows_;
+  int          key_mod_;
+};
+}  // namespace
+
+TEST(Pipeline, expr_stage)
+{
+  FieldMeta      field_meta("a", AttrType::INTS, 0, sizeof(int), true, 0);
+  ArithmeticExpr expr(ArithmeticExpr::Type::ADD,
+      make_unique<FieldExpr>(Field(nullptr, &field_meta)),
+      make_unique<FieldExpr>(Field(nullptr, &field_meta)));
+
+  ExprPipelineStage stage(vector<Expression *>{&expr});
+  ASSERT_EQ(stage.open(), RC::SUCCESS);
+
+  atomic<int>                next_row{0};
+  CounterVecPhysicalOperator source(next_row, 1000);
+  Chunk                      chunk;
+  int                        rows = 0;
+  while (source.next(chunk) == RC::SUCCESS) {
+    ASSERT_EQ(stage.execute(chunk), RC::SUCCESS);
+    ASSERT_EQ(chunk.column_num(), 1);
+    for (int i = 0; i < chunk.rows(); i++, rows++) {
+      ASSERT_EQ(chunk.get_value(0, i).get_int(), rows * 2);
+    }
+  }
+  ASSERT_EQ(rows, 1000);
+}
+
+TEST(Pipeline, parallel_drivers_push_to_aggregate)
+{
+  const int rows    = 10000;
+  const int workers = 4;
+
+  FieldMeta      field_meta("a", AttrType::INTS, 0, sizeof(int), true, 0);
+  ArithmeticExpr double_expr(ArithmeticExpr::Type::ADD,
+      make_unique<FieldExpr>(Field(nullptr, &field_meta)),
+      make_unique<FieldExpr>(Field(nullptr, &field_meta)));
+  AggregateExpr  sum_expr(AggregateExpr::Type::SUM, new FieldExpr(Field(nullptr, &field_meta)));
+  AggregateExpr  count_expr(AggregateExpr::Type::COUNT, new ValueExpr(Value(1)));
+
+  // AGGREGATE_VEC <- GATHER_VEC <- workers x (EXPR_VEC <- 数据源)
+  atomic<int> next_row{0};
+  auto        gather = make_unique<GatherVecPhysicalOperator>(make_shared<MorselScheduler>());
+  for (int i = 0; i < workers; i++) {
+    auto expr_oper = make_unique<ExprVecPhysicalOperator>(vector<Expression *>{&double_expr});
+    expr_oper->add_child(make_unique<CounterVecPhysicalOperator>(next_row, rows));
+    gather->add_child(std::move(expr_oper));
+  }
+  unique_ptr<PhysicalOperator> oper =
+      make_unique<AggregateVecPhysicalOperator>(vector<Expression *>{&sum_expr, &count_expr});
+  oper->add_child(std::move(gather));
+
+  ASSERT_EQ(PipelineBuilder::build(oper), RC::SUCCESS);
+  ASSERT_EQ(oper->type(), PhysicalOperatorType::PIPELINE_VEC);
+  ASSERT_EQ(oper->param(), "P0: TABLE_SCAN_VEC -> EXPR -> AGGREGATE_VEC x4; P1: AGGREGATE_VEC");
+
+  ASSERT_EQ(oper->open(nullptr), RC::SUCCESS);
+  Chunk chunk;
+  ASSERT_EQ(oper->next(chunk), RC::SUCCESS);
+  ASSERT_EQ(chunk.rows(), 1);
+  ASSERT_EQ(chunk.get_value(0, 0).get_int(), rows * (rows - 1));
+  ASSERT_EQ(chunk.get_value(1, 0).get_int(), rows);
+  ASSERT_EQ(oper->next(chunk), RC::RECORD_EOF);
+  ASSERT_EQ(oper->close(), RC::SUCCESS);
+  // 没有开启统计时不计数
+  ASSERT_FALSE(oper->has_actual());
+}
+
+TEST(Pipeline, explain_analyze_counts_stages)
+{
+  const int rows    = 1000;
+  const int workers = 4;
+
+  FieldMeta      field_meta("a", AttrType::INTS, 0, sizeof(int), true, 0);
+  ArithmeticExpr double_expr(ArithmeticExpr::Type::ADD,
+      make_unique<FieldExpr>(Field(nullptr, &field_meta)),
+      make_unique<FieldExpr>(Field(nullptr, &field_meta)));
+  AggregateExpr  sum_expr(AggregateExpr::Type::SUM, new FieldExpr(Field(nullptr, &field_meta)));
+
+  atomic<int> next_row{0};
+  auto        gather = make_unique<GatherVecPhysicalOperator>(make_shared<MorselScheduler>());
+  for (int i = 0; i < workers; i++) {
+    auto expr_oper = make_unique<ExprVecPhysicalOperator>(vector<Expression *>{&double_expr});
+    expr_oper->add_child(make_unique<CounterVecPhysicalOperator>(next_row, rows));
+    gather->add_child(std::move(expr_oper));
+  }
+  unique_ptr<PhysicalOperator> oper = make_unique<AggregateVecPhysicalOperator>(vector<Expression *>{&sum_expr});
+  oper->add_child(std::move(gather));
+  ASSERT_EQ(PipelineBuilder::build(oper), RC::SUCCESS);
+
+  oper->enable_actual();
+  ASSERT_EQ(oper->open(nullptr), RC::SUCCESS);
+  Chunk chunk;
+  ASSERT_EQ(oper->next(chunk), RC::SUCCESS);
+  ASSERT_EQ(oper->next(chunk), RC::RECORD_EOF);
+  ASSERT_EQ(oper->close(), RC::SUCCESS);
+
+  ASSERT_TRUE(oper->has_actual());
+  ASSERT_EQ(oper->actual_rows(), 1);
+  ASSERT_EQ(oper->param(),
+      "P0: TABLE_SCAN_VEC(actual_rows=1000) -> EXPR(actual_rows=1000) -> AGGREGATE_VEC(actual_rows=1000) x4; "
+      "P1: AGGREGATE_VEC(actual_rows=1)");
+}
+
+TEST(Pipeline, parallel_drivers_push_to_group_by)
+{
+  const int rows    = 10000;
+  const int workers = 4;
+  const int groups  = 10;
+
+  FieldMeta     value_meta("a", AttrType::INTS, 0, sizeof(int), true, 0);
+  FieldMeta     key_meta("k", AttrType::INTS, 0, sizeof(int), true, 1);
+  AggregateExpr sum_expr(AggregateExpr::Type::SUM, new FieldExpr(Field(nullptr, &value_meta)));
+  AggregateExpr count_expr(AggregateExpr::Type::COUNT, new ValueExpr(Value(1)));
+
+  // GROUP_BY_VEC <- GATHER_VEC <- workers x 数据源，每个实例聚合到自己的局部哈希表中
+  atomic<int> next_row{0};
+  auto        gather = make_unique<GatherVecPhysicalOperator>(make_shared<MorselScheduler>());
+  for (int i = 0; i < workers; i++) {
+    gather->add_child(make_unique<CounterVecPhysicalOperator>(next_row, rows, groups));
+  }
+  vector<unique_ptr<Expression>> group_by_exprs;
+  group_by_exprs.emplace_back(make_unique<FieldExpr>(Field(nullptr, &key_meta)));
+  unique_ptr<PhysicalOperator> oper = make_unique<GroupByVecPhysicalOperator>(
+      std::move(group_by_exprs), vector<Expression *>{&sum_expr, &count_expr});
+  ASSERT_NE(static_cast<GroupByVecPhysicalOperator *>(oper.get())->create_local_sink(), nullptr);
+  oper->add_child(std::move(gather));
+
+  ASSERT_EQ(PipelineBuilder::build(oper), RC::SUCCESS);
+  ASSERT_EQ(oper->param(), "P0: TABLE_SCAN_VEC -> GROUP_BY_VEC x4; P1: GROUP_BY_VEC");
+
+  ASSERT_EQ(oper->open(nullptr), RC::SUCCESS);
+  vector<bool> seen(groups, false);
+  Chunk        chunk;
+  RC           rc = RC::SUCCESS;
+  while (OB_SUCC(rc = oper->next(chunk))) {
+    for (int i = 0; i < chunk.rows(); i++) {
+      const int key = chunk.get_value(0, i).get_int();
+      ASSERT_FALSE(seen[key]);
+      seen[key] = true;
+      // key, key + groups, ... 的和
+      const int count = rows / groups;
+      ASSERT_EQ(chunk.get_value(1, i).get_int(), key * count + groups * count * (count - 1) / 2);
+      ASSERT_EQ(chunk.get_value(2, i).get_int(), count);
+    }
+  }
+  ASSERT_EQ(rc, RC::RECORD_EOF);
+  ASSERT_EQ(count(seen.begin(), seen.end(), true), groups);
+  ASSERT_EQ(oper->close(), RC::SUCCESS);
+}
+
+TEST(Pipeline, aggregate_sink_skips_nulls)
+{
+  // 值为 i，i % 3 == 0 的行为 NULL，选择向量只保留偶数行
+  FieldMeta     field_meta("a", AttrType::INTS, 0, sizeof(int), true, 0);
+  AggregateExpr count_field(AggregateExpr::Type::COUNT, new FieldExpr(Field(nullptr, &field_meta)));
+  AggregateExpr count_star(AggregateExpr::Type::COUNT, new ValueExpr(Value(1)));
+  AggregateExpr sum_expr(AggregateExpr::Type::SUM, new FieldExpr(Field(nullptr, &field_meta)));
+  AggregateVecPhysicalOperator oper(vector<Expression *>{&count_field, &count_star, &sum_expr});
+
+  const int   rows   = 100;
+  auto        column = make_unique<Column>(AttrType::INTS, sizeof(int), rows);
+  vector<int> selection;
+  int         expected_count = 0;
+  int         expected_sum   = 0;
+  for (int i = 0; i < rows; i++) {
+    if (i % 3 == 0) {
+      column->append_null();
+    } else {
+      column->append_one((const char *)&i);
+    }
+    if (i % 2 == 0) {
+      selection.push_back(i);
+      expected_count += i % 3 == 0 ? 0 : 1;
+      expected_sum += i % 3 == 0 ? 0 : i;
+    }
+  }
+  Chunk chunk;
+  chunk.add_column(std::move(column), 0);
+  chunk.set_selection(selection);
+
+  ASSERT_EQ(oper.open(nullptr), RC::SUCCESS);
+  ASSERT_EQ(oper.sink(chunk), RC::SUCCESS);
+  // 没有选择向量时同样跳过 NULL
+  chunk.clear_selection();
+  ASSERT_EQ(oper.sink(chunk), RC::SUCCESS);
+
+  Chunk output;
+  ASSERT_EQ(oper.next(output), RC::SUCCESS);
+  ASSERT_EQ(output.get_value(0, 0).get_int(), expected_count + rows - (rows + 2) / 3);
+  ASSERT_EQ(output.get_value(1, 0).get_int(), static_cast<int>(selection.size()) + rows);
+  int all_sum = 0;
+  for (int i = 0; i < rows; i++) {
+    all_sum += i % 3 == 0 ? 0 : i;
+  }
+  ASSERT_EQ(output.get_value(2, 0).get_int(), expected_sum + all_sum);
+  ASSERT_EQ(oper.close(), RC::SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,183 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/expr/expression.h"
+#include "sql/operator/insert_physical_operator.h"
+#include "sql/operator/predicate_physical_operator.h"
+#include "sql/operator/string_list_physical_operator.h"
+#include "sql/plan_cache/plan_cache.h"
+#include "sql/plan_cache/sql_normalizer.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+namespace {
+FieldMeta field_meta("a", AttrType::INTS, 0, sizeof(int), true, 0);
+
+/// a = value 的过滤算子，value 是 INTS 类型
+unique_ptr<PhysicalOperator> make_predicate(int value)
+{
+  auto expr = make_unique<ComparisonExpr>(
+      EQUAL_TO, make_unique<FieldExpr>(Field(nullptr, &field_meta)), make_unique<ValueExpr>(Value(value)));
+  return make_unique<PredicatePhysicalOperator>(std::move(expr));
+}
+
+vector<Value *> plan_constants(PhysicalOperator &oper)
+{
+  vector<Value *> constants;
+  vector<Value *> copies;
+  oper.collect_constants(constants, copies);
+  return constants;
+}
+
+unique_ptr<CachedPlan> make_plan(PlanCache &cache, const string &key, int value)
+{
+  vector<Value> params{Value(static_cast<long long>(value))};
+  auto          plan = make_unique<CachedPlan>(key, params, cache.schema_version());
+  auto          oper = make_predicate(value);
+  if (!plan->prepare(*oper, {})) {
+    return nullptr;
+  }
+  plan->set_operator(std::move(oper));
+  return plan;
+}
+}  // namespace
+
+TEST(SqlNormalizer, normalize)
+{
+  string        text;
+  vector<Value> params;
+  ASSERT_TRUE(SqlNormalizer::normalize("select  *\nfrom t1 where id=12 and v = 'abc' and f > 1.5 ;", text, params));
+  ASSERT_EQ(text, "select * from t1 where id=? and v = ? and f > ? ;");
+  ASSERT_EQ(params.size(), 3);
+  ASSERT_EQ(params[0].attr_type(), AttrType::BIGINTS);
+  ASSERT_EQ(params[0].get_bigint(), 12);
+  ASSERT_EQ(params[1].attr_type(), AttrType::CHARS);
+  ASSERT_EQ(params[1].get_string(), "abc");
+  ASSERT_EQ(params[2].attr_type(), AttrType::FLOATS);
+  ASSERT_FLOAT_EQ(params[2].get_float(), 1.5);
+
+  string other_text;
+  ASSERT_TRUE(SqlNormalizer::normalize("select * from t1 where id=7 and v = \"x\" and f > 2.0 ;", other_text, params));
+  ASSERT_EQ(other_text, text);
+
+  ASSERT_FALSE(SqlNormalizer::normalize("select * from t where v = 'abc", text, params));
+  ASSERT_EQ(SqlNormalizer::first_word("  SELECT * from t"), "select");
+}
+
+TEST(CachedPlan, bind_parameters)
+{
+  // insert into t values (1, 1, 2)：相等的参数对应两个值
+  vector<Value> params{Value(1LL), Value(1LL), Value(2LL)};
+  unique_ptr<PhysicalOperator> oper =
+      make_unique<InsertPhysicalOperator>(nullptr, vector<Value>{Value(1LL), Value(1LL), Value(2LL)});
+  CachedPlan plan("insert", params, 0);
+  ASSERT_TRUE(plan.prepare(*oper, {}));
+
+  ASSERT_EQ(plan.bind({Value(5LL), Value(5LL), Value(7LL)}), RC::SUCCESS);
+  vector<Value *> constants = plan_constants(*oper);
+  ASSERT_EQ(constants[0]->get_bigint(), 5);
+  ASSERT_EQ(constants[1]->get_bigint(), 5);
+  ASSERT_EQ(constants[2]->get_bigint(), 7);
+
+  // 参数转换成 INTS 类型的常量，超出范围的参数不能使用这个执行计划
+  unique_ptr<PhysicalOperator> predicate = make_predicate(3);
+  CachedPlan                   predicate_plan("predicate", {Value(3LL)}, 0);
+  ASSERT_TRUE(predicate_plan.prepare(*predicate, {}));
+  ASSERT_EQ(predicate_plan.bind({Value(9LL)}), RC::SUCCESS);
+  ASSERT_EQ(plan_constants(*predicate)[0]->attr_type(), AttrType::INTS);
+  ASSERT_EQ(plan_constants(*predicate)[0]->get_int(), 9);
+  ASSERT_NE(predicate_plan.bind({Value(3000000000LL)}), RC::SUCCESS);
+}
+
+TEST(CachedPlan, not_cacheable)
+{
+  // 参数在执行计划中找不到，比如用在了 LIMIT 或 IN 列表中
+  unique_ptr<PhysicalOperator> oper = make_predicate(3);
+  CachedPlan                   plan("predicate", {Value(3LL), Value(4LL)}, 0);
+  ASSERT_FALSE(plan.prepare(*oper, {}));
+
+  // 三个相等的参数只有一个出现在执行计划中
+  CachedPlan equal_plan("predicate", {Value(3LL), Value(3LL), Value(3LL)}, 0);
+  ASSERT_FALSE(equal_plan.prepare(*oper, {}));
+
+  // 包含不能重新打开的算子
+  oper->add_child(make_unique<StringListPhysicalOperator>());
+  CachedPlan child_plan("predicate", {Value(3LL)}, 0);
+  ASSERT_FALSE(child_plan.prepare(*oper, {}));
+}
+
+TEST(PlanCache, acquire_and_release)
+{
+  PlanCache cache;
+  ASSERT_EQ(cache.acquire("a", {Value(1LL)}, false), nullptr);
+
+  cache.release(make_plan(cache, "a", 1));
+  unique_ptr<CachedPlan> plan = cache.acquire("a", {Value(2LL)}, false);
+  ASSERT_NE(plan, nullptr);
+  // 执行计划被取出之后，其它请求不能同时使用
+  ASSERT_EQ(cache.acquire("a", {Value(3LL)}, false), nullptr);
+
+  unique_ptr<PhysicalOperator> oper = plan->take_operator();
+  ASSERT_EQ(plan_constants(*oper)[0]->get_int(), 2);
+  plan->set_operator(std::move(oper));
+  cache.release(std::move(plan));
+
+  PlanCache::Stats stats = cache.stats();
+  ASSERT_EQ(stats.hits, 1);
+  ASSERT_EQ(stats.misses, 2);
+  ASSERT_EQ(stats.entries, 1);
+  ASSERT_GT(stats.memory, 0);
+}
+
+TEST(PlanCache, bounded_memory)
+{
+  PlanCache    cache;
+  const size_t plan_memory = make_plan(cache, "probe", 1)->memory_size();
+  cache.set_capacity(plan_memory * PlanCache::SHARD_NUM * 2);
+
+  const int plan_num = PlanCache::SHARD_NUM * 16;
+  for (int i = 0; i < plan_num; i++) {
+    cache.release(make_plan(cache, "key" + to_string(i), i));
+  }
+  PlanCache::Stats stats = cache.stats();
+  ASSERT_LE(stats.memory, cache.capacity());
+  ASSERT_GT(stats.evictions, 0);
+  ASSERT_EQ(stats.entries + stats.evictions, plan_num);
+
+  // 最近放入的执行计划还在缓存中
+  ASSERT_NE(cache.acquire("key" + to_string(plan_num - 1), {Value(1LL)}, false), nullptr);
+
+  cache.set_capacity(0);
+  ASSERT_EQ(cache.stats().entries, 0);
+  cache.release(make_plan(cache, "a", 1));
+  ASSERT_EQ(cache.stats().entries, 0);
+}
+
+TEST(PlanCache, invalidate)
+{
+  PlanCache              cache;
+  unique_ptr<CachedPlan> old_plan = make_plan(cache, "a", 1);
+  cache.release(make_plan(cache, "b", 1));
+
+  cache.invalidate_all();
+  ASSERT_EQ(cache.stats().invalidations, 1);
+  ASSERT_EQ(cache.acquire("b", {Value(1LL)}, false), nullptr);
+
+  // 表结构变化之前生成的执行计划不再放入缓存
+  cache.release(std::move(old_plan));
+  ASSERT_EQ(cache.stats().entries, 0);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,119 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "session/session.h"
+#include "sql/expr/expression.h"
+#include "sql/parser/parse.h"
+#include "sql/plan_cache/prepared_statement.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+TEST(PreparedStatement, render)
+{
+  PreparedStatement stmt(1, "select * from t where id = ? and name = ?");
+  ASSERT_EQ(stmt.init(), RC::SUCCESS);
+  ASSERT_EQ(stmt.param_num(), 2);
+
+  string sql;
+  ASSERT_EQ(stmt.render({Value(3), Value("abc")}, sql), RC::SUCCESS);
+  ASSERT_EQ(sql, "select * from t where id = 3 and name = 'abc'");
+
+  // 参数个数不一致
+  ASSERT_EQ(stmt.render({Value(3)}, sql), RC::INVALID_ARGUMENT);
+}
+
+TEST(PreparedStatement, quoted_question_mark)
+{
+  PreparedStatement stmt(1, "select * from t where a = '?' and b = \"?\" and c = ?");
+  ASSERT_EQ(stmt.init(), RC::SUCCESS);
+  ASSERT_EQ(stmt.param_num(), 1);
+
+  string sql;
+  ASSERT_EQ(stmt.render({Value(1LL)}, sql), RC::SUCCESS);
+  ASSERT_EQ(sql, "select * from t where a = '?' and b = \"?\" and c = 1");
+
+  PreparedStatement bad(2, "select * from t where a = '?");
+  ASSERT_EQ(bad.init(), RC::SQL_SYNTAX);
+}
+
+TEST(PreparedStatement, literal)
+{
+  string literal;
+  ASSERT_EQ(PreparedStatement::to_literal(Value(-12), literal), RC::SUCCESS);
+  ASSERT_EQ(literal, "-12");
+
+  ASSERT_EQ(PreparedStatement::to_literal(Value(1.5f), literal), RC::SUCCESS);
+  ASSERT_EQ(literal, "1.5");
+  ASSERT_EQ(PreparedStatement::to_literal(Value(2.0f), literal), RC::SUCCESS);
+  ASSERT_EQ(literal, "2.0");
+  ASSERT_EQ(PreparedStatement::to_literal(Value(0.1f), literal), RC::SUCCESS);
+  ASSERT_EQ(strtof(literal.c_str(), nullptr), 0.1f);
+
+  ASSERT_EQ(PreparedStatement::to_literal(Value("it's"), literal), RC::SUCCESS);
+  ASSERT_EQ(literal, "\"it's\"");
+  ASSERT_EQ(PreparedStatement::to_literal(Value("a'b\"c"), literal), RC::INVALID_ARGUMENT);
+}
+
+TEST(PreparedStatement, negative_params)
+{
+  // 负数参数渲染成 -5 这样的常量，插入的值、条件与 SET 中都可以解析
+  const vector<Value> params = {Value(-5), Value(-1.5f)};
+  const char         *sqls[] = {
+      "insert into t values(?, ?)",
+      "select * from t where id = ? and ? < score",
+      "update t set score = ? where id = ?",
+  };
+  for (const char *text : sqls) {
+    PreparedStatement stmt(1, text);
+    ASSERT_EQ(stmt.init(), RC::SUCCESS);
+    string sql;
+    ASSERT_EQ(stmt.render(params, sql), RC::SUCCESS);
+
+    ParsedSqlResult result;
+    ASSERT_EQ(parse(sql.c_str(), &result), RC::SUCCESS);
+    ASSERT_EQ(result.sql_nodes().size(), 1);
+    ASSERT_NE(result.sql_nodes().front()->flag, SCF_ERROR) << sql;
+  }
+
+  PreparedStatement stmt(1, "insert into t values(?, ?)");
+  ASSERT_EQ(stmt.init(), RC::SUCCESS);
+  string sql;
+  ASSERT_EQ(stmt.render(params, sql), RC::SUCCESS);
+  ParsedSqlResult result;
+  ASSERT_EQ(parse(sql.c_str(), &result), RC::SUCCESS);
+  const vector<Value> &values = result.sql_nodes().front()->insertion.values;
+  ASSERT_EQ(values.size(), 2);
+  ASSERT_EQ(values[0].get_int(), -5);
+  ASSERT_EQ(values[1].get_float(), -1.5f);
+}
+
+TEST(PreparedStatement, session)
+{
+  Session            session;
+  PreparedStatement *stmt = nullptr;
+  ASSERT_EQ(session.add_prepared_statement("select ?", stmt), RC::SUCCESS);
+  const uint32_t id = stmt->id();
+  ASSERT_EQ(session.find_prepared_statement(id), stmt);
+
+  PreparedStatement *other = nullptr;
+  ASSERT_EQ(session.add_prepared_statement("select ?, ?", other), RC::SUCCESS);
+  ASSERT_NE(other->id(), id);
+
+  session.remove_prepared_statement(id);
+  ASSERT_EQ(session.find_prepared_statement(id), nullptr);
+  ASSERT_EQ(session.find_prepared_statement(other->id()), other);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
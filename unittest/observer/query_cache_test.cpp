@@ -0,0 +1,139 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "session/session.h"
+#include "sql/expr/tuple.h"
+#include "sql/query_cache/query_cache.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+namespace {
+/// 两列的查询结果，包含 rows 行，不访问任何表
+unique_ptr<CachedResult> make_result(QueryCache &cache, const string &key, int rows)
+{
+  auto result = make_unique<CachedResult>(key, nullptr, 0, cache.schema_version(), cache.max_result_size());
+  result->set_tables({});
+
+  TupleSchema schema;
+  schema.append_cell("id");
+  schema.append_cell("name");
+  result->set_schema(schema);
+
+  ValueListTuple tuple;
+  for (int i = 0; i < rows; i++) {
+    tuple.set_cells({Value(i), Value("row")});
+    if (!result->add_tuple(tuple)) {
+      return nullptr;
+    }
+  }
+  return result;
+}
+}  // namespace
+
+TEST(CachedResult, collect_rows)
+{
+  QueryCache               cache;
+  unique_ptr<CachedResult> result = make_result(cache, "a", 3);
+  ASSERT_NE(result, nullptr);
+  ASSERT_EQ(result->row_num(), 3);
+  ASSERT_EQ(result->column_num(), 2);
+  ASSERT_EQ(result->schema().cell_at(1).alias(), string("name"));
+  ASSERT_EQ(result->cell(2, 0), "2");
+  ASSERT_EQ(result->cell(2, 1), "row");
+
+  // 列数与表头不一致的元组不能收集
+  ValueListTuple tuple;
+  tuple.set_cells({Value(1)});
+  ASSERT_FALSE(result->add_tuple(tuple));
+
+  // 超过内存上限之后放弃收集
+  cache.set_capacity(QueryCache::SHARD_NUM * 1024);
+  ASSERT_EQ(make_result(cache, "b", 1024), nullptr);
+}
+
+TEST(QueryCache, make_key)
+{
+  // 参数的值是键的一部分
+  Session session;
+  const string key = QueryCache::make_key("select * from t where id = ?", {Value(1LL)}, &session);
+  ASSERT_EQ(key, QueryCache::make_key("select * from t where id = ?", {Value(1LL)}, &session));
+  ASSERT_NE(key, QueryCache::make_key("select * from t where id = ?", {Value(2LL)}, &session));
+  ASSERT_NE(key, QueryCache::make_key("select * from t where id = ?", {Value("1")}, &session));
+  ASSERT_NE(QueryCache::make_key("select ?, ?", {Value("a,"), Value("b")}, &session),
+      QueryCache::make_key("select ?, ?", {Value("a"), Value(",b")}, &session));
+}
+
+TEST(QueryCache, lookup_and_add)
+{
+  QueryCache cache;
+  ASSERT_EQ(cache.lookup("a"), nullptr);
+
+  cache.add(make_result(cache, "a", 2));
+  shared_ptr<const CachedResult> result = cache.lookup("a");
+  ASSERT_NE(result, nullptr);
+  ASSERT_EQ(result->row_num(), 2);
+
+  // 同一条SQL再次放入时替换原来的结果
+  cache.add(make_result(cache, "a", 5));
+  ASSERT_EQ(cache.lookup("a")->row_num(), 5);
+  // 已经取出的结果不受影响
+  ASSERT_EQ(result->row_num(), 2);
+
+  QueryCache::Stats stats = cache.stats();
+  ASSERT_EQ(stats.hits, 2);
+  ASSERT_EQ(stats.misses, 1);
+  ASSERT_EQ(stats.entries, 1);
+  ASSERT_EQ(stats.memory, static_cast<int64_t>(cache.lookup("a")->memory_size()));
+}
+
+TEST(QueryCache, bounded_memory)
+{
+  QueryCache   cache;
+  const size_t result_memory = make_result(cache, "probe", 4)->memory_size();
+  cache.set_capacity(result_memory * QueryCache::SHARD_NUM * 2);
+
+  const int result_num = QueryCache::SHARD_NUM * 16;
+  for (int i = 0; i < result_num; i++) {
+    cache.add(make_result(cache, "key" + to_string(i), 4));
+  }
+  QueryCache::Stats stats = cache.stats();
+  ASSERT_LE(stats.memory, cache.capacity());
+  ASSERT_GT(stats.evictions, 0);
+  ASSERT_EQ(stats.entries + stats.evictions, result_num);
+
+  // 最近放入的结果还在缓存中
+  ASSERT_NE(cache.lookup("key" + to_string(result_num - 1)), nullptr);
+
+  cache.set_capacity(0);
+  ASSERT_EQ(cache.stats().entries, 0);
+  ASSERT_EQ(cache.stats().memory, 0);
+}
+
+TEST(QueryCache, invalidate)
+{
+  QueryCache               cache;
+  unique_ptr<CachedResult> old_result = make_result(cache, "a", 1);
+  cache.add(make_result(cache, "b", 1));
+
+  cache.invalidate_all();
+  ASSERT_EQ(cache.stats().invalidations, 1);
+  ASSERT_EQ(cache.lookup("b"), nullptr);
+
+  // 表结构变化之前开始执行的查询，结果不再放入缓存
+  cache.add(std::move(old_result));
+  ASSERT_EQ(cache.stats().entries, 0);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,144 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/expr/tuple.h"
+#include "sql/operator/runtime_filter.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+namespace {
+/// 取元组的第一列
+class FirstCellExpr : public Expression
+{
+public:
+  explicit FirstCellExpr(AttrType type) : type_(type) {}
+
+  unique_ptr<Expression> copy() const override { return make_unique<FirstCellExpr>(type_); }
+  ExprType               type() const override { return ExprType::NONE; }
+  AttrType               value_type() const override { return type_; }
+  RC get_value(const Tuple &tuple, Value &value) const override { return tuple.cell_at(0, value); }
+
+private:
+  AttrType type_;
+};
+
+unique_ptr<RuntimeFilter> make_filter(AttrType key_type)
+{
+  vector<unique_ptr<Expression>> keys;
+  keys.emplace_back(make_unique<FirstCellExpr>(key_type));
+  return make_unique<RuntimeFilter>(std::move(keys), vector<AttrType>{key_type});
+}
+
+void add_key(RuntimeFilter &filter, const Value &value, AttrType key_type)
+{
+  vector<Value> values{value};
+  string        key;
+  RuntimeFilter::encode_key(values, {key_type}, key);
+  filter.add(values, key);
+}
+
+bool pass(RuntimeFilter &filter, const Value &value)
+{
+  ValueListTuple tuple;
+  tuple.set_cells({value});
+  bool result = false;
+  EXPECT_EQ(filter.filter(tuple, result), RC::SUCCESS);
+  return result;
+}
+}  // namespace
+
+TEST(RuntimeFilter, bloom_filter)
+{
+  BlockedBloomFilter bloom_filter;
+  bloom_filter.init(10000);
+  for (uint64_t i = 0; i < 10000; i++) {
+    bloom_filter.insert(i * 0x9e3779b97f4a7c15ULL);
+  }
+
+  int false_positives = 0;
+  for (uint64_t i = 0; i < 10000; i++) {
+    ASSERT_TRUE(bloom_filter.may_contain(i * 0x9e3779b97f4a7c15ULL));
+    false_positives += bloom_filter.may_contain((i + 20000) * 0x9e3779b97f4a7c15ULL) ? 1 : 0;
+  }
+  ASSERT_LT(false_positives, 100);
+}
+
+TEST(RuntimeFilter, range_and_bloom)
+{
+  auto filter = make_filter(AttrType::INTS);
+  filter->reset();
+  for (int i = 100; i < 200; i += 2) {
+    add_key(*filter, Value(i), AttrType::INTS);
+  }
+  // 右表的数据还没有完整，不能过滤
+  ASSERT_TRUE(pass(*filter, Value(1)));
+  filter->finish();
+
+  // 范围之外的值由最小、最大值过滤
+  ASSERT_FALSE(pass(*filter, Value(99)));
+  ASSERT_FALSE(pass(*filter, Value(200)));
+
+  int passed_odd = 0;
+  for (int i = 100; i < 200; i++) {
+    if (i % 2 == 0) {
+      ASSERT_TRUE(pass(*filter, Value(i)));
+    } else {
+      passed_odd += pass(*filter, Value(i)) ? 1 : 0;
+    }
+  }
+  ASSERT_LT(passed_odd, 5);
+  ASSERT_EQ(filter->checked_rows(), 102);  // 完整之前的行不计入
+}
+
+TEST(RuntimeFilter, float_key)
+{
+  // 整数与浮点数比较时按照浮点数编码
+  auto filter = make_filter(AttrType::FLOATS);
+  filter->reset();
+  add_key(*filter, Value(1.5f), AttrType::FLOATS);
+  add_key(*filter, Value(3.0f), AttrType::FLOATS);
+  filter->finish();
+
+  ASSERT_TRUE(pass(*filter, Value(3)));
+  ASSERT_TRUE(pass(*filter, Value(1.5f)));
+  ASSERT_FALSE(pass(*filter, Value(2)));
+}
+
+TEST(RuntimeFilter, empty_and_disable)
+{
+  auto filter = make_filter(AttrType::INTS);
+  filter->reset();
+  filter->finish();
+  ASSERT_FALSE(pass(*filter, Value(1)));
+
+  // 几乎所有的行都能通过时停用过滤器
+  filter->reset();
+  for (int i = 0; i < 100; i++) {
+    add_key(*filter, Value(i), AttrType::INTS);
+  }
+  filter->finish();
+  for (int i = 0; i < 10000; i++) {
+    pass(*filter, Value(i % 100));
+  }
+  ASSERT_FALSE(filter->enabled());
+  ASSERT_TRUE(pass(*filter, Value(1000)));
+
+  // 重新建表之后再次启用
+  filter->reset();
+  filter->finish();
+  ASSERT_TRUE(filter->enabled());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,116 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "common/lang/algorithm.h"
+#include "common/lang/memory.h"
+#include "common/lang/string.h"
+#include "common/lang/vector.h"
+#include "storage/common/top_n_sorter.h"
+#include "gtest/gtest.h"
+
+using namespace std;
+
+namespace {
+/// 构造一个 chunk：payload 为 (id int, name text)，排序列为 (id % 100 的 bigint, id)
+void make_chunk(int start, int rows, Chunk &payload, Chunk &keys, vector<int> &ids)
+{
+  auto id_col   = make_unique<Column>(AttrType::INTS, sizeof(int), rows);
+  auto name_col = make_unique<Column>(AttrType::TEXTS, sizeof(string_t), rows);
+  auto key1_col = make_unique<Column>(AttrType::BIGINTS, sizeof(int64_t), rows);
+  auto key2_col = make_unique<Column>(AttrType::INTS, sizeof(int), rows);
+  for (int i = start; i < start + rows; i++) {
+    int     id  = (i * 7919) % 100003;
+    int64_t key = id % 100;
+    Value   name;
+    name.set_text(("name_with_long_text_" + to_string(id)).c_str());
+    id_col->append_one((char *)&id);
+    name_col->append_value(name);
+    key1_col->append_one((char *)&key);
+    key2_col->append_one((char *)&id);
+    ids.push_back(id);
+  }
+  payload.add_column(std::move(id_col), 0);
+  payload.add_column(std::move(name_col), 1);
+  keys.add_column(std::move(key1_col), 0);
+  keys.add_column(std::move(key2_col), 1);
+}
+
+void check_top_n(bool asc, int limit)
+{
+  TopNSorter  sorter({asc, true}, limit);
+  vector<int> ids;
+  for (int i = 0; i < 20; i++) {
+    Chunk payload, keys;
+    make_chunk(i * 1000, 1000, payload, keys, ids);
+    ASSERT_EQ(sorter.add_chunk(payload, keys), RC::SUCCESS);
+  }
+  ASSERT_EQ(sorter.finish(), RC::SUCCESS);
+  // 堆满之后，绝大部分行都应该被第一个排序列过滤掉
+  EXPECT_GT(sorter.filtered_rows(), 10000);
+
+  std::sort(ids.begin(), ids.end(), [asc](int left, int right) {
+    if (left % 100 != right % 100) {
+      return asc ? left % 100 < right % 100 : left % 100 > right % 100;
+    }
+    return left < right;
+  });
+  ids.resize(std::min<size_t>(ids.size(), limit));
+
+  Chunk output;
+  output.add_column(make_unique<Column>(AttrType::INTS, sizeof(int), 64), 0);
+  output.add_column(make_unique<Column>(AttrType::TEXTS, sizeof(string_t), 64), 1);
+
+  vector<int> result;
+  RC          rc = RC::SUCCESS;
+  while (OB_SUCC(rc = sorter.next(output))) {
+    for (int r = 0; r < output.rows(); r++) {
+      int id = output.get_value(0, r).get_int();
+      EXPECT_EQ(output.get_value(1, r).get_string(), "name_with_long_text_" + to_string(id));
+      result.push_back(id);
+    }
+    output.reset_data();
+  }
+  EXPECT_EQ(rc, RC::RECORD_EOF);
+  EXPECT_EQ(result, ids);
+}
+}  // namespace
+
+TEST(TopNSorterTest, top_n_asc) { check_top_n(true, 100); }
+
+TEST(TopNSorterTest, top_n_desc) { check_top_n(false, 100); }
+
+TEST(TopNSorterTest, top_n_compact)
+{
+  // limit 较大时会多次回收内存块
+  check_top_n(true, 1500);
+}
+
+TEST(TopNSorterTest, limit_larger_than_input)
+{
+  TopNSorter  sorter({true, true}, 1000);
+  vector<int> ids;
+  Chunk       payload, keys;
+  make_chunk(0, 10, payload, keys, ids);
+  ASSERT_EQ(sorter.add_chunk(payload, keys), RC::SUCCESS);
+  ASSERT_EQ(sorter.finish(), RC::SUCCESS);
+
+  Chunk output;
+  output.add_column(make_unique<Column>(AttrType::INTS, sizeof(int), 64), 0);
+  output.add_column(make_unique<Column>(AttrType::TEXTS, sizeof(string_t), 64), 1);
+  ASSERT_EQ(sorter.next(output), RC::SUCCESS);
+  ASSERT_EQ(output.rows(), 10);
+  ASSERT_EQ(sorter.next(output), RC::RECORD_EOF);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}